@@ -0,0 +1,230 @@
+## @file
+# Convert the DXE Core call profile in a debug log to folded stacks and to a
+# flame graph.
+#
+# The DXE Core prints its call profile to the debug log at ReadyToBoot when
+# PcdDxeCoreCallProfileNodes isn't zero, as folded stacks between the lines
+# "DXEPROF: begin" and "DXEPROF: end". The last complete profile of the log is
+# converted.
+#
+# Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+DxeProfileToFlameGraph
+'''
+from __future__ import print_function
+
+import sys
+import argparse
+import re
+import zlib
+from xml.sax.saxutils import escape
+
+#
+# Globals for help information
+#
+__prog__        = 'DxeProfileToFlameGraph'
+__copyright__   = 'Copyright (c) 2026, agent <agent@local>. All rights reserved.'
+__description__ = 'Convert the DXE Core call profile in a debug log to folded stacks and to a flame graph.\n'
+
+#
+# Layout of the flame graph, in pixels
+#
+FRAME_HEIGHT = 16
+FONT_SIZE    = 12
+FONT_WIDTH   = 0.59
+MARGIN       = 10
+TITLE_HEIGHT = 30
+
+PROFILE_TAG  = 'DXEPROF: '
+
+def ReadProfile (File):
+    #
+    # The debug log may prefix the lines with time stamps or mix the lines of
+    # the profile with other messages; only the text after the tag counts.
+    #
+    Profile = None
+    Current = None
+    for Line in File:
+        Index = Line.find (PROFILE_TAG)
+        if Index < 0:
+            continue
+        Text = Line[Index + len (PROFILE_TAG):].strip ()
+        if Text == 'begin':
+            Current = []
+        elif Text == 'end':
+            if Current is not None:
+                Profile = Current
+            Current = None
+        elif Current is not None:
+            Stack, Separator, Value = Text.rpartition (' ')
+            if Separator == '' or not Value.isdigit ():
+                print ('DxeProfileToFlameGraph: warning: skipped malformed line: {Line}'.format (Line = Text), file = sys.stderr)
+                continue
+            Current.append ((Stack, int (Value)))
+    return Profile
+
+class Frame:
+    def __init__ (self, Name):
+        self.Name     = Name
+        self.Self     = 0
+        self.Total    = 0
+        self.Children = {}
+
+def BuildTree (Profile):
+    Root = Frame ('all')
+    for Stack, Value in Profile:
+        Node = Root
+        Node.Total += Value
+        for Name in Stack.split (';'):
+            if Name not in Node.Children:
+                Node.Children[Name] = Frame (Name)
+            Node = Node.Children[Name]
+            Node.Total += Value
+        Node.Self += Value
+    return Root
+
+def TreeDepth (Node):
+    if not Node.Children:
+        return 1
+    return 1 + max (TreeDepth (Child) for Child in Node.Children.values ())
+
+def FrameColor (Name):
+    #
+    # A stable color per frame type, a warm hue for the frame name within it
+    #
+    Type = Name.split (':')[0]
+    Hash = zlib.crc32 (Name.encode ('utf-8')) & 0xFFFFFFFF
+    Base = {
+      'DxeCore':           (200, 200, 200),
+      'LoadImage':         (230, 160,  60),
+      'StartImage':        (230, 110,  50),
+      'ConnectController': (210, 190,  60),
+      'Supported':         (150, 200,  90),
+      'Start':             (230,  80,  60),
+      'Notify':            ( 90, 160, 220),
+      'RestoreTpl':        (140, 140, 220)
+      }.get (Type, (220, 120, 90))
+    return 'rgb({R},{G},{B})'.format (
+             R = min (255, Base[0] + (Hash & 0x1F)),
+             G = min (255, Base[1] + ((Hash >> 5) & 0x1F)),
+             B = min (255, Base[2] + ((Hash >> 10) & 0x1F))
+             )
+
+def FormatTime (Value):
+    return '{Value:.3f} ms'.format (Value = Value / 1000000.0)
+
+def WriteFlameGraph (File, Root, Title, Width, MinWidth, Inverted):
+    Depth  = TreeDepth (Root)
+    Height = Depth * FRAME_HEIGHT + TITLE_HEIGHT + 2 * MARGIN
+    Scale  = float (Width - 2 * MARGIN) / max (Root.Total, 1)
+
+    File.write ('<?xml version="1.0" standalone="no"?>\n')
+    File.write ('<svg version="1.1" width="{Width}" height="{Height}" xmlns="http://www.w3.org/2000/svg">\n'.format (Width = Width, Height = Height))
+    File.write ('<rect x="0" y="0" width="{Width}" height="{Height}" fill="rgb(248,248,248)"/>\n'.format (Width = Width, Height = Height))
+    File.write ('<text x="{X}" y="{Y}" font-size="{Size}" font-family="Verdana" text-anchor="middle">{Title}</text>\n'.format (
+                  X = Width // 2,
+                  Y = MARGIN + FONT_SIZE + 4,
+                  Size = FONT_SIZE + 4,
+                  Title = escape (Title)
+                  ))
+
+    #
+    # Frames are laid out with their children in name order, from the bottom
+    # up, or from the top down for an icicle graph.
+    #
+    Pending = [(Root, 0, MARGIN)]
+    while Pending:
+        Node, Level, X = Pending.pop ()
+        FrameWidth = Node.Total * Scale
+        if FrameWidth < MinWidth:
+            continue
+        if Inverted:
+            Y = MARGIN + TITLE_HEIGHT + Level * FRAME_HEIGHT
+        else:
+            Y = Height - MARGIN - (Level + 1) * FRAME_HEIGHT
+        Info = '{Name} ({Time}, {Percent:.2f}%, self {Self})'.format (
+                 Name = Node.Name,
+                 Time = FormatTime (Node.Total),
+                 Percent = 100.0 * Node.Total / max (Root.Total, 1),
+                 Self = FormatTime (Node.Self)
+                 )
+        File.write ('<g><title>{Info}</title>'.format (Info = escape (Info)))
+        File.write ('<rect x="{X:.1f}" y="{Y}" width="{W:.1f}" height="{H}" fill="{Color}" rx="2" ry="2"/>'.format (
+                      X = X,
+                      Y = Y,
+                      W = FrameWidth,
+                      H = FRAME_HEIGHT - 1,
+                      Color = FrameColor (Node.Name)
+                      ))
+        Characters = int ((FrameWidth - 6) / (FONT_SIZE * FONT_WIDTH))
+        if Characters >= 3:
+            Label = Node.Name if len (Node.Name) <= Characters else Node.Name[:Characters - 2] + '..'
+            File.write ('<text x="{X:.1f}" y="{Y}" font-size="{Size}" font-family="Verdana">{Label}</text>'.format (
+                          X = X + 3,
+                          Y = Y + FRAME_HEIGHT - 4,
+                          Size = FONT_SIZE,
+                          Label = escape (Label)
+                          ))
+        File.write ('</g>\n')
+
+        ChildX = X
+        for Name in sorted (Node.Children):
+            Child = Node.Children[Name]
+            Pending.append ((Child, Level + 1, ChildX))
+            ChildX += Child.Total * Scale
+
+    File.write ('</svg>\n')
+
+if __name__ == '__main__':
+    #
+    # Create command line argument parser object
+    #
+    parser = argparse.ArgumentParser (prog = __prog__,
+                                      description = __description__ + __copyright__,
+                                      conflict_handler = 'resolve')
+    parser.add_argument ("-i", "--input", dest = 'InputFile', type = argparse.FileType ('r'), default = sys.stdin,
+                         help = "Debug log with the DXE Core call profile. Standard input if not given.")
+    parser.add_argument ("-o", "--output", dest = 'OutputFile', type = argparse.FileType ('w'),
+                         help = "Flame graph SVG file to write.")
+    parser.add_argument ("-f", "--folded", dest = 'FoldedFile', type = argparse.FileType ('w'),
+                         help = "Folded stacks file to write, for other flame graph tools.")
+    parser.add_argument ("-t", "--title", dest = 'Title', default = 'DXE Core Call Profile',
+                         help = "Title of the flame graph.")
+    parser.add_argument ("-w", "--width", dest = 'Width', type = int, default = 1200,
+                         help = "Width of the flame graph in pixels. Default is 1200.")
+    parser.add_argument ("-m", "--min-width", dest = 'MinWidth', type = float, default = 0.1,
+                         help = "Frames narrower than this many pixels are omitted. Default is 0.1.")
+    parser.add_argument ("--inverted", dest = 'Inverted', action = "store_true",
+                         help = "Draw an icicle graph, with the root frame at the top.")
+    parser.add_argument ("-v", "--verbose", dest = 'Verbose', action = "store_true",
+                         help = "Increase output messages")
+
+    #
+    # Parse command line arguments
+    #
+    args = parser.parse_args ()
+
+    if args.OutputFile is None and args.FoldedFile is None:
+        print ('DxeProfileToFlameGraph: error: at least one of --output and --folded is required.')
+        sys.exit (1)
+
+    Profile = ReadProfile (args.InputFile)
+    if not Profile:
+        print ('DxeProfileToFlameGraph: error: no complete DXE Core call profile found in the debug log.')
+        sys.exit (1)
+
+    if args.FoldedFile is not None:
+        for Stack, Value in Profile:
+            args.FoldedFile.write ('{Stack} {Value}\n'.format (Stack = Stack, Value = Value))
+        args.FoldedFile.close ()
+
+    Root = BuildTree (Profile)
+    if args.Verbose:
+        print ('DxeProfileToFlameGraph: {Count} stacks, {Time} in total'.format (Count = len (Profile), Time = FormatTime (Root.Total)))
+
+    if args.OutputFile is not None:
+        WriteFlameGraph (args.OutputFile, Root, args.Title, args.Width, args.MinWidth, args.Inverted)
+        args.OutputFile.close ()
@@ -0,0 +1,23 @@
+@REM @file
+@REM This script will exec BrotliCompress tool with the --chunk-size option, so that
+@REM the output is made of independent chunks that can be decompressed in parallel.
+@REM
+@REM Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+@REM SPDX-License-Identifier: BSD-2-Clause-Patent
+@REM
+
+@echo off
+@setlocal
+
+:Begin
+if "%1"=="" goto End
+if "%1"=="-e" (
+  set FLAG=-c 0x100000
+)
+set ARGS=%ARGS% %1
+shift
+goto Begin
+
+:End
+BrotliCompress %ARGS% %FLAG%
+@echo on
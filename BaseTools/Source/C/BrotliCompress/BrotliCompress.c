@@ -21,6 +21,9 @@
 #include "./brotli/c/common/version.h"
 #include <brotli/decode.h>
 #include <brotli/encode.h>
+#include <Common/UefiBaseTypes.h>
+#include <Common/PiFirmwareFile.h>
+#include <Guid/ChunkedDecompress.h>
 
 #if !defined(_WIN32)
 #include <unistd.h>
@@ -96,6 +99,9 @@ static void Usage() {
 "  -q NUM, --quality=NUM       compression level (%d-%d)\n",
           BROTLI_MIN_QUALITY, BROTLI_MAX_QUALITY);
   printf(
+"  -c NUM, --chunk-size=NUM    compress independent chunks of NUM bytes\n"
+"                              that can be decompressed in parallel\n");
+  printf(
 "  -v, --version               display version and exit\n");
 }
 
@@ -395,23 +401,331 @@ Finish:
   return IsOk;
 }
 
+/*
+  Compress InputFile and fill in the decoder header with the decoded size and
+  the scratch buffer size the decoder needs.
+*/
+int CompressFileWithHeader(char *InputFile, uint8_t *InputBuffer, char *OutputFile, uint8_t *OutputBuffer, int Quality, int Gap) {
+  char OutputTmpFile[_MAX_PATH];
+  FILE *OutputHandle;
+  int64_t Size;
+  int Ret;
+
+  //
+  // Compress file
+  //
+  Ret = CompressFile(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
+  if (!Ret) {
+    printf ("Failed to compress file [%s]\n", InputFile);
+    return BROTLI_FALSE;
+  }
+  //
+  // Decompress file for get Outputfile size
+  //
+  if (strlen(OutputFile) + strlen(".tmp") < _MAX_PATH) {
+    strcpy (OutputTmpFile, OutputFile);
+    strcat(OutputTmpFile, ".tmp");
+  } else {
+    printf ("Output file path is too long[%s]\n", OutputFile);
+    return BROTLI_FALSE;
+  }
+  memset(InputBuffer, 0, kFileBufferSize);
+  memset(OutputBuffer, 0, kFileBufferSize);
+  ScratchBufferSize = 0;
+  Ret = DecompressFile(OutputFile, InputBuffer, OutputTmpFile, OutputBuffer, Quality, Gap);
+  if (!Ret) {
+    printf ("Failed to decompress file [%s]\n", OutputFile);
+    return BROTLI_FALSE;
+  }
+  remove (OutputTmpFile);
+
+  //
+  // fill decoder header
+  //
+  Size = FileSize(InputFile);
+  OutputHandle = fopen(OutputFile, "rb+"); /* open output_path file and add in head info */
+  if (OutputHandle == NULL) {
+    printf("Failed to open output file [%s]\n", OutputFile);
+    return BROTLI_FALSE;
+  }
+  fwrite(&Size, 1, sizeof(int64_t), OutputHandle);
+  ScratchBufferSize += Gap * GAP_MEM_BLOCK; /* there is a memory gap between IA32 and X64 environment*/
+  ScratchBufferSize += kFileBufferSize * 2;
+  Size = (int64_t) ScratchBufferSize;
+  fwrite(&Size, 1, sizeof(int64_t), OutputHandle);
+  if (fclose(OutputHandle) != 0) {
+    printf("Failed to close output file [%s]\n", OutputFile);
+    return BROTLI_FALSE;
+  }
+  return BROTLI_TRUE;
+}
+
+static uint8_t *ReadWholeFile(const char *Path, size_t *Size) {
+  FILE *FileHandle;
+  int64_t FileLength;
+  uint8_t *Data;
+
+  FileLength = FileSize(Path);
+  if (FileLength < 0) {
+    return NULL;
+  }
+  FileHandle = fopen(Path, "rb");
+  if (FileHandle == NULL) {
+    return NULL;
+  }
+  Data = (uint8_t *)malloc((size_t)FileLength + 1);
+  if (Data != NULL && fread(Data, 1, (size_t)FileLength, FileHandle) != (size_t)FileLength) {
+    free(Data);
+    Data = NULL;
+  }
+  fclose(FileHandle);
+  *Size = (size_t)FileLength;
+  return Data;
+}
+
+static int WriteWholeFile(const char *Path, const uint8_t *Data, size_t Size) {
+  FILE *FileHandle;
+  size_t Written;
+
+  FileHandle = fopen(Path, "wb");
+  if (FileHandle == NULL) {
+    printf("Failed to open file [%s]\n", Path);
+    return BROTLI_FALSE;
+  }
+  Written = fwrite(Data, 1, Size, FileHandle);
+  if (fclose(FileHandle) != 0 || Written != Size) {
+    printf("Failed to write file [%s]\n", Path);
+    return BROTLI_FALSE;
+  }
+  return BROTLI_TRUE;
+}
+
+static int MakeTmpPath(char *TmpPath, const char *Path, const char *Suffix) {
+  if (strlen(Path) + strlen(Suffix) >= _MAX_PATH) {
+    printf ("Output file path is too long[%s]\n", Path);
+    return BROTLI_FALSE;
+  }
+  strcpy(TmpPath, Path);
+  strcat(TmpPath, Suffix);
+  return BROTLI_TRUE;
+}
+
+int IsChunkedFile(char *InputFile) {
+  FILE *FileHandle;
+  CHUNKED_DECOMPRESS_HEADER Header;
+  size_t Read;
+
+  FileHandle = fopen(InputFile, "rb");
+  if (FileHandle == NULL) {
+    return BROTLI_FALSE;
+  }
+  Read = fread(&Header, 1, sizeof (Header), FileHandle);
+  fclose(FileHandle);
+  return Read == sizeof (Header) &&
+         Header.Signature == CHUNKED_DECOMPRESS_SIGNATURE &&
+         Header.ChunkSize != 0 &&
+         Header.ChunkCount == ((uint64_t)Header.DecodedSize + Header.ChunkSize - 1) / Header.ChunkSize;
+}
+
+/*
+  Compress InputFile as independent chunks of ChunkSize bytes, each of them
+  wrapped in a complete Brotli GUIDed section, behind a CHUNKED_DECOMPRESS_HEADER.
+*/
+int CompressFileChunked(char *InputFile, uint8_t *InputBuffer, char *OutputFile, uint8_t *OutputBuffer, int Quality, int Gap, uint32_t ChunkSize) {
+  CHUNKED_DECOMPRESS_HEADER Header;
+  EFI_GUID_DEFINED_SECTION Section;
+  EFI_GUID BrotliGuid = BROTLI_CUSTOM_DECOMPRESS_GUID;
+  static const uint8_t Padding[3] = { 0, 0, 0 };
+  char ChunkFile[_MAX_PATH];
+  char ChunkOutputFile[_MAX_PATH];
+  FILE *OutputHandle;
+  uint8_t *Input;
+  uint8_t *Chunk;
+  size_t InputSize;
+  size_t ChunkDataSize;
+  size_t Offset;
+  size_t Length;
+  size_t SectionSize;
+  size_t PadSize;
+  int Ret;
+
+  if (!MakeTmpPath(ChunkFile, OutputFile, ".chunk") ||
+      !MakeTmpPath(ChunkOutputFile, OutputFile, ".chunk.br")) {
+    return BROTLI_FALSE;
+  }
+
+  Input = ReadWholeFile(InputFile, &InputSize);
+  if (Input == NULL || InputSize == 0 || (uint64_t)InputSize > 0xFFFFFFFF) {
+    printf("Failed to read input [%s]\n", InputFile);
+    free(Input);
+    return BROTLI_FALSE;
+  }
+
+  OutputHandle = fopen(OutputFile, "wb");
+  if (OutputHandle == NULL) {
+    printf("Failed to open output file [%s]\n", OutputFile);
+    free(Input);
+    return BROTLI_FALSE;
+  }
+
+  Header.Signature   = CHUNKED_DECOMPRESS_SIGNATURE;
+  Header.ChunkCount  = (UINT32)((InputSize + ChunkSize - 1) / ChunkSize);
+  Header.ChunkSize   = ChunkSize;
+  Header.DecodedSize = (UINT32)InputSize;
+  Ret = fwrite(&Header, 1, sizeof (Header), OutputHandle) == sizeof (Header);
+
+  memset(&Section, 0, sizeof (Section));
+  Section.CommonHeader.Type     = EFI_SECTION_GUID_DEFINED;
+  Section.SectionDefinitionGuid = BrotliGuid;
+  Section.DataOffset            = sizeof (Section);
+  Section.Attributes            = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+
+  for (Offset = 0; Ret && Offset < InputSize; Offset += Length) {
+    Length = InputSize - Offset < ChunkSize ? InputSize - Offset : ChunkSize;
+    Ret = WriteWholeFile(ChunkFile, Input + Offset, Length) &&
+          CompressFileWithHeader(ChunkFile, InputBuffer, ChunkOutputFile, OutputBuffer, Quality, Gap);
+    if (!Ret) {
+      break;
+    }
+
+    Chunk = ReadWholeFile(ChunkOutputFile, &ChunkDataSize);
+    if (Chunk == NULL) {
+      Ret = BROTLI_FALSE;
+      break;
+    }
+
+    SectionSize = sizeof (Section) + ChunkDataSize;
+    if (SectionSize > 0xFFFFFF) {
+      printf("Chunk too large, use a smaller chunk size\n");
+      free(Chunk);
+      Ret = BROTLI_FALSE;
+      break;
+    }
+    Section.CommonHeader.Size[0] = (UINT8)SectionSize;
+    Section.CommonHeader.Size[1] = (UINT8)(SectionSize >> 8);
+    Section.CommonHeader.Size[2] = (UINT8)(SectionSize >> 16);
+    PadSize = (Offset + Length < InputSize) ? (4 - SectionSize % 4) % 4 : 0;
+
+    Ret = fwrite(&Section, 1, sizeof (Section), OutputHandle) == sizeof (Section) &&
+          fwrite(Chunk, 1, ChunkDataSize, OutputHandle) == ChunkDataSize &&
+          fwrite(Padding, 1, PadSize, OutputHandle) == PadSize;
+    free(Chunk);
+  }
+
+  remove(ChunkFile);
+  remove(ChunkOutputFile);
+  free(Input);
+  if (fclose(OutputHandle) != 0 || !Ret) {
+    printf("Failed to compress file [%s]\n", InputFile);
+    return BROTLI_FALSE;
+  }
+  return BROTLI_TRUE;
+}
+
+int DecompressFileChunked(char *InputFile, uint8_t *InputBuffer, char *OutputFile, uint8_t *OutputBuffer, int Quality, int Gap) {
+  CHUNKED_DECOMPRESS_HEADER *Header;
+  EFI_GUID_DEFINED_SECTION *Section;
+  EFI_GUID BrotliGuid = BROTLI_CUSTOM_DECOMPRESS_GUID;
+  char ChunkFile[_MAX_PATH];
+  char ChunkOutputFile[_MAX_PATH];
+  FILE *OutputHandle;
+  uint8_t *Input;
+  uint8_t *Chunk;
+  size_t InputSize;
+  size_t ChunkDataSize;
+  size_t Offset;
+  size_t SectionSize;
+  uint64_t DecodedSize;
+  uint32_t Index;
+  int Ret;
+
+  if (!MakeTmpPath(ChunkFile, OutputFile, ".chunk.br") ||
+      !MakeTmpPath(ChunkOutputFile, OutputFile, ".chunk")) {
+    return BROTLI_FALSE;
+  }
+
+  Input = ReadWholeFile(InputFile, &InputSize);
+  if (Input == NULL) {
+    printf("Failed to read input [%s]\n", InputFile);
+    return BROTLI_FALSE;
+  }
+
+  OutputHandle = fopen(OutputFile, "wb");
+  if (OutputHandle == NULL) {
+    printf("Failed to open output file [%s]\n", OutputFile);
+    free(Input);
+    return BROTLI_FALSE;
+  }
+
+  Header      = (CHUNKED_DECOMPRESS_HEADER *)Input;
+  Offset      = sizeof (*Header);
+  DecodedSize = 0;
+  Ret         = BROTLI_TRUE;
+  for (Index = 0; Ret && Index < Header->ChunkCount; Index++) {
+    Offset = (Offset + 3) & ~(size_t)3;
+    if (InputSize < Offset || InputSize - Offset < sizeof (*Section)) {
+      Ret = BROTLI_FALSE;
+      break;
+    }
+    Section     = (EFI_GUID_DEFINED_SECTION *)(Input + Offset);
+    SectionSize = Section->CommonHeader.Size[0] |
+                  (Section->CommonHeader.Size[1] << 8) |
+                  (Section->CommonHeader.Size[2] << 16);
+    if (Section->CommonHeader.Type != EFI_SECTION_GUID_DEFINED ||
+        memcmp(&Section->SectionDefinitionGuid, &BrotliGuid, sizeof (EFI_GUID)) != 0 ||
+        SectionSize < sizeof (*Section) || SectionSize > InputSize - Offset ||
+        Section->DataOffset < sizeof (*Section) || Section->DataOffset > SectionSize) {
+      Ret = BROTLI_FALSE;
+      break;
+    }
+
+    memset(InputBuffer, 0, kFileBufferSize);
+    memset(OutputBuffer, 0, kFileBufferSize);
+    Ret = WriteWholeFile(ChunkFile, Input + Offset + Section->DataOffset, SectionSize - Section->DataOffset) &&
+          DecompressFile(ChunkFile, InputBuffer, ChunkOutputFile, OutputBuffer, Quality, Gap);
+    if (!Ret) {
+      break;
+    }
+
+    Chunk = ReadWholeFile(ChunkOutputFile, &ChunkDataSize);
+    if (Chunk == NULL) {
+      Ret = BROTLI_FALSE;
+      break;
+    }
+    Ret = fwrite(Chunk, 1, ChunkDataSize, OutputHandle) == ChunkDataSize;
+    free(Chunk);
+    DecodedSize += ChunkDataSize;
+    Offset      += SectionSize;
+  }
+
+  if (Ret && DecodedSize != Header->DecodedSize) {
+    printf("Corrupt input [%s]\n", InputFile);
+    Ret = BROTLI_FALSE;
+  }
+
+  remove(ChunkFile);
+  remove(ChunkOutputFile);
+  free(Input);
+  if (fclose(OutputHandle) != 0) {
+    return BROTLI_FALSE;
+  }
+  return Ret;
+}
+
 int main(int argc, char** argv) {
   BROTLI_BOOL CompressBool;
   BROTLI_BOOL DecompressBool;
   char *OutputFile;
   char *InputFile;
-  char OutputTmpFile[_MAX_PATH];
-  FILE *OutputHandle;
   int Quality;
   int Gap;
   int OutputFileLength;
   int InputFileLength;
   int Ret;
-  size_t InputFileSize;
   uint8_t *Buffer;
   uint8_t *InputBuffer;
   uint8_t *OutputBuffer;
-  int64_t Size;
+  uint32_t ChunkSize;
 
   InputFile = NULL;
   OutputFile = NULL;
@@ -422,7 +736,7 @@ int main(int argc, char** argv) {
   //
   Quality = 9;
   Gap = 1;
-  InputFileSize = 0;
+  ChunkSize = 0;
   Ret = 0;
 
   if (argc < 2) {
@@ -504,6 +818,22 @@ int main(int argc, char** argv) {
       argv++;
       continue;
     }
+    if (strcmp(argv[1], "-c") == 0 || strncmp(argv[1], "--chunk-size", 12) == 0) {
+      if (strcmp(argv[1], "-c") == 0) {
+        ChunkSize = (uint32_t)strtoul(argv[2], NULL, 0);
+        argc--;
+        argv++;
+      } else {
+        ChunkSize = (uint32_t)strtoul((char *)argv[1] + 13, NULL, 0);
+      }
+      if (ChunkSize == 0 || ChunkSize > CHUNKED_DECOMPRESS_MAX_CHUNK_SIZE) {
+        printf("Invalid chunk size\n");
+        return 1;
+      }
+      argc--;
+      argv++;
+      continue;
+    }
     if (argc > 1) {
       InputFileLength = strlen(argv[1]);
       if (InputFileLength > _MAX_PATH - 1) {
@@ -529,51 +859,17 @@ int main(int argc, char** argv) {
   InputBuffer = Buffer;
   OutputBuffer = Buffer + kFileBufferSize;
   if (CompressBool) {
-    //
-    // Compress file
-    //
-    Ret = CompressFile(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
-    if (!Ret) {
-      printf ("Failed to compress file [%s]\n", InputFile);
-      goto Finish;
-    }
-    //
-    // Decompress file for get Outputfile size
-    //
-    strcpy (OutputTmpFile, OutputFile);
-    if (strlen(InputFile) + strlen(".tmp") < _MAX_PATH) {
-      strcat(OutputTmpFile, ".tmp");
+    if (ChunkSize != 0) {
+      Ret = CompressFileChunked(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap, ChunkSize);
     } else {
-      printf ("Output file path is too long[%s]\n", OutputFile);
-      Ret = BROTLI_FALSE;
-      goto Finish;
-    }
-    memset(Buffer, 0, kFileBufferSize*2);
-    Ret = DecompressFile(OutputFile, InputBuffer, OutputTmpFile, OutputBuffer, Quality, Gap);
-    if (!Ret) {
-      printf ("Failed to decompress file [%s]\n", OutputFile);
-      goto Finish;
-    }
-    remove (OutputTmpFile);
-
-    //
-    // fill decoder header
-    //
-    InputFileSize = FileSize(InputFile);
-    Size = (int64_t)InputFileSize;
-    OutputHandle = fopen(OutputFile, "rb+"); /* open output_path file and add in head info */
-    fwrite(&Size, 1, sizeof(int64_t), OutputHandle);
-    ScratchBufferSize += Gap * GAP_MEM_BLOCK; /* there is a memory gap between IA32 and X64 environment*/
-    ScratchBufferSize += kFileBufferSize * 2;
-    Size = (int64_t) ScratchBufferSize;
-    fwrite(&Size, 1, sizeof(int64_t), OutputHandle);
-    if (fclose(OutputHandle) != 0) {
-      printf("Failed to close output file [%s]\n", OutputFile);
-      Ret = BROTLI_FALSE;
-      goto Finish;
+      Ret = CompressFileWithHeader(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
     }
   } else {
-    Ret = DecompressFile(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
+    if (IsChunkedFile(InputFile)) {
+      Ret = DecompressFileChunked(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
+    } else {
+      Ret = DecompressFile(InputFile, InputBuffer, OutputFile, OutputBuffer, Quality, Gap);
+    }
     if (!Ret) {
       printf ("Failed to decompress file [%s]\n", InputFile);
       goto Finish;
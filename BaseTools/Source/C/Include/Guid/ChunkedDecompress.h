@@ -0,0 +1,56 @@
+/** @file
+  GUIDs and data layout of chunked LZMA/Brotli compressed GUIDed sections.
+
+  The section data starts with a CHUNKED_DECOMPRESS_HEADER, followed by
+  ChunkCount complete GUIDed sections of the single stream algorithm, each
+  4-byte aligned and decoding to ChunkSize bytes, except for the last one.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CHUNKED_DECOMPRESS_GUID_H__
+#define __CHUNKED_DECOMPRESS_GUID_H__
+
+#define LZMA_CUSTOM_DECOMPRESS_GUID \
+  { \
+    0xEE4E5898, 0x3914, 0x4259, {0x9D, 0x6E, 0xDC, 0x7B, 0xD7, 0x94, 0x03, 0xCF } \
+  }
+
+#define LZMAF86_CUSTOM_DECOMPRESS_GUID \
+  { \
+    0xD42AE6BD, 0x1352, 0x4BFB, {0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } \
+  }
+
+#define BROTLI_CUSTOM_DECOMPRESS_GUID \
+  { \
+    0x3D532050, 0x5CDA, 0x4FD0, {0x87, 0x9E, 0x0F, 0x7F, 0x63, 0x0D, 0x5A, 0xFB } \
+  }
+
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID \
+  { \
+    0x516095F4, 0x1753, 0x4DFF, {0x80, 0xA4, 0x98, 0x86, 0x7A, 0xF9, 0x42, 0xC4 } \
+  }
+
+#define BROTLI_CHUNKED_CUSTOM_DECOMPRESS_GUID \
+  { \
+    0xF69E4A4F, 0x0C47, 0x443C, {0x9A, 0xAE, 0x39, 0xEA, 0xD8, 0x97, 0x2A, 0xF2 } \
+  }
+
+#define CHUNKED_DECOMPRESS_SIGNATURE  0x4B484343  // "CCHK"
+
+//
+// Keeps every chunk in a section with a 24-bit size.
+//
+#define CHUNKED_DECOMPRESS_MAX_CHUNK_SIZE  0x800000
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    ChunkCount;
+  UINT32    ChunkSize;
+  UINT32    DecodedSize;
+} CHUNKED_DECOMPRESS_HEADER;
+
+#endif
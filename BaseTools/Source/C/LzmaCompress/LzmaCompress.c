@@ -24,6 +24,8 @@
 #include "Sdk/C/Bra.h"
 #include "CommonLib.h"
 #include "ParseInf.h"
+#include <Common/PiFirmwareFile.h>
+#include <Guid/ChunkedDecompress.h>
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
@@ -44,6 +46,7 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mChunkSize = 0;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -60,6 +63,8 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunk-size Size: encode independent chunks of Size bytes that\n"
+             "                     can be decoded in parallel\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -94,40 +99,22 @@ void PrintVersion(char *buffer)
   sprintf (buffer, "%s Version %d.%d %s ", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
 }
 
-static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+static SRes EncodeBuffer(const Byte *inBuffer, size_t inSize, CLzmaEncProps *props, Byte **outBuffer, size_t *outSize)
 {
   SRes res;
-  size_t inSize = (size_t)fileSize;
-  Byte *inBuffer = 0;
-  Byte *outBuffer = 0;
   Byte *filteredStream = 0;
-  size_t outSize;
-
-  if (inSize != 0) {
-    inBuffer = (Byte *)MyAlloc(inSize);
-    if (inBuffer == 0)
-      return SZ_ERROR_MEM;
-  } else {
-    return SZ_ERROR_INPUT_EOF;
-  }
-
-  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
-    res = SZ_ERROR_READ;
-    goto Done;
-  }
 
   // we allocate 105% of original size + 64KB for output buffer
-  outSize = (size_t)fileSize / 20 * 21 + (1 << 16);
-  outBuffer = (Byte *)MyAlloc(outSize);
-  if (outBuffer == 0) {
-    res = SZ_ERROR_MEM;
-    goto Done;
+  *outSize = inSize / 20 * 21 + (1 << 16);
+  *outBuffer = (Byte *)MyAlloc(*outSize);
+  if (*outBuffer == 0) {
+    return SZ_ERROR_MEM;
   }
 
   {
     int i;
     for (i = 0; i < 8; i++)
-      outBuffer[i + LZMA_PROPS_SIZE] = (Byte)(fileSize >> (8 * i));
+      (*outBuffer)[i + LZMA_PROPS_SIZE] = (Byte)((UInt64)inSize >> (8 * i));
   }
 
   if (mConType != NoConverter)
@@ -149,31 +136,248 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
   }
 
   {
-    size_t outSizeProcessed = outSize - LZMA_HEADER_SIZE;
+    size_t outSizeProcessed = *outSize - LZMA_HEADER_SIZE;
     size_t outPropsSize = LZMA_PROPS_SIZE;
 
-    res = LzmaEncode(outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
+    res = LzmaEncode(*outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
         mConType != NoConverter ? filteredStream : inBuffer, inSize,
-        props, outBuffer, &outPropsSize, 0,
+        props, *outBuffer, &outPropsSize, 0,
         NULL, &g_Alloc, &g_Alloc);
 
     if (res != SZ_OK)
       goto Done;
 
-    outSize = LZMA_HEADER_SIZE + outSizeProcessed;
+    *outSize = LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+
+Done:
+  MyFree(filteredStream);
+  if (res != SZ_OK) {
+    MyFree(*outBuffer);
+    *outBuffer = 0;
+  }
+
+  return res;
+}
+
+//
+// Write the input as independently compressed chunks, each of them wrapped in
+// a complete LZMA GUIDed section, behind a CHUNKED_DECOMPRESS_HEADER.
+//
+static SRes EncodeChunks(ISeqOutStream *outStream, const Byte *inBuffer, size_t inSize, CLzmaEncProps *props)
+{
+  SRes res;
+  CHUNKED_DECOMPRESS_HEADER header;
+  EFI_GUID_DEFINED_SECTION section;
+  EFI_GUID lzmaGuid = LZMA_CUSTOM_DECOMPRESS_GUID;
+  EFI_GUID lzmaF86Guid = LZMAF86_CUSTOM_DECOMPRESS_GUID;
+  static const Byte padding[3] = { 0, 0, 0 };
+  Byte *outBuffer;
+  size_t outSize;
+  size_t offset;
+  size_t chunkSize;
+  size_t sectionSize;
+  size_t padSize;
+
+  if ((UInt64)inSize > 0xFFFFFFFF) {
+    return SZ_ERROR_PARAM;
+  }
+
+  header.Signature   = CHUNKED_DECOMPRESS_SIGNATURE;
+  header.ChunkCount  = (UINT32)((inSize + mChunkSize - 1) / mChunkSize);
+  header.ChunkSize   = (UINT32)mChunkSize;
+  header.DecodedSize = (UINT32)inSize;
+  if (outStream->Write(outStream, &header, sizeof (header)) != sizeof (header))
+    return SZ_ERROR_WRITE;
+
+  memset(&section, 0, sizeof (section));
+  section.CommonHeader.Type      = EFI_SECTION_GUID_DEFINED;
+  section.SectionDefinitionGuid  = (mConType == X86Converter) ? lzmaF86Guid : lzmaGuid;
+  section.DataOffset             = sizeof (section);
+  section.Attributes             = EFI_GUIDED_SECTION_PROCESSING_REQUIRED;
+
+  for (offset = 0; offset < inSize; offset += chunkSize) {
+    chunkSize = inSize - offset < (size_t)mChunkSize ? inSize - offset : (size_t)mChunkSize;
+
+    res = EncodeBuffer(inBuffer + offset, chunkSize, props, &outBuffer, &outSize);
+    if (res != SZ_OK)
+      return res;
+
+    sectionSize = sizeof (section) + outSize;
+    if (sectionSize > 0xFFFFFF) {
+      MyFree(outBuffer);
+      return SZ_ERROR_PARAM;
+    }
+
+    section.CommonHeader.Size[0] = (UINT8)sectionSize;
+    section.CommonHeader.Size[1] = (UINT8)(sectionSize >> 8);
+    section.CommonHeader.Size[2] = (UINT8)(sectionSize >> 16);
+    padSize = (offset + chunkSize < inSize) ? (4 - sectionSize % 4) % 4 : 0;
+
+    if ((outStream->Write(outStream, &section, sizeof (section)) != sizeof (section)) ||
+        (outStream->Write(outStream, outBuffer, outSize) != outSize) ||
+        (outStream->Write(outStream, padding, padSize) != padSize)) {
+      MyFree(outBuffer);
+      return SZ_ERROR_WRITE;
+    }
+
+    MyFree(outBuffer);
   }
 
+  return SZ_OK;
+}
+
+static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+
+  if (inSize != 0) {
+    inBuffer = (Byte *)MyAlloc(inSize);
+    if (inBuffer == 0)
+      return SZ_ERROR_MEM;
+  } else {
+    return SZ_ERROR_INPUT_EOF;
+  }
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  if (mChunkSize != 0) {
+    res = EncodeChunks(outStream, inBuffer, inSize, props);
+    goto Done;
+  }
+
+  res = EncodeBuffer(inBuffer, inSize, props, &outBuffer, &outSize);
+  if (res != SZ_OK)
+    goto Done;
+
   if (outStream->Write(outStream, outBuffer, outSize) != outSize)
     res = SZ_ERROR_WRITE;
 
 Done:
   MyFree(outBuffer);
   MyFree(inBuffer);
-  MyFree(filteredStream);
 
   return res;
 }
 
+static SRes DecodeBuffer(const Byte *inBuffer, size_t inSize, CONVERTER_TYPE conType, Byte **outBuffer, size_t *outSize)
+{
+  SRes res;
+  size_t inSizePure;
+  ELzmaStatus status;
+  UInt64 outSize64 = 0;
+  int i;
+
+  *outBuffer = 0;
+  *outSize = 0;
+
+  if (inSize < LZMA_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  for (i = 0; i < 8; i++)
+    outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
+
+  *outSize = (size_t)outSize64;
+  if (*outSize == 0)
+    return SZ_OK;
+
+  *outBuffer = (Byte *)MyAlloc(*outSize);
+  if (*outBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  inSizePure = inSize - LZMA_HEADER_SIZE;
+  res = LzmaDecode(*outBuffer, outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
+      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+
+  if (res != SZ_OK) {
+    MyFree(*outBuffer);
+    *outBuffer = 0;
+    return res;
+  }
+
+  if (conType == X86Converter)
+  {
+    UInt32 x86State;
+    x86_Convert_Init(x86State);
+    x86_Convert(*outBuffer, (SizeT) *outSize, 0, &x86State, 0);
+  }
+
+  return SZ_OK;
+}
+
+static BoolInt IsChunked(const Byte *inBuffer, size_t inSize)
+{
+  const CHUNKED_DECOMPRESS_HEADER *header = (const CHUNKED_DECOMPRESS_HEADER *)inBuffer;
+
+  return inSize >= sizeof (*header) &&
+         header->Signature == CHUNKED_DECOMPRESS_SIGNATURE &&
+         header->ChunkSize != 0 &&
+         header->ChunkCount == ((UInt64)header->DecodedSize + header->ChunkSize - 1) / header->ChunkSize;
+}
+
+static SRes DecodeChunks(ISeqOutStream *outStream, const Byte *inBuffer, size_t inSize)
+{
+  SRes res;
+  const CHUNKED_DECOMPRESS_HEADER *header = (const CHUNKED_DECOMPRESS_HEADER *)inBuffer;
+  const EFI_GUID_DEFINED_SECTION *section;
+  EFI_GUID lzmaGuid = LZMA_CUSTOM_DECOMPRESS_GUID;
+  EFI_GUID lzmaF86Guid = LZMAF86_CUSTOM_DECOMPRESS_GUID;
+  CONVERTER_TYPE conType;
+  Byte *outBuffer;
+  size_t outSize;
+  size_t offset;
+  size_t sectionSize;
+  UInt64 decodedSize = 0;
+  UINT32 index;
+
+  offset = sizeof (*header);
+  for (index = 0; index < header->ChunkCount; index++) {
+    offset = (offset + 3) & ~(size_t)3;
+    if (inSize < offset || inSize - offset < sizeof (*section))
+      return SZ_ERROR_DATA;
+
+    section = (const EFI_GUID_DEFINED_SECTION *)(inBuffer + offset);
+    sectionSize = section->CommonHeader.Size[0] |
+                  (section->CommonHeader.Size[1] << 8) |
+                  (section->CommonHeader.Size[2] << 16);
+    if (section->CommonHeader.Type != EFI_SECTION_GUID_DEFINED ||
+        sectionSize < sizeof (*section) || sectionSize > inSize - offset ||
+        section->DataOffset < sizeof (*section) || section->DataOffset > sectionSize)
+      return SZ_ERROR_DATA;
+
+    if (memcmp(&section->SectionDefinitionGuid, &lzmaGuid, sizeof (EFI_GUID)) == 0) {
+      conType = NoConverter;
+    } else if (memcmp(&section->SectionDefinitionGuid, &lzmaF86Guid, sizeof (EFI_GUID)) == 0) {
+      conType = X86Converter;
+    } else {
+      return SZ_ERROR_UNSUPPORTED;
+    }
+
+    res = DecodeBuffer(inBuffer + offset + section->DataOffset, sectionSize - section->DataOffset,
+        conType, &outBuffer, &outSize);
+    if (res != SZ_OK)
+      return res;
+
+    if (outStream->Write(outStream, outBuffer, outSize) != outSize) {
+      MyFree(outBuffer);
+      return SZ_ERROR_WRITE;
+    }
+
+    MyFree(outBuffer);
+    decodedSize += outSize;
+    offset += sectionSize;
+  }
+
+  return decodedSize == header->DecodedSize ? SZ_OK : SZ_ERROR_DATA;
+}
+
 static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
 {
   SRes res;
@@ -181,11 +385,6 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
   Byte *inBuffer = 0;
   Byte *outBuffer = 0;
   size_t outSize = 0;
-  size_t inSizePure;
-  ELzmaStatus status;
-  UInt64 outSize64 = 0;
-
-  int i;
 
   if (inSize < LZMA_HEADER_SIZE)
     return SZ_ERROR_INPUT_EOF;
@@ -199,35 +398,15 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
-  for (i = 0; i < 8; i++)
-    outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
-
-  outSize = (size_t)outSize64;
-  if (outSize != 0) {
-    outBuffer = (Byte *)MyAlloc(outSize);
-    if (outBuffer == 0) {
-      res = SZ_ERROR_MEM;
-      goto Done;
-    }
-  } else {
-    res = SZ_OK;
+  if (IsChunked(inBuffer, inSize)) {
+    res = DecodeChunks(outStream, inBuffer, inSize);
     goto Done;
   }
 
-  inSizePure = inSize - LZMA_HEADER_SIZE;
-  res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
-      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
-
+  res = DecodeBuffer(inBuffer, inSize, mConType, &outBuffer, &outSize);
   if (res != SZ_OK)
     goto Done;
 
-  if (mConType == X86Converter)
-  {
-    UInt32 x86State;
-    x86_Convert_Init(x86State);
-    x86_Convert(outBuffer, (SizeT) outSize, 0, &x86State, 0);
-  }
-
   if (outStream->Write(outStream, outBuffer, outSize) != outSize)
     res = SZ_ERROR_WRITE;
 
@@ -272,6 +451,14 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      if ((AsciiStringToUint64(args[++param], FALSE, &mChunkSize) != EFI_SUCCESS) ||
+          (mChunkSize == 0) || (mChunkSize > CHUNKED_DECOMPRESS_MAX_CHUNK_SIZE)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -99,6 +99,8 @@ class GUIDTools:
         struct2stream(ModifyGuidFormat("fc1bcdb0-7d31-49aa-936a-a4600d9dd083")): GUIDTool("fc1bcdb0-7d31-49aa-936a-a4600d9dd083", "CRC32", "GenCrc32"),
         struct2stream(ModifyGuidFormat("d42ae6bd-1352-4bfb-909a-ca72a6eae889")): GUIDTool("d42ae6bd-1352-4bfb-909a-ca72a6eae889", "LZMAF86", "LzmaF86Compress"),
         struct2stream(ModifyGuidFormat("3d532050-5cda-4fd0-879e-0f7f630d5afb")): GUIDTool("3d532050-5cda-4fd0-879e-0f7f630d5afb", "BROTLI", "BrotliCompress"),
+        struct2stream(ModifyGuidFormat("516095f4-1753-4dff-80a4-98867af942c4")): GUIDTool("516095f4-1753-4dff-80a4-98867af942c4", "LZMACHUNKED", "LzmaChunkedCompress"),
+        struct2stream(ModifyGuidFormat("f69e4a4f-0c47-443c-9aae-39ead8972af2")): GUIDTool("f69e4a4f-0c47-443c-9aae-39ead8972af2", "BROTLICHUNKED", "BrotliChunkedCompress"),
     }
 
     def __init__(self, tooldef_file: str=None) -> None:
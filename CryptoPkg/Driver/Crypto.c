@@ -1016,6 +1016,40 @@ CryptoServiceSha256HashAll (
   return CALL_BASECRYPTLIB (Sha256.Services.HashAll, Sha256HashAll, (Data, DataSize, HashValue), FALSE);
 }
 
+/**
+  Computes the SHA-256 message digests of several independent data buffers.
+
+  This function performs the SHA-256 message digest of each of the given data
+  buffers, and places the digest values into the specified memory. On the CPUs
+  with SHA extensions the buffers are hashed two at a time, the rounds of the
+  two messages interleaved, which gives a higher throughput than hashing them
+  one after the other.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   BufferCount  Number of data buffers.
+  @param[in]   Data         Array of pointers to the buffers containing the data to be hashed.
+  @param[in]   DataSize     Array of the sizes of the Data buffers in bytes.
+  @param[out]  HashValue    Array of pointers to the buffers that receive the SHA-256
+                            digest values (32 bytes each).
+
+  @retval TRUE   SHA-256 digest computation succeeded.
+  @retval FALSE  SHA-256 digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceSha256HashAllMultiple (
+  IN   UINTN        BufferCount,
+  IN   CONST VOID   **Data,
+  IN   CONST UINTN  *DataSize,
+  OUT  UINT8        **HashValue
+  )
+{
+  return CALL_BASECRYPTLIB (Sha256.Services.HashAllMultiple, Sha256HashAllMultiple, (BufferCount, Data, DataSize, HashValue), FALSE);
+}
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
 
@@ -5384,6 +5418,92 @@ CryptoServiceTlsGetExportKey (
            );
 }
 
+/**
+  Free a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+CryptoServiceTlsFreeSession (
+  IN     VOID  *Session
+  )
+{
+  CALL_VOID_BASECRYPTLIB (Tls.Services.FreeSession, TlsFreeSession, (Session));
+}
+
+/**
+  Sets a TLS session to be resumed during TLS/SSL connect.
+
+  This function offers a session saved with TlsGetSession() from an earlier
+  connection to the same server, with its session ID (TLS 1.2) or its session
+  ticket (TLS 1.3). If the server accepts it, the handshake is abbreviated and
+  the server certificate isn't sent nor verified again. Otherwise a full
+  handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be used by this TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+CryptoServiceTlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  return CALL_BASECRYPTLIB (TlsSet.Services.Session, TlsSetSession, (Tls, Session), EFI_UNSUPPORTED);
+}
+
+/**
+  Gets a copy of the session of the specified TLS connection for resumption.
+
+  This function returns a copy of the TLS session currently used by the
+  specified TLS connection, including the session ticket received from a
+  TLS 1.3 server, so that a later connection to the same server can resume
+  it with TlsSetSession(). The copy must be freed with TlsFreeSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @return  Pointer to the TLS session object, or NULL if there is no session
+           that can be resumed.
+
+**/
+VOID *
+EFIAPI
+CryptoServiceTlsGetSession (
+  IN     VOID  *Tls
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.Session, TlsGetSession, (Tls), NULL);
+}
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  session set with TlsSetSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The session was resumed.
+  @retval  FALSE    A full handshake was done, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceTlsGetSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.SessionReused, TlsGetSessionReused, (Tls), FALSE);
+}
+
 /**
   Carries out the RSA-SSA signature generation with EMSA-PSS encoding scheme.
 
@@ -6987,5 +7107,14 @@ const EDKII_CRYPTO_PROTOCOL  mEdkiiCrypto = {
   CryptoServiceX509VerifyCertChain,
   CryptoServiceX509GetCertFromCertChain,
   CryptoServiceAsn1GetTag,
-  CryptoServiceX509GetExtendedBasicConstraints
+  CryptoServiceX509GetExtendedBasicConstraints,
+  /// TLS (continued)
+  CryptoServiceTlsFreeSession,
+  /// TLS Set (continued)
+  CryptoServiceTlsSetSession,
+  /// TLS Get (continued)
+  CryptoServiceTlsGetSession,
+  CryptoServiceTlsGetSessionReused,
+  /// Sha256 (continued)
+  CryptoServiceSha256HashAllMultiple
 };
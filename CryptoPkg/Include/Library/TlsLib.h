@@ -90,6 +90,20 @@ TlsNew (
   IN     VOID  *TlsCtx
   );
 
+/**
+  Free a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID  *Session
+  );
+
 /**
   Checks if the TLS handshake was done.
 
@@ -458,6 +472,30 @@ TlsSetSessionId (
   IN     UINT16  SessionIdLen
   );
 
+/**
+  Sets a TLS session to be resumed during TLS/SSL connect.
+
+  This function offers a session saved with TlsGetSession() from an earlier
+  connection to the same server, with its session ID (TLS 1.2) or its session
+  ticket (TLS 1.3). If the server accepts it, the handshake is abbreviated and
+  the server certificate isn't sent nor verified again. Otherwise a full
+  handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be used by this TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  );
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -751,6 +789,42 @@ TlsGetSessionId (
   IN OUT UINT16  *SessionIdLen
   );
 
+/**
+  Gets a copy of the session of the specified TLS connection for resumption.
+
+  This function returns a copy of the TLS session currently used by the
+  specified TLS connection, including the session ticket received from a
+  TLS 1.3 server, so that a later connection to the same server can resume
+  it with TlsSetSession(). The copy must be freed with TlsFreeSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @return  Pointer to the TLS session object, or NULL if there is no session
+           that can be resumed.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls
+  );
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  session set with TlsSetSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The session was resumed.
+  @retval  FALSE    A full handshake was done, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsGetSessionReused (
+  IN     VOID  *Tls
+  );
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -174,12 +174,13 @@ typedef struct {
   } Sha1;
   union {
     struct {
-      UINT8    GetContextSize : 1;
-      UINT8    Init           : 1;
-      UINT8    Duplicate      : 1;
-      UINT8    Update         : 1;
-      UINT8    Final          : 1;
-      UINT8    HashAll        : 1;
+      UINT8    GetContextSize  : 1;
+      UINT8    Init            : 1;
+      UINT8    Duplicate       : 1;
+      UINT8    Update          : 1;
+      UINT8    Final           : 1;
+      UINT8    HashAll         : 1;
+      UINT8    HashAllMultiple : 1;
     } Services;
     UINT32    Family;
   } Sha256;
@@ -304,6 +305,7 @@ typedef struct {
       UINT8    Read           : 1;
       UINT8    Write          : 1;
       UINT8    Shutdown       : 1;
+      UINT8    FreeSession    : 1;
     } Services;
     UINT32    Family;
   } Tls;
@@ -323,6 +325,7 @@ typedef struct {
       UINT8    HostPrivateKeyEx   : 1;
       UINT8    SignatureAlgoList  : 1;
       UINT8    EcCurve            : 1;
+      UINT8    Session            : 1;
     } Services;
     UINT32    Family;
   } TlsSet;
@@ -342,6 +345,8 @@ typedef struct {
       UINT8    HostPrivateKey       : 1;
       UINT8    CertRevocationList   : 1;
       UINT8    ExportKey            : 1;
+      UINT8    Session              : 1;
+      UINT8    SessionReused        : 1;
     } Services;
     UINT32    Family;
   } TlsGet;
@@ -0,0 +1,67 @@
+/** @file
+  SHA-256 block functions for the CPUs without supported hash extensions.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/DebugLib.h>
+#include "CryptSha256Accel.h"
+
+/**
+  Check whether the CPU supports Sha256NiBlocks() and Sha256NiBlocksX2().
+
+  @retval FALSE  The CPU has no SHA extensions.
+
+**/
+BOOLEAN
+Sha256AccelIsSupported (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+/**
+  Process whole blocks of one message into its SHA-256 state.
+
+  @param[in, out]  State       The eight 32-bit words of the state, H0 first.
+  @param[in]       Data        The blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+VOID
+EFIAPI
+Sha256NiBlocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Process the same number of whole blocks of two independent messages into
+  their SHA-256 states, interleaving the rounds of the two.
+
+  @param[in, out]  State0      The state of the first message.
+  @param[in, out]  State1      The state of the second message.
+  @param[in]       Data0       The blocks of the first message.
+  @param[in]       Data1       The blocks of the second message.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data0 and in Data1.
+
+**/
+VOID
+EFIAPI
+Sha256NiBlocksX2 (
+  IN OUT UINT32       *State0,
+  IN OUT UINT32       *State1,
+  IN     CONST UINT8  *Data0,
+  IN     CONST UINT8  *Data1,
+  IN     UINTN        BlockCount
+  )
+{
+  ASSERT (FALSE);
+}
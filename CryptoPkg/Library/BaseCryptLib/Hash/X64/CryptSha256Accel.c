@@ -0,0 +1,50 @@
+/** @file
+  SHA extensions detection for the SHA-256 block functions on X64.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include "../CryptSha256Accel.h"
+
+#define CPUID_EXTENDED_FEATURES  0x07
+
+#define CPUID1_ECX_SSSE3           BIT9
+#define CPUID1_ECX_SSE4_1          BIT19
+#define CPUID7_EBX_SHA_EXTENSIONS  BIT29
+
+/**
+  Query the CPU for the instructions used by Sha256NiBlocks() and
+  Sha256NiBlocksX2().
+
+  @retval TRUE   Sha256NiBlocks() and Sha256NiBlocksX2() can be called.
+  @retval FALSE  The CPU has no SHA extensions.
+
+**/
+BOOLEAN
+Sha256AccelCheckCpu (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  Ebx;
+  UINT32  Ecx;
+
+  AsmCpuid (0, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_EXTENDED_FEATURES) {
+    return FALSE;
+  }
+
+  //
+  // The block functions also use PSHUFB (SSSE3) and PBLENDW (SSE4.1).
+  //
+  AsmCpuid (1, NULL, NULL, &Ecx, NULL);
+  if ((Ecx & (CPUID1_ECX_SSSE3 | CPUID1_ECX_SSE4_1)) != (CPUID1_ECX_SSSE3 | CPUID1_ECX_SSE4_1)) {
+    return FALSE;
+  }
+
+  AsmCpuidEx (CPUID_EXTENDED_FEATURES, 0, NULL, &Ebx, NULL, NULL);
+  return (BOOLEAN)((Ebx & CPUID7_EBX_SHA_EXTENSIONS) != 0);
+}
@@ -0,0 +1,36 @@
+/** @file
+  SHA extensions detection for the SHA-256 block functions on X64, cached for
+  the modules that run from memory.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../CryptSha256Accel.h"
+
+STATIC BOOLEAN  mSha256AccelChecked   = FALSE;
+STATIC BOOLEAN  mSha256AccelSupported = FALSE;
+
+/**
+  Check whether the CPU supports Sha256NiBlocks() and Sha256NiBlocksX2().
+
+  The CPU is only queried on the first call, Sha256Update() and
+  Sha256HashAll() then just read the cached result.
+
+  @retval TRUE   Sha256NiBlocks() and Sha256NiBlocksX2() can be called.
+  @retval FALSE  The CPU has no SHA extensions.
+
+**/
+BOOLEAN
+Sha256AccelIsSupported (
+  VOID
+  )
+{
+  if (!mSha256AccelChecked) {
+    mSha256AccelSupported = Sha256AccelCheckCpu ();
+    mSha256AccelChecked   = TRUE;
+  }
+
+  return mSha256AccelSupported;
+}
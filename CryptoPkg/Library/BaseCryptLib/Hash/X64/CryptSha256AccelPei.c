@@ -0,0 +1,28 @@
+/** @file
+  SHA extensions detection for the SHA-256 block functions on X64, for the
+  PEI instance.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../CryptSha256Accel.h"
+
+/**
+  Check whether the CPU supports Sha256NiBlocks() and Sha256NiBlocksX2().
+
+  The result isn't cached as PEIMs may execute in place from flash, where
+  they can't write to their global variables.
+
+  @retval TRUE   Sha256NiBlocks() and Sha256NiBlocksX2() can be called.
+  @retval FALSE  The CPU has no SHA extensions.
+
+**/
+BOOLEAN
+Sha256AccelIsSupported (
+  VOID
+  )
+{
+  return Sha256AccelCheckCpu ();
+}
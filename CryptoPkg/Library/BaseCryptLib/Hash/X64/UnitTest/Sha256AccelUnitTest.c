@@ -0,0 +1,497 @@
+/** @file
+  Host based unit tests of the SHA-256 block functions on the SHA extensions.
+
+  The host BaseLib answers CPUID with zeros, so the tests install a CPUID that
+  queries the host CPU. The block functions are then checked against a C
+  implementation of the SHA-256 compression function from FIPS 180-4. The
+  tests are skipped when the host CPU has no SHA extensions.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#if defined (_MSC_VER)
+  #include <intrin.h>
+#else
+  #include <cpuid.h>
+#endif
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestHostBaseLib.h>
+#include <Register/Intel/Cpuid.h>
+
+#include "../../CryptSha256Accel.h"
+
+#define UNIT_TEST_APP_NAME     "SHA-256 Block Functions Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Largest block count checked, and number of random states and messages
+// hashed for each block count.
+//
+#define TEST_MAX_BLOCKS  9
+#define TEST_ROUNDS      64
+
+#define ROTR32(Value, Count)  (((Value) >> (Count)) | ((Value) << (32 - (Count))))
+
+STATIC CONST UINT32  mSha256K[64] = {
+  0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+  0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+  0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+  0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+  0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+  0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+  0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+  0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+//
+// The message buffers have one spare byte to also hash unaligned blocks.
+//
+STATIC UINT8   mMessage0[TEST_MAX_BLOCKS * SHA256_ACCEL_BLOCK_SIZE + 1];
+STATIC UINT8   mMessage1[TEST_MAX_BLOCKS * SHA256_ACCEL_BLOCK_SIZE + 1];
+STATIC UINT32  mRandomSeed = 0x5EED;
+
+/**
+  Retrieves CPUID information of the host CPU using an extended leaf
+  identifier.
+
+  @param[in]   Index     The 32-bit value to load into EAX prior to invoking
+                         the CPUID instruction.
+  @param[in]   SubIndex  The 32-bit value to load into ECX prior to invoking
+                         the CPUID instruction.
+  @param[out]  Eax       The EAX value returned by CPUID. Optional.
+  @param[out]  Ebx       The EBX value returned by CPUID. Optional.
+  @param[out]  Ecx       The ECX value returned by CPUID. Optional.
+  @param[out]  Edx       The EDX value returned by CPUID. Optional.
+
+  @return Index.
+
+**/
+UINT32
+EFIAPI
+HostAsmCpuidEx (
+  IN  UINT32  Index,
+  IN  UINT32  SubIndex,
+  OUT UINT32  *Eax   OPTIONAL,
+  OUT UINT32  *Ebx   OPTIONAL,
+  OUT UINT32  *Ecx   OPTIONAL,
+  OUT UINT32  *Edx   OPTIONAL
+  )
+{
+  UINT32  Registers[4];
+
+ #if defined (_MSC_VER)
+  __cpuidex ((int *)Registers, (int)Index, (int)SubIndex);
+ #else
+  __cpuid_count (Index, SubIndex, Registers[0], Registers[1], Registers[2], Registers[3]);
+ #endif
+
+  if (Eax != NULL) {
+    *Eax = Registers[0];
+  }
+
+  if (Ebx != NULL) {
+    *Ebx = Registers[1];
+  }
+
+  if (Ecx != NULL) {
+    *Ecx = Registers[2];
+  }
+
+  if (Edx != NULL) {
+    *Edx = Registers[3];
+  }
+
+  return Index;
+}
+
+/**
+  Retrieves CPUID information of the host CPU.
+
+  @param[in]   Index  The 32-bit value to load into EAX prior to invoking the
+                      CPUID instruction.
+  @param[out]  Eax    The EAX value returned by CPUID. Optional.
+  @param[out]  Ebx    The EBX value returned by CPUID. Optional.
+  @param[out]  Ecx    The ECX value returned by CPUID. Optional.
+  @param[out]  Edx    The EDX value returned by CPUID. Optional.
+
+  @return Index.
+
+**/
+UINT32
+EFIAPI
+HostAsmCpuid (
+  IN  UINT32  Index,
+  OUT UINT32  *Eax   OPTIONAL,
+  OUT UINT32  *Ebx   OPTIONAL,
+  OUT UINT32  *Ecx   OPTIONAL,
+  OUT UINT32  *Edx   OPTIONAL
+  )
+{
+  return HostAsmCpuidEx (Index, 0, Eax, Ebx, Ecx, Edx);
+}
+
+/**
+  Retrieves CPUID information of the host CPU using an extended leaf
+  identifier, without the SHA extensions.
+
+  @param[in]   Index     The 32-bit value to load into EAX prior to invoking
+                         the CPUID instruction.
+  @param[in]   SubIndex  The 32-bit value to load into ECX prior to invoking
+                         the CPUID instruction.
+  @param[out]  Eax       The EAX value returned by CPUID. Optional.
+  @param[out]  Ebx       The EBX value returned by CPUID. Optional.
+  @param[out]  Ecx       The ECX value returned by CPUID. Optional.
+  @param[out]  Edx       The EDX value returned by CPUID. Optional.
+
+  @return Index.
+
+**/
+UINT32
+EFIAPI
+NoShaAsmCpuidEx (
+  IN  UINT32  Index,
+  IN  UINT32  SubIndex,
+  OUT UINT32  *Eax   OPTIONAL,
+  OUT UINT32  *Ebx   OPTIONAL,
+  OUT UINT32  *Ecx   OPTIONAL,
+  OUT UINT32  *Edx   OPTIONAL
+  )
+{
+  CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS_EBX  FeatureEbx;
+
+  HostAsmCpuidEx (Index, SubIndex, Eax, Ebx, Ecx, Edx);
+  if ((Index == CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) && (SubIndex == 0) && (Ebx != NULL)) {
+    FeatureEbx.Uint32   = *Ebx;
+    FeatureEbx.Bits.SHA = 0;
+    *Ebx                = FeatureEbx.Uint32;
+  }
+
+  return Index;
+}
+
+/**
+  Return the next number of a simple linear congruential generator, so that
+  every run checks the same states and messages.
+
+  @return A pseudo random 32-bit number.
+
+**/
+STATIC
+UINT32
+TestRandom32 (
+  VOID
+  )
+{
+  mRandomSeed = mRandomSeed * 1103515245 + 12345;
+  return (mRandomSeed >> 16) | (mRandomSeed << 16);
+}
+
+/**
+  Fill a buffer with pseudo random bytes.
+
+  @param[out]  Buffer  The buffer to fill.
+  @param[in]   Size    Size of Buffer in bytes.
+
+**/
+STATIC
+VOID
+TestRandomFill (
+  OUT VOID   *Buffer,
+  IN  UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    ((UINT8 *)Buffer)[Index] = (UINT8)TestRandom32 ();
+  }
+}
+
+/**
+  Process whole blocks into a SHA-256 state with the compression function of
+  FIPS 180-4.
+
+  @param[in, out]  State       The eight 32-bit words of the state, H0 first.
+  @param[in]       Data        The blocks.
+  @param[in]       BlockCount  Number of 64-byte blocks in Data.
+
+**/
+STATIC
+VOID
+ReferenceSha256Blocks (
+  IN OUT UINT32       *State,
+  IN     CONST UINT8  *Data,
+  IN     UINTN        BlockCount
+  )
+{
+  UINT32  W[64];
+  UINT32  V[8];
+  UINT32  T1;
+  UINT32  T2;
+  UINTN   Index;
+
+  for ( ; BlockCount > 0; BlockCount--, Data += SHA256_ACCEL_BLOCK_SIZE) {
+    for (Index = 0; Index < 16; Index++) {
+      W[Index] = SwapBytes32 (ReadUnaligned32 ((CONST UINT32 *)(Data + Index * 4)));
+    }
+
+    for ( ; Index < 64; Index++) {
+      W[Index] = (ROTR32 (W[Index - 2], 17) ^ ROTR32 (W[Index - 2], 19) ^ (W[Index - 2] >> 10)) + W[Index - 7] +
+                 (ROTR32 (W[Index - 15], 7) ^ ROTR32 (W[Index - 15], 18) ^ (W[Index - 15] >> 3)) + W[Index - 16];
+    }
+
+    CopyMem (V, State, sizeof (V));
+    for (Index = 0; Index < 64; Index++) {
+      T1 = V[7] + (ROTR32 (V[4], 6) ^ ROTR32 (V[4], 11) ^ ROTR32 (V[4], 25)) +
+           ((V[4] & V[5]) ^ (~V[4] & V[6])) + mSha256K[Index] + W[Index];
+      T2 = (ROTR32 (V[0], 2) ^ ROTR32 (V[0], 13) ^ ROTR32 (V[0], 22)) +
+           ((V[0] & V[1]) ^ (V[0] & V[2]) ^ (V[1] & V[2]));
+      CopyMem (&V[1], &V[0], 7 * sizeof (UINT32));
+      V[4] += T1;
+      V[0]  = T1 + T2;
+    }
+
+    for (Index = 0; Index < 8; Index++) {
+      State[Index] += V[Index];
+    }
+  }
+}
+
+/**
+  Skip the block function tests when the host CPU has no SHA extensions.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED   The host CPU has the SHA extensions.
+  @retval  UNIT_TEST_SKIPPED  The block functions can't run on the host CPU.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CheckShaExtensions (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (!Sha256AccelCheckCpu ()) {
+    UT_LOG_WARNING ("The host CPU has no SHA extensions, skipping.\n");
+    return UNIT_TEST_SKIPPED;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Sha256NiBlocks() gives the same state as the reference compression function
+  for aligned and unaligned messages of 0 to TEST_MAX_BLOCKS blocks.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The states match.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A state differs.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BlocksShouldMatchReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Expected[8];
+  UINT32  State[8];
+  UINTN   BlockCount;
+  UINTN   Round;
+  UINTN   Offset;
+
+  for (BlockCount = 0; BlockCount <= TEST_MAX_BLOCKS; BlockCount++) {
+    for (Round = 0; Round < TEST_ROUNDS; Round++) {
+      Offset = Round % 2;
+      TestRandomFill (mMessage0, sizeof (mMessage0));
+      TestRandomFill (Expected, sizeof (Expected));
+      CopyMem (State, Expected, sizeof (State));
+
+      ReferenceSha256Blocks (Expected, mMessage0 + Offset, BlockCount);
+      Sha256NiBlocks (State, mMessage0 + Offset, BlockCount);
+      UT_ASSERT_MEM_EQUAL (State, Expected, sizeof (State));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Sha256NiBlocksX2() gives the same two states as the reference compression
+  function applied to each message, for 0 to TEST_MAX_BLOCKS blocks.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The states match.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A state differs.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BlocksX2ShouldMatchReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Expected0[8];
+  UINT32  Expected1[8];
+  UINT32  State0[8];
+  UINT32  State1[8];
+  UINTN   BlockCount;
+  UINTN   Round;
+  UINTN   Offset;
+
+  for (BlockCount = 0; BlockCount <= TEST_MAX_BLOCKS; BlockCount++) {
+    for (Round = 0; Round < TEST_ROUNDS; Round++) {
+      Offset = Round % 2;
+      TestRandomFill (mMessage0, sizeof (mMessage0));
+      TestRandomFill (mMessage1, sizeof (mMessage1));
+      TestRandomFill (Expected0, sizeof (Expected0));
+      TestRandomFill (Expected1, sizeof (Expected1));
+      CopyMem (State0, Expected0, sizeof (State0));
+      CopyMem (State1, Expected1, sizeof (State1));
+
+      ReferenceSha256Blocks (Expected0, mMessage0 + Offset, BlockCount);
+      ReferenceSha256Blocks (Expected1, mMessage1, BlockCount);
+      Sha256NiBlocksX2 (State0, State1, mMessage0 + Offset, mMessage1, BlockCount);
+      UT_ASSERT_MEM_EQUAL (State0, Expected0, sizeof (State0));
+      UT_ASSERT_MEM_EQUAL (State1, Expected1, sizeof (State1));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Sha256AccelIsSupported() queries the CPU once and keeps its answer, even if
+  CPUID would now give another one.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The answer is cached.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The CPU is queried again.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SupportShouldBeCached (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BOOLEAN  CpuSupported;
+  BOOLEAN  Supported;
+
+  UT_ASSERT_TRUE (Sha256AccelIsSupported ());
+
+  //
+  // Hide the SHA extensions from CPUID.
+  //
+  gUnitTestHostBaseLib.X86->AsmCpuidEx = NoShaAsmCpuidEx;
+  CpuSupported                         = Sha256AccelCheckCpu ();
+  Supported                            = Sha256AccelIsSupported ();
+  gUnitTestHostBaseLib.X86->AsmCpuidEx = HostAsmCpuidEx;
+
+  UT_ASSERT_FALSE (CpuSupported);
+  UT_ASSERT_TRUE (Supported);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the SHA-256
+  block functions and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BlockTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Answer CPUID from the host CPU.
+  //
+  gUnitTestHostBaseLib.X86->AsmCpuid   = HostAsmCpuid;
+  gUnitTestHostBaseLib.X86->AsmCpuidEx = HostAsmCpuidEx;
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&BlockTests, Framework, "SHA-256 Block Function Tests", "BaseCryptLib.Sha256Accel", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SHA-256 Block Function Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------Description-----------------------------------------Name--------Function----------------------Pre-------------------Post--Context
+  //
+  AddTestCase (BlockTests, "Sha256NiBlocks matches the reference", "Blocks", BlocksShouldMatchReference, CheckShaExtensions, NULL, NULL);
+  AddTestCase (BlockTests, "Sha256NiBlocksX2 matches the reference", "BlocksX2", BlocksX2ShouldMatchReference, CheckShaExtensions, NULL, NULL);
+  AddTestCase (BlockTests, "Sha256AccelIsSupported caches the CPU answer", "Cached", SupportShouldBeCached, CheckShaExtensions, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Sha256AccelUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Sha256AccelUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
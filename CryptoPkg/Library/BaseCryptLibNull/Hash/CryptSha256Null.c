@@ -160,3 +160,38 @@ Sha256HashAll (
   ASSERT (FALSE);
   return FALSE;
 }
+
+/**
+  Computes the SHA-256 message digests of several independent data buffers.
+
+  This function performs the SHA-256 message digest of each of the given data
+  buffers, and places the digest values into the specified memory. On the CPUs
+  with SHA extensions the buffers are hashed two at a time, the rounds of the
+  two messages interleaved, which gives a higher throughput than hashing them
+  one after the other.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   BufferCount  Number of data buffers.
+  @param[in]   Data         Array of pointers to the buffers containing the data to be hashed.
+  @param[in]   DataSize     Array of the sizes of the Data buffers in bytes.
+  @param[out]  HashValue    Array of pointers to the buffers that receive the SHA-256
+                            digest values (32 bytes each).
+
+  @retval TRUE   SHA-256 digest computation succeeded.
+  @retval FALSE  SHA-256 digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+Sha256HashAllMultiple (
+  IN   UINTN        BufferCount,
+  IN   CONST VOID   **Data,
+  IN   CONST UINTN  *DataSize,
+  OUT  UINT8        **HashValue
+  )
+{
+  ASSERT (FALSE);
+  return FALSE;
+}
@@ -669,6 +669,45 @@ TlsSetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets a TLS session to be resumed during TLS/SSL connect.
+
+  This function offers a session saved with TlsGetSession() from an earlier
+  connection to the same server, with its session ID (TLS 1.2) or its session
+  ticket (TLS 1.3). If the server accepts it, the handshake is abbreviated and
+  the server certificate isn't sent nor verified again. Otherwise a full
+  handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be used by this TLS object.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSetSession (
+  IN     VOID  *Tls,
+  IN     VOID  *Session
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL) || (Session == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SSL_set_session (TlsConn->Ssl, (SSL_SESSION *)Session) != 1) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Adds the CA to the cert store when requesting Server or Client authentication.
 
@@ -1381,6 +1420,74 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets a copy of the session of the specified TLS connection for resumption.
+
+  This function returns a copy of the TLS session currently used by the
+  specified TLS connection, including the session ticket received from a
+  TLS 1.3 server, so that a later connection to the same server can resume
+  it with TlsSetSession(). The copy must be freed with TlsFreeSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @return  Pointer to the TLS session object, or NULL if there is no session
+           that can be resumed.
+
+**/
+VOID *
+EFIAPI
+TlsGetSession (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+  SSL_SESSION     *Session;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return NULL;
+  }
+
+  Session = SSL_get_session (TlsConn->Ssl);
+  if ((Session == NULL) || (SSL_SESSION_is_resumable (Session) == 0)) {
+    return NULL;
+  }
+
+  //
+  // Hand out a copy: the session of the connection is marked as not
+  // resumable when the connection is freed without a close_notify alert.
+  //
+  return (VOID *)SSL_SESSION_dup (Session);
+}
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  session set with TlsSetSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The session was resumed.
+  @retval  FALSE    A full handshake was done, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsGetSessionReused (
+  IN     VOID  *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *)Tls;
+
+  if ((TlsConn == NULL) || (TlsConn->Ssl == NULL)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(SSL_session_reused (TlsConn->Ssl) != 0);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -141,6 +141,23 @@ TlsFree (
   OPENSSL_free (Tls);
 }
 
+/**
+  Free a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID  *Session
+  )
+{
+  SSL_SESSION_free ((SSL_SESSION *)Session);
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -86,6 +86,23 @@ TlsFree (
   ASSERT (FALSE);
 }
 
+/**
+  Free a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+VOID
+EFIAPI
+TlsFreeSession (
+  IN     VOID  *Session
+  )
+{
+  ASSERT (FALSE);
+}
+
 /**
   Create a new TLS object for a connection.
 
@@ -21,7 +21,7 @@
 /// the EDK II Crypto Protocol is extended, this version define must be
 /// increased.
 ///
-#define EDKII_CRYPTO_VERSION  16
+#define EDKII_CRYPTO_VERSION  18
 
 ///
 /// EDK II Crypto Protocol forward declaration
@@ -1829,6 +1829,37 @@ BOOLEAN
   OUT  UINT8                       *HashValue
   );
 
+/**
+  Computes the SHA-256 message digests of several independent data buffers.
+
+  This function performs the SHA-256 message digest of each of the given data
+  buffers, and places the digest values into the specified memory. On the CPUs
+  with SHA extensions the buffers are hashed two at a time, the rounds of the
+  two messages interleaved, which gives a higher throughput than hashing them
+  one after the other.
+
+  If this interface is not supported, then return FALSE.
+
+  @param[in]   BufferCount  Number of data buffers.
+  @param[in]   Data         Array of pointers to the buffers containing the data to be hashed.
+  @param[in]   DataSize     Array of the sizes of the Data buffers in bytes.
+  @param[out]  HashValue    Array of pointers to the buffers that receive the SHA-256
+                            digest values (32 bytes each).
+
+  @retval TRUE   SHA-256 digest computation succeeded.
+  @retval FALSE  SHA-256 digest computation failed.
+  @retval FALSE  This interface is not supported.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_SHA256_HASH_ALL_MULTIPLE)(
+  IN   UINTN                       BufferCount,
+  IN   CONST VOID                  **Data,
+  IN   CONST UINTN                 *DataSize,
+  OUT  UINT8                       **HashValue
+  );
+
 /**
   Retrieves the size, in bytes, of the context buffer required for SHA-384 hash operations.
   If this interface is not supported, then return zero.
@@ -4177,6 +4208,80 @@ EFI_STATUS
   IN     UINTN                    KeyBufferLen
   );
 
+/**
+  Free a TLS session object returned by TlsGetSession().
+
+  If Session is NULL, nothing is done.
+
+  @param[in]  Session    Pointer to the TLS session object to be freed.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_CRYPTO_TLS_FREE_SESSION)(
+  IN     VOID                     *Session
+  );
+
+/**
+  Sets a TLS session to be resumed during TLS/SSL connect.
+
+  This function offers a session saved with TlsGetSession() from an earlier
+  connection to the same server, with its session ID (TLS 1.2) or its session
+  ticket (TLS 1.3). If the server accepts it, the handshake is abbreviated and
+  the server certificate isn't sent nor verified again. Otherwise a full
+  handshake is done.
+
+  @param[in]  Tls             Pointer to the TLS object.
+  @param[in]  Session         Pointer to the TLS session object.
+
+  @retval  EFI_SUCCESS           The session was set successfully.
+  @retval  EFI_INVALID_PARAMETER The parameter is invalid.
+  @retval  EFI_UNSUPPORTED       The session can't be used by this TLS object.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_CRYPTO_TLS_SET_SESSION)(
+  IN     VOID                     *Tls,
+  IN     VOID                     *Session
+  );
+
+/**
+  Gets a copy of the session of the specified TLS connection for resumption.
+
+  This function returns a copy of the TLS session currently used by the
+  specified TLS connection, including the session ticket received from a
+  TLS 1.3 server, so that a later connection to the same server can resume
+  it with TlsSetSession(). The copy must be freed with TlsFreeSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @return  Pointer to the TLS session object, or NULL if there is no session
+           that can be resumed.
+
+**/
+typedef
+VOID *
+(EFIAPI *EDKII_CRYPTO_TLS_GET_SESSION)(
+  IN     VOID                     *Tls
+  );
+
+/**
+  Checks whether the handshake of the specified TLS connection resumed a
+  session set with TlsSetSession().
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The session was resumed.
+  @retval  FALSE    A full handshake was done, or Tls is invalid.
+
+**/
+typedef
+BOOLEAN
+(EFIAPI *EDKII_CRYPTO_TLS_GET_SESSION_REUSED)(
+  IN     VOID                     *Tls
+  );
+
 /**
   Gets the CA-supplied certificate revocation list data set in the specified
   TLS object.
@@ -5603,6 +5708,15 @@ struct _EDKII_CRYPTO_PROTOCOL {
   EDKII_CRYPTO_X509_GET_CERT_FROM_CERT_CHAIN          X509GetCertFromCertChain;
   EDKII_CRYPTO_ASN1_GET_TAG                           Asn1GetTag;
   EDKII_CRYPTO_X509_GET_EXTENDED_BASIC_CONSTRAINTS    X509GetExtendedBasicConstraints;
+  /// TLS (continued)
+  EDKII_CRYPTO_TLS_FREE_SESSION                       TlsFreeSession;
+  /// TLS Set (continued)
+  EDKII_CRYPTO_TLS_SET_SESSION                        TlsSetSession;
+  /// TLS Get (continued)
+  EDKII_CRYPTO_TLS_GET_SESSION                        TlsGetSession;
+  EDKII_CRYPTO_TLS_GET_SESSION_REUSED                 TlsGetSessionReused;
+  /// Sha256 (continued)
+  EDKII_CRYPTO_SHA256_HASH_ALL_MULTIPLE               Sha256HashAllMultiple;
 };
 
 extern GUID  gEdkiiCryptoProtocolGuid;
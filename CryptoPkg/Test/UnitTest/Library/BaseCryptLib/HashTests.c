@@ -186,17 +186,296 @@ TestVerifyHash (
   return UNIT_TEST_PASSED;
 }
 
+//
+// SHA-256 messages of more than one block. (From "SHA-256 Examples" of NIST
+// CSVC and "Test Vectors" of IETF RFC6234)
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8  *Sha256Data448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+GLOBAL_REMOVE_IF_UNREFERENCED CONST CHAR8  *Sha256Data896 = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+
+#define SHA256_MILLION_A_SIZE    1000000
+#define SHA256_KNOWN_ANSWER_NUM  5
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  Sha256Digest448[SHA256_DIGEST_SIZE] = {
+  0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+  0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  Sha256Digest896[SHA256_DIGEST_SIZE] = {
+  0xcf, 0x5b, 0x16, 0xa7, 0x78, 0xaf, 0x83, 0x80, 0x03, 0x6c, 0xe5, 0x9e, 0x7b, 0x04, 0x92, 0x37,
+  0x0b, 0x24, 0x9b, 0x11, 0xe8, 0xf0, 0x7a, 0x51, 0xaf, 0xac, 0x45, 0x03, 0x7a, 0xfe, 0xe9, 0xd1
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINT8  Sha256DigestMillionA[SHA256_DIGEST_SIZE] = {
+  0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+  0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+};
+
+//
+// Sizes of the SHA-256 multi-buffer test messages. Sha256HashAllMultiple()
+// hashes them in pairs, the blocks both messages of a pair have together:
+// none, one, two, fifteen with the rest of the longer one on its own, and
+// sixty-four of equal messages. The odd count leaves one message to be
+// hashed on its own.
+//
+GLOBAL_REMOVE_IF_UNREFERENCED CONST UINTN  mSha256MultipleSize[] = { 0, 55, 64, 100, 128, 191, 1000, 4113, 4096, 4096, 119 };
+
+//
+// Buffer size and number of rounds of the SHA-256 throughput test.
+//
+#define SHA256_THROUGHPUT_BUFFER_SIZE  SIZE_64KB
+#define SHA256_THROUGHPUT_BUFFER_NUM   4
+#define SHA256_THROUGHPUT_ROUNDS       16
+
+typedef struct {
+  UINTN    MessageSize;
+  UINT8    *Message;
+  VOID     *HashCtx;
+} SHA256_BUFFER_TEST_CONTEXT;
+
+SHA256_BUFFER_TEST_CONTEXT  mSha256KnownAnswerCtx = { SHA256_MILLION_A_SIZE };
+SHA256_BUFFER_TEST_CONTEXT  mSha256MultipleCtx    = { 4113 };
+SHA256_BUFFER_TEST_CONTEXT  mSha256ThroughputCtx  = { SHA256_THROUGHPUT_BUFFER_SIZE * SHA256_THROUGHPUT_BUFFER_NUM };
+
+UNIT_TEST_STATUS
+EFIAPI
+TestSha256BufferPreReq (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  SHA256_BUFFER_TEST_CONTEXT  *BufferTestContext;
+
+  BufferTestContext          = Context;
+  BufferTestContext->Message = AllocateZeroPool (BufferTestContext->MessageSize);
+  BufferTestContext->HashCtx = AllocatePool (Sha256GetContextSize ());
+  if ((BufferTestContext->Message == NULL) || (BufferTestContext->HashCtx == NULL)) {
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+VOID
+EFIAPI
+TestSha256BufferCleanUp (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  SHA256_BUFFER_TEST_CONTEXT  *BufferTestContext;
+
+  BufferTestContext = Context;
+  if (BufferTestContext->Message != NULL) {
+    FreePool (BufferTestContext->Message);
+    BufferTestContext->Message = NULL;
+  }
+
+  if (BufferTestContext->HashCtx != NULL) {
+    FreePool (BufferTestContext->HashCtx);
+    BufferTestContext->HashCtx = NULL;
+  }
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifySha256KnownAnswer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SHA256_BUFFER_TEST_CONTEXT  *BufferTestContext;
+  CONST VOID                  *Data[SHA256_KNOWN_ANSWER_NUM];
+  UINTN                       DataSize[SHA256_KNOWN_ANSWER_NUM];
+  CONST UINT8                 *Expected[SHA256_KNOWN_ANSWER_NUM];
+  UINT8                       Digest[SHA256_KNOWN_ANSWER_NUM][SHA256_DIGEST_SIZE];
+  UINT8                       *HashValue[SHA256_KNOWN_ANSWER_NUM];
+  UINTN                       Index;
+  BOOLEAN                     Status;
+
+  BufferTestContext = Context;
+  SetMem (BufferTestContext->Message, SHA256_MILLION_A_SIZE, 'a');
+
+  //
+  // In pairs for Sha256HashAllMultiple(): one block together, all the
+  // blocks together, then the last message on its own.
+  //
+  Data[0]     = Sha256Data896;
+  DataSize[0] = AsciiStrLen (Sha256Data896);
+  Expected[0] = Sha256Digest896;
+  for (Index = 1; Index < 4; Index++) {
+    Data[Index]     = BufferTestContext->Message;
+    DataSize[Index] = SHA256_MILLION_A_SIZE;
+    Expected[Index] = Sha256DigestMillionA;
+  }
+
+  Data[4]     = Sha256Data448;
+  DataSize[4] = AsciiStrLen (Sha256Data448);
+  Expected[4] = Sha256Digest448;
+
+  for (Index = 0; Index < ARRAY_SIZE (Data); Index++) {
+    HashValue[Index] = Digest[Index];
+
+    ZeroMem (Digest[Index], SHA256_DIGEST_SIZE);
+    Status = Sha256HashAll (Data[Index], DataSize[Index], Digest[Index]);
+    UT_ASSERT_TRUE (Status);
+    UT_ASSERT_MEM_EQUAL (Digest[Index], Expected[Index], SHA256_DIGEST_SIZE);
+
+    //
+    // Streaming in uneven pieces has to give the same digest.
+    //
+    ZeroMem (Digest[Index], SHA256_DIGEST_SIZE);
+    Status = Sha256Init (BufferTestContext->HashCtx);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Update (BufferTestContext->HashCtx, Data[Index], DataSize[Index] / 3);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Update (BufferTestContext->HashCtx, (CONST UINT8 *)Data[Index] + DataSize[Index] / 3, DataSize[Index] - DataSize[Index] / 3);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Final (BufferTestContext->HashCtx, Digest[Index]);
+    UT_ASSERT_TRUE (Status);
+    UT_ASSERT_MEM_EQUAL (Digest[Index], Expected[Index], SHA256_DIGEST_SIZE);
+  }
+
+  ZeroMem (Digest, sizeof (Digest));
+  Status = Sha256HashAllMultiple (ARRAY_SIZE (Data), Data, DataSize, HashValue);
+  UT_ASSERT_TRUE (Status);
+
+  for (Index = 0; Index < ARRAY_SIZE (Data); Index++) {
+    UT_ASSERT_MEM_EQUAL (Digest[Index], Expected[Index], SHA256_DIGEST_SIZE);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifySha256HashAllMultiple (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SHA256_BUFFER_TEST_CONTEXT  *BufferTestContext;
+  CONST VOID                  *Data[ARRAY_SIZE (mSha256MultipleSize)];
+  UINT8                       Digest[ARRAY_SIZE (mSha256MultipleSize)][SHA256_DIGEST_SIZE];
+  UINT8                       *HashValue[ARRAY_SIZE (mSha256MultipleSize)];
+  UINT8                       Expected[SHA256_DIGEST_SIZE];
+  UINTN                       Index;
+  UINTN                       Offset;
+  BOOLEAN                     Status;
+
+  BufferTestContext = Context;
+  for (Index = 0; Index < BufferTestContext->MessageSize; Index++) {
+    BufferTestContext->Message[Index] = (UINT8)(Index * 7 + 1);
+  }
+
+  //
+  // Each message ends at the end of the buffer, so that no two of different
+  // sizes are equal.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mSha256MultipleSize); Index++) {
+    Offset           = BufferTestContext->MessageSize - mSha256MultipleSize[Index];
+    Data[Index]      = BufferTestContext->Message + Offset;
+    HashValue[Index] = Digest[Index];
+  }
+
+  ZeroMem (Digest, sizeof (Digest));
+  Status = Sha256HashAllMultiple (ARRAY_SIZE (mSha256MultipleSize), Data, mSha256MultipleSize, HashValue);
+  UT_ASSERT_TRUE (Status);
+
+  for (Index = 0; Index < ARRAY_SIZE (mSha256MultipleSize); Index++) {
+    Status = Sha256HashAll (Data[Index], mSha256MultipleSize[Index], Expected);
+    UT_ASSERT_TRUE (Status);
+    UT_ASSERT_MEM_EQUAL (Digest[Index], Expected, SHA256_DIGEST_SIZE);
+
+    //
+    // Streaming with a partial block first has to give the same digest.
+    //
+    ZeroMem (Digest[Index], SHA256_DIGEST_SIZE);
+    Offset = MIN (mSha256MultipleSize[Index], 3);
+    Status = Sha256Init (BufferTestContext->HashCtx);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Update (BufferTestContext->HashCtx, Data[Index], Offset);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Update (BufferTestContext->HashCtx, (CONST UINT8 *)Data[Index] + Offset, mSha256MultipleSize[Index] - Offset);
+    UT_ASSERT_TRUE (Status);
+    Status = Sha256Final (BufferTestContext->HashCtx, Digest[Index]);
+    UT_ASSERT_TRUE (Status);
+    UT_ASSERT_MEM_EQUAL (Digest[Index], Expected, SHA256_DIGEST_SIZE);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+TestSha256Throughput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SHA256_BUFFER_TEST_CONTEXT  *BufferTestContext;
+  CONST VOID                  *Data[SHA256_THROUGHPUT_BUFFER_NUM];
+  UINTN                       DataSize[SHA256_THROUGHPUT_BUFFER_NUM];
+  UINT8                       Digest[SHA256_THROUGHPUT_BUFFER_NUM][SHA256_DIGEST_SIZE];
+  UINT8                       *HashValue[SHA256_THROUGHPUT_BUFFER_NUM];
+  UINT64                      Start;
+  UINT64                      Single;
+  UINT64                      Multiple;
+  UINTN                       Round;
+  UINTN                       Index;
+  BOOLEAN                     Status;
+
+  BufferTestContext = Context;
+  for (Index = 0; Index < SHA256_THROUGHPUT_BUFFER_NUM; Index++) {
+    Data[Index]      = BufferTestContext->Message + Index * SHA256_THROUGHPUT_BUFFER_SIZE;
+    DataSize[Index]  = SHA256_THROUGHPUT_BUFFER_SIZE;
+    HashValue[Index] = Digest[Index];
+  }
+
+  Start = GetPerformanceCounter ();
+  for (Round = 0; Round < SHA256_THROUGHPUT_ROUNDS; Round++) {
+    for (Index = 0; Index < SHA256_THROUGHPUT_BUFFER_NUM; Index++) {
+      Status = Sha256HashAll (Data[Index], DataSize[Index], HashValue[Index]);
+      UT_ASSERT_TRUE (Status);
+    }
+  }
+
+  Single = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+
+  Start = GetPerformanceCounter ();
+  for (Round = 0; Round < SHA256_THROUGHPUT_ROUNDS; Round++) {
+    Status = Sha256HashAllMultiple (SHA256_THROUGHPUT_BUFFER_NUM, Data, DataSize, HashValue);
+    UT_ASSERT_TRUE (Status);
+  }
+
+  Multiple = GetTimeInNanoSecond (GetPerformanceCounter () - Start);
+
+  //
+  // No numbers without a performance counter.
+  //
+  if ((Single == 0) || (Multiple == 0)) {
+    UT_LOG_INFO ("No performance counter, SHA-256 throughput not measured\n");
+    return UNIT_TEST_PASSED;
+  }
+
+  UT_LOG_INFO (
+    "SHA-256 throughput: Sha256HashAll %ld MB/s, Sha256HashAllMultiple %ld MB/s\n",
+    DivU64x64Remainder (MultU64x32 (SHA256_THROUGHPUT_BUFFER_SIZE * SHA256_THROUGHPUT_BUFFER_NUM * SHA256_THROUGHPUT_ROUNDS, 1000), Single, NULL),
+    DivU64x64Remainder (MultU64x32 (SHA256_THROUGHPUT_BUFFER_SIZE * SHA256_THROUGHPUT_BUFFER_NUM * SHA256_THROUGHPUT_ROUNDS, 1000), Multiple, NULL)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
 TEST_DESC  mHashTest[] = {
   //
   // -----Description----------------Class---------------------Function---------------Pre------------------Post------------Context
   //
  #ifdef ENABLE_MD5_DEPRECATED_INTERFACES
-  { "TestVerifyMd5()",    "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mMd5TestCtx    },
+  { "TestVerifyMd5()",                   "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,                  TestVerifyHashPreReq,   TestVerifyHashCleanUp,   &mMd5TestCtx           },
  #endif
-  { "TestVerifySha1()",   "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha1TestCtx   },
-  { "TestVerifySha256()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha256TestCtx },
-  { "TestVerifySha384()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha384TestCtx },
-  { "TestVerifySha512()", "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash, TestVerifyHashPreReq, TestVerifyHashCleanUp, &mSha512TestCtx },
+  { "TestVerifySha1()",                  "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,                  TestVerifyHashPreReq,   TestVerifyHashCleanUp,   &mSha1TestCtx          },
+  { "TestVerifySha256()",                "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,                  TestVerifyHashPreReq,   TestVerifyHashCleanUp,   &mSha256TestCtx        },
+  { "TestVerifySha384()",                "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,                  TestVerifyHashPreReq,   TestVerifyHashCleanUp,   &mSha384TestCtx        },
+  { "TestVerifySha512()",                "CryptoPkg.BaseCryptLib.Hash", TestVerifyHash,                  TestVerifyHashPreReq,   TestVerifyHashCleanUp,   &mSha512TestCtx        },
+  { "TestVerifySha256KnownAnswer()",     "CryptoPkg.BaseCryptLib.Hash", TestVerifySha256KnownAnswer,     TestSha256BufferPreReq, TestSha256BufferCleanUp, &mSha256KnownAnswerCtx },
+  { "TestVerifySha256HashAllMultiple()", "CryptoPkg.BaseCryptLib.Hash", TestVerifySha256HashAllMultiple, TestSha256BufferPreReq, TestSha256BufferCleanUp, &mSha256MultipleCtx    },
+  { "TestSha256Throughput()",            "CryptoPkg.BaseCryptLib.Hash", TestSha256Throughput,            TestSha256BufferPreReq, TestSha256BufferCleanUp, &mSha256ThroughputCtx  },
 };
 
 UINTN  mHashTestNum = ARRAY_SIZE (mHashTest);
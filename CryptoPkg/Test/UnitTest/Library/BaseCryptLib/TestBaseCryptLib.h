@@ -19,6 +19,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 // #include <UnitTestTypes.h>
 #include <Library/UnitTestLib.h>
 // #include <Library/UnitTestAssertLib.h>
@@ -34,6 +34,13 @@ EFI_SIMPLE_NETWORK_PROTOCOL  gEmuSnpTemplate = {
   NULL                      // Mode
 };
 
+EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  gEmuSnpOffloadTemplate = {
+  EDKII_NETWORK_OFFLOAD_PROTOCOL_REVISION,
+  EDKII_NETWORK_OFFLOAD_TX_MASK,
+  EMU_SNP_MAX_LARGE_SEND_SIZE,
+  EmuSnpOffloadTransmit
+};
+
 EFI_SIMPLE_NETWORK_MODE  gEmuSnpModeTemplate = {
   EfiSimpleNetworkStopped,      //  State
   NET_ETHER_ADDR_LEN,           //  HwAddressSize
@@ -483,6 +490,112 @@ EmuSnpTransmit (
   return Status;
 }
 
+///
+/// Arguments of an offloaded transmit, replayed for every frame built by
+/// NetLibOffloadFrame().
+///
+typedef struct {
+  EMU_SNP_PRIVATE_DATA    *Private;
+  UINTN                   HeaderSize;
+  EFI_MAC_ADDRESS         *SrcAddr;
+  EFI_MAC_ADDRESS         *DestAddr;
+  UINT16                  *Protocol;
+} EMU_SNP_OFFLOAD_CONTEXT;
+
+/**
+  Hand one frame built by NetLibOffloadFrame() to the host.
+
+  @param[in]  Context       Pointer to the EMU_SNP_OFFLOAD_CONTEXT.
+  @param[in]  Frame         Pointer to the frame.
+  @param[in]  FrameLength   Length of the frame, in bytes.
+
+  @retval EFI_SUCCESS       The frame was sent.
+  @retval Others            The error returned by the host.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+EmuSnpOffloadSendFrame (
+  IN VOID    *Context,
+  IN UINT8   *Frame,
+  IN UINT32  FrameLength
+  )
+{
+  EMU_SNP_OFFLOAD_CONTEXT  *Offload;
+
+  Offload = (EMU_SNP_OFFLOAD_CONTEXT *)Context;
+
+  return Offload->Private->Io->Transmit (
+                                 Offload->Private->Io,
+                                 Offload->HeaderSize,
+                                 FrameLength,
+                                 Frame,
+                                 Offload->SrcAddr,
+                                 Offload->DestAddr,
+                                 Offload->Protocol
+                                 );
+}
+
+/**
+  Places a packet in the transmit queue of a network interface, performing the
+  requested checksum and segmentation offloads.
+
+  The emulated device has no offload engine, so the offloads are done with
+  NetLibOffloadFrame() and every resulting frame is handed to the host.
+
+  @param  This       Protocol instance pointer.
+  @param  TxInfo     The offloads requested for this frame.
+  @param  HeaderSize The size, in bytes, of the media header to be filled in by
+                     the Transmit() function.
+  @param  BufferSize The size, in bytes, of the entire packet.
+  @param  Buffer     A pointer to the packet.
+  @param  SrcAddr    The source HW MAC address.
+  @param  DestAddr   The destination HW MAC address.
+  @param  Protocol   The type of header to build.
+
+  @retval EFI_SUCCESS           The packet was placed on the transmit queue.
+  @retval EFI_UNSUPPORTED       One of the requested offloads is not supported.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network interface.
+
+**/
+EFI_STATUS
+EFIAPI
+EmuSnpOffloadTransmit (
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO          *TxInfo,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL
+  )
+{
+  EMU_SNP_OFFLOAD_CONTEXT  Offload;
+
+  if ((TxInfo == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((TxInfo->Flags & ~This->Capabilities) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (BufferSize > This->MaxLargeSendSize + NET_ETHER_HEADER_SIZE + NET_VLAN_TAG_LEN) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Offload.Private    = EMU_SNP_PRIVATE_DATA_FROM_OFFLOAD_THIS (This);
+  Offload.HeaderSize = HeaderSize;
+  Offload.SrcAddr    = SrcAddr;
+  Offload.DestAddr   = DestAddr;
+  Offload.Protocol   = Protocol;
+
+  return NetLibOffloadFrame (TxInfo, Buffer, (UINT32)BufferSize, EmuSnpOffloadSendFrame, &Offload);
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -728,6 +841,7 @@ EmuSnpDriverBindingStart (
 
   CopyMem (&Private->Snp, &gEmuSnpTemplate, sizeof (EFI_SIMPLE_NETWORK_PROTOCOL));
   CopyMem (&Private->Mode, &gEmuSnpModeTemplate, sizeof (EFI_SIMPLE_NETWORK_MODE));
+  CopyMem (&Private->SnpOffload, &gEmuSnpOffloadTemplate, sizeof (EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL));
 
   Private->Signature           = EMU_SNP_PRIVATE_DATA_SIGNATURE;
   Private->IoThunk             = EmuIoThunk;
@@ -788,6 +902,8 @@ EmuSnpDriverBindingStart (
                   &Private->DeviceHandle,
                   &gEfiSimpleNetworkProtocolGuid,
                   &Private->Snp,
+                  &gEdkiiSimpleNetworkOffloadProtocolGuid,
+                  &Private->SnpOffload,
                   &gEfiDevicePathProtocolGuid,
                   Private->DevicePath,
                   NULL
@@ -915,6 +1031,8 @@ EmuSnpDriverBindingStop (
                   Private->DeviceHandle,
                   &gEfiSimpleNetworkProtocolGuid,
                   &Private->Snp,
+                  &gEdkiiSimpleNetworkOffloadProtocolGuid,
+                  &Private->SnpOffload,
                   &gEfiDevicePathProtocolGuid,
                   Private->DevicePath,
                   NULL
@@ -21,6 +21,7 @@ Abstract:
 #include <Protocol/DevicePath.h>
 #include <Protocol/EmuIoThunk.h>
 #include <Protocol/EmuSnp.h>
+#include <Protocol/NetworkOffload.h>
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
@@ -33,29 +34,39 @@ Abstract:
 
 #define NET_ETHER_HEADER_SIZE  14
 
+//
+// Largest IPv4 packet the emulated device accepts for segmentation offload.
+//
+#define EMU_SNP_MAX_LARGE_SEND_SIZE  0xFFFF
+
 //
 //  Private data for driver.
 //
 #define EMU_SNP_PRIVATE_DATA_SIGNATURE  SIGNATURE_32( 'U', 'S', 'N', 'P' )
 
 typedef struct {
-  UINTN                          Signature;
-  EMU_IO_THUNK_PROTOCOL          *IoThunk;
-  EMU_SNP_PROTOCOL               *Io;
-  EFI_DEVICE_PATH_PROTOCOL       *DevicePath;
+  UINTN                                    Signature;
+  EMU_IO_THUNK_PROTOCOL                    *IoThunk;
+  EMU_SNP_PROTOCOL                         *Io;
+  EFI_DEVICE_PATH_PROTOCOL                 *DevicePath;
 
-  EFI_HANDLE                     EfiHandle;
-  EFI_HANDLE                     DeviceHandle;
+  EFI_HANDLE                               EfiHandle;
+  EFI_HANDLE                               DeviceHandle;
 
-  EFI_SIMPLE_NETWORK_PROTOCOL    Snp;
-  EFI_SIMPLE_NETWORK_MODE        Mode;
+  EFI_SIMPLE_NETWORK_PROTOCOL              Snp;
+  EFI_SIMPLE_NETWORK_MODE                  Mode;
 
-  EFI_UNICODE_STRING_TABLE       *ControllerNameTable;
+  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL    SnpOffload;
+
+  EFI_UNICODE_STRING_TABLE                 *ControllerNameTable;
 } EMU_SNP_PRIVATE_DATA;
 
 #define EMU_SNP_PRIVATE_DATA_FROM_SNP_THIS(a) \
       CR( a, EMU_SNP_PRIVATE_DATA, Snp, EMU_SNP_PRIVATE_DATA_SIGNATURE )
 
+#define EMU_SNP_PRIVATE_DATA_FROM_OFFLOAD_THIS(a) \
+      CR( a, EMU_SNP_PRIVATE_DATA, SnpOffload, EMU_SNP_PRIVATE_DATA_SIGNATURE )
+
 extern EFI_DRIVER_BINDING_PROTOCOL   gEmuSnpDriverBinding;
 extern EFI_COMPONENT_NAME_PROTOCOL   gEmuSnpDriverComponentName;
 extern EFI_COMPONENT_NAME2_PROTOCOL  gEmuSnpDriverComponentName2;
@@ -428,6 +439,42 @@ EmuSnpTransmit (
   IN UINT16                       *Protocol OPTIONAL
   );
 
+/**
+  Places a packet in the transmit queue of a network interface, performing the
+  requested checksum and segmentation offloads.
+
+  The emulated device has no offload engine, so the offloads are done with
+  NetLibOffloadFrame() and every resulting frame is handed to the host.
+
+  @param  This       Protocol instance pointer.
+  @param  TxInfo     The offloads requested for this frame.
+  @param  HeaderSize The size, in bytes, of the media header to be filled in by
+                     the Transmit() function.
+  @param  BufferSize The size, in bytes, of the entire packet.
+  @param  Buffer     A pointer to the packet.
+  @param  SrcAddr    The source HW MAC address.
+  @param  DestAddr   The destination HW MAC address.
+  @param  Protocol   The type of header to build.
+
+  @retval EFI_SUCCESS           The packet was placed on the transmit queue.
+  @retval EFI_UNSUPPORTED       One of the requested offloads is not supported.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
+  @retval EFI_DEVICE_ERROR      The command could not be sent to the network interface.
+
+**/
+EFI_STATUS
+EFIAPI
+EmuSnpOffloadTransmit (
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO          *TxInfo,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL
+  );
+
 /**
   Receives a packet from a network interface.
 
@@ -5,7 +5,14 @@
   if a driver can be scheduled for execution.  The criteria for
   schedulability is that the dependency expression is satisfied.
 
+  It also keeps a reverse index from the protocols pushed by the dependency
+  expressions to the drivers pushing them. A PUSH that finds its protocol is
+  replaced by EFI_DEP_REPLACE_TRUE, so an expression that evaluated to FALSE
+  can only change once one of its remaining protocols is installed; the
+  dispatcher evaluates it again only then.
+
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -19,6 +26,41 @@ BOOLEAN  *mDepexEvaluationStack        = NULL;
 BOOLEAN  *mDepexEvaluationStackEnd     = NULL;
 BOOLEAN  *mDepexEvaluationStackPointer = NULL;
 
+//
+// Number of buckets of mDepexProtocolHashTable, as a power of 2, and golden
+// ratio multiplier of its hash function.
+//
+#define DEPEX_PROTOCOL_HASH_BITS        6
+#define DEPEX_PROTOCOL_HASH_MULTIPLIER  0x9E3779B1
+
+#define DEPEX_PROTOCOL_SIGNATURE  SIGNATURE_32('d','p','x','p')
+
+///
+/// DEPEX_PROTOCOL - each protocol pushed by a dependency expression has 1
+/// entry in the reverse index, listing the drivers that push it.
+///
+typedef struct _DEPEX_PROTOCOL {
+  UINTN                     Signature;
+  /// Next protocol in the same bucket of mDepexProtocolHashTable
+  struct _DEPEX_PROTOCOL    *HashNext;
+  /// ID of the protocol
+  EFI_GUID                  ProtocolID;
+  /// List of DEPEX_DRIVER_REFERENCE
+  LIST_ENTRY                Drivers;
+} DEPEX_PROTOCOL;
+
+typedef struct {
+  /// Link on DEPEX_PROTOCOL.Drivers
+  LIST_ENTRY               Link;
+  EFI_CORE_DRIVER_ENTRY    *DriverEntry;
+} DEPEX_DRIVER_REFERENCE;
+
+//
+// Reverse index of the dependency expressions, protected by the dispatcher
+// lock as it's looked up by the protocol installations
+//
+DEPEX_PROTOCOL  *mDepexProtocolHashTable[1 << DEPEX_PROTOCOL_HASH_BITS];
+
 //
 // Worker functions
 //
@@ -431,3 +473,269 @@ CoreIsSchedulable (
 Done:
   return FALSE;
 }
+
+/**
+  Compute the bucket of a protocol GUID in mDepexProtocolHashTable.
+
+  @param  Protocol              The ID of the protocol.
+
+  @return The bucket index.
+
+**/
+STATIC
+UINTN
+CoreDepexProtocolHashBucket (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  CONST UINT32  *Data;
+  UINT32        Key;
+
+  Data = (CONST UINT32 *)Protocol;
+  Key  = ReadUnaligned32 (Data) ^ ReadUnaligned32 (Data + 1) ^
+         ReadUnaligned32 (Data + 2) ^ ReadUnaligned32 (Data + 3);
+  return (UINTN)((Key * DEPEX_PROTOCOL_HASH_MULTIPLIER) >> (32 - DEPEX_PROTOCOL_HASH_BITS));
+}
+
+/**
+  Find the entry of a protocol in the reverse index.
+  The dispatcher lock must be owned, or the index not be updated concurrently.
+
+  @param  Protocol              The ID of the protocol.
+
+  @return The entry of the protocol, or NULL if no driver pushes it.
+
+**/
+STATIC
+DEPEX_PROTOCOL *
+CoreFindDepexProtocol (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  DEPEX_PROTOCOL  *DepexProtocol;
+
+  for (DepexProtocol = mDepexProtocolHashTable[CoreDepexProtocolHashBucket (Protocol)];
+       DepexProtocol != NULL;
+       DepexProtocol = DepexProtocol->HashNext)
+  {
+    if (CompareGuid (&DepexProtocol->ProtocolID, Protocol)) {
+      return DepexProtocol;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find the next PUSH opcode of a dependency expression, replaced or not.
+
+  @param  DriverEntry           DriverEntry element with a Depex.
+  @param  Iterator              On input, the opcode to search from. On output,
+                                the opcode following the PUSH found.
+
+  @return The PUSH or EFI_DEP_REPLACE_TRUE opcode, followed by the GUID of its
+          protocol, or NULL if the expression has no more.
+
+**/
+STATIC
+UINT8 *
+CoreNextDepexPush (
+  IN     EFI_CORE_DRIVER_ENTRY  *DriverEntry,
+  IN OUT UINT8                  **Iterator
+  )
+{
+  UINT8  *End;
+  UINT8  *Opcode;
+
+  End = (UINT8 *)DriverEntry->Depex + DriverEntry->DepexSize;
+  while (*Iterator < End) {
+    Opcode = *Iterator;
+    switch (*Opcode) {
+      case EFI_DEP_PUSH:
+      case EFI_DEP_REPLACE_TRUE:
+      case EFI_DEP_BEFORE:
+      case EFI_DEP_AFTER:
+        if ((UINTN)(End - Opcode) < 1 + sizeof (EFI_GUID)) {
+          return NULL;
+        }
+
+        *Iterator = Opcode + 1 + sizeof (EFI_GUID);
+        if ((*Opcode == EFI_DEP_PUSH) || (*Opcode == EFI_DEP_REPLACE_TRUE)) {
+          return Opcode;
+        }
+
+        break;
+
+      case EFI_DEP_AND:
+      case EFI_DEP_OR:
+      case EFI_DEP_NOT:
+      case EFI_DEP_TRUE:
+      case EFI_DEP_FALSE:
+      case EFI_DEP_SOR:
+        *Iterator = Opcode + 1;
+        break;
+
+      default:
+        //
+        // EFI_DEP_END or an unknown opcode
+        //
+        return NULL;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add the protocols pushed by the dependency expression of a driver to the
+  reverse index, so that the installation of one of them marks the driver
+  for evaluation. If the index can't be updated, DriverEntry->DepexIndexed
+  is left FALSE and the driver is evaluated on every dispatch pass.
+
+  @param  DriverEntry           DriverEntry element with a pre-processed Depex.
+
+**/
+VOID
+CoreIndexDepex (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8                   *Iterator;
+  UINT8                   *Push;
+  UINTN                   Count;
+  UINTN                   Index;
+  DEPEX_DRIVER_REFERENCE  *References;
+  DEPEX_PROTOCOL          *DepexProtocol;
+  UINTN                   Bucket;
+
+  DriverEntry->DepexIndexed = FALSE;
+  DriverEntry->DepexDirty   = TRUE;
+
+  //
+  // A NULL Depex waits on the Architectural Protocols, which are not indexed
+  //
+  if (DriverEntry->Depex == NULL) {
+    return;
+  }
+
+  Count    = 0;
+  Iterator = DriverEntry->Depex;
+  while (CoreNextDepexPush (DriverEntry, &Iterator) != NULL) {
+    Count++;
+  }
+
+  References = NULL;
+  if (Count != 0) {
+    References = AllocatePool (Count * sizeof (DEPEX_DRIVER_REFERENCE));
+    if (References == NULL) {
+      return;
+    }
+  }
+
+  Index    = 0;
+  Iterator = DriverEntry->Depex;
+  while ((Push = CoreNextDepexPush (DriverEntry, &Iterator)) != NULL) {
+    DepexProtocol = CoreFindDepexProtocol ((EFI_GUID *)(Push + 1));
+    if (DepexProtocol == NULL) {
+      DepexProtocol = AllocatePool (sizeof (DEPEX_PROTOCOL));
+      if (DepexProtocol == NULL) {
+        //
+        // Leave the driver out of the index. The references already linked
+        // only mark it for an evaluation it gets anyway.
+        //
+        return;
+      }
+
+      DepexProtocol->Signature = DEPEX_PROTOCOL_SIGNATURE;
+      CopyGuid (&DepexProtocol->ProtocolID, (EFI_GUID *)(Push + 1));
+      InitializeListHead (&DepexProtocol->Drivers);
+
+      Bucket = CoreDepexProtocolHashBucket (&DepexProtocol->ProtocolID);
+      CoreAcquireDispatcherLock ();
+      DepexProtocol->HashNext         = mDepexProtocolHashTable[Bucket];
+      mDepexProtocolHashTable[Bucket] = DepexProtocol;
+      CoreReleaseDispatcherLock ();
+    }
+
+    References[Index].DriverEntry = DriverEntry;
+    CoreAcquireDispatcherLock ();
+    InsertTailList (&DepexProtocol->Drivers, &References[Index].Link);
+    CoreReleaseDispatcherLock ();
+    Index++;
+  }
+
+  DriverEntry->DepexIndexed = TRUE;
+}
+
+/**
+  Mark the drivers whose dependency expression pushes a protocol for
+  evaluation, as the protocol has been installed.
+
+  @param  Protocol              The GUID of the installed protocol.
+
+**/
+VOID
+CoreDepexProtocolInstalled (
+  IN  EFI_GUID  *Protocol
+  )
+{
+  DEPEX_PROTOCOL          *DepexProtocol;
+  LIST_ENTRY              *Link;
+  DEPEX_DRIVER_REFERENCE  *Reference;
+
+  CoreAcquireDispatcherLock ();
+
+  DepexProtocol = CoreFindDepexProtocol (Protocol);
+  if (DepexProtocol != NULL) {
+    for (Link = DepexProtocol->Drivers.ForwardLink; Link != &DepexProtocol->Drivers; Link = Link->ForwardLink) {
+      Reference                          = BASE_CR (Link, DEPEX_DRIVER_REFERENCE, Link);
+      Reference->DriverEntry->DepexDirty = TRUE;
+    }
+  }
+
+  CoreReleaseDispatcherLock ();
+}
+
+/**
+  Display what the dependency expression of a driver is still waiting on.
+
+  @param  DriverEntry           DriverEntry element in the Dependent state.
+
+**/
+VOID
+CoreDisplayDepexWaits (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8     *Iterator;
+  UINT8     *Push;
+  EFI_GUID  ProtocolGuid;
+  VOID      *Interface;
+
+  if (DriverEntry->Before || DriverEntry->After) {
+    DEBUG ((
+      DEBUG_LOAD,
+      "  Waiting on %a FFS(%g)\n",
+      DriverEntry->Before ? "BEFORE" : "AFTER",
+      &DriverEntry->BeforeAfterGuid
+      ));
+    return;
+  }
+
+  if (DriverEntry->Depex == NULL) {
+    DEBUG ((DEBUG_LOAD, "  Waiting on the Architectural Protocols\n"));
+    return;
+  }
+
+  Iterator = DriverEntry->Depex;
+  while ((Push = CoreNextDepexPush (DriverEntry, &Iterator)) != NULL) {
+    if (*Push == EFI_DEP_REPLACE_TRUE) {
+      continue;
+    }
+
+    CopyMem (&ProtocolGuid, Push + 1, sizeof (EFI_GUID));
+    if (EFI_ERROR (CoreLocateProtocol (&ProtocolGuid, NULL, &Interface))) {
+      DEBUG ((DEBUG_LOAD, "  Waiting on GUID(%g)\n", &ProtocolGuid));
+    }
+  }
+}
@@ -11,7 +11,10 @@
   Step #2 - Dispatch. Remove driver from the mScheduledQueue and load and
             start it. After mScheduledQueue is drained check the
             mDiscoveredList to see if any item has a Depex that is ready to
-            be placed on the mScheduledQueue.
+            be placed on the mScheduledQueue. Only the Depex that may have
+            changed are evaluated: the ones pushing a protocol installed
+            since their last evaluation, found by the reverse index of
+            Dependency.c, and the ones missing from that index.
 
   Step #3 - Adding to the mScheduledQueue requires that you process Before
             and After dependencies. This is done recursively as the call to add
@@ -27,6 +30,7 @@
   SOR   - Schedule On Request - Don't schedule if this bit is set.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -60,6 +64,14 @@ EFI_LOCK  mDispatcherLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 //
 BOOLEAN  gDispatcherRunning = FALSE;
 
+//
+// Dispatch statistics. The drivers are only timed when performance
+// measurement is enabled, so a platform may use a null TimerLib otherwise.
+//
+UINTN    mDepexEvaluations     = 0;
+BOOLEAN  mDispatchTimerEnabled = FALSE;
+BOOLEAN  mDispatchTimerCountUp = TRUE;
+
 //
 // Module globals to manage the FwVol registration notification event
 //
@@ -269,6 +281,7 @@ CoreGetDepexSectionAndPreProccess (
       DriverEntry->Depex              = NULL;
       DriverEntry->Dependent          = TRUE;
       DriverEntry->DepexProtocolError = FALSE;
+      CoreIndexDepex (DriverEntry);
     }
   } else {
     //
@@ -277,6 +290,7 @@ CoreGetDepexSectionAndPreProccess (
     //
     CorePreProcessDepex (DriverEntry);
     DriverEntry->DepexProtocolError = FALSE;
+    CoreIndexDepex (DriverEntry);
   }
 
   return Status;
@@ -321,6 +335,7 @@ CoreSchedule (
       CoreAcquireDispatcherLock ();
       DriverEntry->Unrequested = FALSE;
       DriverEntry->Dependent   = TRUE;
+      DriverEntry->DepexDirty  = TRUE;
       CoreReleaseDispatcherLock ();
 
       DEBUG ((DEBUG_DISPATCH, "Schedule FFS(%g) - EFI_SUCCESS\n", DriverName));
@@ -407,6 +422,8 @@ CoreDispatcher (
   EFI_CORE_DRIVER_ENTRY  *DriverEntry;
   BOOLEAN                ReadyToRun;
   EFI_EVENT              DxeDispatchEvent;
+  UINT64                 Start;
+  UINT64                 End;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -444,6 +461,11 @@ CoreDispatcher (
                       EFI_CORE_DRIVER_ENTRY_SIGNATURE
                       );
 
+      Start = 0;
+      if (mDispatchTimerEnabled) {
+        Start = GetPerformanceCounter ();
+      }
+
       //
       // Load the DXE Driver image into memory. If the Driver was transitioned from
       // Untrused to Scheduled it would have already been loaded so we may need to
@@ -525,6 +547,11 @@ CoreDispatcher (
           );
       }
 
+      if (mDispatchTimerEnabled) {
+        End                       = GetPerformanceCounter ();
+        DriverEntry->DispatchTime = GetTimeInNanoSecond (mDispatchTimerCountUp ? End - Start : Start - End);
+      }
+
       ReturnStatus = EFI_SUCCESS;
     }
 
@@ -552,6 +579,15 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        //
+        // Skip the Depex that can't have changed since their last evaluation
+        //
+        if (!DriverEntry->DepexDirty && DriverEntry->DepexIndexed) {
+          continue;
+        }
+
+        DriverEntry->DepexDirty = FALSE;
+        mDepexEvaluations++;
         if (CoreIsSchedulable (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
@@ -1445,8 +1481,17 @@ CoreInitializeDispatcher (
   VOID
   )
 {
+  UINT64  StartValue;
+  UINT64  EndValue;
+
   PERF_FUNCTION_BEGIN ();
 
+  mDispatchTimerEnabled = PerformanceMeasurementEnabled ();
+  if (mDispatchTimerEnabled) {
+    GetPerformanceCounterProperties (&StartValue, &EndValue);
+    mDispatchTimerCountUp = (BOOLEAN)(EndValue >= StartValue);
+  }
+
   mFwVolEvent = EfiCreateProtocolNotifyEvent (
                   &gEfiFirmwareVolume2ProtocolGuid,
                   TPL_CALLBACK,
@@ -1464,7 +1509,8 @@ CoreInitializeDispatcher (
 
 /**
   Traverse the discovered list for any drivers that were discovered but not loaded
-  because the dependency experessions evaluated to false.
+  because the dependency experessions evaluated to false, with what they are
+  waiting on. Then display the time taken to load and start each driver.
 
 **/
 VOID
@@ -1474,11 +1520,46 @@ CoreDisplayDiscoveredNotDispatched (
 {
   LIST_ENTRY             *Link;
   EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  EFI_CORE_DRIVER_ENTRY  *Slowest;
+  UINTN                  Dispatched;
+  UINT64                 TotalTime;
+
+  Slowest    = NULL;
+  Dispatched = 0;
+  TotalTime  = 0;
 
   for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
     DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
     if (DriverEntry->Dependent) {
       DEBUG ((DEBUG_LOAD, "Driver %g was discovered but not loaded!!\n", &DriverEntry->FileName));
+      CoreDisplayDepexWaits (DriverEntry);
     }
+
+    if (DriverEntry->DispatchTime != 0) {
+      DEBUG ((
+        DEBUG_DISPATCH,
+        "Driver %g dispatched in %ld us\n",
+        &DriverEntry->FileName,
+        DivU64x32 (DriverEntry->DispatchTime, 1000)
+        ));
+
+      Dispatched++;
+      TotalTime += DriverEntry->DispatchTime;
+      if ((Slowest == NULL) || (DriverEntry->DispatchTime > Slowest->DispatchTime)) {
+        Slowest = DriverEntry;
+      }
+    }
+  }
+
+  if (Slowest != NULL) {
+    DEBUG ((
+      DEBUG_INFO,
+      "DXE Dispatcher: %d drivers dispatched in %ld ms after %d DEPEX evaluations, slowest %g in %ld us\n",
+      Dispatched,
+      DivU64x32 (TotalTime, 1000000),
+      mDepexEvaluations,
+      &Slowest->FileName,
+      DivU64x32 (Slowest->DispatchTime, 1000)
+      ));
   }
 }
@@ -60,6 +60,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/LoadModuleAtFixedAddress.h>
 #include <Guid/IdleLoopEvent.h>
 #include <Guid/VectorHandoffTable.h>
+#include <Guid/FfsFileIndex.h>
+#include <Guid/HobIndexTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
 
@@ -69,6 +71,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
 #include <Library/PerformanceLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiDecompressLib.h>
 #include <Library/ExtractGuidedSectionLib.h>
 #include <Library/CacheMaintenanceLib.h>
@@ -77,6 +80,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PeCoffGetEntryPointLib.h>
 #include <Library/PeCoffExtraActionLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -160,8 +164,30 @@ typedef struct {
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
+
+  BOOLEAN                          DepexIndexed;    // Depex protocols in the reverse index
+  BOOLEAN                          DepexDirty;      // Depex to evaluate again
+  UINT64                           DispatchTime;    // Load and start time in nanoseconds
 } EFI_CORE_DRIVER_ENTRY;
 
+//
+// Node of a red-black tree indexing a map by start address
+//
+typedef struct _CORE_MAP_NODE CORE_MAP_NODE;
+struct _CORE_MAP_NODE {
+  CORE_MAP_NODE    *Parent;
+  CORE_MAP_NODE    *Left;
+  CORE_MAP_NODE    *Right;
+  UINT64           *Start;
+  UINT64           Weight;
+  UINT64           MaxWeight;
+  BOOLEAN          Red;
+};
+
+typedef struct {
+  CORE_MAP_NODE    *Root;
+} CORE_MAP_TREE;
+
 //
 // The data structure of GCD memory map entry
 //
@@ -177,6 +203,7 @@ typedef struct {
   EFI_GCD_IO_TYPE         GcdIoType;
   EFI_HANDLE              ImageHandle;
   EFI_HANDLE              DeviceHandle;
+  CORE_MAP_NODE           TreeNode;
 } EFI_GCD_MAP_ENTRY;
 
 #define LOADED_IMAGE_PRIVATE_DATA_SIGNATURE  SIGNATURE_32('l','d','r','i')
@@ -248,6 +275,21 @@ typedef struct {
   LIST_ENTRY              CodeSegmentList;
 } IMAGE_PROPERTIES_RECORD;
 
+//
+// The types of call recorded by the call profiler
+//
+typedef enum {
+  CallProfileRoot,
+  CallProfileLoadImage,
+  CallProfileStartImage,
+  CallProfileConnectController,
+  CallProfileSupported,
+  CallProfileStart,
+  CallProfileNotify,
+  CallProfileRestoreTpl,
+  CallProfileTypeMax
+} CALL_PROFILE_TYPE;
+
 //
 // DXE Core Global Variables
 //
@@ -295,6 +337,135 @@ CoreInitializePool (
   VOID
   );
 
+/**
+  Insert the node of a map entry in a tree.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node of the map entry.
+  @param  Start                  Points to the start address of the map entry.
+  @param  Weight                 The weight of the map entry.
+
+**/
+VOID
+CoreMapTreeInsert (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         *Start,
+  IN UINT64         Weight
+  );
+
+/**
+  Remove the node of a map entry from a tree.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node of the map entry.
+
+**/
+VOID
+CoreMapTreeDelete (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node
+  );
+
+/**
+  Change the weight of the node of a map entry.
+
+  @param  Node                   The node of the map entry.
+  @param  Weight                 The new weight of the map entry.
+
+**/
+VOID
+CoreMapTreeSetWeight (
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         Weight
+  );
+
+/**
+  Find the map entry with the highest start address at or below an address.
+  In a map that covers the address, that's the entry holding it.
+
+  @param  Tree                   The tree.
+  @param  Address                The address.
+
+  @return The node of the map entry, or NULL if all the entries start above
+          the address.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeFind (
+  IN CORE_MAP_TREE  *Tree,
+  IN UINT64         Address
+  );
+
+/**
+  Get the map entry with the lowest start address.
+
+  @param  Tree                   The tree.
+
+  @return The node of the map entry, or NULL if the tree is empty.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeFirst (
+  IN CORE_MAP_TREE  *Tree
+  );
+
+/**
+  Get the map entry following another one in address order.
+
+  @param  Node                   The node of the map entry.
+
+  @return The node of the next map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeNext (
+  IN CORE_MAP_NODE  *Node
+  );
+
+/**
+  Find the map entry preceding another one in address order with at least a
+  weight. The entries with a smaller weight are skipped a subtree at a time.
+
+  @param  Node                   The node of the map entry.
+  @param  Weight                 The minimum weight.
+
+  @return The node of the map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreePrevFit (
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         Weight
+  );
+
+/**
+  Find the map entry with the highest start address at or below an address
+  and at least a weight.
+
+  @param  Tree                   The tree.
+  @param  Address                The address.
+  @param  Weight                 The minimum weight.
+
+  @return The node of the map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeLastFit (
+  IN CORE_MAP_TREE  *Tree,
+  IN UINT64         Address,
+  IN UINT64         Weight
+  );
+
+/**
+  Display the usage of the pool and of its slabs for each memory type.
+
+**/
+VOID
+CoreDisplayPoolStatistics (
+  VOID
+  );
+
 /**
   Called to initialize the memory map and add descriptors to
   the current descriptor list.
@@ -460,6 +631,24 @@ CoreInitializeDispatcher (
   VOID
   );
 
+/**
+  Enter critical section by gaining lock on mDispatcherLock.
+
+**/
+VOID
+CoreAcquireDispatcherLock (
+  VOID
+  );
+
+/**
+  Exit critical section by releasing lock on mDispatcherLock.
+
+**/
+VOID
+CoreReleaseDispatcherLock (
+  VOID
+  );
+
 /**
   This is the POSTFIX version of the dependency evaluator.  This code does
   not need to handle Before or After, as it is not valid to call this
@@ -495,6 +684,43 @@ CorePreProcessDepex (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   );
 
+/**
+  Add the protocols pushed by the dependency expression of a driver to the
+  reverse index, so that the installation of one of them marks the driver
+  for evaluation. If the index can't be updated, DriverEntry->DepexIndexed
+  is left FALSE and the driver is evaluated on every dispatch pass.
+
+  @param  DriverEntry           DriverEntry element with a pre-processed Depex.
+
+**/
+VOID
+CoreIndexDepex (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
+/**
+  Mark the drivers whose dependency expression pushes a protocol for
+  evaluation, as the protocol has been installed.
+
+  @param  Protocol              The GUID of the installed protocol.
+
+**/
+VOID
+CoreDepexProtocolInstalled (
+  IN  EFI_GUID  *Protocol
+  );
+
+/**
+  Display what the dependency expression of a driver is still waiting on.
+
+  @param  DriverEntry           DriverEntry element in the Dependent state.
+
+**/
+VOID
+CoreDisplayDepexWaits (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
 /**
   Terminates all boot services.
 
@@ -2410,6 +2636,99 @@ CoreRemoveDebugImageInfoEntry (
   EFI_HANDLE  ImageHandle
   );
 
+/**
+  Finds an image in the DebugImageInfo Table, by its image handle or by an
+  address in the image. The table isn't searched while it's being updated.
+
+  @param  ImageHandle    image handle of the image, or NULL to find the image
+                         by Address
+  @param  Address        an address in the image, if ImageHandle is NULL
+
+  @return The loaded image protocol of the image, or NULL if it isn't found.
+
+**/
+EFI_LOADED_IMAGE_PROTOCOL *
+CoreFindDebugImageInfoEntry (
+  IN EFI_HANDLE  ImageHandle  OPTIONAL,
+  IN UINTN       Address
+  );
+
+/**
+  Initializes the call profiler, if PcdDxeCoreCallProfileNodes isn't zero. The
+  time spent in the DXE Core since then goes to the root node of the profile.
+
+**/
+VOID
+CoreInitializeCallProfile (
+  VOID
+  );
+
+/**
+  Returns the key of the call profile nodes of an image, the CRC32 of its file
+  path, or the image handle if it has no file path.
+
+  @param  FilePath               The file path of the image.
+  @param  ImageHandle            The image handle, NULL if not known yet.
+
+  @return The key, 0 if the call profiler is disabled.
+
+**/
+UINTN
+CoreCallProfileImageKey (
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN EFI_HANDLE                ImageHandle OPTIONAL
+  );
+
+/**
+  Record the entry to a call in the call profile.
+
+  @param  Type                   The type of the call.
+  @param  Key                    The key of the call, telling apart the calls of
+                                 the same type made from the same calling context.
+  @param  ImageHandle            The image the call is made to, if known, to name
+                                 the call after.
+
+  @return The token to give to CoreCallProfileExit() when the call returns.
+
+**/
+UINTN
+CoreCallProfileEnter (
+  IN CALL_PROFILE_TYPE  Type,
+  IN UINTN              Key,
+  IN EFI_HANDLE         ImageHandle OPTIONAL
+  );
+
+/**
+  Record the return from a call in the call profile.
+
+  The calls entered after it and not returned from, the ones left with a long
+  jump by Exit(), are returned from as well.
+
+  @param  Token                  The token CoreCallProfileEnter() returned for the call.
+  @param  ImageHandle            The image the call loaded, to name the call after
+                                 if it has no name yet.
+
+**/
+VOID
+CoreCallProfileExit (
+  IN UINTN       Token,
+  IN EFI_HANDLE  ImageHandle OPTIONAL
+  );
+
+/**
+  Build the index of the GUIDed HOBs of a HOB list.
+
+  @param  HobStart               The HOB list.
+
+  @return The HOB index table, allocated from pool, or NULL if there isn't
+          enough memory for it.
+
+**/
+EDKII_HOB_INDEX_TABLE *
+CoreBuildHobIndexTable (
+  IN VOID  *HobStart
+  );
+
 /**
   This routine consumes FV hobs and produces instances of FW_VOL_BLOCK_PROTOCOL as appropriate.
 
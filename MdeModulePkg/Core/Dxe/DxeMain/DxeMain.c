@@ -2,6 +2,7 @@
   DXE Core Main Entry Point
 
 Copyright (c) 2006 - 2022, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -243,6 +244,7 @@ DxeMain (
   EFI_VECTOR_HANDOFF_INFO       *VectorInfoList;
   EFI_VECTOR_HANDOFF_INFO       *VectorInfo;
   VOID                          *EntryPoint;
+  EDKII_HOB_INDEX_TABLE         *HobIndexTable;
 
   //
   // Setup the default exception handlers
@@ -348,6 +350,15 @@ DxeMain (
   Status = CoreInstallConfigurationTable (&gEfiHobListGuid, HobStart);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Install the index of the GUIDed HOBs of the HOB List next to it
+  //
+  HobIndexTable = CoreBuildHobIndexTable (HobStart);
+  if (HobIndexTable != NULL) {
+    Status = CoreInstallConfigurationTable (&gEdkiiHobIndexTableGuid, HobIndexTable);
+    ASSERT_EFI_ERROR (Status);
+  }
+
   //
   // Install Memory Type Information Table into the EFI System Tables's Configuration Table
   //
@@ -450,6 +461,8 @@ DxeMain (
   Status = CoreInitializeEventServices ();
   ASSERT_EFI_ERROR (Status);
 
+  CoreInitializeCallProfile ();
+
   MemoryProfileInstallProtocol ();
 
   CoreInitializeMemoryAttributesTable ();
@@ -545,6 +558,13 @@ DxeMain (
   CoreDisplayDiscoveredNotDispatched ();
   DEBUG_CODE_END ();
 
+  //
+  // Display the pool usage if this is a debug build
+  //
+  DEBUG_CODE_BEGIN ();
+  CoreDisplayPoolStatistics ();
+  DEBUG_CODE_END ();
+
   //
   // Assert if the Architectural Protocols are not present.
   //
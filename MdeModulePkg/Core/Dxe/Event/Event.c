@@ -2,6 +2,7 @@
   UEFI Event support functions implemented in this file.
 
 Copyright (c) 2006 - 2017, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 (C) Copyright 2015 Hewlett Packard Enterprise Development LP<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -155,6 +156,7 @@ CoreDispatchEventNotifies (
 {
   IEVENT      *Event;
   LIST_ENTRY  *Head;
+  UINTN       ProfileToken;
 
   CoreAcquireEventLock ();
   ASSERT (gEventQueueLock.OwnerTpl == Priority);
@@ -183,7 +185,9 @@ CoreDispatchEventNotifies (
     // Notify this event
     //
     ASSERT (Event->NotifyFunction != NULL);
+    ProfileToken = CoreCallProfileEnter (CallProfileNotify, (UINTN)Event->NotifyFunction, NULL);
     Event->NotifyFunction (Event, Event->NotifyContext);
+    CoreCallProfileExit (ProfileToken, NULL);
 
     //
     // Check for next pending event
@@ -29,10 +29,22 @@ extern  UINTN  gEventPending;
 ///
 /// Timer event information
 ///
-typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+typedef struct _TIMER_EVENT_INFO {
+  ///
+  /// Node of the timer heap: the first child, the next sibling, and the
+  /// previous sibling or the parent of the first child. Prev is NULL if the
+  /// timer isn't queued or is the root.
+  ///
+  struct _TIMER_EVENT_INFO    *Child;
+  struct _TIMER_EVENT_INFO    *Sibling;
+  struct _TIMER_EVENT_INFO    *Prev;
+  UINT64                      TriggerTime;
+  UINT64                      Period;
+  ///
+  /// Queuing order, so that the timers that expire together are signaled
+  /// in the order they were set
+  ///
+  UINT64                      Sequence;
 } TIMER_EVENT_INFO;
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
@@ -2,6 +2,7 @@
   Core Timer Services
 
 Copyright (c) 2006 - 2013, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,18 +13,233 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Internal data
 //
+// The timer database is a pairing heap ordered on the trigger time, then on
+// the queuing order. The heap is linked through the timer events, so that
+// setting a timer never allocates memory and can be done at any TPL.
+//
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+TIMER_EVENT_INFO  *mEfiTimerHeap      = NULL;
+UINT64            mEfiTimerSequence   = 0;
+EFI_LOCK          mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT         mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
 
+//
+// Timer tick statistics, collected when performance measurement is enabled.
+// The longest CoreCheckTimers() run since the last report is logged as a
+// performance record at ReadyToBoot; FPDT records can't be added at the TPL
+// the timers are checked at.
+//
+#define TIMER_TICK_PERF_TOKEN  "TimerTick"
+
+BOOLEAN  mTimerTickStatistics = FALSE;
+BOOLEAN  mTimerTickCountUp    = TRUE;
+UINT64   mTimerTickCount      = 0;
+UINT64   mTimerTickSignaled   = 0;
+UINT64   mTimerTickTotal      = 0;
+UINT64   mTimerTickMax        = 0;
+UINT64   mTimerTickMaxStart   = 0;
+UINT64   mTimerTickMaxEnd     = 0;
+
 //
 // Timer functions
 //
 
+/**
+  Checks whether a timer expires before another one.
+
+  @param  Timer1                 The first timer
+  @param  Timer2                 The second timer
+
+  @retval TRUE                   Timer1 is to be signaled before Timer2
+  @retval FALSE                  Timer2 is to be signaled before Timer1
+
+**/
+STATIC
+BOOLEAN
+CoreTimerBefore (
+  IN TIMER_EVENT_INFO  *Timer1,
+  IN TIMER_EVENT_INFO  *Timer2
+  )
+{
+  if (Timer1->TriggerTime != Timer2->TriggerTime) {
+    return (BOOLEAN)(Timer1->TriggerTime < Timer2->TriggerTime);
+  }
+
+  return (BOOLEAN)(Timer1->Sequence < Timer2->Sequence);
+}
+
+/**
+  Melds two timer heaps.
+
+  @param  Heap1                  The root of the first heap, may be NULL
+  @param  Heap2                  The root of the second heap, may be NULL
+
+  @return The root of the melded heap
+
+**/
+STATIC
+TIMER_EVENT_INFO *
+CoreTimerMeld (
+  IN TIMER_EVENT_INFO  *Heap1,
+  IN TIMER_EVENT_INFO  *Heap2
+  )
+{
+  TIMER_EVENT_INFO  *Root;
+  TIMER_EVENT_INFO  *Child;
+
+  if (Heap1 == NULL) {
+    return Heap2;
+  }
+
+  if (Heap2 == NULL) {
+    return Heap1;
+  }
+
+  if (CoreTimerBefore (Heap2, Heap1)) {
+    Root  = Heap2;
+    Child = Heap1;
+  } else {
+    Root  = Heap1;
+    Child = Heap2;
+  }
+
+  //
+  // The other root becomes the first child of the root
+  //
+  Child->Sibling = Root->Child;
+  if (Root->Child != NULL) {
+    Root->Child->Prev = Child;
+  }
+
+  Child->Prev = Root;
+  Root->Child = Child;
+  return Root;
+}
+
+/**
+  Melds a list of sibling heaps into one, pairwise from the first to the
+  last, then from the last pair back to the first.
+
+  @param  First                  The first heap of the list, may be NULL
+
+  @return The root of the melded heap, with no sibling and no parent
+
+**/
+STATIC
+TIMER_EVENT_INFO *
+CoreTimerMeldSiblings (
+  IN TIMER_EVENT_INFO  *First
+  )
+{
+  TIMER_EVENT_INFO  *Pairs;
+  TIMER_EVENT_INFO  *Heap1;
+  TIMER_EVENT_INFO  *Heap2;
+  TIMER_EVENT_INFO  *Next;
+  TIMER_EVENT_INFO  *Root;
+
+  //
+  // First pass: meld the heaps by pairs, and stack the results
+  //
+  Pairs = NULL;
+  while (First != NULL) {
+    Heap1 = First;
+    Heap2 = Heap1->Sibling;
+    Next  = (Heap2 != NULL) ? Heap2->Sibling : NULL;
+
+    Heap1->Sibling = NULL;
+    Heap1->Prev    = NULL;
+    if (Heap2 != NULL) {
+      Heap2->Sibling = NULL;
+      Heap2->Prev    = NULL;
+    }
+
+    Root          = CoreTimerMeld (Heap1, Heap2);
+    Root->Sibling = Pairs;
+    Pairs         = Root;
+    First         = Next;
+  }
+
+  //
+  // Second pass: meld the stacked pairs, last pair first
+  //
+  Root = NULL;
+  while (Pairs != NULL) {
+    Next           = Pairs->Sibling;
+    Pairs->Sibling = NULL;
+    Root           = CoreTimerMeld (Root, Pairs);
+    Pairs          = Next;
+  }
+
+  return Root;
+}
+
+/**
+  Checks whether the timer event is in the timer database.
+
+  @param  Event                  Points to the internal structure of timer event
+
+  @retval TRUE                   The timer is queued
+  @retval FALSE                  The timer isn't queued
+
+**/
+STATIC
+BOOLEAN
+CoreIsEventTimerQueued (
+  IN IEVENT  *Event
+  )
+{
+  return (BOOLEAN)((mEfiTimerHeap == &Event->Timer) || (Event->Timer.Prev != NULL));
+}
+
+/**
+  Removes the timer event from the timer database.
+
+  @param  Event                  Points to the internal structure of timer event,
+                                 which is queued
+
+**/
+STATIC
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  TIMER_EVENT_INFO  *Timer;
+  TIMER_EVENT_INFO  *Children;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  Timer    = &Event->Timer;
+  Children = CoreTimerMeldSiblings (Timer->Child);
+
+  if (Timer == mEfiTimerHeap) {
+    mEfiTimerHeap = Children;
+  } else {
+    //
+    // Unlink the subtree of the timer from its parent or previous sibling,
+    // and meld its children back into the heap
+    //
+    if (Timer->Prev->Child == Timer) {
+      Timer->Prev->Child = Timer->Sibling;
+    } else {
+      Timer->Prev->Sibling = Timer->Sibling;
+    }
+
+    if (Timer->Sibling != NULL) {
+      Timer->Sibling->Prev = Timer->Prev;
+    }
+
+    mEfiTimerHeap = CoreTimerMeld (mEfiTimerHeap, Children);
+  }
+
+  Timer->Child   = NULL;
+  Timer->Sibling = NULL;
+  Timer->Prev    = NULL;
+}
+
 /**
   Inserts the timer event.
 
@@ -36,29 +252,71 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
-
   ASSERT_LOCKED (&mEfiTimerLock);
 
-  //
-  // Get the timer's trigger time
-  //
-  TriggerTime = Event->Timer.TriggerTime;
+  Event->Timer.Child    = NULL;
+  Event->Timer.Sibling  = NULL;
+  Event->Timer.Prev     = NULL;
+  Event->Timer.Sequence = mEfiTimerSequence++;
+
+  mEfiTimerHeap = CoreTimerMeld (mEfiTimerHeap, &Event->Timer);
+}
+
+/**
+  Reports the timer tick statistics collected since the last report: the
+  longest CoreCheckTimers() run is logged as a performance record.
+
+  @param  Event                  Not used
+  @param  Context                Not used
+
+**/
+STATIC
+VOID
+EFIAPI
+CoreReportTimerTickStatistics (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_TPL  OldTpl;
+  UINT64   Count;
+  UINT64   Signaled;
+  UINT64   Total;
+  UINT64   Max;
+  UINT64   MaxStart;
+  UINT64   MaxEnd;
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Take a consistent copy, the timers may be checked meanwhile
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
-    }
+  OldTpl   = CoreRaiseTpl (TPL_HIGH_LEVEL);
+  Count    = mTimerTickCount;
+  Signaled = mTimerTickSignaled;
+  Total    = mTimerTickTotal;
+  Max      = mTimerTickMax;
+  MaxStart = mTimerTickMaxStart;
+  MaxEnd   = mTimerTickMaxEnd;
+
+  mTimerTickMax = 0;
+  CoreRestoreTpl (OldTpl);
+
+  if (Count == 0) {
+    return;
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  DEBUG ((
+    DEBUG_INFO,
+    "Timer ticks: %ld processed, %ld timers signaled, average %ld ns, longest %ld ns\n",
+    Count,
+    Signaled,
+    DivU64x64Remainder (GetTimeInNanoSecond (Total), Count, NULL),
+    GetTimeInNanoSecond (Max)
+    ));
+
+  if (Max != 0) {
+    PERF_START (gDxeCoreImageHandle, TIMER_TICK_PERF_TOKEN, NULL, MaxStart);
+    PERF_END (gDxeCoreImageHandle, TIMER_TICK_PERF_TOKEN, NULL, MaxEnd);
+  }
 }
 
 /**
@@ -98,6 +356,16 @@ CoreCheckTimers (
 {
   UINT64  SystemTime;
   IEVENT  *Event;
+  UINT64  Start;
+  UINT64  End;
+  UINT64  Elapsed;
+  UINTN   Signaled;
+
+  Start    = 0;
+  Signaled = 0;
+  if (mTimerTickStatistics) {
+    Start = GetPerformanceCounter ();
+  }
 
   //
   // Check the timer database for expired timers
@@ -105,8 +373,9 @@ CoreCheckTimers (
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (mEfiTimerHeap != NULL) {
+    Event = BASE_CR (mEfiTimerHeap, IEVENT, Timer);
+    ASSERT (Event->Signature == EVENT_SIGNATURE);
 
     //
     // If this timer is not expired, then we're done
@@ -118,14 +387,13 @@ CoreCheckTimers (
     //
     // Remove this timer from the timer queue
     //
-
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
 
     //
     // Signal it
     //
     CoreSignalEvent (Event);
+    Signaled++;
 
     //
     // If this is a periodic timer, set it
@@ -151,6 +419,20 @@ CoreCheckTimers (
     }
   }
 
+  if (mTimerTickStatistics) {
+    End     = GetPerformanceCounter ();
+    Elapsed = mTimerTickCountUp ? End - Start : Start - End;
+
+    mTimerTickCount++;
+    mTimerTickSignaled += Signaled;
+    mTimerTickTotal    += Elapsed;
+    if (Elapsed > mTimerTickMax) {
+      mTimerTickMax      = Elapsed;
+      mTimerTickMaxStart = Start;
+      mTimerTickMaxEnd   = End;
+    }
+  }
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -164,6 +446,9 @@ CoreInitializeTimer (
   )
 {
   EFI_STATUS  Status;
+  EFI_EVENT   ReadyToBootEvent;
+  UINT64      StartValue;
+  UINT64      EndValue;
 
   Status = CoreCreateEventInternal (
              EVT_NOTIFY_SIGNAL,
@@ -174,6 +459,21 @@ CoreInitializeTimer (
              &mEfiCheckTimerEvent
              );
   ASSERT_EFI_ERROR (Status);
+
+  if (PerformanceMeasurementEnabled ()) {
+    GetPerformanceCounterProperties (&StartValue, &EndValue);
+    mTimerTickCountUp = (BOOLEAN)(EndValue >= StartValue);
+
+    Status = CoreCreateEventEx (
+               EVT_NOTIFY_SIGNAL,
+               TPL_CALLBACK,
+               CoreReportTimerTickStatistics,
+               NULL,
+               &gEfiEventReadyToBootGuid,
+               &ReadyToBootEvent
+               );
+    mTimerTickStatistics = (BOOLEAN)!EFI_ERROR (Status);
+  }
 }
 
 /**
@@ -202,11 +502,11 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the root of the heap is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  if (mEfiTimerHeap != NULL) {
+    Event = BASE_CR (mEfiTimerHeap, IEVENT, Timer);
 
     if (Event->Timer.TriggerTime <= mEfiSystemTime) {
       CoreSignalEvent (mEfiCheckTimerEvent);
@@ -260,9 +560,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (CoreIsEventTimerQueued (Event)) {
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -2,6 +2,7 @@
   Task priority (TPL) functions.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -98,6 +99,7 @@ CoreRestoreTpl (
 {
   EFI_TPL  OldTpl;
   EFI_TPL  PendingTpl;
+  UINTN    ProfileToken;
 
   OldTpl = gEfiCurrentTpl;
   if (NewTpl > OldTpl) {
@@ -130,7 +132,9 @@ CoreRestoreTpl (
       CoreSetInterruptState (TRUE);
     }
 
+    ProfileToken = CoreCallProfileEnter (CallProfileRestoreTpl, PendingTpl, NULL);
     CoreDispatchEventNotifies (gEfiCurrentTpl);
+    CoreCallProfileExit (ProfileToken, NULL);
   }
 
   //
@@ -4,6 +4,7 @@
   of FV based files.
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -38,6 +39,7 @@ FV_DEVICE  mFvDevice = {
   NULL,
   NULL,
   { NULL,                 NULL},
+  { NULL },
   0,
   0,
   FALSE,
@@ -296,6 +298,135 @@ FreeFvDeviceResource (
   return;
 }
 
+/**
+  Build the FFS file list of a memory mapped FV from the file index the PEI
+  Core built for it, instead of walking the FFS headers.
+
+  The index is only used if every file it records still has a valid header
+  with the recorded name, type and size. The files are not cached here, so
+  FvReadFile() verifies the data checksum of each file on its cached copy.
+
+  @param  FvDevice              A pointer to the FvDevice, with an empty file list.
+
+  @retval TRUE                  The file list is built.
+  @retval FALSE                 The FV has no usable index, the file list is
+                                left empty.
+
+**/
+STATIC
+BOOLEAN
+FvBuildFfsFileListFromIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  EFI_HOB_GUID_TYPE           *GuidHob;
+  EDKII_FFS_FILE_INDEX        *FileIndex;
+  EDKII_FFS_FILE_INDEX_ENTRY  *Entry;
+  EFI_FFS_FILE_HEADER         *FfsHeader;
+  EFI_FFS_FILE_STATE          FileState;
+  FFS_FILE_LIST_ENTRY         *FfsFileEntry;
+  LIST_ENTRY                  *Link;
+  UINT32                      Index;
+  UINT32                      FileSize;
+
+  FileIndex = NULL;
+  GuidHob   = GetFirstGuidHob (&gEdkiiFfsFileIndexHobGuid);
+  while (GuidHob != NULL) {
+    FileIndex = GET_GUID_HOB_DATA (GuidHob);
+    if ((FileIndex->FvBase == (EFI_PHYSICAL_ADDRESS)(UINTN)FvDevice->CachedFv) &&
+        (FileIndex->FvLength == FvDevice->FwVolHeader->FvLength) &&
+        (GET_GUID_HOB_DATA_SIZE (GuidHob) >= OFFSET_OF (EDKII_FFS_FILE_INDEX, Entry) + FileIndex->FileCount * sizeof (EDKII_FFS_FILE_INDEX_ENTRY)))
+    {
+      break;
+    }
+
+    GuidHob = GetNextGuidHob (&gEdkiiFfsFileIndexHobGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  if (GuidHob == NULL) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < FileIndex->FileCount; Index++) {
+    Entry = &FileIndex->Entry[Index];
+    if ((Entry->Size < sizeof (EFI_FFS_FILE_HEADER)) ||
+        ((UINT64)Entry->Offset + Entry->Size > FileIndex->FvLength))
+    {
+      break;
+    }
+
+    //
+    // Check that the file is still the one the index was built for.
+    //
+    FfsHeader = (EFI_FFS_FILE_HEADER *)(FvDevice->CachedFv + Entry->Offset);
+    if (!IsValidFfsHeader (FvDevice->ErasePolarity, FfsHeader, &FileState) ||
+        (FileState == EFI_FILE_DELETED) ||
+        (IS_FFS_FILE2 (FfsHeader) && !FvDevice->IsFfs3Fv) ||
+        (FfsHeader->Type != Entry->Type) ||
+        !CompareGuid (&FfsHeader->Name, &Entry->Name))
+    {
+      break;
+    }
+
+    FileSize = IS_FFS_FILE2 (FfsHeader) ? FFS_FILE2_SIZE (FfsHeader) : FFS_FILE_SIZE (FfsHeader);
+    if (FileSize != Entry->Size) {
+      break;
+    }
+
+    FfsFileEntry = AllocateZeroPool (sizeof (FFS_FILE_LIST_ENTRY));
+    if (FfsFileEntry == NULL) {
+      break;
+    }
+
+    FfsFileEntry->FfsHeader = FfsHeader;
+    InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
+  }
+
+  if (Index < FileIndex->FileCount) {
+    DEBUG ((DEBUG_WARN, "The file index of FV %p is not used, file %d does not match the FV.\n", FvDevice->CachedFv, Index));
+    while (!IsListEmpty (&FvDevice->FfsFileListHeader)) {
+      Link = GetFirstNode (&FvDevice->FfsFileListHeader);
+      RemoveEntryList (Link);
+      CoreFreePool (Link);
+    }
+
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Hash the files of the FFS file list of an FV on their names, for FvReadFile().
+
+  @param  FvDevice              A pointer to the FvDevice.
+
+**/
+STATIC
+VOID
+FvHashFfsFileList (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  LIST_ENTRY           *Link;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+  FFS_FILE_LIST_ENTRY  **Bucket;
+
+  //
+  // Chain the files of each bucket in FV order, starting from the last file.
+  //
+  ZeroMem (FvDevice->FfsFileHash, sizeof (FvDevice->FfsFileHash));
+  for (Link = GetPreviousNode (&FvDevice->FfsFileListHeader, &FvDevice->FfsFileListHeader);
+       Link != &FvDevice->FfsFileListHeader;
+       Link = GetPreviousNode (&FvDevice->FfsFileListHeader, Link))
+  {
+    FfsFileEntry           = (FFS_FILE_LIST_ENTRY *)Link;
+    Bucket                 = &FvDevice->FfsFileHash[EDKII_FFS_FILE_INDEX_BUCKET (&FfsFileEntry->FfsHeader->Name)];
+    FfsFileEntry->HashNext = *Bucket;
+    *Bucket                = FfsFileEntry;
+  }
+}
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -421,6 +552,10 @@ FvCheck (
   Status = EFI_SUCCESS;
   InitializeListHead (&FvDevice->FfsFileListHeader);
 
+  if (FvDevice->IsMemoryMapped && FvBuildFfsFileListFromIndex (FvDevice)) {
+    goto Done;
+  }
+
   //
   // Build FFS list
   //
@@ -559,6 +694,8 @@ Done:
     }
 
     FreeFvDeviceResource (FvDevice);
+  } else {
+    FvHashFfsFileList (FvDevice);
   }
 
   return Status;
@@ -3,6 +3,7 @@
   Block protocol to produce a file abstraction of FV based files.
 
 Copyright (c) 2006 - 2014, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -12,15 +13,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define FV2_DEVICE_SIGNATURE  SIGNATURE_32 ('_', 'F', 'V', '2')
 
+typedef struct _FFS_FILE_LIST_ENTRY FFS_FILE_LIST_ENTRY;
+
 //
 // Used to track all non-deleted files
 //
-typedef struct {
+struct _FFS_FILE_LIST_ENTRY {
   LIST_ENTRY             Link;
   EFI_FFS_FILE_HEADER    *FfsHeader;
   UINTN                  StreamHandle;
   BOOLEAN                FileCached;
-} FFS_FILE_LIST_ENTRY;
+  //
+  // Next file in the same bucket of FV_DEVICE.FfsFileHash, in FV order.
+  //
+  FFS_FILE_LIST_ENTRY    *HashNext;
+};
 
 typedef struct {
   UINTN                                 Signature;
@@ -35,6 +42,10 @@ typedef struct {
   FFS_FILE_LIST_ENTRY                   *LastKey;
 
   LIST_ENTRY                            FfsFileListHeader;
+  //
+  // The files of FfsFileListHeader, hashed on the file name.
+  //
+  FFS_FILE_LIST_ENTRY                   *FfsFileHash[EDKII_FFS_FILE_INDEX_BUCKETS];
 
   UINT32                                AuthenticationStatus;
   UINT8                                 ErasePolarity;
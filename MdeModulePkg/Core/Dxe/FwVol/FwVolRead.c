@@ -2,6 +2,7 @@
   Implements functions to read firmware file
 
 Copyright (c) 2006 - 2020, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -275,42 +276,51 @@ FvReadFile (
   OUT      UINT32                         *AuthenticationStatus
   )
 {
-  EFI_STATUS              Status;
-  FV_DEVICE               *FvDevice;
-  EFI_GUID                SearchNameGuid;
-  EFI_FV_FILETYPE         LocalFoundType;
-  EFI_FV_FILE_ATTRIBUTES  LocalAttributes;
-  UINTN                   FileSize;
-  UINT8                   *SrcPtr;
-  EFI_FFS_FILE_HEADER     *FfsHeader;
-  UINTN                   InputBufferSize;
-  UINTN                   WholeFileSize;
+  EFI_STATUS           Status;
+  FV_DEVICE            *FvDevice;
+  EFI_FV_ATTRIBUTES    FvAttributes;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+  UINTN                FileSize;
+  UINT8                *SrcPtr;
+  EFI_FFS_FILE_HEADER  *FfsHeader;
+  UINTN                InputBufferSize;
+  UINTN                WholeFileSize;
 
   if (NameGuid == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  FvDevice = FV_DEVICE_FROM_THIS (This);
+  FvDevice          = FV_DEVICE_FROM_THIS (This);
+  FvDevice->LastKey = NULL;
 
   //
-  // Keep looking until we find the matching NameGuid.
+  // Check if read operation is enabled
+  //
+  Status = FvGetVolumeAttributes (This, &FvAttributes);
+  if (EFI_ERROR (Status) || ((FvAttributes & EFI_FV2_READ_STATUS) == 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Look the file up by its name, skipping the pad files as FvGetNextFile() does.
   // The Key is really a FfsFileEntry
   //
-  FvDevice->LastKey = 0;
-  do {
-    LocalFoundType = 0;
-    Status         = FvGetNextFile (
-                       This,
-                       &FvDevice->LastKey,
-                       &LocalFoundType,
-                       &SearchNameGuid,
-                       &LocalAttributes,
-                       &FileSize
-                       );
-    if (EFI_ERROR (Status)) {
-      return EFI_NOT_FOUND;
+  FfsFileEntry = FvDevice->FfsFileHash[EDKII_FFS_FILE_INDEX_BUCKET (NameGuid)];
+  while (FfsFileEntry != NULL) {
+    if ((FfsFileEntry->FfsHeader->Type != EFI_FV_FILETYPE_FFS_PAD) &&
+        CompareGuid (&FfsFileEntry->FfsHeader->Name, NameGuid))
+    {
+      break;
     }
-  } while (!CompareGuid (&SearchNameGuid, NameGuid));
+
+    FfsFileEntry = FfsFileEntry->HashNext;
+  }
+
+  if (FfsFileEntry == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  FvDevice->LastKey = FfsFileEntry;
 
   //
   // Get a pointer to the header
@@ -330,6 +340,20 @@ FvReadFile (
         return EFI_OUT_OF_RESOURCES;
       }
 
+      //
+      // The files listed from the file index of the PEI Core have not had their
+      // data checksum verified in DXE. Verify the file on the cached copy, so
+      // that it can't change in the FV after it was verified.
+      //
+      if ((WholeFileSize != (IS_FFS_FILE2 (FfsHeader) ? FFS_FILE2_SIZE (FfsHeader) : FFS_FILE_SIZE (FfsHeader))) ||
+          !IsValidFfsFile (FvDevice->ErasePolarity, FfsHeader))
+      {
+        DEBUG ((DEBUG_ERROR, "File %g of FV %p is corrupted.\n", NameGuid, FvDevice->CachedFv));
+        CoreFreePool (FfsHeader);
+        FvDevice->LastKey = NULL;
+        return EFI_DEVICE_ERROR;
+      }
+
       //
       // Let FfsHeader in FfsFileEntry point to the cached file buffer.
       //
@@ -338,6 +362,15 @@ FvReadFile (
     }
   }
 
+  //
+  // We need to substract the header size
+  //
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    FileSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+  }
+
   //
   // Remember callers buffer size
   //
@@ -4,6 +4,7 @@
   are accessible to the CPU that is executing the DXE core.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -45,6 +46,12 @@ EFI_LOCK    mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 LIST_ENTRY  mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY  mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+//
+// The entries of the GCD maps indexed by base address
+//
+CORE_MAP_TREE  mGcdMemorySpaceTree = { NULL };
+CORE_MAP_TREE  mGcdIoSpaceTree     = { NULL };
+
 EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -413,6 +420,23 @@ CoreAllocateGcdMapEntry (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the tree indexing a GCD map.
+
+  @param  Map                    The GCD map.
+
+  @return The tree of the GCD map.
+
+**/
+STATIC
+CORE_MAP_TREE *
+CoreGetGcdMapTree (
+  IN LIST_ENTRY  *Map
+  )
+{
+  return (Map == &mGcdMemorySpaceMap) ? &mGcdMemorySpaceTree : &mGcdIoSpaceTree;
+}
+
 /**
   Internal function.  Inserts a new descriptor into a sorted list
 
@@ -423,6 +447,7 @@ CoreAllocateGcdMapEntry (
   @param  Length                 The length of the new range in bytes
   @param  TopEntry               Top pad entry to insert if needed.
   @param  BottomEntry            Bottom pad entry to insert if needed.
+  @param  Map                    The GCD map the list belongs to.
 
   @retval EFI_SUCCESS            The new range was inserted into the linked list
 
@@ -434,7 +459,8 @@ CoreInsertGcdMapEntry (
   IN EFI_PHYSICAL_ADDRESS  BaseAddress,
   IN UINT64                Length,
   IN EFI_GCD_MAP_ENTRY     *TopEntry,
-  IN EFI_GCD_MAP_ENTRY     *BottomEntry
+  IN EFI_GCD_MAP_ENTRY     *BottomEntry,
+  IN LIST_ENTRY            *Map
   )
 {
   ASSERT (Length != 0);
@@ -446,6 +472,7 @@ CoreInsertGcdMapEntry (
     Entry->BaseAddress      = BaseAddress;
     BottomEntry->EndAddress = BaseAddress - 1;
     InsertTailList (Link, &BottomEntry->Link);
+    CoreMapTreeInsert (CoreGetGcdMapTree (Map), &BottomEntry->TreeNode, &BottomEntry->BaseAddress, 0);
   }
 
   if ((BaseAddress + Length - 1) < Entry->EndAddress) {
@@ -455,6 +482,7 @@ CoreInsertGcdMapEntry (
     TopEntry->BaseAddress = BaseAddress + Length;
     Entry->EndAddress     = BaseAddress + Length - 1;
     InsertHeadList (Link, &TopEntry->Link);
+    CoreMapTreeInsert (CoreGetGcdMapTree (Map), &TopEntry->TreeNode, &TopEntry->BaseAddress, 0);
   }
 
   return EFI_SUCCESS;
@@ -526,6 +554,8 @@ CoreMergeGcdMapEntry (
     return EFI_UNSUPPORTED;
   }
 
+  CoreMapTreeDelete (CoreGetGcdMapTree (Map), &AdjacentEntry->TreeNode);
+
   if (Forward) {
     Entry->EndAddress = AdjacentEntry->EndAddress;
   } else {
@@ -606,26 +636,38 @@ CoreSearchGcdMapEntry (
 {
   LIST_ENTRY         *Link;
   EFI_GCD_MAP_ENTRY  *Entry;
+  CORE_MAP_NODE      *Node;
 
   ASSERT (Length != 0);
 
   *StartLink = NULL;
   *EndLink   = NULL;
 
-  Link = Map->ForwardLink;
+  //
+  // Find the entry holding BaseAddress in the tree, then walk the list up to
+  // the entry holding the end of the segment
+  //
+  Node = CoreMapTreeFind (CoreGetGcdMapTree (Map), BaseAddress);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Entry = BASE_CR (Node, EFI_GCD_MAP_ENTRY, TreeNode);
+  ASSERT (Entry->Signature == EFI_GCD_MAP_SIGNATURE);
+  if (BaseAddress > Entry->EndAddress) {
+    return EFI_NOT_FOUND;
+  }
+
+  *StartLink = &Entry->Link;
+
+  Link = &Entry->Link;
   while (Link != Map) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    if ((BaseAddress >= Entry->BaseAddress) && (BaseAddress <= Entry->EndAddress)) {
-      *StartLink = Link;
-    }
-
-    if (*StartLink != NULL) {
-      if (((BaseAddress + Length - 1) >= Entry->BaseAddress) &&
-          ((BaseAddress + Length - 1) <= Entry->EndAddress))
-      {
-        *EndLink = Link;
-        return EFI_SUCCESS;
-      }
+    if (((BaseAddress + Length - 1) >= Entry->BaseAddress) &&
+        ((BaseAddress + Length - 1) <= Entry->EndAddress))
+    {
+      *EndLink = Link;
+      return EFI_SUCCESS;
     }
 
     Link = Link->ForwardLink;
@@ -934,7 +976,7 @@ CoreConvertSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry, Map);
     switch (Operation) {
       //
       // Add operations
@@ -1322,7 +1364,7 @@ CoreAllocateSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry, Map);
     Entry->ImageHandle  = ImageHandle;
     Entry->DeviceHandle = DeviceHandle;
     Link                = Link->ForwardLink;
@@ -2547,6 +2589,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfMemorySpace) - 1;
 
   InsertHeadList (&mGcdMemorySpaceMap, &Entry->Link);
+  CoreMapTreeInsert (&mGcdMemorySpaceTree, &Entry->TreeNode, &Entry->BaseAddress, 0);
 
   CoreDumpGcdMemorySpaceMap (TRUE);
 
@@ -2559,6 +2602,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfIoSpace) - 1;
 
   InsertHeadList (&mGcdIoSpaceMap, &Entry->Link);
+  CoreMapTreeInsert (&mGcdIoSpaceTree, &Entry->TreeNode, &Entry->BaseAddress, 0);
 
   CoreDumpGcdIoSpaceMap (TRUE);
 
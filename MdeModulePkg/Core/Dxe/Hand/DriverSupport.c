@@ -2,6 +2,7 @@
   Support functions to connect/disconnect UEFI Driver model Protocol
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -14,7 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 
 /**
-  Connects one or more drivers to a controller.
+  Worker function of CoreConnectController(), which records the call in the
+  call profile around it.
 
   @param  ControllerHandle      The handle of the controller to which driver(s) are to be connected.
   @param  DriverImageHandle     A pointer to an ordered list handles that support the
@@ -26,22 +28,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
                                 by ControllerHandle have been created. If FALSE, then
                                 the tree of controllers is only expanded one level.
 
-  @retval EFI_SUCCESS           1) One or more drivers were connected to ControllerHandle.
-                                2) No drivers were connected to ControllerHandle, but
-                                RemainingDevicePath is not NULL, and it is an End Device
-                                Path Node.
-  @retval EFI_INVALID_PARAMETER ControllerHandle is NULL.
-  @retval EFI_NOT_FOUND         1) There are no EFI_DRIVER_BINDING_PROTOCOL instances
-                                present in the system.
-                                2) No drivers were connected to ControllerHandle.
-  @retval EFI_SECURITY_VIOLATION
-                                The user has no permission to start UEFI device drivers on the device path
-                                associated with the ControllerHandle or specified by the RemainingDevicePath.
+  @return The status CoreConnectController() returns.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-CoreConnectController (
+CoreConnectControllerWorker (
   IN  EFI_HANDLE                ControllerHandle,
   IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
   IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
@@ -239,6 +231,51 @@ CoreConnectController (
   return ReturnStatus;
 }
 
+/**
+  Connects one or more drivers to a controller.
+
+  @param  ControllerHandle      The handle of the controller to which driver(s) are to be connected.
+  @param  DriverImageHandle     A pointer to an ordered list handles that support the
+                                EFI_DRIVER_BINDING_PROTOCOL.
+  @param  RemainingDevicePath   A pointer to the device path that specifies a child of the
+                                controller specified by ControllerHandle.
+  @param  Recursive             If TRUE, then ConnectController() is called recursively
+                                until the entire tree of controllers below the controller specified
+                                by ControllerHandle have been created. If FALSE, then
+                                the tree of controllers is only expanded one level.
+
+  @retval EFI_SUCCESS           1) One or more drivers were connected to ControllerHandle.
+                                2) No drivers were connected to ControllerHandle, but
+                                RemainingDevicePath is not NULL, and it is an End Device
+                                Path Node.
+  @retval EFI_INVALID_PARAMETER ControllerHandle is NULL.
+  @retval EFI_NOT_FOUND         1) There are no EFI_DRIVER_BINDING_PROTOCOL instances
+                                present in the system.
+                                2) No drivers were connected to ControllerHandle.
+  @retval EFI_SECURITY_VIOLATION
+                                The user has no permission to start UEFI device drivers on the device path
+                                associated with the ControllerHandle or specified by the RemainingDevicePath.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreConnectController (
+  IN  EFI_HANDLE                ControllerHandle,
+  IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+  IN  BOOLEAN                   Recursive
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ProfileToken;
+
+  ProfileToken = CoreCallProfileEnter (CallProfileConnectController, 0, NULL);
+  Status       = CoreConnectControllerWorker (ControllerHandle, DriverImageHandle, RemainingDevicePath, Recursive);
+  CoreCallProfileExit (ProfileToken, NULL);
+
+  return Status;
+}
+
 /**
   Add Driver Binding Protocols from Context Driver Image Handles to sorted
   Driver Binding Protocol list.
@@ -415,6 +452,7 @@ CoreConnectSingleController (
   UINTN                                      SortIndex;
   BOOLEAN                                    OneStarted;
   BOOLEAN                                    DriverFound;
+  UINTN                                      ProfileToken;
 
   //
   // Initialize local variables
@@ -635,11 +673,13 @@ CoreConnectSingleController (
       if (SortedDriverBindingProtocols[Index] != NULL) {
         DriverBinding = SortedDriverBindingProtocols[Index];
         PERF_DRIVER_BINDING_SUPPORT_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
-        Status = DriverBinding->Supported (
-                                  DriverBinding,
-                                  ControllerHandle,
-                                  RemainingDevicePath
-                                  );
+        ProfileToken = CoreCallProfileEnter (CallProfileSupported, (UINTN)DriverBinding, DriverBinding->ImageHandle);
+        Status       = DriverBinding->Supported (
+                                        DriverBinding,
+                                        ControllerHandle,
+                                        RemainingDevicePath
+                                        );
+        CoreCallProfileExit (ProfileToken, NULL);
         PERF_DRIVER_BINDING_SUPPORT_END (DriverBinding->DriverBindingHandle, ControllerHandle);
         if (!EFI_ERROR (Status)) {
           SortedDriverBindingProtocols[Index] = NULL;
@@ -650,11 +690,13 @@ CoreConnectSingleController (
           // on ControllerHandle.
           //
           PERF_DRIVER_BINDING_START_BEGIN (DriverBinding->DriverBindingHandle, ControllerHandle);
-          Status = DriverBinding->Start (
-                                    DriverBinding,
-                                    ControllerHandle,
-                                    RemainingDevicePath
-                                    );
+          ProfileToken = CoreCallProfileEnter (CallProfileStart, (UINTN)DriverBinding, DriverBinding->ImageHandle);
+          Status       = DriverBinding->Start (
+                                          DriverBinding,
+                                          ControllerHandle,
+                                          RemainingDevicePath
+                                          );
+          CoreCallProfileExit (ProfileToken, NULL);
           PERF_DRIVER_BINDING_START_END (DriverBinding->DriverBindingHandle, ControllerHandle);
 
           if (!EFI_ERROR (Status)) {
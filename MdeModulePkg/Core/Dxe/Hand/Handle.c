@@ -2,6 +2,7 @@
   UEFI handle & protocol handling.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -10,8 +11,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
-// gHandleList           - A list of all the handles in the system
+// mProtocolDatabase     - A list of all protocols in the system, also hashed in mProtocolHashTable
+// gHandleList           - A list of all the handles in the system, also hashed in mHandleHashTable
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
@@ -59,23 +60,17 @@ CoreValidateHandle (
   IN  EFI_HANDLE  UserHandle
   )
 {
-  IHANDLE     *Handle;
-  LIST_ENTRY  *Link;
-
   if (UserHandle == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
-  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
-    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
-    if (Handle == (IHANDLE *)UserHandle) {
-      return EFI_SUCCESS;
-    }
+  if (CoreHandleHashFind (UserHandle) == NULL) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  return EFI_INVALID_PARAMETER;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -94,8 +89,6 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY      *Link;
-  PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
@@ -103,22 +96,7 @@ CoreFindProtocolEntry (
   //
   // Search the database for the matching GUID
   //
-
-  ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
-    if (CompareGuid (&Item->ProtocolID, Protocol)) {
-      //
-      // This is the protocol entry
-      //
-
-      ProtEntry = Item;
-      break;
-    }
-  }
+  ProtEntry = CoreProtocolHashFind (Protocol);
 
   //
   // If the protocol entry was not found and Create is TRUE, then
@@ -140,6 +118,7 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      CoreProtocolHashInsert (ProtEntry);
     }
   }
 
@@ -409,6 +388,7 @@ CoreInstallProtocolInterfaceNotify (
     // in the system
     //
     InsertTailList (&gHandleList, &Handle->AllHandles);
+    CoreHandleHashInsert (Handle);
   } else {
     Status = CoreValidateHandle (Handle);
     if (EFI_ERROR (Status)) {
@@ -448,6 +428,11 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  //
+  // Have the dispatcher evaluate again the DEPEX pushing this protocol
+  //
+  CoreDepexProtocolInstalled (&ProtEntry->ProtocolID);
+
   //
   // Notify the notification list for this protocol
   //
@@ -771,6 +756,7 @@ CoreUninstallProtocolInterface (
   if (IsListEmpty (&Handle->Protocols)) {
     Handle->Signature = 0;
     RemoveEntryList (&Handle->AllHandles);
+    CoreHandleHashRemove (Handle);
     CoreFreePool (Handle);
   }
 
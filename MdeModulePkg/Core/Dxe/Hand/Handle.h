@@ -14,15 +14,17 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
-typedef struct {
-  UINTN         Signature;
+typedef struct _IHANDLE {
+  UINTN              Signature;
   /// All handles list of IHANDLE
-  LIST_ENTRY    AllHandles;
+  LIST_ENTRY         AllHandles;
   /// List of PROTOCOL_INTERFACE's for this handle
-  LIST_ENTRY    Protocols;
-  UINTN         LocateRequest;
+  LIST_ENTRY         Protocols;
+  UINTN              LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
-  UINT64        Key;
+  UINT64             Key;
+  /// Next handle in the same bucket of mHandleHashTable
+  struct _IHANDLE    *HashNext;
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -34,18 +36,26 @@ typedef struct {
 /// database.  Each handler that supports this protocol is listed, along
 /// with a list of registered notifies.
 ///
-typedef struct {
-  UINTN         Signature;
+typedef struct _PROTOCOL_ENTRY {
+  UINTN                     Signature;
   /// Link Entry inserted to mProtocolDatabase
-  LIST_ENTRY    AllEntries;
+  LIST_ENTRY                AllEntries;
   /// ID of the protocol
-  EFI_GUID      ProtocolID;
+  EFI_GUID                  ProtocolID;
   /// All protocol interfaces
-  LIST_ENTRY    Protocols;
+  LIST_ENTRY                Protocols;
   /// Registerd notification handlers
-  LIST_ENTRY    Notify;
+  LIST_ENTRY                Notify;
+  /// Next protocol entry in the same bucket of mProtocolHashTable
+  struct _PROTOCOL_ENTRY    *HashNext;
 } PROTOCOL_ENTRY;
 
+//
+// Number of buckets of the handle and protocol hash tables, as powers of 2.
+//
+#define HANDLE_HASH_BITS    10
+#define PROTOCOL_HASH_BITS  7
+
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
 
 ///
@@ -242,6 +252,71 @@ CoreValidateHandle (
   IN  EFI_HANDLE  UserHandle
   );
 
+/**
+  Add a handle to the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle, not yet in the table
+
+**/
+VOID
+CoreHandleHashInsert (
+  IN IHANDLE  *Handle
+  );
+
+/**
+  Remove a handle from the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle, in the table
+
+**/
+VOID
+CoreHandleHashRemove (
+  IN IHANDLE  *Handle
+  );
+
+/**
+  Find a handle in the handle hash table. UserHandle is only compared
+  with the handles in the table, never dereferenced, so it may be any value.
+  The gProtocolDatabaseLock must be owned
+
+  @param  UserHandle             The handle to look for
+
+  @return The handle, or NULL if UserHandle isn't a handle in the table
+
+**/
+IHANDLE *
+CoreHandleHashFind (
+  IN EFI_HANDLE  UserHandle
+  );
+
+/**
+  Add a protocol entry to the protocol hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  ProtEntry              The protocol entry, not yet in the table
+
+**/
+VOID
+CoreProtocolHashInsert (
+  IN PROTOCOL_ENTRY  *ProtEntry
+  );
+
+/**
+  Find the protocol entry of a protocol in the protocol hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The ID of the protocol
+
+  @return The protocol entry, or NULL if the protocol has none
+
+**/
+PROTOCOL_ENTRY *
+CoreProtocolHashFind (
+  IN CONST EFI_GUID  *Protocol
+  );
+
 //
 // Externs
 //
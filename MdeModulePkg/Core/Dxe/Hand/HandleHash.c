@@ -0,0 +1,190 @@
+/** @file
+  Hash tables of the handle and protocol databases.
+
+  Every handle on gHandleList is also linked in mHandleHashTable, hashed on
+  its address, and every protocol entry on mProtocolDatabase in
+  mProtocolHashTable, hashed on its GUID. The lists keep the creation order
+  for LocateHandle() and the protocol notifications; the tables make handle
+  validation and protocol lookup independent of the number of handles and
+  protocols in the system.
+
+  The buckets are singly linked and the tables need no initialization, so
+  they can be used by the first protocol installation of the DXE core.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Handle.h"
+
+//
+// Golden ratio multiplier of the hash functions.
+//
+#define HASH_MULTIPLIER  0x9E3779B1
+
+IHANDLE         *mHandleHashTable[1 << HANDLE_HASH_BITS];
+PROTOCOL_ENTRY  *mProtocolHashTable[1 << PROTOCOL_HASH_BITS];
+
+/**
+  Compute the bucket of a handle in mHandleHashTable.
+
+  @param  UserHandle             The handle
+
+  @return The bucket index
+
+**/
+STATIC
+UINTN
+CoreHandleHashBucket (
+  IN EFI_HANDLE  UserHandle
+  )
+{
+  UINT64  Address;
+  UINT32  Key;
+
+  //
+  // The handles are pool allocations, so the low 3 bits are always 0.
+  //
+  Address = (UINT64)(UINTN)UserHandle;
+  Key     = (UINT32)RShiftU64 (Address, 3) ^ (UINT32)RShiftU64 (Address, 32);
+  return (UINTN)((Key * HASH_MULTIPLIER) >> (32 - HANDLE_HASH_BITS));
+}
+
+/**
+  Compute the bucket of a protocol GUID in mProtocolHashTable.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The bucket index
+
+**/
+STATIC
+UINTN
+CoreProtocolHashBucket (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  CONST UINT32  *Data;
+  UINT32        Key;
+
+  Data = (CONST UINT32 *)Protocol;
+  Key  = ReadUnaligned32 (Data) ^ ReadUnaligned32 (Data + 1) ^
+         ReadUnaligned32 (Data + 2) ^ ReadUnaligned32 (Data + 3);
+  return (UINTN)((Key * HASH_MULTIPLIER) >> (32 - PROTOCOL_HASH_BITS));
+}
+
+/**
+  Add a handle to the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle, not yet in the table
+
+**/
+VOID
+CoreHandleHashInsert (
+  IN IHANDLE  *Handle
+  )
+{
+  UINTN  Bucket;
+
+  Bucket                   = CoreHandleHashBucket (Handle);
+  Handle->HashNext         = mHandleHashTable[Bucket];
+  mHandleHashTable[Bucket] = Handle;
+}
+
+/**
+  Remove a handle from the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle, in the table
+
+**/
+VOID
+CoreHandleHashRemove (
+  IN IHANDLE  *Handle
+  )
+{
+  IHANDLE  **Link;
+
+  for (Link = &mHandleHashTable[CoreHandleHashBucket (Handle)]; *Link != NULL; Link = &(*Link)->HashNext) {
+    if (*Link == Handle) {
+      *Link            = Handle->HashNext;
+      Handle->HashNext = NULL;
+      return;
+    }
+  }
+
+  ASSERT (FALSE);
+}
+
+/**
+  Find a handle in the handle hash table. UserHandle is only compared
+  with the handles in the table, never dereferenced, so it may be any value.
+  The gProtocolDatabaseLock must be owned
+
+  @param  UserHandle             The handle to look for
+
+  @return The handle, or NULL if UserHandle isn't a handle in the table
+
+**/
+IHANDLE *
+CoreHandleHashFind (
+  IN EFI_HANDLE  UserHandle
+  )
+{
+  IHANDLE  *Handle;
+
+  for (Handle = mHandleHashTable[CoreHandleHashBucket (UserHandle)]; Handle != NULL; Handle = Handle->HashNext) {
+    if (Handle == (IHANDLE *)UserHandle) {
+      return Handle;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Add a protocol entry to the protocol hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  ProtEntry              The protocol entry, not yet in the table
+
+**/
+VOID
+CoreProtocolHashInsert (
+  IN PROTOCOL_ENTRY  *ProtEntry
+  )
+{
+  UINTN  Bucket;
+
+  Bucket                     = CoreProtocolHashBucket (&ProtEntry->ProtocolID);
+  ProtEntry->HashNext        = mProtocolHashTable[Bucket];
+  mProtocolHashTable[Bucket] = ProtEntry;
+}
+
+/**
+  Find the protocol entry of a protocol in the protocol hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The ID of the protocol
+
+  @return The protocol entry, or NULL if the protocol has none
+
+**/
+PROTOCOL_ENTRY *
+CoreProtocolHashFind (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  PROTOCOL_ENTRY  *ProtEntry;
+
+  for (ProtEntry = mProtocolHashTable[CoreProtocolHashBucket (Protocol)]; ProtEntry != NULL; ProtEntry = ProtEntry->HashNext) {
+    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+      return ProtEntry;
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,480 @@
+/** @file
+  Unit tests and lookup benchmark for the handle and protocol hash tables of
+  the DXE core.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../../DxeMain.h"
+#include "../Handle.h"
+
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core Handle Database Hash Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_MAX_HANDLES    4096
+#define TEST_MAX_PROTOCOLS  512
+#define BENCHMARK_LOOKUPS   10000
+
+///
+/// Handle and protocol counts the lookup benchmark is run with.
+///
+STATIC CONST UINTN  mBenchmarkHandles[]   = { 16, 256, 1024, 4096 };
+STATIC CONST UINTN  mBenchmarkProtocols[] = { 16, 64, 256, 512 };
+
+extern IHANDLE         *mHandleHashTable[1 << HANDLE_HASH_BITS];
+extern PROTOCOL_ENTRY  *mProtocolHashTable[1 << PROTOCOL_HASH_BITS];
+
+STATIC IHANDLE         *mTestHandle[TEST_MAX_HANDLES];
+STATIC PROTOCOL_ENTRY  *mTestProtocol[TEST_MAX_PROTOCOLS];
+STATIC LIST_ENTRY      mTestHandleList    = INITIALIZE_LIST_HEAD_VARIABLE (mTestHandleList);
+STATIC LIST_ENTRY      mTestProtocolList  = INITIALIZE_LIST_HEAD_VARIABLE (mTestProtocolList);
+STATIC UINTN           mTestHandleCount   = 0;
+STATIC UINTN           mTestProtocolCount = 0;
+
+/**
+  Validate a handle the way CoreValidateHandle() did before the hash table,
+  walking the list of all the handles.
+
+  @param[in]  UserHandle   The handle to check.
+
+  @return The handle, or NULL if it isn't on the list.
+
+**/
+STATIC
+IHANDLE *
+TestLinearFindHandle (
+  IN EFI_HANDLE  UserHandle
+  )
+{
+  LIST_ENTRY  *Link;
+  IHANDLE     *Handle;
+
+  for (Link = mTestHandleList.BackLink; Link != &mTestHandleList; Link = Link->BackLink) {
+    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+    if (Handle == (IHANDLE *)UserHandle) {
+      return Handle;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find a protocol entry the way CoreFindProtocolEntry() did before the hash
+  table, walking the list of all the protocol entries.
+
+  @param[in]  Protocol     The ID of the protocol.
+
+  @return The protocol entry, or NULL if the protocol has none.
+
+**/
+STATIC
+PROTOCOL_ENTRY *
+TestLinearFindProtocol (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  LIST_ENTRY      *Link;
+  PROTOCOL_ENTRY  *ProtEntry;
+
+  for (Link = mTestProtocolList.ForwardLink; Link != &mTestProtocolList; Link = Link->ForwardLink) {
+    ProtEntry = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+      return ProtEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Create handles until there are Count, on the list and in the hash table.
+
+  @param[in]  Count        The number of handles.
+
+  @retval TRUE   The handles are created.
+  @retval FALSE  Out of memory.
+
+**/
+STATIC
+BOOLEAN
+TestCreateHandles (
+  IN UINTN  Count
+  )
+{
+  IHANDLE  *Handle;
+
+  while (mTestHandleCount < Count) {
+    Handle = AllocateZeroPool (sizeof (IHANDLE));
+    if (Handle == NULL) {
+      return FALSE;
+    }
+
+    Handle->Signature = EFI_HANDLE_SIGNATURE;
+    InitializeListHead (&Handle->Protocols);
+    InsertTailList (&mTestHandleList, &Handle->AllHandles);
+    CoreHandleHashInsert (Handle);
+    mTestHandle[mTestHandleCount++] = Handle;
+  }
+
+  return TRUE;
+}
+
+/**
+  Create protocol entries until there are Count, on the list and in the hash
+  table. The GUIDs differ in a few bits only, like the GUIDs generated one
+  after the other.
+
+  @param[in]  Count        The number of protocol entries.
+
+  @retval TRUE   The protocol entries are created.
+  @retval FALSE  Out of memory.
+
+**/
+STATIC
+BOOLEAN
+TestCreateProtocols (
+  IN UINTN  Count
+  )
+{
+  PROTOCOL_ENTRY  *ProtEntry;
+
+  while (mTestProtocolCount < Count) {
+    ProtEntry = AllocateZeroPool (sizeof (PROTOCOL_ENTRY));
+    if (ProtEntry == NULL) {
+      return FALSE;
+    }
+
+    ProtEntry->Signature            = PROTOCOL_ENTRY_SIGNATURE;
+    ProtEntry->ProtocolID.Data1     = 0x8d59d32b;
+    ProtEntry->ProtocolID.Data2     = 0xc655;
+    ProtEntry->ProtocolID.Data3     = 0x4ae9;
+    ProtEntry->ProtocolID.Data4[0]  = 0x9b;
+    ProtEntry->ProtocolID.Data4[6]  = (UINT8)(mTestProtocolCount >> 8);
+    ProtEntry->ProtocolID.Data4[7]  = (UINT8)mTestProtocolCount;
+    InitializeListHead (&ProtEntry->Protocols);
+    InitializeListHead (&ProtEntry->Notify);
+    InsertTailList (&mTestProtocolList, &ProtEntry->AllEntries);
+    CoreProtocolHashInsert (ProtEntry);
+    mTestProtocol[mTestProtocolCount++] = ProtEntry;
+  }
+
+  return TRUE;
+}
+
+/**
+  Free all the test handles and protocol entries, and empty the hash tables.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+FreeDatabase (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mTestHandleCount; Index++) {
+    RemoveEntryList (&mTestHandle[Index]->AllHandles);
+    FreePool (mTestHandle[Index]);
+  }
+
+  for (Index = 0; Index < mTestProtocolCount; Index++) {
+    RemoveEntryList (&mTestProtocol[Index]->AllEntries);
+    FreePool (mTestProtocol[Index]);
+  }
+
+  mTestHandleCount   = 0;
+  mTestProtocolCount = 0;
+  ZeroMem (mHandleHashTable, sizeof (mHandleHashTable));
+  ZeroMem (mProtocolHashTable, sizeof (mProtocolHashTable));
+}
+
+/**
+  Every handle is found, and the values that aren't handles aren't.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleFindTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_TRUE (TestCreateHandles (TEST_MAX_HANDLES));
+
+  for (Index = 0; Index < TEST_MAX_HANDLES; Index++) {
+    UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind (mTestHandle[Index]), (UINTN)mTestHandle[Index]);
+
+    //
+    // Pointers into a handle and just past it aren't handles.
+    //
+    UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind ((UINT8 *)mTestHandle[Index] + 8), 0);
+    UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind ((UINT8 *)mTestHandle[Index] + sizeof (IHANDLE)), 0);
+  }
+
+  UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind (NULL), 0);
+  UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind (&mTestHandleList), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A removed handle isn't found any more, and the other handles still are.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleRemoveTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_TRUE (TestCreateHandles (TEST_MAX_HANDLES));
+
+  //
+  // Remove every third handle, from the end, so that the handles are removed
+  // from the head, the middle and the tail of the buckets.
+  //
+  for (Index = TEST_MAX_HANDLES; Index-- > 0;) {
+    if (Index % 3 == 0) {
+      CoreHandleHashRemove (mTestHandle[Index]);
+    }
+  }
+
+  for (Index = 0; Index < TEST_MAX_HANDLES; Index++) {
+    if (Index % 3 == 0) {
+      UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind (mTestHandle[Index]), 0);
+      CoreHandleHashInsert (mTestHandle[Index]);
+    }
+
+    UT_ASSERT_EQUAL ((UINTN)CoreHandleHashFind (mTestHandle[Index]), (UINTN)mTestHandle[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every protocol entry is found by its GUID, and the GUIDs that have none
+  aren't.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ProtocolFindTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN     Index;
+  EFI_GUID  Guid;
+
+  UT_ASSERT_TRUE (TestCreateProtocols (TEST_MAX_PROTOCOLS));
+
+  for (Index = 0; Index < TEST_MAX_PROTOCOLS; Index++) {
+    //
+    // Look up with a copy, the GUIDs are compared by value.
+    //
+    CopyGuid (&Guid, &mTestProtocol[Index]->ProtocolID);
+    UT_ASSERT_EQUAL ((UINTN)CoreProtocolHashFind (&Guid), (UINTN)mTestProtocol[Index]);
+
+    Guid.Data1++;
+    UT_ASSERT_EQUAL ((UINTN)CoreProtocolHashFind (&Guid), 0);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare the lookups in the hash tables with the list walks they replace,
+  for growing numbers of handles and protocols. The times are logged.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The benchmark ran.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    A lookup failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkLookup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Count;
+  UINTN   Number;
+  UINTN   Lookups;
+  UINTN   Index;
+  UINTN   Found;
+  UINT64  Start;
+  UINT64  Hash;
+  UINT64  Linear;
+
+  Lookups = UnitTestBenchmarkIterations (BENCHMARK_LOOKUPS);
+
+  for (Count = 0; Count < ARRAY_SIZE (mBenchmarkHandles); Count++) {
+    Number = mBenchmarkHandles[Count];
+    UT_ASSERT_TRUE (TestCreateHandles (Number));
+
+    //
+    // Validate the handles in turn, like the handles of the controllers
+    // a driver binding Supported() is called for.
+    //
+    Found = 0;
+    Start = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found += (CoreHandleHashFind (mTestHandle[Index % Number]) != NULL);
+    }
+
+    Hash  = UnitTestBenchmarkElapsed (Start);
+    Start = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found -= (TestLinearFindHandle (mTestHandle[Index % Number]) != NULL);
+    }
+
+    Linear = UnitTestBenchmarkElapsed (Start);
+    UT_ASSERT_EQUAL (Found, 0);
+
+    UT_LOG_INFO (
+      "%5Lu handles: %Lu validations, hash %Lu us, list walk %Lu us\n",
+      (UINT64)Number,
+      (UINT64)Lookups,
+      Hash,
+      Linear
+      );
+  }
+
+  for (Count = 0; Count < ARRAY_SIZE (mBenchmarkProtocols); Count++) {
+    Number = mBenchmarkProtocols[Count];
+    UT_ASSERT_TRUE (TestCreateProtocols (Number));
+
+    Found = 0;
+    Start = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found += (CoreProtocolHashFind (&mTestProtocol[Index % Number]->ProtocolID) != NULL);
+    }
+
+    Hash  = UnitTestBenchmarkElapsed (Start);
+    Start = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found -= (TestLinearFindProtocol (&mTestProtocol[Index % Number]->ProtocolID) != NULL);
+    }
+
+    Linear = UnitTestBenchmarkElapsed (Start);
+    UT_ASSERT_EQUAL (Found, 0);
+
+    UT_LOG_INFO (
+      "%5Lu protocols: %Lu lookups, hash %Lu us, list walk %Lu us\n",
+      (UINT64)Number,
+      (UINT64)Lookups,
+      Hash,
+      Linear
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the handle
+  and protocol hash tables and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      HashTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&HashTests, Framework, "Handle Database Hash Tests", "DxeCore.HandleHash", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Handle Database Hash Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (HashTests, "Handles are validated by address", "HandleFind", HandleFindTest, NULL, FreeDatabase, NULL);
+  AddTestCase (HashTests, "Removed handles are no longer valid", "HandleRemove", HandleRemoveTest, NULL, FreeDatabase, NULL);
+  AddTestCase (HashTests, "Protocol entries are found by GUID", "ProtocolFind", ProtocolFindTest, NULL, FreeDatabase, NULL);
+  AddTestCase (HashTests, "Handle and protocol lookup benchmark", "Benchmark", BenchmarkLookup, NULL, FreeDatabase, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  argc  Number of arguments.
+  @param[in]  argv  Array of arguments.
+
+  @return 0 on success, 1 on failure.
+
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -2,6 +2,7 @@
   Core image handling services to load and unload PeImage.
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -583,6 +584,7 @@ CoreLoadPeImage (
   EFI_STATUS  Status;
   BOOLEAN     DstBufAlocated;
   UINTN       Size;
+  BOOLEAN     LogFixups;
 
   ZeroMem (&Image->ImageContext, sizeof (Image->ImageContext));
 
@@ -737,36 +739,47 @@ CoreLoadPeImage (
   }
 
   //
-  // Load the image from the file into the allocated memory
+  // A Runtime Driver keeps the log of its fixups, to be relocated again when
+  // SetVirtualAddressMap() is called. Any other image is relocated while its
+  // sections are loaded, rather than in another pass over the image.
   //
-  Status = PeCoffLoaderLoadImage (&Image->ImageContext);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
+  LogFixups = (BOOLEAN)(((Attribute & EFI_LOAD_PE_IMAGE_ATTRIBUTE_RUNTIME_REGISTRATION) != 0) &&
+                        (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER));
 
   //
-  // If this is a Runtime Driver, then allocate memory for the FixupData that
-  // is used to relocate the image when SetVirtualAddressMap() is called. The
-  // relocation is done by the Runtime AP.
+  // Load the image from the file into the allocated memory
   //
-  if ((Attribute & EFI_LOAD_PE_IMAGE_ATTRIBUTE_RUNTIME_REGISTRATION) != 0) {
-    if (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER) {
-      Image->ImageContext.FixupData = AllocateRuntimePool ((UINTN)(Image->ImageContext.FixupDataSize));
-      if (Image->ImageContext.FixupData == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Done;
-      }
-    }
+  if (LogFixups) {
+    Status = PeCoffLoaderLoadImage (&Image->ImageContext);
+  } else {
+    Status = PeCoffLoaderLoadAndRelocateImage (&Image->ImageContext);
   }
 
-  //
-  // Relocate the image in memory
-  //
-  Status = PeCoffLoaderRelocateImage (&Image->ImageContext);
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
+  if (LogFixups) {
+    //
+    // Allocate memory for the FixupData that is used to relocate the image
+    // when SetVirtualAddressMap() is called. The relocation is done by the
+    // Runtime AP.
+    //
+    Image->ImageContext.FixupData = AllocateRuntimePool ((UINTN)(Image->ImageContext.FixupDataSize));
+    if (Image->ImageContext.FixupData == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Done;
+    }
+
+    //
+    // Relocate the image in memory
+    //
+    Status = PeCoffLoaderRelocateImage (&Image->ImageContext);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+  }
+
   //
   // Flush the Instruction Cache
   //
@@ -1536,8 +1549,10 @@ CoreLoadImage (
 {
   EFI_STATUS  Status;
   EFI_HANDLE  Handle;
+  UINTN       ProfileToken;
 
   PERF_LOAD_IMAGE_BEGIN (NULL);
+  ProfileToken = CoreCallProfileEnter (CallProfileLoadImage, CoreCallProfileImageKey (FilePath, NULL), NULL);
 
   Status = CoreLoadImageCommon (
              BootPolicy,
@@ -1560,6 +1575,7 @@ CoreLoadImage (
     Handle = *ImageHandle;
   }
 
+  CoreCallProfileExit (ProfileToken, Handle);
   PERF_LOAD_IMAGE_END (Handle);
 
   return Status;
@@ -1598,6 +1614,7 @@ CoreStartImage (
   UINT64                     HandleDatabaseKey;
   UINTN                      SetJumpFlag;
   EFI_HANDLE                 Handle;
+  UINTN                      ProfileToken;
 
   Handle = ImageHandle;
 
@@ -1643,6 +1660,11 @@ CoreStartImage (
   }
 
   PERF_START_IMAGE_BEGIN (Handle);
+  ProfileToken = CoreCallProfileEnter (
+                   CallProfileStartImage,
+                   CoreCallProfileImageKey (Image->Info.FilePath, ImageHandle),
+                   ImageHandle
+                   );
 
   //
   // Push the current start image context, and
@@ -1665,6 +1687,7 @@ CoreStartImage (
     // Image may be unloaded after return with failure,
     // then ImageHandle may be invalid, so use NULL handle to record perf log.
     //
+    CoreCallProfileExit (ProfileToken, NULL);
     PERF_START_IMAGE_END (NULL);
 
     //
@@ -1781,8 +1804,9 @@ CoreStartImage (
   }
 
   //
-  // Done
+  // Done. The calls the image left with Exit() are returned from here too.
   //
+  CoreCallProfileExit (ProfileToken, NULL);
   PERF_START_IMAGE_END (Handle);
   return Status;
 }
@@ -41,6 +41,7 @@ typedef struct {
 
   UINT64             VirtualStart;
   UINT64             Attribute;
+  CORE_MAP_NODE      TreeNode;
 } MEMORY_MAP;
 
 //
@@ -166,7 +167,8 @@ CoreInternalAllocatePages (
 // Internal Global data
 //
 
-extern EFI_LOCK    gMemoryLock;
-extern LIST_ENTRY  gMemoryMap;
-extern LIST_ENTRY  mGcdMemorySpaceMap;
+extern EFI_LOCK       gMemoryLock;
+extern LIST_ENTRY     gMemoryMap;
+extern CORE_MAP_TREE  gMemoryMapTree;
+extern LIST_ENTRY     mGcdMemorySpaceMap;
 #endif
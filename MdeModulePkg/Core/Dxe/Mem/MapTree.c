@@ -0,0 +1,577 @@
+/** @file
+  Red-black trees indexing the memory map and the GCD maps by address.
+
+  The nodes are embedded in the map entries, so the trees never allocate
+  memory and can be updated under the memory and GCD locks, while the map
+  itself is being changed. A node refers to the start address of its entry
+  instead of holding a copy: the entries of a map never overlap, so moving
+  the bounds of an entry doesn't change the order of the tree.
+
+  Each node also has a weight, and the largest weight in its subtree. The
+  memory map weighs its free entries by their size, so that the free ranges
+  large enough for a request can be found without visiting the others.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+/**
+  Recompute the largest weight in the subtree of a node from its children.
+
+  @param  Node                   The node to update.
+
+**/
+STATIC
+VOID
+CoreMapTreeUpdateMax (
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  UINT64  MaxWeight;
+
+  MaxWeight = Node->Weight;
+  if ((Node->Left != NULL) && (Node->Left->MaxWeight > MaxWeight)) {
+    MaxWeight = Node->Left->MaxWeight;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxWeight > MaxWeight)) {
+    MaxWeight = Node->Right->MaxWeight;
+  }
+
+  Node->MaxWeight = MaxWeight;
+}
+
+/**
+  Recompute the largest subtree weights from a node up to the root.
+
+  @param  Node                   The lowest node whose subtree has changed,
+                                 or NULL.
+
+**/
+STATIC
+VOID
+CoreMapTreePropagate (
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  for ( ; Node != NULL; Node = Node->Parent) {
+    CoreMapTreeUpdateMax (Node);
+  }
+}
+
+/**
+  Put a node, or NULL, in the place of another in the tree.
+
+  @param  Tree                   The tree.
+  @param  Old                    The node to replace.
+  @param  New                    The replacing node, or NULL.
+
+**/
+STATIC
+VOID
+CoreMapTreeReplace (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Old,
+  IN CORE_MAP_NODE  *New OPTIONAL
+  )
+{
+  if (Old->Parent == NULL) {
+    Tree->Root = New;
+  } else if (Old == Old->Parent->Left) {
+    Old->Parent->Left = New;
+  } else {
+    Old->Parent->Right = New;
+  }
+
+  if (New != NULL) {
+    New->Parent = Old->Parent;
+  }
+}
+
+/**
+  Rotate the tree left around a node.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node to move down, which has a right child.
+
+**/
+STATIC
+VOID
+CoreMapTreeRotateLeft (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  CORE_MAP_NODE  *Child;
+
+  Child       = Node->Right;
+  Node->Right = Child->Left;
+  if (Child->Left != NULL) {
+    Child->Left->Parent = Node;
+  }
+
+  CoreMapTreeReplace (Tree, Node, Child);
+  Child->Left  = Node;
+  Node->Parent = Child;
+
+  CoreMapTreeUpdateMax (Node);
+  CoreMapTreeUpdateMax (Child);
+}
+
+/**
+  Rotate the tree right around a node.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node to move down, which has a left child.
+
+**/
+STATIC
+VOID
+CoreMapTreeRotateRight (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  CORE_MAP_NODE  *Child;
+
+  Child      = Node->Left;
+  Node->Left = Child->Right;
+  if (Child->Right != NULL) {
+    Child->Right->Parent = Node;
+  }
+
+  CoreMapTreeReplace (Tree, Node, Child);
+  Child->Right = Node;
+  Node->Parent = Child;
+
+  CoreMapTreeUpdateMax (Node);
+  CoreMapTreeUpdateMax (Child);
+}
+
+/**
+  Insert the node of a map entry in a tree.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node of the map entry.
+  @param  Start                  Points to the start address of the map entry.
+  @param  Weight                 The weight of the map entry.
+
+**/
+VOID
+CoreMapTreeInsert (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         *Start,
+  IN UINT64         Weight
+  )
+{
+  CORE_MAP_NODE  **Link;
+  CORE_MAP_NODE  *Parent;
+  CORE_MAP_NODE  *Grandparent;
+  CORE_MAP_NODE  *Uncle;
+
+  Node->Start     = Start;
+  Node->Weight    = Weight;
+  Node->MaxWeight = Weight;
+  Node->Left      = NULL;
+  Node->Right     = NULL;
+  Node->Red       = TRUE;
+
+  Parent = NULL;
+  Link   = &Tree->Root;
+  while (*Link != NULL) {
+    Parent = *Link;
+    ASSERT (*Start != *Parent->Start);
+    Link = (*Start < *Parent->Start) ? &Parent->Left : &Parent->Right;
+  }
+
+  Node->Parent = Parent;
+  *Link        = Node;
+  CoreMapTreePropagate (Parent);
+
+  //
+  // Restore the red-black properties
+  //
+  while (((Parent = Node->Parent) != NULL) && Parent->Red) {
+    Grandparent = Parent->Parent;
+    if (Parent == Grandparent->Left) {
+      Uncle = Grandparent->Right;
+      if ((Uncle != NULL) && Uncle->Red) {
+        Parent->Red      = FALSE;
+        Uncle->Red       = FALSE;
+        Grandparent->Red = TRUE;
+        Node             = Grandparent;
+        continue;
+      }
+
+      if (Node == Parent->Right) {
+        Node = Parent;
+        CoreMapTreeRotateLeft (Tree, Node);
+        Parent = Node->Parent;
+      }
+
+      Parent->Red      = FALSE;
+      Grandparent->Red = TRUE;
+      CoreMapTreeRotateRight (Tree, Grandparent);
+    } else {
+      Uncle = Grandparent->Left;
+      if ((Uncle != NULL) && Uncle->Red) {
+        Parent->Red      = FALSE;
+        Uncle->Red       = FALSE;
+        Grandparent->Red = TRUE;
+        Node             = Grandparent;
+        continue;
+      }
+
+      if (Node == Parent->Left) {
+        Node = Parent;
+        CoreMapTreeRotateRight (Tree, Node);
+        Parent = Node->Parent;
+      }
+
+      Parent->Red      = FALSE;
+      Grandparent->Red = TRUE;
+      CoreMapTreeRotateLeft (Tree, Grandparent);
+    }
+  }
+
+  Tree->Root->Red = FALSE;
+}
+
+/**
+  Remove the node of a map entry from a tree.
+
+  @param  Tree                   The tree.
+  @param  Node                   The node of the map entry.
+
+**/
+VOID
+CoreMapTreeDelete (
+  IN CORE_MAP_TREE  *Tree,
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  CORE_MAP_NODE  *Child;
+  CORE_MAP_NODE  *Parent;
+  CORE_MAP_NODE  *Successor;
+  CORE_MAP_NODE  *Sibling;
+  BOOLEAN        RemovedRed;
+
+  //
+  // Unlink the node, or its successor if it has two children. Child takes
+  // the place of the unlinked node and Parent is its new parent.
+  //
+  if (Node->Left == NULL) {
+    Child      = Node->Right;
+    Parent     = Node->Parent;
+    RemovedRed = Node->Red;
+    CoreMapTreeReplace (Tree, Node, Child);
+  } else if (Node->Right == NULL) {
+    Child      = Node->Left;
+    Parent     = Node->Parent;
+    RemovedRed = Node->Red;
+    CoreMapTreeReplace (Tree, Node, Child);
+  } else {
+    Successor = Node->Right;
+    while (Successor->Left != NULL) {
+      Successor = Successor->Left;
+    }
+
+    Child      = Successor->Right;
+    RemovedRed = Successor->Red;
+    if (Successor->Parent == Node) {
+      Parent = Successor;
+    } else {
+      Parent = Successor->Parent;
+      CoreMapTreeReplace (Tree, Successor, Child);
+      Successor->Right         = Node->Right;
+      Successor->Right->Parent = Successor;
+    }
+
+    CoreMapTreeReplace (Tree, Node, Successor);
+    Successor->Left         = Node->Left;
+    Successor->Left->Parent = Successor;
+    Successor->Red          = Node->Red;
+  }
+
+  CoreMapTreePropagate (Parent);
+
+  if (RemovedRed) {
+    return;
+  }
+
+  //
+  // Restore the red-black properties
+  //
+  while ((Child != Tree->Root) && ((Child == NULL) || !Child->Red)) {
+    if (Child == Parent->Left) {
+      Sibling = Parent->Right;
+      if (Sibling->Red) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        CoreMapTreeRotateLeft (Tree, Parent);
+        Sibling = Parent->Right;
+      }
+
+      if (((Sibling->Left == NULL) || !Sibling->Left->Red) &&
+          ((Sibling->Right == NULL) || !Sibling->Right->Red))
+      {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+        continue;
+      }
+
+      if ((Sibling->Right == NULL) || !Sibling->Right->Red) {
+        Sibling->Left->Red = FALSE;
+        Sibling->Red       = TRUE;
+        CoreMapTreeRotateRight (Tree, Sibling);
+        Sibling = Parent->Right;
+      }
+
+      Sibling->Red        = Parent->Red;
+      Parent->Red         = FALSE;
+      Sibling->Right->Red = FALSE;
+      CoreMapTreeRotateLeft (Tree, Parent);
+    } else {
+      Sibling = Parent->Left;
+      if (Sibling->Red) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        CoreMapTreeRotateRight (Tree, Parent);
+        Sibling = Parent->Left;
+      }
+
+      if (((Sibling->Left == NULL) || !Sibling->Left->Red) &&
+          ((Sibling->Right == NULL) || !Sibling->Right->Red))
+      {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+        continue;
+      }
+
+      if ((Sibling->Left == NULL) || !Sibling->Left->Red) {
+        Sibling->Right->Red = FALSE;
+        Sibling->Red        = TRUE;
+        CoreMapTreeRotateLeft (Tree, Sibling);
+        Sibling = Parent->Left;
+      }
+
+      Sibling->Red       = Parent->Red;
+      Parent->Red        = FALSE;
+      Sibling->Left->Red = FALSE;
+      CoreMapTreeRotateRight (Tree, Parent);
+    }
+
+    Child = Tree->Root;
+  }
+
+  if (Child != NULL) {
+    Child->Red = FALSE;
+  }
+}
+
+/**
+  Change the weight of the node of a map entry.
+
+  @param  Node                   The node of the map entry.
+  @param  Weight                 The new weight of the map entry.
+
+**/
+VOID
+CoreMapTreeSetWeight (
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         Weight
+  )
+{
+  Node->Weight = Weight;
+  CoreMapTreePropagate (Node);
+}
+
+/**
+  Find the map entry with the highest start address at or below an address.
+  In a map that covers the address, that's the entry holding it.
+
+  @param  Tree                   The tree.
+  @param  Address                The address.
+
+  @return The node of the map entry, or NULL if all the entries start above
+          the address.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeFind (
+  IN CORE_MAP_TREE  *Tree,
+  IN UINT64         Address
+  )
+{
+  CORE_MAP_NODE  *Node;
+  CORE_MAP_NODE  *Found;
+
+  Found = NULL;
+  Node  = Tree->Root;
+  while (Node != NULL) {
+    if (*Node->Start <= Address) {
+      Found = Node;
+      Node  = Node->Right;
+    } else {
+      Node = Node->Left;
+    }
+  }
+
+  return Found;
+}
+
+/**
+  Get the map entry with the lowest start address.
+
+  @param  Tree                   The tree.
+
+  @return The node of the map entry, or NULL if the tree is empty.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeFirst (
+  IN CORE_MAP_TREE  *Tree
+  )
+{
+  CORE_MAP_NODE  *Node;
+
+  Node = Tree->Root;
+  if (Node != NULL) {
+    while (Node->Left != NULL) {
+      Node = Node->Left;
+    }
+  }
+
+  return Node;
+}
+
+/**
+  Get the map entry following another one in address order.
+
+  @param  Node                   The node of the map entry.
+
+  @return The node of the next map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeNext (
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  if (Node->Right != NULL) {
+    Node = Node->Right;
+    while (Node->Left != NULL) {
+      Node = Node->Left;
+    }
+
+    return Node;
+  }
+
+  while ((Node->Parent != NULL) && (Node == Node->Parent->Right)) {
+    Node = Node->Parent;
+  }
+
+  return Node->Parent;
+}
+
+/**
+  Find the map entry with the highest start address and at least a weight
+  in a subtree.
+
+  @param  Node                   The root of the subtree, whose largest weight
+                                 is at least Weight.
+  @param  Weight                 The minimum weight.
+
+  @return The node of the map entry.
+
+**/
+STATIC
+CORE_MAP_NODE *
+CoreMapTreeLastFitIn (
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         Weight
+  )
+{
+  ASSERT (Node->MaxWeight >= Weight);
+
+  for ( ; ;) {
+    if ((Node->Right != NULL) && (Node->Right->MaxWeight >= Weight)) {
+      Node = Node->Right;
+    } else if (Node->Weight >= Weight) {
+      return Node;
+    } else {
+      Node = Node->Left;
+    }
+  }
+}
+
+/**
+  Find the map entry preceding another one in address order with at least a
+  weight. The entries with a smaller weight are skipped a subtree at a time.
+
+  @param  Node                   The node of the map entry.
+  @param  Weight                 The minimum weight.
+
+  @return The node of the map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreePrevFit (
+  IN CORE_MAP_NODE  *Node,
+  IN UINT64         Weight
+  )
+{
+  CORE_MAP_NODE  *Parent;
+
+  if ((Node->Left != NULL) && (Node->Left->MaxWeight >= Weight)) {
+    return CoreMapTreeLastFitIn (Node->Left, Weight);
+  }
+
+  for (Parent = Node->Parent; Parent != NULL; Node = Parent, Parent = Parent->Parent) {
+    if (Node == Parent->Right) {
+      if (Parent->Weight >= Weight) {
+        return Parent;
+      }
+
+      if ((Parent->Left != NULL) && (Parent->Left->MaxWeight >= Weight)) {
+        return CoreMapTreeLastFitIn (Parent->Left, Weight);
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find the map entry with the highest start address at or below an address
+  and at least a weight.
+
+  @param  Tree                   The tree.
+  @param  Address                The address.
+  @param  Weight                 The minimum weight.
+
+  @return The node of the map entry, or NULL if there is none.
+
+**/
+CORE_MAP_NODE *
+CoreMapTreeLastFit (
+  IN CORE_MAP_TREE  *Tree,
+  IN UINT64         Address,
+  IN UINT64         Weight
+  )
+{
+  CORE_MAP_NODE  *Node;
+
+  Node = CoreMapTreeFind (Tree, Address);
+  if ((Node == NULL) || (Node->Weight >= Weight)) {
+    return Node;
+  }
+
+  return CoreMapTreePrevFit (Node, Weight);
+}
@@ -17,3 +17,9 @@ EFI_LOCK  gMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 // MemoryMap - the current memory map
 //
 LIST_ENTRY  gMemoryMap = INITIALIZE_LIST_HEAD_VARIABLE (gMemoryMap);
+
+//
+// MemoryMapTree - the entries of the memory map indexed by address, weighed
+// by their size if they are free
+//
+CORE_MAP_TREE  gMemoryMapTree = { NULL };
@@ -2,6 +2,7 @@
   UEFI Memory page management functions.
 
 Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -31,6 +32,12 @@ UINTN  mMemoryMapKey = 0;
 
 #define MAX_MAP_DEPTH  6
 
+//
+// The weight of a memory map entry in gMemoryMapTree: its size if it's free
+//
+#define MEMORY_MAP_WEIGHT(Entry) \
+  (((Entry)->Type == EfiConventionalMemory) ? (Entry)->End - (Entry)->Start + 1 : 0)
+
 ///
 /// mMapDepth - depth of new descriptor stack
 ///
@@ -130,6 +137,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
+  CoreMapTreeDelete (&gMemoryMapTree, &Entry->TreeNode);
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -161,8 +169,8 @@ CoreAddRange (
   IN UINT64                Attribute
   )
 {
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
+  CORE_MAP_NODE  *Node;
+  MEMORY_MAP     *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
   ASSERT (End > Start);
@@ -210,25 +218,25 @@ CoreAddRange (
   // and the same Attribute
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
-
-    if (Entry->Type != Type) {
-      continue;
-    }
-
-    if (Entry->Attribute != Attribute) {
-      continue;
+  if (Start != 0) {
+    Node = CoreMapTreeFind (&gMemoryMapTree, Start - 1);
+    if (Node != NULL) {
+      Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+      if ((Entry->End + 1 == Start) && (Entry->Type == Type) && (Entry->Attribute == Attribute)) {
+        Start = Entry->Start;
+        RemoveMemoryMapEntry (Entry);
+      }
     }
+  }
 
-    if (Entry->End + 1 == Start) {
-      Start = Entry->Start;
-      RemoveMemoryMapEntry (Entry);
-    } else if (Entry->Start == End + 1) {
-      End = Entry->End;
-      RemoveMemoryMapEntry (Entry);
+  if (End != MAX_UINT64) {
+    Node = CoreMapTreeFind (&gMemoryMapTree, End + 1);
+    if (Node != NULL) {
+      Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+      if ((Entry->Start == End + 1) && (Entry->Type == Type) && (Entry->Attribute == Attribute)) {
+        End = Entry->End;
+        RemoveMemoryMapEntry (Entry);
+      }
     }
   }
 
@@ -244,6 +252,12 @@ CoreAddRange (
   mMapStack[mMapDepth].VirtualStart = 0;
   mMapStack[mMapDepth].Attribute    = Attribute;
   InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  CoreMapTreeInsert (
+    &gMemoryMapTree,
+    &mMapStack[mMapDepth].TreeNode,
+    &mMapStack[mMapDepth].Start,
+    MEMORY_MAP_WEIGHT (&mMapStack[mMapDepth])
+    );
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -315,9 +329,10 @@ CoreFreeMemoryMapStack (
   VOID
   )
 {
-  MEMORY_MAP  *Entry;
-  MEMORY_MAP  *Entry2;
-  LIST_ENTRY  *Link2;
+  MEMORY_MAP     *Entry;
+  MEMORY_MAP     *Entry2;
+  LIST_ENTRY     *Link2;
+  CORE_MAP_NODE  *Node;
 
   ASSERT_LOCKED (&gMemoryLock);
 
@@ -350,18 +365,23 @@ CoreFreeMemoryMapStack (
       //
       // Move this entry to general memory
       //
+      CoreMapTreeDelete (&gMemoryMapTree, &mMapStack[mMapDepth].TreeNode);
       RemoveEntryList (&mMapStack[mMapDepth].Link);
       mMapStack[mMapDepth].Link.ForwardLink = NULL;
 
       CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
+      CoreMapTreeInsert (&gMemoryMapTree, &Entry->TreeNode, &Entry->Start, MEMORY_MAP_WEIGHT (Entry));
 
       //
-      // Find insertion location
+      // Find insertion location: the entries from pages are kept in address
+      // order in the list, so it's before the next one in the tree
       //
-      for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
-        Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-        if (Entry2->FromPages && (Entry2->Start > Entry->Start)) {
+      Link2 = &gMemoryMap;
+      for (Node = CoreMapTreeNext (&Entry->TreeNode); Node != NULL; Node = CoreMapTreeNext (Node)) {
+        Entry2 = BASE_CR (Node, MEMORY_MAP, TreeNode);
+        if (Entry2->FromPages) {
+          Link2 = &Entry2->Link;
           break;
         }
       }
@@ -740,7 +760,7 @@ CoreConvertPagesEx (
   UINT64           RangeEnd;
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
-  LIST_ENTRY       *Link;
+  CORE_MAP_NODE    *Node;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -765,15 +785,12 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if ((Entry->Start <= Start) && (Entry->End > Start)) {
-        break;
-      }
+    Node = CoreMapTreeFind (&gMemoryMapTree, Start);
+    if (Node != NULL) {
+      Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
     }
 
-    if (Link == &gMemoryMap) {
+    if ((Node == NULL) || (Entry->End <= Start)) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -885,14 +902,18 @@ CoreConvertPagesEx (
 
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      CoreMapTreeSetWeight (&Entry->TreeNode, MEMORY_MAP_WEIGHT (Entry));
 
       Entry = &mMapStack[mMapDepth];
       InsertTailList (&gMemoryMap, &Entry->Link);
+      CoreMapTreeInsert (&gMemoryMapTree, &Entry->TreeNode, &Entry->Start, MEMORY_MAP_WEIGHT (Entry));
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
     }
 
+    CoreMapTreeSetWeight (&Entry->TreeNode, MEMORY_MAP_WEIGHT (Entry));
+
     //
     // The new range inherits the same Attribute as the Entry
     // it is being cut out of unless attributes are being changed
@@ -1034,13 +1055,13 @@ CoreFindFreePagesI (
   IN BOOLEAN          NeedGuard
   )
 {
-  UINT64      NumberOfBytes;
-  UINT64      Target;
-  UINT64      DescStart;
-  UINT64      DescEnd;
-  UINT64      DescNumberOfBytes;
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
+  UINT64         NumberOfBytes;
+  UINT64         Target;
+  UINT64         DescStart;
+  UINT64         DescEnd;
+  UINT64         DescNumberOfBytes;
+  CORE_MAP_NODE  *Node;
+  MEMORY_MAP     *Entry;
 
   if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
     return 0;
@@ -1070,24 +1091,25 @@ CoreFindFreePagesI (
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target        = 0;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
+  //
+  // Walk down the free entries large enough for the request, from the one
+  // below MaxAddress. The first one that fits holds the highest range.
+  //
+  for (Node = CoreMapTreeLastFit (&gMemoryMapTree, MaxAddress - 1, NumberOfBytes);
+       Node != NULL;
+       Node = CoreMapTreePrevFit (Node, NumberOfBytes))
+  {
+    Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+    ASSERT (Entry->Type == EfiConventionalMemory);
 
     DescStart = Entry->Start;
     DescEnd   = Entry->End;
 
     //
-    // If desc is past max allowed address or below min allowed address, skip it
+    // If desc is below min allowed address, so are all the next ones
     //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
+    if (DescEnd < MinAddress) {
+      break;
     }
 
     //
@@ -1118,23 +1140,19 @@ CoreFindFreePagesI (
         continue;
       }
 
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
+      if (NeedGuard) {
+        DescEnd = AdjustMemoryS (
+                    DescEnd + 1 - DescNumberOfBytes,
+                    DescNumberOfBytes,
+                    NumberOfBytes
+                    );
+        if (DescEnd == 0) {
+          continue;
         }
-
-        Target = DescEnd;
       }
+
+      Target = DescEnd;
+      break;
     }
   }
 
@@ -1527,11 +1545,11 @@ CoreInternalFreePages (
   OUT EFI_MEMORY_TYPE      *MemoryType OPTIONAL
   )
 {
-  EFI_STATUS  Status;
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
-  UINTN       Alignment;
-  BOOLEAN     IsGuarded;
+  EFI_STATUS     Status;
+  CORE_MAP_NODE  *Node;
+  MEMORY_MAP     *Entry;
+  UINTN          Alignment;
+  BOOLEAN        IsGuarded;
 
   //
   // Free the range
@@ -1543,14 +1561,12 @@ CoreInternalFreePages (
   //
   IsGuarded = FALSE;
   Entry     = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if ((Entry->Start <= Memory) && (Entry->End > Memory)) {
-      break;
-    }
+  Node      = CoreMapTreeFind (&gMemoryMapTree, Memory);
+  if (Node != NULL) {
+    Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
   }
 
-  if (Link == &gMemoryMap) {
+  if ((Entry == NULL) || (Entry->End <= Memory)) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
@@ -1765,12 +1781,14 @@ CoreGetMemoryMap (
   UINTN                  BufferSize;
   UINTN                  NumberOfEntries;
   LIST_ENTRY             *Link;
+  CORE_MAP_NODE          *Node;
   MEMORY_MAP             *Entry;
   EFI_GCD_MAP_ENTRY      *GcdMapEntry;
   EFI_GCD_MAP_ENTRY      MergeGcdMapEntry;
   EFI_MEMORY_TYPE        Type;
   EFI_MEMORY_DESCRIPTOR  *MemoryMapStart;
   EFI_MEMORY_DESCRIPTOR  *MemoryMapEnd;
+  EFI_MEMORY_DESCRIPTOR  *PreviousMemoryMap;
 
   //
   // Make sure the parameters are valid
@@ -1835,12 +1853,15 @@ CoreGetMemoryMap (
   }
 
   //
-  // Build the map
+  // Build the map. The entries are taken in address order, so a descriptor
+  // can only be merged with the one before it.
   //
   ZeroMem (MemoryMap, BufferSize);
-  MemoryMapStart = MemoryMap;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+  MemoryMapStart    = MemoryMap;
+  PreviousMemoryMap = MemoryMap;
+  for (Node = CoreMapTreeFirst (&gMemoryMapTree); Node != NULL; Node = CoreMapTreeNext (Node)) {
+    Entry = BASE_CR (Node, MEMORY_MAP, TreeNode);
+    ASSERT (Entry->Signature == MEMORY_MAP_SIGNATURE);
     ASSERT (Entry->VirtualStart == 0);
 
     //
@@ -1877,10 +1898,13 @@ CoreGetMemoryMap (
     }
 
     //
-    // Check to see if the new Memory Map Descriptor can be merged with an
-    // existing descriptor if they are adjacent and have the same attributes
+    // Check to see if the new Memory Map Descriptor can be merged with the
+    // previous descriptor if they are adjacent and have the same attributes
     //
-    MemoryMap = MergeMemoryMapDescriptor (MemoryMapStart, MemoryMap, Size);
+    if (MergeMemoryMapDescriptor (PreviousMemoryMap, MemoryMap, Size) != MemoryMap) {
+      PreviousMemoryMap = MemoryMap;
+      MemoryMap         = NEXT_MEMORY_DESCRIPTOR (MemoryMap, Size);
+    }
   }
 
   ZeroMem (&MergeGcdMapEntry, sizeof (MergeGcdMapEntry));
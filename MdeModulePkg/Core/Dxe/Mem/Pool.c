@@ -2,6 +2,7 @@
   UEFI Memory pool management functions.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -59,6 +60,97 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Small allocations are served from slabs: pool pages carved into objects of
+// one size class, each with a POOL_SLAB_HEAD in front of it and no tail. The
+// size classes are POOL_SLAB_CLASS_SIZE bytes apart, so the class of a size is
+// found with a shift.
+//
+// CoreFreePoolI() tells a slab object from a POOL_HEAD allocation by the UINT32
+// just before the buffer. In a POOL_HEAD, that's the low half of Size, always
+// a multiple of 8, or the Type, never an invalid memory type. The slab
+// signatures have an odd first byte and aren't valid memory types either.
+//
+#define POOL_SLAB_HEAD_SIGNATURE  SIGNATURE_32('s','l','b','0')
+#define POOL_SLAB_FREE_SIGNATURE  SIGNATURE_32('s','l','b','f')
+typedef struct {
+  UINT32    Signature;
+  UINT8     Class;
+  UINT8     Type;
+  UINT16    Reserved;
+} POOL_SLAB_HEAD;
+
+typedef struct _POOL_SLAB_FREE {
+  POOL_SLAB_HEAD            Head;
+  struct _POOL_SLAB_FREE    *Next;
+} POOL_SLAB_FREE;
+
+#define POOL_SLAB_SIGNATURE  SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32            Signature;
+  UINT32            InUse;
+  POOL_SLAB_FREE    *FreeList;
+  LIST_ENTRY        Link;
+} POOL_SLAB;
+
+#define SIZE_OF_POOL_SLAB  ALIGN_VALUE (sizeof (POOL_SLAB), 8)
+
+#define POOL_SLAB_CLASS_SHIFT    4
+#define POOL_SLAB_CLASS_SIZE     (1 << POOL_SLAB_CLASS_SHIFT)
+#define POOL_SLAB_CLASSES        8
+#define POOL_SLAB_MAX_SIZE       (POOL_SLAB_CLASSES * POOL_SLAB_CLASS_SIZE)
+#define POOL_SLAB_MAGAZINE_SIZE  16
+
+#define SIZE_TO_SLAB_CLASS(a)   (((a) == 0) ? 0 : ((a) - 1) >> POOL_SLAB_CLASS_SHIFT)
+#define SLAB_CLASS_TO_SIZE(a)   (((a) + 1) << POOL_SLAB_CLASS_SHIFT)
+#define SLAB_CLASS_TO_SLOT(a)   (sizeof (POOL_SLAB_HEAD) + SLAB_CLASS_TO_SIZE (a))
+#define SLAB_CLASS_TO_COUNT(a)  ((EFI_PAGE_SIZE - SIZE_OF_POOL_SLAB) / SLAB_CLASS_TO_SLOT (a))
+
+//
+// The slabs of one size class of a memory type. The objects freed last are
+// kept in the magazine and handed out first, without touching their slab.
+//
+typedef struct {
+  LIST_ENTRY        Partial;
+  POOL_SLAB_FREE    *Magazine;
+  UINTN             MagazineCount;
+  UINTN             InUse;
+  UINTN             Allocations;
+} POOL_SLAB_CLASS_CACHE;
+
+typedef struct {
+  UINTN                    Pages;
+  UINTN                    PeakPages;
+  POOL_SLAB_CLASS_CACHE    Class[POOL_SLAB_CLASSES];
+} POOL_SLAB_CACHE;
+
+//
+// The slab cache of a memory type is allocated from the pool itself, which
+// must not need a slab.
+//
+STATIC_ASSERT (
+  sizeof (POOL_SLAB_CACHE) > POOL_SLAB_MAX_SIZE,
+  "The slab cache must be allocated from the pool lists"
+  );
+
+//
+// Slab pages are allocated and freed with the pool lock held, but
+// CoreUpdateProfile() allocates its records from the pool. The slab page
+// actions are queued here and recorded in the memory profile by
+// CoreAllocatePool() and CoreFreePool() once the lock is released.
+//
+typedef struct {
+  MEMORY_PROFILE_ACTION    Action;
+  EFI_MEMORY_TYPE          MemoryType;
+  VOID                     *Page;
+} POOL_SLAB_PROFILE_RECORD;
+
+#define POOL_SLAB_PROFILE_RECORDS  64
+
+STATIC POOL_SLAB_PROFILE_RECORD  mPoolSlabProfile[POOL_SLAB_PROFILE_RECORDS];
+STATIC UINTN                     mPoolSlabProfileFirst;
+STATIC UINTN                     mPoolSlabProfileCount;
+
 //
 // Globals
 //
@@ -70,6 +162,7 @@ typedef struct {
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
   LIST_ENTRY         Link;
+  POOL_SLAB_CACHE    *Slab;
 } POOL;
 
 //
@@ -123,6 +216,7 @@ CoreInitializePool (
     mPoolHead[Type].Signature  = 0;
     mPoolHead[Type].Used       = 0;
     mPoolHead[Type].MemoryType = (EFI_MEMORY_TYPE)Type;
+    mPoolHead[Type].Slab       = NULL;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
@@ -171,6 +265,7 @@ LookupPoolHead (
     Pool->Signature  = POOL_SIGNATURE;
     Pool->Used       = 0;
     Pool->MemoryType = MemoryType;
+    Pool->Slab       = NULL;
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
     }
@@ -183,6 +278,87 @@ LookupPoolHead (
   return NULL;
 }
 
+/**
+  Internal function.  Queue a slab page action for the memory profile.
+  Caller must have the memory lock held
+
+  @param  Action                 MemoryProfileActionAllocatePages or
+                                 MemoryProfileActionFreePages
+  @param  MemoryType             The memory type of the slab page
+  @param  Page                   The slab page
+
+**/
+STATIC
+VOID
+CoreQueuePoolSlabProfile (
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN VOID                   *Page
+  )
+{
+  POOL_SLAB_PROFILE_RECORD  *Record;
+
+  ASSERT_LOCKED (&mPoolMemoryLock);
+
+  if ((PcdGet8 (PcdMemoryProfilePropertyMask) & BIT0) == 0) {
+    return;
+  }
+
+  if (mPoolSlabProfileCount == POOL_SLAB_PROFILE_RECORDS) {
+    DEBUG ((DEBUG_WARN, "Memory profile: slab page %p not recorded\n", Page));
+    return;
+  }
+
+  Record             = &mPoolSlabProfile[(mPoolSlabProfileFirst + mPoolSlabProfileCount) % POOL_SLAB_PROFILE_RECORDS];
+  Record->Action     = Action;
+  Record->MemoryType = MemoryType;
+  Record->Page       = Page;
+  mPoolSlabProfileCount++;
+}
+
+/**
+  Internal function.  Record the queued slab page actions in the memory
+  profile, in the order they happened. The slab pages are accounted to the
+  DXE core.
+
+**/
+STATIC
+VOID
+CoreUpdatePoolSlabProfile (
+  VOID
+  )
+{
+  POOL_SLAB_PROFILE_RECORD  Record;
+
+  while (mPoolSlabProfileCount != 0) {
+    if (EFI_ERROR (CoreAcquireLockOrFail (&mPoolMemoryLock))) {
+      return;
+    }
+
+    if (mPoolSlabProfileCount == 0) {
+      CoreReleaseLock (&mPoolMemoryLock);
+      return;
+    }
+
+    Record                = mPoolSlabProfile[mPoolSlabProfileFirst];
+    mPoolSlabProfileFirst = (mPoolSlabProfileFirst + 1) % POOL_SLAB_PROFILE_RECORDS;
+    mPoolSlabProfileCount--;
+    CoreReleaseLock (&mPoolMemoryLock);
+
+    //
+    // This may allocate or free more slab pages, which are queued again.
+    //
+    CoreUpdateProfile (
+      (EFI_PHYSICAL_ADDRESS)(UINTN)CoreUpdatePoolSlabProfile,
+      Record.Action,
+      Record.MemoryType,
+      EFI_PAGE_SIZE,
+      Record.Page,
+      NULL
+      );
+  }
+}
+
 /**
   Allocate pool of a particular type.
 
@@ -273,6 +449,7 @@ CoreAllocatePool (
   EFI_STATUS  Status;
 
   Status = CoreInternalAllocatePool (PoolType, Size, Buffer);
+  CoreUpdatePoolSlabProfile ();
   if (!EFI_ERROR (Status)) {
     CoreUpdateProfile (
       (EFI_PHYSICAL_ADDRESS)(UINTN)RETURN_ADDRESS (0),
@@ -336,6 +513,106 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Allocates a small pool entry from the slabs of a
+  memory type.
+
+  @param  Pool                   The pool head of the memory type
+  @param  Size                   The amount of pool to allocate, at most
+                                 POOL_SLAB_MAX_SIZE
+
+  @return The allocated pool, or NULL
+
+**/
+STATIC
+VOID *
+CoreAllocatePoolSlab (
+  IN POOL   *Pool,
+  IN UINTN  Size
+  )
+{
+  POOL_SLAB_CACHE        *Cache;
+  POOL_SLAB_CLASS_CACHE  *ClassCache;
+  POOL_SLAB              *Slab;
+  POOL_SLAB_FREE         *Free;
+  CHAR8                  *NewPage;
+  UINTN                  Class;
+  UINTN                  Index;
+
+  if (Pool->Slab == NULL) {
+    Cache = CoreAllocatePoolI (EfiBootServicesData, sizeof (POOL_SLAB_CACHE), FALSE);
+    if (Cache == NULL) {
+      return NULL;
+    }
+
+    ZeroMem (Cache, sizeof (POOL_SLAB_CACHE));
+    for (Class = 0; Class < POOL_SLAB_CLASSES; Class++) {
+      InitializeListHead (&Cache->Class[Class].Partial);
+    }
+
+    Pool->Slab = Cache;
+  }
+
+  Cache      = Pool->Slab;
+  Class      = SIZE_TO_SLAB_CLASS (Size);
+  ClassCache = &Cache->Class[Class];
+
+  if (ClassCache->Magazine != NULL) {
+    Free                 = ClassCache->Magazine;
+    ClassCache->Magazine = Free->Next;
+    ClassCache->MagazineCount--;
+  } else {
+    //
+    // If no slab of the class has a free object, carve up a new page
+    //
+    if (IsListEmpty (&ClassCache->Partial)) {
+      NewPage = CoreAllocatePoolPagesI (Pool->MemoryType, 1, EFI_PAGE_SIZE, FALSE);
+      if (NewPage == NULL) {
+        return NULL;
+      }
+
+      CoreQueuePoolSlabProfile (MemoryProfileActionAllocatePages, Pool->MemoryType, NewPage);
+
+      Slab            = (POOL_SLAB *)NewPage;
+      Slab->Signature = POOL_SLAB_SIGNATURE;
+      Slab->InUse     = 0;
+      Slab->FreeList  = NULL;
+      for (Index = SLAB_CLASS_TO_COUNT (Class); Index > 0; Index--) {
+        Free                 = (POOL_SLAB_FREE *)&NewPage[SIZE_OF_POOL_SLAB + (Index - 1) * SLAB_CLASS_TO_SLOT (Class)];
+        Free->Head.Signature = POOL_SLAB_FREE_SIGNATURE;
+        Free->Head.Class     = (UINT8)Class;
+        Free->Head.Type      = (UINT8)Pool->MemoryType;
+        Free->Head.Reserved  = 0;
+        Free->Next           = Slab->FreeList;
+        Slab->FreeList       = Free;
+      }
+
+      InsertHeadList (&ClassCache->Partial, &Slab->Link);
+      Cache->Pages++;
+      Cache->PeakPages = MAX (Cache->PeakPages, Cache->Pages);
+    }
+
+    Slab           = CR (ClassCache->Partial.ForwardLink, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+    Free           = Slab->FreeList;
+    Slab->FreeList = Free->Next;
+    Slab->InUse++;
+
+    //
+    // Full slabs are on no list until one of their objects is freed
+    //
+    if (Slab->FreeList == NULL) {
+      RemoveEntryList (&Slab->Link);
+    }
+  }
+
+  ASSERT (Free->Head.Signature == POOL_SLAB_FREE_SIGNATURE);
+  Free->Head.Signature = POOL_SLAB_HEAD_SIGNATURE;
+  ClassCache->InUse++;
+  ClassCache->Allocations++;
+
+  return &Free->Head + 1;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -388,6 +665,27 @@ CoreAllocatePoolI (
                   ((PcdGet8 (PcdHeapGuardPropertyMask) & BIT7) == 0));
   PageAsPool = (IsHeapGuardEnabled (GUARD_HEAP_TYPE_FREED) && !mOnGuarding);
 
+  //
+  // Serve small requests from the slabs, unless the pool is guarded
+  //
+  if ((Size <= POOL_SLAB_MAX_SIZE) && !NeedGuard && !PageAsPool &&
+      ((UINT32)PoolType < EfiMaxMemoryType) && (Granularity == EFI_PAGE_SIZE))
+  {
+    Buffer = CoreAllocatePoolSlab (&mPoolHead[PoolType], Size);
+    if (Buffer != NULL) {
+      DEBUG_CLEAR_MEMORY (Buffer, Size);
+
+      DEBUG ((
+        DEBUG_POOL,
+        "AllocatePoolI: Type %x, Addr %p (len %lx) from slab\n",
+        PoolType,
+        Buffer,
+        (UINT64)Size
+        ));
+      return Buffer;
+    }
+  }
+
   //
   // Adjusting the Size to be of proper alignment so that
   // we don't get an unaligned access fault later when
@@ -585,6 +883,7 @@ CoreFreePool (
   EFI_MEMORY_TYPE  PoolType;
 
   Status = CoreInternalFreePool (Buffer, &PoolType);
+  CoreUpdatePoolSlabProfile ();
   if (!EFI_ERROR (Status)) {
     CoreUpdateProfile (
       (EFI_PHYSICAL_ADDRESS)(UINTN)RETURN_ADDRESS (0),
@@ -665,6 +964,93 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Returns a free object to its slab, and frees the page of
+  the slab once all its objects are free.
+
+  @param  Pool                   The pool head of the memory type
+  @param  ClassCache             The slab cache of the size class of the object
+  @param  Free                   The free object
+
+**/
+STATIC
+VOID
+CoreReleasePoolSlabObject (
+  IN POOL                   *Pool,
+  IN POOL_SLAB_CLASS_CACHE  *ClassCache,
+  IN POOL_SLAB_FREE         *Free
+  )
+{
+  POOL_SLAB  *Slab;
+
+  Slab = (POOL_SLAB *)((UINTN)Free & ~(UINTN)EFI_PAGE_MASK);
+  ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+
+  if (Slab->FreeList == NULL) {
+    InsertHeadList (&ClassCache->Partial, &Slab->Link);
+  }
+
+  Free->Next     = Slab->FreeList;
+  Slab->FreeList = Free;
+  Slab->InUse--;
+
+  if (Slab->InUse == 0) {
+    RemoveEntryList (&Slab->Link);
+    Slab->Signature = 0;
+    Pool->Slab->Pages--;
+    CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS)(UINTN)Slab, 1);
+    CoreQueuePoolSlabProfile (MemoryProfileActionFreePages, Pool->MemoryType, Slab);
+  }
+}
+
+/**
+  Internal function.  Frees a small pool entry allocated from the slabs of a
+  memory type.
+
+  The entry is kept in the magazine of its size class if there's room, or
+  returned to its slab. The magazine is emptied when the last object of the
+  size class is freed, so that it doesn't hold on to the slab pages.
+
+  @param  Pool                   The pool head of the memory type
+  @param  Head                   The slab head of the pool entry
+
+**/
+STATIC
+VOID
+CoreFreePoolSlab (
+  IN POOL            *Pool,
+  IN POOL_SLAB_HEAD  *Head
+  )
+{
+  POOL_SLAB_CLASS_CACHE  *ClassCache;
+  POOL_SLAB_FREE         *Free;
+
+  ClassCache = &Pool->Slab->Class[Head->Class];
+  ClassCache->InUse--;
+
+  Free                 = (POOL_SLAB_FREE *)Head;
+  Free->Head.Signature = POOL_SLAB_FREE_SIGNATURE;
+
+  if ((ClassCache->InUse != 0) && (ClassCache->MagazineCount < POOL_SLAB_MAGAZINE_SIZE)) {
+    Free->Next           = ClassCache->Magazine;
+    ClassCache->Magazine = Free;
+    ClassCache->MagazineCount++;
+    return;
+  }
+
+  CoreReleasePoolSlabObject (Pool, ClassCache, Free);
+
+  if (ClassCache->InUse == 0) {
+    while (ClassCache->Magazine != NULL) {
+      Free                 = ClassCache->Magazine;
+      ClassCache->Magazine = Free->Next;
+      CoreReleasePoolSlabObject (Pool, ClassCache, Free);
+    }
+
+    ClassCache->MagazineCount = 0;
+  }
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -682,22 +1068,55 @@ CoreFreePoolI (
   OUT EFI_MEMORY_TYPE  *PoolType OPTIONAL
   )
 {
-  POOL       *Pool;
-  POOL_HEAD  *Head;
-  POOL_TAIL  *Tail;
-  POOL_FREE  *Free;
-  UINTN      Index;
-  UINTN      NoPages;
-  UINTN      Size;
-  CHAR8      *NewPage;
-  UINTN      Offset;
-  BOOLEAN    AllFree;
-  UINTN      Granularity;
-  BOOLEAN    IsGuarded;
-  BOOLEAN    HasPoolTail;
-  BOOLEAN    PageAsPool;
+  POOL            *Pool;
+  POOL_HEAD       *Head;
+  POOL_TAIL       *Tail;
+  POOL_FREE       *Free;
+  POOL_SLAB_HEAD  *SlabHead;
+  UINTN           Index;
+  UINTN           NoPages;
+  UINTN           Size;
+  CHAR8           *NewPage;
+  UINTN           Offset;
+  BOOLEAN         AllFree;
+  UINTN           Granularity;
+  BOOLEAN         IsGuarded;
+  BOOLEAN         HasPoolTail;
+  BOOLEAN         PageAsPool;
 
   ASSERT (Buffer != NULL);
+  //
+  // Small pool entries come from the slabs
+  //
+  SlabHead = (POOL_SLAB_HEAD *)Buffer - 1;
+  if (SlabHead->Signature == POOL_SLAB_HEAD_SIGNATURE) {
+    ASSERT_LOCKED (&mPoolMemoryLock);
+
+    if ((SlabHead->Type >= EfiMaxMemoryType) ||
+        (SlabHead->Class >= POOL_SLAB_CLASSES) ||
+        (mPoolHead[SlabHead->Type].Slab == NULL))
+    {
+      ASSERT (FALSE);
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Pool = &mPoolHead[SlabHead->Type];
+    DEBUG ((DEBUG_POOL, "FreePool: %p (len %lx) to slab\n", Buffer, (UINT64)SLAB_CLASS_TO_SIZE (SlabHead->Class)));
+
+    if (PoolType != NULL) {
+      *PoolType = Pool->MemoryType;
+    }
+
+    DEBUG_CLEAR_MEMORY (Buffer, SLAB_CLASS_TO_SIZE (SlabHead->Class));
+    CoreFreePoolSlab (Pool, SlabHead);
+    return EFI_SUCCESS;
+  }
+
+  if (SlabHead->Signature == POOL_SLAB_FREE_SIGNATURE) {
+    ASSERT (SlabHead->Signature != POOL_SLAB_FREE_SIGNATURE);
+    return EFI_INVALID_PARAMETER;
+  }
+
   //
   // Get the head & tail of the pool entry
   //
@@ -869,3 +1288,56 @@ CoreFreePoolI (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Display the usage of the pool and of its slabs for each memory type.
+
+**/
+VOID
+CoreDisplayPoolStatistics (
+  VOID
+  )
+{
+  POOL                   *Pool;
+  POOL_SLAB_CLASS_CACHE  *ClassCache;
+  UINTN                  Type;
+  UINTN                  Class;
+
+  CoreAcquireLock (&mPoolMemoryLock);
+
+  for (Type = 0; Type < EfiMaxMemoryType; Type++) {
+    Pool = &mPoolHead[Type];
+    if ((Pool->Used == 0) && (Pool->Slab == NULL)) {
+      continue;
+    }
+
+    DEBUG ((DEBUG_INFO, "Pool type %x: %,ld bytes in pool lists\n", (UINT32)Type, (UINT64)Pool->Used));
+    if (Pool->Slab == NULL) {
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  Slab pages %,ld (peak %,ld)\n",
+      (UINT64)Pool->Slab->Pages,
+      (UINT64)Pool->Slab->PeakPages
+      ));
+    for (Class = 0; Class < POOL_SLAB_CLASSES; Class++) {
+      ClassCache = &Pool->Slab->Class[Class];
+      if (ClassCache->Allocations == 0) {
+        continue;
+      }
+
+      DEBUG ((
+        DEBUG_INFO,
+        "  %3d bytes: %,ld in use, %,ld allocated, %d in magazine\n",
+        (UINT32)SLAB_CLASS_TO_SIZE (Class),
+        (UINT64)ClassCache->InUse,
+        (UINT64)ClassCache->Allocations,
+        (UINT32)ClassCache->MagazineCount
+        ));
+    }
+  }
+
+  CoreReleaseLock (&mPoolMemoryLock);
+}
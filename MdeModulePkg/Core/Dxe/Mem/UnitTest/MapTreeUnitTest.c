@@ -0,0 +1,490 @@
+/** @file
+  Unit tests for the red-black trees indexing the memory map and the GCD maps
+  of the DXE core.
+
+  The trees are checked after every random insert, delete and weight change:
+  the red-black properties, the order of the start addresses and the largest
+  weight of every subtree. The lookups are compared with a linear walk of the
+  entries, the way the maps were searched when they were plain lists.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "../../DxeMain.h"
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE Core Map Tree Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// The entries start TEST_ENTRY_STRIDE bytes apart, in the order of their
+// index, so that a linear walk of the array is a walk of the map.
+//
+#define TEST_ENTRY_COUNT   512
+#define TEST_ENTRY_STRIDE  0x1000
+#define TEST_MAX_WEIGHT    64
+#define TEST_OPERATIONS    20000
+#define TEST_LOOKUPS       8
+
+typedef struct {
+  CORE_MAP_NODE    Node;
+  UINT64           Start;
+  UINT64           Weight;
+  BOOLEAN          InTree;
+} TEST_MAP_ENTRY;
+
+STATIC TEST_MAP_ENTRY  mTestEntry[TEST_ENTRY_COUNT];
+STATIC CORE_MAP_TREE   mTestTree;
+STATIC UINTN           mTestEntryCount;
+STATIC UINT32          mRandomSeed;
+
+/**
+  Return the next number of a simple linear congruential generator, so that
+  every run does the same operations.
+
+  @param[in]  Limit   The exclusive upper bound of the number.
+
+  @return A pseudo random number below Limit.
+
+**/
+STATIC
+UINTN
+TestRandom (
+  IN UINTN  Limit
+  )
+{
+  mRandomSeed = mRandomSeed * 1103515245 + 12345;
+  return ((mRandomSeed >> 16) & 0x7FFF) % Limit;
+}
+
+/**
+  Get the test entry of a node.
+
+  @param[in]  Node    The node, or NULL.
+
+  @return The index of the entry, or TEST_ENTRY_COUNT if Node is NULL.
+
+**/
+STATIC
+UINTN
+TestEntryIndex (
+  IN CORE_MAP_NODE  *Node
+  )
+{
+  if (Node == NULL) {
+    return TEST_ENTRY_COUNT;
+  }
+
+  return (UINTN)(BASE_CR (Node, TEST_MAP_ENTRY, Node) - mTestEntry);
+}
+
+/**
+  Find the entry with the highest start address at or below an address and
+  at least a weight, walking the entries down from the address.
+
+  @param[in]  Address   The address.
+  @param[in]  Weight    The minimum weight.
+
+  @return The index of the entry, or TEST_ENTRY_COUNT if there is none.
+
+**/
+STATIC
+UINTN
+TestLinearLastFit (
+  IN UINT64  Address,
+  IN UINT64  Weight
+  )
+{
+  UINTN  Index;
+
+  Index = (UINTN)MIN (Address / TEST_ENTRY_STRIDE + 1, TEST_ENTRY_COUNT);
+  while (Index > 0) {
+    Index--;
+    if (mTestEntry[Index].InTree && (mTestEntry[Index].Start <= Address) && (mTestEntry[Index].Weight >= Weight)) {
+      return Index;
+    }
+  }
+
+  return TEST_ENTRY_COUNT;
+}
+
+/**
+  Check the subtree of a node: the parent links, no red node with a red child,
+  the same number of black nodes on every path, the start addresses in order
+  and the largest weight of the subtree.
+
+  @param[in]   Node         The root of the subtree, or NULL.
+  @param[in]   Low          All the start addresses must be above this one.
+  @param[in]   High         All the start addresses must be below this one.
+  @param[out]  BlackHeight  The number of black nodes on every path.
+  @param[out]  Count        The number of nodes in the subtree.
+
+  @retval TRUE   The subtree is valid.
+  @retval FALSE  The subtree breaks one of the properties.
+
+**/
+STATIC
+BOOLEAN
+TestCheckSubtree (
+  IN  CORE_MAP_NODE  *Node,
+  IN  INT64          Low,
+  IN  INT64          High,
+  OUT UINTN          *BlackHeight,
+  OUT UINTN          *Count
+  )
+{
+  UINTN   LeftHeight;
+  UINTN   RightHeight;
+  UINTN   LeftCount;
+  UINTN   RightCount;
+  UINT64  MaxWeight;
+
+  if (Node == NULL) {
+    *BlackHeight = 1;
+    *Count       = 0;
+    return TRUE;
+  }
+
+  if (((INT64)*Node->Start <= Low) || ((INT64)*Node->Start >= High)) {
+    return FALSE;
+  }
+
+  if (((Node->Left != NULL) && (Node->Left->Parent != Node)) ||
+      ((Node->Right != NULL) && (Node->Right->Parent != Node)))
+  {
+    return FALSE;
+  }
+
+  if (Node->Red &&
+      (((Node->Left != NULL) && Node->Left->Red) ||
+       ((Node->Right != NULL) && Node->Right->Red)))
+  {
+    return FALSE;
+  }
+
+  if (!TestCheckSubtree (Node->Left, Low, (INT64)*Node->Start, &LeftHeight, &LeftCount) ||
+      !TestCheckSubtree (Node->Right, (INT64)*Node->Start, High, &RightHeight, &RightCount) ||
+      (LeftHeight != RightHeight))
+  {
+    return FALSE;
+  }
+
+  MaxWeight = Node->Weight;
+  if ((Node->Left != NULL) && (Node->Left->MaxWeight > MaxWeight)) {
+    MaxWeight = Node->Left->MaxWeight;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxWeight > MaxWeight)) {
+    MaxWeight = Node->Right->MaxWeight;
+  }
+
+  if (Node->MaxWeight != MaxWeight) {
+    return FALSE;
+  }
+
+  *BlackHeight = LeftHeight + (Node->Red ? 0 : 1);
+  *Count       = LeftCount + RightCount + 1;
+  return TRUE;
+}
+
+/**
+  Check the whole test tree.
+
+  @retval TRUE   The tree is a valid red-black tree of the entries in it.
+  @retval FALSE  The tree is broken.
+
+**/
+STATIC
+BOOLEAN
+TestCheckTree (
+  VOID
+  )
+{
+  UINTN  BlackHeight;
+  UINTN  Count;
+
+  if (mTestTree.Root != NULL) {
+    if (mTestTree.Root->Red || (mTestTree.Root->Parent != NULL)) {
+      return FALSE;
+    }
+  }
+
+  if (!TestCheckSubtree (mTestTree.Root, -1, MAX_INT64, &BlackHeight, &Count)) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(Count == mTestEntryCount);
+}
+
+/**
+  Do a random insert, delete or weight change on the test tree. The entries
+  not in the tree are inserted, and the others are deleted one time in four.
+
+**/
+STATIC
+VOID
+TestRandomOperation (
+  VOID
+  )
+{
+  TEST_MAP_ENTRY  *Entry;
+
+  Entry = &mTestEntry[TestRandom (TEST_ENTRY_COUNT)];
+  if (!Entry->InTree) {
+    Entry->Weight = TestRandom (TEST_MAX_WEIGHT);
+    Entry->InTree = TRUE;
+    CoreMapTreeInsert (&mTestTree, &Entry->Node, &Entry->Start, Entry->Weight);
+    mTestEntryCount++;
+  } else if (TestRandom (4) == 0) {
+    Entry->InTree = FALSE;
+    CoreMapTreeDelete (&mTestTree, &Entry->Node);
+    mTestEntryCount--;
+  } else {
+    Entry->Weight = TestRandom (TEST_MAX_WEIGHT);
+    CoreMapTreeSetWeight (&Entry->Node, Entry->Weight);
+  }
+}
+
+/**
+  Start every test with an empty tree and the same random numbers.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED   The tree is reset.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetTree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  ZeroMem (mTestEntry, sizeof (mTestEntry));
+  for (Index = 0; Index < TEST_ENTRY_COUNT; Index++) {
+    mTestEntry[Index].Start = Index * TEST_ENTRY_STRIDE;
+  }
+
+  mTestTree.Root  = NULL;
+  mTestEntryCount = 0;
+  mRandomSeed     = 0x5EED;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The tree stays a valid red-black tree, with the largest weight of every
+  subtree up to date, through random inserts, deletes and weight changes.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TreeInvariantTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Operation;
+
+  for (Operation = 0; Operation < TEST_OPERATIONS; Operation++) {
+    TestRandomOperation ();
+    UT_ASSERT_TRUE (TestCheckTree ());
+  }
+
+  //
+  // Empty the tree in address order, which rebalances it the most.
+  //
+  while (mTestTree.Root != NULL) {
+    mTestEntry[TestEntryIndex (CoreMapTreeFirst (&mTestTree))].InTree = FALSE;
+    CoreMapTreeDelete (&mTestTree, CoreMapTreeFirst (&mTestTree));
+    mTestEntryCount--;
+    UT_ASSERT_TRUE (TestCheckTree ());
+  }
+
+  UT_ASSERT_EQUAL (mTestEntryCount, 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  CoreMapTreeFind() returns the entry holding an address, and
+  CoreMapTreeFirst() and CoreMapTreeNext() visit the entries in address
+  order, as a walk of the map would.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FindTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN          Operation;
+  UINTN          Lookup;
+  UINTN          Index;
+  UINT64         Address;
+  CORE_MAP_NODE  *Node;
+
+  for (Operation = 0; Operation < TEST_OPERATIONS; Operation++) {
+    TestRandomOperation ();
+
+    for (Lookup = 0; Lookup < TEST_LOOKUPS; Lookup++) {
+      Address = TestRandom ((TEST_ENTRY_COUNT + 1) * TEST_ENTRY_STRIDE / 16) * 16;
+      UT_ASSERT_EQUAL (TestEntryIndex (CoreMapTreeFind (&mTestTree, Address)), TestLinearLastFit (Address, 0));
+    }
+
+    if (Operation % 256 == 0) {
+      Node = CoreMapTreeFirst (&mTestTree);
+      for (Index = 0; Index < TEST_ENTRY_COUNT; Index++) {
+        if (mTestEntry[Index].InTree) {
+          UT_ASSERT_EQUAL (TestEntryIndex (Node), Index);
+          Node = CoreMapTreeNext (Node);
+        }
+      }
+
+      UT_ASSERT_TRUE (Node == NULL);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  CoreMapTreeLastFit() and CoreMapTreePrevFit(), which skip the light entries
+  a subtree at a time, find the same entries as a linear first-fit walk down
+  the map.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FitTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN          Operation;
+  UINTN          Lookup;
+  UINTN          Index;
+  UINT64         Address;
+  UINT64         Weight;
+  CORE_MAP_NODE  *Node;
+
+  for (Operation = 0; Operation < TEST_OPERATIONS; Operation++) {
+    TestRandomOperation ();
+
+    for (Lookup = 0; Lookup < TEST_LOOKUPS; Lookup++) {
+      Address = TestRandom ((TEST_ENTRY_COUNT + 1) * TEST_ENTRY_STRIDE / 16) * 16;
+      Weight  = TestRandom (TEST_MAX_WEIGHT + 2);
+      Node    = CoreMapTreeLastFit (&mTestTree, Address, Weight);
+      Index   = TestLinearLastFit (Address, Weight);
+      UT_ASSERT_EQUAL (TestEntryIndex (Node), Index);
+
+      //
+      // Follow the fits down to the lowest one, as an allocation that
+      // doesn't fit the alignment or the range of the first one does.
+      //
+      if ((Lookup == 0) && (Node != NULL)) {
+        while (Node != NULL) {
+          Node  = CoreMapTreePrevFit (Node, Weight);
+          Index = (Index == 0) ? TEST_ENTRY_COUNT : TestLinearLastFit (mTestEntry[Index - 1].Start, Weight);
+          UT_ASSERT_EQUAL (TestEntryIndex (Node), Index);
+        }
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the map trees
+  and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TreeTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&TreeTests, Framework, "Map Tree Tests", "DxeCore.MapTree", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Map Tree Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (TreeTests, "Red-black and largest weight invariants hold", "Invariants", TreeInvariantTest, ResetTree, NULL, NULL);
+  AddTestCase (TreeTests, "Find and in-order walk match a linear walk", "Find", FindTest, ResetTree, NULL, NULL);
+  AddTestCase (TreeTests, "LastFit and PrevFit match a linear first fit", "Fit", FitTest, ResetTree, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  argc  Number of arguments.
+  @param[in]  argv  Array of arguments.
+
+  @return 0 on success, 1 on failure.
+
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
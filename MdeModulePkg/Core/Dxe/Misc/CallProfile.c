@@ -0,0 +1,539 @@
+/** @file
+  Call profiler of the DXE Core.
+
+  When PcdDxeCoreCallProfileNodes isn't zero, the DXE Core records the time
+  spent in LoadImage(), StartImage(), ConnectController(), the Supported() and
+  Start() services of the driver bindings, the event notification functions and
+  the event dispatch of RestoreTPL() in a calling context tree: a node per
+  distinct chain of these calls, holding the time spent in the chain. The tree
+  is printed to the debug log as folded stacks at ReadyToBoot, one line per node:
+
+    DXEPROF: DxeCore;StartImage:PciBusDxe;ConnectController;Start:UsbBusDxe 1234567
+
+  where the number is the time in ns spent in the node but not in its children.
+  BaseTools/Scripts/DxeProfileToFlameGraph.py makes a flame graph of the lines.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+#define CALL_PROFILE_MAX_DEPTH    64
+#define CALL_PROFILE_NAME_LENGTH  48
+#define CALL_PROFILE_NO_NODE      MAX_UINT32
+
+typedef struct {
+  UINTN     Key;
+  UINT64    Ticks;           // time spent in the node, children included
+  UINT32    Parent;
+  UINT32    FirstChild;
+  UINT32    NextSibling;
+  UINT32    Type;
+  CHAR8     Name[CALL_PROFILE_NAME_LENGTH];
+} CALL_PROFILE_NODE;
+
+typedef struct {
+  UINT32     Node;
+  BOOLEAN    Recorded;       // FALSE if the tree is full, Node is the parent then
+  UINT64     Start;
+} CALL_PROFILE_FRAME;
+
+CONST CHAR8  *mCallProfileTypeName[CallProfileTypeMax] = {
+  "DxeCore",
+  "LoadImage",
+  "StartImage",
+  "ConnectController",
+  "Supported",
+  "Start",
+  "Notify",
+  "RestoreTpl"
+};
+
+CALL_PROFILE_NODE   *mCallProfileNodes     = NULL;
+UINT32              mCallProfileNodeCount  = 0;
+UINT32              mCallProfileMaxNodes   = 0;
+UINT64              mCallProfileLostFrames = 0;
+BOOLEAN             mCallProfileCountUp    = TRUE;
+UINTN               mCallProfileDepth      = 0;
+CALL_PROFILE_FRAME  mCallProfileStack[CALL_PROFILE_MAX_DEPTH];
+
+/**
+  Name a node after an image: the file name of its PDB without the extension,
+  else the GUID of its FFS file, else its base address.
+
+  @param  Node                   The node.
+  @param  LoadedImage            The loaded image protocol of the image.
+
+**/
+STATIC
+VOID
+CallProfileNameImage (
+  IN CALL_PROFILE_NODE          *Node,
+  IN EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage
+  )
+{
+  CHAR8           *PdbPointer;
+  CHAR8           Char;
+  UINTN           StartIndex;
+  UINTN           Index;
+  CONST EFI_GUID  *FileName;
+
+  PdbPointer = PeCoffLoaderGetPdbPointer (LoadedImage->ImageBase);
+  if (PdbPointer != NULL) {
+    StartIndex = 0;
+    for (Index = 0; PdbPointer[Index] != 0; Index++) {
+      if ((PdbPointer[Index] == '\\') || (PdbPointer[Index] == '/')) {
+        StartIndex = Index + 1;
+      }
+    }
+
+    //
+    // Spaces and semicolons separate the frames and the time of a folded stack.
+    //
+    for (Index = 0; Index < CALL_PROFILE_NAME_LENGTH - 1; Index++) {
+      Char = PdbPointer[StartIndex + Index];
+      if ((Char == 0) || (Char == '.')) {
+        break;
+      }
+
+      Node->Name[Index] = ((Char == ' ') || (Char == ';')) ? '_' : Char;
+    }
+
+    Node->Name[Index] = 0;
+    return;
+  }
+
+  FileName = NULL;
+  if (LoadedImage->FilePath != NULL) {
+    FileName = EfiGetNameGuidFromFwVolDevicePathNode ((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)LoadedImage->FilePath);
+  }
+
+  if (FileName != NULL) {
+    AsciiSPrint (Node->Name, sizeof (Node->Name), "%g", FileName);
+  } else {
+    AsciiSPrint (Node->Name, sizeof (Node->Name), "0x%lx", (UINT64)(UINTN)LoadedImage->ImageBase);
+  }
+}
+
+/**
+  Find the child node of a node for a call, and add it to the tree if the node
+  has none yet.
+
+  @param  Parent                 The node of the caller.
+  @param  Type                   The type of the call.
+  @param  Key                    The key of the call.
+  @param  ImageHandle            The image the call is made to, if known.
+
+  @return The child node, or CALL_PROFILE_NO_NODE if the tree is full.
+
+**/
+STATIC
+UINT32
+CallProfileFindChild (
+  IN UINT32             Parent,
+  IN CALL_PROFILE_TYPE  Type,
+  IN UINTN              Key,
+  IN EFI_HANDLE         ImageHandle OPTIONAL
+  )
+{
+  CALL_PROFILE_NODE          *Node;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+  UINT32                     Index;
+  UINTN                      Offset;
+
+  for (Index = mCallProfileNodes[Parent].FirstChild;
+       Index != CALL_PROFILE_NO_NODE;
+       Index = mCallProfileNodes[Index].NextSibling)
+  {
+    if ((mCallProfileNodes[Index].Type == (UINT32)Type) && (mCallProfileNodes[Index].Key == Key)) {
+      return Index;
+    }
+  }
+
+  if (mCallProfileNodeCount == mCallProfileMaxNodes) {
+    return CALL_PROFILE_NO_NODE;
+  }
+
+  Index             = mCallProfileNodeCount++;
+  Node              = &mCallProfileNodes[Index];
+  Node->Key         = Key;
+  Node->Ticks       = 0;
+  Node->Parent      = Parent;
+  Node->FirstChild  = CALL_PROFILE_NO_NODE;
+  Node->NextSibling = CALL_PROFILE_NO_NODE;
+  Node->Type        = (UINT32)Type;
+  Node->Name[0]     = 0;
+
+  //
+  // The name is worked out once, for the output to do without a lookup.
+  //
+  if (ImageHandle != NULL) {
+    LoadedImage = CoreFindDebugImageInfoEntry (ImageHandle, 0);
+    if (LoadedImage != NULL) {
+      CallProfileNameImage (Node, LoadedImage);
+    }
+  } else if (Type == CallProfileNotify) {
+    LoadedImage = CoreFindDebugImageInfoEntry (NULL, Key);
+    if (LoadedImage != NULL) {
+      CallProfileNameImage (Node, LoadedImage);
+      Offset = Key - (UINTN)LoadedImage->ImageBase;
+      AsciiSPrint (
+        Node->Name + AsciiStrLen (Node->Name),
+        sizeof (Node->Name) - AsciiStrLen (Node->Name),
+        "+0x%lx",
+        (UINT64)Offset
+        );
+    } else {
+      AsciiSPrint (Node->Name, sizeof (Node->Name), "0x%lx", (UINT64)Key);
+    }
+  } else if (Type == CallProfileRestoreTpl) {
+    AsciiSPrint (Node->Name, sizeof (Node->Name), "%d", (UINT32)Key);
+  }
+
+  //
+  // Link the node last; the report walks the tree with interrupts enabled.
+  //
+  Node->NextSibling                    = mCallProfileNodes[Parent].FirstChild;
+  mCallProfileNodes[Parent].FirstChild = Index;
+
+  return Index;
+}
+
+/**
+  Add the time since the start of a frame to the node of the frame.
+
+  @param  Frame                  The frame.
+  @param  Now                    The current performance counter value.
+
+**/
+STATIC
+VOID
+CallProfileAddTicks (
+  IN CALL_PROFILE_FRAME  *Frame,
+  IN UINT64              Now
+  )
+{
+  if (Frame->Recorded) {
+    mCallProfileNodes[Frame->Node].Ticks += mCallProfileCountUp ? Now - Frame->Start : Frame->Start - Now;
+  }
+}
+
+/**
+  Returns the key of the call profile nodes of an image, the CRC32 of its file
+  path, or the image handle if it has no file path.
+
+  @param  FilePath               The file path of the image.
+  @param  ImageHandle            The image handle, NULL if not known yet.
+
+  @return The key, 0 if the call profiler is disabled.
+
+**/
+UINTN
+CoreCallProfileImageKey (
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN EFI_HANDLE                ImageHandle OPTIONAL
+  )
+{
+  if (mCallProfileNodes == NULL) {
+    return 0;
+  }
+
+  if (FilePath == NULL) {
+    return (UINTN)ImageHandle;
+  }
+
+  return CalculateCrc32 (FilePath, GetDevicePathSize (FilePath));
+}
+
+/**
+  Record the entry to a call in the call profile.
+
+  @param  Type                   The type of the call.
+  @param  Key                    The key of the call, telling apart the calls of
+                                 the same type made from the same calling context.
+  @param  ImageHandle            The image the call is made to, if known, to name
+                                 the call after.
+
+  @return The token to give to CoreCallProfileExit() when the call returns.
+
+**/
+UINTN
+CoreCallProfileEnter (
+  IN CALL_PROFILE_TYPE  Type,
+  IN UINTN              Key,
+  IN EFI_HANDLE         ImageHandle OPTIONAL
+  )
+{
+  BOOLEAN             InterruptState;
+  UINTN               Token;
+  UINT32              Parent;
+  CALL_PROFILE_FRAME  *Frame;
+
+  if (mCallProfileNodes == NULL) {
+    return 0;
+  }
+
+  //
+  // The calls made from interrupt context nest in the interrupted call.
+  //
+  InterruptState = SaveAndDisableInterrupts ();
+
+  Token = ++mCallProfileDepth;
+  if (Token <= CALL_PROFILE_MAX_DEPTH) {
+    Parent          = mCallProfileStack[Token - 2].Node;
+    Frame           = &mCallProfileStack[Token - 1];
+    Frame->Node     = CallProfileFindChild (Parent, Type, Key, ImageHandle);
+    Frame->Recorded = (BOOLEAN)(Frame->Node != CALL_PROFILE_NO_NODE);
+    if (!Frame->Recorded) {
+      Frame->Node = Parent;
+      mCallProfileLostFrames++;
+    }
+
+    Frame->Start = GetPerformanceCounter ();
+  } else {
+    mCallProfileLostFrames++;
+  }
+
+  SetInterruptState (InterruptState);
+
+  return Token;
+}
+
+/**
+  Record the return from a call in the call profile.
+
+  The calls entered after it and not returned from, the ones left with a long
+  jump by Exit(), are returned from as well.
+
+  @param  Token                  The token CoreCallProfileEnter() returned for the call.
+  @param  ImageHandle            The image the call loaded, to name the call after
+                                 if it has no name yet.
+
+**/
+VOID
+CoreCallProfileExit (
+  IN UINTN       Token,
+  IN EFI_HANDLE  ImageHandle OPTIONAL
+  )
+{
+  BOOLEAN                    InterruptState;
+  UINT64                     Now;
+  CALL_PROFILE_FRAME         *Frame;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+
+  if (Token == 0) {
+    return;
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+  Now            = GetPerformanceCounter ();
+
+  if ((ImageHandle != NULL) && (Token <= mCallProfileDepth) && (Token <= CALL_PROFILE_MAX_DEPTH)) {
+    Frame = &mCallProfileStack[Token - 1];
+    if (Frame->Recorded && (mCallProfileNodes[Frame->Node].Name[0] == 0)) {
+      LoadedImage = CoreFindDebugImageInfoEntry (ImageHandle, 0);
+      if (LoadedImage != NULL) {
+        CallProfileNameImage (&mCallProfileNodes[Frame->Node], LoadedImage);
+      }
+    }
+  }
+
+  while (mCallProfileDepth >= Token) {
+    if (mCallProfileDepth <= CALL_PROFILE_MAX_DEPTH) {
+      CallProfileAddTicks (&mCallProfileStack[mCallProfileDepth - 1], Now);
+    }
+
+    mCallProfileDepth--;
+  }
+
+  SetInterruptState (InterruptState);
+}
+
+/**
+  Print the frame of a node, followed by a separator.
+
+  @param  Node                   The node.
+  @param  Separator              The separator.
+
+**/
+STATIC
+VOID
+CallProfilePrintFrame (
+  IN CALL_PROFILE_NODE  *Node,
+  IN CONST CHAR8        *Separator
+  )
+{
+  if (Node->Name[0] == 0) {
+    DEBUG ((DEBUG_INFO, "%a%a", mCallProfileTypeName[Node->Type], Separator));
+  } else {
+    DEBUG ((DEBUG_INFO, "%a:%a%a", mCallProfileTypeName[Node->Type], Node->Name, Separator));
+  }
+}
+
+/**
+  Print the call profile to the debug log as folded stacks, at ReadyToBoot.
+
+  A frame is printed at a time, the lines of a deep tree being longer than the
+  debug messages can be.
+
+  @param  Event                  Not used
+  @param  Context                Not used
+
+**/
+STATIC
+VOID
+EFIAPI
+CoreReportCallProfile (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  BOOLEAN  InterruptState;
+  UINT64   Now;
+  UINTN    Index;
+  UINT32   Path[CALL_PROFILE_MAX_DEPTH];
+  UINTN    Depth;
+  UINT32   Node;
+  UINT32   Child;
+  UINT64   Ticks;
+  UINT64   ChildTicks;
+  UINT64   Time;
+
+  //
+  // Account the time of the calls in progress so far.
+  //
+  InterruptState = SaveAndDisableInterrupts ();
+  Now            = GetPerformanceCounter ();
+  for (Index = 0; (Index < mCallProfileDepth) && (Index < CALL_PROFILE_MAX_DEPTH); Index++) {
+    CallProfileAddTicks (&mCallProfileStack[Index], Now);
+    mCallProfileStack[Index].Start = Now;
+  }
+
+  SetInterruptState (InterruptState);
+
+  DEBUG ((DEBUG_INFO, "DXEPROF: begin\n"));
+
+  //
+  // Walk the tree depth first, from the root node.
+  //
+  Depth = 0;
+  Node  = 0;
+  while (TRUE) {
+    Path[Depth] = Node;
+
+    InterruptState = SaveAndDisableInterrupts ();
+    Ticks          = mCallProfileNodes[Node].Ticks;
+    ChildTicks     = 0;
+    for (Child = mCallProfileNodes[Node].FirstChild;
+         Child != CALL_PROFILE_NO_NODE;
+         Child = mCallProfileNodes[Child].NextSibling)
+    {
+      ChildTicks += mCallProfileNodes[Child].Ticks;
+    }
+
+    SetInterruptState (InterruptState);
+
+    Time = (Ticks > ChildTicks) ? GetTimeInNanoSecond (Ticks - ChildTicks) : 0;
+    if (Time != 0) {
+      DEBUG ((DEBUG_INFO, "DXEPROF: "));
+      for (Index = 0; Index < Depth; Index++) {
+        CallProfilePrintFrame (&mCallProfileNodes[Path[Index]], ";");
+      }
+
+      CallProfilePrintFrame (&mCallProfileNodes[Node], " ");
+      DEBUG ((DEBUG_INFO, "%ld\n", Time));
+    }
+
+    if (mCallProfileNodes[Node].FirstChild != CALL_PROFILE_NO_NODE) {
+      Node = mCallProfileNodes[Node].FirstChild;
+      Depth++;
+      continue;
+    }
+
+    while ((Depth > 0) && (mCallProfileNodes[Node].NextSibling == CALL_PROFILE_NO_NODE)) {
+      Depth--;
+      Node = Path[Depth];
+    }
+
+    if (Depth == 0) {
+      break;
+    }
+
+    Node = mCallProfileNodes[Node].NextSibling;
+  }
+
+  DEBUG ((DEBUG_INFO, "DXEPROF: end\n"));
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Call profile: %d of %d nodes used, %ld calls not recorded\n",
+    mCallProfileNodeCount,
+    mCallProfileMaxNodes,
+    mCallProfileLostFrames
+    ));
+}
+
+/**
+  Initializes the call profiler, if PcdDxeCoreCallProfileNodes isn't zero. The
+  time spent in the DXE Core since then goes to the root node of the profile.
+
+**/
+VOID
+CoreInitializeCallProfile (
+  VOID
+  )
+{
+  EFI_STATUS         Status;
+  EFI_EVENT          ReadyToBootEvent;
+  UINT64             StartValue;
+  UINT64             EndValue;
+  CALL_PROFILE_NODE  *Nodes;
+
+  mCallProfileMaxNodes = PcdGet32 (PcdDxeCoreCallProfileNodes);
+  if (mCallProfileMaxNodes == 0) {
+    return;
+  }
+
+  Status = CoreCreateEventEx (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             CoreReportCallProfile,
+             NULL,
+             &gEfiEventReadyToBootGuid,
+             &ReadyToBootEvent
+             );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Nodes = AllocatePool (mCallProfileMaxNodes * sizeof (CALL_PROFILE_NODE));
+  if (Nodes == NULL) {
+    DEBUG ((DEBUG_ERROR, "Call profile: No memory for %d nodes\n", mCallProfileMaxNodes));
+    CoreCloseEvent (ReadyToBootEvent);
+    return;
+  }
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  mCallProfileCountUp = (BOOLEAN)(EndValue >= StartValue);
+
+  Nodes[0].Key         = 0;
+  Nodes[0].Ticks       = 0;
+  Nodes[0].Parent      = CALL_PROFILE_NO_NODE;
+  Nodes[0].FirstChild  = CALL_PROFILE_NO_NODE;
+  Nodes[0].NextSibling = CALL_PROFILE_NO_NODE;
+  Nodes[0].Type        = CallProfileRoot;
+  Nodes[0].Name[0]     = 0;
+
+  mCallProfileNodeCount         = 1;
+  mCallProfileStack[0].Node     = 0;
+  mCallProfileStack[0].Recorded = TRUE;
+  mCallProfileStack[0].Start    = GetPerformanceCounter ();
+  mCallProfileDepth             = 1;
+
+  //
+  // The calls are recorded from now on.
+  //
+  mCallProfileNodes = Nodes;
+}
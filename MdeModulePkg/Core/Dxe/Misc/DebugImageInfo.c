@@ -3,6 +3,7 @@
   images.
 
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -280,3 +281,50 @@ CoreRemoveDebugImageInfoEntry (
 
   mDebugInfoTableHeader.UpdateStatus &= ~EFI_DEBUG_IMAGE_INFO_UPDATE_IN_PROGRESS;
 }
+
+/**
+  Finds an image in the DebugImageInfo Table, by its image handle or by an
+  address in the image. The table isn't searched while it's being updated.
+
+  @param  ImageHandle    image handle of the image, or NULL to find the image
+                         by Address
+  @param  Address        an address in the image, if ImageHandle is NULL
+
+  @return The loaded image protocol of the image, or NULL if it isn't found.
+
+**/
+EFI_LOADED_IMAGE_PROTOCOL *
+CoreFindDebugImageInfoEntry (
+  IN EFI_HANDLE  ImageHandle  OPTIONAL,
+  IN UINTN       Address
+  )
+{
+  EFI_DEBUG_IMAGE_INFO       *Table;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+  UINTN                      Index;
+
+  if ((mDebugInfoTableHeader.UpdateStatus & EFI_DEBUG_IMAGE_INFO_UPDATE_IN_PROGRESS) != 0) {
+    return NULL;
+  }
+
+  Table = mDebugInfoTableHeader.EfiDebugImageInfoTable;
+
+  for (Index = 0; Index < mMaxTableEntries; Index++) {
+    if (Table[Index].NormalImage == NULL) {
+      continue;
+    }
+
+    LoadedImage = Table[Index].NormalImage->LoadedImageProtocolInstance;
+    if (ImageHandle != NULL) {
+      if (Table[Index].NormalImage->ImageHandle == ImageHandle) {
+        return LoadedImage;
+      }
+    } else if ((Address >= (UINTN)LoadedImage->ImageBase) &&
+               (Address - (UINTN)LoadedImage->ImageBase < LoadedImage->ImageSize))
+    {
+      return LoadedImage;
+    }
+  }
+
+  return NULL;
+}
@@ -0,0 +1,147 @@
+/** @file
+  Index of the GUIDed HOBs of the HOB list.
+
+  The index is built once, when the HOB list is installed in the EFI System
+  Configuration Table, and published next to it so that a HobLib instance of
+  a DXE module can find a GUIDed HOB without walking the HOB list.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+/**
+  Find the entry of a GUID in a HOB index table.
+
+  @param  Table                  The HOB index table.
+  @param  Guid                   The GUID to look for.
+
+  @return The entry of the GUID, or NULL if the table has none.
+
+**/
+STATIC
+EDKII_HOB_INDEX_ENTRY *
+CoreFindHobIndexEntry (
+  IN EDKII_HOB_INDEX_TABLE  *Table,
+  IN CONST EFI_GUID         *Guid
+  )
+{
+  UINT32  Index;
+
+  for (Index = Table->Bucket[EDKII_HOB_INDEX_BUCKET (Guid)];
+       Index != EDKII_HOB_INDEX_END;
+       Index = Table->Entry[Index].Next)
+  {
+    if (CompareGuid (&Table->Entry[Index].Name, Guid)) {
+      return &Table->Entry[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Build the index of the GUIDed HOBs of a HOB list.
+
+  @param  HobStart               The HOB list.
+
+  @return The HOB index table, allocated from pool, or NULL if there isn't
+          enough memory for it.
+
+**/
+EDKII_HOB_INDEX_TABLE *
+CoreBuildHobIndexTable (
+  IN VOID  *HobStart
+  )
+{
+  EFI_PEI_HOB_POINTERS   Hob;
+  UINTN                  HobCount;
+  UINTN                  Bucket;
+  UINT32                 First;
+  UINT32                 *Offset;
+  EDKII_HOB_INDEX_ENTRY  *Entry;
+  EDKII_HOB_INDEX_TABLE  *Work;
+  EDKII_HOB_INDEX_TABLE  *Table;
+
+  HobCount = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      HobCount++;
+    }
+  }
+
+  //
+  // Room for an entry per GUIDed HOB, the worst case, and the offset array.
+  //
+  Work = AllocatePool (
+           OFFSET_OF (EDKII_HOB_INDEX_TABLE, Entry) +
+           HobCount * (sizeof (EDKII_HOB_INDEX_ENTRY) + sizeof (UINT32))
+           );
+  if (Work == NULL) {
+    return NULL;
+  }
+
+  Work->HobList       = (EFI_PHYSICAL_ADDRESS)(UINTN)HobStart;
+  Work->HobListLength = (UINT64)(Hob.Raw + sizeof (EFI_HOB_GENERIC_HEADER) - (UINT8 *)HobStart);
+  Work->EntryCount    = 0;
+  Work->HobCount      = (UINT32)HobCount;
+  SetMem32 (Work->Bucket, sizeof (Work->Bucket), EDKII_HOB_INDEX_END);
+
+  //
+  // Count the HOBs of each GUID.
+  //
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) != EFI_HOB_TYPE_GUID_EXTENSION) {
+      continue;
+    }
+
+    Entry = CoreFindHobIndexEntry (Work, &Hob.Guid->Name);
+    if (Entry == NULL) {
+      Bucket               = EDKII_HOB_INDEX_BUCKET (&Hob.Guid->Name);
+      Entry                = &Work->Entry[Work->EntryCount];
+      Entry->Count         = 0;
+      Entry->Reserved      = 0;
+      Entry->Next          = Work->Bucket[Bucket];
+      Work->Bucket[Bucket] = Work->EntryCount++;
+      CopyGuid (&Entry->Name, &Hob.Guid->Name);
+    }
+
+    Entry->Count++;
+  }
+
+  //
+  // Lay the offsets of each GUID out after the ones of the GUIDs before it,
+  // then fill them in HOB list order.
+  //
+  First = 0;
+  for (Entry = Work->Entry; Entry < &Work->Entry[Work->EntryCount]; Entry++) {
+    Entry->First = First;
+    First       += Entry->Count;
+    Entry->Count = 0;
+  }
+
+  Offset = EDKII_HOB_INDEX_OFFSETS (Work);
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Entry                                 = CoreFindHobIndexEntry (Work, &Hob.Guid->Name);
+      Offset[Entry->First + Entry->Count++] = (UINT32)(Hob.Raw - (UINT8 *)HobStart);
+    }
+  }
+
+  //
+  // Drop the unused entries of the worst case.
+  //
+  Table = AllocateCopyPool (
+            (UINTN)((UINT8 *)&Offset[HobCount] - (UINT8 *)Work),
+            Work
+            );
+  FreePool (Work);
+  if (Table == NULL) {
+    return NULL;
+  }
+
+  DEBUG ((DEBUG_INFO, "HOB index: %d GUIDed HOBs, %d GUIDs\n", Table->HobCount, Table->EntryCount));
+  return Table;
+}
@@ -3,6 +3,7 @@
 
 Copyright (c) 2015 HP Development Company, L.P.
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -243,6 +244,335 @@ FileHandleToVolume (
   return NULL;
 }
 
+/**
+  Walk the files of a memory mapped FFS2/FFS3 firmware volume for its file index.
+
+  The files are checked as FindFileEx() checks them, and the deleted files as
+  the DXE Core checks them, so that the index holds exactly the files either
+  core would find by walking the FV.
+
+  @param FwVolHeader     Pointer to the FV header.
+  @param FileIndex       The file index to fill in the entries of, or NULL to
+                         check and count the files only.
+  @param FileCount       Returns the number of files in the index.
+
+  @retval TRUE           All the files of the FV are intact.
+  @retval FALSE          The FV can't be indexed.
+
+**/
+STATIC
+BOOLEAN
+WalkFfsFileIndex (
+  IN     EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader,
+  IN OUT EDKII_FFS_FILE_INDEX        *FileIndex  OPTIONAL,
+  OUT    UINT32                      *FileCount
+  )
+{
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FwVolExtHeader;
+  EFI_FFS_FILE_HEADER             *FfsFileHeader;
+  EDKII_FFS_FILE_INDEX_ENTRY      *Entry;
+  UINT32                          FileLength;
+  UINT32                          FileOccupiedSize;
+  UINT32                          HeaderSize;
+  UINT64                          FileOffset;
+  UINT8                           ErasePolarity;
+  UINT8                           EraseByte;
+  UINT8                           FileState;
+  UINT8                           DataCheckSum;
+  UINTN                           Index;
+  BOOLEAN                         IsFfs3Fv;
+
+  IsFfs3Fv = CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid);
+
+  if ((FwVolHeader->Attributes & EFI_FVB2_ERASE_POLARITY) != 0) {
+    ErasePolarity = 1;
+    EraseByte     = 0xFF;
+  } else {
+    ErasePolarity = 0;
+    EraseByte     = 0;
+  }
+
+  if (FwVolHeader->ExtHeaderOffset != 0) {
+    FwVolExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *)((UINT8 *)FwVolHeader + FwVolHeader->ExtHeaderOffset);
+    FfsFileHeader  = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolExtHeader + FwVolExtHeader->ExtHeaderSize);
+  } else {
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + FwVolHeader->HeaderLength);
+  }
+
+  FfsFileHeader = (EFI_FFS_FILE_HEADER *)ALIGN_POINTER (FfsFileHeader, 8);
+  FileOffset    = (UINT64)((UINT8 *)FfsFileHeader - (UINT8 *)FwVolHeader);
+  *FileCount    = 0;
+
+  while (FileOffset + sizeof (EFI_FFS_FILE_HEADER) <= FwVolHeader->FvLength) {
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FwVolHeader + FileOffset);
+    FileState     = GetFileState (ErasePolarity, FfsFileHeader);
+    switch (FileState) {
+      case EFI_FILE_HEADER_CONSTRUCTION:
+      case EFI_FILE_HEADER_INVALID:
+        if (IS_FFS_FILE2 (FfsFileHeader)) {
+          FileOffset += sizeof (EFI_FFS_FILE_HEADER2);
+        } else {
+          FileOffset += sizeof (EFI_FFS_FILE_HEADER);
+        }
+
+        continue;
+
+      case EFI_FILE_DATA_VALID:
+      case EFI_FILE_MARKED_FOR_UPDATE:
+      case EFI_FILE_DELETED:
+        break;
+
+      case 0:
+        //
+        // The rest of the FV is free space only if the whole header is erased.
+        //
+        for (Index = 0; Index < sizeof (EFI_FFS_FILE_HEADER); Index++) {
+          if (((UINT8 *)FfsFileHeader)[Index] != EraseByte) {
+            return FALSE;
+          }
+        }
+
+        return TRUE;
+
+      default:
+        return FALSE;
+    }
+
+    if (CalculateHeaderChecksum (FfsFileHeader) != 0) {
+      return FALSE;
+    }
+
+    if (IS_FFS_FILE2 (FfsFileHeader)) {
+      FileLength = FFS_FILE2_SIZE (FfsFileHeader);
+      HeaderSize = sizeof (EFI_FFS_FILE_HEADER2);
+    } else {
+      FileLength = FFS_FILE_SIZE (FfsFileHeader);
+      HeaderSize = sizeof (EFI_FFS_FILE_HEADER);
+    }
+
+    if ((FileLength < HeaderSize) || (FileOffset + FileLength > FwVolHeader->FvLength)) {
+      return FALSE;
+    }
+
+    if (FileIndex == NULL) {
+      DataCheckSum = FFS_FIXED_CHECKSUM;
+      if ((FfsFileHeader->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+        DataCheckSum = CalculateCheckSum8 ((CONST UINT8 *)FfsFileHeader + HeaderSize, FileLength - HeaderSize);
+      }
+
+      if (FfsFileHeader->IntegrityCheck.Checksum.File != DataCheckSum) {
+        return FALSE;
+      }
+    }
+
+    //
+    // Both cores skip the deleted files, and the FFS3 files in an FFS2 FV.
+    //
+    if ((FileState != EFI_FILE_DELETED) && (IsFfs3Fv || !IS_FFS_FILE2 (FfsFileHeader))) {
+      if (FileIndex != NULL) {
+        Entry = &FileIndex->Entry[*FileCount];
+        CopyGuid (&Entry->Name, &FfsFileHeader->Name);
+        Entry->Offset = (UINT32)FileOffset;
+        Entry->Size   = FileLength;
+        Entry->Next   = EDKII_FFS_FILE_INDEX_END;
+        Entry->Type   = FfsFileHeader->Type;
+      }
+
+      (*FileCount)++;
+    }
+
+    FileOccupiedSize = GET_OCCUPIED_SIZE (FileLength, 8);
+    FileOffset      += FileOccupiedSize;
+  }
+
+  return TRUE;
+}
+
+/**
+  Build the file index of a firmware volume registered in the PEI Core.
+
+  The index is built in a GUIDed HOB, so that the DXE Core gets it too. An FV
+  that isn't handled by the built-in FV PPIs, or that has a file which isn't
+  intact, isn't indexed and is searched by walking its files. No FV is indexed
+  if PcdPeiCoreFfsFileIndex is FALSE.
+
+  @param CoreFvHandle    The FV registered in the PEI Core.
+
+  @return The file index of the FV, or NULL if the FV isn't indexed.
+
+**/
+STATIC
+EDKII_FFS_FILE_INDEX *
+BuildFfsFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FwVolHeader;
+  EFI_HOB_GUID_TYPE           *GuidHob;
+  EDKII_FFS_FILE_INDEX        *FileIndex;
+  EDKII_FFS_FILE_INDEX_ENTRY  *Entry;
+  EFI_STATUS                  Status;
+  UINTN                       IndexSize;
+  UINT32                      FileCount;
+  UINT32                      EntryIndex;
+  UINT32                      *Bucket;
+
+  if (!PcdGetBool (PcdPeiCoreFfsFileIndex)) {
+    return NULL;
+  }
+
+  if ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)) {
+    return NULL;
+  }
+
+  FwVolHeader = CoreFvHandle->FvHeader;
+  if (FwVolHeader->FvLength > MAX_UINT32) {
+    return NULL;
+  }
+
+  if (!WalkFfsFileIndex (FwVolHeader, NULL, &FileCount)) {
+    DEBUG ((DEBUG_WARN, "The FV %p is not indexed, it has files that are not intact.\n", FwVolHeader));
+    return NULL;
+  }
+
+  IndexSize = OFFSET_OF (EDKII_FFS_FILE_INDEX, Entry) + FileCount * sizeof (EDKII_FFS_FILE_INDEX_ENTRY);
+  if (IndexSize > 0xFFF8 - sizeof (EFI_HOB_GUID_TYPE)) {
+    DEBUG ((DEBUG_INFO, "The FV %p is not indexed, it has too many files.\n", FwVolHeader));
+    return NULL;
+  }
+
+  //
+  // Create the HOB through the PEI services, which don't assert when the
+  // temporary memory is short of space for the index.
+  //
+  Status = PeiServicesCreateHob (EFI_HOB_TYPE_GUID_EXTENSION, (UINT16)(sizeof (EFI_HOB_GUID_TYPE) + IndexSize), (VOID **)&GuidHob);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  CopyGuid (&GuidHob->Name, &gEdkiiFfsFileIndexHobGuid);
+  FileIndex           = (EDKII_FFS_FILE_INDEX *)(GuidHob + 1);
+  FileIndex->FvBase   = (EFI_PHYSICAL_ADDRESS)(UINTN)FwVolHeader;
+  FileIndex->FvLength = FwVolHeader->FvLength;
+  FileIndex->Reserved = 0;
+  WalkFfsFileIndex (FwVolHeader, FileIndex, &FileIndex->FileCount);
+  ASSERT (FileIndex->FileCount == FileCount);
+
+  //
+  // Chain the entries of each bucket in FV order, starting from the last entry.
+  //
+  SetMem32 (FileIndex->Bucket, sizeof (FileIndex->Bucket), EDKII_FFS_FILE_INDEX_END);
+  for (EntryIndex = FileCount; EntryIndex > 0; EntryIndex--) {
+    Entry       = &FileIndex->Entry[EntryIndex - 1];
+    Bucket      = &FileIndex->Bucket[EDKII_FFS_FILE_INDEX_BUCKET (&Entry->Name)];
+    Entry->Next = *Bucket;
+    *Bucket     = EntryIndex - 1;
+  }
+
+  DEBUG ((DEBUG_INFO, "Indexed %d files of the FV %p\n", FileCount, FwVolHeader));
+  return FileIndex;
+}
+
+/**
+  Search the file index of a firmware volume, as FindFileEx() searches the files
+  of the FV.
+
+  @param FileIndex       The file index of the FV.
+  @param FvHandle        Pointer to the FV header of the volume to search
+  @param FileName        File name
+  @param SearchType      Filter to find only files of this type.
+                         Type EFI_FV_FILETYPE_ALL causes no filtering to be done.
+  @param FileHandle      This parameter must point to a valid FFS volume.
+  @param AprioriFile     Pointer to AprioriFile image in this FV if has
+
+  @return EFI_NOT_FOUND  No files matching the search criteria were found
+  @retval EFI_SUCCESS    Success to search given file
+
+**/
+STATIC
+EFI_STATUS
+FindFileInIndex (
+  IN        EDKII_FFS_FILE_INDEX  *FileIndex,
+  IN  CONST EFI_PEI_FV_HANDLE     FvHandle,
+  IN  CONST EFI_GUID              *FileName    OPTIONAL,
+  IN        EFI_FV_FILETYPE       SearchType,
+  IN OUT    EFI_PEI_FILE_HANDLE   *FileHandle,
+  IN OUT    EFI_PEI_FILE_HANDLE   *AprioriFile  OPTIONAL
+  )
+{
+  EFI_FFS_FILE_HEADER         **FileHeader;
+  EDKII_FFS_FILE_INDEX_ENTRY  *Entry;
+  UINT32                      EntryIndex;
+  UINT32                      Low;
+  UINT32                      High;
+  UINT32                      FileOffset;
+
+  FileHeader = (EFI_FFS_FILE_HEADER **)FileHandle;
+  Entry      = FileIndex->Entry;
+
+  if (FileName != NULL) {
+    EntryIndex = FileIndex->Bucket[EDKII_FFS_FILE_INDEX_BUCKET (FileName)];
+    while (EntryIndex != EDKII_FFS_FILE_INDEX_END) {
+      if (CompareGuid (&Entry[EntryIndex].Name, FileName)) {
+        *FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FvHandle + Entry[EntryIndex].Offset);
+        return EFI_SUCCESS;
+      }
+
+      EntryIndex = Entry[EntryIndex].Next;
+    }
+
+    *FileHeader = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Continue after the file at FileHeader, found by a binary search on the
+  // file offsets.
+  //
+  Low = 0;
+  if (*FileHeader != NULL) {
+    FileOffset = (UINT32)((UINT8 *)*FileHeader - (UINT8 *)FvHandle);
+    High       = FileIndex->FileCount;
+    while (Low < High) {
+      EntryIndex = Low + (High - Low) / 2;
+      if (Entry[EntryIndex].Offset <= FileOffset) {
+        Low = EntryIndex + 1;
+      } else {
+        High = EntryIndex;
+      }
+    }
+  }
+
+  for (EntryIndex = Low; EntryIndex < FileIndex->FileCount; EntryIndex++) {
+    if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      if ((Entry[EntryIndex].Type == EFI_FV_FILETYPE_PEIM) ||
+          (Entry[EntryIndex].Type == EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER) ||
+          (Entry[EntryIndex].Type == EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE))
+      {
+        break;
+      } else if (AprioriFile != NULL) {
+        if (Entry[EntryIndex].Type == EFI_FV_FILETYPE_FREEFORM) {
+          if (CompareGuid (&Entry[EntryIndex].Name, &gPeiAprioriFileNameGuid)) {
+            *AprioriFile = (EFI_PEI_FILE_HANDLE)((UINT8 *)FvHandle + Entry[EntryIndex].Offset);
+          }
+        }
+      }
+    } else if (((SearchType == Entry[EntryIndex].Type) || (SearchType == EFI_FV_FILETYPE_ALL)) &&
+               (Entry[EntryIndex].Type != EFI_FV_FILETYPE_FFS_PAD))
+    {
+      break;
+    }
+  }
+
+  if (EntryIndex == FileIndex->FileCount) {
+    *FileHeader = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  *FileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FvHandle + Entry[EntryIndex].Offset);
+  return EFI_SUCCESS;
+}
+
 /**
   Given the input file pointer, search for the first matching file in the
   FFS volume as defined by SearchType. The search starts from FileHeader inside
@@ -283,6 +613,16 @@ FindFileEx (
   UINT8                           FileState;
   UINT8                           DataCheckSum;
   BOOLEAN                         IsFfs3Fv;
+  PEI_CORE_FV_HANDLE              *CoreFvHandle;
+
+  //
+  // Search the file index of the FV instead of reading the FFS headers, if
+  // the FV has one.
+  //
+  CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+  if ((CoreFvHandle != NULL) && (CoreFvHandle->FileIndex != NULL)) {
+    return FindFileInIndex (CoreFvHandle->FileIndex, FvHandle, FileName, SearchType, FileHandle, AprioriFile);
+  }
 
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -517,6 +857,7 @@ PeiInitializeFv (
   PrivateData->Fv[PrivateData->FvCount].FvPpi                = FvPpi;
   PrivateData->Fv[PrivateData->FvCount].FvHandle             = FvHandle;
   PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = 0;
+  PrivateData->Fv[PrivateData->FvCount].FileIndex            = BuildFfsFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
   DEBUG ((
     DEBUG_INFO,
     "The %dth FV start address is 0x%11p, size is 0x%08x, handle is 0x%p\n",
@@ -658,6 +999,7 @@ FirmwareVolumeInfoPpiNotifyCallback (
     PrivateData->Fv[PrivateData->FvCount].FvPpi                = FvPpi;
     PrivateData->Fv[PrivateData->FvCount].FvHandle             = FvHandle;
     PrivateData->Fv[PrivateData->FvCount].AuthenticationStatus = FvInfo2Ppi.AuthenticationStatus;
+    PrivateData->Fv[PrivateData->FvCount].FileIndex            = BuildFfsFileIndex (&PrivateData->Fv[PrivateData->FvCount]);
     CurFvCount                                                 = PrivateData->FvCount;
     DEBUG ((
       DEBUG_INFO,
@@ -2,6 +2,7 @@
   EFI PEI Core memory services
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -208,7 +209,7 @@ RemoveFvHobsInTemporaryMemory (
 
 /**
   Migrate the base address in firmware volume allocation HOBs
-  from temporary memory to PEI installed memory.
+  and FFS file index HOBs from temporary memory to PEI installed memory.
 
   @param[in] PrivateData      Pointer to PeiCore's private data structure.
   @param[in] OrgFvHandle      Address of FV Handle in temporary memory.
@@ -226,6 +227,7 @@ ConvertFvHob (
   EFI_HOB_FIRMWARE_VOLUME   *FirmwareVolumeHob;
   EFI_HOB_FIRMWARE_VOLUME2  *FirmwareVolume2Hob;
   EFI_HOB_FIRMWARE_VOLUME3  *FirmwareVolume3Hob;
+  EDKII_FFS_FILE_INDEX      *FileIndex;
 
   DEBUG ((DEBUG_INFO, "Converting FVs in FV HOB.\n"));
 
@@ -245,6 +247,11 @@ ConvertFvHob (
       if (FirmwareVolume3Hob->BaseAddress == OrgFvHandle) {
         FirmwareVolume3Hob->BaseAddress = FvHandle;
       }
+    } else if ((GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) && CompareGuid (&Hob.Guid->Name, &gEdkiiFfsFileIndexHobGuid)) {
+      FileIndex = GET_GUID_HOB_DATA (Hob.Guid);
+      if (FileIndex->FvBase == OrgFvHandle) {
+        FileIndex->FvBase = FvHandle;
+      }
     }
   }
 }
@@ -2,6 +2,7 @@
   Definition of Pei Core Structures and Services
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -31,6 +32,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
 #include <Library/PerformanceLib.h>
+#include <Library/TimerLib.h>
 #include <Library/PeiServicesLib.h>
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/PeCoffLib.h>
@@ -45,6 +47,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
+#include <Guid/FfsFileIndex.h>
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -68,21 +71,55 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP  32
 #define DISPATCH_NOTIFY_GROWTH_STEP  8
 
+///
+/// The PPI and notify descriptors are hashed on their GUID. The MaxCount
+/// entries of a list are followed, in the same allocation, by a hash link per
+/// entry, so the links move with the list when it grows or is migrated to
+/// permanent memory. The links hold entry indexes plus one, so that a zeroed
+/// PPI database is empty, and no pointer: ConvertPpiPointers() and
+/// ConvertPpiPointersFv() leave them valid.
+///
+#define PPI_HASH_BITS     5
+#define PPI_HASH_BUCKETS  (1 << PPI_HASH_BITS)
+
+typedef struct {
+  ///
+  /// Next PPI of the same bucket in install order, plus one, or 0. Not used
+  /// by the notify lists.
+  ///
+  UINT16    Next;
+  ///
+  /// Hash bucket of the GUID.
+  ///
+  UINT8     Hash;
+  UINT8     Reserved;
+} PEI_PPI_HASH_LINK;
+
+///
+/// The hash links of a list of MaxCount entries.
+///
+#define PPI_HASH_LINKS(Ptrs, MaxCount)  ((PEI_PPI_HASH_LINK *)&(Ptrs)[(MaxCount)])
+
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
   UINTN                    LastDispatchedCount;
   ///
-  /// MaxCount number of entries.
+  /// MaxCount number of entries, followed by their hash links.
   ///
   PEI_PPI_LIST_POINTERS    *PpiPtrs;
+  ///
+  /// First and last PPI of each hash bucket, plus one, or 0.
+  ///
+  UINT16                   HashHead[PPI_HASH_BUCKETS];
+  UINT16                   HashTail[PPI_HASH_BUCKETS];
 } PEI_PPI_LIST;
 
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
   ///
-  /// MaxCount number of entries.
+  /// MaxCount number of entries, followed by their hash links.
   ///
   PEI_PPI_LIST_POINTERS    *NotifyPtrs;
 } PEI_CALLBACK_NOTIFY_LIST;
@@ -92,11 +129,25 @@ typedef struct {
   UINTN                    MaxCount;
   UINTN                    LastDispatchedCount;
   ///
-  /// MaxCount number of entries.
+  /// MaxCount number of entries, followed by their hash links.
   ///
   PEI_PPI_LIST_POINTERS    *NotifyPtrs;
 } PEI_DISPATCH_NOTIFY_LIST;
 
+///
+/// Time spent in the PPI database, when performance measurement is enabled,
+/// in performance counter ticks. The time of the notification functions
+/// isn't counted.
+///
+typedef struct {
+  BOOLEAN    Enabled;
+  BOOLEAN    CountUp;
+  UINT64     LocateCount;
+  UINT64     LocateTicks;
+  UINT64     NotifyCount;
+  UINT64     NotifyTicks;
+} PEI_PPI_STATISTICS;
+
 ///
 /// PPI database structure which contains three links:
 /// PpiList, CallbackNotifyList and DispatchNotifyList.
@@ -114,6 +165,7 @@ typedef struct {
   /// Notify List at callback level.
   ///
   PEI_DISPATCH_NOTIFY_LIST    DispatchNotifyList;
+  PEI_PPI_STATISTICS          Statistics;
 } PEI_PPI_DATABASE;
 
 //
@@ -146,6 +198,10 @@ typedef struct {
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // Pointer to the file index of the FV in the HOB list, or NULL.
+  //
+  EDKII_FFS_FILE_INDEX           *FileIndex;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -658,6 +714,21 @@ ProcessDispatchNotifyList (
   IN PEI_CORE_INSTANCE  *PrivateData
   );
 
+/**
+  Report the time spent in the PPI database since the last report, as a
+  performance record for the locates and another for the notify processing,
+  both ending now, and reset the counters.
+
+  @param PrivateData        PeiCore's private data structure.
+  @param Phase              Name of the PEI phase the time was spent in.
+
+**/
+VOID
+ReportPpiStatistics (
+  IN PEI_CORE_INSTANCE  *PrivateData,
+  IN CONST CHAR8        *Phase
+  );
+
 /**
 
   Process notifications.
@@ -1059,7 +1130,7 @@ RemoveFvHobsInTemporaryMemory (
 
 /**
   Migrate the base address in firmware volume allocation HOBs
-  from temporary memory to PEI installed memory.
+  and FFS file index HOBs from temporary memory to PEI installed memory.
 
   @param[in] PrivateData      Pointer to PeiCore's private data structure.
   @param[in] OrgFvHandle      Address of FV Handle in temporary memory.
@@ -2,6 +2,7 @@
   Pei Core Main Entry Point
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
@@ -178,6 +179,8 @@ PeiCore (
   EFI_HOB_HANDOFF_INFO_TABLE      *HandoffInformationTable;
   EFI_PEI_TEMPORARY_RAM_DONE_PPI  *TemporaryRamDonePpi;
   UINTN                           Index;
+  UINT64                          StartValue;
+  UINT64                          EndValue;
 
   //
   // Retrieve context passed into PEI Core
@@ -236,6 +239,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (EDKII_FFS_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex + OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
@@ -271,6 +278,10 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *)((UINT8 *)OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+
+          if (OldCoreData->Fv[Index].FileIndex != NULL) {
+            OldCoreData->Fv[Index].FileIndex = (EDKII_FFS_FILE_INDEX *)((UINT8 *)OldCoreData->Fv[Index].FileIndex - OldCoreData->HeapOffset);
+          }
         }
 
         OldCoreData->TempFileGuid    = (EFI_GUID *)((UINT8 *)OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
@@ -405,7 +416,17 @@ PeiCore (
     //
     PERF_CROSSMODULE_BEGIN ("PEI");
     PERF_INMODULE_BEGIN ("PreMem");
+
+    //
+    // Count the time spent in the PPI database too.
+    //
+    PrivateData.PpiData.Statistics.Enabled = PerformanceMeasurementEnabled ();
+    if (PrivateData.PpiData.Statistics.Enabled) {
+      GetPerformanceCounterProperties (&StartValue, &EndValue);
+      PrivateData.PpiData.Statistics.CountUp = (BOOLEAN)(EndValue >= StartValue);
+    }
   } else {
+    ReportPpiStatistics (&PrivateData, "PreMem");
     PERF_INMODULE_END ("PreMem");
     PERF_INMODULE_BEGIN ("PostMem");
   }
@@ -498,6 +519,7 @@ PeiCore (
   //
   // Measure PEI Core execution time.
   //
+  ReportPpiStatistics (&PrivateData, "PostMem");
   PERF_INMODULE_END ("PostMem");
 
   //
@@ -2,12 +2,179 @@
   EFI PEI Core PPI services
 
 Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
 #include "PeiMain.h"
 
+/**
+  Compute the hash bucket of a PPI or notify GUID: the words of the GUID
+  folded and multiplied by the golden ratio.
+
+  @param Guid            The GUID.
+
+  @return The hash bucket.
+
+**/
+STATIC
+UINT8
+PpiGuidHash (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash = ((UINT32 *)Guid)[0] ^ ((UINT32 *)Guid)[1] ^ ((UINT32 *)Guid)[2] ^ ((UINT32 *)Guid)[3];
+  return (UINT8)((Hash * 0x9E3779B1) >> (32 - PPI_HASH_BITS));
+}
+
+/**
+  Link a PPI into the hash bucket of its GUID, keeping the bucket in install
+  order.
+
+  @param PpiListPointer  The PPI list.
+  @param Index           The index of the PPI in the list.
+
+**/
+STATIC
+VOID
+PpiHashInsert (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         Index
+  )
+{
+  PEI_PPI_HASH_LINK  *Links;
+  UINT8              Hash;
+  UINT16             Link;
+
+  ASSERT (Index < MAX_UINT16);
+
+  Links             = PPI_HASH_LINKS (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount);
+  Hash              = PpiGuidHash (PpiListPointer->PpiPtrs[Index].Ppi->Guid);
+  Links[Index].Hash = Hash;
+  Links[Index].Next = 0;
+
+  if ((PpiListPointer->HashTail[Hash] == 0) || (PpiListPointer->HashTail[Hash] <= Index)) {
+    //
+    // Append, the common case.
+    //
+    if (PpiListPointer->HashTail[Hash] == 0) {
+      PpiListPointer->HashHead[Hash] = (UINT16)(Index + 1);
+    } else {
+      Links[PpiListPointer->HashTail[Hash] - 1].Next = (UINT16)(Index + 1);
+    }
+
+    PpiListPointer->HashTail[Hash] = (UINT16)(Index + 1);
+    return;
+  }
+
+  if (PpiListPointer->HashHead[Hash] > Index) {
+    Links[Index].Next              = PpiListPointer->HashHead[Hash];
+    PpiListPointer->HashHead[Hash] = (UINT16)(Index + 1);
+    return;
+  }
+
+  for (Link = PpiListPointer->HashHead[Hash]; Links[Link - 1].Next <= Index; Link = Links[Link - 1].Next) {
+  }
+
+  Links[Index].Next    = Links[Link - 1].Next;
+  Links[Link - 1].Next = (UINT16)(Index + 1);
+}
+
+/**
+  Unlink a PPI from the hash bucket it is in.
+
+  @param PpiListPointer  The PPI list.
+  @param Index           The index of the PPI in the list.
+
+**/
+STATIC
+VOID
+PpiHashRemove (
+  IN PEI_PPI_LIST  *PpiListPointer,
+  IN UINTN         Index
+  )
+{
+  PEI_PPI_HASH_LINK  *Links;
+  UINT8              Hash;
+  UINT16             *Link;
+  UINT16             Previous;
+
+  Links    = PPI_HASH_LINKS (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount);
+  Hash     = Links[Index].Hash;
+  Previous = 0;
+  for (Link = &PpiListPointer->HashHead[Hash]; *Link != Index + 1; Link = &Links[*Link - 1].Next) {
+    ASSERT (*Link != 0);
+    Previous = *Link;
+  }
+
+  *Link = Links[Index].Next;
+  if (PpiListPointer->HashTail[Hash] == Index + 1) {
+    PpiListPointer->HashTail[Hash] = Previous;
+  }
+}
+
+/**
+  Grow a PPI or notify list, with its hash links.
+
+  @param Ptrs            The entries of the list.
+  @param MaxCount        The number of entries of the list.
+  @param GrowthStep      The number of entries to add.
+
+  @return The entries of the grown list.
+
+**/
+STATIC
+PEI_PPI_LIST_POINTERS *
+GrowPpiListPointers (
+  IN PEI_PPI_LIST_POINTERS  *Ptrs,
+  IN UINTN                  MaxCount,
+  IN UINTN                  GrowthStep
+  )
+{
+  PEI_PPI_LIST_POINTERS  *TempPtr;
+
+  TempPtr = AllocateZeroPool (
+              (sizeof (PEI_PPI_LIST_POINTERS) + sizeof (PEI_PPI_HASH_LINK)) * (MaxCount + GrowthStep)
+              );
+  ASSERT (TempPtr != NULL);
+  if (MaxCount != 0) {
+    CopyMem (TempPtr, Ptrs, sizeof (PEI_PPI_LIST_POINTERS) * MaxCount);
+    CopyMem (
+      PPI_HASH_LINKS (TempPtr, MaxCount + GrowthStep),
+      PPI_HASH_LINKS (Ptrs, MaxCount),
+      sizeof (PEI_PPI_HASH_LINK) * MaxCount
+      );
+  }
+
+  return TempPtr;
+}
+
+/**
+  Add the ticks elapsed since a performance counter value to a PPI database
+  time counter.
+
+  @param Statistics      The PPI database statistics.
+  @param Ticks           The time counter.
+  @param Start           The performance counter value.
+
+**/
+STATIC
+VOID
+PpiStatisticsAddTicks (
+  IN     PEI_PPI_STATISTICS  *Statistics,
+  IN OUT UINT64              *Ticks,
+  IN     UINT64              Start
+  )
+{
+  UINT64  End;
+
+  End     = GetPerformanceCounter ();
+  *Ticks += Statistics->CountUp ? End - Start : Start - End;
+}
+
 /**
 
   Migrate Pointer from the temporary memory to PEI installed memory.
@@ -165,6 +332,11 @@ ConvertPpiPointers (
 {
   UINT8  Index;
 
+  //
+  // The hash links of the PPI database are indexes and hashes of the GUID
+  // values, they need no conversion.
+  //
+
   //
   // Convert normal PPIs.
   //
@@ -456,7 +628,6 @@ InternalPeiInstallPpi (
   PEI_PPI_LIST       *PpiListPointer;
   UINTN              Index;
   UINTN              LastCount;
-  VOID               *TempPtr;
 
   if (PpiList == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -490,16 +661,7 @@ InternalPeiInstallPpi (
       //
       // Run out of room, grow the buffer.
       //
-      TempPtr = AllocateZeroPool (
-                  sizeof (PEI_PPI_LIST_POINTERS) * (PpiListPointer->MaxCount + PPI_GROWTH_STEP)
-                  );
-      ASSERT (TempPtr != NULL);
-      CopyMem (
-        TempPtr,
-        PpiListPointer->PpiPtrs,
-        sizeof (PEI_PPI_LIST_POINTERS) * PpiListPointer->MaxCount
-        );
-      PpiListPointer->PpiPtrs  = TempPtr;
+      PpiListPointer->PpiPtrs  = GrowPpiListPointers (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount, PPI_GROWTH_STEP);
       PpiListPointer->MaxCount = PpiListPointer->MaxCount + PPI_GROWTH_STEP;
     }
 
@@ -528,6 +690,10 @@ InternalPeiInstallPpi (
     PpiList++;
   }
 
+  for (Index = LastCount; Index < PpiListPointer->CurrentCount; Index++) {
+    PpiHashInsert (PpiListPointer, Index);
+  }
+
   //
   // Process any callback level notifies for newly installed PPIs.
   //
@@ -624,7 +790,9 @@ PeiReInstallPpi (
   // Replace the old PPI with the new one.
   //
   DEBUG ((DEBUG_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
+  PpiHashRemove (&PrivateData->PpiData.PpiList, Index);
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  PpiHashInsert (&PrivateData->PpiData.PpiList, Index);
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -668,17 +836,31 @@ PeiLocatePpi (
   )
 {
   PEI_CORE_INSTANCE       *PrivateData;
-  UINTN                   Index;
+  PEI_PPI_LIST            *PpiListPointer;
+  PEI_PPI_HASH_LINK       *Links;
+  PEI_PPI_STATISTICS      *Statistics;
+  UINT64                  Start;
+  UINT16                  Link;
   EFI_GUID                *CheckGuid;
   EFI_PEI_PPI_DESCRIPTOR  *TempPtr;
 
-  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PrivateData    = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  PpiListPointer = &PrivateData->PpiData.PpiList;
+  Statistics     = &PrivateData->PpiData.Statistics;
+
+  Start = 0;
+  if (Statistics->Enabled) {
+    Start = GetPerformanceCounter ();
+    Statistics->LocateCount++;
+  }
 
   //
-  // Search the data base for the matching instance of the GUIDed PPI.
+  // Search the hash bucket of the GUID for the matching instance of the
+  // GUIDed PPI, the bucket is in install order.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
-    TempPtr   = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
+  Links = PPI_HASH_LINKS (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount);
+  for (Link = PpiListPointer->HashHead[PpiGuidHash (Guid)]; Link != 0; Link = Links[Link - 1].Next) {
+    TempPtr   = PpiListPointer->PpiPtrs[Link - 1].Ppi;
     CheckGuid = TempPtr->Guid;
 
     //
@@ -700,6 +882,10 @@ PeiLocatePpi (
           *Ppi = TempPtr->Ppi;
         }
 
+        if (Statistics->Enabled) {
+          PpiStatisticsAddTicks (Statistics, &Statistics->LocateTicks, Start);
+        }
+
         return EFI_SUCCESS;
       }
 
@@ -707,6 +893,10 @@ PeiLocatePpi (
     }
   }
 
+  if (Statistics->Enabled) {
+    PpiStatisticsAddTicks (Statistics, &Statistics->LocateTicks, Start);
+  }
+
   return EFI_NOT_FOUND;
 }
 
@@ -741,7 +931,7 @@ InternalPeiNotifyPpi (
   PEI_DISPATCH_NOTIFY_LIST  *DispatchNotifyListPointer;
   UINTN                     DispatchNotifyIndex;
   UINTN                     LastDispatchNotifyCount;
-  VOID                      *TempPtr;
+  PEI_PPI_HASH_LINK         *NotifyLinks;
 
   if (NotifyList == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -779,20 +969,17 @@ InternalPeiNotifyPpi (
         //
         // Run out of room, grow the buffer.
         //
-        TempPtr = AllocateZeroPool (
-                    sizeof (PEI_PPI_LIST_POINTERS) * (CallbackNotifyListPointer->MaxCount + CALLBACK_NOTIFY_GROWTH_STEP)
-                    );
-        ASSERT (TempPtr != NULL);
-        CopyMem (
-          TempPtr,
-          CallbackNotifyListPointer->NotifyPtrs,
-          sizeof (PEI_PPI_LIST_POINTERS) * CallbackNotifyListPointer->MaxCount
-          );
-        CallbackNotifyListPointer->NotifyPtrs = TempPtr;
-        CallbackNotifyListPointer->MaxCount   = CallbackNotifyListPointer->MaxCount + CALLBACK_NOTIFY_GROWTH_STEP;
+        CallbackNotifyListPointer->NotifyPtrs = GrowPpiListPointers (
+                                                  CallbackNotifyListPointer->NotifyPtrs,
+                                                  CallbackNotifyListPointer->MaxCount,
+                                                  CALLBACK_NOTIFY_GROWTH_STEP
+                                                  );
+        CallbackNotifyListPointer->MaxCount = CallbackNotifyListPointer->MaxCount + CALLBACK_NOTIFY_GROWTH_STEP;
       }
 
       CallbackNotifyListPointer->NotifyPtrs[CallbackNotifyIndex].Notify = (EFI_PEI_NOTIFY_DESCRIPTOR *)NotifyList;
+      NotifyLinks                                                       = PPI_HASH_LINKS (CallbackNotifyListPointer->NotifyPtrs, CallbackNotifyListPointer->MaxCount);
+      NotifyLinks[CallbackNotifyIndex].Hash                             = PpiGuidHash (NotifyList->Guid);
       CallbackNotifyIndex++;
       CallbackNotifyListPointer->CurrentCount++;
     } else {
@@ -800,20 +987,17 @@ InternalPeiNotifyPpi (
         //
         // Run out of room, grow the buffer.
         //
-        TempPtr = AllocateZeroPool (
-                    sizeof (PEI_PPI_LIST_POINTERS) * (DispatchNotifyListPointer->MaxCount + DISPATCH_NOTIFY_GROWTH_STEP)
-                    );
-        ASSERT (TempPtr != NULL);
-        CopyMem (
-          TempPtr,
-          DispatchNotifyListPointer->NotifyPtrs,
-          sizeof (PEI_PPI_LIST_POINTERS) * DispatchNotifyListPointer->MaxCount
-          );
-        DispatchNotifyListPointer->NotifyPtrs = TempPtr;
-        DispatchNotifyListPointer->MaxCount   = DispatchNotifyListPointer->MaxCount + DISPATCH_NOTIFY_GROWTH_STEP;
+        DispatchNotifyListPointer->NotifyPtrs = GrowPpiListPointers (
+                                                  DispatchNotifyListPointer->NotifyPtrs,
+                                                  DispatchNotifyListPointer->MaxCount,
+                                                  DISPATCH_NOTIFY_GROWTH_STEP
+                                                  );
+        DispatchNotifyListPointer->MaxCount = DispatchNotifyListPointer->MaxCount + DISPATCH_NOTIFY_GROWTH_STEP;
       }
 
       DispatchNotifyListPointer->NotifyPtrs[DispatchNotifyIndex].Notify = (EFI_PEI_NOTIFY_DESCRIPTOR *)NotifyList;
+      NotifyLinks                                                       = PPI_HASH_LINKS (DispatchNotifyListPointer->NotifyPtrs, DispatchNotifyListPointer->MaxCount);
+      NotifyLinks[DispatchNotifyIndex].Hash                             = PpiGuidHash (NotifyList->Guid);
       DispatchNotifyIndex++;
       DispatchNotifyListPointer->CurrentCount++;
     }
@@ -966,47 +1150,170 @@ ProcessNotify (
   IN INTN               NotifyStopIndex
   )
 {
+  PEI_PPI_LIST               *PpiListPointer;
+  PEI_PPI_LIST_POINTERS      *NotifyPtrs;
+  PEI_PPI_HASH_LINK          *Links;
+  PEI_PPI_STATISTICS         *Statistics;
+  UINT64                     Start;
+  UINT32                     HashMask;
+  UINT8                      Hash;
+  UINT16                     Link;
   INTN                       Index1;
   INTN                       Index2;
   EFI_GUID                   *SearchGuid;
   EFI_GUID                   *CheckGuid;
   EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor;
 
+  PpiListPointer = &PrivateData->PpiData.PpiList;
+  Statistics     = &PrivateData->PpiData.Statistics;
+
+  Start = 0;
+  if (Statistics->Enabled) {
+    Start = GetPerformanceCounter ();
+    Statistics->NotifyCount++;
+  }
+
+  //
+  // When only a few PPIs are installed, skip the notifies whose GUID is in
+  // none of their hash buckets without walking the buckets.
+  //
+  HashMask = MAX_UINT32;
+  if (InstallStopIndex - InstallStartIndex <= PPI_HASH_BUCKETS) {
+    Links    = PPI_HASH_LINKS (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount);
+    HashMask = 0;
+    for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
+      HashMask |= 1u << Links[Index2].Hash;
+    }
+  }
+
   for (Index1 = NotifyStartIndex; Index1 < NotifyStopIndex; Index1++) {
+    //
+    // The notify lists may grow in a notify function, get them again.
+    //
     if (NotifyType == EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK) {
-      NotifyDescriptor = PrivateData->PpiData.CallbackNotifyList.NotifyPtrs[Index1].Notify;
+      NotifyPtrs = PrivateData->PpiData.CallbackNotifyList.NotifyPtrs;
+      Links      = PPI_HASH_LINKS (NotifyPtrs, PrivateData->PpiData.CallbackNotifyList.MaxCount);
     } else {
-      NotifyDescriptor = PrivateData->PpiData.DispatchNotifyList.NotifyPtrs[Index1].Notify;
+      NotifyPtrs = PrivateData->PpiData.DispatchNotifyList.NotifyPtrs;
+      Links      = PPI_HASH_LINKS (NotifyPtrs, PrivateData->PpiData.DispatchNotifyList.MaxCount);
+    }
+
+    Hash = Links[Index1].Hash;
+    if ((HashMask & (1u << Hash)) == 0) {
+      continue;
     }
 
-    CheckGuid = NotifyDescriptor->Guid;
+    NotifyDescriptor = NotifyPtrs[Index1].Notify;
+    CheckGuid        = NotifyDescriptor->Guid;
+
+    //
+    // The hash bucket of the GUID is in install order, so stop at the end of
+    // the install range.
+    //
+    Link = PpiListPointer->HashHead[Hash];
+    while ((Link != 0) && ((INTN)Link <= InstallStopIndex)) {
+      Index2 = Link - 1;
+      if (Index2 >= InstallStartIndex) {
+        SearchGuid = PpiListPointer->PpiPtrs[Index2].Ppi->Guid;
+        //
+        // Don't use CompareGuid function here for performance reasons.
+        // Instead we compare the GUID as INT32 at a time and branch
+        // on the first failed comparison.
+        //
+        if ((((INT32 *)SearchGuid)[0] == ((INT32 *)CheckGuid)[0]) &&
+            (((INT32 *)SearchGuid)[1] == ((INT32 *)CheckGuid)[1]) &&
+            (((INT32 *)SearchGuid)[2] == ((INT32 *)CheckGuid)[2]) &&
+            (((INT32 *)SearchGuid)[3] == ((INT32 *)CheckGuid)[3]))
+        {
+          DEBUG ((
+            DEBUG_INFO,
+            "Notify: PPI Guid: %g, Peim notify entry point: %p\n",
+            SearchGuid,
+            NotifyDescriptor->Notify
+            ));
+          if (Statistics->Enabled) {
+            PpiStatisticsAddTicks (Statistics, &Statistics->NotifyTicks, Start);
+          }
+
+          NotifyDescriptor->Notify (
+                              (EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
+                              NotifyDescriptor,
+                              (PpiListPointer->PpiPtrs[Index2].Ppi)->Ppi
+                              );
+
+          if (Statistics->Enabled) {
+            Start = GetPerformanceCounter ();
+          }
+        }
+      }
 
-    for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
-      SearchGuid = PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi->Guid;
       //
-      // Don't use CompareGuid function here for performance reasons.
-      // Instead we compare the GUID as INT32 at a time and branch
-      // on the first failed comparison.
+      // The notify function may have installed or reinstalled PPIs. Go on
+      // with the next PPI of the bucket after this one.
       //
-      if ((((INT32 *)SearchGuid)[0] == ((INT32 *)CheckGuid)[0]) &&
-          (((INT32 *)SearchGuid)[1] == ((INT32 *)CheckGuid)[1]) &&
-          (((INT32 *)SearchGuid)[2] == ((INT32 *)CheckGuid)[2]) &&
-          (((INT32 *)SearchGuid)[3] == ((INT32 *)CheckGuid)[3]))
-      {
-        DEBUG ((
-          DEBUG_INFO,
-          "Notify: PPI Guid: %g, Peim notify entry point: %p\n",
-          SearchGuid,
-          NotifyDescriptor->Notify
-          ));
-        NotifyDescriptor->Notify (
-                            (EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
-                            NotifyDescriptor,
-                            (PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi)->Ppi
-                            );
+      Links = PPI_HASH_LINKS (PpiListPointer->PpiPtrs, PpiListPointer->MaxCount);
+      if (Links[Index2].Hash == Hash) {
+        Link = Links[Index2].Next;
+      } else {
+        for (Link = PpiListPointer->HashHead[Hash]; (Link != 0) && ((INTN)Link <= Index2 + 1); Link = Links[Link - 1].Next) {
+        }
       }
     }
   }
+
+  if (Statistics->Enabled) {
+    PpiStatisticsAddTicks (Statistics, &Statistics->NotifyTicks, Start);
+  }
+}
+
+/**
+  Report the time spent in the PPI database since the last report, as a
+  performance record for the locates and another for the notify processing,
+  both ending now, and reset the counters.
+
+  @param PrivateData        PeiCore's private data structure.
+  @param Phase              Name of the PEI phase the time was spent in.
+
+**/
+VOID
+ReportPpiStatistics (
+  IN PEI_CORE_INSTANCE  *PrivateData,
+  IN CONST CHAR8        *Phase
+  )
+{
+  PEI_PPI_STATISTICS  *Statistics;
+  UINT64              End;
+
+  Statistics = &PrivateData->PpiData.Statistics;
+  if (!Statistics->Enabled) {
+    return;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "PPI database in %a: %ld locates in %ld ns, %ld notify passes in %ld ns\n",
+    Phase,
+    Statistics->LocateCount,
+    GetTimeInNanoSecond (Statistics->LocateTicks),
+    Statistics->NotifyCount,
+    GetTimeInNanoSecond (Statistics->NotifyTicks)
+    ));
+
+  End = GetPerformanceCounter ();
+  if (Statistics->LocateTicks != 0) {
+    PERF_START (NULL, "PpiLocate", Phase, Statistics->CountUp ? End - Statistics->LocateTicks : End + Statistics->LocateTicks);
+    PERF_END (NULL, "PpiLocate", Phase, End);
+  }
+
+  if (Statistics->NotifyTicks != 0) {
+    PERF_START (NULL, "PpiNotify", Phase, Statistics->CountUp ? End - Statistics->NotifyTicks : End + Statistics->NotifyTicks);
+    PERF_END (NULL, "PpiNotify", Phase, End);
+  }
+
+  Statistics->LocateCount = 0;
+  Statistics->LocateTicks = 0;
+  Statistics->NotifyCount = 0;
+  Statistics->NotifyTicks = 0;
 }
 
 /**
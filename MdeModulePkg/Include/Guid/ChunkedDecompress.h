@@ -0,0 +1,46 @@
+/** @file
+  Chunked LZMA/Brotli custom decompress algorithm Guid and section format definitions.
+
+  The data of a chunked compressed GUIDed section starts with a
+  CHUNKED_DECOMPRESS_HEADER, followed by ChunkCount complete GUIDed sections,
+  each of them 4-byte aligned. Every inner section carries the GUID of a legacy
+  single stream algorithm (LZMA, LZMA with X86 converter or Brotli) and decodes
+  to ChunkSize bytes, except for the last one which decodes to the remainder of
+  DecodedSize. The chunks are independent of each other, so they can be decoded
+  in parallel.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CHUNKED_DECOMPRESS_GUID_H__
+#define __CHUNKED_DECOMPRESS_GUID_H__
+
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents are independent LZMA compressed chunks.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0x516095F4, 0x1753, 0x4DFF, { 0x80, 0xA4, 0x98, 0x86, 0x7A, 0xF9, 0x42, 0xC4 } }
+
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents are independent Brotli compressed chunks.
+///
+#define BROTLI_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0xF69E4A4F, 0x0C47, 0x443C, { 0x9A, 0xAE, 0x39, 0xEA, 0xD8, 0x97, 0x2A, 0xF2 } }
+
+#define CHUNKED_DECOMPRESS_SIGNATURE  SIGNATURE_32 ('C', 'C', 'H', 'K')
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    ChunkCount;
+  UINT32    ChunkSize;
+  UINT32    DecodedSize;
+} CHUNKED_DECOMPRESS_HEADER;
+
+extern GUID  gLzmaChunkedCustomDecompressGuid;
+extern GUID  gBrotliChunkedCustomDecompressGuid;
+
+#endif
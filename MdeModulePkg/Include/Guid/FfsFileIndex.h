@@ -0,0 +1,70 @@
+/** @file
+  Index of the FFS files in a firmware volume.
+
+  If PcdPeiCoreFfsFileIndex is TRUE, the PEI Core builds an EDKII_FFS_FILE_INDEX
+  in a GUIDed HOB for each memory mapped FFS2/FFS3 firmware volume it registers. The index records the name,
+  type and location of every file of the FV, in FV order, with the entries
+  chained in hash buckets on the file name. Files can then be found without
+  reading their FFS headers from the FV again. The DXE Core uses the index to
+  build its file list of the same FV, and walks the FV when there is no index.
+
+  Only an FV whose files are all intact is indexed, so an index entry doesn't
+  need the file checksums verified again.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_FFS_FILE_INDEX_GUID_H__
+#define __EDKII_FFS_FILE_INDEX_GUID_H__
+
+#define EDKII_FFS_FILE_INDEX_HOB_GUID \
+  { \
+    0x3699095b, 0xbfde, 0x495b, { 0x9a, 0x60, 0x16, 0xc5, 0x6f, 0xc2, 0x66, 0x02 } \
+  }
+
+///
+/// Number of hash buckets, a power of two.
+///
+#define EDKII_FFS_FILE_INDEX_BUCKETS  64
+
+///
+/// Ends a hash chain.
+///
+#define EDKII_FFS_FILE_INDEX_END  0xFFFFFFFF
+
+///
+/// The hash bucket of a file name. The name may be unaligned.
+///
+#define EDKII_FFS_FILE_INDEX_BUCKET(Name) \
+  ((ReadUnaligned32 ((CONST UINT32 *)(Name)) ^ ReadUnaligned32 ((CONST UINT32 *)(Name) + 3)) & (EDKII_FFS_FILE_INDEX_BUCKETS - 1))
+
+typedef struct {
+  EFI_GUID    Name;
+  UINT32      Offset;         // offset of the FFS file header in the FV
+  UINT32      Size;           // file size, including the FFS file header
+  UINT32      Next;           // next entry in the same bucket, or EDKII_FFS_FILE_INDEX_END
+  UINT8       Type;
+  UINT8       Reserved[3];
+} EDKII_FFS_FILE_INDEX_ENTRY;
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS          FvBase;
+  UINT64                        FvLength;
+  UINT32                        FileCount;
+  UINT32                        Reserved;
+  ///
+  /// First entry of each hash bucket, or EDKII_FFS_FILE_INDEX_END. The
+  /// entries of a bucket are chained in FV order.
+  ///
+  UINT32                        Bucket[EDKII_FFS_FILE_INDEX_BUCKETS];
+  ///
+  /// FileCount entries, in FV order.
+  ///
+  EDKII_FFS_FILE_INDEX_ENTRY    Entry[1];
+} EDKII_FFS_FILE_INDEX;
+
+extern EFI_GUID  gEdkiiFfsFileIndexHobGuid;
+
+#endif // #ifndef __EDKII_FFS_FILE_INDEX_GUID_H__
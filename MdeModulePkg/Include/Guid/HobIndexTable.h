@@ -0,0 +1,84 @@
+/** @file
+  Index of the GUIDed HOBs of the HOB list.
+
+  The DXE Core builds an EDKII_HOB_INDEX_TABLE of the HOB list it is handed
+  and installs it in the EFI System Configuration Table, next to the HOB list
+  itself. The table lists, for each GUID found in a GUIDed HOB, the offsets
+  of all the GUIDed HOBs with that GUID in HOB list order, with the GUIDs
+  chained in hash buckets. A HobLib instance can then find the GUIDed HOBs
+  without walking the HOB list from the start on every call.
+
+  The HOB list is not extended after the DXE Core entry, so the index stays
+  complete. A HOB may still be marked unused later, so a HOB found through the
+  index has its type and GUID checked again.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_HOB_INDEX_TABLE_GUID_H__
+#define __EDKII_HOB_INDEX_TABLE_GUID_H__
+
+#define EDKII_HOB_INDEX_TABLE_GUID \
+  { \
+    0xb11d9598, 0x58cb, 0x49a6, { 0x91, 0x32, 0x0c, 0x7e, 0xae, 0x6e, 0x3f, 0xd8 } \
+  }
+
+///
+/// Number of hash buckets.
+///
+#define EDKII_HOB_INDEX_BUCKET_BITS  7
+#define EDKII_HOB_INDEX_BUCKETS      (1 << EDKII_HOB_INDEX_BUCKET_BITS)
+
+///
+/// Ends a hash chain.
+///
+#define EDKII_HOB_INDEX_END  0xFFFFFFFF
+
+///
+/// The hash bucket of a GUID: the words of the GUID folded and multiplied by
+/// the golden ratio, so that GUIDs differing in a few bits only spread over
+/// the buckets. The GUID may be unaligned.
+///
+#define EDKII_HOB_INDEX_BUCKET(Guid) \
+  ((UINT32)((ReadUnaligned32 ((CONST UINT32 *)(Guid)) ^ ReadUnaligned32 ((CONST UINT32 *)(Guid) + 1) ^ \
+             ReadUnaligned32 ((CONST UINT32 *)(Guid) + 2) ^ ReadUnaligned32 ((CONST UINT32 *)(Guid) + 3)) * 0x9E3779B1) >> \
+   (32 - EDKII_HOB_INDEX_BUCKET_BITS))
+
+typedef struct {
+  EFI_GUID    Name;
+  UINT32      First;          // index in the offset array of the first HOB with the GUID
+  UINT32      Count;          // number of GUIDed HOBs with the GUID
+  UINT32      Next;           // next entry in the same bucket, or EDKII_HOB_INDEX_END
+  UINT32      Reserved;
+} EDKII_HOB_INDEX_ENTRY;
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS     HobList;
+  ///
+  /// Length of the HOB list, including the end of list HOB.
+  ///
+  UINT64                   HobListLength;
+  UINT32                   EntryCount;
+  UINT32                   HobCount;
+  ///
+  /// First entry of each hash bucket, or EDKII_HOB_INDEX_END.
+  ///
+  UINT32                   Bucket[EDKII_HOB_INDEX_BUCKETS];
+  ///
+  /// EntryCount entries, followed by the offset array: HobCount UINT32
+  /// offsets from HobList, grouped by GUID and in HOB list order within a
+  /// group.
+  ///
+  EDKII_HOB_INDEX_ENTRY    Entry[1];
+} EDKII_HOB_INDEX_TABLE;
+
+///
+/// The offset array of an index table.
+///
+#define EDKII_HOB_INDEX_OFFSETS(Table)  ((UINT32 *)&(Table)->Entry[(Table)->EntryCount])
+
+extern EFI_GUID  gEdkiiHobIndexTableGuid;
+
+#endif // #ifndef __EDKII_HOB_INDEX_TABLE_GUID_H__
@@ -0,0 +1,97 @@
+/** @file
+  EDKII PE Image Digest Cache Protocol.
+
+  The Authenticode digest of a PE/COFF image is computed by the image
+  verification for Secure Boot, and again by the TCG measurement for every
+  active PCR bank. This protocol lets the handlers invoked for the same
+  EFI_SECURITY2_ARCH_PROTOCOL.FileAuthentication() call share the digests
+  they compute.
+
+  The digests are only kept while the image is being authenticated. They are
+  only returned for the FileBuffer, FileSize and File passed to the ongoing
+  FileAuthentication() call.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef PE_IMAGE_DIGEST_CACHE_H_
+#define PE_IMAGE_DIGEST_CACHE_H_
+
+#include <Protocol/DevicePath.h>
+#include <IndustryStandard/Tpm20.h>
+
+#define EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL_GUID \
+  { 0x5b4744f4, 0x7c61, 0x4b80, { 0x9a, 0xc9, 0x1f, 0xb9, 0x2b, 0x50, 0x35, 0xa1 } }
+
+typedef struct _EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL;
+
+/**
+  Get the Authenticode digest of the image being authenticated.
+
+  @param[in]      This            Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]      FileBuffer      The image buffer.
+  @param[in]      FileSize        The size of the image buffer.
+  @param[in]      File            The device path of the image.
+  @param[in]      HashAlgorithm   The hash algorithm, a TPM_ALG_ID value.
+  @param[out]     Digest          The digest of the image.
+  @param[in, out] DigestSize      On input, the size of Digest. On output, the size
+                                  of the digest.
+
+  @retval EFI_SUCCESS             The digest is returned.
+  @retval EFI_NOT_FOUND           The digest isn't cached, or the image isn't the
+                                  one being authenticated.
+  @retval EFI_BUFFER_TOO_SMALL    Digest is too small, DigestSize is updated.
+  @retval EFI_INVALID_PARAMETER   DigestSize is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PE_IMAGE_DIGEST_CACHE_GET)(
+  IN     EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN     CONST VOID                            *FileBuffer,
+  IN     UINTN                                 FileSize,
+  IN     CONST EFI_DEVICE_PATH_PROTOCOL        *File OPTIONAL,
+  IN     TPM_ALG_ID                            HashAlgorithm,
+  OUT    UINT8                                 *Digest,
+  IN OUT UINTN                                 *DigestSize
+  );
+
+/**
+  Cache the Authenticode digest of the image being authenticated.
+
+  @param[in]  This            Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]  FileBuffer      The image buffer.
+  @param[in]  FileSize        The size of the image buffer.
+  @param[in]  File            The device path of the image.
+  @param[in]  HashAlgorithm   The hash algorithm, a TPM_ALG_ID value.
+  @param[in]  Digest          The digest of the image.
+  @param[in]  DigestSize      The size of the digest.
+
+  @retval EFI_SUCCESS             The digest is cached.
+  @retval EFI_NOT_STARTED         The image isn't the one being authenticated.
+  @retval EFI_INVALID_PARAMETER   Digest is NULL, or DigestSize is too large.
+  @retval EFI_OUT_OF_RESOURCES    There is no room left for the digest.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PE_IMAGE_DIGEST_CACHE_SET)(
+  IN EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN CONST VOID                            *FileBuffer,
+  IN UINTN                                 FileSize,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL        *File OPTIONAL,
+  IN TPM_ALG_ID                            HashAlgorithm,
+  IN CONST UINT8                           *Digest,
+  IN UINTN                                 DigestSize
+  );
+
+struct _EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL {
+  EDKII_PE_IMAGE_DIGEST_CACHE_GET    GetDigest;
+  EDKII_PE_IMAGE_DIGEST_CACHE_SET    SetDigest;
+};
+
+extern EFI_GUID  gEdkiiPeImageDigestCacheProtocolGuid;
+
+#endif
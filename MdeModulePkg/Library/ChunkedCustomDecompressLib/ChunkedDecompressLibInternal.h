@@ -0,0 +1,105 @@
+/** @file
+  Internal include file for the chunked LZMA/Brotli GUIDed section extraction library.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CHUNKED_DECOMPRESS_LIB_INTERNAL_H__
+#define __CHUNKED_DECOMPRESS_LIB_INTERNAL_H__
+
+#include <PiPei.h>
+#include <Guid/ChunkedDecompress.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+#include <Library/SynchronizationLib.h>
+
+//
+// Maximum number of processors decoding the chunks of one section. Each of
+// them needs its own copy of the scratch buffer of the inner algorithm.
+//
+#define CHUNKED_DECOMPRESS_MAX_WORKERS  8
+
+typedef struct {
+  CONST VOID                               *Section;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER    Decode;
+  UINT8                                    *Output;
+  UINT32                                   OutputSize;
+  UINT32                                   AuthenticationStatus;
+  RETURN_STATUS                            Status;
+} CHUNKED_DECOMPRESS_CHUNK;
+
+typedef struct {
+  CHUNKED_DECOMPRESS_CHUNK    *Chunks;
+  UINT32                      ChunkCount;
+  UINT8                       *Scratch;
+  UINT32                      ScratchSize;
+  UINT32                      WorkerCount;
+  volatile UINT32             NextChunk;
+  volatile UINT32             NextWorker;
+  volatile UINT32             Failed;
+} CHUNKED_DECOMPRESS_CONTEXT;
+
+/**
+  Decode chunks of the section described by Context until none is left.
+
+  Chunks are claimed one at a time, so any number of processors can run this
+  concurrently as long as each of them uses its own scratch buffer slot. Only
+  the inner decode handlers resolved by the BSP are used, never PEI or boot
+  services.
+
+  @param[in, out] Context  The chunked decompression context.
+  @param[in]      Worker   The index of the scratch buffer slot to use.
+
+**/
+VOID
+ChunkedDecompressRun (
+  IN OUT CHUNKED_DECOMPRESS_CONTEXT  *Context,
+  IN     UINT32                      Worker
+  );
+
+/**
+  AP procedure decoding chunks of the section described by Buffer.
+
+  It claims a free scratch buffer slot and runs ChunkedDecompressRun(). Slot 0
+  is reserved for the BSP. APs finding no free slot return immediately.
+
+  @param[in, out] Buffer   Pointer to the CHUNKED_DECOMPRESS_CONTEXT.
+
+**/
+VOID
+EFIAPI
+ChunkedDecompressWorker (
+  IN OUT VOID  *Buffer
+  );
+
+/**
+  Return the number of processors that can decode chunks in parallel,
+  including the BSP.
+
+  @return The number of enabled processors, or 1 if MP services are not available.
+
+**/
+UINTN
+ChunkedDecompressGetProcessorCount (
+  VOID
+  );
+
+/**
+  Run ChunkedDecompressRun() on the BSP and ChunkedDecompressWorker() on as
+  many APs as available until all chunks of Context are decoded.
+
+  If the APs can not be started, the BSP decodes all chunks by itself.
+
+  @param[in, out] Context  The chunked decompression context.
+
+**/
+VOID
+ChunkedDecompressDispatch (
+  IN OUT CHUNKED_DECOMPRESS_CONTEXT  *Context
+  );
+
+#endif
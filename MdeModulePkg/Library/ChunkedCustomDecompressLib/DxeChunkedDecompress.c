@@ -0,0 +1,138 @@
+/** @file
+  Dispatch the decoding of the chunks of a chunked compressed section to the
+  APs with the MP Services Protocol.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ChunkedDecompressLibInternal.h"
+#include <Protocol/MpService.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+/**
+  Locate the MP Services Protocol.
+
+  The APs are only used below TPL_NOTIFY, the completion of non-blocking
+  requests is detected by the MP services from a timer event.
+
+  @return The MP Services Protocol, or NULL if it is not installed yet or
+          can not be used at the current TPL.
+
+**/
+STATIC
+EFI_MP_SERVICES_PROTOCOL *
+GetMpServices (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  EFI_TPL                   Tpl;
+
+  if (gBS == NULL) {
+    return NULL;
+  }
+
+  Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  gBS->RestoreTPL (Tpl);
+  if (Tpl >= TPL_NOTIFY) {
+    return NULL;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  return MpServices;
+}
+
+/**
+  Return the number of processors that can decode chunks in parallel,
+  including the BSP.
+
+  @return The number of enabled processors, or 1 if MP services are not available.
+
+**/
+UINTN
+ChunkedDecompressGetProcessorCount (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+
+  MpServices = GetMpServices ();
+  if (MpServices == NULL) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  return NumberOfEnabledProcessors;
+}
+
+/**
+  Run ChunkedDecompressRun() on the BSP and ChunkedDecompressWorker() on as
+  many APs as available until all chunks of Context are decoded.
+
+  If the APs can not be started, the BSP decodes all chunks by itself.
+
+  @param[in, out] Context  The chunked decompression context.
+
+**/
+VOID
+ChunkedDecompressDispatch (
+  IN OUT CHUNKED_DECOMPRESS_CONTEXT  *Context
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  EFI_EVENT                 Event;
+
+  Event      = NULL;
+  MpServices = GetMpServices ();
+  if (MpServices != NULL) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &Event);
+    if (!EFI_ERROR (Status)) {
+      //
+      // Non-blocking, so that the BSP decodes chunks too.
+      //
+      Status = MpServices->StartupAllAPs (
+                             MpServices,
+                             ChunkedDecompressWorker,
+                             FALSE,
+                             Event,
+                             0,
+                             Context,
+                             NULL
+                             );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_INFO, "ChunkedDecompress: APs not started - %r\n", Status));
+        gBS->CloseEvent (Event);
+        Event = NULL;
+      }
+    }
+  }
+
+  ChunkedDecompressRun (Context, 0);
+
+  //
+  // Context lives on the stack of the caller, wait until all APs are done
+  // with it.
+  //
+  if (Event != NULL) {
+    while (gBS->CheckEvent (Event) == EFI_NOT_READY) {
+      CpuPause ();
+    }
+
+    gBS->CloseEvent (Event);
+  }
+}
@@ -0,0 +1,510 @@
+/** @file
+  Chunked LZMA/Brotli Decompress GUIDed Section Extraction Library.
+
+  A chunked section holds a number of complete GUIDed sections of the legacy
+  single stream algorithms, each of them decoding to a fixed size chunk of the
+  output. The chunks are decoded in parallel on the available processors with
+  the handlers registered for the inner GUIDs, so the LZMA and Brotli
+  decompression libraries must be linked to the same module.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ChunkedDecompressLibInternal.h"
+
+/**
+  Check whether a GUID identifies a chunked compressed section.
+
+  @param[in] Guid   The GUID to check.
+
+  @retval TRUE   Guid is one of the chunked custom decompress GUIDs.
+  @retval FALSE  Guid is not a chunked custom decompress GUID.
+
+**/
+STATIC
+BOOLEAN
+IsChunkedDecompressGuid (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  return (BOOLEAN)(CompareGuid (Guid, &gLzmaChunkedCustomDecompressGuid) ||
+                   CompareGuid (Guid, &gBrotliChunkedCustomDecompressGuid));
+}
+
+/**
+  Locate and validate the chunked section header of a GUIDed section.
+
+  @param[in]  InputSection      A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] Header            The chunked section header.
+  @param[out] DataSize          The size of the section data, starting at Header.
+  @param[out] SectionAttribute  The attributes of the GUIDed section.
+
+  @retval RETURN_SUCCESS            The header is valid.
+  @retval RETURN_INVALID_PARAMETER  The section is not a well formed chunked section.
+
+**/
+STATIC
+RETURN_STATUS
+ChunkedSectionGetHeader (
+  IN  CONST VOID                        *InputSection,
+  OUT CONST CHUNKED_DECOMPRESS_HEADER  **Header,
+  OUT UINT32                            *DataSize,
+  OUT UINT16                            *SectionAttribute
+  )
+{
+  CONST EFI_GUID  *Guid;
+  UINT32          SectionSize;
+  UINT16          DataOffset;
+
+  if (IS_SECTION2 (InputSection)) {
+    Guid              = &((EFI_GUID_DEFINED_SECTION2 *)InputSection)->SectionDefinitionGuid;
+    SectionSize       = SECTION2_SIZE (InputSection);
+    DataOffset        = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->DataOffset;
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION2 *)InputSection)->Attributes;
+  } else {
+    Guid              = &((EFI_GUID_DEFINED_SECTION *)InputSection)->SectionDefinitionGuid;
+    SectionSize       = SECTION_SIZE (InputSection);
+    DataOffset        = ((EFI_GUID_DEFINED_SECTION *)InputSection)->DataOffset;
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION *)InputSection)->Attributes;
+  }
+
+  if (!IsChunkedDecompressGuid (Guid)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((DataOffset > SectionSize) || (SectionSize - DataOffset < sizeof (CHUNKED_DECOMPRESS_HEADER))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Header   = (CONST CHUNKED_DECOMPRESS_HEADER *)((CONST UINT8 *)InputSection + DataOffset);
+  *DataSize = SectionSize - DataOffset;
+
+  if (((*Header)->Signature != CHUNKED_DECOMPRESS_SIGNATURE) ||
+      ((*Header)->ChunkSize == 0) ||
+      ((*Header)->DecodedSize == 0) ||
+      ((*Header)->ChunkCount != ((UINT64)(*Header)->DecodedSize + (*Header)->ChunkSize - 1) / (*Header)->ChunkSize))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Return the next inner section of a chunked section together with its handlers
+  and the information reported by its GetInfo handler.
+
+  @param[in]      Header            The chunked section header.
+  @param[in]      DataSize          The size of the section data, starting at Header.
+  @param[in]      Index             The index of the chunk at Offset.
+  @param[in, out] Offset            On input, the offset of the chunk from Header.
+                                    On output, the offset of the next chunk.
+  @param[out]     Section           The inner GUIDed section.
+  @param[out]     Decode            The decode handler of the inner section.
+  @param[out]     ScratchSize       The scratch buffer size required by the inner section.
+
+  @retval RETURN_SUCCESS            The chunk is valid.
+  @retval RETURN_UNSUPPORTED        No handler is registered for the inner section GUID.
+  @retval RETURN_INVALID_PARAMETER  The chunk is not well formed.
+
+**/
+STATIC
+RETURN_STATUS
+ChunkedSectionGetChunk (
+  IN     CONST CHUNKED_DECOMPRESS_HEADER        *Header,
+  IN     UINT32                                 DataSize,
+  IN     UINT32                                 Index,
+  IN OUT UINT32                                 *Offset,
+  OUT    CONST VOID                             **Section,
+  OUT    EXTRACT_GUIDED_SECTION_DECODE_HANDLER  *Decode,
+  OUT    UINT32                                 *ScratchSize
+  )
+{
+  RETURN_STATUS                            Status;
+  CONST EFI_COMMON_SECTION_HEADER          *Chunk;
+  CONST EFI_GUID                           *Guid;
+  UINT32                                   ChunkSize;
+  UINT32                                   Remaining;
+  UINT32                                   OutputSize;
+  UINT32                                   ExpectedSize;
+  UINT16                                   Attributes;
+  EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER  GetInfo;
+
+  if ((*Offset > DataSize) || (DataSize - *Offset < sizeof (EFI_GUID_DEFINED_SECTION))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Remaining = DataSize - *Offset;
+  Chunk     = (CONST EFI_COMMON_SECTION_HEADER *)((CONST UINT8 *)Header + *Offset);
+  if (Chunk->Type != EFI_SECTION_GUID_DEFINED) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IS_SECTION2 (Chunk)) {
+    if (Remaining < sizeof (EFI_GUID_DEFINED_SECTION2)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    ChunkSize = SECTION2_SIZE (Chunk);
+    Guid      = &((EFI_GUID_DEFINED_SECTION2 *)Chunk)->SectionDefinitionGuid;
+    if (ChunkSize < sizeof (EFI_GUID_DEFINED_SECTION2)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  } else {
+    ChunkSize = SECTION_SIZE (Chunk);
+    Guid      = &((EFI_GUID_DEFINED_SECTION *)Chunk)->SectionDefinitionGuid;
+    if (ChunkSize < sizeof (EFI_GUID_DEFINED_SECTION)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  if (ChunkSize > Remaining) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // Chunks must not nest, the workers only decode one level.
+  //
+  if (IsChunkedDecompressGuid (Guid)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status = ExtractGuidedSectionGetHandlers (Guid, &GetInfo, Decode);
+  if (RETURN_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "ChunkedDecompress: no handler for chunk GUID %g\n", Guid));
+    return RETURN_UNSUPPORTED;
+  }
+
+  Status = GetInfo (Chunk, &OutputSize, ScratchSize, &Attributes);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Index < Header->ChunkCount - 1) {
+    ExpectedSize = Header->ChunkSize;
+  } else {
+    ExpectedSize = Header->DecodedSize - Header->ChunkSize * Index;
+  }
+
+  if (OutputSize != ExpectedSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Section = Chunk;
+  *Offset  = (UINT32)ALIGN_VALUE ((UINT64)*Offset + ChunkSize, 4);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode chunks of the section described by Context until none is left.
+
+  Chunks are claimed one at a time, so any number of processors can run this
+  concurrently as long as each of them uses its own scratch buffer slot. Only
+  the inner decode handlers resolved by the BSP are used, never PEI or boot
+  services.
+
+  @param[in, out] Context  The chunked decompression context.
+  @param[in]      Worker   The index of the scratch buffer slot to use.
+
+**/
+VOID
+ChunkedDecompressRun (
+  IN OUT CHUNKED_DECOMPRESS_CONTEXT  *Context,
+  IN     UINT32                      Worker
+  )
+{
+  CHUNKED_DECOMPRESS_CHUNK  *Chunk;
+  UINT32                    Index;
+  UINT8                     *Scratch;
+  VOID                      *Output;
+
+  ASSERT (Worker < Context->WorkerCount);
+
+  Scratch = Context->Scratch + (UINTN)Worker * Context->ScratchSize;
+
+  while (Context->Failed == 0) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->ChunkCount) {
+      break;
+    }
+
+    Chunk         = &Context->Chunks[Index];
+    Output        = Chunk->Output;
+    Chunk->Status = Chunk->Decode (Chunk->Section, &Output, Scratch, &Chunk->AuthenticationStatus);
+    if (RETURN_ERROR (Chunk->Status)) {
+      Context->Failed = 1;
+      break;
+    }
+
+    //
+    // The handler may point the output at the section data instead of
+    // copying it.
+    //
+    if (Output != Chunk->Output) {
+      CopyMem (Chunk->Output, Output, Chunk->OutputSize);
+    }
+  }
+}
+
+/**
+  AP procedure decoding chunks of the section described by Buffer.
+
+  It claims a free scratch buffer slot and runs ChunkedDecompressRun(). Slot 0
+  is reserved for the BSP. APs finding no free slot return immediately.
+
+  @param[in, out] Buffer   Pointer to the CHUNKED_DECOMPRESS_CONTEXT.
+
+**/
+VOID
+EFIAPI
+ChunkedDecompressWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  CHUNKED_DECOMPRESS_CONTEXT  *Context;
+  UINT32                      Worker;
+
+  Context = (CHUNKED_DECOMPRESS_CONTEXT *)Buffer;
+
+  Worker = InterlockedIncrement (&Context->NextWorker) - 1;
+  if (Worker < Context->WorkerCount) {
+    ChunkedDecompressRun (Context, Worker);
+  }
+}
+
+/**
+  Examines a GUIDed section and returns the size of the decoded buffer and the
+  size of an scratch buffer required to actually decode the data in a GUIDed section.
+
+  Examines a GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports,
+  then RETURN_UNSUPPORTED is returned.
+  If the required information can not be retrieved from InputSection,
+  then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports,
+  then the size required to hold the decoded buffer is returned in OututBufferSize,
+  the size of an optional scratch buffer is returned in ScratchSize, and the Attributes field
+  from EFI_GUID_DEFINED_SECTION header of InputSection is returned in SectionAttribute.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBufferSize is NULL, then ASSERT().
+  If ScratchBufferSize is NULL, then ASSERT().
+  If SectionAttribute is NULL, then ASSERT().
+
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+ChunkedGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  RETURN_STATUS                          Status;
+  CONST CHUNKED_DECOMPRESS_HEADER        *Header;
+  CONST VOID                             *Chunk;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER  Decode;
+  UINT32                                 DataSize;
+  UINT32                                 Offset;
+  UINT32                                 Index;
+  UINT32                                 ChunkScratchSize;
+  UINT32                                 MaxScratchSize;
+  UINT64                                 TotalScratchSize;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  Status = ChunkedSectionGetHeader (InputSection, &Header, &DataSize, SectionAttribute);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  MaxScratchSize = 0;
+  Offset         = sizeof (CHUNKED_DECOMPRESS_HEADER);
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Status = ChunkedSectionGetChunk (Header, DataSize, Index, &Offset, &Chunk, &Decode, &ChunkScratchSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    MaxScratchSize = MAX (MaxScratchSize, ChunkScratchSize);
+  }
+
+  //
+  // The scratch buffer holds the chunk table, followed by one scratch buffer
+  // of the inner algorithm per worker.
+  //
+  TotalScratchSize = ALIGN_VALUE ((UINT64)Header->ChunkCount * sizeof (CHUNKED_DECOMPRESS_CHUNK), 8) +
+                     MultU64x32 (ALIGN_VALUE ((UINT64)MaxScratchSize, 8), MIN (Header->ChunkCount, CHUNKED_DECOMPRESS_MAX_WORKERS));
+  if (TotalScratchSize > MAX_UINT32) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *OutputBufferSize  = Header->DecodedSize;
+  *ScratchBufferSize = (UINT32)TotalScratchSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompress a chunked LZMA/Brotli compressed GUIDed section into a caller allocated output buffer.
+
+  Decodes the GUIDed section specified by InputSection.
+  If GUID for InputSection does not match the GUID that this handler supports, then RETURN_UNSUPPORTED is returned.
+  If the data in InputSection can not be decoded, then RETURN_INVALID_PARAMETER is returned.
+  If the GUID of InputSection does match the GUID that this handler supports, then InputSection
+  is decoded into the buffer specified by OutputBuffer and the authentication status of this
+  decode operation is returned in AuthenticationStatus.  If the decoded buffer is identical to the
+  data in InputSection, then OutputBuffer is set to point at the data in InputSection.  Otherwise,
+  the decoded data will be placed in caller allocated buffer specified by OutputBuffer.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBuffer is NULL, then ASSERT().
+  If ScratchBuffer is NULL and this decode operation requires a scratch buffer, then ASSERT().
+  If AuthenticationStatus is NULL, then ASSERT().
+
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+                            See the definition of authentication status in the EFI_PEI_GUIDED_SECTION_EXTRACTION_PPI
+                            section of the PI Specification. EFI_AUTH_STATUS_PLATFORM_OVERRIDE must
+                            never be set by this handler.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_UNSUPPORTED        The section specified by InputSection does not match the GUID this handler supports.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+
+**/
+RETURN_STATUS
+EFIAPI
+ChunkedGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer         OPTIONAL,
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  RETURN_STATUS                    Status;
+  CONST CHUNKED_DECOMPRESS_HEADER  *Header;
+  CHUNKED_DECOMPRESS_CONTEXT       Context;
+  CHUNKED_DECOMPRESS_CHUNK         *Chunk;
+  UINT32                           DataSize;
+  UINT32                           Offset;
+  UINT32                           Index;
+  UINT32                           ChunkScratchSize;
+  UINT16                           Attributes;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+  ASSERT (ScratchBuffer != NULL);
+
+  *AuthenticationStatus = 0;
+
+  Status = ChunkedSectionGetHeader (InputSection, &Header, &DataSize, &Attributes);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (&Context, sizeof (Context));
+  Context.Chunks      = (CHUNKED_DECOMPRESS_CHUNK *)ScratchBuffer;
+  Context.ChunkCount  = Header->ChunkCount;
+  Context.Scratch     = (UINT8 *)ScratchBuffer + ALIGN_VALUE (Header->ChunkCount * sizeof (CHUNKED_DECOMPRESS_CHUNK), 8);
+  Context.WorkerCount = MIN (Header->ChunkCount, CHUNKED_DECOMPRESS_MAX_WORKERS);
+
+  //
+  // Resolve the handlers of all chunks on the BSP, the workers can not look
+  // them up.
+  //
+  Offset = sizeof (CHUNKED_DECOMPRESS_HEADER);
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Chunk  = &Context.Chunks[Index];
+    Status = ChunkedSectionGetChunk (Header, DataSize, Index, &Offset, &Chunk->Section, &Chunk->Decode, &ChunkScratchSize);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    Chunk->Output               = (UINT8 *)*OutputBuffer + (UINTN)Header->ChunkSize * Index;
+    Chunk->OutputSize           = (Index < Header->ChunkCount - 1) ? Header->ChunkSize : Header->DecodedSize - Header->ChunkSize * Index;
+    Chunk->AuthenticationStatus = 0;
+    Chunk->Status               = RETURN_NOT_STARTED;
+    Context.ScratchSize         = MAX (Context.ScratchSize, (UINT32)ALIGN_VALUE (ChunkScratchSize, 8));
+  }
+
+  Context.WorkerCount = (UINT32)MIN (Context.WorkerCount, ChunkedDecompressGetProcessorCount ());
+  Context.NextWorker  = 1;
+  if (Context.WorkerCount > 1) {
+    ChunkedDecompressDispatch (&Context);
+  } else {
+    ChunkedDecompressRun (&Context, 0);
+  }
+
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Chunk = &Context.Chunks[Index];
+    if (RETURN_ERROR (Chunk->Status) && (Chunk->Status != RETURN_NOT_STARTED)) {
+      return Chunk->Status;
+    }
+  }
+
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    Chunk = &Context.Chunks[Index];
+    if (RETURN_ERROR (Chunk->Status)) {
+      return Chunk->Status;
+    }
+
+    *AuthenticationStatus |= Chunk->AuthenticationStatus;
+  }
+
+  *AuthenticationStatus &= ~EFI_AUTH_STATUS_PLATFORM_OVERRIDE;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Register the chunked decompress handlers with the chunked LZMA and Brotli GUIDs.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+ChunkedDecompressLibConstructor (
+  VOID
+  )
+{
+  RETURN_STATUS  Status;
+
+  Status = ExtractGuidedSectionRegisterHandlers (
+             &gLzmaChunkedCustomDecompressGuid,
+             ChunkedGuidedSectionGetInfo,
+             ChunkedGuidedSectionExtraction
+             );
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  return ExtractGuidedSectionRegisterHandlers (
+           &gBrotliChunkedCustomDecompressGuid,
+           ChunkedGuidedSectionGetInfo,
+           ChunkedGuidedSectionExtraction
+           );
+}
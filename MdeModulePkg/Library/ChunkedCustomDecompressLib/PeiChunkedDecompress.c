@@ -0,0 +1,110 @@
+/** @file
+  Dispatch the decoding of the chunks of a chunked compressed section to the
+  APs with the PEI MP Services PPI.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "ChunkedDecompressLibInternal.h"
+#include <Ppi/MpServices.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+
+/**
+  Locate the PEI MP Services PPI.
+
+  @return The PEI MP Services PPI, or NULL if it is not installed yet.
+
+**/
+STATIC
+EFI_PEI_MP_SERVICES_PPI *
+GetMpServices (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  Status = PeiServicesLocatePpi (&gEfiPeiMpServicesPpiGuid, 0, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  return MpServices;
+}
+
+/**
+  Return the number of processors that can decode chunks in parallel,
+  including the BSP.
+
+  @return The number of enabled processors, or 1 if MP services are not available.
+
+**/
+UINTN
+ChunkedDecompressGetProcessorCount (
+  VOID
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+  UINTN                    NumberOfProcessors;
+  UINTN                    NumberOfEnabledProcessors;
+
+  MpServices = GetMpServices ();
+  if (MpServices == NULL) {
+    return 1;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         GetPeiServicesTablePointer (),
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors == 0)) {
+    return 1;
+  }
+
+  return NumberOfEnabledProcessors;
+}
+
+/**
+  Run ChunkedDecompressRun() on the BSP and ChunkedDecompressWorker() on as
+  many APs as available until all chunks of Context are decoded.
+
+  If the APs can not be started, the BSP decodes all chunks by itself.
+
+  @param[in, out] Context  The chunked decompression context.
+
+**/
+VOID
+ChunkedDecompressDispatch (
+  IN OUT CHUNKED_DECOMPRESS_CONTEXT  *Context
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  MpServices = GetMpServices ();
+  if (MpServices != NULL) {
+    //
+    // The PPI only has a blocking mode, the BSP picks up whatever the APs
+    // left over once they return.
+    //
+    Status = MpServices->StartupAllAPs (
+                           GetPeiServicesTablePointer (),
+                           MpServices,
+                           ChunkedDecompressWorker,
+                           FALSE,
+                           0,
+                           Context
+                           );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "ChunkedDecompress: APs not started - %r\n", Status));
+    }
+  }
+
+  ChunkedDecompressRun (Context, 0);
+}
@@ -0,0 +1,596 @@
+/** @file
+  Unit tests and lookup benchmark for the HOB index table of the DXE Core and
+  the HobLib instance that uses it.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiDxe.h>
+
+#include <Guid/HobList.h>
+#include <Guid/HobIndexTable.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#define UNIT_TEST_APP_NAME     "DXE HOB Index Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_HOBS          4096
+#define TEST_GUIDS         256
+#define BENCHMARK_LOOKUPS  10000
+
+///
+/// HOB counts the lookup benchmark is run with, with a GUID for every eight
+/// HOBs.
+///
+STATIC CONST UINTN  mBenchmarkHobs[] = { 64, 512, 2048, 8192 };
+
+extern VOID                   *mHobList;
+extern EDKII_HOB_INDEX_TABLE  *mHobIndexTable;
+
+EDKII_HOB_INDEX_TABLE *
+CoreBuildHobIndexTable (
+  IN VOID  *HobStart
+  );
+
+EFI_STATUS
+EFIAPI
+HobLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
+STATIC VOID                   *mTestHobList       = NULL;
+STATIC EDKII_HOB_INDEX_TABLE  *mTestHobIndexTable = NULL;
+STATIC UINT32                 mTestSeed           = 1;
+
+/**
+  Look up the HOB list and the HOB index table of the test, in place of the
+  EFI System Configuration Table.
+
+  @param[in]   TableGuid   The GUID of the table.
+  @param[out]  Table       The table, or NULL if there is none.
+
+  @retval EFI_SUCCESS      The table is found.
+  @retval EFI_NOT_FOUND    The table isn't installed.
+
+**/
+EFI_STATUS
+EFIAPI
+EfiGetSystemConfigurationTable (
+  IN  EFI_GUID  *TableGuid,
+  OUT VOID      **Table
+  )
+{
+  *Table = NULL;
+  if (CompareGuid (TableGuid, &gEfiHobListGuid)) {
+    *Table = mTestHobList;
+  } else if (CompareGuid (TableGuid, &gEdkiiHobIndexTableGuid)) {
+    *Table = mTestHobIndexTable;
+  }
+
+  return (*Table != NULL) ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+/**
+  Return a pseudo random number.
+
+  @return The number.
+
+**/
+STATIC
+UINT32
+TestRandom (
+  VOID
+  )
+{
+  mTestSeed = mTestSeed * 1103515245 + 12345;
+  return mTestSeed >> 8;
+}
+
+/**
+  Make the GUID of a GUIDed HOB. The GUIDs differ in a few bits only, like
+  the GUIDs generated one after the other.
+
+  @param[in]   Number      The number of the GUID.
+  @param[out]  Guid        The GUID.
+
+**/
+STATIC
+VOID
+TestMakeGuid (
+  IN  UINTN     Number,
+  OUT EFI_GUID  *Guid
+  )
+{
+  ZeroMem (Guid, sizeof (EFI_GUID));
+  Guid->Data1    = 0x1c3a6f3e;
+  Guid->Data2    = 0x2b4d;
+  Guid->Data3    = 0x4f0a;
+  Guid->Data4[0] = 0x8e;
+  Guid->Data4[6] = (UINT8)(Number >> 8);
+  Guid->Data4[7] = (UINT8)Number;
+}
+
+/**
+  Build a HOB list with the PHIT HOB, HobCount GUIDed and resource descriptor
+  HOBs in a random mix, and the end of list HOB.
+
+  @param[in]  HobCount     The number of HOBs after the PHIT HOB.
+  @param[in]  GuidCount    The number of GUIDs of the GUIDed HOBs.
+
+  @return The HOB list, or NULL if out of memory.
+
+**/
+STATIC
+VOID *
+TestBuildHobList (
+  IN UINTN  HobCount,
+  IN UINTN  GuidCount
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  VOID                  *HobList;
+  UINTN                 Index;
+  UINT16                Length;
+
+  HobList = AllocateZeroPool (sizeof (EFI_HOB_HANDOFF_INFO_TABLE) + HobCount * (sizeof (EFI_HOB_GUID_TYPE) + 64) + sizeof (EFI_HOB_GENERIC_HEADER));
+  if (HobList == NULL) {
+    return NULL;
+  }
+
+  Hob.Raw                              = HobList;
+  Hob.Header->HobType                  = EFI_HOB_TYPE_HANDOFF;
+  Hob.Header->HobLength                = sizeof (EFI_HOB_HANDOFF_INFO_TABLE);
+  Hob.HandoffInformationTable->Version = EFI_HOB_HANDOFF_TABLE_VERSION;
+  Hob.Raw                              = GET_NEXT_HOB (Hob);
+
+  for (Index = 0; Index < HobCount; Index++) {
+    if (TestRandom () % 4 == 0) {
+      Hob.Header->HobType   = EFI_HOB_TYPE_RESOURCE_DESCRIPTOR;
+      Hob.Header->HobLength = sizeof (EFI_HOB_RESOURCE_DESCRIPTOR);
+    } else {
+      Length                = (UINT16)(sizeof (EFI_HOB_GUID_TYPE) + (TestRandom () % 8) * 8);
+      Hob.Header->HobType   = EFI_HOB_TYPE_GUID_EXTENSION;
+      Hob.Header->HobLength = Length;
+      TestMakeGuid (TestRandom () % GuidCount, &Hob.Guid->Name);
+    }
+
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  Hob.Header->HobType   = EFI_HOB_TYPE_END_OF_HOB_LIST;
+  Hob.Header->HobLength = sizeof (EFI_HOB_GENERIC_HEADER);
+  return HobList;
+}
+
+/**
+  Build a HOB list and its index table, and construct the library with them.
+
+  @param[in]  HobCount     The number of HOBs after the PHIT HOB.
+  @param[in]  GuidCount    The number of GUIDs of the GUIDed HOBs.
+
+  @retval TRUE   The library uses the index table.
+  @retval FALSE  Out of memory.
+
+**/
+STATIC
+BOOLEAN
+TestSetupHobList (
+  IN UINTN  HobCount,
+  IN UINTN  GuidCount
+  )
+{
+  mTestHobList = TestBuildHobList (HobCount, GuidCount);
+  if (mTestHobList == NULL) {
+    return FALSE;
+  }
+
+  mTestHobIndexTable = CoreBuildHobIndexTable (mTestHobList);
+  if (mTestHobIndexTable == NULL) {
+    return FALSE;
+  }
+
+  mHobList = NULL;
+  HobLibConstructor (NULL, NULL);
+  return (BOOLEAN)(mHobIndexTable == mTestHobIndexTable);
+}
+
+/**
+  Free the HOB list and its index table, and reset the library.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+FreeHobList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mTestHobIndexTable != NULL) {
+    FreePool (mTestHobIndexTable);
+    mTestHobIndexTable = NULL;
+  }
+
+  if (mTestHobList != NULL) {
+    FreePool (mTestHobList);
+    mTestHobList = NULL;
+  }
+
+  mHobList       = NULL;
+  mHobIndexTable = NULL;
+}
+
+/**
+  Find a GUIDed HOB by walking the HOB list, with the index table put aside.
+
+  @param[in]  Guid         The GUID to match with in the HOB list.
+  @param[in]  HobStart     The starting HOB.
+
+  @return The matched GUID HOB, or NULL if there is none.
+
+**/
+STATIC
+VOID *
+TestWalkGuidHob (
+  IN CONST EFI_GUID  *Guid,
+  IN CONST VOID      *HobStart
+  )
+{
+  EDKII_HOB_INDEX_TABLE  *Table;
+  VOID                   *GuidHob;
+
+  Table          = mHobIndexTable;
+  mHobIndexTable = NULL;
+  GuidHob        = GetNextGuidHob (Guid, HobStart);
+  mHobIndexTable = Table;
+  return GuidHob;
+}
+
+/**
+  Check that each GUID is found from each HOB of the list as by the walk of
+  the HOB list.
+
+  @retval TRUE   The lookups match.
+  @retval FALSE  A lookup doesn't match.
+
+**/
+STATIC
+BOOLEAN
+TestCheckLookups (
+  VOID
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  EFI_GUID              Guid;
+  UINTN                 Number;
+
+  //
+  // Include a GUID that no HOB has.
+  //
+  for (Number = 0; Number <= TEST_GUIDS; Number++) {
+    TestMakeGuid (Number, &Guid);
+    if (GetFirstGuidHob (&Guid) != TestWalkGuidHob (&Guid, mTestHobList)) {
+      return FALSE;
+    }
+  }
+
+  for (Hob.Raw = mTestHobList; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    TestMakeGuid (TestRandom () % (TEST_GUIDS + 1), &Guid);
+    if (GetNextGuidHob (&Guid, Hob.Raw) != TestWalkGuidHob (&Guid, Hob.Raw)) {
+      return FALSE;
+    }
+
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      if (GetNextGuidHob (&Hob.Guid->Name, Hob.Raw) != Hob.Raw) {
+        return FALSE;
+      }
+
+      if (GetNextGuidHob (&Hob.Guid->Name, GET_NEXT_HOB (Hob)) != TestWalkGuidHob (&Hob.Guid->Name, GET_NEXT_HOB (Hob))) {
+        return FALSE;
+      }
+    }
+  }
+
+  //
+  // The end of list HOB is a starting HOB as well.
+  //
+  return (BOOLEAN)(GetNextGuidHob (&Guid, Hob.Raw) == NULL);
+}
+
+/**
+  The GUIDed HOBs are found through the index as by the walk of the HOB list.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GuidHobFindTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Index;
+  UINT32  *Offset;
+
+  UT_ASSERT_TRUE (TestSetupHobList (TEST_HOBS, TEST_GUIDS));
+
+  //
+  // The offsets of a GUID are in HOB list order.
+  //
+  Offset = EDKII_HOB_INDEX_OFFSETS (mHobIndexTable);
+  UT_ASSERT_TRUE (mHobIndexTable->EntryCount <= TEST_GUIDS);
+  for (Index = 0; Index < mHobIndexTable->EntryCount; Index++) {
+    UT_ASSERT_NOT_EQUAL (mHobIndexTable->Entry[Index].Count, 0);
+    UT_ASSERT_EQUAL (
+      (UINTN)GetFirstGuidHob (&mHobIndexTable->Entry[Index].Name),
+      (UINTN)mTestHobList + Offset[mHobIndexTable->Entry[Index].First]
+      );
+  }
+
+  UT_ASSERT_TRUE (TestCheckLookups ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The GUIDed HOBs marked unused after the index is built aren't found.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+UnusedHobTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  UINTN                 Index;
+
+  UT_ASSERT_TRUE (TestSetupHobList (TEST_HOBS, TEST_GUIDS));
+
+  Index = 0;
+  for (Hob.Raw = mTestHobList; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if ((GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) && (Index++ % 3 == 0)) {
+      Hob.Header->HobType = EFI_HOB_TYPE_UNUSED;
+    }
+  }
+
+  UT_ASSERT_TRUE (TestCheckLookups ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A HOB list other than the indexed one is walked, and an index table of
+  another HOB list isn't used.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+OtherHobListTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VOID                   *HobList;
+  EDKII_HOB_INDEX_TABLE  *Table;
+  EFI_GUID               Guid;
+  EFI_PEI_HOB_POINTERS   Hob;
+  UINTN                  Number;
+
+  UT_ASSERT_TRUE (TestSetupHobList (TEST_HOBS, TEST_GUIDS));
+
+  HobList = TestBuildHobList (TEST_HOBS / 4, TEST_GUIDS);
+  UT_ASSERT_NOT_NULL (HobList);
+
+  for (Number = 0; Number <= TEST_GUIDS; Number++) {
+    TestMakeGuid (Number, &Guid);
+    Hob.Raw = HobList;
+    while ((Hob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, Hob.Raw)) != NULL) {
+      if (CompareGuid (&Guid, &Hob.Guid->Name)) {
+        break;
+      }
+
+      Hob.Raw = GET_NEXT_HOB (Hob);
+    }
+
+    UT_ASSERT_EQUAL ((UINTN)GetNextGuidHob (&Guid, HobList), (UINTN)Hob.Raw);
+  }
+
+  //
+  // Install the index table of the other HOB list.
+  //
+  Table              = mTestHobIndexTable;
+  mTestHobIndexTable = CoreBuildHobIndexTable (HobList);
+  UT_ASSERT_NOT_NULL (mTestHobIndexTable);
+  mHobList = NULL;
+  HobLibConstructor (NULL, NULL);
+  UT_ASSERT_EQUAL ((UINTN)mHobIndexTable, 0);
+
+  FreePool (mTestHobIndexTable);
+  FreePool (HobList);
+  mTestHobIndexTable = Table;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare GetFirstGuidHob() through the index table with the walk of the HOB
+  list, for growing numbers of HOBs. The times are logged.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED               The benchmark ran.
+  @retval UNIT_TEST_ERROR_TEST_FAILED    A lookup failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkLookup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                  Count;
+  UINTN                  Number;
+  UINTN                  Lookups;
+  UINTN                  Index;
+  UINTN                  Found;
+  EFI_GUID               *Guid;
+  EDKII_HOB_INDEX_TABLE  *Table;
+  UINT64                 Start;
+  UINT64                 Indexed;
+  UINT64                 Walk;
+
+  Lookups = UnitTestBenchmarkIterations (BENCHMARK_LOOKUPS);
+
+  for (Count = 0; Count < ARRAY_SIZE (mBenchmarkHobs); Count++) {
+    Number = mBenchmarkHobs[Count] / 8;
+    UT_ASSERT_TRUE (TestSetupHobList (mBenchmarkHobs[Count], Number));
+
+    Guid = AllocatePool (Number * sizeof (EFI_GUID));
+    UT_ASSERT_NOT_NULL (Guid);
+    for (Index = 0; Index < Number; Index++) {
+      TestMakeGuid (Index, &Guid[Index]);
+    }
+
+    //
+    // Look up the GUIDs in turn, like the drivers looking for their
+    // configuration HOBs.
+    //
+    Found = 0;
+    Start = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found += (GetFirstGuidHob (&Guid[Index % Number]) != NULL);
+    }
+
+    Indexed = UnitTestBenchmarkElapsed (Start);
+
+    Table          = mHobIndexTable;
+    mHobIndexTable = NULL;
+    Start          = UnitTestBenchmarkStart ();
+    for (Index = 0; Index < Lookups; Index++) {
+      Found -= (GetFirstGuidHob (&Guid[Index % Number]) != NULL);
+    }
+
+    Walk           = UnitTestBenchmarkElapsed (Start);
+    mHobIndexTable = Table;
+    FreePool (Guid);
+    UT_ASSERT_EQUAL (Found, 0);
+
+    UT_LOG_INFO (
+      "%5Lu HOBs, %4Lu GUIDs: %Lu lookups, index %Lu us, HOB list walk %Lu us\n",
+      (UINT64)mBenchmarkHobs[Count],
+      (UINT64)Number,
+      (UINT64)Lookups,
+      Indexed,
+      Walk
+      );
+
+    FreeHobList (NULL);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the HOB
+  index table and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "HOB Index Tests", "HobLib.HobIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HOB Index Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (IndexTests, "GUIDed HOBs are found through the index", "GuidHobFind", GuidHobFindTest, NULL, FreeHobList, NULL);
+  AddTestCase (IndexTests, "GUIDed HOBs marked unused aren't found", "UnusedHob", UnusedHobTest, NULL, FreeHobList, NULL);
+  AddTestCase (IndexTests, "Other HOB lists are walked", "OtherHobList", OtherHobListTest, NULL, FreeHobList, NULL);
+  AddTestCase (IndexTests, "GUIDed HOB lookup benchmark", "Benchmark", BenchmarkLookup, NULL, FreeHobList, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in]  argc  Number of arguments.
+  @param[in]  argv  Array of arguments.
+
+  @return 0 on success, 1 on failure.
+
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,258 @@
+/** @file
+  Cache of the PE image digests computed by the Security2 handlers.
+
+  The Secure Boot verification and the TCG measurement both compute the
+  Authenticode digest of the image passed to FileAuthentication(). The
+  digests are kept for the duration of the call, so each algorithm is only
+  computed once per image. They are dropped when the call returns: the
+  image buffer can then be freed, and its address reused for another image.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PeImageDigestCache.h"
+
+//
+// The image being authenticated.
+//
+PE_IMAGE_DIGEST_CACHE_ENTRY  *mPeImageDigestCacheEntry = NULL;
+
+/**
+  Get the cache entry of the image being authenticated.
+
+  @param[in]  FileBuffer    The image buffer.
+  @param[in]  FileSize      The size of the image buffer.
+  @param[in]  File          The device path of the image.
+
+  @return The cache entry of the image, or NULL if the image isn't the one
+          being authenticated.
+
+**/
+STATIC
+PE_IMAGE_DIGEST_CACHE_ENTRY *
+PeImageDigestCacheGetEntry (
+  IN CONST VOID                      *FileBuffer,
+  IN UINTN                           FileSize,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *File OPTIONAL
+  )
+{
+  PE_IMAGE_DIGEST_CACHE_ENTRY  *Entry;
+  UINTN                        FileDevicePathSize;
+
+  Entry = mPeImageDigestCacheEntry;
+  if ((Entry == NULL) ||
+      (FileBuffer == NULL) ||
+      (Entry->FileBuffer != FileBuffer) ||
+      (Entry->FileSize != FileSize))
+  {
+    return NULL;
+  }
+
+  if ((Entry->File == NULL) || (File == NULL)) {
+    return (Entry->File == File) ? Entry : NULL;
+  }
+
+  FileDevicePathSize = GetDevicePathSize (File);
+  if ((FileDevicePathSize != GetDevicePathSize (Entry->File)) ||
+      (CompareMem (File, Entry->File, FileDevicePathSize) != 0))
+  {
+    return NULL;
+  }
+
+  return Entry;
+}
+
+/**
+  Get the Authenticode digest of the image being authenticated.
+
+  @param[in]      This            Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]      FileBuffer      The image buffer.
+  @param[in]      FileSize        The size of the image buffer.
+  @param[in]      File            The device path of the image.
+  @param[in]      HashAlgorithm   The hash algorithm, a TPM_ALG_ID value.
+  @param[out]     Digest          The digest of the image.
+  @param[in, out] DigestSize      On input, the size of Digest. On output, the size
+                                  of the digest.
+
+  @retval EFI_SUCCESS             The digest is returned.
+  @retval EFI_NOT_FOUND           The digest isn't cached, or the image isn't the
+                                  one being authenticated.
+  @retval EFI_BUFFER_TOO_SMALL    Digest is too small, DigestSize is updated.
+  @retval EFI_INVALID_PARAMETER   DigestSize is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageDigestCacheGetDigest (
+  IN     EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN     CONST VOID                            *FileBuffer,
+  IN     UINTN                                 FileSize,
+  IN     CONST EFI_DEVICE_PATH_PROTOCOL        *File OPTIONAL,
+  IN     TPM_ALG_ID                            HashAlgorithm,
+  OUT    UINT8                                 *Digest,
+  IN OUT UINTN                                 *DigestSize
+  )
+{
+  PE_IMAGE_DIGEST_CACHE_ENTRY  *Entry;
+  UINTN                        Index;
+
+  if (DigestSize == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = PeImageDigestCacheGetEntry (FileBuffer, FileSize, File);
+  if (Entry == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < Entry->DigestCount; Index++) {
+    if (Entry->Digests[Index].HashAlgorithm == HashAlgorithm) {
+      if ((*DigestSize < Entry->Digests[Index].DigestSize) || (Digest == NULL)) {
+        *DigestSize = Entry->Digests[Index].DigestSize;
+        return EFI_BUFFER_TOO_SMALL;
+      }
+
+      *DigestSize = Entry->Digests[Index].DigestSize;
+      CopyMem (Digest, Entry->Digests[Index].Digest, *DigestSize);
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Cache the Authenticode digest of the image being authenticated.
+
+  @param[in]  This            Pointer to the EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL instance.
+  @param[in]  FileBuffer      The image buffer.
+  @param[in]  FileSize        The size of the image buffer.
+  @param[in]  File            The device path of the image.
+  @param[in]  HashAlgorithm   The hash algorithm, a TPM_ALG_ID value.
+  @param[in]  Digest          The digest of the image.
+  @param[in]  DigestSize      The size of the digest.
+
+  @retval EFI_SUCCESS             The digest is cached.
+  @retval EFI_NOT_STARTED         The image isn't the one being authenticated.
+  @retval EFI_INVALID_PARAMETER   Digest is NULL, or DigestSize is too large.
+  @retval EFI_OUT_OF_RESOURCES    There is no room left for the digest.
+
+**/
+EFI_STATUS
+EFIAPI
+PeImageDigestCacheSetDigest (
+  IN EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *This,
+  IN CONST VOID                            *FileBuffer,
+  IN UINTN                                 FileSize,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL        *File OPTIONAL,
+  IN TPM_ALG_ID                            HashAlgorithm,
+  IN CONST UINT8                           *Digest,
+  IN UINTN                                 DigestSize
+  )
+{
+  PE_IMAGE_DIGEST_CACHE_ENTRY  *Entry;
+  UINTN                        Index;
+
+  if ((Digest == NULL) || (DigestSize == 0) || (DigestSize > SHA512_DIGEST_SIZE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = PeImageDigestCacheGetEntry (FileBuffer, FileSize, File);
+  if (Entry == NULL) {
+    return EFI_NOT_STARTED;
+  }
+
+  for (Index = 0; Index < Entry->DigestCount; Index++) {
+    if (Entry->Digests[Index].HashAlgorithm == HashAlgorithm) {
+      break;
+    }
+  }
+
+  if (Index == PE_IMAGE_DIGEST_CACHE_MAX_DIGESTS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entry->Digests[Index].HashAlgorithm = HashAlgorithm;
+  Entry->Digests[Index].DigestSize    = DigestSize;
+  CopyMem (Entry->Digests[Index].Digest, Digest, DigestSize);
+  if (Index == Entry->DigestCount) {
+    Entry->DigestCount++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  mPeImageDigestCache = {
+  PeImageDigestCacheGetDigest,
+  PeImageDigestCacheSetDigest
+};
+
+/**
+  Start caching the digests of an image being authenticated.
+
+  @param[out] Entry         The cache entry of the image, valid until
+                            PeImageDigestCacheEnd() is called.
+  @param[in]  File          The device path of the image.
+  @param[in]  FileBuffer    The image buffer.
+  @param[in]  FileSize      The size of the image buffer.
+
+**/
+VOID
+PeImageDigestCacheStart (
+  OUT PE_IMAGE_DIGEST_CACHE_ENTRY     *Entry,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *File OPTIONAL,
+  IN  CONST VOID                      *FileBuffer,
+  IN  UINTN                           FileSize
+  )
+{
+  Entry->Previous    = mPeImageDigestCacheEntry;
+  Entry->FileBuffer  = FileBuffer;
+  Entry->FileSize    = FileSize;
+  Entry->File        = File;
+  Entry->DigestCount = 0;
+
+  mPeImageDigestCacheEntry = Entry;
+}
+
+/**
+  Drop the digests of an image once it is authenticated.
+
+  @param[in]  Entry         The cache entry of the image.
+
+**/
+VOID
+PeImageDigestCacheEnd (
+  IN PE_IMAGE_DIGEST_CACHE_ENTRY  *Entry
+  )
+{
+  ASSERT (mPeImageDigestCacheEntry == Entry);
+
+  DEBUG ((DEBUG_VERBOSE, "PeImageDigestCache: %d digests cached for image at 0x%p\n", Entry->DigestCount, Entry->FileBuffer));
+
+  mPeImageDigestCacheEntry = Entry->Previous;
+  ZeroMem (Entry, sizeof (*Entry));
+}
+
+/**
+  Install the PE Image Digest Cache Protocol.
+
+  @param[in]  Handle        The handle to install the protocol on.
+
+**/
+VOID
+PeImageDigestCacheInitialize (
+  IN EFI_HANDLE  Handle
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gBS->InstallProtocolInterface (
+                  &Handle,
+                  &gEdkiiPeImageDigestCacheProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  &mPeImageDigestCache
+                  );
+  ASSERT_EFI_ERROR (Status);
+}
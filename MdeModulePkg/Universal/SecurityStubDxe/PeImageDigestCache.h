@@ -0,0 +1,89 @@
+/** @file
+  Cache of the PE image digests computed by the Security2 handlers.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _PE_IMAGE_DIGEST_CACHE_H_
+#define _PE_IMAGE_DIGEST_CACHE_H_
+
+#include <PiDxe.h>
+#include <Protocol/PeImageDigestCache.h>
+
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/DebugLib.h>
+
+//
+// One digest per hash algorithm: SHA1, SHA256, SHA384, SHA512 and SM3.
+//
+#define PE_IMAGE_DIGEST_CACHE_MAX_DIGESTS  5
+
+typedef struct {
+  TPM_ALG_ID    HashAlgorithm;
+  UINTN         DigestSize;
+  UINT8         Digest[SHA512_DIGEST_SIZE];
+} PE_IMAGE_DIGEST;
+
+//
+// The digests of the image being authenticated.
+//
+typedef struct _PE_IMAGE_DIGEST_CACHE_ENTRY PE_IMAGE_DIGEST_CACHE_ENTRY;
+
+struct _PE_IMAGE_DIGEST_CACHE_ENTRY {
+  //
+  // The image authenticated before this one started, if the authentications
+  // are nested.
+  //
+  PE_IMAGE_DIGEST_CACHE_ENTRY       *Previous;
+  CONST VOID                        *FileBuffer;
+  UINTN                             FileSize;
+  CONST EFI_DEVICE_PATH_PROTOCOL    *File;
+  UINTN                             DigestCount;
+  PE_IMAGE_DIGEST                   Digests[PE_IMAGE_DIGEST_CACHE_MAX_DIGESTS];
+};
+
+/**
+  Start caching the digests of an image being authenticated.
+
+  @param[out] Entry         The cache entry of the image, valid until
+                            PeImageDigestCacheEnd() is called.
+  @param[in]  File          The device path of the image.
+  @param[in]  FileBuffer    The image buffer.
+  @param[in]  FileSize      The size of the image buffer.
+
+**/
+VOID
+PeImageDigestCacheStart (
+  OUT PE_IMAGE_DIGEST_CACHE_ENTRY     *Entry,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *File OPTIONAL,
+  IN  CONST VOID                      *FileBuffer,
+  IN  UINTN                           FileSize
+  );
+
+/**
+  Drop the digests of an image once it is authenticated.
+
+  @param[in]  Entry         The cache entry of the image.
+
+**/
+VOID
+PeImageDigestCacheEnd (
+  IN PE_IMAGE_DIGEST_CACHE_ENTRY  *Entry
+  );
+
+/**
+  Install the PE Image Digest Cache Protocol.
+
+  @param[in]  Handle        The handle to install the protocol on.
+
+**/
+VOID
+PeImageDigestCacheInitialize (
+  IN EFI_HANDLE  Handle
+  );
+
+#endif
@@ -14,6 +14,7 @@
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/SecurityManagementLib.h>
 #include "Defer3rdPartyImageLoad.h"
+#include "PeImageDigestCache.h"
 
 //
 // Handle for the Security Architectural Protocol instance produced by this driver
@@ -135,7 +136,8 @@ Security2StubAuthenticate (
   IN BOOLEAN                            BootPolicy
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS                   Status;
+  PE_IMAGE_DIGEST_CACHE_ENTRY  DigestCacheEntry;
 
   if (FileBuffer != NULL) {
     Status = Defer3rdPartyImageLoad (File, BootPolicy);
@@ -144,17 +146,27 @@ Security2StubAuthenticate (
     }
   }
 
-  return ExecuteSecurity2Handlers (
-           EFI_AUTH_OPERATION_VERIFY_IMAGE |
-           EFI_AUTH_OPERATION_DEFER_IMAGE_LOAD |
-           EFI_AUTH_OPERATION_MEASURE_IMAGE |
-           EFI_AUTH_OPERATION_CONNECT_POLICY,
-           0,
-           File,
-           FileBuffer,
-           FileSize,
-           BootPolicy
-           );
+  //
+  // Let the verification and the measurement handlers share the digests of
+  // the image they compute.
+  //
+  PeImageDigestCacheStart (&DigestCacheEntry, File, FileBuffer, FileSize);
+
+  Status = ExecuteSecurity2Handlers (
+             EFI_AUTH_OPERATION_VERIFY_IMAGE |
+             EFI_AUTH_OPERATION_DEFER_IMAGE_LOAD |
+             EFI_AUTH_OPERATION_MEASURE_IMAGE |
+             EFI_AUTH_OPERATION_CONNECT_POLICY,
+             0,
+             File,
+             FileBuffer,
+             FileSize,
+             BootPolicy
+             );
+
+  PeImageDigestCacheEnd (&DigestCacheEntry);
+
+  return Status;
 }
 
 //
@@ -205,6 +217,8 @@ SecurityStubInitialize (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  PeImageDigestCacheInitialize (mSecurityArchProtocolHandle);
+
   Defer3rdPartyImageLoadInitialize ();
 
   return EFI_SUCCESS;
@@ -16,6 +16,7 @@
   PeCoffLoaderGetImageInfo() routine will do basic check for whole PE/COFF image.
 
   Copyright (c) 2006 - 2019, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
   Portions copyright (c) 2008 - 2009, Apple Inc. All rights reserved.<BR>
   Portions Copyright (c) 2020, Hewlett Packard Enterprise Development LP. All rights reserved.<BR>
   Portions Copyright (c) 2022, Loongson Technology Corporation Limited. All rights reserved.<BR>
@@ -883,76 +884,38 @@ PeCoffLoaderImageAddress (
 }
 
 /**
-  Applies relocation fixups to a PE/COFF image that was loaded with PeCoffLoaderLoadImage().
-
-  If the DestinationAddress field of ImageContext is 0, then use the ImageAddress field of
-  ImageContext as the relocation base address.  Otherwise, use the DestinationAddress field
-  of ImageContext as the relocation base address.  The caller must allocate the relocation
-  fixup log buffer and fill in the FixupData field of ImageContext prior to calling this function.
-
-  The ImageRead, Handle, PeCoffHeaderOffset,  IsTeImage, Machine, ImageType, ImageAddress,
-  ImageSize, DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders,
-  DebugDirectoryEntryRva, EntryPoint, FixupDataSize, CodeView, PdbPointer, and FixupData of
-  the ImageContext structure must be valid prior to invoking this service.
-
-  If ImageContext is NULL, then ASSERT().
+  Find the relocation blocks of a PE/COFF image loaded at the ImageAddress of
+  ImageContext, and update the image base in its header to the relocation base
+  address.
 
-  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
-  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
-  prior to transferring control to a PE/COFF image that is loaded using this library.
+  Only the headers of the image need to be loaded.
 
-  @param  ImageContext        The pointer to the image context structure that describes the PE/COFF
-                              image that is being relocated.
+  @param  ImageContext      The pointer to the image context structure that describes the PE/COFF
+                            image that is being relocated.
+  @param  RelocBase         Returns the first relocation block, or NULL if there is none.
+  @param  RelocBaseEnd      Returns the last byte of the relocation blocks.
+  @param  Adjust            Returns the difference between the relocation base address and
+                            the image base address the image is linked at.
+  @param  TeStrippedOffset  Returns the stripped offset of a TE image.
 
-  @retval RETURN_SUCCESS      The PE/COFF image was relocated.
-                              Extended status information is in the ImageError field of ImageContext.
-  @retval RETURN_LOAD_ERROR   The image in not a valid PE/COFF image.
-                              Extended status information is in the ImageError field of ImageContext.
-  @retval RETURN_UNSUPPORTED  A relocation record type is not supported.
-                              Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_SUCCESS     The relocation blocks are found.
+  @retval RETURN_LOAD_ERROR  The relocation directory isn't in the image.
 
 **/
+STATIC
 RETURN_STATUS
-EFIAPI
-PeCoffLoaderRelocateImage (
-  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+PeCoffLoaderGetRelocationBlocks (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext,
+  OUT    EFI_IMAGE_BASE_RELOCATION     **RelocBase,
+  OUT    EFI_IMAGE_BASE_RELOCATION     **RelocBaseEnd,
+  OUT    UINT64                        *Adjust,
+  OUT    UINT32                        *TeStrippedOffset
   )
 {
-  RETURN_STATUS                        Status;
   EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION  Hdr;
   EFI_IMAGE_DATA_DIRECTORY             *RelocDir;
-  UINT64                               Adjust;
-  EFI_IMAGE_BASE_RELOCATION            *RelocBaseOrg;
-  EFI_IMAGE_BASE_RELOCATION            *RelocBase;
-  EFI_IMAGE_BASE_RELOCATION            *RelocBaseEnd;
-  UINT16                               *Reloc;
-  UINT16                               *RelocEnd;
-  CHAR8                                *Fixup;
-  CHAR8                                *FixupBase;
-  UINT16                               *Fixup16;
-  UINT32                               *Fixup32;
-  UINT64                               *Fixup64;
-  CHAR8                                *FixupData;
   PHYSICAL_ADDRESS                     BaseAddress;
   UINT32                               NumberOfRvaAndSizes;
-  UINT32                               TeStrippedOffset;
-
-  ASSERT (ImageContext != NULL);
-
-  //
-  // Assume success
-  //
-  ImageContext->ImageError = IMAGE_ERROR_SUCCESS;
-
-  //
-  // If there are no relocation entries, then we are done
-  //
-  if (ImageContext->RelocationsStripped) {
-    // Applies additional environment specific actions to relocate fixups
-    // to a PE/COFF image if needed
-    PeCoffLoaderRelocateImageExtraAction (ImageContext);
-    return RETURN_SUCCESS;
-  }
 
   //
   // If the destination address is not 0, use that rather than the
@@ -965,15 +928,15 @@ PeCoffLoaderRelocateImage (
   }
 
   if (!(ImageContext->IsTeImage)) {
-    Hdr.Pe32         = (EFI_IMAGE_NT_HEADERS32 *)((UINTN)ImageContext->ImageAddress + ImageContext->PeCoffHeaderOffset);
-    TeStrippedOffset = 0;
+    Hdr.Pe32          = (EFI_IMAGE_NT_HEADERS32 *)((UINTN)ImageContext->ImageAddress + ImageContext->PeCoffHeaderOffset);
+    *TeStrippedOffset = 0;
 
     if (Hdr.Pe32->OptionalHeader.Magic == EFI_IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
       //
       // Use PE32 offset
       //
-      Adjust = (UINT64)BaseAddress - Hdr.Pe32->OptionalHeader.ImageBase;
-      if (Adjust != 0) {
+      *Adjust = (UINT64)BaseAddress - Hdr.Pe32->OptionalHeader.ImageBase;
+      if (*Adjust != 0) {
         Hdr.Pe32->OptionalHeader.ImageBase = (UINT32)BaseAddress;
       }
 
@@ -983,8 +946,8 @@ PeCoffLoaderRelocateImage (
       //
       // Use PE32+ offset
       //
-      Adjust = (UINT64)BaseAddress - Hdr.Pe32Plus->OptionalHeader.ImageBase;
-      if (Adjust != 0) {
+      *Adjust = (UINT64)BaseAddress - Hdr.Pe32Plus->OptionalHeader.ImageBase;
+      if (*Adjust != 0) {
         Hdr.Pe32Plus->OptionalHeader.ImageBase = (UINT64)BaseAddress;
       }
 
@@ -1002,11 +965,11 @@ PeCoffLoaderRelocateImage (
       RelocDir = NULL;
     }
   } else {
-    Hdr.Te           = (EFI_TE_IMAGE_HEADER *)(UINTN)(ImageContext->ImageAddress);
-    TeStrippedOffset = (UINT32)Hdr.Te->StrippedSize - sizeof (EFI_TE_IMAGE_HEADER);
-    Adjust           = (UINT64)(BaseAddress - (Hdr.Te->ImageBase + TeStrippedOffset));
-    if (Adjust != 0) {
-      Hdr.Te->ImageBase = (UINT64)(BaseAddress - TeStrippedOffset);
+    Hdr.Te            = (EFI_TE_IMAGE_HEADER *)(UINTN)(ImageContext->ImageAddress);
+    *TeStrippedOffset = (UINT32)Hdr.Te->StrippedSize - sizeof (EFI_TE_IMAGE_HEADER);
+    *Adjust           = (UINT64)(BaseAddress - (Hdr.Te->ImageBase + *TeStrippedOffset));
+    if (*Adjust != 0) {
+      Hdr.Te->ImageBase = (UINT64)(BaseAddress - *TeStrippedOffset);
     }
 
     //
@@ -1016,13 +979,13 @@ PeCoffLoaderRelocateImage (
   }
 
   if ((RelocDir != NULL) && (RelocDir->Size > 0)) {
-    RelocBase    = (EFI_IMAGE_BASE_RELOCATION *)PeCoffLoaderImageAddress (ImageContext, RelocDir->VirtualAddress, TeStrippedOffset);
-    RelocBaseEnd = (EFI_IMAGE_BASE_RELOCATION *)PeCoffLoaderImageAddress (
-                                                  ImageContext,
-                                                  RelocDir->VirtualAddress + RelocDir->Size - 1,
-                                                  TeStrippedOffset
-                                                  );
-    if ((RelocBase == NULL) || (RelocBaseEnd == NULL) || ((UINTN)RelocBaseEnd < (UINTN)RelocBase)) {
+    *RelocBase    = (EFI_IMAGE_BASE_RELOCATION *)PeCoffLoaderImageAddress (ImageContext, RelocDir->VirtualAddress, *TeStrippedOffset);
+    *RelocBaseEnd = (EFI_IMAGE_BASE_RELOCATION *)PeCoffLoaderImageAddress (
+                                                   ImageContext,
+                                                   RelocDir->VirtualAddress + RelocDir->Size - 1,
+                                                   *TeStrippedOffset
+                                                   );
+    if ((*RelocBase == NULL) || (*RelocBaseEnd == NULL) || ((UINTN)*RelocBaseEnd < (UINTN)*RelocBase)) {
       ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
       return RETURN_LOAD_ERROR;
     }
@@ -1030,125 +993,265 @@ PeCoffLoaderRelocateImage (
     //
     // Set base and end to bypass processing below.
     //
-    RelocBase = RelocBaseEnd = NULL;
+    *RelocBase = *RelocBaseEnd = NULL;
   }
 
-  RelocBaseOrg = RelocBase;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Apply the fixups of the relocation blocks of a PE/COFF image, in order, up to
+  the first block whose page doesn't end below Limit.
+
+  @param  ImageContext      The pointer to the image context structure that describes the PE/COFF
+                            image that is being relocated.
+  @param  RelocBase         On input, the next relocation block to apply. On output, the first
+                            relocation block not applied.
+  @param  RelocBaseEnd      The last byte of the relocation blocks.
+  @param  Limit             The end of the part of the image loaded already, or MAX_UINTN to
+                            apply all the remaining blocks.
+  @param  Adjust            The difference between the relocation base address and the image
+                            base address the image is linked at.
+  @param  TeStrippedOffset  Stripped offset for TE image.
+  @param  FixupData         On input, where to log the next fixup, or NULL not to log the fixups.
+                            On output, where to log the fixup after the last one applied.
+
+  @retval RETURN_SUCCESS      The relocation blocks are applied.
+  @retval RETURN_LOAD_ERROR   A relocation block is invalid.
+  @retval RETURN_UNSUPPORTED  A relocation record type is not supported.
+
+**/
+STATIC
+RETURN_STATUS
+PeCoffLoaderApplyRelocationBlocks (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext,
+  IN OUT EFI_IMAGE_BASE_RELOCATION     **RelocBase,
+  IN     EFI_IMAGE_BASE_RELOCATION     *RelocBaseEnd,
+  IN     UINTN                         Limit,
+  IN     UINT64                        Adjust,
+  IN     UINT32                        TeStrippedOffset,
+  IN OUT CHAR8                         **FixupData
+  )
+{
+  RETURN_STATUS  Status;
+  UINT16         *Reloc;
+  UINT16         *RelocEnd;
+  CHAR8          *Fixup;
+  CHAR8          *FixupBase;
+  UINT16         *Fixup16;
+  UINT32         *Fixup32;
+  UINT64         *Fixup64;
+  UINTN          MaxOffset;
 
   //
-  // If Adjust is not zero, then apply fix ups to the image
+  // Run the relocation information and apply the fixups
   //
-  if (Adjust != 0) {
+  while ((UINTN)*RelocBase < (UINTN)RelocBaseEnd) {
+    Reloc = (UINT16 *)((CHAR8 *)*RelocBase + sizeof (EFI_IMAGE_BASE_RELOCATION));
     //
-    // Run the relocation information and apply the fixups
+    // Add check for RelocBase->SizeOfBlock field.
     //
-    FixupData = ImageContext->FixupData;
-    while ((UINTN)RelocBase < (UINTN)RelocBaseEnd) {
-      Reloc = (UINT16 *)((CHAR8 *)RelocBase + sizeof (EFI_IMAGE_BASE_RELOCATION));
-      //
-      // Add check for RelocBase->SizeOfBlock field.
-      //
-      if (RelocBase->SizeOfBlock == 0) {
-        ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-        return RETURN_LOAD_ERROR;
+    if ((*RelocBase)->SizeOfBlock == 0) {
+      ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+      return RETURN_LOAD_ERROR;
+    }
+
+    if ((UINTN)*RelocBase > MAX_ADDRESS - (*RelocBase)->SizeOfBlock) {
+      ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+      return RETURN_LOAD_ERROR;
+    }
+
+    RelocEnd = (UINT16 *)((CHAR8 *)*RelocBase + (*RelocBase)->SizeOfBlock);
+    if ((UINTN)RelocEnd > (UINTN)RelocBaseEnd + 1) {
+      ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+      return RETURN_LOAD_ERROR;
+    }
+
+    FixupBase = PeCoffLoaderImageAddress (ImageContext, (*RelocBase)->VirtualAddress, TeStrippedOffset);
+    if (FixupBase == NULL) {
+      ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+      return RETURN_LOAD_ERROR;
+    }
+
+    //
+    // Leave the block for later if one of its fixups may not be loaded yet.
+    //
+    if (Limit != MAX_UINTN) {
+      MaxOffset = 0;
+      for (Fixup16 = Reloc; (UINTN)Fixup16 < (UINTN)RelocEnd; Fixup16++) {
+        MaxOffset = MAX (MaxOffset, (UINTN)(*Fixup16 & 0xFFF));
       }
 
-      if ((UINTN)RelocBase > MAX_ADDRESS - RelocBase->SizeOfBlock) {
-        ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-        return RETURN_LOAD_ERROR;
+      if ((UINTN)FixupBase + MaxOffset + sizeof (UINT64) > Limit) {
+        return RETURN_SUCCESS;
       }
+    }
 
-      RelocEnd = (UINT16 *)((CHAR8 *)RelocBase + RelocBase->SizeOfBlock);
-      if ((UINTN)RelocEnd > (UINTN)RelocBaseOrg + RelocDir->Size) {
+    //
+    // Run this relocation record
+    //
+    while ((UINTN)Reloc < (UINTN)RelocEnd) {
+      Fixup = PeCoffLoaderImageAddress (ImageContext, (*RelocBase)->VirtualAddress + (*Reloc & 0xFFF), TeStrippedOffset);
+      if (Fixup == NULL) {
         ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
         return RETURN_LOAD_ERROR;
       }
 
-      FixupBase = PeCoffLoaderImageAddress (ImageContext, RelocBase->VirtualAddress, TeStrippedOffset);
-      if (FixupBase == NULL) {
-        ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-        return RETURN_LOAD_ERROR;
+      switch ((*Reloc) >> 12) {
+        case EFI_IMAGE_REL_BASED_ABSOLUTE:
+          break;
+
+        case EFI_IMAGE_REL_BASED_HIGH:
+          Fixup16  = (UINT16 *)Fixup;
+          *Fixup16 = (UINT16)(*Fixup16 + ((UINT16)((UINT32)Adjust >> 16)));
+          if (*FixupData != NULL) {
+            *(UINT16 *)*FixupData = *Fixup16;
+            *FixupData            = *FixupData + sizeof (UINT16);
+          }
+
+          break;
+
+        case EFI_IMAGE_REL_BASED_LOW:
+          Fixup16  = (UINT16 *)Fixup;
+          *Fixup16 = (UINT16)(*Fixup16 + (UINT16)Adjust);
+          if (*FixupData != NULL) {
+            *(UINT16 *)*FixupData = *Fixup16;
+            *FixupData            = *FixupData + sizeof (UINT16);
+          }
+
+          break;
+
+        case EFI_IMAGE_REL_BASED_HIGHLOW:
+          Fixup32  = (UINT32 *)Fixup;
+          *Fixup32 = *Fixup32 + (UINT32)Adjust;
+          if (*FixupData != NULL) {
+            *FixupData            = ALIGN_POINTER (*FixupData, sizeof (UINT32));
+            *(UINT32 *)*FixupData = *Fixup32;
+            *FixupData            = *FixupData + sizeof (UINT32);
+          }
+
+          break;
+
+        case EFI_IMAGE_REL_BASED_DIR64:
+          Fixup64  = (UINT64 *)Fixup;
+          *Fixup64 = *Fixup64 + (UINT64)Adjust;
+          if (*FixupData != NULL) {
+            *FixupData            = ALIGN_POINTER (*FixupData, sizeof (UINT64));
+            *(UINT64 *)*FixupData = *Fixup64;
+            *FixupData            = *FixupData + sizeof (UINT64);
+          }
+
+          break;
+
+        default:
+          //
+          // The common code does not handle some of the stranger IPF relocations
+          // PeCoffLoaderRelocateImageEx () adds support for these complex fixups
+          // on IPF and is a No-Op on other architectures.
+          //
+          Status = PeCoffLoaderRelocateImageEx (Reloc, Fixup, FixupData, Adjust);
+          if (RETURN_ERROR (Status)) {
+            ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
+            return Status;
+          }
       }
 
       //
-      // Run this relocation record
+      // Next relocation record
       //
-      while ((UINTN)Reloc < (UINTN)RelocEnd) {
-        Fixup = PeCoffLoaderImageAddress (ImageContext, RelocBase->VirtualAddress + (*Reloc & 0xFFF), TeStrippedOffset);
-        if (Fixup == NULL) {
-          ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-          return RETURN_LOAD_ERROR;
-        }
+      Reloc += 1;
+    }
 
-        switch ((*Reloc) >> 12) {
-          case EFI_IMAGE_REL_BASED_ABSOLUTE:
-            break;
+    //
+    // Next reloc block
+    //
+    *RelocBase = (EFI_IMAGE_BASE_RELOCATION *)RelocEnd;
+  }
 
-          case EFI_IMAGE_REL_BASED_HIGH:
-            Fixup16  = (UINT16 *)Fixup;
-            *Fixup16 = (UINT16)(*Fixup16 + ((UINT16)((UINT32)Adjust >> 16)));
-            if (FixupData != NULL) {
-              *(UINT16 *)FixupData = *Fixup16;
-              FixupData            = FixupData + sizeof (UINT16);
-            }
+  return RETURN_SUCCESS;
+}
 
-            break;
+/**
+  Applies relocation fixups to a PE/COFF image that was loaded with PeCoffLoaderLoadImage().
 
-          case EFI_IMAGE_REL_BASED_LOW:
-            Fixup16  = (UINT16 *)Fixup;
-            *Fixup16 = (UINT16)(*Fixup16 + (UINT16)Adjust);
-            if (FixupData != NULL) {
-              *(UINT16 *)FixupData = *Fixup16;
-              FixupData            = FixupData + sizeof (UINT16);
-            }
+  If the DestinationAddress field of ImageContext is 0, then use the ImageAddress field of
+  ImageContext as the relocation base address.  Otherwise, use the DestinationAddress field
+  of ImageContext as the relocation base address.  The caller must allocate the relocation
+  fixup log buffer and fill in the FixupData field of ImageContext prior to calling this function.
 
-            break;
+  The ImageRead, Handle, PeCoffHeaderOffset,  IsTeImage, Machine, ImageType, ImageAddress,
+  ImageSize, DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders,
+  DebugDirectoryEntryRva, EntryPoint, FixupDataSize, CodeView, PdbPointer, and FixupData of
+  the ImageContext structure must be valid prior to invoking this service.
 
-          case EFI_IMAGE_REL_BASED_HIGHLOW:
-            Fixup32  = (UINT32 *)Fixup;
-            *Fixup32 = *Fixup32 + (UINT32)Adjust;
-            if (FixupData != NULL) {
-              FixupData            = ALIGN_POINTER (FixupData, sizeof (UINT32));
-              *(UINT32 *)FixupData = *Fixup32;
-              FixupData            = FixupData + sizeof (UINT32);
-            }
+  If ImageContext is NULL, then ASSERT().
 
-            break;
+  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
+  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
+  prior to transferring control to a PE/COFF image that is loaded using this library.
 
-          case EFI_IMAGE_REL_BASED_DIR64:
-            Fixup64  = (UINT64 *)Fixup;
-            *Fixup64 = *Fixup64 + (UINT64)Adjust;
-            if (FixupData != NULL) {
-              FixupData              = ALIGN_POINTER (FixupData, sizeof (UINT64));
-              *(UINT64 *)(FixupData) = *Fixup64;
-              FixupData              = FixupData + sizeof (UINT64);
-            }
+  @param  ImageContext        The pointer to the image context structure that describes the PE/COFF
+                              image that is being relocated.
 
-            break;
+  @retval RETURN_SUCCESS      The PE/COFF image was relocated.
+                              Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_LOAD_ERROR   The image in not a valid PE/COFF image.
+                              Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_UNSUPPORTED  A relocation record type is not supported.
+                              Extended status information is in the ImageError field of ImageContext.
 
-          default:
-            //
-            // The common code does not handle some of the stranger IPF relocations
-            // PeCoffLoaderRelocateImageEx () adds support for these complex fixups
-            // on IPF and is a No-Op on other architectures.
-            //
-            Status = PeCoffLoaderRelocateImageEx (Reloc, Fixup, &FixupData, Adjust);
-            if (RETURN_ERROR (Status)) {
-              ImageContext->ImageError = IMAGE_ERROR_FAILED_RELOCATION;
-              return Status;
-            }
-        }
+**/
+RETURN_STATUS
+EFIAPI
+PeCoffLoaderRelocateImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+{
+  RETURN_STATUS              Status;
+  UINT64                     Adjust;
+  EFI_IMAGE_BASE_RELOCATION  *RelocBase;
+  EFI_IMAGE_BASE_RELOCATION  *RelocBaseEnd;
+  CHAR8                      *FixupData;
+  UINT32                     TeStrippedOffset;
 
-        //
-        // Next relocation record
-        //
-        Reloc += 1;
-      }
+  ASSERT (ImageContext != NULL);
 
-      //
-      // Next reloc block
-      //
-      RelocBase = (EFI_IMAGE_BASE_RELOCATION *)RelocEnd;
+  //
+  // Assume success
+  //
+  ImageContext->ImageError = IMAGE_ERROR_SUCCESS;
+
+  //
+  // If there are no relocation entries, then we are done
+  //
+  if (ImageContext->RelocationsStripped) {
+    // Applies additional environment specific actions to relocate fixups
+    // to a PE/COFF image if needed
+    PeCoffLoaderRelocateImageExtraAction (ImageContext);
+    return RETURN_SUCCESS;
+  }
+
+  Status = PeCoffLoaderGetRelocationBlocks (ImageContext, &RelocBase, &RelocBaseEnd, &Adjust, &TeStrippedOffset);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // If Adjust is not zero, then apply fix ups to the image
+  //
+  if (Adjust != 0) {
+    FixupData = ImageContext->FixupData;
+    Status    = PeCoffLoaderApplyRelocationBlocks (
+                  ImageContext,
+                  &RelocBase,
+                  RelocBaseEnd,
+                  MAX_UINTN,
+                  Adjust,
+                  TeStrippedOffset,
+                  &FixupData
+                  );
+    if (RETURN_ERROR (Status)) {
+      return Status;
     }
 
     ASSERT ((UINTN)FixupData <= (UINTN)ImageContext->FixupData + ImageContext->FixupDataSize);
@@ -1170,40 +1273,109 @@ PeCoffLoaderRelocateImage (
 }
 
 /**
-  Loads a PE/COFF image into memory.
+  Load a section of a PE/COFF image, zero filling the part of its virtual size
+  past its raw data.
 
-  Loads the PE/COFF image accessed through the ImageRead service of ImageContext into the buffer
-  specified by the ImageAddress and ImageSize fields of ImageContext.  The caller must allocate
-  the load buffer and fill in the ImageAddress and ImageSize fields prior to calling this function.
-  The EntryPoint, FixupDataSize, CodeView, PdbPointer and HiiResourceData fields of ImageContext are computed.
-  The ImageRead, Handle, PeCoffHeaderOffset,  IsTeImage,  Machine, ImageType, ImageAddress, ImageSize,
-  DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders, and DebugDirectoryEntryRva
-  fields of the ImageContext structure must be valid prior to invoking this service.
+  @param  ImageContext      The pointer to the image context structure that describes the PE/COFF
+                            image that is being loaded.
+  @param  Section           The section header, in the loaded image headers.
+  @param  TeStrippedOffset  Stripped offset for TE image.
+  @param  LoadedEnd         Returns the end of the loaded section.
 
-  If ImageContext is NULL, then ASSERT().
+  @retval RETURN_SUCCESS     The section is loaded.
+  @retval RETURN_LOAD_ERROR  The section is not in the image.
+  @retval Others             The section could not be read.
 
-  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
-  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
-  prior to transferring control to a PE/COFF image that is loaded using this library.
+**/
+STATIC
+RETURN_STATUS
+PeCoffLoaderLoadSection (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext,
+  IN     EFI_IMAGE_SECTION_HEADER      *Section,
+  IN     UINT32                        TeStrippedOffset,
+  OUT    UINTN                         *LoadedEnd
+  )
+{
+  RETURN_STATUS  Status;
+  CHAR8          *Base;
+  CHAR8          *End;
+  UINTN          Size;
+
+  //
+  // Read the section
+  //
+  Size = (UINTN)Section->Misc.VirtualSize;
+  if ((Size == 0) || (Size > Section->SizeOfRawData)) {
+    Size = (UINTN)Section->SizeOfRawData;
+  }
+
+  //
+  // Compute sections address
+  //
+  Base = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress, TeStrippedOffset);
+  End  = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress + Section->Misc.VirtualSize - 1, TeStrippedOffset);
+
+  //
+  // If the size of the section is non-zero and the base address or end address resolved to 0, then fail.
+  //
+  if ((Size > 0) && ((Base == NULL) || (End == NULL))) {
+    ImageContext->ImageError = IMAGE_ERROR_SECTION_NOT_LOADED;
+    return RETURN_LOAD_ERROR;
+  }
+
+  if (Section->SizeOfRawData > 0) {
+    Status = ImageContext->ImageRead (
+                             ImageContext->Handle,
+                             Section->PointerToRawData - TeStrippedOffset,
+                             &Size,
+                             Base
+                             );
+    if (RETURN_ERROR (Status)) {
+      ImageContext->ImageError = IMAGE_ERROR_IMAGE_READ;
+      return Status;
+    }
+  }
+
+  //
+  // If raw size is less then virtual size, zero fill the remaining
+  //
+
+  if (Size < Section->Misc.VirtualSize) {
+    ZeroMem (Base + Size, Section->Misc.VirtualSize - Size);
+  }
+
+  *LoadedEnd = (UINTN)Base + MAX (Size, Section->Misc.VirtualSize);
+  return RETURN_SUCCESS;
+}
+
+/**
+  Loads a PE/COFF image into memory, and relocates it as its sections are
+  loaded if asked to.
 
   @param  ImageContext              The pointer to the image context structure that describes the PE/COFF
                                     image that is being loaded.
+  @param  Relocate                  TRUE to relocate the image too, as PeCoffLoaderRelocateImage()
+                                    does, but without logging the fixups in FixupData.
 
   @retval RETURN_SUCCESS            The PE/COFF image was loaded into the buffer specified by
                                     the ImageAddress and ImageSize fields of ImageContext.
                                     Extended status information is in the ImageError field of ImageContext.
   @retval RETURN_BUFFER_TOO_SMALL   The caller did not provide a large enough buffer.
                                     Extended status information is in the ImageError field of ImageContext.
-  @retval RETURN_LOAD_ERROR         The PE/COFF image is an EFI Runtime image with no relocations.
+  @retval RETURN_LOAD_ERROR         The PE/COFF image is an EFI Runtime image with no relocations,
+                                    or its relocations are invalid.
                                     Extended status information is in the ImageError field of ImageContext.
   @retval RETURN_INVALID_PARAMETER  The image address is invalid.
                                     Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_UNSUPPORTED        A relocation record type is not supported.
+                                    Extended status information is in the ImageError field of ImageContext.
 
 **/
+STATIC
 RETURN_STATUS
-EFIAPI
-PeCoffLoaderLoadImage (
-  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+PeCoffLoaderLoadImageWorker (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext,
+  IN     BOOLEAN                       Relocate
   )
 {
   RETURN_STATUS                        Status;
@@ -1214,7 +1386,6 @@ PeCoffLoaderLoadImage (
   UINTN                                NumberOfSections;
   UINTN                                Index;
   CHAR8                                *Base;
-  CHAR8                                *End;
   EFI_IMAGE_DATA_DIRECTORY             *DirectoryEntry;
   EFI_IMAGE_DEBUG_DIRECTORY_ENTRY      *DebugEntry;
   UINTN                                Size;
@@ -1227,6 +1398,14 @@ PeCoffLoaderLoadImage (
   CHAR16                               *String;
   UINT32                               Offset;
   UINT32                               TeStrippedOffset;
+  EFI_IMAGE_SECTION_HEADER             *RelocSection;
+  UINTN                                RelocSectionEnd;
+  UINTN                                SectionEnd;
+  EFI_IMAGE_BASE_RELOCATION            *RelocBase;
+  EFI_IMAGE_BASE_RELOCATION            *RelocBaseEnd;
+  UINT64                               Adjust;
+  UINTN                                Loaded;
+  CHAR8                                *FixupData;
 
   ASSERT (ImageContext != NULL);
 
@@ -1342,51 +1521,81 @@ PeCoffLoaderLoadImage (
   }
 
   //
-  // Load each section of the image
+  // When relocating, load the section of the relocation blocks first, then
+  // apply each block as soon as the sections of its page are loaded, while
+  // they are still in the cache.
   //
-  Section = FirstSection;
-  for (Index = 0; Index < NumberOfSections; Index++) {
-    //
-    // Read the section
-    //
-    Size = (UINTN)Section->Misc.VirtualSize;
-    if ((Size == 0) || (Size > Section->SizeOfRawData)) {
-      Size = (UINTN)Section->SizeOfRawData;
+  RelocSection = NULL;
+  RelocBase    = NULL;
+  RelocBaseEnd = NULL;
+  Adjust       = 0;
+  if (Relocate && !ImageContext->RelocationsStripped) {
+    Status = PeCoffLoaderGetRelocationBlocks (ImageContext, &RelocBase, &RelocBaseEnd, &Adjust, &TeStrippedOffset);
+    if (RETURN_ERROR (Status)) {
+      return Status;
     }
 
-    //
-    // Compute sections address
-    //
-    Base = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress, TeStrippedOffset);
-    End  = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress + Section->Misc.VirtualSize - 1, TeStrippedOffset);
+    if ((Adjust != 0) && (RelocBase != NULL)) {
+      Section = FirstSection;
+      for (Index = 0; Index < NumberOfSections; Index++) {
+        Base = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress, TeStrippedOffset);
+        if ((Base != NULL) &&
+            ((UINTN)RelocBase >= (UINTN)Base) &&
+            ((UINTN)RelocBaseEnd - (UINTN)Base < MAX (Section->Misc.VirtualSize, Section->SizeOfRawData)))
+        {
+          RelocSection = Section;
+          Status       = PeCoffLoaderLoadSection (ImageContext, RelocSection, TeStrippedOffset, &RelocSectionEnd);
+          if (RETURN_ERROR (Status)) {
+            return Status;
+          }
 
-    //
-    // If the size of the section is non-zero and the base address or end address resolved to 0, then fail.
-    //
-    if ((Size > 0) && ((Base == NULL) || (End == NULL))) {
-      ImageContext->ImageError = IMAGE_ERROR_SECTION_NOT_LOADED;
-      return RETURN_LOAD_ERROR;
+          break;
+        }
+
+        Section += 1;
+      }
     }
+  }
 
-    if (Section->SizeOfRawData > 0) {
-      Status = ImageContext->ImageRead (
-                               ImageContext->Handle,
-                               Section->PointerToRawData - TeStrippedOffset,
-                               &Size,
-                               Base
-                               );
+  //
+  // Load each section of the image
+  //
+  Loaded  = (UINTN)ImageContext->ImageAddress;
+  Section = FirstSection;
+  for (Index = 0; Index < NumberOfSections; Index++) {
+    if (Section != RelocSection) {
+      Status = PeCoffLoaderLoadSection (ImageContext, Section, TeStrippedOffset, &SectionEnd);
       if (RETURN_ERROR (Status)) {
-        ImageContext->ImageError = IMAGE_ERROR_IMAGE_READ;
         return Status;
       }
+    } else {
+      SectionEnd = RelocSectionEnd;
     }
 
-    //
-    // If raw size is less then virtual size, zero fill the remaining
-    //
-
-    if (Size < Section->Misc.VirtualSize) {
-      ZeroMem (Base + Size, Section->Misc.VirtualSize - Size);
+    if (RelocSection != NULL) {
+      //
+      // The blocks are applied in order to the sections loaded so far, as
+      // long as the sections are in ascending order.
+      //
+      Base = PeCoffLoaderImageAddress (ImageContext, Section->VirtualAddress, TeStrippedOffset);
+      if ((Loaded != MAX_UINTN) && ((UINTN)Base >= Loaded)) {
+        Loaded    = SectionEnd;
+        FixupData = NULL;
+        Status    = PeCoffLoaderApplyRelocationBlocks (
+                      ImageContext,
+                      &RelocBase,
+                      RelocBaseEnd,
+                      Loaded,
+                      Adjust,
+                      TeStrippedOffset,
+                      &FixupData
+                      );
+        if (RETURN_ERROR (Status)) {
+          return Status;
+        }
+      } else {
+        Loaded = MAX_UINTN;
+      }
     }
 
     //
@@ -1395,6 +1604,26 @@ PeCoffLoaderLoadImage (
     Section += 1;
   }
 
+  if ((Adjust != 0) && (RelocBase != NULL)) {
+    //
+    // Apply the blocks left, or all of them if the relocation blocks are in no
+    // section.
+    //
+    FixupData = NULL;
+    Status    = PeCoffLoaderApplyRelocationBlocks (
+                  ImageContext,
+                  &RelocBase,
+                  RelocBaseEnd,
+                  MAX_UINTN,
+                  Adjust,
+                  TeStrippedOffset,
+                  &FixupData
+                  );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   //
   // Get image's entry point
   //
@@ -1672,9 +1901,109 @@ PeCoffLoaderLoadImage (
     }
   }
 
+  if (Relocate) {
+    //
+    // Adjust the EntryPoint to match the linked-to address
+    //
+    if ((Adjust != 0) && (ImageContext->DestinationAddress != 0)) {
+      ImageContext->EntryPoint -= (UINT64)ImageContext->ImageAddress;
+      ImageContext->EntryPoint += (UINT64)ImageContext->DestinationAddress;
+    }
+
+    // Applies additional environment specific actions to relocate fixups
+    // to a PE/COFF image if needed
+    PeCoffLoaderRelocateImageExtraAction (ImageContext);
+  }
+
   return Status;
 }
 
+/**
+  Loads a PE/COFF image into memory.
+
+  Loads the PE/COFF image accessed through the ImageRead service of ImageContext into the buffer
+  specified by the ImageAddress and ImageSize fields of ImageContext.  The caller must allocate
+  the load buffer and fill in the ImageAddress and ImageSize fields prior to calling this function.
+  The EntryPoint, FixupDataSize, CodeView, PdbPointer and HiiResourceData fields of ImageContext are computed.
+  The ImageRead, Handle, PeCoffHeaderOffset,  IsTeImage,  Machine, ImageType, ImageAddress, ImageSize,
+  DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders, and DebugDirectoryEntryRva
+  fields of the ImageContext structure must be valid prior to invoking this service.
+
+  If ImageContext is NULL, then ASSERT().
+
+  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
+  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
+  prior to transferring control to a PE/COFF image that is loaded using this library.
+
+  @param  ImageContext              The pointer to the image context structure that describes the PE/COFF
+                                    image that is being loaded.
+
+  @retval RETURN_SUCCESS            The PE/COFF image was loaded into the buffer specified by
+                                    the ImageAddress and ImageSize fields of ImageContext.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_BUFFER_TOO_SMALL   The caller did not provide a large enough buffer.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_LOAD_ERROR         The PE/COFF image is an EFI Runtime image with no relocations.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_INVALID_PARAMETER  The image address is invalid.
+                                    Extended status information is in the ImageError field of ImageContext.
+
+**/
+RETURN_STATUS
+EFIAPI
+PeCoffLoaderLoadImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+{
+  return PeCoffLoaderLoadImageWorker (ImageContext, FALSE);
+}
+
+/**
+  Loads a PE/COFF image into memory and applies its relocation fixups.
+
+  Loads the PE/COFF image as PeCoffLoaderLoadImage() does and relocates it as
+  PeCoffLoaderRelocateImage() does, in a single pass over the image. The section of
+  the relocation blocks is loaded first, then each block is applied as soon as the
+  sections it fixes up are loaded, so the image isn't read back from memory for the
+  fixups. The fixups are not logged in FixupData, so a runtime driver that needs
+  them must be loaded with PeCoffLoaderLoadImage() and PeCoffLoaderRelocateImage().
+
+  The ImageRead, Handle, PeCoffHeaderOffset, IsTeImage, Machine, ImageType, ImageAddress, ImageSize,
+  DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders, and DebugDirectoryEntryRva
+  fields of the ImageContext structure must be valid prior to invoking this service.
+
+  If ImageContext is NULL, then ASSERT().
+
+  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
+  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
+  prior to transferring control to a PE/COFF image that is loaded using this library.
+
+  @param  ImageContext              The pointer to the image context structure that describes the PE/COFF
+                                    image that is being loaded.
+
+  @retval RETURN_SUCCESS            The PE/COFF image was loaded into the buffer specified by
+                                    the ImageAddress and ImageSize fields of ImageContext, and relocated.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_BUFFER_TOO_SMALL   The caller did not provide a large enough buffer.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_LOAD_ERROR         The PE/COFF image is an EFI Runtime image with no relocations,
+                                    or its relocations are invalid.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_INVALID_PARAMETER  The image address is invalid.
+                                    Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_UNSUPPORTED        A relocation record type is not supported.
+                                    Extended status information is in the ImageError field of ImageContext.
+
+**/
+RETURN_STATUS
+EFIAPI
+PeCoffLoaderLoadAndRelocateImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+{
+  return PeCoffLoaderLoadImageWorker (ImageContext, TRUE);
+}
+
 /**
   Reapply fixups on a fixed up PE32/PE32+ image to allow virutal calling at EFI
   runtime.
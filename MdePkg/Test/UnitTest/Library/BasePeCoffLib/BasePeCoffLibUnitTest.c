@@ -0,0 +1,589 @@
+/** @file
+  Unit tests of the load and relocation services of BasePeCoffLib.
+
+  Each test builds a synthetic PE32+ image with DIR64 relocations, loads it
+  with PeCoffLoaderLoadImage() and PeCoffLoaderRelocateImage(), then with
+  PeCoffLoaderLoadAndRelocateImage(), and checks that both produce the same
+  image with every fixup applied.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <IndustryStandard/PeImage.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PeCoffLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "BasePeCoffLib Unit Test Application"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_IMAGE_BASE         0x10000000ULL
+#define TEST_DESTINATION        0x7F1234560000ULL
+#define TEST_FILE_ALIGNMENT     0x20
+#define TEST_ENTRY_POINT_DELTA  0x10
+#define TEST_MAX_SECTIONS       4
+#define TEST_MAX_FIXUPS         1024
+#define TEST_MAX_BLOCKS         64
+
+//
+// The order the relocation blocks are written in.
+//
+typedef enum {
+  BlocksInPageOrder,
+  BlocksInReverseOrder,
+  BlocksShuffled
+} TEST_BLOCK_ORDER;
+
+typedef struct {
+  CHAR8     *Name;
+  UINT32    VirtualSize;
+  UINT32    SizeOfRawData;
+} TEST_SECTION;
+
+typedef struct {
+  CONST TEST_SECTION    *Sections;
+  UINTN                 NumberOfSections;
+  UINTN                 RelocationSection;
+  UINT32                SectionAlignment;
+  TEST_BLOCK_ORDER      BlockOrder;
+  UINT32                Seed;
+} PE_COFF_TEST_CONTEXT;
+
+//
+// A synthetic image, its fixups, and the images it was loaded into.
+//
+typedef struct {
+  UINT8     *File;
+  UINTN     FileSize;
+  UINT32    SizeOfImage;
+  UINT32    AddressOfEntryPoint;
+  UINT32    Fixups[TEST_MAX_FIXUPS];
+  UINTN     NumberOfFixups;
+  UINT64    Values[TEST_MAX_FIXUPS];
+  VOID      *TwoPassImage;
+  VOID      *OnePassImage;
+} PE_COFF_TEST_IMAGE;
+
+STATIC PE_COFF_TEST_IMAGE  mImage;
+
+//
+// The relocation section last, as most linkers place it.
+//
+STATIC CONST TEST_SECTION  mRelocLastSections[] = {
+  { ".text",  0x1830, 0x1820 },
+  { ".data",  0x2000, 0x900  },
+  { ".reloc", 0x2000, 0x2000 }
+};
+
+//
+// The relocation section before the sections it fixes up.
+//
+STATIC CONST TEST_SECTION  mRelocFirstSections[] = {
+  { ".text",  0x3030, 0x3020 },
+  { ".reloc", 0x2000, 0x2000 },
+  { ".data",  0x1500, 0x1500 },
+  { ".rdata", 0x700,  0x700  }
+};
+
+//
+// Page aligned sections.
+//
+STATIC CONST TEST_SECTION  mPageAlignedSections[] = {
+  { ".text",  0x5000, 0x5000 },
+  { ".data",  0x3000, 0x3000 },
+  { ".reloc", 0x2000, 0x2000 }
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mInOrder = {
+  mRelocLastSections, ARRAY_SIZE (mRelocLastSections), 2, 0x20, BlocksInPageOrder, 1
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mReverseOrder = {
+  mRelocLastSections, ARRAY_SIZE (mRelocLastSections), 2, 0x20, BlocksInReverseOrder, 1
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mShuffled = {
+  mRelocLastSections, ARRAY_SIZE (mRelocLastSections), 2, 0x20, BlocksShuffled, 4
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mRelocFirstShuffled = {
+  mRelocFirstSections, ARRAY_SIZE (mRelocFirstSections), 1, 0x20, BlocksShuffled, 2
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mPageAlignedInOrder = {
+  mPageAlignedSections, ARRAY_SIZE (mPageAlignedSections), 2, 0x1000, BlocksInPageOrder, 3
+};
+
+STATIC PE_COFF_TEST_CONTEXT  mPageAlignedReverseOrder = {
+  mPageAlignedSections, ARRAY_SIZE (mPageAlignedSections), 2, 0x1000, BlocksInReverseOrder, 3
+};
+
+/**
+  Return the next number of a linear congruential generator.
+
+  @param[in, out]  Seed  The state of the generator.
+
+  @return A pseudo random 32-bit number.
+
+**/
+STATIC
+UINT32
+NextRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed;
+}
+
+/**
+  Build the file of a synthetic PE32+ image into mImage.
+
+  The sections other than the relocation section are filled with pseudo random
+  data. Pseudo random quadwords of them, and the last quadword of each, are
+  linked at TEST_IMAGE_BASE and described by DIR64 relocations, one block per
+  page, written in the order of Context->BlockOrder.
+
+  @param[in]  Context  The layout of the image.
+
+  @retval UNIT_TEST_PASSED  The image was built.
+  @retval other            The image could not be built.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+BuildImage (
+  IN PE_COFF_TEST_CONTEXT  *Context
+  )
+{
+  EFI_IMAGE_DOS_HEADER      *DosHdr;
+  EFI_IMAGE_NT_HEADERS64    *Hdr;
+  EFI_IMAGE_SECTION_HEADER  *SectionHdr;
+  UINT32                    SizeOfHeaders;
+  UINT32                    VirtualAddress[TEST_MAX_SECTIONS];
+  UINT32                    PointerToRawData[TEST_MAX_SECTIONS];
+  UINT32                    SizeOfRawData[TEST_MAX_SECTIONS];
+  UINT32                    VirtualSize[TEST_MAX_SECTIONS];
+  UINT8                     *Image;
+  UINT8                     *Relocations;
+  UINT32                    RelocationsSize;
+  UINT32                    BlockOffset[TEST_MAX_BLOCKS];
+  UINT32                    BlockSize[TEST_MAX_BLOCKS];
+  UINTN                     NumberOfBlocks;
+  UINT32                    Order[TEST_MAX_BLOCKS];
+  UINT32                    Seed;
+  UINT32                    Offset;
+  UINT32                    Page;
+  UINT32                    Fixup;
+  UINTN                     Index;
+  UINTN                     Count;
+  UINTN                     Swap;
+  UINT32                    Temp;
+
+  UT_ASSERT_TRUE (Context->NumberOfSections <= TEST_MAX_SECTIONS);
+
+  ZeroMem (&mImage, sizeof (mImage));
+  Seed = Context->Seed;
+
+  SizeOfHeaders = (UINT32)ALIGN_VALUE (
+                            sizeof (EFI_IMAGE_DOS_HEADER) + sizeof (EFI_IMAGE_NT_HEADERS64) +
+                            Context->NumberOfSections * sizeof (EFI_IMAGE_SECTION_HEADER),
+                            TEST_FILE_ALIGNMENT
+                            );
+
+  Offset = ALIGN_VALUE (SizeOfHeaders, Context->SectionAlignment);
+  for (Index = 0; Index < Context->NumberOfSections; Index++) {
+    VirtualAddress[Index] = Offset;
+    VirtualSize[Index]    = Context->Sections[Index].VirtualSize;
+    SizeOfRawData[Index]  = Context->Sections[Index].SizeOfRawData;
+    Offset                = ALIGN_VALUE (
+                              Offset + MAX (VirtualSize[Index], SizeOfRawData[Index]),
+                              Context->SectionAlignment
+                              );
+  }
+
+  mImage.SizeOfImage         = Offset;
+  mImage.AddressOfEntryPoint = VirtualAddress[0] + TEST_ENTRY_POINT_DELTA;
+  Image                      = AllocateZeroPool (mImage.SizeOfImage);
+  UT_ASSERT_NOT_NULL (Image);
+
+  //
+  // Fill the sections with quadwords and pick the ones to fix up, in ascending
+  // order and not overlapping.
+  //
+  for (Index = 0; Index < Context->NumberOfSections; Index++) {
+    if (Index == Context->RelocationSection) {
+      continue;
+    }
+
+    for (Offset = 0; Offset + sizeof (UINT64) <= SizeOfRawData[Index]; Offset += sizeof (UINT64)) {
+      WriteUnaligned64 (
+        (UINT64 *)(Image + VirtualAddress[Index] + Offset),
+        LShiftU64 (NextRandom (&Seed), 8) | (NextRandom (&Seed) & 0xFF)
+        );
+    }
+
+    Offset = 0;
+    while (Offset + sizeof (UINT64) < SizeOfRawData[Index]) {
+      UT_ASSERT_TRUE (mImage.NumberOfFixups < TEST_MAX_FIXUPS);
+      mImage.Fixups[mImage.NumberOfFixups++] = VirtualAddress[Index] + Offset;
+      Offset                                += sizeof (UINT64) * (1 + NextRandom (&Seed) % 16);
+    }
+
+    UT_ASSERT_TRUE (mImage.NumberOfFixups < TEST_MAX_FIXUPS);
+    mImage.Fixups[mImage.NumberOfFixups++] = VirtualAddress[Index] + SizeOfRawData[Index] - sizeof (UINT64);
+  }
+
+  //
+  // Link the fixups at TEST_IMAGE_BASE and keep the values they must have
+  // once relocated to TEST_DESTINATION.
+  //
+  for (Index = 0; Index < mImage.NumberOfFixups; Index++) {
+    Fixup = mImage.Fixups[Index];
+    WriteUnaligned64 (
+      (UINT64 *)(Image + Fixup),
+      ReadUnaligned64 ((UINT64 *)(Image + Fixup)) + TEST_IMAGE_BASE
+      );
+    mImage.Values[Index] = ReadUnaligned64 ((UINT64 *)(Image + Fixup)) - TEST_IMAGE_BASE + TEST_DESTINATION;
+  }
+
+  //
+  // Write one block of DIR64 relocations per page in page order to a scratch
+  // buffer, then copy them to the relocation section in the order to test.
+  //
+  Relocations = AllocateZeroPool (VirtualSize[Context->RelocationSection]);
+  UT_ASSERT_NOT_NULL (Relocations);
+
+  RelocationsSize = 0;
+  NumberOfBlocks  = 0;
+  Index           = 0;
+  while (Index < mImage.NumberOfFixups) {
+    UT_ASSERT_TRUE (NumberOfBlocks < TEST_MAX_BLOCKS);
+    Page                        = mImage.Fixups[Index] & ~(UINT32)EFI_PAGE_MASK;
+    BlockOffset[NumberOfBlocks] = RelocationsSize;
+    RelocationsSize            += sizeof (EFI_IMAGE_BASE_RELOCATION);
+    for (Count = 0; (Index < mImage.NumberOfFixups) && ((mImage.Fixups[Index] & ~(UINT32)EFI_PAGE_MASK) == Page); Index++, Count++) {
+      UT_ASSERT_TRUE (RelocationsSize + sizeof (UINT16) <= VirtualSize[Context->RelocationSection]);
+      WriteUnaligned16 (
+        (UINT16 *)(Relocations + RelocationsSize),
+        (UINT16)((EFI_IMAGE_REL_BASED_DIR64 << 12) | (mImage.Fixups[Index] & EFI_PAGE_MASK))
+        );
+      RelocationsSize += sizeof (UINT16);
+    }
+
+    //
+    // Pad each block to 32 bits with an absolute relocation.
+    //
+    if ((Count % 2) != 0) {
+      RelocationsSize += sizeof (UINT16);
+    }
+
+    BlockSize[NumberOfBlocks] = RelocationsSize - BlockOffset[NumberOfBlocks];
+    WriteUnaligned32 ((UINT32 *)(Relocations + BlockOffset[NumberOfBlocks]), Page);
+    WriteUnaligned32 ((UINT32 *)(Relocations + BlockOffset[NumberOfBlocks] + sizeof (UINT32)), BlockSize[NumberOfBlocks]);
+    NumberOfBlocks++;
+  }
+
+  for (Index = 0; Index < NumberOfBlocks; Index++) {
+    Order[Index] = (UINT32)Index;
+  }
+
+  if (Context->BlockOrder == BlocksInReverseOrder) {
+    for (Index = 0; Index < NumberOfBlocks; Index++) {
+      Order[Index] = (UINT32)(NumberOfBlocks - 1 - Index);
+    }
+  } else if (Context->BlockOrder == BlocksShuffled) {
+    for (Index = NumberOfBlocks - 1; Index > 0; Index--) {
+      Swap         = NextRandom (&Seed) % (Index + 1);
+      Temp         = Order[Index];
+      Order[Index] = Order[Swap];
+      Order[Swap]  = Temp;
+    }
+  }
+
+  Offset = VirtualAddress[Context->RelocationSection];
+  for (Index = 0; Index < NumberOfBlocks; Index++) {
+    CopyMem (Image + Offset, Relocations + BlockOffset[Order[Index]], BlockSize[Order[Index]]);
+    Offset += BlockSize[Order[Index]];
+  }
+
+  FreePool (Relocations);
+  VirtualSize[Context->RelocationSection]   = RelocationsSize;
+  SizeOfRawData[Context->RelocationSection] = ALIGN_VALUE (RelocationsSize, TEST_FILE_ALIGNMENT);
+
+  //
+  // Lay out the file: the headers, then the raw data of each section.
+  //
+  mImage.FileSize = SizeOfHeaders;
+  for (Index = 0; Index < Context->NumberOfSections; Index++) {
+    PointerToRawData[Index] = (UINT32)mImage.FileSize;
+    mImage.FileSize        += SizeOfRawData[Index];
+  }
+
+  mImage.File = AllocateZeroPool (mImage.FileSize);
+  UT_ASSERT_NOT_NULL (mImage.File);
+
+  for (Index = 0; Index < Context->NumberOfSections; Index++) {
+    CopyMem (mImage.File + PointerToRawData[Index], Image + VirtualAddress[Index], SizeOfRawData[Index]);
+  }
+
+  FreePool (Image);
+
+  DosHdr           = (EFI_IMAGE_DOS_HEADER *)mImage.File;
+  DosHdr->e_magic  = EFI_IMAGE_DOS_SIGNATURE;
+  DosHdr->e_lfanew = sizeof (EFI_IMAGE_DOS_HEADER);
+
+  Hdr                                  = (EFI_IMAGE_NT_HEADERS64 *)(mImage.File + DosHdr->e_lfanew);
+  Hdr->Signature                       = EFI_IMAGE_NT_SIGNATURE;
+  Hdr->FileHeader.Machine              = IMAGE_FILE_MACHINE_X64;
+  Hdr->FileHeader.NumberOfSections     = (UINT16)Context->NumberOfSections;
+  Hdr->FileHeader.SizeOfOptionalHeader = sizeof (EFI_IMAGE_OPTIONAL_HEADER64);
+  Hdr->FileHeader.Characteristics      = EFI_IMAGE_FILE_EXECUTABLE_IMAGE;
+
+  Hdr->OptionalHeader.Magic               = EFI_IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+  Hdr->OptionalHeader.AddressOfEntryPoint = mImage.AddressOfEntryPoint;
+  Hdr->OptionalHeader.BaseOfCode          = VirtualAddress[0];
+  Hdr->OptionalHeader.ImageBase           = TEST_IMAGE_BASE;
+  Hdr->OptionalHeader.SectionAlignment    = Context->SectionAlignment;
+  Hdr->OptionalHeader.FileAlignment       = TEST_FILE_ALIGNMENT;
+  Hdr->OptionalHeader.SizeOfImage         = mImage.SizeOfImage;
+  Hdr->OptionalHeader.SizeOfHeaders       = SizeOfHeaders;
+  Hdr->OptionalHeader.Subsystem           = EFI_IMAGE_SUBSYSTEM_EFI_APPLICATION;
+  Hdr->OptionalHeader.NumberOfRvaAndSizes = EFI_IMAGE_NUMBER_OF_DIRECTORY_ENTRIES;
+
+  Hdr->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC].VirtualAddress = VirtualAddress[Context->RelocationSection];
+  Hdr->OptionalHeader.DataDirectory[EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC].Size           = RelocationsSize;
+
+  SectionHdr = (EFI_IMAGE_SECTION_HEADER *)(Hdr + 1);
+  for (Index = 0; Index < Context->NumberOfSections; Index++) {
+    CopyMem (SectionHdr[Index].Name, Context->Sections[Index].Name, AsciiStrLen (Context->Sections[Index].Name));
+    SectionHdr[Index].Misc.VirtualSize = VirtualSize[Index];
+    SectionHdr[Index].VirtualAddress   = VirtualAddress[Index];
+    SectionHdr[Index].SizeOfRawData    = SizeOfRawData[Index];
+    SectionHdr[Index].PointerToRawData = PointerToRawData[Index];
+    SectionHdr[Index].Characteristics  = EFI_IMAGE_SCN_CNT_CODE | EFI_IMAGE_SCN_MEM_EXECUTE | EFI_IMAGE_SCN_MEM_READ;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Load mImage.File at TEST_DESTINATION with the two passes or the single pass.
+
+  @param[in]   OnePass      TRUE to use PeCoffLoaderLoadAndRelocateImage().
+  @param[out]  Image        The loaded image, from AllocatePages().
+  @param[out]  EntryOffset  The offset of the entry point in the image.
+
+  @retval UNIT_TEST_PASSED  The image was loaded and relocated.
+  @retval other            The image could not be loaded.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+LoadTestImage (
+  IN  BOOLEAN  OnePass,
+  OUT VOID     **Image,
+  OUT UINT64   *EntryOffset
+  )
+{
+  PE_COFF_LOADER_IMAGE_CONTEXT  ImageContext;
+  RETURN_STATUS                 Status;
+
+  ZeroMem (&ImageContext, sizeof (ImageContext));
+  ImageContext.Handle    = mImage.File;
+  ImageContext.ImageRead = PeCoffLoaderImageReadFromMemory;
+
+  Status = PeCoffLoaderGetImageInfo (&ImageContext);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ImageContext.ImageSize, mImage.SizeOfImage);
+  UT_ASSERT_FALSE (ImageContext.RelocationsStripped);
+
+  *Image = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN)ImageContext.ImageSize));
+  UT_ASSERT_NOT_NULL (*Image);
+  ZeroMem (*Image, (UINTN)ImageContext.ImageSize);
+
+  ImageContext.ImageAddress       = (PHYSICAL_ADDRESS)(UINTN)*Image;
+  ImageContext.DestinationAddress = TEST_DESTINATION;
+
+  if (OnePass) {
+    Status = PeCoffLoaderLoadAndRelocateImage (&ImageContext);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  } else {
+    Status = PeCoffLoaderLoadImage (&ImageContext);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    Status = PeCoffLoaderRelocateImage (&ImageContext);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  *EntryOffset = ImageContext.EntryPoint - ImageContext.DestinationAddress;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Build the test image described by the context.
+
+  @param[in]  Context  The PE_COFF_TEST_CONTEXT of the test.
+
+  @retval UNIT_TEST_PASSED  The image was built.
+  @retval other            The image could not be built.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+BuildTestImage (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return BuildImage ((PE_COFF_TEST_CONTEXT *)Context);
+}
+
+/**
+  Free the test image and the images it was loaded into.
+
+  @param[in]  Context  The PE_COFF_TEST_CONTEXT of the test.
+
+**/
+STATIC
+VOID
+EFIAPI
+FreeTestImage (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mImage.TwoPassImage != NULL) {
+    FreePages (mImage.TwoPassImage, EFI_SIZE_TO_PAGES (mImage.SizeOfImage));
+  }
+
+  if (mImage.OnePassImage != NULL) {
+    FreePages (mImage.OnePassImage, EFI_SIZE_TO_PAGES (mImage.SizeOfImage));
+  }
+
+  if (mImage.File != NULL) {
+    FreePool (mImage.File);
+  }
+
+  ZeroMem (&mImage, sizeof (mImage));
+}
+
+/**
+  Check that PeCoffLoaderLoadAndRelocateImage() loads and relocates the image
+  as PeCoffLoaderLoadImage() and PeCoffLoaderRelocateImage() do.
+
+  @param[in]  Context  The PE_COFF_TEST_CONTEXT of the test.
+
+  @retval UNIT_TEST_PASSED             Both loads produced the expected image.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The images differ or a fixup is wrong.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LoadAndRelocateMatchesTwoPasses (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  Status;
+  UINT64            TwoPassEntry;
+  UINT64            OnePassEntry;
+  UINT8             *Image;
+  UINTN             Index;
+
+  Status = LoadTestImage (FALSE, &mImage.TwoPassImage, &TwoPassEntry);
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  Status = LoadTestImage (TRUE, &mImage.OnePassImage, &OnePassEntry);
+  if (Status != UNIT_TEST_PASSED) {
+    return Status;
+  }
+
+  UT_ASSERT_EQUAL (TwoPassEntry, mImage.AddressOfEntryPoint);
+  UT_ASSERT_EQUAL (OnePassEntry, TwoPassEntry);
+  UT_ASSERT_MEM_EQUAL (mImage.OnePassImage, mImage.TwoPassImage, mImage.SizeOfImage);
+
+  Image = mImage.OnePassImage;
+  for (Index = 0; Index < mImage.NumberOfFixups; Index++) {
+    UT_ASSERT_EQUAL (ReadUnaligned64 ((UINT64 *)(Image + mImage.Fixups[Index])), mImage.Values[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the load and
+  relocation services of BasePeCoffLib and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      LoadAndRelocateTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&LoadAndRelocateTests, Framework, "PE/COFF Load And Relocate Tests", "BasePeCoffLib.LoadAndRelocate", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the PE/COFF Load And Relocate Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (LoadAndRelocateTests, "Relocation blocks in page order", "InOrder", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mInOrder);
+  AddTestCase (LoadAndRelocateTests, "Relocation blocks in reverse order", "ReverseOrder", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mReverseOrder);
+  AddTestCase (LoadAndRelocateTests, "Relocation blocks shuffled", "Shuffled", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mShuffled);
+  AddTestCase (LoadAndRelocateTests, "Relocation section first, blocks shuffled", "RelocFirstShuffled", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mRelocFirstShuffled);
+  AddTestCase (LoadAndRelocateTests, "Page aligned sections, blocks in page order", "PageAlignedInOrder", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mPageAlignedInOrder);
+  AddTestCase (LoadAndRelocateTests, "Page aligned sections, blocks in reverse order", "PageAlignedReverseOrder", LoadAndRelocateMatchesTwoPasses, BuildTestImage, FreeTestImage, &mPageAlignedReverseOrder);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
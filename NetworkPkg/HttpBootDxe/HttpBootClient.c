@@ -597,7 +597,7 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create the pool of HttpIo connections for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
 
@@ -636,14 +636,18 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
+  //
+  // The HTTP children are created on demand, one per server the boot files
+  // are fetched from, and keep their connections open between requests.
+  //
+  Status = HttpIoPoolInit (
              ImageHandle,
              Private->Controller,
              Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
              &ConfigData,
              HttpBootHttpIoCallback,
              (VOID *)Private,
-             &Private->HttpIo
+             &Private->HttpIoPool
              );
   if (EFI_ERROR (Status)) {
     return Status;
@@ -1117,9 +1121,13 @@ HttpBootGetBootFile (
   }
 
   //
-  // 2.4 Send out the request to HTTP server.
+  // 2.4 Send out the request to HTTP server, on the connection to its host.
   //
-  HttpIo = &Private->HttpIo;
+  Status = HttpIoPoolGetIo (&Private->HttpIoPool, Private->BootFileUri, &HttpIo);
+  if (EFI_ERROR (Status)) {
+    goto ERROR_4;
+  }
+
   Status = HttpIoSendRequest (
              HttpIo,
              RequestData,
@@ -1147,7 +1155,7 @@ HttpBootGetBootFile (
 
   Data   = NULL;
   Status = HttpIoRecvResponse (
-             &Private->HttpIo,
+             HttpIo,
              TRUE,
              ResponseData
              );
@@ -1300,7 +1308,7 @@ HttpBootGetBootFile (
         ResponseBody.Body       = (CHAR8 *)Buffer + ReceivedSize;
         ResponseBody.BodyLength = *BufferSize - ReceivedSize;
         Status                  = HttpIoRecvResponse (
-                                    &Private->HttpIo,
+                                    HttpIo,
                                     FALSE,
                                     &ResponseBody
                                     );
@@ -1355,7 +1363,7 @@ HttpBootGetBootFile (
         ResponseBody.Body       = (CHAR8 *)Block;
         ResponseBody.BodyLength = HTTP_BOOT_BLOCK_SIZE;
         Status                  = HttpIoRecvResponse (
-                                    &Private->HttpIo,
+                                    HttpIo,
                                     FALSE,
                                     &ResponseBody
                                     );
@@ -73,7 +73,7 @@ HttpBootDiscoverBootInfo (
   );
 
 /**
-  Create a HttpIo instance for the file download.
+  Create the pool of HttpIo connections for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
 
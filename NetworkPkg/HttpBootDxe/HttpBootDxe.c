@@ -154,7 +154,7 @@ HttpBootDestroyIp4Children (
   }
 
   if ((Private->Ip6Nic == NULL) && Private->HttpCreated) {
-    HttpIoDestroyIo (&Private->HttpIo);
+    HttpIoPoolDestroy (&Private->HttpIoPool);
     Private->HttpCreated = FALSE;
   }
 
@@ -228,7 +228,7 @@ HttpBootDestroyIp6Children (
   }
 
   if ((Private->Ip4Nic == NULL) && Private->HttpCreated) {
-    HttpIoDestroyIo (&Private->HttpIo);
+    HttpIoPoolDestroy (&Private->HttpIoPool);
     Private->HttpCreated = FALSE;
   }
 
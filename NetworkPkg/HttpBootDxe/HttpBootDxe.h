@@ -153,7 +153,7 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   EFI_HANDLE                                   Ip6Child;
   EFI_HANDLE                                   Dhcp4Child;
   EFI_HANDLE                                   Dhcp6Child;
-  HTTP_IO                                      HttpIo;
+  HTTP_IO_POOL                                 HttpIoPool;
   BOOLEAN                                      HttpCreated;
 
   //
@@ -459,7 +459,7 @@ HttpBootStop (
   }
 
   if (Private->HttpCreated) {
-    HttpIoDestroyIo (&Private->HttpIo);
+    HttpIoPoolDestroy (&Private->HttpIoPool);
     Private->HttpCreated = FALSE;
   }
 
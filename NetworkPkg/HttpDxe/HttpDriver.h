@@ -47,6 +47,8 @@
 #include <Protocol/Ip6Config.h>
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
+#include <Protocol/TlsRecord.h>
+#include <Protocol/TlsSessionCache.h>
 #include <Protocol/HttpCallback.h>
 
 #include <Guid/ImageAuthentication.h>
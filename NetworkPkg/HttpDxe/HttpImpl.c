@@ -385,7 +385,8 @@ EfiHttpRequest (
                                        ImageHandle,
                                        &(HttpInstance->TlsSb),
                                        &(HttpInstance->Tls),
-                                       &(HttpInstance->TlsConfiguration)
+                                       &(HttpInstance->TlsConfiguration),
+                                       &(HttpInstance->TlsRecord)
                                        );
       if (HttpInstance->TlsChildHandle == NULL) {
         return EFI_DEVICE_ERROR;
@@ -747,9 +748,11 @@ HttpCancelTokens (
   IN VOID          *Context
   )
 {
+  EFI_STATUS       Status;
   EFI_HTTP_TOKEN   *Token;
   HTTP_TOKEN_WRAP  *Wrap;
   HTTP_PROTOCOL    *HttpInstance;
+  EFI_EVENT        TxEvent;
 
   Token = (EFI_HTTP_TOKEN *)Context;
 
@@ -791,6 +794,56 @@ HttpCancelTokens (
     }
   }
 
+  if (Map == &HttpInstance->TxTokens) {
+    //
+    // A request token stays in TxTokens until its response is received, so
+    // remove it for the caller to be able to free it.
+    //
+    if (!Wrap->TcpWrap.IsTxDone) {
+      if (!HttpInstance->LocalAddressIsIPv6) {
+        TxEvent = Wrap->TcpWrap.Tx4Token.CompletionToken.Event;
+        Status  = HttpInstance->Tcp4->Cancel (HttpInstance->Tcp4, &Wrap->TcpWrap.Tx4Token.CompletionToken);
+      } else {
+        TxEvent = Wrap->TcpWrap.Tx6Token.CompletionToken.Event;
+        Status  = HttpInstance->Tcp6->Cancel (HttpInstance->Tcp6, &Wrap->TcpWrap.Tx6Token.CompletionToken);
+      }
+
+      //
+      // Dispatch the DPC queued by the NotifyFunction of the canceled token's
+      // event, it signals the user's token and closes the event.
+      //
+      DispatchDpc ();
+
+      if (!Wrap->TcpWrap.IsTxDone) {
+        if (Status != EFI_NOT_FOUND) {
+          //
+          // TCP still owns the request, keep the wrap for its NotifyFunction.
+          //
+          return (Token != NULL) ? EFI_ABORTED : EFI_SUCCESS;
+        }
+
+        //
+        // The request is queued behind another one and TCP has never seen it.
+        //
+        if (TxEvent != NULL) {
+          gBS->CloseEvent (TxEvent);
+        }
+
+        Wrap->HttpToken->Status = EFI_ABORTED;
+        gBS->SignalEvent (Wrap->HttpToken->Event);
+      }
+    }
+
+    //
+    // The response of a request already sent can't be told from the one of
+    // the next request any more, so don't reuse the connection.
+    //
+    HttpInstance->ConnectionClose = TRUE;
+
+    NetMapRemoveItem (Map, Item, NULL);
+    FreePool (Wrap);
+  }
+
   //
   // If only one item is to be cancel, return EFI_ABORTED to stop
   // iterating the map any more.
@@ -995,6 +1048,7 @@ HttpResponseWorker (
   NET_FRAGMENT      Fragment;
   UINT32            TimeoutValue;
   UINTN             Index;
+  UINTN             ReceivedLength;
 
   if ((Wrap == NULL) || (Wrap->HttpInstance == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -1375,7 +1429,18 @@ HttpResponseWorker (
       goto Error2;
     }
 
-    Status = HttpsReceive (HttpInstance, &Fragment, HttpInstance->TimeoutEvent);
+    //
+    // Decrypt the body straight into the caller's buffer, anything that
+    // doesn't fit is returned in Fragment.
+    //
+    ReceivedLength = HttpMsg->BodyLength;
+    Status         = HttpsReceiveToBuffer (
+                       HttpInstance,
+                       HttpMsg->Body,
+                       &ReceivedLength,
+                       &Fragment,
+                       HttpInstance->TimeoutEvent
+                       );
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
 
@@ -1386,9 +1451,7 @@ HttpResponseWorker (
     //
     // Process the received the body packet.
     //
-    HttpMsg->BodyLength = MIN ((UINTN)Fragment.Len, HttpMsg->BodyLength);
-
-    CopyMem (HttpMsg->Body, Fragment.Bulk, HttpMsg->BodyLength);
+    HttpMsg->BodyLength = ReceivedLength;
 
     //
     // Record the CallbackData data.
@@ -1424,7 +1487,11 @@ HttpResponseWorker (
       HttpMsg->BodyLength = HttpInstance->NextMsg - (CHAR8 *)HttpMsg->Body;
     }
 
-    HttpInstance->CacheLen = Fragment.Len - HttpMsg->BodyLength;
+    //
+    // Cache the next message header left in HttpMsg->Body, followed by
+    // the data that didn't fit in it.
+    //
+    HttpInstance->CacheLen = ReceivedLength - HttpMsg->BodyLength + Fragment.Len;
     if (HttpInstance->CacheLen != 0) {
       if (HttpInstance->CacheBody != NULL) {
         FreePool (HttpInstance->CacheBody);
@@ -1436,7 +1503,8 @@ HttpResponseWorker (
         goto Error2;
       }
 
-      CopyMem (HttpInstance->CacheBody, Fragment.Bulk + HttpMsg->BodyLength, HttpInstance->CacheLen);
+      CopyMem (HttpInstance->CacheBody, (UINT8 *)HttpMsg->Body + HttpMsg->BodyLength, ReceivedLength - HttpMsg->BodyLength);
+      CopyMem (HttpInstance->CacheBody + ReceivedLength - HttpMsg->BodyLength, Fragment.Bulk, Fragment.Len);
       HttpInstance->CacheOffset = 0;
       if (HttpInstance->NextMsg != NULL) {
         HttpInstance->NextMsg = HttpInstance->CacheBody;
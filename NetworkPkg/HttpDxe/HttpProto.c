@@ -858,6 +858,7 @@ HttpCleanProtocol (
     //
     HttpInstance->TlsSb->DestroyChild (HttpInstance->TlsSb, HttpInstance->TlsChildHandle);
     HttpInstance->TlsChildHandle = NULL;
+    HttpInstance->TlsRecord      = NULL;
   }
 
   if (HttpInstance->Tcp4ChildHandle != NULL) {
@@ -1487,82 +1488,66 @@ HttpTransmitTcp (
   EFI_TCP6_IO_TOKEN  *Tx6Token;
   EFI_TCP6_PROTOCOL  *Tcp6;
   UINT8              *TlsRecord;
+  UINTN              TlsRecordLen;
   UINT16             PayloadSize;
-  NET_FRAGMENT       TempFragment;
   NET_FRAGMENT       Fragment;
   UINTN              RecordCount;
   UINTN              RemainingLen;
 
-  Status            = EFI_SUCCESS;
-  TlsRecord         = NULL;
-  PayloadSize       = 0;
-  TempFragment.Len  = 0;
-  TempFragment.Bulk = NULL;
-  Fragment.Len      = 0;
-  Fragment.Bulk     = NULL;
-  RecordCount       = 0;
-  RemainingLen      = 0;
+  Status        = EFI_SUCCESS;
+  TlsRecord     = NULL;
+  TlsRecordLen  = 0;
+  PayloadSize   = 0;
+  Fragment.Len  = 0;
+  Fragment.Bulk = NULL;
+  RecordCount   = 0;
+  RemainingLen  = 0;
 
   //
   // Need to encrypt data.
   //
   if (HttpInstance->UseHttps) {
     //
-    // Allocate enough buffer for each TLS plaintext records.
+    // Allocate enough buffer for all TLS plaintext records, so that they
+    // are encrypted by the TLS protocol in one call.
     //
-    TlsRecord = AllocateZeroPool (TLS_RECORD_HEADER_LENGTH + TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH);
+    RecordCount = TxStringLen / TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH + 1;
+    TlsRecord   = AllocatePool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH));
     if (TlsRecord == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       return Status;
     }
 
     //
-    // Allocate enough buffer for all TLS ciphertext records.
-    //
-    RecordCount   = TxStringLen / TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH + 1;
-    Fragment.Bulk = AllocateZeroPool (RecordCount * (TLS_RECORD_HEADER_LENGTH + TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH));
-    if (Fragment.Bulk == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      goto ON_ERROR;
-    }
-
-    //
-    // Encrypt each TLS plaintext records.
+    // Build the TLS plaintext records back to back.
     //
     RemainingLen = TxStringLen;
     while (RemainingLen != 0) {
       PayloadSize = (UINT16)MIN (TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH, RemainingLen);
 
-      ((TLS_RECORD_HEADER *)TlsRecord)->ContentType   = TlsContentTypeApplicationData;
-      ((TLS_RECORD_HEADER *)TlsRecord)->Version.Major = HttpInstance->TlsConfigData.Version.Major;
-      ((TLS_RECORD_HEADER *)TlsRecord)->Version.Minor = HttpInstance->TlsConfigData.Version.Minor;
-      ((TLS_RECORD_HEADER *)TlsRecord)->Length        = PayloadSize;
-
-      CopyMem (TlsRecord + TLS_RECORD_HEADER_LENGTH, TxString + (TxStringLen - RemainingLen), PayloadSize);
-
-      Status = TlsProcessMessage (
-                 HttpInstance,
-                 TlsRecord,
-                 TLS_RECORD_HEADER_LENGTH + PayloadSize,
-                 EfiTlsEncrypt,
-                 &TempFragment
-                 );
-      if (EFI_ERROR (Status)) {
-        goto ON_ERROR;
-      }
-
-      //
-      // Record the processed/encrypted Packet.
-      //
-      CopyMem (Fragment.Bulk + Fragment.Len, TempFragment.Bulk, TempFragment.Len);
-      Fragment.Len += TempFragment.Len;
+      ((TLS_RECORD_HEADER *)(TlsRecord + TlsRecordLen))->ContentType   = TlsContentTypeApplicationData;
+      ((TLS_RECORD_HEADER *)(TlsRecord + TlsRecordLen))->Version.Major = HttpInstance->TlsConfigData.Version.Major;
+      ((TLS_RECORD_HEADER *)(TlsRecord + TlsRecordLen))->Version.Minor = HttpInstance->TlsConfigData.Version.Minor;
+      ((TLS_RECORD_HEADER *)(TlsRecord + TlsRecordLen))->Length        = PayloadSize;
 
-      FreePool (TempFragment.Bulk);
-      TempFragment.Len  = 0;
-      TempFragment.Bulk = NULL;
+      CopyMem (TlsRecord + TlsRecordLen + TLS_RECORD_HEADER_LENGTH, TxString + (TxStringLen - RemainingLen), PayloadSize);
 
+      TlsRecordLen += TLS_RECORD_HEADER_LENGTH + PayloadSize;
       RemainingLen -= (UINTN)PayloadSize;
-      ZeroMem (TlsRecord, TLS_RECORD_HEADER_LENGTH + TLS_PLAINTEXT_RECORD_MAX_PAYLOAD_LENGTH);
+    }
+
+    //
+    // Encrypt all the TLS plaintext records.
+    //
+    Status = TlsProcessMessage (
+               HttpInstance,
+               TlsRecord,
+               TlsRecordLen,
+               EfiTlsEncrypt,
+               &Fragment
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
     }
 
     FreePool (TlsRecord);
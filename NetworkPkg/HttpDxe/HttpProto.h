@@ -175,6 +175,7 @@ typedef struct _HTTP_PROTOCOL {
   TLS_CONFIG_DATA                   TlsConfigData;
   EFI_TLS_PROTOCOL                  *Tls;
   EFI_TLS_CONFIGURATION_PROTOCOL    *TlsConfiguration;
+  EDKII_TLS_RECORD_PROTOCOL         *TlsRecord;
   EFI_TLS_SESSION_STATE             TlsSessionState;
 
   //
@@ -134,10 +134,14 @@ IsHttpsUrl (
 /**
   Creates a Tls child handle, open EFI_TLS_PROTOCOL and EFI_TLS_CONFIGURATION_PROTOCOL.
 
+  The EDKII_TLS_RECORD_PROTOCOL is opened too if the TLS driver produces it.
+
   @param[in]  ImageHandle           The firmware allocated handle for the UEFI image.
   @param[out] TlsSb                 Pointer to the TLS SERVICE_BINDING_PROTOCOL.
   @param[out] TlsProto              Pointer to the EFI_TLS_PROTOCOL instance.
   @param[out] TlsConfiguration      Pointer to the EFI_TLS_CONFIGURATION_PROTOCOL instance.
+  @param[out] TlsRecord             Pointer to the EDKII_TLS_RECORD_PROTOCOL instance,
+                                    NULL if the TLS child doesn't have it.
 
   @return  The child handle with opened EFI_TLS_PROTOCOL and EFI_TLS_CONFIGURATION_PROTOCOL.
 
@@ -148,7 +152,8 @@ TlsCreateChild (
   IN  EFI_HANDLE                      ImageHandle,
   OUT EFI_SERVICE_BINDING_PROTOCOL    **TlsSb,
   OUT EFI_TLS_PROTOCOL                **TlsProto,
-  OUT EFI_TLS_CONFIGURATION_PROTOCOL  **TlsConfiguration
+  OUT EFI_TLS_CONFIGURATION_PROTOCOL  **TlsConfiguration,
+  OUT EDKII_TLS_RECORD_PROTOCOL       **TlsRecord
   )
 {
   EFI_STATUS  Status;
@@ -199,6 +204,18 @@ TlsCreateChild (
     return NULL;
   }
 
+  Status = gBS->OpenProtocol (
+                  TlsChildHandle,
+                  &gEdkiiTlsRecordProtocolGuid,
+                  (VOID **)TlsRecord,
+                  ImageHandle,
+                  TlsChildHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    *TlsRecord = NULL;
+  }
+
   return TlsChildHandle;
 }
 
@@ -639,7 +656,9 @@ TlsConfigureSession (
   IN OUT HTTP_PROTOCOL  *HttpInstance
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS                        Status;
+  EFI_HANDLE                        ImageHandle;
+  EDKII_TLS_SESSION_CACHE_PROTOCOL  *TlsSessionCache;
 
   //
   // TlsConfigData initialization
@@ -686,6 +705,28 @@ TlsConfigureSession (
     return Status;
   }
 
+  //
+  // Let the TLS driver resume the session of a previous connection to the
+  // same host and port, if it can.
+  //
+  if (HttpInstance->LocalAddressIsIPv6) {
+    ImageHandle = HttpInstance->Service->Ip6DriverBindingHandle;
+  } else {
+    ImageHandle = HttpInstance->Service->Ip4DriverBindingHandle;
+  }
+
+  Status = gBS->OpenProtocol (
+                  HttpInstance->TlsChildHandle,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  (VOID **)&TlsSessionCache,
+                  ImageHandle,
+                  HttpInstance->TlsChildHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (!EFI_ERROR (Status)) {
+    TlsSessionCache->SetPeer (TlsSessionCache, HttpInstance->RemotePort);
+  }
+
   Status = HttpInstance->Tls->SetSessionData (
                                 HttpInstance->Tls,
                                 EfiTlsSessionState,
@@ -1623,13 +1664,260 @@ ON_EXIT:
 }
 
 /**
-  Receive one fragment decrypted from one TLS record.
+  Decrypt the TLS application data record received in a net buffer.
+
+  The blocks of Pdu are handed to the TLS protocol as its fragment table,
+  so the ciphertext isn't gathered into a linear buffer first.
+
+  @param[in]       HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]       Pdu             The net buffer holding the TLS record.
+  @param[out]      Fragment        The TLS header and plain text TLS APP payload,
+                                   in a buffer to be freed by the caller.
+
+  @retval EFI_SUCCESS          The record is decrypted successfully.
+  @retval EFI_OUT_OF_RESOURCES Can't allocate memory resources.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+TlsDecryptPdu (
+  IN     HTTP_PROTOCOL  *HttpInstance,
+  IN     NET_BUF        *Pdu,
+  OUT    NET_FRAGMENT   *Fragment
+  )
+{
+  EFI_STATUS             Status;
+  NET_FRAGMENT           *ExtFragment;
+  UINT32                 ExtNum;
+  EFI_TLS_FRAGMENT_DATA  *FragmentTable;
+  EFI_TLS_FRAGMENT_DATA  *OriginalFragmentTable;
+  UINT32                 FragmentCount;
+  UINT8                  *Buffer;
+  UINT32                 BufferSize;
+  UINT32                 BytesCopied;
+  UINT32                 Index;
+
+  Buffer                = NULL;
+  BufferSize            = 0;
+  OriginalFragmentTable = NULL;
+  ExtNum                = Pdu->BlockOpNum;
+
+  ExtFragment   = AllocatePool (ExtNum * sizeof (NET_FRAGMENT));
+  FragmentTable = AllocatePool (ExtNum * sizeof (EFI_TLS_FRAGMENT_DATA));
+  if ((ExtFragment == NULL) || (FragmentTable == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  NetbufBuildExt (Pdu, ExtFragment, &ExtNum);
+
+  for (Index = 0; Index < ExtNum; Index++) {
+    FragmentTable[Index].FragmentLength = ExtFragment[Index].Len;
+    FragmentTable[Index].FragmentBuffer = ExtFragment[Index].Bulk;
+  }
+
+  FragmentCount         = ExtNum;
+  OriginalFragmentTable = FragmentTable;
+
+  Status = HttpInstance->Tls->ProcessPacket (
+                                HttpInstance->Tls,
+                                &FragmentTable,
+                                &FragmentCount,
+                                EfiTlsDecrypt
+                                );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  if (FragmentCount == 1) {
+    //
+    // The usual case: hand the only output fragment to the caller as is.
+    //
+    Fragment->Bulk = FragmentTable[0].FragmentBuffer;
+    Fragment->Len  = FragmentTable[0].FragmentLength;
+    Status         = EFI_SUCCESS;
+    goto ON_EXIT;
+  }
+
+  for (Index = 0; Index < FragmentCount; Index++) {
+    BufferSize += FragmentTable[Index].FragmentLength;
+  }
+
+  Buffer = AllocatePool (BufferSize);
+  if (Buffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0, BytesCopied = 0; Index < FragmentCount; Index++) {
+    if (Buffer != NULL) {
+      CopyMem (Buffer + BytesCopied, FragmentTable[Index].FragmentBuffer, FragmentTable[Index].FragmentLength);
+      BytesCopied += FragmentTable[Index].FragmentLength;
+    }
+
+    FreePool (FragmentTable[Index].FragmentBuffer);
+  }
+
+  Fragment->Bulk = Buffer;
+  Fragment->Len  = BufferSize;
+
+ON_EXIT:
+  if (ExtFragment != NULL) {
+    FreePool (ExtFragment);
+  }
+
+  if (OriginalFragmentTable != NULL) {
+    if (FragmentTable == OriginalFragmentTable) {
+      FragmentTable = NULL;
+    }
+
+    FreePool (OriginalFragmentTable);
+  }
+
+  //
+  // Caller has the responsibility to free the FragmentTable.
+  //
+  if (FragmentTable != NULL) {
+    FreePool (FragmentTable);
+  }
+
+  return Status;
+}
+
+/**
+  Decrypt the TLS application data record received in a net buffer into the
+  caller's buffer.
+
+  With the EDKII TLS Record Protocol, the blocks of Pdu are decrypted by the
+  TLS child straight into Buffer. Without it, the record is decrypted with
+  TlsDecryptPdu() and its payload is copied to Buffer.
+
+  @param[in]       HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]       Pdu             The net buffer holding the TLS record.
+  @param[out]      Buffer          The buffer to receive the payload in. May be NULL
+                                   if BufferSize is zero.
+  @param[in, out]  BufferSize      On input, the size of Buffer. On output, the number
+                                   of bytes written to Buffer.
+  @param[out]      Remainder       The rest of the payload, in a buffer to be freed by
+                                   the caller. NULL if there is none.
+  @param[out]      RemainderSize   The size of Remainder.
+
+  @retval EFI_SUCCESS          The record is decrypted successfully.
+  @retval EFI_OUT_OF_RESOURCES Can't allocate memory resources.
+  @retval EFI_ABORTED          Something wrong decryption the message.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+TlsDecryptPduToBuffer (
+  IN     HTTP_PROTOCOL  *HttpInstance,
+  IN     NET_BUF        *Pdu,
+  OUT    UINT8          *Buffer OPTIONAL,
+  IN OUT UINTN          *BufferSize,
+  OUT    UINT8          **Remainder,
+  OUT    UINTN          *RemainderSize
+  )
+{
+  EFI_STATUS             Status;
+  NET_FRAGMENT           TempFragment;
+  UINT8                  *Payload;
+  UINTN                  PayloadSize;
+  UINTN                  Copied;
+  NET_FRAGMENT           *ExtFragment;
+  EFI_TLS_FRAGMENT_DATA  *FragmentTable;
+  UINT32                 ExtNum;
+  UINT32                 Index;
+
+  *Remainder     = NULL;
+  *RemainderSize = 0;
+
+  if (HttpInstance->TlsRecord == NULL) {
+    Status = TlsDecryptPdu (HttpInstance, Pdu, &TempFragment);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    ASSERT (((TLS_RECORD_HEADER *)(TempFragment.Bulk))->ContentType == TlsContentTypeApplicationData);
+
+    Payload     = TempFragment.Bulk + TLS_RECORD_HEADER_LENGTH;
+    PayloadSize = ((TLS_RECORD_HEADER *)(TempFragment.Bulk))->Length;
+    Copied      = MIN (PayloadSize, *BufferSize);
+
+    CopyMem (Buffer, Payload, Copied);
+
+    if (PayloadSize > Copied) {
+      *Remainder = AllocatePool (PayloadSize - Copied);
+      if (*Remainder == NULL) {
+        FreePool (TempFragment.Bulk);
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      *RemainderSize = PayloadSize - Copied;
+      CopyMem (*Remainder, Payload + Copied, *RemainderSize);
+    }
+
+    FreePool (TempFragment.Bulk);
+
+    *BufferSize = Copied;
+    return EFI_SUCCESS;
+  }
+
+  ExtNum        = Pdu->BlockOpNum;
+  ExtFragment   = AllocatePool (ExtNum * sizeof (NET_FRAGMENT));
+  FragmentTable = AllocatePool (ExtNum * sizeof (EFI_TLS_FRAGMENT_DATA));
+  if ((ExtFragment == NULL) || (FragmentTable == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  NetbufBuildExt (Pdu, ExtFragment, &ExtNum);
+
+  for (Index = 0; Index < ExtNum; Index++) {
+    FragmentTable[Index].FragmentLength = ExtFragment[Index].Len;
+    FragmentTable[Index].FragmentBuffer = ExtFragment[Index].Bulk;
+  }
+
+  Status = HttpInstance->TlsRecord->DecryptToBuffer (
+                                      HttpInstance->TlsRecord,
+                                      FragmentTable,
+                                      ExtNum,
+                                      Buffer,
+                                      BufferSize,
+                                      Remainder,
+                                      RemainderSize
+                                      );
+
+ON_EXIT:
+  if (ExtFragment != NULL) {
+    FreePool (ExtFragment);
+  }
+
+  if (FragmentTable != NULL) {
+    FreePool (FragmentTable);
+  }
+
+  return Status;
+}
+
+/**
+  Receive one TLS record and decrypt its payload into the caller's buffer.
+
+  The TLS APP payload is decrypted straight into Buffer when the TLS child
+  has the EDKII TLS Record Protocol, and copied once from the output of the
+  TLS protocol otherwise. The part of the payload that doesn't fit in Buffer,
+  or the whole record if it isn't application data, is returned in Fragment.
 
   @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
-  @param[in, out]      Fragment        The received Fragment.
+  @param[out]          Buffer          The buffer to receive the payload in. May be NULL
+                                       if BufferSize is zero.
+  @param[in, out]      BufferSize      On input, the size of Buffer. On output, the number
+                                       of bytes copied to Buffer.
+  @param[out]          Fragment        The rest of the received data, in a buffer to be
+                                       freed by the caller. Bulk is NULL if there is none.
   @param[in]           Timeout         The time to wait for connection done.
 
-  @retval EFI_SUCCESS          One fragment is received.
+  @retval EFI_SUCCESS          One record is received.
   @retval EFI_OUT_OF_RESOURCES Can't allocate memory resources.
   @retval EFI_ABORTED          Something wrong decryption the message.
   @retval Others               Other errors as indicated.
@@ -1637,9 +1925,11 @@ ON_EXIT:
 **/
 EFI_STATUS
 EFIAPI
-HttpsReceive (
+HttpsReceiveToBuffer (
   IN     HTTP_PROTOCOL  *HttpInstance,
-  IN OUT NET_FRAGMENT   *Fragment,
+  OUT    UINT8          *Buffer OPTIONAL,
+  IN OUT UINTN          *BufferSize,
+  OUT    NET_FRAGMENT   *Fragment,
   IN     EFI_EVENT      Timeout
   )
 {
@@ -1648,7 +1938,7 @@ HttpsReceive (
   TLS_RECORD_HEADER  RecordHeader;
   UINT8              *BufferIn;
   UINTN              BufferInSize;
-  NET_FRAGMENT       TempFragment;
+  UINTN              Copied;
   UINT8              *BufferOut;
   UINTN              BufferOutSize;
   NET_BUF            *PacketOut;
@@ -1660,6 +1950,7 @@ HttpsReceive (
   Pdu                      = NULL;
   BufferIn                 = NULL;
   BufferInSize             = 0;
+  Copied                   = 0;
   BufferOut                = NULL;
   BufferOutSize            = 0;
   PacketOut                = NULL;
@@ -1675,23 +1966,11 @@ HttpsReceive (
     return Status;
   }
 
-  BufferInSize = Pdu->TotalSize;
-  BufferIn     = AllocateZeroPool (BufferInSize);
-  if (BufferIn == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    NetbufFree (Pdu);
-    return Status;
-  }
-
-  NetbufCopy (Pdu, 0, (UINT32)BufferInSize, BufferIn);
-
-  NetbufFree (Pdu);
+  NetbufCopy (Pdu, 0, TLS_RECORD_HEADER_LENGTH, (UINT8 *)&RecordHeader);
 
   //
   // Handle Receive data.
   //
-  RecordHeader = *(TLS_RECORD_HEADER *)BufferIn;
-
   if ((RecordHeader.ContentType == TlsContentTypeApplicationData) &&
       (RecordHeader.Version.Major == 0x03) &&
       ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
@@ -1702,15 +1981,10 @@ HttpsReceive (
     //
     // Decrypt Packet.
     //
-    Status = TlsProcessMessage (
-               HttpInstance,
-               BufferIn,
-               BufferInSize,
-               EfiTlsDecrypt,
-               &TempFragment
-               );
+    Copied = *BufferSize;
+    Status = TlsDecryptPduToBuffer (HttpInstance, Pdu, Buffer, &Copied, &BufferIn, &BufferInSize);
 
-    FreePool (BufferIn);
+    NetbufFree (Pdu);
 
     if (EFI_ERROR (Status)) {
       if (Status == EFI_ABORTED) {
@@ -1780,31 +2054,26 @@ HttpsReceive (
 
       return Status;
     }
-
-    //
-    // Parsing buffer.
-    //
-    ASSERT (((TLS_RECORD_HEADER *)(TempFragment.Bulk))->ContentType == TlsContentTypeApplicationData);
-
-    BufferInSize = ((TLS_RECORD_HEADER *)(TempFragment.Bulk))->Length;
+  } else {
+    BufferInSize = Pdu->TotalSize;
     BufferIn     = AllocateZeroPool (BufferInSize);
     if (BufferIn == NULL) {
+      NetbufFree (Pdu);
       Status = EFI_OUT_OF_RESOURCES;
       return Status;
     }
 
-    CopyMem (BufferIn, TempFragment.Bulk + TLS_RECORD_HEADER_LENGTH, BufferInSize);
+    NetbufCopy (Pdu, 0, (UINT32)BufferInSize, BufferIn);
 
-    //
-    // Free the buffer in TempFragment.
-    //
-    FreePool (TempFragment.Bulk);
-  } else if ((RecordHeader.ContentType == TlsContentTypeAlert) &&
-             (RecordHeader.Version.Major == 0x03) &&
-             ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
-              (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
-              (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR))
-             )
+    NetbufFree (Pdu);
+  }
+
+  if ((RecordHeader.ContentType == TlsContentTypeAlert) &&
+      (RecordHeader.Version.Major == 0x03) &&
+      ((RecordHeader.Version.Minor == TLS10_PROTOCOL_VERSION_MINOR) ||
+       (RecordHeader.Version.Minor == TLS11_PROTOCOL_VERSION_MINOR) ||
+       (RecordHeader.Version.Minor == TLS12_PROTOCOL_VERSION_MINOR))
+      )
   {
     BufferOutSize = DEF_BUF_LEN;
     BufferOut     = AllocateZeroPool (BufferOutSize);
@@ -1914,8 +2183,36 @@ HttpsReceive (
     BufferInSize = 0;
   }
 
+  *BufferSize    = Copied;
   Fragment->Bulk = BufferIn;
   Fragment->Len  = (UINT32)BufferInSize;
 
   return Status;
 }
+
+/**
+  Receive one fragment decrypted from one TLS record.
+
+  @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in, out]      Fragment        The received Fragment.
+  @param[in]           Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS          One fragment is received.
+  @retval EFI_OUT_OF_RESOURCES Can't allocate memory resources.
+  @retval EFI_ABORTED          Something wrong decryption the message.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpsReceive (
+  IN     HTTP_PROTOCOL  *HttpInstance,
+  IN OUT NET_FRAGMENT   *Fragment,
+  IN     EFI_EVENT      Timeout
+  )
+{
+  UINTN  BufferSize;
+
+  BufferSize = 0;
+  return HttpsReceiveToBuffer (HttpInstance, NULL, &BufferSize, Fragment, Timeout);
+}
@@ -30,10 +30,14 @@ IsHttpsUrl (
 /**
   Creates a Tls child handle, open EFI_TLS_PROTOCOL and EFI_TLS_CONFIGURATION_PROTOCOL.
 
+  The EDKII_TLS_RECORD_PROTOCOL is opened too if the TLS driver produces it.
+
   @param[in]  ImageHandle           The firmware allocated handle for the UEFI image.
   @param[out] TlsSb                 Pointer to the TLS SERVICE_BINDING_PROTOCOL.
   @param[out] TlsProto              Pointer to the EFI_TLS_PROTOCOL instance.
   @param[out] TlsConfiguration      Pointer to the EFI_TLS_CONFIGURATION_PROTOCOL instance.
+  @param[out] TlsRecord             Pointer to the EDKII_TLS_RECORD_PROTOCOL instance,
+                                    NULL if the TLS child doesn't have it.
 
   @return  The child handle with opened EFI_TLS_PROTOCOL and EFI_TLS_CONFIGURATION_PROTOCOL.
 
@@ -44,7 +48,8 @@ TlsCreateChild (
   IN  EFI_HANDLE                      ImageHandle,
   OUT EFI_SERVICE_BINDING_PROTOCOL    **TlsSb,
   OUT EFI_TLS_PROTOCOL                **TlsProto,
-  OUT EFI_TLS_CONFIGURATION_PROTOCOL  **TlsConfiguration
+  OUT EFI_TLS_CONFIGURATION_PROTOCOL  **TlsConfiguration,
+  OUT EDKII_TLS_RECORD_PROTOCOL       **TlsRecord
   );
 
 /**
@@ -240,6 +245,38 @@ TlsProcessMessage (
   IN OUT NET_FRAGMENT        *Fragment
   );
 
+/**
+  Receive one TLS record and decrypt its payload into the caller's buffer.
+
+  The TLS APP payload is copied once, from the output of the TLS protocol
+  to Buffer. The part of the payload that doesn't fit in Buffer, or the
+  whole record if it isn't application data, is returned in Fragment.
+
+  @param[in]           HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[out]          Buffer          The buffer to receive the payload in. May be NULL
+                                       if BufferSize is zero.
+  @param[in, out]      BufferSize      On input, the size of Buffer. On output, the number
+                                       of bytes copied to Buffer.
+  @param[out]          Fragment        The rest of the received data, in a buffer to be
+                                       freed by the caller. Bulk is NULL if there is none.
+  @param[in]           Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS          One record is received.
+  @retval EFI_OUT_OF_RESOURCES Can't allocate memory resources.
+  @retval EFI_ABORTED          Something wrong decryption the message.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+HttpsReceiveToBuffer (
+  IN     HTTP_PROTOCOL  *HttpInstance,
+  OUT    UINT8          *Buffer OPTIONAL,
+  IN OUT UINTN          *BufferSize,
+  OUT    NET_FRAGMENT   *Fragment,
+  IN     EFI_EVENT      Timeout
+  );
+
 /**
   Receive one fragment decrypted from one TLS record.
 
@@ -106,6 +106,17 @@ struct _ISCSI_SESSION {
   UINT32                         NumConns;
 
   LIST_ENTRY                     TcbList;
+  ISCSI_TCB                      *TcbTable[ISCSI_MAX_OUTSTANDING_CMDS];
+  UINT32                         NumTcbs;
+
+  //
+  // Non-blocking commands waiting to be submitted, the event submitting
+  // them at TPL_CALLBACK and the timer checking the timeout of the
+  // submitted ones.
+  //
+  LIST_ENTRY                     PendingCmds;
+  EFI_EVENT                      SubmitEvent;
+  EFI_EVENT                      TickEvent;
 
   //
   // Session-wide parameters
@@ -127,42 +138,64 @@ struct _ISCSI_SESSION {
 #define ISCSI_CONNECTION_SIGNATURE  SIGNATURE_32 ('I', 'S', 'C', 'N')
 
 struct _ISCSI_CONNECTION {
-  UINT32               Signature;
-  LIST_ENTRY           Link;
+  UINT32                   Signature;
+  LIST_ENTRY               Link;
 
-  EFI_EVENT            TimeoutEvent;
+  EFI_EVENT                TimeoutEvent;
 
-  ISCSI_SESSION        *Session;
+  ISCSI_SESSION            *Session;
 
-  UINT8                State;
-  UINT8                CurrentStage;
-  UINT8                NextStage;
+  UINT8                    State;
+  UINT8                    CurrentStage;
+  UINT8                    NextStage;
 
-  UINT8                AuthStep;
+  UINT8                    AuthStep;
 
-  BOOLEAN              PartialReqSent;
-  BOOLEAN              PartialRspRcvd;
+  BOOLEAN                  PartialReqSent;
+  BOOLEAN                  PartialRspRcvd;
 
-  BOOLEAN              TransitInitiated;
-  BOOLEAN              ParamNegotiated;
+  BOOLEAN                  TransitInitiated;
+  BOOLEAN                  ParamNegotiated;
 
-  UINT16               Cid;
-  UINT32               ExpStatSN;
+  UINT16                   Cid;
+  UINT32                   ExpStatSN;
+
+  //
+  // Number of commands outstanding on this connection.
+  //
+  UINT32                   NumTcbs;
 
   //
   // Queues...
   //
-  NET_BUF_QUEUE        RspQue;
+  NET_BUF_QUEUE            RspQue;
+
+  BOOLEAN                  Ipv6Flag;
+  TCP_IO                   TcpIo;
 
-  BOOLEAN              Ipv6Flag;
-  TCP_IO               TcpIo;
+  //
+  // Full feature phase receive. RxToken is always pending on the TCP
+  // connection; its completion drives the reception of the PDUs into
+  // RxHeader and RxDataSeg through the fragments of RxFragment.
+  //
+  TCP_IO_IO_TOKEN          RxToken;
+  EFI_TCP4_RECEIVE_DATA    RxData;
+  EFI_EVENT                RxWorkEvent;
+  BOOLEAN                  RxDone;
+  BOOLEAN                  RxInData;
+  NET_BUF                  *RxHeader;
+  NET_BUF                  *RxDataSeg;
+  NET_FRAGMENT             RxFragment[2];
+  UINT32                   RxFragmentCount;
+  UINT32                   RxFragmentIndex;
+  UINT32                   RxPad;
 
   //
   // Connection-only parameters.
   //
-  UINT32               MaxRecvDataSegmentLength;
-  ISCSI_DIGEST_TYPE    HeaderDigest;
-  ISCSI_DIGEST_TYPE    DataDigest;
+  UINT32                   MaxRecvDataSegmentLength;
+  ISCSI_DIGEST_TYPE        HeaderDigest;
+  ISCSI_DIGEST_TYPE        DataDigest;
 };
 
 #define ISCSI_DRIVER_DATA_SIGNATURE  SIGNATURE_32 ('I', 'S', 'D', 'A')
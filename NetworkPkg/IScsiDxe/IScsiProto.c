@@ -313,6 +313,22 @@ IScsiDestroyConnection (
 {
   TcpIoDestroySocket (&Conn->TcpIo);
 
+  if (Conn->RxToken.Tcp4Token.CompletionToken.Event != NULL) {
+    gBS->CloseEvent (Conn->RxToken.Tcp4Token.CompletionToken.Event);
+  }
+
+  if (Conn->RxWorkEvent != NULL) {
+    gBS->CloseEvent (Conn->RxWorkEvent);
+  }
+
+  if (Conn->RxHeader != NULL) {
+    NetbufFree (Conn->RxHeader);
+  }
+
+  if (Conn->RxDataSeg != NULL) {
+    NetbufFree (Conn->RxDataSeg);
+  }
+
   NetbufQueFlush (&Conn->RspQue);
   gBS->CloseEvent (Conn->TimeoutEvent);
   FreePool (Conn);
@@ -421,8 +437,8 @@ ON_EXIT:
   Re-set any stateful session-level authentication information that is used by
   the leading login / leading connection.
 
-  (Note that this driver only supports a single connection per session -- see
-  ISCSI_MAX_CONNS_PER_SESSION.)
+  Every connection of the session goes through its own authentication, so
+  this is done before each login.
 
   @param[in,out] Session  The iSCSI session.
 **/
@@ -437,6 +453,64 @@ IScsiSessionResetAuthData (
   }
 }
 
+/**
+  Add connections to a logged in session, up to the negotiated MaxConnections.
+
+  Failing to add a connection isn't fatal: the session keeps running its
+  commands over the connections it already has.
+
+  @param[in]  Session           The iSCSI session.
+
+**/
+STATIC
+VOID
+IScsiSessionAddConnections (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS        Status;
+  ISCSI_CONNECTION  *Conn;
+  VOID              *Tcp;
+
+  while (Session->NumConns < Session->MaxConnections) {
+    Conn = IScsiCreateConnection (Session);
+    if (Conn == NULL) {
+      return;
+    }
+
+    IScsiAttatchConnection (Session, Conn);
+
+    //
+    // The session is logged in, so this is a non-leading login carrying
+    // the TSIH of the session.
+    //
+    IScsiSessionResetAuthData (Session);
+    Status = IScsiConnLogin (Conn, Session->ConfigData->SessionConfigData.ConnectTimeout);
+    if (!EFI_ERROR (Status)) {
+      Status = IScsiConnStartReceive (Conn);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Status = gBS->OpenProtocol (
+                      Conn->TcpIo.Handle,
+                      Conn->Ipv6Flag ? &gEfiTcp6ProtocolGuid : &gEfiTcp4ProtocolGuid,
+                      (VOID **)&Tcp,
+                      Session->Private->Image,
+                      Session->Private->ExtScsiPassThruHandle,
+                      EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                      );
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "IScsiSessionAddConnections: connection %d failed, %r\n", Conn->Cid, Status));
+      IScsiConnReset (Conn);
+      IScsiDetatchConnection (Conn);
+      IScsiDestroyConnection (Conn);
+      return;
+    }
+  }
+}
+
 /**
   Login the iSCSI session.
 
@@ -492,6 +566,10 @@ IScsiSessionLogin (
     //
     IScsiSessionResetAuthData (Session);
     Status = IScsiConnLogin (Conn, Session->ConfigData->SessionConfigData.ConnectTimeout);
+    if (!EFI_ERROR (Status)) {
+      Status = IScsiConnStartReceive (Conn);
+    }
+
     if (EFI_ERROR (Status)) {
       IScsiConnReset (Conn);
       IScsiDetatchConnection (Conn);
@@ -528,6 +606,10 @@ IScsiSessionLogin (
     if (Conn->Ipv6Flag) {
       Status = IScsiGetIp6NicInfo (Conn);
     }
+
+    if (!EFI_ERROR (Status)) {
+      IScsiSessionAddConnections (Session);
+    }
   }
 
   return Status;
@@ -1573,6 +1655,20 @@ IScsiCheckOpParams (
     goto ON_ERROR;
   }
 
+  if (Session->State == SESSION_STATE_LOGGED_IN) {
+    //
+    // Non-leading login, the session-wide parameters are already negotiated.
+    // MaxRecvDataSegmentLength is declarative.
+    //
+    Value = IScsiGetValueByKeyFromList (KeyValueList, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH);
+    if (Value != NULL) {
+      Conn->MaxRecvDataSegmentLength = (UINT32)IScsiNetNtoi (Value);
+    }
+
+    Status = EFI_SUCCESS;
+    goto ON_ERROR;
+  }
+
   //
   // ErrorRecoveryLevel: result function is Minimum.
   //
@@ -1792,6 +1888,15 @@ IScsiFillOpParams (
   AsciiSPrint (Value, sizeof (Value), "%a", (Conn->DataDigest == IScsiDigestCRC32) ? "None,CRC32" : "None");
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_DATA_DIGEST, Value);
 
+  if (Session->State == SESSION_STATE_LOGGED_IN) {
+    //
+    // Non-leading login, only the connection-only keys are negotiated.
+    //
+    AsciiSPrint (Value, sizeof (Value), "%d", MAX_RECV_DATA_SEG_LEN_IN_FFP);
+    IScsiAddKeyValuePair (Pdu, ISCSI_KEY_MAX_RECV_DATA_SEGMENT_LENGTH, Value);
+    return;
+  }
+
   AsciiSPrint (Value, sizeof (Value), "%d", Session->ErrorRecoveryLevel);
   IScsiAddKeyValuePair (Pdu, ISCSI_KEY_ERROR_RECOVERY_LEVEL, Value);
 
@@ -2051,7 +2156,8 @@ IScsiNormalizeName (
 
   @retval EFI_SUCCESS          The task control block is created.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_NOT_READY        The target cannot accept new commands.
+  @retval EFI_NOT_READY        The target cannot accept new commands, or
+                               ISCSI_MAX_OUTSTANDING_CMDS commands are in flight.
 
 **/
 EFI_STATUS
@@ -2067,10 +2173,22 @@ IScsiNewTcb (
 
   Session = Conn->Session;
 
-  if (ISCSI_SEQ_GT (Session->CmdSN, Session->MaxCmdSN)) {
+  if (ISCSI_SEQ_GT (Session->CmdSN, Session->MaxCmdSN) ||
+      (Session->NumTcbs >= ISCSI_MAX_OUTSTANDING_CMDS))
+  {
     return EFI_NOT_READY;
   }
 
+  //
+  // Skip the tags whose slot in the task table is still taken by an
+  // outstanding command, and the reserved tag.
+  //
+  while ((Session->InitiatorTaskTag == ISCSI_RESERVED_TAG) ||
+         (Session->TcbTable[ISCSI_TCB_INDEX (Session->InitiatorTaskTag)] != NULL))
+  {
+    Session->InitiatorTaskTag++;
+  }
+
   NewTcb = AllocateZeroPool (sizeof (ISCSI_TCB));
   if (NewTcb == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -2084,6 +2202,9 @@ IScsiNewTcb (
   NewTcb->Conn             = Conn;
 
   InsertTailList (&Session->TcbList, &NewTcb->Link);
+  Session->TcbTable[ISCSI_TCB_INDEX (NewTcb->InitiatorTaskTag)] = NewTcb;
+  Session->NumTcbs++;
+  Conn->NumTcbs++;
 
   //
   // Advance the initiator task tag.
@@ -2107,11 +2228,54 @@ IScsiDelTcb (
   IN ISCSI_TCB  *Tcb
   )
 {
+  ISCSI_SESSION  *Session;
+
+  if (Tcb->Conn == NULL) {
+    //
+    // The session was aborted while a blocking command waited for it, the
+    // task control block is already unlinked.
+    //
+    FreePool (Tcb);
+    return;
+  }
+
+  Session = Tcb->Conn->Session;
+
+  ASSERT (Session->TcbTable[ISCSI_TCB_INDEX (Tcb->InitiatorTaskTag)] == Tcb);
+  Session->TcbTable[ISCSI_TCB_INDEX (Tcb->InitiatorTaskTag)] = NULL;
+  Session->NumTcbs--;
+  Tcb->Conn->NumTcbs--;
+
   RemoveEntryList (&Tcb->Link);
 
   FreePool (Tcb);
 }
 
+/**
+  Find the outstanding task control block of a session by its initiator task tag.
+
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag, in host byte order.
+
+  @return The task control block, or NULL if no command is outstanding with this tag.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  )
+{
+  ISCSI_TCB  *Tcb;
+
+  Tcb = Session->TcbTable[ISCSI_TCB_INDEX (InitiatorTaskTag)];
+  if ((Tcb == NULL) || (Tcb->InitiatorTaskTag != InitiatorTaskTag)) {
+    return NULL;
+  }
+
+  return Tcb;
+}
+
 /**
   Create a data segment, pad it, and calculate the CRC if needed.
 
@@ -2841,7 +3005,7 @@ IScsiOnScsiRspRcvd (
   Process the received NOP In PDU.
 
   @param[in]  Pdu            The NOP In PDU received.
-  @param[in]  Tcb            The task control block.
+  @param[in]  Conn           The connection the NOP In PDU is received on.
 
   @retval EFI_SUCCESS        The NOP In PDU is processed and the related sequence
                              numbers are updated.
@@ -2850,8 +3014,8 @@ IScsiOnScsiRspRcvd (
 **/
 EFI_STATUS
 IScsiOnNopInRcvd (
-  IN NET_BUF    *Pdu,
-  IN ISCSI_TCB  *Tcb
+  IN NET_BUF           *Pdu,
+  IN ISCSI_CONNECTION  *Conn
   )
 {
   ISCSI_NOP_IN  *NopInHdr;
@@ -2867,103 +3031,141 @@ IScsiOnNopInRcvd (
   NopInHdr->MaxCmdSN = NTOHL (NopInHdr->MaxCmdSN);
 
   if (NopInHdr->InitiatorTaskTag == ISCSI_RESERVED_TAG) {
-    if (NopInHdr->StatSN != Tcb->Conn->ExpStatSN) {
+    if (NopInHdr->StatSN != Conn->ExpStatSN) {
       return EFI_PROTOCOL_ERROR;
     }
   } else {
-    Status = IScsiCheckSN (&Tcb->Conn->ExpStatSN, NopInHdr->StatSN);
+    Status = IScsiCheckSN (&Conn->ExpStatSN, NopInHdr->StatSN);
     if (EFI_ERROR (Status)) {
       return Status;
     }
   }
 
-  IScsiUpdateCmdSN (Tcb->Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
+  IScsiUpdateCmdSN (Conn->Session, NopInHdr->MaxCmdSN, NopInHdr->ExpCmdSN);
 
   return EFI_SUCCESS;
 }
 
 /**
-  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+  Select the connection of the session with the fewest outstanding commands.
 
-  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
-  @param[in]       Target    The target ID.
-  @param[in]       Lun       The LUN.
-  @param[in, out]  Packet    The request packet containing IO request, SCSI command
-                             buffer and buffers to read/write.
+  @param[in]  Session           The iSCSI session.
 
-  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
-  @retval EFI_DEVICE_ERROR     Session state was not as required.
-  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
-  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
-  @retval EFI_NOT_READY        The target can not accept new commands.
-  @retval Others               Other errors as indicated.
+  @return The connection to issue the next command on, or NULL if one of the
+          connections of the session failed.
+
+**/
+STATIC
+ISCSI_CONNECTION *
+IScsiSelectConnection (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  LIST_ENTRY        *Entry;
+  ISCSI_CONNECTION  *Conn;
+  ISCSI_CONNECTION  *Selected;
+
+  Selected = NULL;
+
+  NET_LIST_FOR_EACH (Entry, &Session->Conns) {
+    Conn = NET_LIST_USER_STRUCT_S (Entry, ISCSI_CONNECTION, Link, ISCSI_CONNECTION_SIGNATURE);
+    if (Conn->State != CONN_STATE_LOGGED_IN) {
+      //
+      // The session has to be reinstated.
+      //
+      return NULL;
+    }
+
+    if ((Selected == NULL) || (Conn->NumTcbs < Selected->NumTcbs)) {
+      Selected = Conn;
+    }
+  }
+
+  return Selected;
+}
+
+/**
+  Submit a SCSI command on the least loaded connection of the session.
+
+  The SCSI Command PDU and the unsolicited Data-Out PDUs, if any, are sent. The
+  rest of the command is carried out as the PDUs of the target arrive on the
+  connection, until the StatusXferd field of the task control block is set.
+
+  @param[in]   Session          The iSCSI session.
+  @param[in]   Lun              The LUN.
+  @param[in]   Packet           The request packet containing IO request, SCSI command
+                                buffer and buffers to read/write.
+  @param[out]  Tcb              The task control block of the command. It must be
+                                freed with IScsiDelTcb() once the command is done.
+
+  @retval EFI_SUCCESS           The SCSI command is submitted.
+  @retval EFI_DEVICE_ERROR      Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval EFI_NOT_READY         The target can not accept new commands.
+  @retval Others                Other errors as indicated.
 
 **/
 EFI_STATUS
-IScsiExecuteScsiCommand (
-  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
-  IN UINT8                                           *Target,
-  IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+IScsiSubmitScsiCommand (
+  IN     ISCSI_SESSION                               *Session,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  OUT    ISCSI_TCB                                   **Tcb
   )
 {
-  EFI_STATUS               Status;
-  ISCSI_DRIVER_DATA        *Private;
-  ISCSI_SESSION            *Session;
-  EFI_EVENT                TimeoutEvent;
-  ISCSI_CONNECTION         *Conn;
-  ISCSI_TCB                *Tcb;
-  NET_BUF                  *Pdu;
-  ISCSI_XFER_CONTEXT       *XferContext;
-  UINT8                    *Data;
-  ISCSI_IN_BUFFER_CONTEXT  InBufferContext;
-  UINT64                   Timeout;
-  UINT8                    *PduHdr;
-
-  Private      = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
-  Session      = Private->Session;
-  Status       = EFI_SUCCESS;
-  Tcb          = NULL;
-  TimeoutEvent = NULL;
-  Timeout      = 0;
+  EFI_STATUS          Status;
+  EFI_TPL             OldTpl;
+  ISCSI_CONNECTION    *Conn;
+  ISCSI_TCB           *NewTcb;
+  NET_BUF             *Pdu;
+  ISCSI_XFER_CONTEXT  *XferContext;
+  UINT8               *Data;
+  UINT8               *PduHdr;
+
+  *Tcb = NULL;
 
   if (Session->State != SESSION_STATE_LOGGED_IN) {
-    Status = EFI_DEVICE_ERROR;
-    goto ON_EXIT;
+    return EFI_DEVICE_ERROR;
   }
 
-  Conn = NET_LIST_USER_STRUCT_S (
-           Session->Conns.ForwardLink,
-           ISCSI_CONNECTION,
-           Link,
-           ISCSI_CONNECTION_SIGNATURE
-           );
+  //
+  // Keep the receive path from completing the command before it is
+  // entirely sent.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-  if (Packet->Timeout != 0) {
-    Timeout = MultU64x32 (Packet->Timeout, 4);
+  Conn = IScsiSelectConnection (Session);
+  if (Conn == NULL) {
+    Status = EFI_DEVICE_ERROR;
+    goto ON_EXIT;
   }
 
-  Status = IScsiNewTcb (Conn, &Tcb);
+  Status = IScsiNewTcb (Conn, &NewTcb);
   if (EFI_ERROR (Status)) {
     goto ON_EXIT;
   }
 
+  NewTcb->Lun                       = Lun;
+  NewTcb->Packet                    = Packet;
+  NewTcb->InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
+  NewTcb->InBufferContext.InDataLen = Packet->InTransferLength;
+  NewTcb->Status                    = EFI_SUCCESS;
+
   //
   // Encapsulate the SCSI request packet into an iSCSI SCSI Command PDU.
   //
-  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, Tcb);
+  Pdu = IScsiNewScsiCmdPdu (Packet, Lun, NewTcb);
   if (Pdu == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
 
-  XferContext = &Tcb->XferContext;
+  XferContext = &NewTcb->XferContext;
   PduHdr      = NetbufGetByte (Pdu, 0, NULL);
   if (PduHdr == NULL) {
     Status = EFI_PROTOCOL_ERROR;
     NetbufFree (Pdu);
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
 
   XferContext->Offset = ISCSI_GET_DATASEG_LEN (PduHdr);
@@ -2976,7 +3178,7 @@ IScsiExecuteScsiCommand (
   NetbufFree (Pdu);
 
   if (EFI_ERROR (Status)) {
-    goto ON_EXIT;
+    goto ON_ERROR;
   }
 
   if (!Session->InitialR2T &&
@@ -2995,180 +3197,875 @@ IScsiExecuteScsiCommand (
                                        );
 
     Data   = (UINT8 *)Packet->OutDataBuffer + XferContext->Offset;
-    Status = IScsiSendDataOutPduSequence (Data, Lun, Tcb);
+    Status = IScsiSendDataOutPduSequence (Data, Lun, NewTcb);
     if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
+      goto ON_ERROR;
     }
   }
 
-  InBufferContext.InData    = (UINT8 *)Packet->InDataBuffer;
-  InBufferContext.InDataLen = Packet->InTransferLength;
-
-  while (!Tcb->StatusXferd) {
-    //
-    // Start the timeout timer.
-    //
-    if (Timeout != 0) {
-      Status = gBS->SetTimer (Conn->TimeoutEvent, TimerRelative, Timeout);
-      if (EFI_ERROR (Status)) {
-        goto ON_EXIT;
-      }
-
-      TimeoutEvent = Conn->TimeoutEvent;
-    }
-
-    //
-    // Try to receive PDU from target.
-    //
-    Status = IScsiReceivePdu (Conn, &Pdu, &InBufferContext, FALSE, FALSE, TimeoutEvent);
-    if (EFI_ERROR (Status)) {
-      goto ON_EXIT;
-    }
-
-    PduHdr = NetbufGetByte (Pdu, 0, NULL);
-    if (PduHdr == NULL) {
-      Status = EFI_PROTOCOL_ERROR;
-      NetbufFree (Pdu);
-      goto ON_EXIT;
-    }
-
-    switch (ISCSI_GET_OPCODE (PduHdr)) {
-      case ISCSI_OPCODE_SCSI_DATA_IN:
-        Status = IScsiOnDataInRcvd (Pdu, Tcb, Packet);
-        break;
+  *Tcb = NewTcb;
+  goto ON_EXIT;
 
-      case ISCSI_OPCODE_R2T:
-        Status = IScsiOnR2TRcvd (Pdu, Tcb, Lun, Packet);
-        break;
+ON_ERROR:
 
-      case ISCSI_OPCODE_SCSI_RSP:
-        Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Packet);
-        break;
+  IScsiDelTcb (NewTcb);
 
-      case ISCSI_OPCODE_NOP_IN:
-        Status = IScsiOnNopInRcvd (Pdu, Tcb);
-        break;
+ON_EXIT:
 
-      case ISCSI_OPCODE_VENDOR_T0:
-      case ISCSI_OPCODE_VENDOR_T1:
-      case ISCSI_OPCODE_VENDOR_T2:
-        //
-        // These messages are vendor specific. Skip them.
-        //
-        break;
+  gBS->RestoreTPL (OldTpl);
 
-      default:
-        Status = EFI_PROTOCOL_ERROR;
-        break;
-    }
+  return Status;
+}
 
-    NetbufFree (Pdu);
+/**
+  Release a command whose status is transferred or which failed.
 
-    if (EFI_ERROR (Status)) {
-      break;
-    }
-  }
+  A non-blocking command is freed and its event signaled. A blocking command
+  is left to the caller waiting for it.
 
-ON_EXIT:
+  @param[in]  Tcb               The task control block of the command.
 
-  if (TimeoutEvent != NULL) {
-    gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
-  }
+**/
+STATIC
+VOID
+IScsiTcbDone (
+  IN ISCSI_TCB  *Tcb
+  )
+{
+  EFI_EVENT  Event;
 
-  if (Tcb != NULL) {
-    IScsiDelTcb (Tcb);
+  Event = Tcb->Event;
+  if (Event == NULL) {
+    return;
   }
 
-  return Status;
+  IScsiDelTcb (Tcb);
+  gBS->SignalEvent (Event);
 }
 
 /**
-  Reinstate the session on some error.
-
-  @param[in]  Session           The iSCSI session
+  Stop using a connection after an error, and fail the commands outstanding
+  on it. The session is reinstated on the next command submitted.
 
-  @retval EFI_SUCCESS           The session is reinstated from some error.
-  @retval Other                 Reinstatement failed.
+  @param[in]  Conn              The iSCSI connection.
+  @param[in]  HostAdapterStatus The host adapter status reported for the failed commands.
 
 **/
-EFI_STATUS
-IScsiSessionReinstatement (
-  IN ISCSI_SESSION  *Session
+STATIC
+VOID
+IScsiConnFail (
+  IN ISCSI_CONNECTION  *Conn,
+  IN UINT8             HostAdapterStatus
   )
 {
-  EFI_STATUS  Status;
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *NextEntry;
+  ISCSI_TCB   *Tcb;
 
-  ASSERT (Session->State != SESSION_STATE_FREE);
+  if (Conn->State != CONN_STATE_LOGGED_IN) {
+    return;
+  }
 
-  //
-  // Abort the session and re-init it.
-  //
-  IScsiSessionAbort (Session);
-  IScsiSessionInit (Session, TRUE);
+  Conn->State = CONN_STATE_CLEANUP_WAIT;
 
   //
-  // Login again.
+  // Stop the receive, it may target the buffer of a failed command.
   //
-  Status = IScsiSessionLogin (Session);
+  if (Conn->TcpIo.TcpVersion == TCP_VERSION_4) {
+    Conn->TcpIo.Tcp.Tcp4->Cancel (Conn->TcpIo.Tcp.Tcp4, &Conn->RxToken.Tcp4Token.CompletionToken);
+  } else {
+    Conn->TcpIo.Tcp.Tcp6->Cancel (Conn->TcpIo.Tcp.Tcp6, &Conn->RxToken.Tcp6Token.CompletionToken);
+  }
 
-  return Status;
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Conn->Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if (Tcb->Conn != Conn) {
+      continue;
+    }
+
+    Tcb->Packet->HostAdapterStatus = HostAdapterStatus;
+    Tcb->Status                    = EFI_DEVICE_ERROR;
+    Tcb->StatusXferd               = TRUE;
+    IScsiTcbDone (Tcb);
+  }
 }
 
 /**
-  Initialize some session parameters before login.
+  Process a PDU received on a connection on behalf of the command it belongs to.
 
-  @param[in, out]  Session  The iSCSI session.
-  @param[in]       Recovery Whether the request is from a fresh new start or recovery.
+  A command that completes with a residual gets EFI_BAD_BUFFER_SIZE in the
+  Status field of its task control block; this isn't a connection error.
+
+  @param[in]  Conn              The iSCSI connection the PDU is received on.
+  @param[in]  Pdu               The PDU received.
+
+  @retval EFI_SUCCESS           The PDU is processed.
+  @retval EFI_PROTOCOL_ERROR    Some kind of iSCSI protocol error occurred.
+  @retval Others                Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiDispatchPdu (
+  IN ISCSI_CONNECTION  *Conn,
+  IN NET_BUF           *Pdu
+  )
+{
+  EFI_STATUS     Status;
+  ISCSI_SESSION  *Session;
+  UINT8          *PduHdr;
+  UINT8          Opcode;
+  ISCSI_TCB      *Tcb;
+
+  Session = Conn->Session;
+
+  PduHdr = NetbufGetByte (Pdu, 0, NULL);
+  if (PduHdr == NULL) {
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  Opcode = ISCSI_GET_OPCODE (PduHdr);
+  Tcb    = NULL;
+
+  if ((Opcode == ISCSI_OPCODE_SCSI_DATA_IN) ||
+      (Opcode == ISCSI_OPCODE_R2T) ||
+      (Opcode == ISCSI_OPCODE_SCSI_RSP))
+  {
+    //
+    // The initiator task tag is at the same place in all these PDUs.
+    //
+    Tcb = IScsiFindTcb (Session, NTOHL (((SCSI_RESPONSE *)PduHdr)->InitiatorTaskTag));
+    if ((Tcb == NULL) || (Tcb->Conn != Conn)) {
+      return EFI_PROTOCOL_ERROR;
+    }
+  }
+
+  switch (Opcode) {
+    case ISCSI_OPCODE_SCSI_DATA_IN:
+      Status = IScsiOnDataInRcvd (Pdu, Tcb, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_R2T:
+      Status = IScsiOnR2TRcvd (Pdu, Tcb, Tcb->Lun, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_SCSI_RSP:
+      Status = IScsiOnScsiRspRcvd (Pdu, Tcb, Tcb->Packet);
+      break;
+
+    case ISCSI_OPCODE_NOP_IN:
+      Status = IScsiOnNopInRcvd (Pdu, Conn);
+      break;
+
+    case ISCSI_OPCODE_VENDOR_T0:
+    case ISCSI_OPCODE_VENDOR_T1:
+    case ISCSI_OPCODE_VENDOR_T2:
+      //
+      // These messages are vendor specific. Skip them.
+      //
+      Status = EFI_SUCCESS;
+      break;
+
+    default:
+      Status = EFI_PROTOCOL_ERROR;
+      break;
+  }
+
+  if ((Status == EFI_BAD_BUFFER_SIZE) && (Tcb != NULL)) {
+    //
+    // The command completed with a residual, the connection is fine.
+    //
+    Tcb->Status = Status;
+    Status      = EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Tcb != NULL) && Tcb->StatusXferd) {
+    IScsiTcbDone (Tcb);
+  }
+
+  //
+  // The command window may have moved, retry the queued commands.
+  //
+  if (!IsListEmpty (&Session->PendingCmds)) {
+    gBS->SignalEvent (Session->SubmitEvent);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue the TCP receive for the rest of the current fragment.
+
+  @param[in]  Conn              The iSCSI connection.
+
+  @retval EFI_SUCCESS           The receive is queued.
+  @retval Others                Other errors as indicated by the TCP Receive().
+
+**/
+STATIC
+EFI_STATUS
+IScsiConnRxPost (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  NET_FRAGMENT  *Fragment;
+
+  Fragment = &Conn->RxFragment[Conn->RxFragmentIndex];
+
+  Conn->RxData.DataLength                      = Fragment->Len;
+  Conn->RxData.FragmentCount                   = 1;
+  Conn->RxData.FragmentTable[0].FragmentLength = Fragment->Len;
+  Conn->RxData.FragmentTable[0].FragmentBuffer = Fragment->Bulk;
+
+  if (Conn->TcpIo.TcpVersion == TCP_VERSION_4) {
+    return Conn->TcpIo.Tcp.Tcp4->Receive (Conn->TcpIo.Tcp.Tcp4, &Conn->RxToken.Tcp4Token);
+  }
+
+  return Conn->TcpIo.Tcp.Tcp6->Receive (Conn->TcpIo.Tcp.Tcp6, &Conn->RxToken.Tcp6Token);
+}
+
+/**
+  Prepare to receive the basic header segment of the next PDU.
+
+  @param[in]  Conn              The iSCSI connection.
+
+  @retval EFI_SUCCESS           The header buffer is allocated.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+
+**/
+STATIC
+EFI_STATUS
+IScsiConnRxNextPdu (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  UINT8  *Header;
+
+  Conn->RxHeader = NetbufAlloc (sizeof (ISCSI_BASIC_HEADER));
+  if (Conn->RxHeader == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Header = NetbufAllocSpace (Conn->RxHeader, sizeof (ISCSI_BASIC_HEADER), NET_BUF_TAIL);
+  ASSERT (Header != NULL);
+
+  Conn->RxInData           = FALSE;
+  Conn->RxDataSeg          = NULL;
+  Conn->RxFragment[0].Bulk = Header;
+  Conn->RxFragment[0].Len  = sizeof (ISCSI_BASIC_HEADER);
+  Conn->RxFragmentCount    = 1;
+  Conn->RxFragmentIndex    = 0;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Handle the end of the reception of the header or of the data segment of a
+  PDU. Set up the reception of the data segment, or process the complete PDU
+  and set up the reception of the next one.
+
+  @param[in]  Conn              The iSCSI connection.
+
+  @retval EFI_SUCCESS           The next segment is ready to be received.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR    Some kind of iSCSI protocol error occurred.
+  @retval Others                Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiConnRxSegmentDone (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  EFI_STATUS    Status;
+  UINT8         *Header;
+  UINT32        Len;
+  UINT32        PadLen;
+  UINT32        InDataOffset;
+  ISCSI_TCB     *Tcb;
+  NET_FRAGMENT  Fragment;
+  LIST_ENTRY    *NbufList;
+  NET_BUF       *Pdu;
+
+  Header = NetbufGetByte (Conn->RxHeader, 0, NULL);
+  Len    = ISCSI_GET_DATASEG_LEN (Header);
+
+  if (!Conn->RxInData && (Len != 0)) {
+    PadLen = ISCSI_GET_PAD_LEN (Len);
+
+    switch (ISCSI_GET_OPCODE (Header)) {
+      case ISCSI_OPCODE_SCSI_DATA_IN:
+        //
+        // Receive the data straight into the buffer of the command.
+        //
+        Tcb          = IScsiFindTcb (Conn->Session, NTOHL (((ISCSI_SCSI_DATA_IN *)Header)->InitiatorTaskTag));
+        InDataOffset = ISCSI_GET_BUFFER_OFFSET (Header);
+        if ((Tcb == NULL) || ((InDataOffset + Len) > Tcb->InBufferContext.InDataLen)) {
+          return EFI_PROTOCOL_ERROR;
+        }
+
+        Fragment.Len    = Len;
+        Fragment.Bulk   = Tcb->InBufferContext.InData + InDataOffset;
+        Conn->RxDataSeg = NetbufFromExt (&Fragment, 1, 0, 0, IScsiNbufExtFree, NULL);
+        break;
+
+      case ISCSI_OPCODE_SCSI_RSP:
+      case ISCSI_OPCODE_NOP_IN:
+      case ISCSI_OPCODE_TEXT_RSP:
+      case ISCSI_OPCODE_ASYNC_MSG:
+      case ISCSI_OPCODE_REJECT:
+      case ISCSI_OPCODE_VENDOR_T0:
+      case ISCSI_OPCODE_VENDOR_T1:
+      case ISCSI_OPCODE_VENDOR_T2:
+        Conn->RxDataSeg = NetbufAlloc (Len);
+        if (Conn->RxDataSeg != NULL) {
+          NetbufAllocSpace (Conn->RxDataSeg, Len, NET_BUF_TAIL);
+        }
+
+        break;
+
+      default:
+        return EFI_PROTOCOL_ERROR;
+    }
+
+    if (Conn->RxDataSeg == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    //
+    // The padding bytes are received in a separate fragment and dropped.
+    //
+    Conn->RxInData           = TRUE;
+    Conn->RxFragment[0].Bulk = NetbufGetByte (Conn->RxDataSeg, 0, NULL);
+    Conn->RxFragment[0].Len  = Len;
+    Conn->RxFragment[1].Bulk = (UINT8 *)&Conn->RxPad;
+    Conn->RxFragment[1].Len  = PadLen;
+    Conn->RxFragmentCount    = (PadLen != 0) ? 2 : 1;
+    Conn->RxFragmentIndex    = 0;
+
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The PDU is complete, form it from its segments.
+  //
+  if (Conn->RxDataSeg == NULL) {
+    Pdu = Conn->RxHeader;
+  } else {
+    NbufList = AllocatePool (sizeof (LIST_ENTRY));
+    if (NbufList == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    InitializeListHead (NbufList);
+    InsertTailList (NbufList, &Conn->RxHeader->List);
+    InsertTailList (NbufList, &Conn->RxDataSeg->List);
+
+    Pdu = NetbufFromBufList (NbufList, 0, 0, IScsiFreeNbufList, NbufList);
+    if (Pdu == NULL) {
+      IScsiFreeNbufList (NbufList);
+      Conn->RxHeader  = NULL;
+      Conn->RxDataSeg = NULL;
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Conn->RxHeader  = NULL;
+  Conn->RxDataSeg = NULL;
+
+  Status = IScsiDispatchPdu (Conn, Pdu);
+  NetbufFree (Pdu);
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return IScsiConnRxNextPdu (Conn);
+}
+
+/**
+  Process the completions of the receive token of a connection.
+
+  This is called at TPL_CALLBACK.
+
+  @param[in]  Conn              The iSCSI connection.
+
+**/
+STATIC
+VOID
+IScsiConnRxProcess (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  EFI_STATUS    Status;
+  NET_FRAGMENT  *Fragment;
+  UINT32        Received;
+
+  while (Conn->RxDone) {
+    Conn->RxDone = FALSE;
+
+    if (Conn->State != CONN_STATE_LOGGED_IN) {
+      return;
+    }
+
+    Status = Conn->RxToken.Tcp4Token.CompletionToken.Status;
+    if (!EFI_ERROR (Status)) {
+      Received        = Conn->RxData.FragmentTable[0].FragmentLength;
+      Fragment        = &Conn->RxFragment[Conn->RxFragmentIndex];
+      Fragment->Bulk += Received;
+      Fragment->Len  -= Received;
+
+      if (Fragment->Len == 0) {
+        Conn->RxFragmentIndex++;
+        if (Conn->RxFragmentIndex == Conn->RxFragmentCount) {
+          Status = IScsiConnRxSegmentDone (Conn);
+        }
+      }
+    }
+
+    if (!EFI_ERROR (Status)) {
+      //
+      // The receive may complete at once, and the loop goes on.
+      //
+      Status = IScsiConnRxPost (Conn);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "IScsiConnRxProcess: connection %d failed, %r\n", Conn->Cid, Status));
+      IScsiConnFail (Conn, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER);
+      return;
+    }
+  }
+}
+
+/**
+  Notify function of the receive token of a connection. The completion is
+  processed at TPL_CALLBACK.
+
+  @param[in]  Event             The receive token event.
+  @param[in]  Context           The iSCSI connection.
+
+**/
+STATIC
+VOID
+EFIAPI
+IScsiOnRxTokenDone (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  ISCSI_CONNECTION  *Conn;
+
+  Conn         = (ISCSI_CONNECTION *)Context;
+  Conn->RxDone = TRUE;
+  gBS->SignalEvent (Conn->RxWorkEvent);
+}
+
+/**
+  Process the PDUs received on a connection.
+
+  @param[in]  Event             The event signaled.
+  @param[in]  Context           The iSCSI connection.
+
+**/
+STATIC
+VOID
+EFIAPI
+IScsiOnRxWork (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  IScsiConnRxProcess ((ISCSI_CONNECTION *)Context);
+}
+
+/**
+  Start receiving the full feature phase PDUs of a connection that just
+  logged in. The connection becomes usable for commands.
+
+  @param[in]  Conn              The iSCSI connection.
+
+  @retval EFI_SUCCESS           The receive is started.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval Others                Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiConnStartReceive (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  IScsiOnRxTokenDone,
+                  Conn,
+                  &Conn->RxToken.Tcp4Token.CompletionToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  IScsiOnRxWork,
+                  Conn,
+                  &Conn->RxWorkEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn->RxToken.Tcp4Token.Packet.RxData = &Conn->RxData;
+
+  Status = IScsiConnRxNextPdu (Conn);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Conn->State = CONN_STATE_LOGGED_IN;
+
+  Status = IScsiConnRxPost (Conn);
+  if (EFI_ERROR (Status)) {
+    Conn->State = CONN_STATE_CLEANUP_WAIT;
+  }
+
+  return Status;
+}
+
+/**
+  Poll the TCP connection and process the PDUs received so far.
+
+  @param[in]  Conn              The iSCSI connection.
+
+**/
+VOID
+IScsiConnPoll (
+  IN ISCSI_CONNECTION  *Conn
+  )
+{
+  EFI_TPL  OldTpl;
+
+  if (Conn->TcpIo.TcpVersion == TCP_VERSION_4) {
+    Conn->TcpIo.Tcp.Tcp4->Poll (Conn->TcpIo.Tcp.Tcp4);
+  } else {
+    Conn->TcpIo.Tcp.Tcp6->Poll (Conn->TcpIo.Tcp.Tcp6);
+  }
+
+  //
+  // The caller may run at TPL_CALLBACK, where the work event can't fire.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  IScsiConnRxProcess (Conn);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Submit the queued non-blocking commands, in order, until the target can't
+  accept more.
+
+  @param[in]  Event             The event signaled.
+  @param[in]  Context           The iSCSI session.
+
+**/
+STATIC
+VOID
+EFIAPI
+IScsiSubmitPendingCmds (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS         Status;
+  ISCSI_SESSION      *Session;
+  ISCSI_PENDING_CMD  *Cmd;
+  ISCSI_TCB          *Tcb;
+  EFI_TPL            OldTpl;
+
+  Session = (ISCSI_SESSION *)Context;
+
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Session->PendingCmds)) {
+      gBS->RestoreTPL (OldTpl);
+      return;
+    }
+
+    Cmd = NET_LIST_HEAD (&Session->PendingCmds, ISCSI_PENDING_CMD, Link);
+    RemoveEntryList (&Cmd->Link);
+    gBS->RestoreTPL (OldTpl);
+
+    Status = IScsiSubmitScsiCommand (Session, Cmd->Lun, Cmd->Packet, &Tcb);
+    if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
+      //
+      // Try to reinstate the session and re-submit the command.
+      //
+      Status = IScsiSessionReinstatement (Session);
+      if (!EFI_ERROR (Status)) {
+        Status = IScsiSubmitScsiCommand (Session, Cmd->Lun, Cmd->Packet, &Tcb);
+      }
+    }
+
+    if (Status == EFI_NOT_READY) {
+      //
+      // Wait for the target to open the command window.
+      //
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      InsertHeadList (&Session->PendingCmds, &Cmd->Link);
+      gBS->RestoreTPL (OldTpl);
+      return;
+    }
+
+    if (EFI_ERROR (Status)) {
+      Cmd->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+      gBS->SignalEvent (Cmd->Event);
+    } else {
+      Tcb->Event = Cmd->Event;
+      if (Cmd->Packet->Timeout != 0) {
+        Tcb->TimeoutTicks = DivU64x32 (MultU64x32 (Cmd->Packet->Timeout, 4), ISCSI_ASYNC_TICK) + 1;
+      }
+    }
+
+    FreePool (Cmd);
+  }
+}
+
+/**
+  Check the timeout of the non-blocking commands, and retry the queued ones.
+
+  @param[in]  Event             The event signaled.
+  @param[in]  Context           The iSCSI session.
 
 **/
+STATIC
 VOID
-IScsiSessionInit (
-  IN OUT ISCSI_SESSION  *Session,
-  IN BOOLEAN            Recovery
+EFIAPI
+IScsiOnTick (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
   )
 {
-  if (!Recovery) {
-    Session->Signature = ISCSI_SESSION_SIGNATURE;
-    Session->State     = SESSION_STATE_FREE;
+  ISCSI_SESSION  *Session;
+  LIST_ENTRY     *Entry;
+  ISCSI_TCB      *Tcb;
 
-    InitializeListHead (&Session->Conns);
-    InitializeListHead (&Session->TcbList);
+  Session = (ISCSI_SESSION *)Context;
+
+  NET_LIST_FOR_EACH (Entry, &Session->TcbList) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, ISCSI_TCB, Link);
+    if ((Tcb->Event == NULL) || (Tcb->TimeoutTicks == 0)) {
+      continue;
+    }
+
+    Tcb->TimeoutTicks--;
+    if (Tcb->TimeoutTicks == 0) {
+      DEBUG ((DEBUG_ERROR, "IScsiOnTick: task 0x%x timed out\n", Tcb->InitiatorTaskTag));
+      IScsiConnFail (Tcb->Conn, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND);
+      break;
+    }
   }
 
-  Session->Tsih = 0;
+  if (!IsListEmpty (&Session->PendingCmds)) {
+    gBS->SignalEvent (Session->SubmitEvent);
+  }
+}
 
-  Session->CmdSN            = 1;
-  Session->InitiatorTaskTag = 1;
-  Session->NextCid          = 1;
+/**
+  Queue a non-blocking SCSI command. It is submitted at TPL_CALLBACK, as
+  soon as the target accepts it.
 
-  Session->TargetPortalGroupTag = 0;
-  Session->MaxConnections       = ISCSI_MAX_CONNS_PER_SESSION;
-  Session->InitialR2T           = FALSE;
-  Session->ImmediateData        = TRUE;
-  Session->MaxBurstLength       = 262144;
-  Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
-  Session->DefaultTime2Wait     = 2;
-  Session->DefaultTime2Retain   = 20;
-  Session->MaxOutstandingR2T    = DEFAULT_MAX_OUTSTANDING_R2T;
-  Session->DataPDUInOrder       = TRUE;
-  Session->DataSequenceInOrder  = TRUE;
-  Session->ErrorRecoveryLevel   = 0;
+  @param[in]       Session   The iSCSI session.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet.
+  @param[in]       Event     The event to signal when the command completes.
+
+  @retval EFI_SUCCESS          The command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval Others               Other errors as indicated.
+
+**/
+STATIC
+EFI_STATUS
+IScsiQueueScsiCommand (
+  IN     ISCSI_SESSION                               *Session,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event
+  )
+{
+  EFI_STATUS         Status;
+  ISCSI_PENDING_CMD  *Cmd;
+  EFI_TPL            OldTpl;
+
+  if (Session->State != SESSION_STATE_LOGGED_IN) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Session->SubmitEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    IScsiSubmitPendingCmds,
+                    Session,
+                    &Session->SubmitEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (Session->TickEvent == NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    IScsiOnTick,
+                    Session,
+                    &Session->TickEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = gBS->SetTimer (Session->TickEvent, TimerPeriodic, ISCSI_ASYNC_TICK);
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (Session->TickEvent);
+      Session->TickEvent = NULL;
+      return Status;
+    }
+  }
+
+  Cmd = AllocatePool (sizeof (ISCSI_PENDING_CMD));
+  if (Cmd == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cmd->Lun    = Lun;
+  Cmd->Packet = Packet;
+  Cmd->Event  = Event;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Session->PendingCmds, &Cmd->Link);
+  gBS->RestoreTPL (OldTpl);
+
+  gBS->SignalEvent (Session->SubmitEvent);
+
+  return EFI_SUCCESS;
 }
 
 /**
-  Abort the iSCSI session. That is, reset all the connection(s), and free the
-  resources.
+  Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
+
+  @param[in]       PassThru  The EXT SCSI PASS THRU protocol.
+  @param[in]       Target    The target ID.
+  @param[in]       Lun       The LUN.
+  @param[in, out]  Packet    The request packet containing IO request, SCSI command
+                             buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is queued and Event is signaled
+                             when it completes. Otherwise the command is executed
+                             before returning.
+
+  @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
+                               the Packet, or the command is queued.
+  @retval EFI_DEVICE_ERROR     Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
+  @retval EFI_PROTOCOL_ERROR   There is no such data in the net buffer.
+  @retval EFI_NOT_READY        The target can not accept new commands.
+  @retval Others               Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiExecuteScsiCommand (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
+  IN UINT8                                           *Target,
+  IN UINT64                                          Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event OPTIONAL
+  )
+{
+  EFI_STATUS         Status;
+  ISCSI_DRIVER_DATA  *Private;
+  ISCSI_TCB          *Tcb;
+  EFI_EVENT          TimeoutEvent;
+
+  Private = ISCSI_DRIVER_DATA_FROM_EXT_SCSI_PASS_THRU (PassThru);
+
+  if (Event != NULL) {
+    return IScsiQueueScsiCommand (Private->Session, Lun, Packet, Event);
+  }
+
+  Status = IScsiSubmitScsiCommand (Private->Session, Lun, Packet, &Tcb);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  TimeoutEvent = NULL;
+  if (Packet->Timeout != 0) {
+    Status = gBS->SetTimer (Tcb->Conn->TimeoutEvent, TimerRelative, MultU64x32 (Packet->Timeout, 4));
+    if (!EFI_ERROR (Status)) {
+      TimeoutEvent = Tcb->Conn->TimeoutEvent;
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+  while (!Tcb->StatusXferd) {
+    if ((TimeoutEvent != NULL) && !EFI_ERROR (gBS->CheckEvent (TimeoutEvent))) {
+      //
+      // The target may still send the data of the command, stop the connection.
+      //
+      IScsiConnFail (Tcb->Conn, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND);
+      Status = EFI_TIMEOUT;
+      break;
+    }
+
+    IScsiConnPoll (Tcb->Conn);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = Tcb->Status;
+  }
+
+  //
+  // The connection and its timer are gone if the session was aborted.
+  //
+  if ((TimeoutEvent != NULL) && (Tcb->Conn != NULL)) {
+    gBS->SetTimer (TimeoutEvent, TimerCancel, 0);
+  }
+
+  IScsiDelTcb (Tcb);
+
+  return Status;
+}
+
+/**
+  Reset all the connection(s) of the iSCSI session, and free their resources.
+  The outstanding and the queued commands are failed. The submit and tick
+  events of the session are kept.
 
   @param[in, out]  Session The iSCSI session.
 
 **/
+STATIC
 VOID
-IScsiSessionAbort (
+IScsiSessionReset (
   IN OUT ISCSI_SESSION  *Session
   )
 {
-  ISCSI_CONNECTION  *Conn;
-  EFI_GUID          *ProtocolGuid;
+  ISCSI_CONNECTION   *Conn;
+  EFI_GUID           *ProtocolGuid;
+  LIST_ENTRY         *Entry;
+  ISCSI_PENDING_CMD  *Cmd;
+  ISCSI_TCB          *Tcb;
+  EFI_TPL            OldTpl;
 
   if (Session->State != SESSION_STATE_LOGGED_IN) {
     return;
@@ -3176,6 +4073,51 @@ IScsiSessionAbort (
 
   ASSERT (!IsListEmpty (&Session->Conns));
 
+  //
+  // Fail the commands in flight and the ones waiting to be submitted.
+  //
+  NET_LIST_FOR_EACH (Entry, &Session->Conns) {
+    Conn = NET_LIST_USER_STRUCT_S (Entry, ISCSI_CONNECTION, Link, ISCSI_CONNECTION_SIGNATURE);
+    IScsiConnFail (Conn, EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER);
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (!IsListEmpty (&Session->PendingCmds)) {
+    Cmd = NET_LIST_HEAD (&Session->PendingCmds, ISCSI_PENDING_CMD, Link);
+    RemoveEntryList (&Cmd->Link);
+    Cmd->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+    gBS->SignalEvent (Cmd->Event);
+    FreePool (Cmd);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  //
+  // Only the blocking commands are left. Fail them and detach them from the
+  // connections freed below; their callers stop polling once the status is
+  // transferred and free them.
+  //
+  while (!IsListEmpty (&Session->TcbList)) {
+    Tcb = NET_LIST_HEAD (&Session->TcbList, ISCSI_TCB, Link);
+    if (!Tcb->StatusXferd) {
+      Tcb->Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+      Tcb->Status                    = EFI_DEVICE_ERROR;
+      Tcb->StatusXferd               = TRUE;
+    }
+
+    if (Tcb->Event != NULL) {
+      IScsiTcbDone (Tcb);
+      continue;
+    }
+
+    Session->TcbTable[ISCSI_TCB_INDEX (Tcb->InitiatorTaskTag)] = NULL;
+    Session->NumTcbs--;
+    Tcb->Conn->NumTcbs--;
+    RemoveEntryList (&Tcb->Link);
+    InitializeListHead (&Tcb->Link);
+    Tcb->Conn = NULL;
+  }
+
   while (!IsListEmpty (&Session->Conns)) {
     Conn = NET_LIST_USER_STRUCT_S (
              Session->Conns.ForwardLink,
@@ -3206,3 +4148,111 @@ IScsiSessionAbort (
 
   return;
 }
+
+/**
+  Reinstate the session on some error.
+
+  @param[in]  Session           The iSCSI session
+
+  @retval EFI_SUCCESS           The session is reinstated from some error.
+  @retval Other                 Reinstatement failed.
+
+**/
+EFI_STATUS
+IScsiSessionReinstatement (
+  IN ISCSI_SESSION  *Session
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Session->State != SESSION_STATE_FREE);
+
+  //
+  // Reset the session and re-init it. The submit and tick events are kept,
+  // this may run from the submit event and the commands submitted after the
+  // login still need their timeouts checked.
+  //
+  IScsiSessionReset (Session);
+  IScsiSessionInit (Session, TRUE);
+
+  //
+  // Login again.
+  //
+  Status = IScsiSessionLogin (Session);
+
+  return Status;
+}
+
+/**
+  Initialize some session parameters before login.
+
+  @param[in, out]  Session  The iSCSI session.
+  @param[in]       Recovery Whether the request is from a fresh new start or recovery.
+
+**/
+VOID
+IScsiSessionInit (
+  IN OUT ISCSI_SESSION  *Session,
+  IN BOOLEAN            Recovery
+  )
+{
+  if (!Recovery) {
+    Session->Signature = ISCSI_SESSION_SIGNATURE;
+    Session->State     = SESSION_STATE_FREE;
+
+    InitializeListHead (&Session->Conns);
+    InitializeListHead (&Session->TcbList);
+    InitializeListHead (&Session->PendingCmds);
+  }
+
+  ASSERT (IsListEmpty (&Session->TcbList));
+  ZeroMem (Session->TcbTable, sizeof (Session->TcbTable));
+  Session->NumTcbs = 0;
+
+  Session->Tsih = 0;
+
+  Session->CmdSN            = 1;
+  Session->InitiatorTaskTag = 1;
+  Session->NextCid          = 1;
+
+  Session->TargetPortalGroupTag = 0;
+  Session->MaxConnections       = ISCSI_MAX_CONNS_PER_SESSION;
+  Session->InitialR2T           = FALSE;
+  Session->ImmediateData        = TRUE;
+  Session->MaxBurstLength       = 262144;
+  Session->FirstBurstLength     = MAX_RECV_DATA_SEG_LEN_IN_FFP;
+  Session->DefaultTime2Wait     = 2;
+  Session->DefaultTime2Retain   = 20;
+  Session->MaxOutstandingR2T    = ISCSI_MAX_OUTSTANDING_R2T;
+  Session->DataPDUInOrder       = TRUE;
+  Session->DataSequenceInOrder  = TRUE;
+  Session->ErrorRecoveryLevel   = 0;
+}
+
+/**
+  Abort the iSCSI session. That is, reset all the connection(s), and free the
+  resources.
+
+  @param[in, out]  Session The iSCSI session.
+
+**/
+VOID
+IScsiSessionAbort (
+  IN OUT ISCSI_SESSION  *Session
+  )
+{
+  //
+  // The events may outlive a failed reinstatement, close them in any state.
+  //
+  if (Session->SubmitEvent != NULL) {
+    gBS->CloseEvent (Session->SubmitEvent);
+    Session->SubmitEvent = NULL;
+  }
+
+  if (Session->TickEvent != NULL) {
+    gBS->CloseEvent (Session->TickEvent);
+    Session->TickEvent = NULL;
+  }
+
+  IScsiSessionReset (Session);
+}
@@ -25,11 +25,26 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
     )
 
 #define ISCSI_WELL_KNOWN_PORT        3260
-#define ISCSI_MAX_CONNS_PER_SESSION  1
+#define ISCSI_MAX_CONNS_PER_SESSION  4
 
 #define DEFAULT_MAX_RECV_DATA_SEG_LEN  8192
 #define MAX_RECV_DATA_SEG_LEN_IN_FFP   65536
-#define DEFAULT_MAX_OUTSTANDING_R2T    1
+
+//
+// The Data-Out sequence for an R2T is sent before the next PDU is received,
+// so a task never has more than one R2T outstanding.
+//
+#define ISCSI_MAX_OUTSTANDING_R2T  1
+
+//
+// Maximum number of commands in flight on a session, must be a power of 2.
+// The task control blocks are indexed by the low bits of their initiator
+// task tag.
+//
+#define ISCSI_MAX_OUTSTANDING_CMDS  32
+#define ISCSI_TCB_INDEX(Itt)        ((Itt) & (ISCSI_MAX_OUTSTANDING_CMDS - 1))
+
+#define ISCSI_ASYNC_TICK  EFI_TIMER_PERIOD_MILLISECONDS (100)
 
 #define ISCSI_VERSION_MAX  0x00
 #define ISCSI_VERSION_MIN  0x00
@@ -595,24 +610,46 @@ typedef struct _ISCSI_IN_BUFFER_CONTEXT {
 } ISCSI_IN_BUFFER_CONTEXT;
 
 typedef struct _ISCSI_TCB {
-  LIST_ENTRY            Link;
-
-  BOOLEAN               SoFarInOrder;
-  UINT32                ExpDataSN;
-  BOOLEAN               FbitReceived;
-  BOOLEAN               StatusXferd;
-  UINT32                ActiveR2Ts;
-  UINT32                Response;
-  CHAR8                 *Reason;
-  UINT32                InitiatorTaskTag;
-  UINT32                CmdSN;
-  UINT32                SNACKTag;
-
-  ISCSI_XFER_CONTEXT    XferContext;
-
-  ISCSI_CONNECTION      *Conn;
+  LIST_ENTRY                                    Link;
+
+  BOOLEAN                                       SoFarInOrder;
+  UINT32                                        ExpDataSN;
+  BOOLEAN                                       FbitReceived;
+  BOOLEAN                                       StatusXferd;
+  UINT32                                        ActiveR2Ts;
+  UINT32                                        Response;
+  CHAR8                                         *Reason;
+  UINT32                                        InitiatorTaskTag;
+  UINT32                                        CmdSN;
+  UINT32                                        SNACKTag;
+
+  ISCSI_XFER_CONTEXT                            XferContext;
+
+  ISCSI_CONNECTION                              *Conn;
+
+  //
+  // The request the task is carrying out.
+  //
+  UINT64                                        Lun;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  ISCSI_IN_BUFFER_CONTEXT                       InBufferContext;
+  EFI_STATUS                                    Status;
+
+  //
+  // The event to signal on completion of a non-blocking command, and the
+  // number of ISCSI_ASYNC_TICK periods left before it times out.
+  //
+  EFI_EVENT                                     Event;
+  UINT64                                        TimeoutTicks;
 } ISCSI_TCB;
 
+typedef struct _ISCSI_PENDING_CMD {
+  LIST_ENTRY                                    Link;
+  UINT64                                        Lun;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                                     Event;
+} ISCSI_PENDING_CMD;
+
 typedef struct _ISCSI_KEY_VALUE_PAIR {
   LIST_ENTRY    List;
 
@@ -969,6 +1006,88 @@ IScsiNormalizeName (
   IN     UINTN  Len
   );
 
+/**
+  Find the outstanding task control block of a session by its initiator task tag.
+
+  @param[in]  Session           The iSCSI session.
+  @param[in]  InitiatorTaskTag  The initiator task tag, in host byte order.
+
+  @return The task control block, or NULL if no command is outstanding with this tag.
+
+**/
+ISCSI_TCB *
+IScsiFindTcb (
+  IN ISCSI_SESSION  *Session,
+  IN UINT32         InitiatorTaskTag
+  );
+
+/**
+  Delete the tcb from the connection and destroy it.
+
+  @param[in]  Tcb The tcb to delete.
+
+**/
+VOID
+IScsiDelTcb (
+  IN ISCSI_TCB  *Tcb
+  );
+
+/**
+  Submit a SCSI command on the least loaded connection of the session.
+
+  The SCSI Command PDU and the unsolicited Data-Out PDUs, if any, are sent. The
+  rest of the command is carried out as the PDUs of the target arrive on the
+  connection, until the StatusXferd field of the task control block is set.
+
+  @param[in]   Session          The iSCSI session.
+  @param[in]   Lun              The LUN.
+  @param[in]   Packet           The request packet containing IO request, SCSI command
+                                buffer and buffers to read/write.
+  @param[out]  Tcb              The task control block of the command. It must be
+                                freed with IScsiDelTcb() once the command is done.
+
+  @retval EFI_SUCCESS           The SCSI command is submitted.
+  @retval EFI_DEVICE_ERROR      Session state was not as required.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval EFI_NOT_READY         The target can not accept new commands.
+  @retval Others                Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiSubmitScsiCommand (
+  IN     ISCSI_SESSION                               *Session,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  OUT    ISCSI_TCB                                   **Tcb
+  );
+
+/**
+  Start receiving the full feature phase PDUs of a connection that just
+  logged in. The connection becomes usable for commands.
+
+  @param[in]  Conn              The iSCSI connection.
+
+  @retval EFI_SUCCESS           The receive is started.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate memory.
+  @retval Others                Other errors as indicated.
+
+**/
+EFI_STATUS
+IScsiConnStartReceive (
+  IN ISCSI_CONNECTION  *Conn
+  );
+
+/**
+  Poll the TCP connection and process the PDUs received so far.
+
+  @param[in]  Conn              The iSCSI connection.
+
+**/
+VOID
+IScsiConnPoll (
+  IN ISCSI_CONNECTION  *Conn
+  );
+
 /**
   Execute the SCSI command issued through the EXT SCSI PASS THRU protocol.
 
@@ -977,9 +1096,12 @@ IScsiNormalizeName (
   @param[in]       Lun       The LUN.
   @param[in, out]  Packet    The request packet containing IO request, SCSI command
                              buffer and buffers to read/write.
+  @param[in]       Event     If not NULL, the command is queued and Event is signaled
+                             when it completes. Otherwise the command is executed
+                             before returning.
 
   @retval EFI_SUCCESS          The SCSI command is executed and the result is updated to
-                               the Packet.
+                               the Packet, or the command is queued.
   @retval EFI_DEVICE_ERROR     Session state was not as required.
   @retval EFI_OUT_OF_RESOURCES Failed to allocate memory.
   @retval EFI_NOT_READY        The target can not accept new commands.
@@ -991,7 +1113,8 @@ IScsiExecuteScsiCommand (
   IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL                 *PassThru,
   IN UINT8                                           *Target,
   IN UINT64                                          Lun,
-  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN EFI_EVENT                                       Event OPTIONAL
   );
 
 /**
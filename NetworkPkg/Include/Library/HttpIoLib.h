@@ -18,6 +18,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_IO_MAX_SEND_PAYLOAD                     1024
 #define HTTP_IO_CHUNK_SIZE_STRING_LEN                50
 #define HTTP_IO_CHUNKED_TRANSFER_CODING_DATA_LENGTH  256
+#define HTTP_IO_POOL_MAX_CONNECTIONS                 4
 
 ///
 /// HTTP_IO_CALLBACK_EVENT
@@ -113,8 +114,46 @@ typedef struct {
 
   EFI_EVENT            TimeoutEvent;
   UINT32               Timeout;
+
+  //
+  // Tokens of the requests sent by HttpIoSendPipelinedRequests(), they're
+  // kept until the next call as the HTTP driver holds them until their
+  // responses are received.
+  //
+  UINTN                PipelineCount;
+  EFI_HTTP_TOKEN       *PipelineTokens;
+  BOOLEAN              *PipelineTxDone;
 } HTTP_IO;
 
+///
+/// A persistent connection of HTTP_IO_POOL. The HTTP child keeps its TCP (and
+/// TLS) connection to the last host it talked to open between requests.
+///
+typedef struct {
+  HTTP_IO    HttpIo;
+  CHAR8      *HostName;
+  UINT16     Port;
+  BOOLEAN    UseHttps;
+  UINT64     LastUsed;
+} HTTP_IO_POOL_CONNECTION;
+
+///
+/// A pool of persistent HTTP connections of one NIC, keyed by the scheme,
+/// host and port of the request URL.
+///
+typedef struct {
+  EFI_HANDLE                 Image;
+  EFI_HANDLE                 Controller;
+  UINT8                      IpVersion;
+  HTTP_IO_CONFIG_DATA        ConfigData;
+  HTTP_IO_CALLBACK           Callback;
+  VOID                       *Context;
+
+  UINT64                     UseCount;
+  UINTN                      ConnectionCount;
+  HTTP_IO_POOL_CONNECTION    Connections[HTTP_IO_POOL_MAX_CONNECTIONS];
+} HTTP_IO_POOL;
+
 ///
 /// Process code of HTTP chunk transfer.
 ///
@@ -263,6 +302,97 @@ HttpIoRecvResponse (
   OUT     HTTP_IO_RESPONSE_DATA  *ResponseData
   );
 
+/**
+  Send several HTTP REQUEST messages to the server back to back, without
+  waiting for the responses in between (HTTP/1.1 pipelining).
+
+  The responses are received in the order of Messages, by calling
+  HttpIoRecvResponse() once per request. Messages and the data they point to
+  must stay valid until then, and all the responses must be received before
+  HttpIoSendPipelinedRequests() is called again on the same HttpIo.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[in]   RequestCount     Number of messages in Messages.
+  @param[in]   Messages         Array of the request messages to send.
+
+  @retval EFI_SUCCESS            All the HTTP requests are transmitted.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+  @retval EFI_DEVICE_ERROR       An unexpected network or system error occurred.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoSendPipelinedRequests (
+  IN  HTTP_IO           *HttpIo,
+  IN  UINTN             RequestCount,
+  IN  EFI_HTTP_MESSAGE  *Messages
+  );
+
+/**
+  Initialize a pool of persistent HTTP connections. The HTTP children are
+  created on demand by HttpIoPoolGetIo().
+
+  @param[in]  Image          The handle of the driver image.
+  @param[in]  Controller     The handle of the controller.
+  @param[in]  IpVersion      IP_VERSION_4 or IP_VERSION_6.
+  @param[in]  ConfigData     The HTTP_IO configuration data of every connection.
+  @param[in]  Callback       Callback function which will be invoked when specified
+                             HTTP_IO_CALLBACK_EVENT happened.
+  @param[in]  Context        The Context data which will be passed to the Callback function.
+  @param[out] Pool           The HTTP_IO_POOL.
+
+  @retval EFI_SUCCESS            The pool is initialized.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_UNSUPPORTED        IpVersion is not supported.
+
+**/
+EFI_STATUS
+HttpIoPoolInit (
+  IN EFI_HANDLE           Image,
+  IN EFI_HANDLE           Controller,
+  IN UINT8                IpVersion,
+  IN HTTP_IO_CONFIG_DATA  *ConfigData,
+  IN HTTP_IO_CALLBACK     Callback,
+  IN VOID                 *Context,
+  OUT HTTP_IO_POOL        *Pool
+  );
+
+/**
+  Get the HTTP_IO to send a request for Url with.
+
+  The connection last used for the same scheme, host and port is returned, so
+  that its TCP and TLS sessions are reused. Otherwise a new connection is
+  created, or the least recently used one is handed over if the pool is full.
+
+  @param[in]   Pool             The HTTP_IO_POOL.
+  @param[in]   Url              The URL of the request.
+  @param[out]  HttpIo           The HTTP_IO to use for the request.
+
+  @retval EFI_SUCCESS            The HTTP_IO is returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+  @retval Others                 Failed to create the HTTP_IO.
+
+**/
+EFI_STATUS
+HttpIoPoolGetIo (
+  IN  HTTP_IO_POOL  *Pool,
+  IN  CHAR8         *Url,
+  OUT HTTP_IO       **HttpIo
+  );
+
+/**
+  Destroy all the connections of the pool.
+
+  @param[in]  Pool          The HTTP_IO_POOL.
+
+**/
+VOID
+HttpIoPoolDestroy (
+  IN HTTP_IO_POOL  *Pool
+  );
+
 /**
   Get the value of the content length if there is a "Content-Length" header.
 
@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/Ip4.h>
 #include <Protocol/Ip6.h>
+#include <Protocol/NetworkOffload.h>
 
 #include <Library/NetLib.h>
 
@@ -290,14 +291,15 @@ typedef struct _IP_IO_SEND_ENTRY {
 /// in IP_IO.
 ///
 typedef struct _IP_IO_IP_INFO {
-  EFI_IP_ADDRESS               Addr;
-  IP_IO_IP_MASK                PreMask;
-  LIST_ENTRY                   Entry;
-  EFI_HANDLE                   ChildHandle;
-  IP_IO_IP_PROTOCOL            Ip;
-  IP_IO_IP_COMPLETION_TOKEN    DummyRcvToken;
-  INTN                         RefCnt;
-  UINT8                        IpVersion;
+  EFI_IP_ADDRESS                Addr;
+  IP_IO_IP_MASK                 PreMask;
+  LIST_ENTRY                    Entry;
+  EFI_HANDLE                    ChildHandle;
+  IP_IO_IP_PROTOCOL             Ip;
+  IP_IO_IP_COMPLETION_TOKEN     DummyRcvToken;
+  INTN                          RefCnt;
+  UINT8                         IpVersion;
+  EDKII_IP4_OFFLOAD_PROTOCOL    *Ip4Offload;   ///< NULL if not supported by the IP instance.
 } IP_IO_IP_INFO;
 
 /**
@@ -434,6 +436,46 @@ IpIoSend (
   IN     IP_IO_OVERRIDE  *OverrideData  OPTIONAL
   );
 
+/**
+  Send out an IP packet with transmit offload.
+
+  Same as IpIoSend(), except that the offload requested in TxInfo is passed
+  to the IPv4 instance of Sender. The offload is ignored if TxInfo is NULL,
+  if Sender is NULL, or if the IP instance doesn't support offload; query
+  IpIoGetOffloadCapabilities() first.
+
+  @param[in, out]  IpIo                  Pointer to an IP_IO instance used for sending IP
+                                         packet.
+  @param[in, out]  Pkt                   Pointer to the IP packet to be sent.
+  @param[in]       Sender                The IP protocol instance used for sending.
+  @param[in]       Context               Optional context data.
+  @param[in]       NotifyData            Optional notify data.
+  @param[in]       Dest                  The destination IP address to send this packet to.
+                                         This parameter is optional when using IPv6.
+  @param[in]       OverrideData          The data to override some configuration of the IP
+                                         instance used for sending.
+  @param[in]       TxInfo                The offload requested for the packet.
+
+  @retval          EFI_SUCCESS           The operation is completed successfully.
+  @retval          EFI_INVALID_PARAMETER The input parameter is not correct.
+  @retval          EFI_NOT_STARTED       The IpIo is not configured.
+  @retval          EFI_OUT_OF_RESOURCES  Failed due to resource limit.
+  @retval          Others                Error condition occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoSendWithOffload (
+  IN OUT IP_IO                          *IpIo,
+  IN OUT NET_BUF                        *Pkt,
+  IN     IP_IO_IP_INFO                  *Sender        OPTIONAL,
+  IN     VOID                           *Context       OPTIONAL,
+  IN     VOID                           *NotifyData    OPTIONAL,
+  IN     EFI_IP_ADDRESS                 *Dest          OPTIONAL,
+  IN     IP_IO_OVERRIDE                 *OverrideData  OPTIONAL,
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo        OPTIONAL
+  );
+
 /**
   Cancel the IP transmit token that wraps this Packet.
 
@@ -498,6 +540,26 @@ IpIoConfigIp (
   IN OUT VOID           *IpConfigData OPTIONAL
   );
 
+/**
+  Get the transmit offloads performed in hardware below an IP instance.
+
+  @param[in]   IpInfo            Pointer to the IP_IO_IP_INFO instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware,
+                                 zero if the IP instance doesn't support offload.
+  @param[out]  MaxLargeSendSize  Largest IPv4 packet accepted with EDKII_NETWORK_OFFLOAD_TSO4.
+
+  @retval      EFI_SUCCESS           The capabilities are returned.
+  @retval      EFI_INVALID_PARAMETER One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoGetOffloadCapabilities (
+  IN  IP_IO_IP_INFO  *IpInfo,
+  OUT UINT32         *Capabilities,
+  OUT UINT32         *MaxLargeSendSize
+  );
+
 /**
   Destroy an IP instance maintained in IpIo->IpList for
   sending purpose.
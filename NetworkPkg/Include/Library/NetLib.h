@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define _NET_LIB_H_
 
 #include <Protocol/Ip6.h>
+#include <Protocol/NetworkOffload.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -1528,14 +1529,30 @@ NetLibIp6ToStr (
 //
 // Various signatures
 //
-#define  NET_BUF_SIGNATURE     SIGNATURE_32 ('n', 'b', 'u', 'f')
-#define  NET_VECTOR_SIGNATURE  SIGNATURE_32 ('n', 'v', 'e', 'c')
-#define  NET_QUE_SIGNATURE     SIGNATURE_32 ('n', 'b', 'q', 'u')
+#define  NET_BUF_SIGNATURE       SIGNATURE_32 ('n', 'b', 'u', 'f')
+#define  NET_VECTOR_SIGNATURE    SIGNATURE_32 ('n', 'v', 'e', 'c')
+#define  NET_QUE_SIGNATURE       SIGNATURE_32 ('n', 'b', 'q', 'u')
 
-#define  NET_PROTO_DATA        64   // Opaque buffer for protocols
-#define  NET_BUF_HEAD          1    // Trim or allocate space from head
-#define  NET_BUF_TAIL          0    // Trim or allocate space from tail
-#define  NET_VECTOR_OWN_FIRST  0x01 // We allocated the 1st block in the vector
+#define  NET_PROTO_DATA          64   // Opaque buffer for protocols
+#define  NET_BUF_HEAD            1    // Trim or allocate space from head
+#define  NET_BUF_TAIL            0    // Trim or allocate space from tail
+#define  NET_VECTOR_OWN_FIRST    0x01 // We allocated the 1st block in the vector
+#define  NET_VECTOR_CACHED_BULK  0x02 // The single block came from a bulk cache class
+
+//
+// Net buffer cache configuration. NET_BUF and NET_VECTOR structures with up to
+// (1 << (NET_BUF_CACHE_CLASS_NUM - 1)) blocks are recycled through per-size
+// free lists. So are the data blocks of NetbufAlloc() up to
+// NET_BUF_CACHE_BULK_SIZE bytes, in NET_BUF_CACHE_BULK_CLASS_NUM size classes
+// of 128, 512 and 2048 bytes, so that a small header or ACK buffer doesn't
+// hold an MTU sized block.
+//
+#define  NET_BUF_CACHE_CLASS_NUM       4
+#define  NET_BUF_CACHE_BULK_CLASS_NUM  3
+#define  NET_BUF_CACHE_BULK_SIZE       2048
+
+#define NET_BUF_CACHE_BULK_CLASS_SIZE(Class) \
+  (NET_BUF_CACHE_BULK_SIZE >> (2 * (NET_BUF_CACHE_BULK_CLASS_NUM - 1 - (Class))))
 
 #define NET_CHECK_SIGNATURE(PData, SIGNATURE) \
   ASSERT (((PData) != NULL) && ((PData)->Signature == (SIGNATURE)))
@@ -1560,7 +1577,7 @@ typedef struct {
   INTN                   RefCnt; // Reference count to share NET_VECTOR.
   NET_VECTOR_EXT_FREE    Free;   // external function to free NET_VECTOR
   VOID                   *Arg;   // opaque argument to Free
-  UINT32                 Flag;   // Flags, NET_VECTOR_OWN_FIRST
+  UINT32                 Flag;   // Flags, NET_VECTOR_OWN_FIRST or NET_VECTOR_CACHED_BULK
   UINT32                 Len;    // Total length of the associated BLOCKs
 
   UINT32                 BlockNum;
@@ -1669,6 +1686,22 @@ typedef struct {
 #define NET_BUF_SIZE(BlockOpNum)  \
   (sizeof (NET_BUF) + ((BlockOpNum) - 1) * sizeof (NET_BLOCK_OP))
 
+//
+// Allocation statistics of one net buffer cache size class.
+//
+typedef struct {
+  UINT64    AllocCount;           // Total allocations from this class
+  UINT64    CacheHits;            // Allocations served from the free list
+  UINT64    FreeCount;            // Total frees to this class
+  UINT32    Cached;               // Objects currently held by the free list
+} NET_BUF_CACHE_CLASS_STATS;
+
+typedef struct {
+  NET_BUF_CACHE_CLASS_STATS    Buf[NET_BUF_CACHE_CLASS_NUM];
+  NET_BUF_CACHE_CLASS_STATS    Vector[NET_BUF_CACHE_CLASS_NUM];
+  NET_BUF_CACHE_CLASS_STATS    Bulk[NET_BUF_CACHE_BULK_CLASS_NUM];
+} NET_BUF_POOL_STATS;
+
 #define NET_HEADSPACE(BlockOp)  \
   ((UINTN)((BlockOp)->Head) - (UINTN)((BlockOp)->BlockHead))
 
@@ -2195,6 +2228,82 @@ NetIp6PseudoHeadChecksum (
   IN UINT32            Len
   );
 
+/**
+  Retrieve the allocation statistics of the net buffer caches.
+
+  @param[out]  Stats         Pointer to the buffer to receive the statistics.
+
+**/
+VOID
+EFIAPI
+NetbufGetPoolStats (
+  OUT NET_BUF_POOL_STATS  *Stats
+  );
+
+/**
+  Release all the NET_BUF, NET_VECTOR and data blocks held by the net buffer
+  caches back to the pool.
+
+**/
+VOID
+EFIAPI
+NetbufFlushPoolCache (
+  VOID
+  );
+
+/**
+  Callback used by NetLibOffloadFrame to hand a finished frame to the
+  link layer.
+
+  @param[in]  Context       The context passed to NetLibOffloadFrame.
+  @param[in]  Frame         Pointer to the frame. The buffer is only valid
+                            during the call and must be copied if kept.
+  @param[in]  FrameLength   Length of the frame, in bytes.
+
+  @retval EFI_SUCCESS       The frame was sent.
+  @retval Others            The frame couldn't be sent.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *NET_OFFLOAD_SEND_FRAME)(
+  IN VOID    *Context,
+  IN UINT8   *Frame,
+  IN UINT32  FrameLength
+  );
+
+/**
+  Perform the transmit offloads requested in TxInfo in software.
+
+  The IPv4, TCP and UDP checksums requested by TxInfo->Flags are computed in
+  place. If EDKII_NETWORK_OFFLOAD_TSO4 is requested and the TCP payload is
+  larger than TxInfo->Mss, the frame is split into segments of at most
+  TxInfo->Mss bytes of payload, each of them with its own headers and
+  checksums. SendFrame is called once for every resulting frame.
+
+  @param[in]       TxInfo        The offloads requested for the frame.
+  @param[in, out]  Frame         Pointer to the frame, starting with the media header.
+  @param[in]       FrameLength   Length of the frame, in bytes.
+  @param[in]       SendFrame     Function called to send every resulting frame.
+  @param[in]       Context       Context passed to SendFrame.
+
+  @retval EFI_SUCCESS            All the resulting frames were sent.
+  @retval EFI_INVALID_PARAMETER  The frame doesn't carry a valid IPv4 packet at
+                                 TxInfo->HeaderOffset, or TxInfo->Mss is zero.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the segment buffer.
+  @retval Others                 The error returned by SendFrame.
+
+**/
+EFI_STATUS
+EFIAPI
+NetLibOffloadFrame (
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo,
+  IN OUT UINT8                          *Frame,
+  IN     UINT32                         FrameLength,
+  IN     NET_OFFLOAD_SEND_FRAME         SendFrame,
+  IN     VOID                           *Context
+  );
+
 /**
   The function frees the net buffer which allocated by the IP protocol. It releases
   only the net buffer and doesn't call the external free function.
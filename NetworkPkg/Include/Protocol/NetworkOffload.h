@@ -0,0 +1,218 @@
+/** @file
+  This file defines the EDKII network offload protocols.
+
+  The offload protocols are an optional companion to the Simple Network,
+  Managed Network and IPv4 protocols. They let an upper layer hand a frame
+  to the lower layer with a request to compute the IPv4/TCP/UDP checksums
+  and/or to split a large TCP segment into MSS-sized segments (TSO). A
+  lower layer that cannot do the requested work in hardware falls back to
+  software, so the caller only has to check the reported capabilities to
+  decide whether an offload is worth requesting.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_NETWORK_OFFLOAD_H_
+#define EDKII_NETWORK_OFFLOAD_H_
+
+#include <Protocol/SimpleNetwork.h>
+#include <Protocol/ManagedNetwork.h>
+#include <Protocol/Ip4.h>
+
+#define EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL_GUID \
+  { \
+    0x6f1c9a4e, 0x2d3b, 0x4c57, {0x9e, 0x1a, 0x83, 0x5d, 0x0b, 0x7c, 0x46, 0xf2} \
+  }
+
+#define EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL_GUID \
+  { \
+    0x0a7d3b62, 0x9e45, 0x4f1b, {0xb6, 0x2c, 0x51, 0xe8, 0x94, 0x0d, 0x3a, 0x7f} \
+  }
+
+#define EDKII_IP4_OFFLOAD_PROTOCOL_GUID \
+  { \
+    0xc3e81f05, 0x64a2, 0x4d9e, {0x8b, 0x37, 0x2f, 0xa1, 0x5c, 0x6e, 0x90, 0x1d} \
+  }
+
+typedef struct _EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL   EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL;
+typedef struct _EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL;
+typedef struct _EDKII_IP4_OFFLOAD_PROTOCOL              EDKII_IP4_OFFLOAD_PROTOCOL;
+
+#define EDKII_NETWORK_OFFLOAD_PROTOCOL_REVISION  0x00010000
+
+//
+// Offload capabilities and transmit request flags.
+//
+#define EDKII_NETWORK_OFFLOAD_IP4_CSUM   BIT0     ///< Compute the IPv4 header checksum.
+#define EDKII_NETWORK_OFFLOAD_TCP4_CSUM  BIT1     ///< Compute the TCP checksum over IPv4.
+#define EDKII_NETWORK_OFFLOAD_UDP4_CSUM  BIT2     ///< Compute the UDP checksum over IPv4.
+#define EDKII_NETWORK_OFFLOAD_TSO4       BIT3     ///< Split a TCP over IPv4 segment by Mss.
+#define EDKII_NETWORK_OFFLOAD_RX_CSUM    BIT16    ///< Received frames with a bad IPv4/TCP/UDP
+                                                  ///< checksum are dropped by the device.
+
+#define EDKII_NETWORK_OFFLOAD_TX_MASK \
+  (EDKII_NETWORK_OFFLOAD_IP4_CSUM | EDKII_NETWORK_OFFLOAD_TCP4_CSUM | \
+   EDKII_NETWORK_OFFLOAD_UDP4_CSUM | EDKII_NETWORK_OFFLOAD_TSO4)
+
+///
+/// Per-frame offload request.
+///
+/// The frame must carry an IPv4 header at HeaderOffset, followed by the TCP
+/// or UDP header. The checksum fields the offload is asked to fill must be
+/// zero. When EDKII_NETWORK_OFFLOAD_TSO4 is set, the TCP payload is split
+/// into segments of at most Mss bytes; the IPv4 total length, identification
+/// and checksum, and the TCP sequence number, flags and checksum of every
+/// segment are rewritten, with FIN and PSH only set on the last segment.
+///
+typedef struct {
+  UINT32    Flags;
+  UINT16    Mss;
+  UINT16    HeaderOffset;
+} EDKII_NETWORK_OFFLOAD_TX_INFO;
+
+/**
+  Place a frame in the transmit queue of a network interface with offload.
+
+  This function has the same semantics as EFI_SIMPLE_NETWORK_PROTOCOL.Transmit(),
+  except that the frame may be up to MaxLargeSendSize bytes long when
+  EDKII_NETWORK_OFFLOAD_TSO4 is requested. HeaderOffset in TxInfo is relative
+  to the start of Buffer, including the media header.
+
+  @param[in]  This              Pointer to the EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo            The offload requested for this frame.
+  @param[in]  HeaderSize        The size, in bytes, of the media header to be filled in by
+                                the Transmit() function.
+  @param[in]  BufferSize        The size, in bytes, of the entire packet.
+  @param[in]  Buffer            A pointer to the packet.
+  @param[in]  SrcAddr           The source HW MAC address.
+  @param[in]  DestAddr          The destination HW MAC address.
+  @param[in]  Protocol          The type of header to build.
+
+  @retval EFI_SUCCESS           The packet was placed on the transmit queue.
+  @retval EFI_UNSUPPORTED       One of the requested offloads is not supported.
+  @retval EFI_NOT_READY         The network interface is too busy to accept this transmit request.
+  @retval EFI_BUFFER_TOO_SMALL  The BufferSize parameter is too small.
+  @retval EFI_INVALID_PARAMETER One or more of the parameters has an unsupported value.
+  @retval Others                Other errors as indicated by EFI_SIMPLE_NETWORK_PROTOCOL.Transmit().
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SIMPLE_NETWORK_OFFLOAD_TRANSMIT)(
+  IN EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO          *TxInfo,
+  IN UINTN                                  HeaderSize,
+  IN UINTN                                  BufferSize,
+  IN VOID                                   *Buffer,
+  IN EFI_MAC_ADDRESS                        *SrcAddr  OPTIONAL,
+  IN EFI_MAC_ADDRESS                        *DestAddr OPTIONAL,
+  IN UINT16                                 *Protocol OPTIONAL
+  );
+
+///
+/// The EDKII Simple Network Offload Protocol is installed by a network
+/// interface driver on the handle carrying its EFI_SIMPLE_NETWORK_PROTOCOL.
+/// Transmit buffers handed to it are recycled through the GetStatus()
+/// service of that EFI_SIMPLE_NETWORK_PROTOCOL.
+///
+struct _EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL {
+  UINT64                                   Revision;
+  UINT32                                   Capabilities;
+  UINT32                                   MaxLargeSendSize;
+  EDKII_SIMPLE_NETWORK_OFFLOAD_TRANSMIT    Transmit;
+};
+
+/**
+  Return the offloads performed by the hardware below this protocol instance.
+
+  @param[in]   This              Pointer to the offload protocol instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware.
+  @param[out]  MaxLargeSendSize  Largest frame, without media header, accepted with
+                                 EDKII_NETWORK_OFFLOAD_TSO4. Zero if TSO isn't supported.
+
+  @retval EFI_SUCCESS            The capabilities are returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_NETWORK_OFFLOAD_GET_CAPABILITIES)(
+  IN  VOID    *This,
+  OUT UINT32  *Capabilities,
+  OUT UINT32  *MaxLargeSendSize
+  );
+
+/**
+  Places an outgoing data packet into the MNP transmit queue with offload.
+
+  This function has the same semantics as EFI_MANAGED_NETWORK_PROTOCOL.Transmit(),
+  except that Token.Packet.TxData.DataLength may exceed the MTU when
+  EDKII_NETWORK_OFFLOAD_TSO4 is requested. HeaderOffset in TxInfo is relative
+  to the start of the data, after the media header. Offloads not available
+  in hardware are performed in software.
+
+  @param[in]  This              Pointer to the EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo            The offload requested for this packet.
+  @param[in]  Token             Pointer to a token associated with the transmit data descriptor.
+
+  @retval EFI_SUCCESS           The transmit completion token was cached.
+  @retval Others                As EFI_MANAGED_NETWORK_PROTOCOL.Transmit().
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MANAGED_NETWORK_OFFLOAD_TRANSMIT)(
+  IN EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO           *TxInfo,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN    *Token
+  );
+
+///
+/// The EDKII Managed Network Offload Protocol is installed on every MNP
+/// child handle, next to its EFI_MANAGED_NETWORK_PROTOCOL.
+///
+struct _EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL {
+  EDKII_NETWORK_OFFLOAD_GET_CAPABILITIES    GetCapabilities;
+  EDKII_MANAGED_NETWORK_OFFLOAD_TRANSMIT    Transmit;
+};
+
+/**
+  Places an outgoing data packet into the IPv4 transmit queue with offload.
+
+  This function has the same semantics as EFI_IP4_PROTOCOL.Transmit(), except
+  that the packet isn't fragmented when EDKII_NETWORK_OFFLOAD_TSO4 is
+  requested and may then be up to MaxLargeSendSize bytes long. TxInfo's
+  HeaderOffset is ignored; the IPv4 header is always at the start of the
+  packet handed to the link layer.
+
+  @param[in]  This              Pointer to the EDKII_IP4_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo            The offload requested for this packet.
+  @param[in]  Token             Pointer to the transmit token.
+
+  @retval EFI_SUCCESS           The data has been queued for transmission.
+  @retval Others                As EFI_IP4_PROTOCOL.Transmit().
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_IP4_OFFLOAD_TRANSMIT)(
+  IN EDKII_IP4_OFFLOAD_PROTOCOL     *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo,
+  IN EFI_IP4_COMPLETION_TOKEN       *Token
+  );
+
+///
+/// The EDKII IPv4 Offload Protocol is installed on every IPv4 child handle,
+/// next to its EFI_IP4_PROTOCOL.
+///
+struct _EDKII_IP4_OFFLOAD_PROTOCOL {
+  EDKII_NETWORK_OFFLOAD_GET_CAPABILITIES    GetCapabilities;
+  EDKII_IP4_OFFLOAD_TRANSMIT                Transmit;
+};
+
+extern EFI_GUID  gEdkiiSimpleNetworkOffloadProtocolGuid;
+extern EFI_GUID  gEdkiiManagedNetworkOffloadProtocolGuid;
+extern EFI_GUID  gEdkiiIp4OffloadProtocolGuid;
+
+#endif
@@ -0,0 +1,92 @@
+/** @file
+  This file defines the EDKII TLS Record Protocol interface.
+
+  The TLS Record Protocol is an optional companion to EFI_TLS_PROTOCOL and is
+  installed on the same TLS child handle. EFI_TLS_PROTOCOL.ProcessPacket()
+  returns the decrypted records in a fragment table allocated by the TLS
+  driver, which the caller then copies to its own buffer. DecryptToBuffer()
+  lets the caller name the destination of the plain text instead, so that
+  the TLS APP payload is written by the cipher straight into, for example,
+  the body buffer of an HTTP response.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_TLS_RECORD_H_
+#define EDKII_TLS_RECORD_H_
+
+#include <Protocol/Tls.h>
+
+#define EDKII_TLS_RECORD_PROTOCOL_GUID \
+  { \
+    0xaaac712d, 0xc155, 0x4a15, {0x8b, 0x99, 0x4a, 0x9e, 0xa5, 0x9e, 0xa6, 0x67} \
+  }
+
+typedef struct _EDKII_TLS_RECORD_PROTOCOL EDKII_TLS_RECORD_PROTOCOL;
+
+#define EDKII_TLS_RECORD_PROTOCOL_REVISION  0x00010000
+
+/**
+  Decrypt TLS application data records into a caller supplied buffer.
+
+  FragmentTable describes one or more complete TLS records of the
+  application_data content type, each with its TLS header and cipher text
+  payload. A record may span several fragments. The fragments are not
+  modified.
+
+  The plain text TLS APP payload of all the records is written to Buffer, in
+  order and without the TLS headers. The part of the payload that doesn't
+  fit in Buffer is returned in Remainder.
+
+  @param[in]       This           Pointer to the EDKII_TLS_RECORD_PROTOCOL instance.
+  @param[in]       FragmentTable  Pointer to a list of fragment holding the records.
+  @param[in]       FragmentCount  Number of fragment.
+  @param[out]      Buffer         The buffer to receive the plain text in. May be NULL
+                                  if *BufferSize is zero.
+  @param[in, out]  BufferSize     On input, the size of Buffer in bytes. On output, the
+                                  number of bytes written to Buffer.
+  @param[out]      Remainder      The rest of the plain text, in a buffer to be freed by
+                                  the caller with FreePool(). NULL if there is none.
+  @param[out]      RemainderSize  The size of Remainder in bytes.
+
+  @retval EFI_SUCCESS             The records are decrypted successfully.
+  @retval EFI_INVALID_PARAMETER   One or more of the following conditions is TRUE:
+                                  This, FragmentTable, BufferSize, Remainder or
+                                  RemainderSize is NULL.
+                                  FragmentCount is 0.
+                                  Buffer is NULL if *BufferSize is not zero.
+                                  The fragments don't hold complete application_data
+                                  records.
+  @retval EFI_NOT_READY           Current TLS session state is NOT
+                                  EfiTlsSessionDataTransferring.
+  @retval EFI_ABORTED             Something wrong decryption the message. TLS session
+                                  status will become EfiTlsSessionError. The caller need
+                                  call BuildResponsePacket() to generate Error Alert
+                                  message and send it out.
+  @retval EFI_OUT_OF_RESOURCES    No enough resource to finish the operation.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TLS_RECORD_DECRYPT_TO_BUFFER)(
+  IN     EDKII_TLS_RECORD_PROTOCOL  *This,
+  IN     EFI_TLS_FRAGMENT_DATA      *FragmentTable,
+  IN     UINT32                     FragmentCount,
+  OUT    UINT8                      *Buffer OPTIONAL,
+  IN OUT UINTN                      *BufferSize,
+  OUT    UINT8                      **Remainder,
+  OUT    UINTN                      *RemainderSize
+  );
+
+///
+/// The EDKII TLS Record Protocol gives direct access to the application
+/// data path of a TLS session.
+///
+struct _EDKII_TLS_RECORD_PROTOCOL {
+  UINT64                                Revision;
+  EDKII_TLS_RECORD_DECRYPT_TO_BUFFER    DecryptToBuffer;
+};
+
+extern EFI_GUID  gEdkiiTlsRecordProtocolGuid;
+
+#endif
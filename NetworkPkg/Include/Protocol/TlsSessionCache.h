@@ -0,0 +1,64 @@
+/** @file
+  This file defines the EDKII TLS Session Cache Protocol interface.
+
+  The TLS Session Cache Protocol is an optional companion to EFI_TLS_PROTOCOL
+  and is installed on the same TLS child handle. The TLS driver may keep the
+  session of a finished connection and resume it on the next connection to
+  the same server, which skips the certificate exchange of the handshake.
+  A server is identified by the host name set with EfiTlsVerifyHost and by
+  the port given with SetPeer(); the sessions of a TLS child whose port was
+  never given aren't cached.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_TLS_SESSION_CACHE_H_
+#define EDKII_TLS_SESSION_CACHE_H_
+
+#define EDKII_TLS_SESSION_CACHE_PROTOCOL_GUID \
+  { \
+    0x4c1d8e27, 0x5b93, 0x4f06, {0xa2, 0x6e, 0x71, 0x3c, 0xd9, 0x0b, 0x85, 0xe4} \
+  }
+
+typedef struct _EDKII_TLS_SESSION_CACHE_PROTOCOL EDKII_TLS_SESSION_CACHE_PROTOCOL;
+
+#define EDKII_TLS_SESSION_CACHE_PROTOCOL_REVISION  0x00010000
+
+/**
+  Identify the server port of the TLS session, so that the session may be
+  cached and resumed.
+
+  A session is only cached and resumed if the peer certificate is verified,
+  that is EfiTlsVerifyMethod includes EFI_TLS_VERIFY_PEER and a host name is
+  set with EfiTlsVerifyHost. It is resumed only by a connection to the same
+  host name and port, with the same verification settings and CA
+  certificates.
+
+  @param[in]  This                Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  Port                The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL or Port is 0.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TLS_SESSION_CACHE_SET_PEER)(
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            Port
+  );
+
+///
+/// The EDKII TLS Session Cache Protocol lets the caller opt in to the
+/// resumption of the sessions of a TLS child.
+///
+struct _EDKII_TLS_SESSION_CACHE_PROTOCOL {
+  UINT64                              Revision;
+  EDKII_TLS_SESSION_CACHE_SET_PEER    SetPeer;
+};
+
+extern EFI_GUID  gEdkiiTlsSessionCacheProtocolGuid;
+
+#endif
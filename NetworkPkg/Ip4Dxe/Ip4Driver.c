@@ -326,6 +326,18 @@ Ip4CreateService (
     goto ON_ERROR;
   }
 
+  //
+  // The offload protocol is optional, IpSb->MnpOffload stays NULL without it.
+  //
+  gBS->OpenProtocol (
+         IpSb->MnpChildHandle,
+         &gEdkiiManagedNetworkOffloadProtocolGuid,
+         (VOID **)&IpSb->MnpOffload,
+         ImageHandle,
+         Controller,
+         EFI_OPEN_PROTOCOL_GET_PROTOCOL
+         );
+
   Status = Ip4ServiceConfigMnp (IpSb, TRUE);
 
   if (EFI_ERROR (Status)) {
@@ -867,6 +879,8 @@ Ip4ServiceBindingCreateChild (
                   ChildHandle,
                   &gEfiIp4ProtocolGuid,
                   &IpInstance->Ip4Proto,
+                  &gEdkiiIp4OffloadProtocolGuid,
+                  &IpInstance->Ip4Offload,
                   NULL
                   );
 
@@ -892,6 +906,8 @@ Ip4ServiceBindingCreateChild (
            *ChildHandle,
            &gEfiIp4ProtocolGuid,
            &IpInstance->Ip4Proto,
+           &gEdkiiIp4OffloadProtocolGuid,
+           &IpInstance->Ip4Offload,
            NULL
            );
 
@@ -1027,10 +1043,13 @@ Ip4ServiceBindingDestroyChild (
   // that means there is a resource leak.
   //
   gBS->RestoreTPL (OldTpl);
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   ChildHandle,
                   &gEfiIp4ProtocolGuid,
-                  &IpInstance->Ip4Proto
+                  &IpInstance->Ip4Proto,
+                  &gEdkiiIp4OffloadProtocolGuid,
+                  &IpInstance->Ip4Offload,
+                  NULL
                   );
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
   if (EFI_ERROR (Status)) {
@@ -1044,6 +1063,8 @@ Ip4ServiceBindingDestroyChild (
            &ChildHandle,
            &gEfiIp4ProtocolGuid,
            Ip4,
+           &gEdkiiIp4OffloadProtocolGuid,
+           &IpInstance->Ip4Offload,
            NULL
            );
 
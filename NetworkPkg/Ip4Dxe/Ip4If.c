@@ -174,6 +174,12 @@ Ip4WrapLinkTxToken (
   CopyMem (&Token->DstMac, &mZeroMacAddress, sizeof (Token->DstMac));
   CopyMem (&Token->SrcMac, &Interface->Mac, sizeof (Token->SrcMac));
 
+  if (IpInstance != NULL) {
+    CopyMem (&Token->TxInfo, &IpInstance->TxOffload, sizeof (Token->TxInfo));
+  } else {
+    ZeroMem (&Token->TxInfo, sizeof (Token->TxInfo));
+  }
+
   MnpToken         = &(Token->MnpToken);
   MnpToken->Status = EFI_NOT_READY;
 
@@ -780,6 +786,31 @@ Ip4FreeInterface (
   return EFI_SUCCESS;
 }
 
+/**
+  Hand a link layer transmit token to MNP, with the offload requested for it.
+
+  @param[in]  Token             The token to transmit.
+
+  @retval EFI_SUCCESS           The token is queued by MNP.
+  @retval Others                The status returned by MNP.
+
+**/
+STATIC
+EFI_STATUS
+Ip4TransmitLinkTxToken (
+  IN IP4_LINK_TX_TOKEN  *Token
+  )
+{
+  EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  *MnpOffload;
+
+  MnpOffload = Token->IpSb->MnpOffload;
+  if ((Token->TxInfo.Flags != 0) && (MnpOffload != NULL)) {
+    return MnpOffload->Transmit (MnpOffload, &Token->TxInfo, &Token->MnpToken);
+  }
+
+  return Token->Interface->Mnp->Transmit (Token->Interface->Mnp, &Token->MnpToken);
+}
+
 /**
   This function tries to send all the queued frames in ArpQue to the default gateway if
   the ARP resolve for direct destination address is failed when using /32 subnet mask.
@@ -846,7 +877,22 @@ Ip4SendFrameToDefaultRoute (
     }
 
     RtCacheEntry->NextHop = Gateway;
-    Status                = Ip4SendFrame (Token->Interface, Token->IpInstance, Token->Packet, Gateway, Token->CallBack, Token->Context, Token->IpSb);
+
+    //
+    // The new link token picks its offload from the IP instance, which only
+    // carries it while the packet is being transmitted. Restore it for the
+    // resend.
+    //
+    if (Token->IpInstance != NULL) {
+      CopyMem (&Token->IpInstance->TxOffload, &Token->TxInfo, sizeof (Token->TxInfo));
+    }
+
+    Status = Ip4SendFrame (Token->Interface, Token->IpInstance, Token->Packet, Gateway, Token->CallBack, Token->Context, Token->IpSb);
+
+    if (Token->IpInstance != NULL) {
+      ZeroMem (&Token->IpInstance->TxOffload, sizeof (Token->IpInstance->TxOffload));
+    }
+
     if (EFI_ERROR (Status)) {
       Status = EFI_NO_MAPPING;
       goto ON_ERROR;
@@ -939,7 +985,7 @@ Ip4OnArpResolvedDpc (
     //
     InsertTailList (&Interface->SentFrames, &Token->Link);
 
-    Status = Interface->Mnp->Transmit (Interface->Mnp, &Token->MnpToken);
+    Status = Ip4TransmitLinkTxToken (Token);
     if (EFI_ERROR (Status)) {
       RemoveEntryList (&Token->Link);
       Token->CallBack (Token->IpInstance, Token->Packet, Status, 0, Token->Context);
@@ -1161,7 +1207,7 @@ SEND_NOW:
   // Remove it if the returned status is not EFI_SUCCESS.
   //
   InsertTailList (&Interface->SentFrames, &Token->Link);
-  Status = Interface->Mnp->Transmit (Interface->Mnp, &Token->MnpToken);
+  Status = Ip4TransmitLinkTxToken (Token);
   if (EFI_ERROR (Status)) {
     RemoveEntryList (&Token->Link);
     goto ON_ERROR;
@@ -83,6 +83,8 @@ typedef struct {
   EFI_MAC_ADDRESS                         DstMac;
   EFI_MAC_ADDRESS                         SrcMac;
 
+  EDKII_NETWORK_OFFLOAD_TX_INFO           TxInfo;     ///< Offload requested by IpInstance, if any.
+
   EFI_MANAGED_NETWORK_COMPLETION_TOKEN    MnpToken;
   EFI_MANAGED_NETWORK_TRANSMIT_DATA       MnpTxData;
 } IP4_LINK_TX_TOKEN;
@@ -340,6 +340,53 @@ EFI_IP4_PROTOCOL
   EfiIp4Poll
 };
 
+/**
+  Return the offloads performed by the network device below this IP4 child.
+
+  @param[in]   This              Pointer to the EDKII_IP4_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware.
+  @param[out]  MaxLargeSendSize  Largest IPv4 packet accepted with EDKII_NETWORK_OFFLOAD_TSO4.
+                                 Zero if TSO isn't supported.
+
+  @retval EFI_SUCCESS            The capabilities are returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+Ip4OffloadGetCapabilities (
+  IN  VOID    *This,
+  OUT UINT32  *Capabilities,
+  OUT UINT32  *MaxLargeSendSize
+  );
+
+/**
+  Places an outgoing data packet into the transmit queue with offload.
+
+  @param[in]  This               Pointer to the EDKII_IP4_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo             The offload requested for this packet.
+  @param[in]  Token              Pointer to the transmit token.
+
+  @retval  EFI_SUCCESS           The data has been queued for transmission.
+  @retval  EFI_INVALID_PARAMETER One or more parameters are NULL, or an unknown
+                                 offload is requested.
+  @retval  Others                As EfiIp4Transmit().
+
+**/
+EFI_STATUS
+EFIAPI
+Ip4OffloadTransmit (
+  IN EDKII_IP4_OFFLOAD_PROTOCOL     *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo,
+  IN EFI_IP4_COMPLETION_TOKEN       *Token
+  );
+
+EDKII_IP4_OFFLOAD_PROTOCOL
+  mIp4OffloadProtocolTemplate = {
+  Ip4OffloadGetCapabilities,
+  Ip4OffloadTransmit
+};
+
 /**
   Gets the current operational settings for this instance of the EFI IPv4 Protocol driver.
 
@@ -540,6 +587,7 @@ Ip4InitProtocol (
 
   IpInstance->Signature = IP4_PROTOCOL_SIGNATURE;
   CopyMem (&IpInstance->Ip4Proto, &mEfiIp4ProtocolTemplete, sizeof (IpInstance->Ip4Proto));
+  CopyMem (&IpInstance->Ip4Offload, &mIp4OffloadProtocolTemplate, sizeof (IpInstance->Ip4Offload));
   IpInstance->State     = IP4_STATE_UNCONFIGED;
   IpInstance->InDestroy = FALSE;
   IpInstance->Service   = IpSb;
@@ -1710,7 +1758,9 @@ EfiIp4Transmit (
   //
   // If don't fragment and fragment needed, return error
   //
-  if (DontFragment && (TxData->TotalDataLength + HeadLen > IpSb->MaxPacketSize)) {
+  if (DontFragment && (TxData->TotalDataLength + HeadLen > IpSb->MaxPacketSize) &&
+      ((IpInstance->TxOffload.Flags & EDKII_NETWORK_OFFLOAD_TSO4) == 0))
+  {
     Status = EFI_BAD_BUFFER_SIZE;
     goto ON_EXIT;
   }
@@ -2309,3 +2359,101 @@ Ip4TimerReconfigChecking (
     }
   }
 }
+
+/**
+  Return the offloads performed by the network device below this IP4 child.
+
+  @param[in]   This              Pointer to the EDKII_IP4_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware.
+  @param[out]  MaxLargeSendSize  Largest IPv4 packet accepted with EDKII_NETWORK_OFFLOAD_TSO4.
+                                 Zero if TSO isn't supported.
+
+  @retval EFI_SUCCESS            The capabilities are returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+Ip4OffloadGetCapabilities (
+  IN  VOID    *This,
+  OUT UINT32  *Capabilities,
+  OUT UINT32  *MaxLargeSendSize
+  )
+{
+  IP4_PROTOCOL                            *IpInstance;
+  EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  *MnpOffload;
+
+  if ((This == NULL) || (Capabilities == NULL) || (MaxLargeSendSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  IpInstance = IP4_INSTANCE_FROM_OFFLOAD ((EDKII_IP4_OFFLOAD_PROTOCOL *)This);
+  MnpOffload = IpInstance->Service->MnpOffload;
+
+  //
+  // IPsec processes the packets before the link layer, it needs the
+  // checksums in place.
+  //
+  if ((MnpOffload == NULL) || mIpSec2Installed) {
+    *Capabilities     = 0;
+    *MaxLargeSendSize = 0;
+    return EFI_SUCCESS;
+  }
+
+  return MnpOffload->GetCapabilities (MnpOffload, Capabilities, MaxLargeSendSize);
+}
+
+/**
+  Places an outgoing data packet into the transmit queue with offload.
+
+  Same as EfiIp4Transmit(), except that the offloads requested in TxInfo are
+  passed down to MNP with every frame of the packet. With
+  EDKII_NETWORK_OFFLOAD_TSO4, the packet isn't fragmented even if it is larger
+  than the MTU.
+
+  @param[in]  This               Pointer to the EDKII_IP4_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo             The offload requested for this packet.
+  @param[in]  Token              Pointer to the transmit token.
+
+  @retval  EFI_SUCCESS           The data has been queued for transmission.
+  @retval  EFI_INVALID_PARAMETER One or more parameters are NULL, or an unknown
+                                 offload is requested.
+  @retval  Others                As EfiIp4Transmit().
+
+**/
+EFI_STATUS
+EFIAPI
+Ip4OffloadTransmit (
+  IN EDKII_IP4_OFFLOAD_PROTOCOL     *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo,
+  IN EFI_IP4_COMPLETION_TOKEN       *Token
+  )
+{
+  IP4_PROTOCOL  *IpInstance;
+  EFI_STATUS    Status;
+  EFI_TPL       OldTpl;
+
+  if ((This == NULL) || (TxInfo == NULL) ||
+      ((TxInfo->Flags & ~EDKII_NETWORK_OFFLOAD_TX_MASK) != 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  IpInstance = IP4_INSTANCE_FROM_OFFLOAD (This);
+
+  //
+  // The offload is picked up by the link layer tokens built while the
+  // packet is transmitted, within EfiIp4Transmit().
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  CopyMem (&IpInstance->TxOffload, TxInfo, sizeof (IpInstance->TxOffload));
+  IpInstance->TxOffload.HeaderOffset = 0;
+
+  Status = EfiIp4Transmit (&IpInstance->Ip4Proto, Token);
+
+  ZeroMem (&IpInstance->TxOffload, sizeof (IpInstance->TxOffload));
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
@@ -323,6 +323,14 @@ Ip4Output (
   //
   Mtu = IpSb->MaxPacketSize + sizeof (IP4_HEAD);
 
+  //
+  // A TCP segment sent with segmentation offload is split by the link
+  // layer, it must not be fragmented.
+  //
+  if ((IpInstance != NULL) && ((IpInstance->TxOffload.Flags & EDKII_NETWORK_OFFLOAD_TSO4) != 0)) {
+    Mtu = IP4_MAX_PACKET_SIZE;
+  }
+
   if (Packet->TotalSize + HeadLen > Mtu) {
     //
     // Fragmentation is disabled for RawData mode.
@@ -17,6 +17,10 @@
 #include <Library/PrintLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+#define HTTP_IO_HTTPS_SCHEME        "https://"
+#define HTTP_IO_HTTP_DEFAULT_PORT   80
+#define HTTP_IO_HTTPS_DEFAULT_PORT  443
+
 /**
   Notify the callback function when an event is triggered.
 
@@ -52,6 +56,65 @@ HttpIoNotify (
   QueueDpc (TPL_CALLBACK, HttpIoNotifyDpc, Context);
 }
 
+/**
+  Release the tokens of the last HttpIoSendPipelinedRequests() call.
+
+  @param[in]  HttpIo          The HTTP_IO.
+
+**/
+STATIC
+VOID
+HttpIoFreePipeline (
+  IN HTTP_IO  *HttpIo
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < HttpIo->PipelineCount; Index++) {
+    gBS->CloseEvent (HttpIo->PipelineTokens[Index].Event);
+  }
+
+  if (HttpIo->PipelineTokens != NULL) {
+    FreePool (HttpIo->PipelineTokens);
+    HttpIo->PipelineTokens = NULL;
+  }
+
+  if (HttpIo->PipelineTxDone != NULL) {
+    FreePool (HttpIo->PipelineTxDone);
+    HttpIo->PipelineTxDone = NULL;
+  }
+
+  HttpIo->PipelineCount = 0;
+}
+
+/**
+  Cancel the tokens of the last HttpIoSendPipelinedRequests() call that the
+  HTTP driver still holds, then release them.
+
+  @param[in]  HttpIo          The HTTP_IO.
+
+**/
+STATIC
+VOID
+HttpIoCancelPipeline (
+  IN HTTP_IO  *HttpIo
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < HttpIo->PipelineCount; Index++) {
+    HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->PipelineTokens[Index]);
+  }
+
+  //
+  // Run the DPCs queued by the cancelled tokens before their TxDone flags
+  // are freed.
+  //
+  DispatchDpc ();
+
+  HttpIoFreePipeline (HttpIo);
+}
+
 /**
   Destroy the HTTP_IO and release the resources.
 
@@ -85,6 +148,8 @@ HttpIoDestroyIo (
     gBS->CloseEvent (Event);
   }
 
+  HttpIoFreePipeline (HttpIo);
+
   Http = HttpIo->Http;
   if (Http != NULL) {
     Http->Configure (Http, NULL);
@@ -464,6 +529,344 @@ HttpIoRecvResponse (
   return Status;
 }
 
+/**
+  Send several HTTP REQUEST messages to the server back to back, without
+  waiting for the responses in between (HTTP/1.1 pipelining).
+
+  The responses are received in the order of Messages, by calling
+  HttpIoRecvResponse() once per request. Messages and the data they point to
+  must stay valid until then, and all the responses must be received before
+  HttpIoSendPipelinedRequests() is called again on the same HttpIo.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[in]   RequestCount     Number of messages in Messages.
+  @param[in]   Messages         Array of the request messages to send.
+
+  @retval EFI_SUCCESS            All the HTTP requests are transmitted.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+  @retval EFI_DEVICE_ERROR       An unexpected network or system error occurred.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoSendPipelinedRequests (
+  IN  HTTP_IO           *HttpIo,
+  IN  UINTN             RequestCount,
+  IN  EFI_HTTP_MESSAGE  *Messages
+  )
+{
+  EFI_STATUS         Status;
+  EFI_HTTP_PROTOCOL  *Http;
+  EFI_HTTP_TOKEN     *Tokens;
+  BOOLEAN            *TxDone;
+  UINTN              Index;
+
+  if ((HttpIo == NULL) || (HttpIo->Http == NULL) || (RequestCount == 0) || (Messages == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The responses of the previous pipeline have been received, so its
+  // tokens are no longer held by the HTTP driver.
+  //
+  HttpIoFreePipeline (HttpIo);
+
+  Tokens = AllocateZeroPool (RequestCount * sizeof (EFI_HTTP_TOKEN));
+  TxDone = AllocateZeroPool (RequestCount * sizeof (BOOLEAN));
+  if ((Tokens == NULL) || (TxDone == NULL)) {
+    if (Tokens != NULL) {
+      FreePool (Tokens);
+    }
+
+    if (TxDone != NULL) {
+      FreePool (TxDone);
+    }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HttpIo->PipelineTokens = Tokens;
+  HttpIo->PipelineTxDone = TxDone;
+
+  //
+  // Queue all the request tokens to the HTTP instance. The HTTP driver sends
+  // each of them once the previous one is transmitted.
+  //
+  Http = HttpIo->Http;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    HttpIoNotify,
+                    &TxDone[Index],
+                    &Tokens[Index].Event
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    HttpIo->PipelineCount = Index + 1;
+    Tokens[Index].Status  = EFI_NOT_READY;
+    Tokens[Index].Message = &Messages[Index];
+
+    if (HttpIo->Callback != NULL) {
+      Status = HttpIo->Callback (
+                         HttpIoRequest,
+                         Tokens[Index].Message,
+                         HttpIo->Context
+                         );
+      if (EFI_ERROR (Status)) {
+        goto ON_ERROR;
+      }
+    }
+
+    Status = Http->Request (Http, &Tokens[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  //
+  // Poll the network until all the requests are transmitted.
+  //
+  for (Index = 0; Index < RequestCount; Index++) {
+    while (!TxDone[Index]) {
+      Http->Poll (Http);
+    }
+
+    if (EFI_ERROR (Tokens[Index].Status)) {
+      Status = Tokens[Index].Status;
+      goto ON_ERROR;
+    }
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  //
+  // The HTTP driver may hold some of the tokens already, don't leave them
+  // there to be freed by the next call.
+  //
+  HttpIoCancelPipeline (HttpIo);
+  return Status;
+}
+
+/**
+  Check whether the URL uses the https scheme.
+
+  @param[in]  Url           The URL.
+
+  @retval TRUE              The URL is an https URL.
+  @retval FALSE             The URL is not an https URL.
+
+**/
+STATIC
+BOOLEAN
+HttpIoIsHttpsUrl (
+  IN CHAR8  *Url
+  )
+{
+  CONST CHAR8  *Scheme;
+
+  for (Scheme = HTTP_IO_HTTPS_SCHEME; *Scheme != '\0'; Scheme++, Url++) {
+    if (AsciiCharToUpper (*Url) != AsciiCharToUpper (*Scheme)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Initialize a pool of persistent HTTP connections. The HTTP children are
+  created on demand by HttpIoPoolGetIo().
+
+  @param[in]  Image          The handle of the driver image.
+  @param[in]  Controller     The handle of the controller.
+  @param[in]  IpVersion      IP_VERSION_4 or IP_VERSION_6.
+  @param[in]  ConfigData     The HTTP_IO configuration data of every connection.
+  @param[in]  Callback       Callback function which will be invoked when specified
+                             HTTP_IO_CALLBACK_EVENT happened.
+  @param[in]  Context        The Context data which will be passed to the Callback function.
+  @param[out] Pool           The HTTP_IO_POOL.
+
+  @retval EFI_SUCCESS            The pool is initialized.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_UNSUPPORTED        IpVersion is not supported.
+
+**/
+EFI_STATUS
+HttpIoPoolInit (
+  IN EFI_HANDLE           Image,
+  IN EFI_HANDLE           Controller,
+  IN UINT8                IpVersion,
+  IN HTTP_IO_CONFIG_DATA  *ConfigData,
+  IN HTTP_IO_CALLBACK     Callback,
+  IN VOID                 *Context,
+  OUT HTTP_IO_POOL        *Pool
+  )
+{
+  if ((Image == NULL) || (Controller == NULL) || (ConfigData == NULL) || (Pool == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((IpVersion != IP_VERSION_4) && (IpVersion != IP_VERSION_6)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (Pool, sizeof (HTTP_IO_POOL));
+  Pool->Image      = Image;
+  Pool->Controller = Controller;
+  Pool->IpVersion  = IpVersion;
+  Pool->Callback   = Callback;
+  Pool->Context    = Context;
+  CopyMem (&Pool->ConfigData, ConfigData, sizeof (HTTP_IO_CONFIG_DATA));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the HTTP_IO to send a request for Url with.
+
+  The connection last used for the same scheme, host and port is returned, so
+  that its TCP and TLS sessions are reused. Otherwise a new connection is
+  created, or the least recently used one is handed over if the pool is full.
+
+  @param[in]   Pool             The HTTP_IO_POOL.
+  @param[in]   Url              The URL of the request.
+  @param[out]  HttpIo           The HTTP_IO to use for the request.
+
+  @retval EFI_SUCCESS            The HTTP_IO is returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate memory.
+  @retval Others                 Failed to create the HTTP_IO.
+
+**/
+EFI_STATUS
+HttpIoPoolGetIo (
+  IN  HTTP_IO_POOL  *Pool,
+  IN  CHAR8         *Url,
+  OUT HTTP_IO       **HttpIo
+  )
+{
+  EFI_STATUS               Status;
+  VOID                     *UrlParser;
+  CHAR8                    *HostName;
+  UINT16                   Port;
+  BOOLEAN                  UseHttps;
+  HTTP_IO_POOL_CONNECTION  *Connection;
+  UINTN                    Index;
+
+  if ((Pool == NULL) || (Url == NULL) || (HttpIo == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Key the connection by the scheme, host and port of the URL.
+  //
+  Status = HttpParseUrl (Url, (UINT32)AsciiStrLen (Url), FALSE, &UrlParser);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UseHttps = HttpIoIsHttpsUrl (Url);
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (Url, UrlParser, &HostName);
+  if (!EFI_ERROR (Status)) {
+    if (EFI_ERROR (HttpUrlGetPort (Url, UrlParser, &Port))) {
+      Port = UseHttps ? HTTP_IO_HTTPS_DEFAULT_PORT : HTTP_IO_HTTP_DEFAULT_PORT;
+    }
+  }
+
+  HttpUrlFreeParser (UrlParser);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Connection = NULL;
+  for (Index = 0; Index < Pool->ConnectionCount; Index++) {
+    if ((Pool->Connections[Index].UseHttps == UseHttps) &&
+        (Pool->Connections[Index].Port == Port) &&
+        (AsciiStrCmp (Pool->Connections[Index].HostName, HostName) == 0))
+    {
+      Connection = &Pool->Connections[Index];
+      break;
+    }
+  }
+
+  if (Connection != NULL) {
+    FreePool (HostName);
+  } else {
+    if (Pool->ConnectionCount < HTTP_IO_POOL_MAX_CONNECTIONS) {
+      Connection = &Pool->Connections[Pool->ConnectionCount];
+      Status     = HttpIoCreateIo (
+                     Pool->Image,
+                     Pool->Controller,
+                     Pool->IpVersion,
+                     &Pool->ConfigData,
+                     Pool->Callback,
+                     Pool->Context,
+                     &Connection->HttpIo
+                     );
+      if (EFI_ERROR (Status)) {
+        FreePool (HostName);
+        return Status;
+      }
+
+      Pool->ConnectionCount++;
+    } else {
+      //
+      // Hand the least recently used connection over to the new host, the
+      // HTTP driver closes its current connection on the next request.
+      //
+      Connection = &Pool->Connections[0];
+      for (Index = 1; Index < Pool->ConnectionCount; Index++) {
+        if (Pool->Connections[Index].LastUsed < Connection->LastUsed) {
+          Connection = &Pool->Connections[Index];
+        }
+      }
+
+      FreePool (Connection->HostName);
+    }
+
+    Connection->HostName = HostName;
+    Connection->Port     = Port;
+    Connection->UseHttps = UseHttps;
+  }
+
+  Connection->LastUsed = ++Pool->UseCount;
+  *HttpIo              = &Connection->HttpIo;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Destroy all the connections of the pool.
+
+  @param[in]  Pool          The HTTP_IO_POOL.
+
+**/
+VOID
+HttpIoPoolDestroy (
+  IN HTTP_IO_POOL  *Pool
+  )
+{
+  UINTN  Index;
+
+  if (Pool == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < Pool->ConnectionCount; Index++) {
+    HttpIoDestroyIo (&Pool->Connections[Index].HttpIo);
+    FreePool (Pool->Connections[Index].HostName);
+  }
+
+  ZeroMem (Pool->Connections, sizeof (Pool->Connections));
+  Pool->ConnectionCount = 0;
+}
+
 /**
   Get the value of the content length if there is a "Content-Length" header.
 
@@ -0,0 +1,742 @@
+/** @file
+  Unit tests for the request pipelining of DxeHttpIoLib.
+
+  The HTTP service is a mock that, like HttpDxe, transmits one queued request
+  per Poll() and answers the requests in order. Each response body is the URL
+  of its request.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+
+#include <Protocol/Http.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DpcLib.h>
+#include <Library/HttpIoLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "DxeHttpIoLib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_PIPELINE_DEPTH     2
+#define TEST_BODY_SIZE          64
+#define TEST_TIMEOUT_CHECKS     1000
+#define MOCK_HTTP_MAX_REQUESTS  8
+
+///
+/// Event of the test boot services. The notify function is run when the
+/// event is signaled.
+///
+typedef struct {
+  EFI_EVENT_NOTIFY    NotifyFunction;
+  VOID                *NotifyContext;
+  UINTN               Checks;
+} TEST_EVENT;
+
+///
+/// Mock HTTP instance.
+///
+typedef struct {
+  EFI_HTTP_PROTOCOL    Http;
+  EFI_HTTP_TOKEN       *Requests[MOCK_HTTP_MAX_REQUESTS];
+  UINTN                RequestCount;
+  UINTN                SentCount;
+  UINTN                ResponseCount;
+  EFI_HTTP_TOKEN       *ResponseToken;
+  UINTN                FailRequest;
+} MOCK_HTTP;
+
+STATIC CHAR16  *mTestUrl[TEST_PIPELINE_DEPTH] = {
+  L"http://192.168.0.1/boot/bootx64.efi",
+  L"http://192.168.0.1/boot/grub.cfg"
+};
+
+STATIC EFI_BOOT_SERVICES  *mSavedBootServices;
+STATIC EFI_BOOT_SERVICES  mTestBootServices;
+STATIC UINTN              mTestEventCount;
+STATIC MOCK_HTTP          mMockHttp;
+STATIC HTTP_IO            mTestHttpIo;
+
+/**
+  Create an event of the test boot services.
+
+  @param[in]   Type             The type of event to create and its mode and attributes.
+  @param[in]   NotifyTpl        The task priority level of event notifications, unused.
+  @param[in]   NotifyFunction   The pointer to the event's notification function, if any.
+  @param[in]   NotifyContext    The pointer to the notification function's context.
+  @param[out]  Event            The pointer to the newly created event.
+
+  @retval EFI_SUCCESS           The event was created.
+  @retval EFI_OUT_OF_RESOURCES  The event could not be allocated.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction  OPTIONAL,
+  IN  VOID              *NotifyContext  OPTIONAL,
+  OUT EFI_EVENT         *Event
+  )
+{
+  TEST_EVENT  *TestEvent;
+
+  TestEvent = AllocateZeroPool (sizeof (TEST_EVENT));
+  if (TestEvent == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  TestEvent->NotifyFunction = NotifyFunction;
+  TestEvent->NotifyContext  = NotifyContext;
+  mTestEventCount++;
+
+  *Event = TestEvent;
+  return EFI_SUCCESS;
+}
+
+/**
+  Signal an event of the test boot services, its notify function is run
+  right away.
+
+  @param[in]  Event   The event to signal.
+
+  @retval EFI_SUCCESS  The event was signaled.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  TEST_EVENT  *TestEvent;
+
+  TestEvent = (TEST_EVENT *)Event;
+  if (TestEvent->NotifyFunction != NULL) {
+    TestEvent->NotifyFunction (Event, TestEvent->NotifyContext);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Close an event of the test boot services.
+
+  @param[in]  Event   The event to close.
+
+  @retval EFI_SUCCESS  The event was closed.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  FreePool (Event);
+  mTestEventCount--;
+  return EFI_SUCCESS;
+}
+
+/**
+  Set or cancel the timer of an event of the test boot services.
+
+  @param[in]  Event         The timer event.
+  @param[in]  Type          The type of time, unused.
+  @param[in]  TriggerTime   The number of 100ns units until the timer expires, unused.
+
+  @retval EFI_SUCCESS  The timer was set.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestSetTimer (
+  IN EFI_EVENT        Event,
+  IN EFI_TIMER_DELAY  Type,
+  IN UINT64           TriggerTime
+  )
+{
+  ((TEST_EVENT *)Event)->Checks = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check a timer event of the test boot services. The timer expires after
+  TEST_TIMEOUT_CHECKS checks, so that a lost response fails the test instead
+  of hanging it.
+
+  @param[in]  Event   The timer event.
+
+  @retval EFI_SUCCESS    The timer has expired.
+  @retval EFI_NOT_READY  The timer hasn't expired.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestCheckEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  TEST_EVENT  *TestEvent;
+
+  TestEvent = (TEST_EVENT *)Event;
+  TestEvent->Checks++;
+  return (TestEvent->Checks > TEST_TIMEOUT_CHECKS) ? EFI_SUCCESS : EFI_NOT_READY;
+}
+
+/**
+  Set the BOOLEAN the event's context points to, like HttpIoNotify() does
+  once its DPC is dispatched.
+
+  @param[in]  Event     The event signaled.
+  @param[in]  Context   Pointer to the BOOLEAN to set.
+
+**/
+STATIC
+VOID
+EFIAPI
+TestNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  *((BOOLEAN *)Context) = TRUE;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.GetModeData().
+
+  @param[in]   This             Pointer to the mock HTTP instance.
+  @param[out]  HttpConfigData   Unused.
+
+  @retval EFI_UNSUPPORTED  Always.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpGetModeData (
+  IN  EFI_HTTP_PROTOCOL     *This,
+  OUT EFI_HTTP_CONFIG_DATA  *HttpConfigData
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.Configure().
+
+  @param[in]  This             Pointer to the mock HTTP instance.
+  @param[in]  HttpConfigData   Unused.
+
+  @retval EFI_SUCCESS  Always.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpConfigure (
+  IN EFI_HTTP_PROTOCOL     *This,
+  IN EFI_HTTP_CONFIG_DATA  *HttpConfigData OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.Request(). The token is queued, and transmitted
+  by a later Poll().
+
+  @param[in]  This    Pointer to the mock HTTP instance.
+  @param[in]  Token   The request token.
+
+  @retval EFI_SUCCESS           The request is queued.
+  @retval EFI_DEVICE_ERROR      The test asked this request to fail.
+  @retval EFI_OUT_OF_RESOURCES  Too many requests.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpRequest (
+  IN EFI_HTTP_PROTOCOL  *This,
+  IN EFI_HTTP_TOKEN     *Token
+  )
+{
+  MOCK_HTTP  *Mock;
+
+  Mock = (MOCK_HTTP *)This;
+  if (Mock->RequestCount == Mock->FailRequest) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Mock->RequestCount == MOCK_HTTP_MAX_REQUESTS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Mock->Requests[Mock->RequestCount++] = Token;
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.Cancel(). A request token is dropped from the
+  queue until its response is received, like HttpDxe does; a token not
+  transmitted yet is signaled with EFI_ABORTED.
+
+  @param[in]  This    Pointer to the mock HTTP instance.
+  @param[in]  Token   The token to cancel.
+
+  @retval EFI_SUCCESS    The token is cancelled.
+  @retval EFI_NOT_FOUND  The token isn't queued.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpCancel (
+  IN EFI_HTTP_PROTOCOL  *This,
+  IN EFI_HTTP_TOKEN     *Token
+  )
+{
+  MOCK_HTTP  *Mock;
+  UINTN      Index;
+
+  Mock = (MOCK_HTTP *)This;
+  if ((Token != NULL) && (Token == Mock->ResponseToken)) {
+    Mock->ResponseToken = NULL;
+    Token->Status       = EFI_ABORTED;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  for (Index = Mock->ResponseCount; Index < Mock->RequestCount; Index++) {
+    if ((Mock->Requests[Index] != NULL) && (Mock->Requests[Index] == Token)) {
+      Mock->Requests[Index] = NULL;
+      if (Index >= Mock->SentCount) {
+        Token->Status = EFI_ABORTED;
+        gBS->SignalEvent (Token->Event);
+      }
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.Response(). The token is completed by a later
+  Poll() once the request it answers is transmitted.
+
+  @param[in]  This    Pointer to the mock HTTP instance.
+  @param[in]  Token   The response token.
+
+  @retval EFI_SUCCESS         The response token is queued.
+  @retval EFI_ACCESS_DENIED   A response token is queued already.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpResponse (
+  IN EFI_HTTP_PROTOCOL  *This,
+  IN EFI_HTTP_TOKEN     *Token
+  )
+{
+  MOCK_HTTP  *Mock;
+
+  Mock = (MOCK_HTTP *)This;
+  if (Mock->ResponseToken != NULL) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Mock->ResponseToken = Token;
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock of EFI_HTTP_PROTOCOL.Poll(). Transmit the next queued request, answer
+  the oldest transmitted one if a response token is queued, then dispatch
+  the DPCs like the network stack does.
+
+  @param[in]  This    Pointer to the mock HTTP instance.
+
+  @retval EFI_SUCCESS  Always.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHttpPoll (
+  IN EFI_HTTP_PROTOCOL  *This
+  )
+{
+  MOCK_HTTP       *Mock;
+  EFI_HTTP_TOKEN  *Request;
+  EFI_HTTP_TOKEN  *Response;
+
+  Mock = (MOCK_HTTP *)This;
+
+  if (Mock->SentCount < Mock->RequestCount) {
+    Request = Mock->Requests[Mock->SentCount++];
+    if (Request != NULL) {
+      Request->Status = EFI_SUCCESS;
+      gBS->SignalEvent (Request->Event);
+    }
+  }
+
+  Response = Mock->ResponseToken;
+  if ((Response != NULL) && (Mock->ResponseCount < Mock->SentCount) &&
+      (Mock->Requests[Mock->ResponseCount] != NULL))
+  {
+    Request                             = Mock->Requests[Mock->ResponseCount];
+    Mock->Requests[Mock->ResponseCount] = NULL;
+    Mock->ResponseToken                 = NULL;
+    Mock->ResponseCount++;
+
+    if (Response->Message->Data.Response != NULL) {
+      Response->Message->Data.Response->StatusCode = HTTP_STATUS_200_OK;
+    }
+
+    UnicodeStrToAsciiStrS (
+      Request->Message->Data.Request->Url,
+      Response->Message->Body,
+      Response->Message->BodyLength
+      );
+    Response->Message->BodyLength = AsciiStrLen (Response->Message->Body);
+
+    Response->Status = EFI_SUCCESS;
+    gBS->SignalEvent (Response->Event);
+  }
+
+  DispatchDpc ();
+  return EFI_SUCCESS;
+}
+
+/**
+  Count the request tokens the mock HTTP instance still holds.
+
+  @return The number of request tokens.
+
+**/
+STATIC
+UINTN
+MockHttpHeldRequests (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Count;
+
+  Count = 0;
+  for (Index = 0; Index < mMockHttp.RequestCount; Index++) {
+    if (mMockHttp.Requests[Index] != NULL) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Install the test events in gBS and set up a HTTP_IO on the mock HTTP
+  instance, the way HttpIoCreateIo() does on a HTTP child.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED                      The HTTP_IO is set up.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The events couldn't be created.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupHttpIo (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  mSavedBootServices = gBS;
+  CopyMem (&mTestBootServices, gBS, sizeof (EFI_BOOT_SERVICES));
+  mTestBootServices.CreateEvent = TestCreateEvent;
+  mTestBootServices.SignalEvent = TestSignalEvent;
+  mTestBootServices.CloseEvent  = TestCloseEvent;
+  mTestBootServices.SetTimer    = TestSetTimer;
+  mTestBootServices.CheckEvent  = TestCheckEvent;
+  gBS                           = &mTestBootServices;
+  mTestEventCount               = 0;
+
+  ZeroMem (&mMockHttp, sizeof (mMockHttp));
+  mMockHttp.Http.GetModeData = MockHttpGetModeData;
+  mMockHttp.Http.Configure   = MockHttpConfigure;
+  mMockHttp.Http.Request     = MockHttpRequest;
+  mMockHttp.Http.Cancel      = MockHttpCancel;
+  mMockHttp.Http.Response    = MockHttpResponse;
+  mMockHttp.Http.Poll        = MockHttpPoll;
+  mMockHttp.FailRequest      = MAX_UINTN;
+
+  ZeroMem (&mTestHttpIo, sizeof (mTestHttpIo));
+  mTestHttpIo.IpVersion        = IP_VERSION_4;
+  mTestHttpIo.Http             = &mMockHttp.Http;
+  mTestHttpIo.Timeout          = PcdGet32 (PcdHttpIoTimeout);
+  mTestHttpIo.RspToken.Message = &mTestHttpIo.RspMessage;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  TestNotify,
+                  &mTestHttpIo.IsRxDone,
+                  &mTestHttpIo.RspToken.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER,
+                  TPL_CALLBACK,
+                  NULL,
+                  NULL,
+                  &mTestHttpIo.TimeoutEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Destroy the HTTP_IO and restore gBS.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+DestroyHttpIo (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HttpIoDestroyIo (&mTestHttpIo);
+  gBS = mSavedBootServices;
+}
+
+/**
+  Fill in the GET request messages of the test URLs.
+
+  @param[out]  Requests   The request data of each message.
+  @param[out]  Messages   The request messages.
+
+**/
+STATIC
+VOID
+TestBuildRequests (
+  OUT EFI_HTTP_REQUEST_DATA  *Requests,
+  OUT EFI_HTTP_MESSAGE       *Messages
+  )
+{
+  UINTN  Index;
+
+  ZeroMem (Messages, TEST_PIPELINE_DEPTH * sizeof (EFI_HTTP_MESSAGE));
+  for (Index = 0; Index < TEST_PIPELINE_DEPTH; Index++) {
+    Requests[Index].Method       = HttpMethodGet;
+    Requests[Index].Url          = mTestUrl[Index];
+    Messages[Index].Data.Request = &Requests[Index];
+  }
+}
+
+/**
+  Two pipelined requests are both transmitted before any response is
+  received, then both responses are received in the order of the requests.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PipelineShouldReceiveEveryResponse (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS             Status;
+  EFI_HTTP_REQUEST_DATA  Requests[TEST_PIPELINE_DEPTH];
+  EFI_HTTP_MESSAGE       Messages[TEST_PIPELINE_DEPTH];
+  HTTP_IO_RESPONSE_DATA  ResponseData;
+  CHAR8                  Body[TEST_BODY_SIZE];
+  CHAR8                  Expected[TEST_BODY_SIZE];
+  UINTN                  Index;
+
+  TestBuildRequests (Requests, Messages);
+
+  Status = HttpIoSendPipelinedRequests (&mTestHttpIo, TEST_PIPELINE_DEPTH, Messages);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mMockHttp.SentCount, TEST_PIPELINE_DEPTH);
+  UT_ASSERT_EQUAL (mMockHttp.ResponseCount, 0);
+
+  for (Index = 0; Index < TEST_PIPELINE_DEPTH; Index++) {
+    ZeroMem (&ResponseData, sizeof (ResponseData));
+    ZeroMem (Body, sizeof (Body));
+    ResponseData.Body       = Body;
+    ResponseData.BodyLength = sizeof (Body);
+
+    Status = HttpIoRecvResponse (&mTestHttpIo, TRUE, &ResponseData);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_NOT_EFI_ERROR (ResponseData.Status);
+    UT_ASSERT_EQUAL (ResponseData.Response.StatusCode, HTTP_STATUS_200_OK);
+
+    UnicodeStrToAsciiStrS (mTestUrl[Index], Expected, sizeof (Expected));
+    UT_ASSERT_EQUAL (ResponseData.BodyLength, AsciiStrLen (Expected));
+    UT_ASSERT_MEM_EQUAL (Body, Expected, ResponseData.BodyLength);
+  }
+
+  UT_ASSERT_EQUAL (MockHttpHeldRequests (), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When a request of the pipeline fails, the tokens already queued are
+  cancelled before they are freed, so the HTTP driver holds none of them.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FailedPipelineShouldCancelTokens (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS             Status;
+  EFI_HTTP_REQUEST_DATA  Requests[TEST_PIPELINE_DEPTH];
+  EFI_HTTP_MESSAGE       Messages[TEST_PIPELINE_DEPTH];
+  UINTN                  EventCount;
+
+  TestBuildRequests (Requests, Messages);
+  EventCount            = mTestEventCount;
+  mMockHttp.FailRequest = 1;
+
+  Status = HttpIoSendPipelinedRequests (&mTestHttpIo, TEST_PIPELINE_DEPTH, Messages);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_DEVICE_ERROR);
+
+  UT_ASSERT_EQUAL (mMockHttp.RequestCount, 1);
+  UT_ASSERT_EQUAL (MockHttpHeldRequests (), 0);
+  UT_ASSERT_EQUAL (mTestHttpIo.PipelineCount, 0);
+  UT_ASSERT_TRUE (mTestHttpIo.PipelineTokens == NULL);
+  UT_ASSERT_EQUAL (mTestEventCount, EventCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  pipelining of DxeHttpIoLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PipelineTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&PipelineTests, Framework, "HTTP Pipelining Tests", "HttpIoLib.Pipeline", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HTTP Pipelining Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description----------------------------------------Name--------------Function----------------------------Pre----------Post-----------Context
+  //
+  AddTestCase (PipelineTests, "Both pipelined responses are received in order", "Receive", PipelineShouldReceiveEveryResponse, SetupHttpIo, DestroyHttpIo, NULL);
+  AddTestCase (PipelineTests, "A failed request cancels the queued tokens", "Cancel", FailedPipelineShouldCancelTokens, SetupHttpIo, DestroyHttpIo, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define DxeHttpIoLibUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+DxeHttpIoLibUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
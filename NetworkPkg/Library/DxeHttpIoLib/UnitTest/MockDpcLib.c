@@ -0,0 +1,93 @@
+/** @file
+  Host instance of the DPC Library for the NetworkPkg unit tests.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/DpcLib.h>
+
+#define MOCK_DPC_MAX  64
+
+typedef struct {
+  EFI_DPC_PROCEDURE    DpcProcedure;
+  VOID                 *DpcContext;
+} MOCK_DPC_ENTRY;
+
+STATIC MOCK_DPC_ENTRY  mDpcQueue[MOCK_DPC_MAX];
+STATIC UINTN           mDpcCount;
+
+/**
+  Add a Deferred Procedure Call to the end of the DPC queue.
+
+  The host tests run at a single TPL, so DpcTpl is ignored and the DPCs are
+  run in the order they are queued.
+
+  @param[in]  DpcTpl        The EFI_TPL that the DPC should be invoked.
+  @param[in]  DpcProcedure  Pointer to the DPC's function.
+  @param[in]  DpcContext    Pointer to the DPC's context.  Passed to DpcProcedure
+                            when DpcProcedure is invoked.
+
+  @retval EFI_SUCCESS            The DPC was queued.
+  @retval EFI_INVALID_PARAMETER  DpcProcedure is NULL.
+  @retval EFI_OUT_OF_RESOURCES   There are not enough resources available to
+                                 add the DPC to the queue.
+
+**/
+EFI_STATUS
+EFIAPI
+QueueDpc (
+  IN EFI_TPL            DpcTpl,
+  IN EFI_DPC_PROCEDURE  DpcProcedure,
+  IN VOID               *DpcContext    OPTIONAL
+  )
+{
+  if (DpcProcedure == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mDpcCount == MOCK_DPC_MAX) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mDpcQueue[mDpcCount].DpcProcedure = DpcProcedure;
+  mDpcQueue[mDpcCount].DpcContext   = DpcContext;
+  mDpcCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Dispatch the queue of DPCs, including the DPCs the dispatched ones queue.
+
+  @retval EFI_SUCCESS    One or more DPCs were invoked.
+  @retval EFI_NOT_FOUND  No DPCs were invoked.
+
+**/
+EFI_STATUS
+EFIAPI
+DispatchDpc (
+  VOID
+  )
+{
+  MOCK_DPC_ENTRY  Dpc;
+  UINTN           Index;
+  EFI_STATUS      Status;
+
+  Status = EFI_NOT_FOUND;
+  while (mDpcCount != 0) {
+    Dpc = mDpcQueue[0];
+    mDpcCount--;
+    for (Index = 0; Index < mDpcCount; Index++) {
+      mDpcQueue[Index] = mDpcQueue[Index + 1];
+    }
+
+    Dpc.DpcProcedure (Dpc.DpcContext);
+    Status = EFI_SUCCESS;
+  }
+
+  return Status;
+}
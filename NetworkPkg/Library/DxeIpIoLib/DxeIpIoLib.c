@@ -1584,6 +1584,49 @@ IpIoSend (
   IN     EFI_IP_ADDRESS  *Dest          OPTIONAL,
   IN     IP_IO_OVERRIDE  *OverrideData  OPTIONAL
   )
+{
+  return IpIoSendWithOffload (IpIo, Pkt, Sender, Context, NotifyData, Dest, OverrideData, NULL);
+}
+
+/**
+  Send out an IP packet with transmit offload.
+
+  Same as IpIoSend(), except that the offload requested in TxInfo is passed
+  to the IPv4 instance of Sender. The offload is ignored if TxInfo is NULL,
+  if Sender is NULL, or if the IP instance doesn't support offload; query
+  IpIoGetOffloadCapabilities() first.
+
+  @param[in, out]  IpIo                  Pointer to an IP_IO instance used for sending IP
+                                         packet.
+  @param[in, out]  Pkt                   Pointer to the IP packet to be sent.
+  @param[in]       Sender                The IP protocol instance used for sending.
+  @param[in]       Context               Optional context data.
+  @param[in]       NotifyData            Optional notify data.
+  @param[in]       Dest                  The destination IP address to send this packet to.
+                                         This parameter is optional when using IPv6.
+  @param[in]       OverrideData          The data to override some configuration of the IP
+                                         instance used for sending.
+  @param[in]       TxInfo                The offload requested for the packet.
+
+  @retval          EFI_SUCCESS           The operation is completed successfully.
+  @retval          EFI_INVALID_PARAMETER The input parameter is not correct.
+  @retval          EFI_NOT_STARTED       The IpIo is not configured.
+  @retval          EFI_OUT_OF_RESOURCES  Failed due to resource limit.
+  @retval          Others                Error condition occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoSendWithOffload (
+  IN OUT IP_IO                          *IpIo,
+  IN OUT NET_BUF                        *Pkt,
+  IN     IP_IO_IP_INFO                  *Sender        OPTIONAL,
+  IN     VOID                           *Context       OPTIONAL,
+  IN     VOID                           *NotifyData    OPTIONAL,
+  IN     EFI_IP_ADDRESS                 *Dest          OPTIONAL,
+  IN     IP_IO_OVERRIDE                 *OverrideData  OPTIONAL,
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo        OPTIONAL
+  )
 {
   EFI_STATUS         Status;
   IP_IO_IP_PROTOCOL  Ip;
@@ -1614,7 +1657,15 @@ IpIoSend (
   //
   // Send this Packet
   //
-  if (IpIo->IpVersion == IP_VERSION_4) {
+  if ((IpIo->IpVersion == IP_VERSION_4) && (TxInfo != NULL) && (TxInfo->Flags != 0) &&
+      (Sender != NULL) && (Sender->Ip4Offload != NULL))
+  {
+    Status = Sender->Ip4Offload->Transmit (
+                                   Sender->Ip4Offload,
+                                   TxInfo,
+                                   &SndEntry->SndToken.Ip4Token
+                                   );
+  } else if (IpIo->IpVersion == IP_VERSION_4) {
     Status = Ip.Ip4->Transmit (
                        Ip.Ip4,
                        &SndEntry->SndToken.Ip4Token
@@ -1719,6 +1770,7 @@ IpIoAddIp (
   //
   InitializeListHead (&IpInfo->Entry);
   IpInfo->ChildHandle = NULL;
+  IpInfo->Ip4Offload  = NULL;
   ZeroMem (&IpInfo->Addr, sizeof (IpInfo->Addr));
   ZeroMem (&IpInfo->PreMask, sizeof (IpInfo->PreMask));
 
@@ -1739,6 +1791,20 @@ IpIoAddIp (
     goto ReleaseIpInfo;
   }
 
+  if (IpInfo->IpVersion == IP_VERSION_4) {
+    //
+    // The offload protocol is optional, Ip4Offload stays NULL without it.
+    //
+    gBS->OpenProtocol (
+           IpInfo->ChildHandle,
+           &gEdkiiIp4OffloadProtocolGuid,
+           (VOID **)&IpInfo->Ip4Offload,
+           IpIo->Image,
+           IpIo->Controller,
+           EFI_OPEN_PROTOCOL_GET_PROTOCOL
+           );
+  }
+
   //
   // Create the event for the DummyRcvToken.
   //
@@ -1949,6 +2015,39 @@ IpIoConfigIp (
   return Status;
 }
 
+/**
+  Get the transmit offloads performed in hardware below an IP instance.
+
+  @param[in]   IpInfo            Pointer to the IP_IO_IP_INFO instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware,
+                                 zero if the IP instance doesn't support offload.
+  @param[out]  MaxLargeSendSize  Largest IPv4 packet accepted with EDKII_NETWORK_OFFLOAD_TSO4.
+
+  @retval      EFI_SUCCESS           The capabilities are returned.
+  @retval      EFI_INVALID_PARAMETER One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoGetOffloadCapabilities (
+  IN  IP_IO_IP_INFO  *IpInfo,
+  OUT UINT32         *Capabilities,
+  OUT UINT32         *MaxLargeSendSize
+  )
+{
+  if ((IpInfo == NULL) || (Capabilities == NULL) || (MaxLargeSendSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((IpInfo->IpVersion != IP_VERSION_4) || (IpInfo->Ip4Offload == NULL)) {
+    *Capabilities     = 0;
+    *MaxLargeSendSize = 0;
+    return EFI_SUCCESS;
+  }
+
+  return IpInfo->Ip4Offload->GetCapabilities (IpInfo->Ip4Offload, Capabilities, MaxLargeSendSize);
+}
+
 /**
   Destroy an IP instance maintained in IpIo->IpList for
   sending purpose.
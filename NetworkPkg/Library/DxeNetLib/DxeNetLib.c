@@ -3373,3 +3373,24 @@ NetLibCreateDnsQName (
 
   return QueryName;
 }
+
+/**
+  Destructor of the network library. Releases the memory held by the net
+  buffer caches when the image that links this library is unloaded.
+
+  @param[in]  ImageHandle       The image handle of the driver.
+  @param[in]  SystemTable       The system table.
+
+  @retval EFI_SUCCESS           The destructor always returns EFI_SUCCESS.
+
+**/
+EFI_STATUS
+EFIAPI
+NetLibDestructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  NetbufFlushPoolCache ();
+  return EFI_SUCCESS;
+}
@@ -14,6 +14,350 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+//
+// NET_BUF and NET_VECTOR headers, and small single-block data bulks, are
+// recycled through per-size free lists instead of returning to the boot
+// services pool for every packet. Header class N holds objects with room for
+// (1 << N) NET_BLOCK_OPs or NET_BLOCKs. Bulk class N holds data blocks of
+// NET_BUF_CACHE_BULK_CLASS_SIZE (N) bytes.
+//
+#define NET_BUF_CACHE_DEPTH  64
+
+typedef struct _NET_CACHE_ENTRY NET_CACHE_ENTRY;
+
+struct _NET_CACHE_ENTRY {
+  NET_CACHE_ENTRY    *Next;
+};
+
+typedef struct {
+  NET_CACHE_ENTRY              *Head;
+  NET_BUF_CACHE_CLASS_STATS    Stats;
+} NET_CACHE_CLASS;
+
+STATIC NET_CACHE_CLASS  mNetBufCache[NET_BUF_CACHE_CLASS_NUM];
+STATIC NET_CACHE_CLASS  mNetVectorCache[NET_BUF_CACHE_CLASS_NUM];
+STATIC NET_CACHE_CLASS  mNetBulkCache[NET_BUF_CACHE_BULK_CLASS_NUM];
+
+/**
+  Get the cache size class that holds objects with Units entries.
+
+  @param[in]  Units          The number of NET_BLOCK_OP or NET_BLOCK entries.
+
+  @return                    The size class index, or NET_BUF_CACHE_CLASS_NUM
+                             if the object is too large to be cached.
+
+**/
+STATIC
+UINTN
+NetCacheGetClass (
+  IN UINT32  Units
+  )
+{
+  UINTN  Class;
+
+  if (Units <= 1) {
+    return 0;
+  }
+
+  Class = (UINTN)HighBitSet32 (Units - 1) + 1;
+  return MIN (Class, NET_BUF_CACHE_CLASS_NUM);
+}
+
+/**
+  Get the bulk cache size class that holds data blocks of Len bytes.
+
+  @param[in]  Len            The length of the data block.
+
+  @return                    The bulk size class index, or
+                             NET_BUF_CACHE_BULK_CLASS_NUM if the block is too
+                             large to be cached.
+
+**/
+STATIC
+UINTN
+NetCacheGetBulkClass (
+  IN UINT32  Len
+  )
+{
+  UINTN  Class;
+
+  for (Class = 0; Class < NET_BUF_CACHE_BULK_CLASS_NUM; Class++) {
+    if (Len <= NET_BUF_CACHE_BULK_CLASS_SIZE (Class)) {
+      break;
+    }
+  }
+
+  return Class;
+}
+
+/**
+  Take an object from the size class free list, or allocate a new one from
+  the pool if the list is empty.
+
+  @param[in, out]  Class     The size class to allocate from.
+  @param[in]       Size      The object size of the size class.
+
+  @return                    Pointer to the un-initialized object, or NULL if
+                             the allocation failed due to resource limit.
+
+**/
+STATIC
+VOID *
+NetCacheAllocate (
+  IN OUT NET_CACHE_CLASS  *Class,
+  IN     UINTN            Size
+  )
+{
+  NET_CACHE_ENTRY  *Entry;
+  EFI_TPL          OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Class->Stats.AllocCount++;
+  Entry = Class->Head;
+  if (Entry != NULL) {
+    Class->Head = Entry->Next;
+    Class->Stats.Cached--;
+    Class->Stats.CacheHits++;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Entry == NULL) {
+    Entry = AllocatePool (Size);
+  }
+
+  return Entry;
+}
+
+/**
+  Return an object to the size class free list, or to the pool if the list
+  is already full.
+
+  @param[in, out]  Class     The size class the object was allocated from.
+  @param[in]       Object    Pointer to the object to free.
+
+**/
+STATIC
+VOID
+NetCacheFree (
+  IN OUT NET_CACHE_CLASS  *Class,
+  IN     VOID             *Object
+  )
+{
+  NET_CACHE_ENTRY  *Entry;
+  EFI_TPL          OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Class->Stats.FreeCount++;
+  if (Class->Stats.Cached < NET_BUF_CACHE_DEPTH) {
+    Entry       = (NET_CACHE_ENTRY *)Object;
+    Entry->Next = Class->Head;
+    Class->Head = Entry;
+    Class->Stats.Cached++;
+    Object = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Object != NULL) {
+    FreePool (Object);
+  }
+}
+
+/**
+  Release all the objects held by the size class free list.
+
+  @param[in, out]  Class     The size class to flush.
+
+**/
+STATIC
+VOID
+NetCacheFlush (
+  IN OUT NET_CACHE_CLASS  *Class
+  )
+{
+  NET_CACHE_ENTRY  *Entry;
+  EFI_TPL          OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Entry  = Class->Head;
+
+  Class->Head         = NULL;
+  Class->Stats.Cached = 0;
+  gBS->RestoreTPL (OldTpl);
+
+  while (Entry != NULL) {
+    Class->Head = Entry->Next;
+    FreePool (Entry);
+    Entry = Class->Head;
+  }
+}
+
+/**
+  Allocate a zeroed NET_BUF with BlockOpNum's NET_BLOCK_OP.
+
+  @param[in]  BlockOpNum     The number of NET_BLOCK_OP in the net buffer.
+
+  @return                    Pointer to the allocated NET_BUF, or NULL if the
+                             allocation failed due to resource limit.
+
+**/
+STATIC
+NET_BUF *
+NetbufAllocHead (
+  IN UINT32  BlockOpNum
+  )
+{
+  NET_BUF  *Nbuf;
+  UINTN    Class;
+
+  Class = NetCacheGetClass (BlockOpNum);
+  if (Class < NET_BUF_CACHE_CLASS_NUM) {
+    Nbuf = NetCacheAllocate (&mNetBufCache[Class], NET_BUF_SIZE (1 << Class));
+  } else {
+    Nbuf = AllocatePool (NET_BUF_SIZE (BlockOpNum));
+  }
+
+  if (Nbuf != NULL) {
+    ZeroMem (Nbuf, NET_BUF_SIZE (BlockOpNum));
+  }
+
+  return Nbuf;
+}
+
+/**
+  Free the NET_BUF structure itself, without touching its vector.
+
+  @param[in]  Nbuf           Pointer to the NET_BUF allocated by NetbufAllocHead.
+
+**/
+STATIC
+VOID
+NetbufFreeHead (
+  IN NET_BUF  *Nbuf
+  )
+{
+  UINTN  Class;
+
+  Class = NetCacheGetClass (Nbuf->BlockOpNum);
+  if (Class < NET_BUF_CACHE_CLASS_NUM) {
+    NetCacheFree (&mNetBufCache[Class], Nbuf);
+  } else {
+    FreePool (Nbuf);
+  }
+}
+
+/**
+  Allocate a zeroed NET_VECTOR with BlockNum's NET_BLOCK.
+
+  @param[in]  BlockNum       The number of NET_BLOCK in the net vector.
+
+  @return                    Pointer to the allocated NET_VECTOR, or NULL if the
+                             allocation failed due to resource limit.
+
+**/
+STATIC
+NET_VECTOR *
+NetbufAllocVectorHead (
+  IN UINT32  BlockNum
+  )
+{
+  NET_VECTOR  *Vector;
+  UINTN       Class;
+
+  Class = NetCacheGetClass (BlockNum);
+  if (Class < NET_BUF_CACHE_CLASS_NUM) {
+    Vector = NetCacheAllocate (&mNetVectorCache[Class], NET_VECTOR_SIZE (1 << Class));
+  } else {
+    Vector = AllocatePool (NET_VECTOR_SIZE (BlockNum));
+  }
+
+  if (Vector != NULL) {
+    ZeroMem (Vector, NET_VECTOR_SIZE (BlockNum));
+  }
+
+  return Vector;
+}
+
+/**
+  Free the NET_VECTOR structure itself, without touching its blocks.
+
+  @param[in]  Vector         Pointer to the NET_VECTOR allocated by
+                             NetbufAllocVectorHead.
+
+**/
+STATIC
+VOID
+NetbufFreeVectorHead (
+  IN NET_VECTOR  *Vector
+  )
+{
+  UINTN  Class;
+
+  Class = NetCacheGetClass (Vector->BlockNum);
+  if (Class < NET_BUF_CACHE_CLASS_NUM) {
+    NetCacheFree (&mNetVectorCache[Class], Vector);
+  } else {
+    FreePool (Vector);
+  }
+}
+
+/**
+  Retrieve the allocation statistics of the net buffer caches.
+
+  @param[out]  Stats         Pointer to the buffer to receive the statistics.
+
+**/
+VOID
+EFIAPI
+NetbufGetPoolStats (
+  OUT NET_BUF_POOL_STATS  *Stats
+  )
+{
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  ASSERT (Stats != NULL);
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  for (Index = 0; Index < NET_BUF_CACHE_CLASS_NUM; Index++) {
+    CopyMem (&Stats->Buf[Index], &mNetBufCache[Index].Stats, sizeof (NET_BUF_CACHE_CLASS_STATS));
+    CopyMem (&Stats->Vector[Index], &mNetVectorCache[Index].Stats, sizeof (NET_BUF_CACHE_CLASS_STATS));
+  }
+
+  for (Index = 0; Index < NET_BUF_CACHE_BULK_CLASS_NUM; Index++) {
+    CopyMem (&Stats->Bulk[Index], &mNetBulkCache[Index].Stats, sizeof (NET_BUF_CACHE_CLASS_STATS));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Release all the NET_BUF, NET_VECTOR and data blocks held by the net buffer
+  caches back to the pool.
+
+**/
+VOID
+EFIAPI
+NetbufFlushPoolCache (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < NET_BUF_CACHE_CLASS_NUM; Index++) {
+    NetCacheFlush (&mNetBufCache[Index]);
+    NetCacheFlush (&mNetVectorCache[Index]);
+  }
+
+  for (Index = 0; Index < NET_BUF_CACHE_BULK_CLASS_NUM; Index++) {
+    NetCacheFlush (&mNetBulkCache[Index]);
+  }
+}
+
 /**
   Allocate and build up the sketch for a NET_BUF.
 
@@ -42,7 +386,7 @@ NetbufAllocStruct (
   //
   // Allocate three memory blocks.
   //
-  Nbuf = AllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  Nbuf = NetbufAllocHead (BlockOpNum);
 
   if (Nbuf == NULL) {
     return NULL;
@@ -54,7 +398,7 @@ NetbufAllocStruct (
   InitializeListHead (&Nbuf->List);
 
   if (BlockNum != 0) {
-    Vector = AllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    Vector = NetbufAllocVectorHead (BlockNum);
 
     if (Vector == NULL) {
       goto FreeNbuf;
@@ -70,7 +414,7 @@ NetbufAllocStruct (
 
 FreeNbuf:
 
-  FreePool (Nbuf);
+  NetbufFreeHead (Nbuf);
   return NULL;
 }
 
@@ -93,6 +437,7 @@ NetbufAlloc (
   NET_BUF     *Nbuf;
   NET_VECTOR  *Vector;
   UINT8       *Bulk;
+  UINTN       Class;
 
   ASSERT (Len > 0);
 
@@ -102,13 +447,23 @@ NetbufAlloc (
     return NULL;
   }
 
-  Bulk = AllocatePool (Len);
+  //
+  // Small blocks come from the smallest bulk cache class that fits them.
+  // Only the requested length is exposed.
+  //
+  Vector = Nbuf->Vector;
+  Class  = NetCacheGetBulkClass (Len);
+  if (Class < NET_BUF_CACHE_BULK_CLASS_NUM) {
+    Bulk          = NetCacheAllocate (&mNetBulkCache[Class], NET_BUF_CACHE_BULK_CLASS_SIZE (Class));
+    Vector->Flag |= NET_VECTOR_CACHED_BULK;
+  } else {
+    Bulk = AllocatePool (Len);
+  }
 
   if (Bulk == NULL) {
     goto FreeNBuf;
   }
 
-  Vector      = Nbuf->Vector;
   Vector->Len = Len;
 
   Vector->Block[0].Bulk = Bulk;
@@ -124,7 +479,8 @@ NetbufAlloc (
   return Nbuf;
 
 FreeNBuf:
-  FreePool (Nbuf);
+  NetbufFreeVectorHead (Nbuf->Vector);
+  NetbufFreeHead (Nbuf);
   return NULL;
 }
 
@@ -166,6 +522,14 @@ NetbufFreeVector (
     }
 
     Vector->Free (Vector->Arg);
+  } else if ((Vector->Flag & NET_VECTOR_CACHED_BULK) != 0) {
+    //
+    // The single block was allocated from the bulk cache by NetbufAlloc,
+    // from the size class of its length.
+    //
+    ASSERT (Vector->BlockNum == 1);
+    ASSERT (NetCacheGetBulkClass (Vector->Block[0].Len) < NET_BUF_CACHE_BULK_CLASS_NUM);
+    NetCacheFree (&mNetBulkCache[NetCacheGetBulkClass (Vector->Block[0].Len)], Vector->Block[0].Bulk);
   } else {
     //
     // Free each memory block associated with the Vector
@@ -175,7 +539,7 @@ NetbufFreeVector (
     }
   }
 
-  FreePool (Vector);
+  NetbufFreeVectorHead (Vector);
 }
 
 /**
@@ -208,7 +572,7 @@ NetbufFree (
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeHead (Nbuf);
   }
 }
 
@@ -234,7 +598,7 @@ NetbufClone (
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = AllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  Clone = NetbufAllocHead (Nbuf->BlockOpNum);
 
   if (Clone == NULL) {
     return NULL;
@@ -662,7 +1026,8 @@ NetbufGetFragment (
 
 FreeChild:
 
-  FreePool (Child);
+  NetbufFreeVectorHead (Child->Vector);
+  NetbufFreeHead (Child);
   return NULL;
 }
 
@@ -1840,7 +2205,7 @@ NetIpSecNetbufFree (
       FreePool (Nbuf->Vector->Block[0].Bulk);
     }
 
-    FreePool (Nbuf->Vector);
-    FreePool (Nbuf);
+    NetbufFreeVectorHead (Nbuf->Vector);
+    NetbufFreeHead (Nbuf);
   }
 }
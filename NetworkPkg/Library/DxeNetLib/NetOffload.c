@@ -0,0 +1,225 @@
+/** @file
+  Software implementation of the network transmit offloads, used by the
+  network drivers when the device can't perform them.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Library/NetLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#define NET_OFFLOAD_TCP_FLG_FIN  0x01
+#define NET_OFFLOAD_TCP_FLG_PSH  0x08
+
+/**
+  Compute the TCP or UDP checksum of an IPv4 packet.
+
+  @param[in]  Ip4Head       Pointer to the IPv4 header.
+  @param[in]  L4Head        Pointer to the TCP or UDP header.
+  @param[in]  L4Length      Length of the TCP or UDP header and payload.
+
+  @return The checksum to store in the TCP or UDP header.
+
+**/
+STATIC
+UINT16
+NetOffloadL4Checksum (
+  IN IP4_HEAD  *Ip4Head,
+  IN UINT8     *L4Head,
+  IN UINT16    L4Length
+  )
+{
+  UINT16  Checksum;
+
+  Checksum = NetblockChecksum (L4Head, L4Length);
+  Checksum = NetAddChecksum (
+               Checksum,
+               NetPseudoHeadChecksum (Ip4Head->Src, Ip4Head->Dst, Ip4Head->Protocol, L4Length)
+               );
+
+  return (UINT16)~Checksum;
+}
+
+/**
+  Fill in the checksums requested by Flags for one IPv4 packet.
+
+  @param[in]       Flags        The EDKII_NETWORK_OFFLOAD_* flags.
+  @param[in, out]  Ip4Head      Pointer to the IPv4 header of the packet.
+
+**/
+STATIC
+VOID
+NetOffloadChecksum (
+  IN     UINT32    Flags,
+  IN OUT IP4_HEAD  *Ip4Head
+  )
+{
+  UINT32          HeadLen;
+  UINT16          L4Length;
+  TCP_HEAD        *Tcp;
+  EFI_UDP_HEADER  *Udp;
+
+  HeadLen  = Ip4Head->HeadLen << 2;
+  L4Length = (UINT16)(NTOHS (Ip4Head->TotalLen) - HeadLen);
+
+  if ((Flags & EDKII_NETWORK_OFFLOAD_IP4_CSUM) != 0) {
+    Ip4Head->Checksum = 0;
+    Ip4Head->Checksum = (UINT16)~NetblockChecksum ((UINT8 *)Ip4Head, HeadLen);
+  }
+
+  if ((Ip4Head->Protocol == EFI_IP_PROTO_TCP) &&
+      ((Flags & (EDKII_NETWORK_OFFLOAD_TCP4_CSUM | EDKII_NETWORK_OFFLOAD_TSO4)) != 0))
+  {
+    Tcp           = (TCP_HEAD *)((UINT8 *)Ip4Head + HeadLen);
+    Tcp->Checksum = 0;
+    Tcp->Checksum = NetOffloadL4Checksum (Ip4Head, (UINT8 *)Tcp, L4Length);
+  } else if ((Ip4Head->Protocol == EFI_IP_PROTO_UDP) &&
+             ((Flags & EDKII_NETWORK_OFFLOAD_UDP4_CSUM) != 0))
+  {
+    Udp           = (EFI_UDP_HEADER *)((UINT8 *)Ip4Head + HeadLen);
+    Udp->Checksum = 0;
+    Udp->Checksum = NetOffloadL4Checksum (Ip4Head, (UINT8 *)Udp, L4Length);
+    if (Udp->Checksum == 0) {
+      Udp->Checksum = 0xffff;
+    }
+  }
+}
+
+/**
+  Perform the transmit offloads requested in TxInfo in software.
+
+  The IPv4, TCP and UDP checksums requested by TxInfo->Flags are computed in
+  place. If EDKII_NETWORK_OFFLOAD_TSO4 is requested and the TCP payload is
+  larger than TxInfo->Mss, the frame is split into segments of at most
+  TxInfo->Mss bytes of payload, each of them with its own headers and
+  checksums. SendFrame is called once for every resulting frame.
+
+  @param[in]       TxInfo        The offloads requested for the frame.
+  @param[in, out]  Frame         Pointer to the frame, starting with the media header.
+  @param[in]       FrameLength   Length of the frame, in bytes.
+  @param[in]       SendFrame     Function called to send every resulting frame.
+  @param[in]       Context       Context passed to SendFrame.
+
+  @retval EFI_SUCCESS            All the resulting frames were sent.
+  @retval EFI_INVALID_PARAMETER  The frame doesn't carry a valid IPv4 packet at
+                                 TxInfo->HeaderOffset, or TxInfo->Mss is zero.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the segment buffer.
+  @retval Others                 The error returned by SendFrame.
+
+**/
+EFI_STATUS
+EFIAPI
+NetLibOffloadFrame (
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo,
+  IN OUT UINT8                          *Frame,
+  IN     UINT32                         FrameLength,
+  IN     NET_OFFLOAD_SEND_FRAME         SendFrame,
+  IN     VOID                           *Context
+  )
+{
+  EFI_STATUS  Status;
+  IP4_HEAD    *Ip4Head;
+  TCP_HEAD    *Tcp;
+  UINT32      IpHeadLen;
+  UINT32      IpTotalLen;
+  UINT32      HeadersLen;
+  UINT32      PayloadLen;
+  UINT32      Offset;
+  UINT32      SegLen;
+  UINT16      Index;
+  UINT8       *Segment;
+  IP4_HEAD    *SegIp;
+  TCP_HEAD    *SegTcp;
+
+  if ((TxInfo == NULL) || (Frame == NULL) || (SendFrame == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((TxInfo->Flags & EDKII_NETWORK_OFFLOAD_TX_MASK) == 0) {
+    return SendFrame (Context, Frame, FrameLength);
+  }
+
+  if ((UINT32)TxInfo->HeaderOffset + sizeof (IP4_HEAD) > FrameLength) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Ip4Head    = (IP4_HEAD *)(Frame + TxInfo->HeaderOffset);
+  IpHeadLen  = Ip4Head->HeadLen << 2;
+  IpTotalLen = NTOHS (Ip4Head->TotalLen);
+
+  if ((Ip4Head->Ver != 4) || (IpHeadLen < sizeof (IP4_HEAD)) || (IpTotalLen < IpHeadLen) ||
+      (TxInfo->HeaderOffset + IpTotalLen > FrameLength))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (((TxInfo->Flags & EDKII_NETWORK_OFFLOAD_TSO4) == 0) || (Ip4Head->Protocol != EFI_IP_PROTO_TCP)) {
+    NetOffloadChecksum (TxInfo->Flags, Ip4Head);
+    return SendFrame (Context, Frame, FrameLength);
+  }
+
+  if ((IpTotalLen < IpHeadLen + sizeof (TCP_HEAD)) || (TxInfo->Mss == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Tcp        = (TCP_HEAD *)((UINT8 *)Ip4Head + IpHeadLen);
+  HeadersLen = TxInfo->HeaderOffset + IpHeadLen + (Tcp->HeadLen << 2);
+  if (HeadersLen > TxInfo->HeaderOffset + IpTotalLen) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PayloadLen = TxInfo->HeaderOffset + IpTotalLen - HeadersLen;
+  if (PayloadLen <= TxInfo->Mss) {
+    NetOffloadChecksum (TxInfo->Flags | EDKII_NETWORK_OFFLOAD_IP4_CSUM, Ip4Head);
+    return SendFrame (Context, Frame, FrameLength);
+  }
+
+  //
+  // Build every segment in a scratch buffer: a copy of the original headers
+  // followed by the next Mss bytes of payload.
+  //
+  Segment = AllocatePool (HeadersLen + TxInfo->Mss);
+  if (Segment == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SegIp  = (IP4_HEAD *)(Segment + TxInfo->HeaderOffset);
+  SegTcp = (TCP_HEAD *)((UINT8 *)SegIp + IpHeadLen);
+  Status = EFI_SUCCESS;
+
+  for (Offset = 0, Index = 0; Offset < PayloadLen; Offset += SegLen, Index++) {
+    SegLen = MIN (TxInfo->Mss, PayloadLen - Offset);
+
+    CopyMem (Segment, Frame, HeadersLen);
+    CopyMem (Segment + HeadersLen, Frame + HeadersLen + Offset, SegLen);
+
+    SegIp->TotalLen = HTONS ((UINT16)(HeadersLen - TxInfo->HeaderOffset + SegLen));
+    SegIp->Id       = HTONS ((UINT16)(NTOHS (Ip4Head->Id) + Index));
+    SegTcp->Seq     = HTONL (NTOHL (Tcp->Seq) + Offset);
+
+    if (Offset + SegLen < PayloadLen) {
+      SegTcp->Flag &= (UINT8)~(NET_OFFLOAD_TCP_FLG_FIN | NET_OFFLOAD_TCP_FLG_PSH);
+    }
+
+    //
+    // The IPv4 header checksum has to be recomputed as the total length
+    // and identification changed.
+    //
+    NetOffloadChecksum (TxInfo->Flags | EDKII_NETWORK_OFFLOAD_IP4_CSUM, SegIp);
+
+    Status = SendFrame (Context, Segment, HeadersLen + SegLen);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_NET, "NetLibOffloadFrame: failed to send segment %d, %r\n", Index, Status));
+      break;
+    }
+  }
+
+  FreePool (Segment);
+  return Status;
+}
@@ -0,0 +1,59 @@
+/** @file
+  Host instance of the UEFI Library for the NetworkPkg unit tests.
+
+  Only the functions that DxeNetLib calls are provided.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+/**
+  Retrieves a pointer to the system configuration table from the EFI System Table
+  based on a specified GUID.
+
+  The host tests run without a system table unless they install one in gST;
+  no table is found then.
+
+  If TableGuid is NULL, then ASSERT().
+  If Table is NULL, then ASSERT().
+
+  @param  TableGuid       The pointer to table's GUID type.
+  @param  Table           The pointer to the table associated with TableGuid in the EFI System Table.
+
+  @retval EFI_SUCCESS     A configuration table matching TableGuid was found.
+  @retval EFI_NOT_FOUND   A configuration table matching TableGuid could not be found.
+
+**/
+EFI_STATUS
+EFIAPI
+EfiGetSystemConfigurationTable (
+  IN  EFI_GUID  *TableGuid,
+  OUT VOID      **Table
+  )
+{
+  UINTN  Index;
+
+  ASSERT (TableGuid != NULL);
+  ASSERT (Table != NULL);
+
+  *Table = NULL;
+  if (gST == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < gST->NumberOfTableEntries; Index++) {
+    if (CompareGuid (TableGuid, &(gST->ConfigurationTable[Index].VendorGuid))) {
+      *Table = gST->ConfigurationTable[Index].VendorTable;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
@@ -0,0 +1,444 @@
+/** @file
+  Unit tests and alloc/free benchmark for the NetLib net buffer cache.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NetLib.h>
+
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#define UNIT_TEST_APP_NAME     "NetLib Net Buffer Cache Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define BENCHMARK_ITERATIONS  100000
+#define BENCHMARK_PACKET_LEN  1514
+
+//
+// The bulk cache class of BENCHMARK_PACKET_LEN bytes.
+//
+#define MTU_BULK_CLASS  (NET_BUF_CACHE_BULK_CLASS_NUM - 1)
+
+/**
+  Flush the caches so each test starts from an empty free list.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED  Always.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FlushCache (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NetbufFlushPoolCache ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A freed single block net buffer is reused by the next allocation.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AllocFreeShouldRecycle (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF             *Nbuf;
+  NET_BUF             *Reused;
+  NET_BUF_POOL_STATS  Before;
+  NET_BUF_POOL_STATS  After;
+
+  Nbuf = NetbufAlloc (BENCHMARK_PACKET_LEN);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  UT_ASSERT_NOT_EQUAL (Nbuf->Vector->Flag & NET_VECTOR_CACHED_BULK, 0);
+  UT_ASSERT_NOT_NULL (NetbufAllocSpace (Nbuf, BENCHMARK_PACKET_LEN, NET_BUF_TAIL));
+  NetbufFree (Nbuf);
+
+  NetbufGetPoolStats (&Before);
+  UT_ASSERT_EQUAL (Before.Buf[0].Cached, 1);
+  UT_ASSERT_EQUAL (Before.Vector[0].Cached, 1);
+  UT_ASSERT_EQUAL (Before.Bulk[MTU_BULK_CLASS].Cached, 1);
+
+  Reused = NetbufAlloc (BENCHMARK_PACKET_LEN);
+  UT_ASSERT_NOT_NULL (Reused);
+  UT_ASSERT_TRUE (Reused == Nbuf);
+  UT_ASSERT_EQUAL (Reused->RefCnt, 1);
+  UT_ASSERT_EQUAL (Reused->TotalSize, 0);
+  UT_ASSERT_EQUAL (Reused->Vector->RefCnt, 1);
+
+  NetbufGetPoolStats (&After);
+  UT_ASSERT_EQUAL (After.Buf[0].CacheHits, Before.Buf[0].CacheHits + 1);
+  UT_ASSERT_EQUAL (After.Vector[0].CacheHits, Before.Vector[0].CacheHits + 1);
+  UT_ASSERT_EQUAL (After.Bulk[MTU_BULK_CLASS].CacheHits, Before.Bulk[MTU_BULK_CLASS].CacheHits + 1);
+  UT_ASSERT_EQUAL (After.Bulk[MTU_BULK_CLASS].Cached, 0);
+
+  NetbufFree (Reused);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Blocks larger than NET_BUF_CACHE_BULK_SIZE bypass the bulk cache.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LargeBlockShouldBypassBulkCache (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF             *Nbuf;
+  NET_BUF_POOL_STATS  Stats;
+  UINTN               Class;
+
+  Nbuf = NetbufAlloc (NET_BUF_CACHE_BULK_SIZE + 1);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  UT_ASSERT_EQUAL (Nbuf->Vector->Flag & NET_VECTOR_CACHED_BULK, 0);
+  NetbufFree (Nbuf);
+
+  NetbufGetPoolStats (&Stats);
+  for (Class = 0; Class < NET_BUF_CACHE_BULK_CLASS_NUM; Class++) {
+    UT_ASSERT_EQUAL (Stats.Bulk[Class].Cached, 0);
+  }
+
+  UT_ASSERT_EQUAL (Stats.Buf[0].Cached, 1);
+  UT_ASSERT_EQUAL (Stats.Vector[0].Cached, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Small blocks come from the smallest bulk class that fits them, and a cached
+  small block is never handed out for a larger request.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SmallBlockShouldUseSmallBulkClass (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Lengths[] = { 1, 64, 128, 129, 512, 513, NET_BUF_CACHE_BULK_SIZE };
+  STATIC CONST UINTN   Classes[] = { 0, 0, 0, 1, 1, 2, 2 };
+  NET_BUF              *Nbuf;
+  NET_BUF_POOL_STATS   Before;
+  NET_BUF_POOL_STATS   After;
+  UINTN                Index;
+  UINTN                Class;
+
+  UT_ASSERT_EQUAL (NET_BUF_CACHE_BULK_CLASS_SIZE (0), 128);
+  UT_ASSERT_EQUAL (NET_BUF_CACHE_BULK_CLASS_SIZE (1), 512);
+  UT_ASSERT_EQUAL (NET_BUF_CACHE_BULK_CLASS_SIZE (2), NET_BUF_CACHE_BULK_SIZE);
+
+  for (Index = 0; Index < ARRAY_SIZE (Lengths); Index++) {
+    NetbufFlushPoolCache ();
+
+    Nbuf = NetbufAlloc (Lengths[Index]);
+    UT_ASSERT_NOT_NULL (Nbuf);
+    UT_ASSERT_NOT_EQUAL (Nbuf->Vector->Flag & NET_VECTOR_CACHED_BULK, 0);
+    UT_ASSERT_NOT_NULL (NetbufAllocSpace (Nbuf, Lengths[Index], NET_BUF_TAIL));
+    SetMem (NetbufGetByte (Nbuf, 0, NULL), Lengths[Index], 0x5A);
+    NetbufFree (Nbuf);
+
+    NetbufGetPoolStats (&After);
+    for (Class = 0; Class < NET_BUF_CACHE_BULK_CLASS_NUM; Class++) {
+      UT_ASSERT_EQUAL (After.Bulk[Class].Cached, (Class == Classes[Index]) ? 1 : 0);
+    }
+  }
+
+  //
+  // A cached 64 byte block is left alone by an MTU sized allocation.
+  //
+  NetbufFlushPoolCache ();
+  Nbuf = NetbufAlloc (64);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  NetbufFree (Nbuf);
+
+  NetbufGetPoolStats (&Before);
+  Nbuf = NetbufAlloc (BENCHMARK_PACKET_LEN);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  NetbufGetPoolStats (&After);
+  UT_ASSERT_EQUAL (After.Bulk[0].Cached, 1);
+  UT_ASSERT_EQUAL (After.Bulk[MTU_BULK_CLASS].CacheHits, Before.Bulk[MTU_BULK_CLASS].CacheHits);
+  NetbufFree (Nbuf);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Clones and fragments share the vector, which returns to the cache only
+  after the last reference is dropped.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SharedVectorShouldBeFreedOnce (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF             *Nbuf;
+  NET_BUF             *Clone;
+  NET_BUF             *Fragment;
+  NET_BUF_POOL_STATS  Stats;
+
+  Nbuf = NetbufAlloc (BENCHMARK_PACKET_LEN);
+  UT_ASSERT_NOT_NULL (Nbuf);
+  UT_ASSERT_NOT_NULL (NetbufAllocSpace (Nbuf, BENCHMARK_PACKET_LEN, NET_BUF_TAIL));
+
+  Clone = NetbufClone (Nbuf);
+  UT_ASSERT_NOT_NULL (Clone);
+
+  Fragment = NetbufGetFragment (Nbuf, 100, 500, 64);
+  UT_ASSERT_NOT_NULL (Fragment);
+  UT_ASSERT_EQUAL (Fragment->TotalSize, 500);
+  UT_ASSERT_EQUAL (Nbuf->Vector->RefCnt, 3);
+
+  NetbufFree (Nbuf);
+  NetbufFree (Clone);
+
+  NetbufGetPoolStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.Bulk[MTU_BULK_CLASS].Cached, 0);
+
+  NetbufFree (Fragment);
+
+  NetbufGetPoolStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.Bulk[MTU_BULK_CLASS].Cached, 1);
+  UT_ASSERT_EQUAL (Stats.Buf[0].AllocCount, Stats.Buf[0].FreeCount);
+  UT_ASSERT_EQUAL (Stats.Buf[1].AllocCount, Stats.Buf[1].FreeCount);
+  UT_ASSERT_EQUAL (Stats.Vector[0].AllocCount, Stats.Vector[0].FreeCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Flushing the cache releases every cached object.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FlushShouldEmptyCache (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF             *Nbuf[8];
+  NET_BUF_POOL_STATS  Stats;
+  UINTN               Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    Nbuf[Index] = NetbufAlloc (BENCHMARK_PACKET_LEN);
+    UT_ASSERT_NOT_NULL (Nbuf[Index]);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Nbuf); Index++) {
+    NetbufFree (Nbuf[Index]);
+  }
+
+  NetbufGetPoolStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.Buf[0].Cached, ARRAY_SIZE (Nbuf));
+
+  NetbufFlushPoolCache ();
+
+  NetbufGetPoolStats (&Stats);
+  UT_ASSERT_EQUAL (Stats.Buf[0].Cached, 0);
+  UT_ASSERT_EQUAL (Stats.Vector[0].Cached, 0);
+  for (Index = 0; Index < NET_BUF_CACHE_BULK_CLASS_NUM; Index++) {
+    UT_ASSERT_EQUAL (Stats.Bulk[Index].Cached, 0);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the NetbufAlloc/NetbufFree rate against the three separate pool
+  allocations the net buffer used to make for every packet.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkAllocFree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NET_BUF  *Nbuf;
+  VOID     *Head;
+  VOID     *Vector;
+  VOID     *Bulk;
+  UINTN    Iterations;
+  UINTN    Index;
+  UINT64   Start;
+  UINT64   Cached;
+  UINT64   Pool;
+
+  Iterations = UnitTestBenchmarkIterations (BENCHMARK_ITERATIONS);
+
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < Iterations; Index++) {
+    Nbuf = NetbufAlloc (BENCHMARK_PACKET_LEN);
+    UT_ASSERT_NOT_NULL (Nbuf);
+    NetbufFree (Nbuf);
+  }
+
+  Cached = UnitTestBenchmarkElapsed (Start);
+
+  Start = UnitTestBenchmarkStart ();
+  for (Index = 0; Index < Iterations; Index++) {
+    Head   = AllocateZeroPool (NET_BUF_SIZE (1));
+    Vector = AllocateZeroPool (NET_VECTOR_SIZE (1));
+    Bulk   = AllocatePool (BENCHMARK_PACKET_LEN);
+    UT_ASSERT_TRUE ((Head != NULL) && (Vector != NULL) && (Bulk != NULL));
+    FreePool (Bulk);
+    FreePool (Vector);
+    FreePool (Head);
+  }
+
+  Pool = UnitTestBenchmarkElapsed (Start);
+
+  UT_LOG_INFO (
+    "%Lu alloc/free pairs: cache %Lu us, pool %Lu us\n",
+    (UINT64)Iterations,
+    Cached,
+    Pool
+    );
+  DEBUG ((
+    DEBUG_INFO,
+    "NetBuffer benchmark: %Lu alloc/free pairs, cache %Lu us, pool %Lu us\n",
+    (UINT64)Iterations,
+    Cached,
+    Pool
+    ));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  net buffer cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "Net Buffer Cache Tests", "NetLib.NetBuffer", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Net Buffer Cache Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description----------------------------Name---------------Function-------------------------Pre---------Post--Context
+  //
+  AddTestCase (CacheTests, "Alloc and free are recycled", "Recycle", AllocFreeShouldRecycle, FlushCache, NULL, NULL);
+  AddTestCase (CacheTests, "Large blocks bypass the bulk cache", "LargeBlock", LargeBlockShouldBypassBulkCache, FlushCache, NULL, NULL);
+  AddTestCase (CacheTests, "Small blocks use small bulk classes", "SmallBlock", SmallBlockShouldUseSmallBulkClass, FlushCache, NULL, NULL);
+  AddTestCase (CacheTests, "Shared vectors are freed once", "SharedVector", SharedVectorShouldBeFreedOnce, FlushCache, NULL, NULL);
+  AddTestCase (CacheTests, "Flush empties the cache", "Flush", FlushShouldEmptyCache, FlushCache, NULL, NULL);
+  AddTestCase (CacheTests, "Alloc/free rate benchmark", "Benchmark", BenchmarkAllocFree, FlushCache, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define NetBufferUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+NetBufferUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
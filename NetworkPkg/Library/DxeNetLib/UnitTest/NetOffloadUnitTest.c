@@ -0,0 +1,379 @@
+/** @file
+  Unit tests for the NetLib software transmit offload.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NetLib.h>
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "NetLib Transmit Offload Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_MEDIA_HEADER_LEN  14
+#define TEST_MSS               1460
+#define TEST_PAYLOAD_LEN       5000
+#define TEST_SEQ               0x10203040
+#define TEST_IP_ID             0x1234
+#define TEST_MAX_SEGMENTS      8
+
+#define TEST_TCP_FLG_FIN  0x01
+#define TEST_TCP_FLG_PSH  0x08
+#define TEST_TCP_FLG_ACK  0x10
+
+#define TEST_HEADERS_LEN  (TEST_MEDIA_HEADER_LEN + sizeof (IP4_HEAD) + sizeof (TCP_HEAD))
+
+typedef struct {
+  UINT32    Count;
+  UINT32    Length[TEST_MAX_SEGMENTS];
+  UINT8     Frame[TEST_MAX_SEGMENTS][TEST_HEADERS_LEN + TEST_PAYLOAD_LEN];
+} TEST_SENT_FRAMES;
+
+STATIC TEST_SENT_FRAMES  mSent;
+STATIC UINT8             mFrame[TEST_HEADERS_LEN + TEST_PAYLOAD_LEN];
+
+/**
+  Record a frame produced by NetLibOffloadFrame.
+
+  @param[in]  Context       Unused.
+  @param[in]  Frame         Pointer to the frame.
+  @param[in]  FrameLength   Length of the frame.
+
+  @retval EFI_SUCCESS           The frame is recorded.
+  @retval EFI_BUFFER_TOO_SMALL  Too many or too large frames.
+
+**/
+EFI_STATUS
+EFIAPI
+RecordFrame (
+  IN VOID    *Context,
+  IN UINT8   *Frame,
+  IN UINT32  FrameLength
+  )
+{
+  if ((mSent.Count >= TEST_MAX_SEGMENTS) || (FrameLength > sizeof (mSent.Frame[0]))) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (mSent.Frame[mSent.Count], Frame, FrameLength);
+  mSent.Length[mSent.Count] = FrameLength;
+  mSent.Count++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Build an Ethernet/IPv4/TCP frame with zero checksums and a patterned
+  payload, and reset the recorded frames.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED  Always.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BuildTcpFrame (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  IP4_HEAD  *Ip4Head;
+  TCP_HEAD  *Tcp;
+  UINT32    Index;
+
+  ZeroMem (&mSent, sizeof (mSent));
+  ZeroMem (mFrame, sizeof (mFrame));
+
+  Ip4Head           = (IP4_HEAD *)(mFrame + TEST_MEDIA_HEADER_LEN);
+  Ip4Head->Ver      = 4;
+  Ip4Head->HeadLen  = sizeof (IP4_HEAD) >> 2;
+  Ip4Head->TotalLen = HTONS ((UINT16)(sizeof (IP4_HEAD) + sizeof (TCP_HEAD) + TEST_PAYLOAD_LEN));
+  Ip4Head->Id       = HTONS (TEST_IP_ID);
+  Ip4Head->Ttl      = 64;
+  Ip4Head->Protocol = EFI_IP_PROTO_TCP;
+  Ip4Head->Src      = HTONL (0xC0A80001);
+  Ip4Head->Dst      = HTONL (0xC0A80002);
+
+  Tcp          = (TCP_HEAD *)(Ip4Head + 1);
+  Tcp->SrcPort = HTONS (49152);
+  Tcp->DstPort = HTONS (4420);
+  Tcp->Seq     = HTONL (TEST_SEQ);
+  Tcp->HeadLen = sizeof (TCP_HEAD) >> 2;
+  Tcp->Flag    = TEST_TCP_FLG_ACK | TEST_TCP_FLG_PSH | TEST_TCP_FLG_FIN;
+  Tcp->Wnd     = HTONS (0xffff);
+
+  for (Index = 0; Index < TEST_PAYLOAD_LEN; Index++) {
+    mFrame[TEST_HEADERS_LEN + Index] = (UINT8)Index;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that the IPv4 header and TCP checksums of a frame are valid.
+
+  @param[in]  Frame     Pointer to the frame.
+
+  @retval TRUE          Both checksums are valid.
+  @retval FALSE         At least one checksum is invalid.
+
+**/
+BOOLEAN
+ChecksumsAreValid (
+  IN UINT8  *Frame
+  )
+{
+  IP4_HEAD  *Ip4Head;
+  UINT16    L4Length;
+  UINT16    Sum;
+
+  Ip4Head = (IP4_HEAD *)(Frame + TEST_MEDIA_HEADER_LEN);
+  if (NetblockChecksum ((UINT8 *)Ip4Head, sizeof (IP4_HEAD)) != 0xffff) {
+    return FALSE;
+  }
+
+  L4Length = (UINT16)(NTOHS (Ip4Head->TotalLen) - sizeof (IP4_HEAD));
+  Sum      = NetblockChecksum ((UINT8 *)(Ip4Head + 1), L4Length);
+  Sum      = NetAddChecksum (Sum, NetPseudoHeadChecksum (Ip4Head->Src, Ip4Head->Dst, EFI_IP_PROTO_TCP, L4Length));
+  return (BOOLEAN)(Sum == 0xffff);
+}
+
+/**
+  A checksum-only request fills in the checksums and sends a single frame.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ChecksumOnlyShouldSendOneFrame (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EDKII_NETWORK_OFFLOAD_TX_INFO  TxInfo;
+  EFI_STATUS                     Status;
+
+  TxInfo.Flags        = EDKII_NETWORK_OFFLOAD_IP4_CSUM | EDKII_NETWORK_OFFLOAD_TCP4_CSUM;
+  TxInfo.Mss          = 0;
+  TxInfo.HeaderOffset = TEST_MEDIA_HEADER_LEN;
+
+  Status = NetLibOffloadFrame (&TxInfo, mFrame, sizeof (mFrame), RecordFrame, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSent.Count, 1);
+  UT_ASSERT_EQUAL (mSent.Length[0], sizeof (mFrame));
+  UT_ASSERT_TRUE (ChecksumsAreValid (mFrame));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A TSO request splits the payload into Mss sized segments with valid
+  headers, and only the last segment keeps FIN and PSH.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TsoShouldSplitByMss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EDKII_NETWORK_OFFLOAD_TX_INFO  TxInfo;
+  EFI_STATUS                     Status;
+  UINT32                         Index;
+  UINT32                         Offset;
+  UINT32                         SegLen;
+  IP4_HEAD                       *Ip4Head;
+  TCP_HEAD                       *Tcp;
+
+  TxInfo.Flags        = EDKII_NETWORK_OFFLOAD_TSO4;
+  TxInfo.Mss          = TEST_MSS;
+  TxInfo.HeaderOffset = TEST_MEDIA_HEADER_LEN;
+
+  Status = NetLibOffloadFrame (&TxInfo, mFrame, sizeof (mFrame), RecordFrame, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSent.Count, (TEST_PAYLOAD_LEN + TEST_MSS - 1) / TEST_MSS);
+
+  for (Index = 0, Offset = 0; Index < mSent.Count; Index++, Offset += SegLen) {
+    SegLen  = MIN (TEST_MSS, TEST_PAYLOAD_LEN - Offset);
+    Ip4Head = (IP4_HEAD *)(mSent.Frame[Index] + TEST_MEDIA_HEADER_LEN);
+    Tcp     = (TCP_HEAD *)(Ip4Head + 1);
+
+    UT_ASSERT_EQUAL (mSent.Length[Index], TEST_HEADERS_LEN + SegLen);
+    UT_ASSERT_EQUAL (NTOHS (Ip4Head->TotalLen), sizeof (IP4_HEAD) + sizeof (TCP_HEAD) + SegLen);
+    UT_ASSERT_EQUAL (NTOHS (Ip4Head->Id), TEST_IP_ID + Index);
+    UT_ASSERT_EQUAL (NTOHL (Tcp->Seq), TEST_SEQ + Offset);
+    UT_ASSERT_MEM_EQUAL (mSent.Frame[Index] + TEST_HEADERS_LEN, mFrame + TEST_HEADERS_LEN + Offset, SegLen);
+    UT_ASSERT_TRUE (ChecksumsAreValid (mSent.Frame[Index]));
+
+    if (Index + 1 < mSent.Count) {
+      UT_ASSERT_EQUAL (Tcp->Flag, TEST_TCP_FLG_ACK);
+    } else {
+      UT_ASSERT_EQUAL (Tcp->Flag, TEST_TCP_FLG_ACK | TEST_TCP_FLG_PSH | TEST_TCP_FLG_FIN);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A TSO request for a payload that fits in one Mss is sent unsplit.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TsoWithinMssShouldNotSplit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EDKII_NETWORK_OFFLOAD_TX_INFO  TxInfo;
+  EFI_STATUS                     Status;
+
+  TxInfo.Flags        = EDKII_NETWORK_OFFLOAD_TSO4;
+  TxInfo.Mss          = TEST_PAYLOAD_LEN;
+  TxInfo.HeaderOffset = TEST_MEDIA_HEADER_LEN;
+
+  Status = NetLibOffloadFrame (&TxInfo, mFrame, sizeof (mFrame), RecordFrame, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSent.Count, 1);
+  UT_ASSERT_TRUE (ChecksumsAreValid (mFrame));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A frame without a valid IPv4 header at HeaderOffset is rejected.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadHeaderShouldBeRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EDKII_NETWORK_OFFLOAD_TX_INFO  TxInfo;
+  EFI_STATUS                     Status;
+
+  TxInfo.Flags        = EDKII_NETWORK_OFFLOAD_TSO4;
+  TxInfo.Mss          = TEST_MSS;
+  TxInfo.HeaderOffset = 0;
+
+  Status = NetLibOffloadFrame (&TxInfo, mFrame, sizeof (mFrame), RecordFrame, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  TxInfo.HeaderOffset = TEST_MEDIA_HEADER_LEN;
+  TxInfo.Mss          = 0;
+  Status              = NetLibOffloadFrame (&TxInfo, mFrame, sizeof (mFrame), RecordFrame, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (mSent.Count, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  NetLib software transmit offload, and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      OffloadTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&OffloadTests, Framework, "Software Transmit Offload Tests", "NetLib.NetOffload", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Software Transmit Offload Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite----------Description----------------------------------Name--------------Function-----------------------Pre-------------Post--Context
+  //
+  AddTestCase (OffloadTests, "Checksum offload sends one frame", "Checksum", ChecksumOnlyShouldSendOneFrame, BuildTcpFrame, NULL, NULL);
+  AddTestCase (OffloadTests, "TSO splits the payload by Mss", "TsoSplit", TsoShouldSplitByMss, BuildTcpFrame, NULL, NULL);
+  AddTestCase (OffloadTests, "TSO within one Mss isn't split", "TsoNoSplit", TsoWithinMssShouldNotSplit, BuildTcpFrame, NULL, NULL);
+  AddTestCase (OffloadTests, "Bad headers are rejected", "BadHeader", BadHeaderShouldBeRejected, BuildTcpFrame, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define NetOffloadUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+NetOffloadUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
@@ -385,8 +385,6 @@ _sock_flush (
   struct spdk_sock_request  *req = NULL;
   int                       i = 0;
   unsigned int              offset = 0;
-  char                      *writebuf = NULL;
-  char                      *bufptr = NULL;
   int                       vecsize = 0;
   NET_BUF                   *Pdu = NULL;
   UINT8                     *Packet = NULL;
@@ -445,19 +443,10 @@ _sock_flush (
 
   SPDK_DEBUGLOG (nvme, "Bytes to transmit: %d\n", vecsize);
 
-  writebuf = (char*)AllocateZeroPool (vecsize);
-  if (writebuf == NULL) {
-      SPDK_DEBUGLOG (nvme, "malloc error\n");
-      return -1;
-  }
-
-  bufptr = writebuf;
-  int index = 0;
-  for (index = 0; index < iovcnt; index++) {
-      CopyMem (bufptr, iovs[index].iov_base, iovs[index].iov_len);
-      bufptr += iovs[index].iov_len;
-  }
-
+  //
+  // Gather the iovs straight into the PDU. NetbufAlloc serves the NET_BUF
+  // and small PDUs from the NetLib buffer cache.
+  //
   Pdu = NetbufAlloc (vecsize);
   if (Pdu == NULL) {
       SPDK_DEBUGLOG (nvme, "Error while NetbufAlloc \n");
@@ -467,14 +456,15 @@ _sock_flush (
   if (Packet == NULL) {
       SPDK_DEBUGLOG (nvme, "Error while NetbufAllocSpace \n");
       retval = -1;
-      free (writebuf);
       NetbufFree (Pdu);
       return retval;
   }
 
-  CopyMem (Packet, writebuf, vecsize);
-
-  NetbufCopy (Pdu, 0, vecsize, (UINT8 *)Packet);
+  int index = 0;
+  for (index = 0; index < iovcnt; index++) {
+      CopyMem (Packet, iovs[index].iov_base, iovs[index].iov_len);
+      Packet += iovs[index].iov_len;
+  }
 
   //
   // Send it to the NvmeOf target.
@@ -483,7 +473,6 @@ _sock_flush (
   if (EFI_ERROR (Status)) {
       SPDK_ERRLOG ("Error while TcpIoTransmit .%d\n", Status);
       retval = -1;
-      free (writebuf);
       NetbufFree (Pdu);
       return retval;
   }
@@ -503,7 +492,6 @@ _sock_flush (
       req = TAILQ_NEXT (req, internal.link);
   }
 
-  free (writebuf);
   NetbufFree (Pdu);
   return retval;
 }
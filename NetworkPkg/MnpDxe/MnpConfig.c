@@ -25,6 +25,11 @@ EFI_MANAGED_NETWORK_PROTOCOL  mMnpProtocolTemplate = {
   MnpPoll
 };
 
+EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  mMnpOffloadProtocolTemplate = {
+  MnpOffloadGetCapabilities,
+  MnpOffloadTransmit
+};
+
 EFI_MANAGED_NETWORK_CONFIG_DATA  mMnpDefaultConfigData = {
   10000000,
   10000000,
@@ -237,6 +242,7 @@ MnpAddFreeTxBuf (
     DEBUG ((DEBUG_INFO, "MnpAddFreeTxBuf: Add TxBufWrap %p, TxBuf %p\n", TxBufWrap, TxBufWrap->TxBuf));
     TxBufWrap->Signature = MNP_TX_BUF_WRAP_SIGNATURE;
     TxBufWrap->InUse     = FALSE;
+    TxBufWrap->Large     = FALSE;
     InsertTailList (&MnpDeviceData->FreeTxBufList, &TxBufWrap->WrapEntry);
     InsertTailList (&MnpDeviceData->AllTxBufList, &TxBufWrap->AllEntry);
   }
@@ -323,6 +329,50 @@ ON_EXIT:
   return TxBuf;
 }
 
+/**
+  Allocate a TX buffer for a single large send that doesn't fit in the
+  buffers of the FreeTxBufList. The buffer is released back to the pool
+  instead of the FreeTxBufList when it's recycled.
+
+  @param[in, out]  MnpDeviceData        Pointer to the MNP_DEVICE_DATA.
+  @param[in]       Length               The length of the buffer.
+
+  @return     Pointer to the allocated buffer, if NULL the operation is failed.
+
+**/
+UINT8 *
+MnpAllocLargeTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Length
+  )
+{
+  EFI_TPL          OldTpl;
+  MNP_TX_BUF_WRAP  *TxBufWrap;
+
+  NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
+
+  TxBufWrap = (MNP_TX_BUF_WRAP *)AllocatePool (OFFSET_OF (MNP_TX_BUF_WRAP, TxBuf) + Length);
+  if (TxBufWrap == NULL) {
+    DEBUG ((DEBUG_ERROR, "MnpAllocLargeTxBuf: Failed to allocate %d bytes.\n", Length));
+    return NULL;
+  }
+
+  TxBufWrap->Signature = MNP_TX_BUF_WRAP_SIGNATURE;
+  TxBufWrap->InUse     = TRUE;
+  TxBufWrap->Large     = TRUE;
+  InitializeListHead (&TxBufWrap->WrapEntry);
+
+  //
+  // Track it in the AllTxBufList so that it's released when the device
+  // data is destroyed even if the SNP never recycles it.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  InsertTailList (&MnpDeviceData->AllTxBufList, &TxBufWrap->AllEntry);
+  gBS->RestoreTPL (OldTpl);
+
+  return TxBufWrap->TxBuf;
+}
+
 /**
   Try to reclaim the TX buffer into the buffer pool.
 
@@ -363,8 +413,14 @@ MnpFreeTxBuf (
   }
 
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
-  InsertTailList (&MnpDeviceData->FreeTxBufList, &TxBufWrap->WrapEntry);
-  TxBufWrap->InUse = FALSE;
+  if (TxBufWrap->Large) {
+    RemoveEntryList (&TxBufWrap->AllEntry);
+    FreePool (TxBufWrap);
+  } else {
+    InsertTailList (&MnpDeviceData->FreeTxBufList, &TxBufWrap->WrapEntry);
+    TxBufWrap->InUse = FALSE;
+  }
+
   gBS->RestoreTPL (OldTpl);
 }
 
@@ -457,6 +513,22 @@ MnpInitializeDeviceData (
   SnpMode            = Snp->Mode;
   MnpDeviceData->Snp = Snp;
 
+  //
+  // The transmit offload interface is optional, the offloads are done in
+  // software if the NIC doesn't provide it.
+  //
+  Status = gBS->OpenProtocol (
+                  ControllerHandle,
+                  &gEdkiiSimpleNetworkOffloadProtocolGuid,
+                  (VOID **)&MnpDeviceData->SnpOffload,
+                  ImageHandle,
+                  ControllerHandle,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDeviceData->SnpOffload = NULL;
+  }
+
   //
   // Initialize the lists.
   //
@@ -647,8 +719,11 @@ MnpDestroyDeviceData (
   NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &MnpDeviceData->AllTxBufList) {
     TxBufWrap = NET_LIST_USER_STRUCT (Entry, MNP_TX_BUF_WRAP, AllEntry);
     RemoveEntryList (Entry);
+    if (!TxBufWrap->Large) {
+      MnpDeviceData->TxBufCount--;
+    }
+
     FreePool (TxBufWrap);
-    MnpDeviceData->TxBufCount--;
   }
   ASSERT (IsListEmpty (&MnpDeviceData->AllTxBufList));
   ASSERT (MnpDeviceData->TxBufCount == 0);
@@ -980,6 +1055,7 @@ MnpInitializeInstanceData (
   // Copy the MNP Protocol interfaces from the template.
   //
   CopyMem (&Instance->ManagedNetwork, &mMnpProtocolTemplate, sizeof (Instance->ManagedNetwork));
+  CopyMem (&Instance->ManagedNetworkOffload, &mMnpOffloadProtocolTemplate, sizeof (Instance->ManagedNetworkOffload));
 
   //
   // Copy the default config data.
@@ -1220,6 +1296,11 @@ MnpStart (
         goto ErrorExit;
       }
 
+      //
+      // Count the receive path from this start on.
+      //
+      ZeroMem (&MnpDeviceData->RxStats, sizeof (MnpDeviceData->RxStats));
+
       //
       // Start the timeout timer.
       //
@@ -1273,6 +1354,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->IdlePollCount    = 0;
   }
 
   //
@@ -1334,6 +1417,26 @@ MnpStop (
     MnpDeviceData->EnableSystemPoll = FALSE;
   }
 
+  DEBUG ((
+    DEBUG_NET,
+    "MnpStop: %Lu polls (%Lu empty, %Lu budget exhausted), %Lu packets, max %Lu per poll.\n",
+    MnpDeviceData->RxStats.PollCount,
+    MnpDeviceData->RxStats.EmptyPollCount,
+    MnpDeviceData->RxStats.BudgetExhausted,
+    MnpDeviceData->RxStats.RxPackets,
+    (UINT64)MnpDeviceData->RxStats.MaxPacketsPerPoll
+    ));
+  DEBUG ((
+    DEBUG_NET,
+    "MnpStop: drops nobuf %Lu, size %Lu, vlan %Lu, noreceiver %Lu, queuefull %Lu, deverr %Lu.\n",
+    MnpDeviceData->RxStats.DropNoBuffer,
+    MnpDeviceData->RxStats.DropSizeError,
+    MnpDeviceData->RxStats.DropNoVlan,
+    MnpDeviceData->RxStats.DropNoReceiver,
+    MnpDeviceData->RxStats.DropQueueFull,
+    MnpDeviceData->RxStats.DropDeviceError
+    ));
+
   //
   // Cancel the timeout timer.
   //
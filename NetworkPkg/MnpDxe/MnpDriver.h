@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Protocol/NetworkOffload.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -30,6 +31,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "ComponentName.h"
 
+//
+// Receive path counters, reported through DEBUG when the MNP is stopped.
+//
+typedef struct {
+  UINT64    PollCount;          // Number of batched receive polls.
+  UINT64    EmptyPollCount;     // Polls that found no packet in the SNP queue.
+  UINT64    RxPackets;          // Packets pulled from the SNP.
+  UINT64    BudgetExhausted;    // Polls that stopped because the budget was used up.
+  UINT32    MaxPacketsPerPoll;  // Largest batch seen in one poll.
+  UINT64    DropNoBuffer;       // No NET_BUF available for the receive cache.
+  UINT64    DropSizeError;      // SNP returned a malformed frame.
+  UINT64    DropNoVlan;         // Tagged frame without a matching VLAN service.
+  UINT64    DropNoReceiver;     // No configured instance accepted the frame.
+  UINT64    DropQueueFull;      // Instance receive queue overflowed.
+  UINT64    DropDeviceError;    // Snp->Receive() failed with a device error.
+} MNP_RX_STATISTICS;
+
 #define MNP_DEVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'D')
 
 //
@@ -38,53 +56,65 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern  EFI_DRIVER_BINDING_PROTOCOL  gMnpDriverBinding;
 
 typedef struct {
-  UINT32                         Signature;
+  UINT32                                   Signature;
 
-  EFI_HANDLE                     ControllerHandle;
-  EFI_HANDLE                     ImageHandle;
+  EFI_HANDLE                               ControllerHandle;
+  EFI_HANDLE                               ImageHandle;
 
-  EFI_VLAN_CONFIG_PROTOCOL       VlanConfig;
-  UINTN                          NumberOfVlan;
-  CHAR16                         *MacString;
-  EFI_SIMPLE_NETWORK_PROTOCOL    *Snp;
+  EFI_VLAN_CONFIG_PROTOCOL                 VlanConfig;
+  UINTN                                    NumberOfVlan;
+  CHAR16                                   *MacString;
+  EFI_SIMPLE_NETWORK_PROTOCOL              *Snp;
+  //
+  // Optional transmit offload interface of the SNP, NULL if the NIC has none.
+  //
+  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL    *SnpOffload;
 
   //
   // List of MNP_SERVICE_DATA
   //
-  LIST_ENTRY                     ServiceList;
+  LIST_ENTRY                               ServiceList;
   //
   // Number of configured MNP Service Binding child
   //
-  UINTN                          ConfiguredChildrenNumber;
+  UINTN                                    ConfiguredChildrenNumber;
 
-  LIST_ENTRY                     GroupAddressList;
-  UINT32                         GroupAddressCount;
+  LIST_ENTRY                               GroupAddressList;
+  UINT32                                   GroupAddressCount;
 
-  LIST_ENTRY                     FreeTxBufList;
-  LIST_ENTRY                     AllTxBufList;
-  UINT32                         TxBufCount;
+  LIST_ENTRY                               FreeTxBufList;
+  LIST_ENTRY                               AllTxBufList;
+  UINT32                                   TxBufCount;
 
-  NET_BUF_QUEUE                  FreeNbufQue;
-  INTN                           NbufCnt;
+  NET_BUF_QUEUE                            FreeNbufQue;
+  INTN                                     NbufCnt;
 
-  EFI_EVENT                      PollTimer;
-  BOOLEAN                        EnableSystemPoll;
+  EFI_EVENT                                PollTimer;
+  BOOLEAN                                  EnableSystemPoll;
+  //
+  // Current period of the PollTimer and the number of consecutive idle
+  // polls, used to adapt the system poll rate to the receive load.
+  //
+  UINT64                                   PollInterval;
+  UINT32                                   IdlePollCount;
 
-  EFI_EVENT                      TimeoutCheckTimer;
-  EFI_EVENT                      MediaDetectTimer;
+  EFI_EVENT                                TimeoutCheckTimer;
+  EFI_EVENT                                MediaDetectTimer;
 
-  UINT32                         UnicastCount;
-  UINT32                         BroadcastCount;
-  UINT32                         MulticastCount;
-  UINT32                         PromiscuousCount;
+  UINT32                                   UnicastCount;
+  UINT32                                   BroadcastCount;
+  UINT32                                   MulticastCount;
+  UINT32                                   PromiscuousCount;
 
   //
   // The size of the data buffer in the MNP_PACKET_BUFFER used to
   // store a packet.
   //
-  UINT32                         BufferLength;
-  UINT32                         PaddingSize;
-  NET_BUF                        *RxNbufCache;
+  UINT32                                   BufferLength;
+  UINT32                                   PaddingSize;
+  NET_BUF                                  *RxNbufCache;
+
+  MNP_RX_STATISTICS                        RxStats;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_FAST_INTERVAL   (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_SYS_POLL_IDLE_THRESHOLD  8                      // Idle polls before falling back to the slow rate.
+#define MNP_RX_BATCH_BUDGET          32                     // Max packets drained from the SNP per poll.
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -41,31 +44,40 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   MNP_INSTANCE_DATA_SIGNATURE \
   )
 
+#define MNP_INSTANCE_DATA_FROM_OFFLOAD_THIS(a) \
+  CR ( \
+  (a), \
+  MNP_INSTANCE_DATA, \
+  ManagedNetworkOffload, \
+  MNP_INSTANCE_DATA_SIGNATURE \
+  )
+
 typedef struct {
-  UINT32                             Signature;
+  UINT32                                    Signature;
 
-  MNP_SERVICE_DATA                   *MnpServiceData;
+  MNP_SERVICE_DATA                          *MnpServiceData;
 
-  EFI_HANDLE                         Handle;
+  EFI_HANDLE                                Handle;
 
-  LIST_ENTRY                         InstEntry;
+  LIST_ENTRY                                InstEntry;
 
-  EFI_MANAGED_NETWORK_PROTOCOL       ManagedNetwork;
+  EFI_MANAGED_NETWORK_PROTOCOL              ManagedNetwork;
+  EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL    ManagedNetworkOffload;
 
-  BOOLEAN                            Configured;
-  BOOLEAN                            Destroyed;
+  BOOLEAN                                   Configured;
+  BOOLEAN                                   Destroyed;
 
-  LIST_ENTRY                         GroupCtrlBlkList;
+  LIST_ENTRY                                GroupCtrlBlkList;
 
-  NET_MAP                            RxTokenMap;
+  NET_MAP                                   RxTokenMap;
 
-  LIST_ENTRY                         RxDeliveredPacketQueue;
-  LIST_ENTRY                         RcvdPacketQueue;
-  UINTN                              RcvdPacketQueueSize;
+  LIST_ENTRY                                RxDeliveredPacketQueue;
+  LIST_ENTRY                                RcvdPacketQueue;
+  UINTN                                     RcvdPacketQueueSize;
 
-  EFI_MANAGED_NETWORK_CONFIG_DATA    ConfigData;
+  EFI_MANAGED_NETWORK_CONFIG_DATA           ConfigData;
 
-  UINT8                              ReceiveFilter;
+  UINT8                                     ReceiveFilter;
 } MNP_INSTANCE_DATA;
 
 typedef struct {
@@ -94,6 +106,7 @@ typedef struct {
   LIST_ENTRY    WrapEntry;            // Link to FreeTxBufList
   LIST_ENTRY    AllEntry;             // Link to AllTxBufList
   BOOLEAN       InUse;
+  BOOLEAN       Large;                // Allocated for one large send, freed on recycle
   UINT8         TxBuf[1];
 } MNP_TX_BUF_WRAP;
 
@@ -326,6 +339,8 @@ MnpGroupOp (
 
   @param[in]  Instance            Pointer to the Mnp instance context data.
   @param[in]  Token               Pointer to the transmit token to check.
+  @param[in]  MaxDataLength       The largest DataLength accepted, the MTU unless
+                                  segmentation offload is requested.
 
   @return The Token is valid or not.
 
@@ -333,7 +348,8 @@ MnpGroupOp (
 BOOLEAN
 MnpIsValidTxToken (
   IN MNP_INSTANCE_DATA                     *Instance,
-  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token,
+  IN UINT32                                MaxDataLength
   );
 
 /**
@@ -369,6 +385,7 @@ MnpBuildTxPacket (
   @param[in]       Packet              Pointer to the packet buffer.
   @param[in]       Length              The length of the packet.
   @param[in, out]  Token               Pointer to the token the packet generated from.
+  @param[in]       TxInfo              Optional offload requested for the packet.
 
   @retval EFI_SUCCESS                  The packet is sent out.
   @retval EFI_TIMEOUT                  Time out occurs, the packet isn't sent.
@@ -380,7 +397,8 @@ MnpSyncSendPacket (
   IN     MNP_SERVICE_DATA                      *MnpServiceData,
   IN     UINT8                                 *Packet,
   IN     UINT32                                Length,
-  IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token,
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO         *TxInfo OPTIONAL
   );
 
 /**
@@ -430,6 +448,26 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Drain the SNP receive queue, delivering up to Budget packets.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             Optional, the number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePacketBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINTN            Budget,
+  OUT    UINTN            *Received OPTIONAL
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
@@ -475,6 +513,36 @@ MnpAllocTxBuf (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Allocate a TX buffer for a single large send that doesn't fit in the
+  buffers of the FreeTxBufList. The buffer is released back to the pool
+  instead of the FreeTxBufList when it's recycled.
+
+  @param[in, out]  MnpDeviceData        Pointer to the MNP_DEVICE_DATA.
+  @param[in]       Length               The length of the buffer.
+
+  @return     Pointer to the allocated buffer, if NULL the operation is failed.
+
+**/
+UINT8 *
+MnpAllocLargeTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Length
+  );
+
+/**
+  Try to reclaim the TX buffer into the buffer pool.
+
+  @param[in, out]  MnpDeviceData         Pointer to the mnp device context data.
+  @param[in, out]  TxBuf                 Pointer to the TX buffer to free.
+
+**/
+VOID
+MnpFreeTxBuf (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN OUT UINT8            *TxBuf
+  );
+
 /**
   Try to recycle all the transmitted buffer address from SNP.
 
@@ -879,6 +947,51 @@ MnpPoll (
   IN EFI_MANAGED_NETWORK_PROTOCOL  *This
   );
 
+/**
+  Return the transmit offloads performed by the NIC below this MNP child.
+
+  @param[in]   This              Pointer to the EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware.
+  @param[out]  MaxLargeSendSize  Largest data length accepted with EDKII_NETWORK_OFFLOAD_TSO4.
+
+  @retval EFI_SUCCESS            The capabilities are returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpOffloadGetCapabilities (
+  IN  VOID    *This,
+  OUT UINT32  *Capabilities,
+  OUT UINT32  *MaxLargeSendSize
+  );
+
+/**
+  Places an outgoing data packet into the transmit queue, with checksum and
+  segmentation offload.
+
+  The offloads are passed to the NIC if it reports them, and are done in
+  software otherwise.
+
+  @param[in]  This              Pointer to the EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo            The offload requested for this packet.
+  @param[in]  Token             Pointer to a token associated with the transmit data descriptor.
+
+  @retval EFI_SUCCESS            The transmit completion token was cached.
+  @retval EFI_NOT_STARTED        This MNP child driver instance has not been configured.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES   The transmit data could not be queued due to a
+                                 lack of system resources (usually memory).
+
+**/
+EFI_STATUS
+EFIAPI
+MnpOffloadTransmit (
+  IN EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO           *TxInfo,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN    *Token
+  );
+
 /**
   Configure the Snp receive filters according to the instances' receive filter
   settings.
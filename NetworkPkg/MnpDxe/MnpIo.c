@@ -14,6 +14,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
   @param[in]  Instance            Pointer to the Mnp instance context data.
   @param[in]  Token               Pointer to the transmit token to check.
+  @param[in]  MaxDataLength       The largest DataLength accepted, the MTU unless
+                                  segmentation offload is requested.
 
   @return The Token is valid or not.
 
@@ -21,7 +23,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 BOOLEAN
 MnpIsValidTxToken (
   IN MNP_INSTANCE_DATA                     *Instance,
-  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token,
+  IN UINT32                                MaxDataLength
   )
 {
   MNP_SERVICE_DATA                   *MnpServiceData;
@@ -83,7 +86,7 @@ MnpIsValidTxToken (
     return FALSE;
   }
 
-  if (TxData->DataLength > MnpServiceData->Mtu) {
+  if (TxData->DataLength > MaxDataLength) {
     //
     // The total length is larger than the MTU.
     //
@@ -121,10 +124,25 @@ MnpBuildTxPacket (
   UINT16                   Index;
   MNP_DEVICE_DATA          *MnpDeviceData;
   UINT8                    *TxBuf;
+  UINT32                   TxBufLength;
 
   MnpDeviceData = MnpServiceData->MnpDeviceData;
 
-  TxBuf = MnpAllocTxBuf (MnpDeviceData);
+  //
+  // Only a large send with segmentation offload can exceed the size of the
+  // pooled TX buffers, it gets a buffer of its own.
+  //
+  TxBufLength = NET_VLAN_TAG_LEN + TxData->HeaderLength + TxData->DataLength;
+  if (TxData->DestinationAddress != NULL) {
+    TxBufLength += MnpDeviceData->Snp->Mode->MediaHeaderSize;
+  }
+
+  if (TxBufLength > MnpDeviceData->BufferLength) {
+    TxBuf = MnpAllocLargeTxBuf (MnpDeviceData, TxBufLength);
+  } else {
+    TxBuf = MnpAllocTxBuf (MnpDeviceData);
+  }
+
   if (TxBuf == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -185,6 +203,192 @@ MnpBuildTxPacket (
   return EFI_SUCCESS;
 }
 
+///
+/// Arguments of an offloaded send, replayed for every segment built by
+/// NetLibOffloadFrame() when the NIC can't do the offload itself.
+///
+typedef struct {
+  MNP_DEVICE_DATA                      *MnpDeviceData;
+  UINT32                               HeaderSize;
+  EFI_MANAGED_NETWORK_TRANSMIT_DATA    *TxData;
+  UINT16                               *ProtocolType;
+} MNP_OFFLOAD_CONTEXT;
+
+/**
+  Copy one frame built by NetLibOffloadFrame() to a TX buffer and hand it
+  to the SNP.
+
+  @param[in]  Context       Pointer to the MNP_OFFLOAD_CONTEXT.
+  @param[in]  Frame         Pointer to the frame.
+  @param[in]  FrameLength   Length of the frame, in bytes.
+
+  @retval EFI_SUCCESS           The frame is placed on the SNP transmit queue.
+  @retval EFI_BAD_BUFFER_SIZE   The frame doesn't fit in a TX buffer.
+  @retval EFI_OUT_OF_RESOURCES  No TX buffer is available.
+  @retval Others                The error returned by the SNP.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MnpSendOffloadSegment (
+  IN VOID    *Context,
+  IN UINT8   *Frame,
+  IN UINT32  FrameLength
+  )
+{
+  MNP_OFFLOAD_CONTEXT          *Offload;
+  MNP_DEVICE_DATA              *MnpDeviceData;
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  UINT8                        *TxBuf;
+  EFI_STATUS                   Status;
+
+  Offload       = (MNP_OFFLOAD_CONTEXT *)Context;
+  MnpDeviceData = Offload->MnpDeviceData;
+  Snp           = MnpDeviceData->Snp;
+
+  if (FrameLength > MnpDeviceData->BufferLength) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  TxBuf = MnpAllocTxBuf (MnpDeviceData);
+  if (TxBuf == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (TxBuf, Frame, FrameLength);
+
+  Status = Snp->Transmit (
+                  Snp,
+                  Offload->HeaderSize,
+                  FrameLength,
+                  TxBuf,
+                  Offload->TxData->SourceAddress,
+                  Offload->TxData->DestinationAddress,
+                  Offload->ProtocolType
+                  );
+  if (Status == EFI_NOT_READY) {
+    Status = MnpRecycleTxBuf (MnpDeviceData);
+    if (!EFI_ERROR (Status)) {
+      Status = Snp->Transmit (
+                      Snp,
+                      Offload->HeaderSize,
+                      FrameLength,
+                      TxBuf,
+                      Offload->TxData->SourceAddress,
+                      Offload->TxData->DestinationAddress,
+                      Offload->ProtocolType
+                      );
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    MnpFreeTxBuf (MnpDeviceData, TxBuf);
+  }
+
+  return Status;
+}
+
+/**
+  Send out a packet with the requested transmit offloads.
+
+  The packet is handed to the NIC in one piece if it reports all the
+  requested offloads. Otherwise the offloads are done in software, and the
+  resulting frames are sent through the SNP one by one.
+
+  @param[in]  MnpServiceData      Pointer to the mnp service context data.
+  @param[in]  TxInfo              The offload requested, HeaderOffset relative to
+                                  the end of the media header.
+  @param[in]  HeaderSize          The media header size to be filled by the SNP.
+  @param[in]  Packet              Pointer to the packet buffer, starting with the
+                                  media header.
+  @param[in]  Length              The length of the packet.
+  @param[in]  TxData              Pointer to the transmit data of the packet.
+  @param[in]  ProtocolType        Pointer to the protocol type of the media header.
+
+  @retval EFI_SUCCESS             The packet is sent out.
+  @retval Others                  The packet, or a part of it, isn't sent.
+
+**/
+STATIC
+EFI_STATUS
+MnpSendOffloadPacket (
+  IN MNP_SERVICE_DATA                   *MnpServiceData,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO      *TxInfo,
+  IN UINT32                             HeaderSize,
+  IN UINT8                              *Packet,
+  IN UINT32                             Length,
+  IN EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData,
+  IN UINT16                             *ProtocolType
+  )
+{
+  EFI_STATUS                             Status;
+  MNP_DEVICE_DATA                        *MnpDeviceData;
+  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *SnpOffload;
+  EDKII_NETWORK_OFFLOAD_TX_INFO          FrameInfo;
+  MNP_OFFLOAD_CONTEXT                    Offload;
+  UINT32                                 MediaHeaderSize;
+
+  MnpDeviceData   = MnpServiceData->MnpDeviceData;
+  SnpOffload      = MnpDeviceData->SnpOffload;
+  MediaHeaderSize = MnpDeviceData->Snp->Mode->MediaHeaderSize;
+  if (MnpServiceData->VlanId != 0) {
+    MediaHeaderSize += NET_VLAN_TAG_LEN;
+  }
+
+  CopyMem (&FrameInfo, TxInfo, sizeof (FrameInfo));
+  FrameInfo.HeaderOffset = (UINT16)(TxInfo->HeaderOffset + MediaHeaderSize);
+
+  if ((SnpOffload != NULL) &&
+      ((FrameInfo.Flags & ~SnpOffload->Capabilities) == 0) &&
+      (Length <= SnpOffload->MaxLargeSendSize + MediaHeaderSize))
+  {
+    Status = SnpOffload->Transmit (
+                           SnpOffload,
+                           &FrameInfo,
+                           HeaderSize,
+                           Length,
+                           Packet,
+                           TxData->SourceAddress,
+                           TxData->DestinationAddress,
+                           ProtocolType
+                           );
+    if (Status == EFI_NOT_READY) {
+      Status = MnpRecycleTxBuf (MnpDeviceData);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Status = SnpOffload->Transmit (
+                             SnpOffload,
+                             &FrameInfo,
+                             HeaderSize,
+                             Length,
+                             Packet,
+                             TxData->SourceAddress,
+                             TxData->DestinationAddress,
+                             ProtocolType
+                             );
+    }
+
+    return Status;
+  }
+
+  //
+  // Software fallback. The segments are copied to TX buffers of their own,
+  // so the packet buffer is never handed to the SNP and can be freed here.
+  //
+  Offload.MnpDeviceData = MnpDeviceData;
+  Offload.HeaderSize    = HeaderSize;
+  Offload.TxData        = TxData;
+  Offload.ProtocolType  = ProtocolType;
+
+  Status = NetLibOffloadFrame (&FrameInfo, Packet, Length, MnpSendOffloadSegment, &Offload);
+  MnpFreeTxBuf (MnpDeviceData, Packet);
+
+  return Status;
+}
+
 /**
   Synchronously send out the packet.
 
@@ -196,6 +400,7 @@ MnpBuildTxPacket (
   @param[in]       Packet              Pointer to the packet buffer.
   @param[in]       Length              The length of the packet.
   @param[in, out]  Token               Pointer to the token the packet generated from.
+  @param[in]       TxInfo              Optional offload requested for the packet.
 
   @retval EFI_SUCCESS                  The packet is sent out.
   @retval EFI_TIMEOUT                  Time out occurs, the packet isn't sent.
@@ -207,7 +412,8 @@ MnpSyncSendPacket (
   IN     MNP_SERVICE_DATA                      *MnpServiceData,
   IN     UINT8                                 *Packet,
   IN     UINT32                                Length,
-  IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
+  IN OUT EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token,
+  IN     EDKII_NETWORK_OFFLOAD_TX_INFO         *TxInfo OPTIONAL
   )
 {
   EFI_STATUS                         Status;
@@ -245,6 +451,15 @@ MnpSyncSendPacket (
     ProtocolType = TxData->ProtocolType;
   }
 
+  if ((TxInfo != NULL) && ((TxInfo->Flags & EDKII_NETWORK_OFFLOAD_TX_MASK) != 0)) {
+    Status = MnpSendOffloadPacket (MnpServiceData, TxInfo, HeaderSize, Packet, Length, TxData, &ProtocolType);
+    if (EFI_ERROR (Status)) {
+      Token->Status = EFI_DEVICE_ERROR;
+    }
+
+    goto SIGNAL_TOKEN;
+  }
+
   //
   // Transmit the packet through SNP.
   //
@@ -481,6 +696,7 @@ MnpQueueRcvdPacket (
   //
   if (Instance->RcvdPacketQueueSize == MNP_MAX_RCVD_PACKET_QUE_SIZE) {
     DEBUG ((DEBUG_WARN, "MnpQueueRcvdPacket: Drop one packet bcz queue size limit reached.\n"));
+    Instance->MnpServiceData->MnpDeviceData->RxStats.DropQueueFull++;
 
     //
     // Get the oldest packet.
@@ -860,6 +1076,7 @@ MnpReceivePacket (
       //
       // No available buffer in the buffer pool.
       //
+      MnpDeviceData->RxStats.DropNoBuffer++;
       return EFI_DEVICE_ERROR;
     }
 
@@ -887,6 +1104,10 @@ MnpReceivePacket (
 
     DEBUG_CODE_END ();
 
+    if (Status == EFI_DEVICE_ERROR) {
+      MnpDeviceData->RxStats.DropDeviceError++;
+    }
+
     return Status;
   }
 
@@ -900,9 +1121,12 @@ MnpReceivePacket (
        HeaderSize,
        BufLen)
       );
+    MnpDeviceData->RxStats.DropSizeError++;
     return EFI_DEVICE_ERROR;
   }
 
+  MnpDeviceData->RxStats.RxPackets++;
+
   Trimmed = 0;
   if (Nbuf->TotalSize != BufLen) {
     //
@@ -935,6 +1159,7 @@ MnpReceivePacket (
       NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD);
     }
 
+    MnpDeviceData->RxStats.DropNoVlan++;
     goto EXIT;
   }
 
@@ -962,6 +1187,7 @@ MnpReceivePacket (
     //
     // No receiver for this packet.
     //
+    MnpDeviceData->RxStats.DropNoReceiver++;
     if (Trimmed > 0) {
       NetbufAllocSpace (Nbuf, Trimmed, NET_BUF_TAIL);
     }
@@ -985,6 +1211,66 @@ EXIT:
   return Status;
 }
 
+/**
+  Drain the SNP receive queue, delivering up to Budget packets.
+
+  Pulling several packets per poll lets a busy NIC be emptied in one timer
+  tick instead of one packet per MNP_SYS_POLL_INTERVAL.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             Optional, the number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet was received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePacketBatch (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINTN            Budget,
+  OUT    UINTN            *Received OPTIONAL
+  )
+{
+  EFI_STATUS         Status;
+  UINTN              Count;
+  MNP_RX_STATISTICS  *Stats;
+
+  NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
+
+  Stats  = &MnpDeviceData->RxStats;
+  Status = EFI_NOT_READY;
+  Count  = 0;
+
+  while (Count < Budget) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Count++;
+  }
+
+  Stats->PollCount++;
+  if (Count == 0) {
+    Stats->EmptyPollCount++;
+  } else if (Count == Budget) {
+    Stats->BudgetExhausted++;
+  }
+
+  if (Count > Stats->MaxPacketsPerPoll) {
+    Stats->MaxPacketsPerPoll = (UINT32)Count;
+  }
+
+  if (Received != NULL) {
+    *Received = Count;
+  }
+
+  return (Count > 0) ? EFI_SUCCESS : Status;
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1099,6 +1385,8 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINTN            Received;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
@@ -1106,10 +1394,35 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  MnpReceivePacketBatch (MnpDeviceData, MNP_RX_BATCH_BUDGET, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  //
+  // Adapt the poll rate: switch to the fast interval as soon as traffic shows
+  // up (e.g. TCP data in flight), and fall back to the normal interval once
+  // the link has been idle for a few polls.
+  //
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  Interval = MnpDeviceData->PollInterval;
+  if (Received > 0) {
+    MnpDeviceData->IdlePollCount = 0;
+    Interval                     = MNP_SYS_POLL_FAST_INTERVAL;
+  } else if (MnpDeviceData->IdlePollCount < MNP_SYS_POLL_IDLE_THRESHOLD) {
+    MnpDeviceData->IdlePollCount++;
+  } else {
+    Interval = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if (Interval != MnpDeviceData->PollInterval) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
 }
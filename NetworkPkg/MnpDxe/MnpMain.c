@@ -530,7 +530,7 @@ MnpTransmit (
     goto ON_EXIT;
   }
 
-  if (!MnpIsValidTxToken (Instance, Token)) {
+  if (!MnpIsValidTxToken (Instance, Token, Instance->MnpServiceData->Mtu)) {
     //
     // The Token is invalid.
     //
@@ -552,7 +552,7 @@ MnpTransmit (
   //
   //  OK, send the packet synchronously.
   //
-  Status = MnpSyncSendPacket (MnpServiceData, PktBuf, PktLen, Token);
+  Status = MnpSyncSendPacket (MnpServiceData, PktBuf, PktLen, Token, NULL);
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -773,7 +773,11 @@ MnpPoll (
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePacketBatch (
+             Instance->MnpServiceData->MnpDeviceData,
+             MNP_RX_BATCH_BUDGET,
+             NULL
+             );
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -785,3 +789,127 @@ ON_EXIT:
 
   return Status;
 }
+
+/**
+  Return the offloads performed by the network device below this MNP child.
+
+  @param[in]   This              Pointer to the EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[out]  Capabilities      Bitmask of EDKII_NETWORK_OFFLOAD_* done in hardware.
+  @param[out]  MaxLargeSendSize  Largest DataLength accepted with EDKII_NETWORK_OFFLOAD_TSO4
+                                 by the hardware. Zero if TSO isn't supported.
+
+  @retval EFI_SUCCESS            The capabilities are returned.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpOffloadGetCapabilities (
+  IN  VOID    *This,
+  OUT UINT32  *Capabilities,
+  OUT UINT32  *MaxLargeSendSize
+  )
+{
+  MNP_INSTANCE_DATA                      *Instance;
+  EDKII_SIMPLE_NETWORK_OFFLOAD_PROTOCOL  *SnpOffload;
+
+  if ((This == NULL) || (Capabilities == NULL) || (MaxLargeSendSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance   = MNP_INSTANCE_DATA_FROM_OFFLOAD_THIS ((EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL *)This);
+  SnpOffload = Instance->MnpServiceData->MnpDeviceData->SnpOffload;
+
+  if (SnpOffload == NULL) {
+    *Capabilities     = 0;
+    *MaxLargeSendSize = 0;
+    return EFI_SUCCESS;
+  }
+
+  *Capabilities     = SnpOffload->Capabilities;
+  *MaxLargeSendSize = 0;
+  if ((SnpOffload->Capabilities & EDKII_NETWORK_OFFLOAD_TSO4) != 0) {
+    *MaxLargeSendSize = MIN (SnpOffload->MaxLargeSendSize, MAX_UINT16);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Places an outgoing data packet into the transmit queue with offload.
+
+  Same as MnpTransmit(), except that the offloads requested in TxInfo are
+  performed on the packet, by the network device if it reports them, in
+  software otherwise. With EDKII_NETWORK_OFFLOAD_TSO4, DataLength may exceed
+  the MTU, up to the largest IPv4 packet.
+
+  @param[in]  This    Pointer to the EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL instance.
+  @param[in]  TxInfo  The offload requested for this packet.
+  @param[in]  Token   Pointer to a token associated with the transmit data
+                      descriptor.
+
+  @retval EFI_SUCCESS            The transmit completion token was cached.
+  @retval EFI_NOT_STARTED        This MNP child driver instance has not been
+                                 configured.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are NULL, an unknown
+                                 offload is requested, or the token is invalid
+                                 as defined by MnpTransmit().
+  @retval Others                 As MnpTransmit().
+
+**/
+EFI_STATUS
+EFIAPI
+MnpOffloadTransmit (
+  IN EDKII_MANAGED_NETWORK_OFFLOAD_PROTOCOL  *This,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO           *TxInfo,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN    *Token
+  )
+{
+  EFI_STATUS         Status;
+  MNP_INSTANCE_DATA  *Instance;
+  MNP_SERVICE_DATA   *MnpServiceData;
+  UINT8              *PktBuf;
+  UINT32             PktLen;
+  UINT32             MaxDataLength;
+  EFI_TPL            OldTpl;
+
+  if ((This == NULL) || (TxInfo == NULL) || (Token == NULL) ||
+      ((TxInfo->Flags & ~EDKII_NETWORK_OFFLOAD_TX_MASK) != 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance = MNP_INSTANCE_DATA_FROM_OFFLOAD_THIS (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (!Instance->Configured) {
+    Status = EFI_NOT_STARTED;
+    goto ON_EXIT;
+  }
+
+  MnpServiceData = Instance->MnpServiceData;
+  NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
+
+  MaxDataLength = MnpServiceData->Mtu;
+  if ((TxInfo->Flags & EDKII_NETWORK_OFFLOAD_TSO4) != 0) {
+    MaxDataLength = MAX_UINT16;
+  }
+
+  if (!MnpIsValidTxToken (Instance, Token, MaxDataLength)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = MnpBuildTxPacket (MnpServiceData, Token->Packet.TxData, &PktBuf, &PktLen);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = MnpSyncSendPacket (MnpServiceData, PktBuf, PktLen, Token, TxInfo);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
@@ -301,7 +301,7 @@ TcpFlushPcb (
   Sock = Tcb->Sk;
 
   if (SOCK_IS_CONFIGURED (Sock)) {
-    RemoveEntryList (&Tcb->List);
+    TcpRemoveTcb (Tcb);
 
     if (Sock->DevicePath != NULL) {
       //
@@ -389,6 +389,7 @@ TcpAttachPcb (
   }
 
   InitializeListHead (&Tcb->List);
+  InitializeListHead (&Tcb->HashLink);
   InitializeListHead (&Tcb->SndQue);
   InitializeListHead (&Tcb->RcvQue);
 
@@ -451,6 +452,8 @@ TcpConfigurePcb (
   TCP_PROTO_DATA        *TcpProto;
   TCP_CB                *Tcb;
   TCP_ACCESS_POINT      *TcpAp;
+  UINT32                Capabilities;
+  UINT32                MaxLargeSendSize;
 
   ASSERT ((CfgData != NULL) && (Sk != NULL) && (Sk->SockHandle != NULL));
 
@@ -503,6 +506,26 @@ TcpConfigurePcb (
     goto OnExit;
   }
 
+  //
+  // Use the checksum and segmentation offload of the device, if any. TSO
+  // is only used along with the TCP checksum offload.
+  //
+  Tcb->TxOffload  = 0;
+  Tcb->TsoMaxSize = 0;
+
+  if ((Sk->IpVersion == IP_VERSION_4) &&
+      !EFI_ERROR (IpIoGetOffloadCapabilities (Tcb->IpInfo, &Capabilities, &MaxLargeSendSize)))
+  {
+    Tcb->TxOffload = Capabilities & EDKII_NETWORK_OFFLOAD_TCP4_CSUM;
+
+    if ((Tcb->TxOffload != 0) && ((Capabilities & EDKII_NETWORK_OFFLOAD_TSO4) != 0) &&
+        (MaxLargeSendSize > TCP_TSO_MAX_HEAD))
+    {
+      Tcb->TxOffload |= EDKII_NETWORK_OFFLOAD_TSO4;
+      Tcb->TsoMaxSize = MaxLargeSendSize;
+    }
+  }
+
   if (Sk->IpVersion == IP_VERSION_4) {
     //
     // Get the default address information if the instance is configured to use default address.
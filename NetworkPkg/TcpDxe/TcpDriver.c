@@ -165,6 +165,8 @@ TcpDriverEntryPoint (
   EFI_STATUS  Status;
   UINT32      Seed;
 
+  TcpHashInit ();
+
   //
   // Install the TCP Driver Binding Protocol
   //
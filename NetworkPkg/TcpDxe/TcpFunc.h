@@ -77,44 +77,6 @@ TcpFindTcbByPeer (
   IN UINT8           Version
   );
 
-/**
-  Locate the TCP_CB related to the socket pair.
-
-  @param[in]  LocalPort      The local port number.
-  @param[in]  LocalIp        The local IP address.
-  @param[in]  RemotePort     The remote port number.
-  @param[in]  RemoteIp       The remote IP address.
-  @param[in]  Version        IP_VERSION_4 indicates TCP is running on IP4 stack,
-                             IP_VERSION_6 indicates TCP is running on IP6 stack.
-  @param[in]  Syn            If TRUE, the listen sockets are searched.
-
-  @return Pointer to the related TCP_CB. If NULL, no match is found.
-
-**/
-TCP_CB *
-TcpLocateTcb (
-  IN TCP_PORTNO      LocalPort,
-  IN EFI_IP_ADDRESS  *LocalIp,
-  IN TCP_PORTNO      RemotePort,
-  IN EFI_IP_ADDRESS  *RemoteIp,
-  IN UINT8           Version,
-  IN BOOLEAN         Syn
-  );
-
-/**
-  Insert a Tcb into the proper queue.
-
-  @param[in]  Tcb               Pointer to the TCP_CB to be inserted.
-
-  @retval 0                     The Tcb was inserted successfully.
-  @retval -1                    An error condition occurred.
-
-**/
-INTN
-TcpInsertTcb (
-  IN TCP_CB  *Tcb
-  );
-
 /**
   Clone a TCP_CB from Tcb.
 
@@ -284,6 +246,137 @@ TcpInstallDevicePath (
   IN SOCKET  *Sock
   );
 
+//
+// Functions in TcpHash.c
+//
+
+/**
+  Initialize the TCB hash tables. Called once, before any Tcb is inserted.
+
+**/
+VOID
+TcpHashInit (
+  VOID
+  );
+
+/**
+  Compute the hash bucket of a connection from its endpoints.
+
+  @param[in]  Local    Pointer to the local (IP, Port).
+  @param[in]  Remote   Pointer to the remote (IP, Port).
+  @param[in]  Version  IP_VERSION_4 or IP_VERSION_6.
+
+  @return The index of the bucket in mTcpRunHash.
+
+**/
+UINT32
+TcpHashPeers (
+  IN TCP_PEER  *Local,
+  IN TCP_PEER  *Remote,
+  IN UINT8     Version
+  );
+
+/**
+  Compute the hash bucket of a listening TCB from its local port.
+
+  @param[in]  Port     The local port, in network byte order.
+
+  @return The index of the bucket in mTcpListenHash.
+
+**/
+UINT32
+TcpHashPort (
+  IN TCP_PORTNO  Port
+  );
+
+/**
+  Check whether one IP address equals the other.
+
+  @param[in]   Ip1     Pointer to IP address to be checked.
+  @param[in]   Ip2     Pointer to IP address to be checked.
+  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
+                       IP_VERSION_6 indicates the IP address is an IPv6 address.
+
+  @retval      TRUE    Ip1 equals Ip2.
+  @retval      FALSE   Ip1 does not equal Ip2.
+
+**/
+BOOLEAN
+TcpIsIpEqual (
+  IN EFI_IP_ADDRESS  *Ip1,
+  IN EFI_IP_ADDRESS  *Ip2,
+  IN UINT8           Version
+  );
+
+/**
+  Check whether one IP address is filled with ZERO.
+
+  @param[in]   Ip      Pointer to the IP address to be checked.
+  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
+                       IP_VERSION_6 indicates the IP address is an IPv6 address.
+
+  @retval      TRUE    Ip is all zero address.
+  @retval      FALSE   Ip is not all zero address.
+
+**/
+BOOLEAN
+TcpIsIpZero (
+  IN EFI_IP_ADDRESS  *Ip,
+  IN UINT8           Version
+  );
+
+/**
+  Locate the TCP_CB related to the socket pair.
+
+  @param[in]  LocalPort      The local port number.
+  @param[in]  LocalIp        The local IP address.
+  @param[in]  RemotePort     The remote port number.
+  @param[in]  RemoteIp       The remote IP address.
+  @param[in]  Version        IP_VERSION_4 indicates TCP is running on IP4 stack,
+                             IP_VERSION_6 indicates TCP is running on IP6 stack.
+  @param[in]  Syn            If TRUE, the listen sockets are searched.
+
+  @return Pointer to the related TCP_CB. If NULL, no match is found.
+
+**/
+TCP_CB *
+TcpLocateTcb (
+  IN TCP_PORTNO      LocalPort,
+  IN EFI_IP_ADDRESS  *LocalIp,
+  IN TCP_PORTNO      RemotePort,
+  IN EFI_IP_ADDRESS  *RemoteIp,
+  IN UINT8           Version,
+  IN BOOLEAN         Syn
+  );
+
+/**
+  Insert a Tcb into the proper queue.
+
+  @param[in]  Tcb               Pointer to the TCP_CB to be inserted.
+
+  @retval 0                     The Tcb was inserted successfully.
+  @retval -1                    An error condition occurred.
+
+**/
+INTN
+TcpInsertTcb (
+  IN TCP_CB  *Tcb
+  );
+
+/**
+  Remove a Tcb from its queue and hash bucket.
+
+  The endpoints of the Tcb must not have changed since TcpInsertTcb().
+  Removing a Tcb that isn't on any queue is harmless.
+
+  @param[in]  Tcb               Pointer to the TCP_CB to be removed.
+
+**/
+VOID
+TcpRemoveTcb (
+  IN TCP_CB  *Tcb
+  );
+
 //
 // Functions in TcpOutput.c
 //
@@ -646,6 +739,7 @@ TcpTxCallback (
   @param[in]  Src                Source address of the TCP segment.
   @param[in]  Dest               Destination address of the TCP segment.
   @param[in]  Version            IP_VERSION_4 or IP_VERSION_6
+  @param[in]  TxInfo             Optional offload requested for the segment.
 
   @retval 0                      The segment was sent out successfully.
   @retval -1                     The segment failed to be sent.
@@ -653,11 +747,12 @@ TcpTxCallback (
 **/
 INTN
 TcpSendIpPacket (
-  IN TCP_CB          *Tcb,
-  IN NET_BUF         *Nbuf,
-  IN EFI_IP_ADDRESS  *Src,
-  IN EFI_IP_ADDRESS  *Dest,
-  IN UINT8           Version
+  IN TCP_CB                         *Tcb,
+  IN NET_BUF                        *Nbuf,
+  IN EFI_IP_ADDRESS                 *Src,
+  IN EFI_IP_ADDRESS                 *Dest,
+  IN UINT8                          Version,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo  OPTIONAL
   );
 
 /**
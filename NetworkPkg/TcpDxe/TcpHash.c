@@ -0,0 +1,392 @@
+/** @file
+  TCB queues and the hash tables used to demultiplex incoming segments.
+
+  Every TCB on mTcpRunQue is also linked in mTcpRunHash, hashed on its
+  4-tuple, and every TCB on mTcpListenQue in mTcpListenHash, hashed on its
+  local port. The queues are kept for the timer and for the port lookups
+  that aren't performance sensitive.
+
+  Copyright (c) 2009 - 2017, Intel Corporation. All rights reserved.<BR>
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+LIST_ENTRY  mTcpRunQue = {
+  &mTcpRunQue,
+  &mTcpRunQue
+};
+
+LIST_ENTRY  mTcpListenQue = {
+  &mTcpListenQue,
+  &mTcpListenQue
+};
+
+LIST_ENTRY  mTcpRunHash[TCP_HASH_SIZE];
+LIST_ENTRY  mTcpListenHash[TCP_HASH_SIZE];
+
+//
+// The TCB that received the last segment. Consecutive segments mostly
+// belong to the same connection.
+//
+TCP_CB  *mTcpLastHit = NULL;
+
+/**
+  Initialize the TCB hash tables. Called once, before any Tcb is inserted.
+
+**/
+VOID
+TcpHashInit (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TCP_HASH_SIZE; Index++) {
+    InitializeListHead (&mTcpRunHash[Index]);
+    InitializeListHead (&mTcpListenHash[Index]);
+  }
+
+  mTcpLastHit = NULL;
+}
+
+/**
+  Compute the hash bucket of a connection from its endpoints.
+
+  @param[in]  Local    Pointer to the local (IP, Port).
+  @param[in]  Remote   Pointer to the remote (IP, Port).
+  @param[in]  Version  IP_VERSION_4 or IP_VERSION_6.
+
+  @return The index of the bucket in mTcpRunHash.
+
+**/
+UINT32
+TcpHashPeers (
+  IN TCP_PEER  *Local,
+  IN TCP_PEER  *Remote,
+  IN UINT8     Version
+  )
+{
+  UINT32  Hash;
+  UINTN   Words;
+  UINTN   Index;
+
+  Hash  = ((UINT32)Local->Port << 16) | Remote->Port;
+  Words = (Version == IP_VERSION_4) ? 1 : 4;
+
+  for (Index = 0; Index < Words; Index++) {
+    Hash = (Hash * TCP_HASH_MULTIPLIER) ^ Local->Ip.Addr[Index];
+    Hash = (Hash * TCP_HASH_MULTIPLIER) ^ Remote->Ip.Addr[Index];
+  }
+
+  return (Hash * TCP_HASH_MULTIPLIER) >> (32 - TCP_HASH_BITS);
+}
+
+/**
+  Compute the hash bucket of a listening TCB from its local port.
+
+  @param[in]  Port     The local port, in network byte order.
+
+  @return The index of the bucket in mTcpListenHash.
+
+**/
+UINT32
+TcpHashPort (
+  IN TCP_PORTNO  Port
+  )
+{
+  return ((UINT32)Port * TCP_HASH_MULTIPLIER) >> (32 - TCP_HASH_BITS);
+}
+
+/**
+  Check whether one IP address equals the other.
+
+  @param[in]   Ip1     Pointer to IP address to be checked.
+  @param[in]   Ip2     Pointer to IP address to be checked.
+  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
+                       IP_VERSION_6 indicates the IP address is an IPv6 address.
+
+  @retval      TRUE    Ip1 equals Ip2.
+  @retval      FALSE   Ip1 does not equal Ip2.
+
+**/
+BOOLEAN
+TcpIsIpEqual (
+  IN EFI_IP_ADDRESS  *Ip1,
+  IN EFI_IP_ADDRESS  *Ip2,
+  IN UINT8           Version
+  )
+{
+  ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
+
+  if (Version == IP_VERSION_4) {
+    return (BOOLEAN)(Ip1->Addr[0] == Ip2->Addr[0]);
+  } else {
+    return (BOOLEAN)EFI_IP6_EQUAL (&Ip1->v6, &Ip2->v6);
+  }
+}
+
+/**
+  Check whether one IP address is filled with ZERO.
+
+  @param[in]   Ip      Pointer to the IP address to be checked.
+  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
+                       IP_VERSION_6 indicates the IP address is an IPv6 address.
+
+  @retval      TRUE    Ip is all zero address.
+  @retval      FALSE   Ip is not all zero address.
+
+**/
+BOOLEAN
+TcpIsIpZero (
+  IN EFI_IP_ADDRESS  *Ip,
+  IN UINT8           Version
+  )
+{
+  ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
+
+  if (Version == IP_VERSION_4) {
+    return (BOOLEAN)(Ip->Addr[0] == 0);
+  } else {
+    return (BOOLEAN)((Ip->Addr[0] == 0) && (Ip->Addr[1] == 0) &&
+                     (Ip->Addr[2] == 0) && (Ip->Addr[3] == 0));
+  }
+}
+
+/**
+  Locate a listen TCB that matchs the Local and Remote.
+
+  @param[in]  Local    Pointer to the local (IP, Port).
+  @param[in]  Remote   Pointer to the remote (IP, Port).
+  @param[in]  Version  IP_VERSION_4 indicates TCP is running on IP4 stack,
+                       IP_VERSION_6 indicates TCP is running on IP6 stack.
+
+  @return  Pointer to the TCP_CB with the least number of wildcards,
+           if NULL no match is found.
+
+**/
+TCP_CB *
+TcpLocateListenTcb (
+  IN TCP_PEER  *Local,
+  IN TCP_PEER  *Remote,
+  IN UINT8     Version
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_CB      *Node;
+  TCP_CB      *Match;
+  INTN        Last;
+  INTN        Cur;
+
+  Last  = 4;
+  Match = NULL;
+
+  //
+  // The local port is never a wildcard, only the listeners on
+  // that port need to be checked.
+  //
+  NET_LIST_FOR_EACH (Entry, &mTcpListenHash[TcpHashPort (Local->Port)]) {
+    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashLink);
+
+    if ((Version != Node->Sk->IpVersion) ||
+        (Local->Port != Node->LocalEnd.Port) ||
+        !TCP_PEER_MATCH (Remote, &Node->RemoteEnd, Version) ||
+        !TCP_PEER_MATCH (Local, &Node->LocalEnd, Version)
+        )
+    {
+      continue;
+    }
+
+    //
+    // Compute the number of wildcard
+    //
+    Cur = 0;
+    if (TcpIsIpZero (&Node->RemoteEnd.Ip, Version)) {
+      Cur++;
+    }
+
+    if (Node->RemoteEnd.Port == 0) {
+      Cur++;
+    }
+
+    if (TcpIsIpZero (&Node->LocalEnd.Ip, Version)) {
+      Cur++;
+    }
+
+    if (Cur < Last) {
+      if (Cur == 0) {
+        return Node;
+      }
+
+      Last  = Cur;
+      Match = Node;
+    }
+  }
+
+  return Match;
+}
+
+/**
+  Locate the TCP_CB related to the socket pair.
+
+  @param[in]  LocalPort      The local port number.
+  @param[in]  LocalIp        The local IP address.
+  @param[in]  RemotePort     The remote port number.
+  @param[in]  RemoteIp       The remote IP address.
+  @param[in]  Version        IP_VERSION_4 indicates TCP is running on IP4 stack,
+                             IP_VERSION_6 indicates TCP is running on IP6 stack.
+  @param[in]  Syn            If TRUE, the listen sockets are searched.
+
+  @return Pointer to the related TCP_CB. If NULL, no match is found.
+
+**/
+TCP_CB *
+TcpLocateTcb (
+  IN TCP_PORTNO      LocalPort,
+  IN EFI_IP_ADDRESS  *LocalIp,
+  IN TCP_PORTNO      RemotePort,
+  IN EFI_IP_ADDRESS  *RemoteIp,
+  IN UINT8           Version,
+  IN BOOLEAN         Syn
+  )
+{
+  TCP_PEER    Local;
+  TCP_PEER    Remote;
+  LIST_ENTRY  *Entry;
+  TCP_CB      *Tcb;
+
+  Local.Port  = LocalPort;
+  Remote.Port = RemotePort;
+
+  CopyMem (&Local.Ip, LocalIp, sizeof (EFI_IP_ADDRESS));
+  CopyMem (&Remote.Ip, RemoteIp, sizeof (EFI_IP_ADDRESS));
+
+  //
+  // First check for exact match, starting with the connection that
+  // received the previous segment.
+  //
+  Tcb = mTcpLastHit;
+  if ((Tcb != NULL) &&
+      (Version == Tcb->Sk->IpVersion) &&
+      TCP_PEER_EQUAL (&Remote, &Tcb->RemoteEnd, Version) &&
+      TCP_PEER_EQUAL (&Local, &Tcb->LocalEnd, Version)
+      )
+  {
+    return Tcb;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &mTcpRunHash[TcpHashPeers (&Local, &Remote, Version)]) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashLink);
+
+    if ((Version == Tcb->Sk->IpVersion) &&
+        TCP_PEER_EQUAL (&Remote, &Tcb->RemoteEnd, Version) &&
+        TCP_PEER_EQUAL (&Local, &Tcb->LocalEnd, Version)
+        )
+    {
+      mTcpLastHit = Tcb;
+      return Tcb;
+    }
+  }
+
+  //
+  // Only check the listen queue when the SYN flag is on.
+  //
+  if (Syn) {
+    return TcpLocateListenTcb (&Local, &Remote, Version);
+  }
+
+  return NULL;
+}
+
+/**
+  Insert a Tcb into the proper queue.
+
+  @param[in]  Tcb               Pointer to the TCP_CB to be inserted.
+
+  @retval 0                     The Tcb was inserted successfully.
+  @retval -1                    Error condition occurred.
+
+**/
+INTN
+TcpInsertTcb (
+  IN TCP_CB  *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Head;
+  LIST_ENTRY  *Bucket;
+  TCP_CB      *Node;
+  UINT8       Version;
+
+  ASSERT (
+    (Tcb != NULL) &&
+    (
+     (Tcb->State == TCP_LISTEN) ||
+     (Tcb->State == TCP_SYN_SENT) ||
+     (Tcb->State == TCP_SYN_RCVD) ||
+     (Tcb->State == TCP_CLOSED)
+    )
+    );
+
+  if (Tcb->LocalEnd.Port == 0) {
+    return -1;
+  }
+
+  Version = Tcb->Sk->IpVersion;
+
+  if (Tcb->State == TCP_LISTEN) {
+    Head   = &mTcpListenQue;
+    Bucket = &mTcpListenHash[TcpHashPort (Tcb->LocalEnd.Port)];
+  } else {
+    Head   = &mTcpRunQue;
+    Bucket = &mTcpRunHash[TcpHashPeers (&Tcb->LocalEnd, &Tcb->RemoteEnd, Version)];
+  }
+
+  //
+  // Check that the Tcb isn't already on the list. A duplicate
+  // has the same endpoints, so it hashes to the same bucket.
+  //
+  NET_LIST_FOR_EACH (Entry, Bucket) {
+    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashLink);
+
+    if ((Version == Node->Sk->IpVersion) &&
+        TCP_PEER_EQUAL (&Tcb->LocalEnd, &Node->LocalEnd, Version) &&
+        TCP_PEER_EQUAL (&Tcb->RemoteEnd, &Node->RemoteEnd, Version)
+        )
+    {
+      return -1;
+    }
+  }
+
+  InsertHeadList (Head, &Tcb->List);
+  InsertHeadList (Bucket, &Tcb->HashLink);
+
+  return 0;
+}
+
+/**
+  Remove a Tcb from its queue and hash bucket.
+
+  The Tcb must have been inserted by TcpInsertTcb(), and its endpoints
+  must not have changed since.
+
+  @param[in]  Tcb               Pointer to the TCP_CB to be removed.
+
+**/
+VOID
+TcpRemoveTcb (
+  IN TCP_CB  *Tcb
+  )
+{
+  if (mTcpLastHit == Tcb) {
+    mTcpLastHit = NULL;
+  }
+
+  RemoveEntryList (&Tcb->List);
+  RemoveEntryList (&Tcb->HashLink);
+  InitializeListHead (&Tcb->List);
+  InitializeListHead (&Tcb->HashLink);
+}
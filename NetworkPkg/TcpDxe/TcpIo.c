@@ -86,6 +86,7 @@ TcpTxCallback (
   @param[in]  Src                Source address of the TCP segment.
   @param[in]  Dest               Destination address of the TCP segment.
   @param[in]  Version            IP_VERSION_4 or IP_VERSION_6
+  @param[in]  TxInfo             Optional offload requested for the segment.
 
   @retval 0                      The segment was sent out successfully.
   @retval -1                     The segment failed to send.
@@ -93,11 +94,12 @@ TcpTxCallback (
 **/
 INTN
 TcpSendIpPacket (
-  IN TCP_CB          *Tcb,
-  IN NET_BUF         *Nbuf,
-  IN EFI_IP_ADDRESS  *Src,
-  IN EFI_IP_ADDRESS  *Dest,
-  IN UINT8           Version
+  IN TCP_CB                         *Tcb,
+  IN NET_BUF                        *Nbuf,
+  IN EFI_IP_ADDRESS                 *Src,
+  IN EFI_IP_ADDRESS                 *Dest,
+  IN UINT8                          Version,
+  IN EDKII_NETWORK_OFFLOAD_TX_INFO  *TxInfo  OPTIONAL
   )
 {
   EFI_STATUS      Status;
@@ -158,7 +160,7 @@ TcpSendIpPacket (
     Override.Ip6OverrideData.FlowLabel = 0;
   }
 
-  Status = IpIoSend (IpIo, Nbuf, IpSender, NULL, Tcb, Dest, &Override);
+  Status = IpIoSendWithOffload (IpIo, Nbuf, IpSender, NULL, Tcb, Dest, &Override, TxInfo);
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "TcpSendIpPacket: return %r error\n", Status));
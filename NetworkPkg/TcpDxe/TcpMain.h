@@ -31,6 +31,9 @@ extern EFI_UNICODE_STRING_TABLE      *gTcpControllerNameTable;
 
 extern LIST_ENTRY  mTcpRunQue;
 extern LIST_ENTRY  mTcpListenQue;
+extern LIST_ENTRY  mTcpRunHash[TCP_HASH_SIZE];
+extern LIST_ENTRY  mTcpListenHash[TCP_HASH_SIZE];
+extern TCP_CB      *mTcpLastHit;
 extern TCP_SEQNO   mTcpGlobalIss;
 extern UINT32      mTcpTick;
 
@@ -10,16 +10,6 @@
 
 #include "TcpMain.h"
 
-LIST_ENTRY  mTcpRunQue = {
-  &mTcpRunQue,
-  &mTcpRunQue
-};
-
-LIST_ENTRY  mTcpListenQue = {
-  &mTcpListenQue,
-  &mTcpListenQue
-};
-
 TCP_SEQNO  mTcpGlobalIss = TCP_BASE_ISS;
 
 CHAR16  *mTcpStateName[] = {
@@ -162,130 +152,6 @@ TcpInitTcbPeer (
   }
 }
 
-/**
-  Check whether one IP address equals the other.
-
-  @param[in]   Ip1     Pointer to IP address to be checked.
-  @param[in]   Ip2     Pointer to IP address to be checked.
-  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
-                       IP_VERSION_6 indicates the IP address is an IPv6 address.
-
-  @retval      TRUE    Ip1 equals Ip2.
-  @retval      FALSE   Ip1 does not equal Ip2.
-
-**/
-BOOLEAN
-TcpIsIpEqual (
-  IN EFI_IP_ADDRESS  *Ip1,
-  IN EFI_IP_ADDRESS  *Ip2,
-  IN UINT8           Version
-  )
-{
-  ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
-
-  if (Version == IP_VERSION_4) {
-    return (BOOLEAN)(Ip1->Addr[0] == Ip2->Addr[0]);
-  } else {
-    return (BOOLEAN)EFI_IP6_EQUAL (&Ip1->v6, &Ip2->v6);
-  }
-}
-
-/**
-  Check whether one IP address is filled with ZERO.
-
-  @param[in]   Ip      Pointer to the IP address to be checked.
-  @param[in]   Version IP_VERSION_4 indicates the IP address is an IPv4 address,
-                       IP_VERSION_6 indicates the IP address is an IPv6 address.
-
-  @retval      TRUE    Ip is all zero address.
-  @retval      FALSE   Ip is not all zero address.
-
-**/
-BOOLEAN
-TcpIsIpZero (
-  IN EFI_IP_ADDRESS  *Ip,
-  IN UINT8           Version
-  )
-{
-  ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
-
-  if (Version == IP_VERSION_4) {
-    return (BOOLEAN)(Ip->Addr[0] == 0);
-  } else {
-    return (BOOLEAN)((Ip->Addr[0] == 0) && (Ip->Addr[1] == 0) &&
-                     (Ip->Addr[2] == 0) && (Ip->Addr[3] == 0));
-  }
-}
-
-/**
-  Locate a listen TCB that matchs the Local and Remote.
-
-  @param[in]  Local    Pointer to the local (IP, Port).
-  @param[in]  Remote   Pointer to the remote (IP, Port).
-  @param[in]  Version  IP_VERSION_4 indicates TCP is running on IP4 stack,
-                       IP_VERSION_6 indicates TCP is running on IP6 stack.
-
-  @return  Pointer to the TCP_CB with the least number of wildcards,
-           if NULL no match is found.
-
-**/
-TCP_CB *
-TcpLocateListenTcb (
-  IN TCP_PEER  *Local,
-  IN TCP_PEER  *Remote,
-  IN UINT8     Version
-  )
-{
-  LIST_ENTRY  *Entry;
-  TCP_CB      *Node;
-  TCP_CB      *Match;
-  INTN        Last;
-  INTN        Cur;
-
-  Last  = 4;
-  Match = NULL;
-
-  NET_LIST_FOR_EACH (Entry, &mTcpListenQue) {
-    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
-
-    if ((Version != Node->Sk->IpVersion) ||
-        (Local->Port != Node->LocalEnd.Port) ||
-        !TCP_PEER_MATCH (Remote, &Node->RemoteEnd, Version) ||
-        !TCP_PEER_MATCH (Local, &Node->LocalEnd, Version)
-        )
-    {
-      continue;
-    }
-
-    //
-    // Compute the number of wildcard
-    //
-    Cur = 0;
-    if (TcpIsIpZero (&Node->RemoteEnd.Ip, Version)) {
-      Cur++;
-    }
-
-    if (Node->RemoteEnd.Port == 0) {
-      Cur++;
-    }
-
-    if (TcpIsIpZero (&Node->LocalEnd.Ip, Version)) {
-      Cur++;
-    }
-
-    if (Cur < Last) {
-      if (Cur == 0) {
-        return Node;
-      }
-
-      Last  = Cur;
-      Match = Node;
-    }
-  }
-
-  return Match;
-}
-
 /**
   Try to find one Tcb whose <Ip, Port> equals to <IN Addr, IN Port>.
 
@@ -341,126 +207,6 @@ TcpFindTcbByPeer (
   return FALSE;
 }
 
-/**
-  Locate the TCP_CB related to the socket pair.
-
-  @param[in]  LocalPort      The local port number.
-  @param[in]  LocalIp        The local IP address.
-  @param[in]  RemotePort     The remote port number.
-  @param[in]  RemoteIp       The remote IP address.
-  @param[in]  Version        IP_VERSION_4 indicates TCP is running on IP4 stack,
-                             IP_VERSION_6 indicates TCP is running on IP6 stack.
-  @param[in]  Syn            If TRUE, the listen sockets are searched.
-
-  @return Pointer to the related TCP_CB. If NULL, no match is found.
-
-**/
-TCP_CB *
-TcpLocateTcb (
-  IN TCP_PORTNO      LocalPort,
-  IN EFI_IP_ADDRESS  *LocalIp,
-  IN TCP_PORTNO      RemotePort,
-  IN EFI_IP_ADDRESS  *RemoteIp,
-  IN UINT8           Version,
-  IN BOOLEAN         Syn
-  )
-{
-  TCP_PEER    Local;
-  TCP_PEER    Remote;
-  LIST_ENTRY  *Entry;
-  TCP_CB      *Tcb;
-
-  Local.Port  = LocalPort;
-  Remote.Port = RemotePort;
-
-  CopyMem (&Local.Ip, LocalIp, sizeof (EFI_IP_ADDRESS));
-  CopyMem (&Remote.Ip, RemoteIp, sizeof (EFI_IP_ADDRESS));
-
-  //
-  // First check for exact match.
-  //
-  NET_LIST_FOR_EACH (Entry, &mTcpRunQue) {
-    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
-
-    if ((Version == Tcb->Sk->IpVersion) &&
-        TCP_PEER_EQUAL (&Remote, &Tcb->RemoteEnd, Version) &&
-        TCP_PEER_EQUAL (&Local, &Tcb->LocalEnd, Version)
-        )
-    {
-      RemoveEntryList (&Tcb->List);
-      InsertHeadList (&mTcpRunQue, &Tcb->List);
-
-      return Tcb;
-    }
-  }
-
-  //
-  // Only check the listen queue when the SYN flag is on.
-  //
-  if (Syn) {
-    return TcpLocateListenTcb (&Local, &Remote, Version);
-  }
-
-  return NULL;
-}
-
-/**
-  Insert a Tcb into the proper queue.
-
-  @param[in]  Tcb               Pointer to the TCP_CB to be inserted.
-
-  @retval 0                     The Tcb was inserted successfully.
-  @retval -1                    Error condition occurred.
-
-**/
-INTN
-TcpInsertTcb (
-  IN TCP_CB  *Tcb
-  )
-{
-  LIST_ENTRY  *Entry;
-  LIST_ENTRY  *Head;
-  TCP_CB      *Node;
-
-  ASSERT (
-    (Tcb != NULL) &&
-    (
-     (Tcb->State == TCP_LISTEN) ||
-     (Tcb->State == TCP_SYN_SENT) ||
-     (Tcb->State == TCP_SYN_RCVD) ||
-     (Tcb->State == TCP_CLOSED)
-    )
-    );
-
-  if (Tcb->LocalEnd.Port == 0) {
-    return -1;
-  }
-
-  Head = &mTcpRunQue;
-
-  if (Tcb->State == TCP_LISTEN) {
-    Head = &mTcpListenQue;
-  }
-
-  //
-  // Check that the Tcb isn't already on the list.
-  //
-  NET_LIST_FOR_EACH (Entry, Head) {
-    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
-
-    if (TCP_PEER_EQUAL (&Tcb->LocalEnd, &Node->LocalEnd, Tcb->Sk->IpVersion) &&
-        TCP_PEER_EQUAL (&Tcb->RemoteEnd, &Node->RemoteEnd, Tcb->Sk->IpVersion)
-        )
-    {
-      return -1;
-    }
-  }
-
-  InsertHeadList (Head, &Tcb->List);
-
-  return 0;
-}
-
 /**
   Clone a TCP_CB from Tcb.
 
@@ -490,6 +236,7 @@ TcpCloneTcb (
   NET_GET_REF (Tcb->IpInfo);
 
   InitializeListHead (&Clone->List);
+  InitializeListHead (&Clone->HashLink);
   InitializeListHead (&Clone->SndQue);
   InitializeListHead (&Clone->RcvQue);
 
@@ -946,7 +693,7 @@ TcpResetConnection (
   Nhead->Urg      = 0;
   Nhead->Checksum = TcpChecksum (Nbuf, Tcb->HeadSum);
 
-  TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion);
+  TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion, NULL);
 
   NetbufFree (Nbuf);
 }
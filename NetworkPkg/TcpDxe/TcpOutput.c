@@ -173,6 +173,7 @@ TcpDataToSend (
   UINT32  Len;
   UINT32  Left;
   UINT32  Limit;
+  UINT32  MaxLen;
 
   Sk = Tcb->Sk;
   ASSERT (Sk != NULL);
@@ -205,8 +206,22 @@ TcpDataToSend (
 
   Len = MIN (Win, Left);
 
-  if (Len > Tcb->SndMss) {
-    Len = Tcb->SndMss;
+  //
+  // With segmentation offload, one segment can carry as many full-sized
+  // segments as the device accepts at once. Urgent data is sent without,
+  // the urgent pointer can't be split.
+  //
+  MaxLen = Tcb->SndMss;
+
+  if (((Tcb->TxOffload & EDKII_NETWORK_OFFLOAD_TSO4) != 0) &&
+      !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_URG) &&
+      (Tcb->TsoMaxSize - TCP_TSO_MAX_HEAD >= Tcb->SndMss))
+  {
+    MaxLen = (Tcb->TsoMaxSize - TCP_TSO_MAX_HEAD) / Tcb->SndMss * Tcb->SndMss;
+  }
+
+  if (Len > MaxLen) {
+    Len = MaxLen;
   }
 
   if ((Force != 0) || ((Len == 0) && (Left == 0))) {
@@ -225,7 +240,7 @@ TcpDataToSend (
   // c)It can send everything it has, and either it isn't
   // expecting an ACK, or the Nagle algorithm is disabled.
   //
-  if ((Len == Tcb->SndMss) || (2 * Len >= Tcb->SndWndMax)) {
+  if ((Len >= Tcb->SndMss) || (2 * Len >= Tcb->SndWndMax)) {
     return Len;
   }
 
@@ -273,11 +288,12 @@ TcpTransmitSegment (
   IN     NET_BUF  *Nbuf
   )
 {
-  UINT16    Len;
-  TCP_HEAD  *Head;
-  TCP_SEG   *Seg;
-  BOOLEAN   Syn;
-  UINT32    DataLen;
+  UINT16                         Len;
+  TCP_HEAD                       *Head;
+  TCP_SEG                        *Seg;
+  BOOLEAN                        Syn;
+  UINT32                         DataLen;
+  EDKII_NETWORK_OFFLOAD_TX_INFO  TxInfo;
 
   ASSERT ((Nbuf != NULL) && (Nbuf->Tcp == NULL));
 
@@ -357,9 +373,25 @@ TcpTransmitSegment (
     }
   }
 
-  Head->Flag     = Seg->Flag;
-  Head->Urg      = NTOHS (Seg->Urg);
-  Head->Checksum = TcpChecksum (Nbuf, Tcb->HeadSum);
+  Head->Flag = Seg->Flag;
+  Head->Urg  = NTOHS (Seg->Urg);
+
+  //
+  // Leave the checksum, and the split of a segment larger than SndMss, to
+  // the device if it does them.
+  //
+  ZeroMem (&TxInfo, sizeof (TxInfo));
+
+  if ((Tcb->TxOffload & EDKII_NETWORK_OFFLOAD_TCP4_CSUM) != 0) {
+    TxInfo.Flags = EDKII_NETWORK_OFFLOAD_TCP4_CSUM;
+  } else {
+    Head->Checksum = TcpChecksum (Nbuf, Tcb->HeadSum);
+  }
+
+  if ((DataLen > Tcb->SndMss) && ((Tcb->TxOffload & EDKII_NETWORK_OFFLOAD_TSO4) != 0)) {
+    TxInfo.Flags |= EDKII_NETWORK_OFFLOAD_TSO4;
+    TxInfo.Mss    = Tcb->SndMss;
+  }
 
   //
   // Update the TCP session's control information.
@@ -374,7 +406,7 @@ TcpTransmitSegment (
   //
   Tcb->DelayedAck = 0;
 
-  return TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion);
+  return TcpSendIpPacket (Tcb, Nbuf, &Tcb->LocalEnd.Ip, &Tcb->RemoteEnd.Ip, Tcb->Sk->IpVersion, &TxInfo);
 }
 
 /**
@@ -945,7 +977,7 @@ TcpToSendData (
       Tcb->RttSeq     = Seq;
       Tcb->RttMeasure = 0;
     }
-  } while (Len == Tcb->SndMss);
+  } while (Len >= Tcb->SndMss);
 
   return Sent;
 
@@ -1164,7 +1196,7 @@ TcpSendReset (
 
   Nhead->Checksum = TcpChecksum (Nbuf, HeadSum);
 
-  TcpSendIpPacket (Tcb, Nbuf, Local, Remote, Version);
+  TcpSendIpPacket (Tcb, Nbuf, Local, Remote, Version, NULL);
 
   NetbufFree (Nbuf);
 
@@ -106,6 +106,20 @@
 //
 #define TCP_MAX_HEAD  192
 
+//
+// The headers sent with a TCP segment using segmentation offload: 20byte
+// IPv4 head + 60byte TCP head
+//
+#define TCP_TSO_MAX_HEAD  80
+
+//
+// Size of the TCB hash tables used to demultiplex incoming segments,
+// and the multiplier of the multiplicative hash.
+//
+#define TCP_HASH_BITS        8
+#define TCP_HASH_SIZE        (1 << TCP_HASH_BITS)
+#define TCP_HASH_MULTIPLIER  0x9E3779B1U
+
 //
 // Value ranges for some control option
 //
@@ -230,7 +244,8 @@ typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 /// TCP control block: it includes various states.
 ///
 struct _TCP_CONTROL_BLOCK {
-  LIST_ENTRY          List;    ///< Back and forward link entry
+  LIST_ENTRY          List;     ///< Back and forward link entry
+  LIST_ENTRY          HashLink; ///< Link in the hash bucket of its queue
   TCP_CB              *Parent; ///< The parent TCP_CB structure
 
   SOCKET              *Sk;       ///< The socket it controlled.
@@ -335,6 +350,12 @@ struct _TCP_CONTROL_BLOCK {
   BOOLEAN             RemoteIpZero; ///< RemoteEnd.Ip is ZERO when configured.
   IP_IO_IP_INFO       *IpInfo;      ///< Pointer reference to Ip used to send pkt
   UINT32              Tick;         ///< 1 tick = 200ms
+
+  //
+  // Transmit offload done by the device below IpInfo.
+  //
+  UINT32              TxOffload;    ///< EDKII_NETWORK_OFFLOAD_* flags used to send.
+  UINT32              TsoMaxSize;   ///< Largest IPv4 packet sent with TSO.
 };
 
 #endif
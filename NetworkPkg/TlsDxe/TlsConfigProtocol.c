@@ -60,6 +60,10 @@ TlsConfigurationSetData (
   switch (DataType) {
     case EfiTlsConfigDataTypeCACertificate:
       Status = TlsSetCaCertificate (Instance->TlsConn, Data, DataSize);
+      if (!EFI_ERROR (Status)) {
+        TlsSessionCacheAddCaCertificate (Instance, Data, DataSize);
+      }
+
       break;
     case EfiTlsConfigDataTypeHostPublicCert:
       Status = TlsSetHostPublicCert (Instance->TlsConn, Data, DataSize);
@@ -30,6 +30,10 @@ TlsCleanInstance (
       TlsFree (Instance->TlsConn);
     }
 
+    if (Instance->HostName != NULL) {
+      FreePool (Instance->HostName);
+    }
+
     FreePool (Instance);
   }
 }
@@ -66,6 +70,8 @@ TlsCreateInstance (
 
   CopyMem (&TlsInstance->Tls, &mTlsProtocol, sizeof (TlsInstance->Tls));
   CopyMem (&TlsInstance->TlsConfig, &mTlsConfigurationProtocol, sizeof (TlsInstance->TlsConfig));
+  CopyMem (&TlsInstance->TlsRecord, &mTlsRecordProtocol, sizeof (TlsInstance->TlsRecord));
+  CopyMem (&TlsInstance->TlsSessionCache, &mTlsSessionCacheProtocol, sizeof (TlsInstance->TlsSessionCache));
 
   TlsInstance->TlsSessionState = EfiTlsSessionNotStarted;
 
@@ -90,6 +96,8 @@ TlsCleanService (
       TlsCtxFree (Service->TlsCtx);
     }
 
+    TlsSessionCacheFlush (Service);
+
     FreePool (Service);
   }
 }
@@ -131,6 +139,7 @@ TlsCreateService (
   CopyMem (&TlsService->ServiceBinding, &mTlsServiceBinding, sizeof (TlsService->ServiceBinding));
   TlsService->TlsChildrenNum = 0;
   InitializeListHead (&TlsService->TlsChildrenList);
+  InitializeListHead (&TlsService->SessionCache);
   TlsService->ImageHandle = Image;
 
   *Service = TlsService;
@@ -349,7 +358,8 @@ TlsServiceBindingCreateChild (
   }
 
   //
-  // Install TLS protocol and configuration protocol onto ChildHandle
+  // Install TLS protocol, configuration protocol, record protocol and session
+  // cache protocol onto ChildHandle
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   ChildHandle,
@@ -357,6 +367,10 @@ TlsServiceBindingCreateChild (
                   &TlsInstance->Tls,
                   &gEfiTlsConfigurationProtocolGuid,
                   &TlsInstance->TlsConfig,
+                  &gEdkiiTlsRecordProtocolGuid,
+                  &TlsInstance->TlsRecord,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  &TlsInstance->TlsSessionCache,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -466,7 +480,8 @@ TlsServiceBindingDestroyChild (
   TlsInstance->InDestroy = TRUE;
 
   //
-  // Uninstall the TLS protocol and TLS Configuration Protocol interface installed in ChildHandle.
+  // Uninstall the TLS protocol, TLS Configuration Protocol, TLS Record Protocol
+  // and TLS Session Cache Protocol interface installed in ChildHandle.
   //
   Status = gBS->UninstallMultipleProtocolInterfaces (
                   ChildHandle,
@@ -474,6 +489,10 @@ TlsServiceBindingDestroyChild (
                   Tls,
                   &gEfiTlsConfigurationProtocolGuid,
                   TlsConfig,
+                  &gEdkiiTlsRecordProtocolGuid,
+                  &TlsInstance->TlsRecord,
+                  &gEdkiiTlsSessionCacheProtocolGuid,
+                  &TlsInstance->TlsSessionCache,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -483,6 +502,11 @@ TlsServiceBindingDestroyChild (
   RemoveEntryList (&TlsInstance->Link);
   TlsService->TlsChildrenNum--;
 
+  //
+  // Keep the session for the next connection to the same host and port.
+  //
+  TlsSessionCacheSave (TlsInstance);
+
   gBS->RestoreTPL (OldTpl);
 
   TlsCleanInstance (TlsInstance);
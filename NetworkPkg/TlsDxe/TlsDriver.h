@@ -36,6 +36,16 @@ typedef struct _TLS_SERVICE TLS_SERVICE;
 ///
 typedef struct _TLS_INSTANCE TLS_INSTANCE;
 
+///
+/// The settings a session is verified with. A cached session is only resumed
+/// by a connection with the same settings.
+///
+typedef struct {
+  UINT32    VerifyMethod;
+  UINT32    VerifyHostFlags;
+  UINT8     CaDigest[SHA256_DIGEST_SIZE];
+} TLS_SESSION_CACHE_TRUST;
+
 struct _TLS_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -55,27 +65,58 @@ struct _TLS_SERVICE {
   // created for the connections.
   //
   VOID                            *TlsCtx;
+
+  //
+  // Sessions of the finished connections, to be resumed by the next connection
+  // to the same host and port, the trust settings they were all verified
+  // with, and the handshake counters.
+  //
+  LIST_ENTRY                      SessionCache;
+  UINTN                           SessionCacheCount;
+  TLS_SESSION_CACHE_TRUST         SessionCacheTrust;
+  UINT32                          FullHandshakes;
+  UINT32                          ResumedHandshakes;
 };
 
 struct _TLS_INSTANCE {
-  UINT32                            Signature;
-  LIST_ENTRY                        Link;
+  UINT32                              Signature;
+  LIST_ENTRY                          Link;
 
-  BOOLEAN                           InDestroy;
+  BOOLEAN                             InDestroy;
 
-  TLS_SERVICE                       *Service;
-  EFI_HANDLE                        ChildHandle;
+  TLS_SERVICE                         *Service;
+  EFI_HANDLE                          ChildHandle;
 
-  EFI_TLS_PROTOCOL                  Tls;
-  EFI_TLS_CONFIGURATION_PROTOCOL    TlsConfig;
+  EFI_TLS_PROTOCOL                    Tls;
+  EFI_TLS_CONFIGURATION_PROTOCOL      TlsConfig;
+  EDKII_TLS_RECORD_PROTOCOL           TlsRecord;
+  EDKII_TLS_SESSION_CACHE_PROTOCOL    TlsSessionCache;
 
-  EFI_TLS_SESSION_STATE             TlsSessionState;
+  EFI_TLS_SESSION_STATE               TlsSessionState;
 
   //
   // Main SSL Connection which is created by a server or a client
   // per established connection.
   //
-  VOID                              *TlsConn;
+  VOID                                *TlsConn;
+
+  //
+  // The host name to verify and the server port, which key the session
+  // cache, and whether the cached session has been offered for the current
+  // connection.
+  //
+  CHAR8                               *HostName;
+  UINT32                              VerifyHostFlags;
+  UINT16                              Port;
+  BOOLEAN                             SessionOffered;
+
+  //
+  // Digest of the CA certificates set, in order, and their number. The
+  // sessions aren't cached if one couldn't be hashed.
+  //
+  UINT8                               CaDigest[SHA256_DIGEST_SIZE];
+  UINTN                               CaCount;
+  BOOLEAN                             CaDigestError;
 };
 
 #define TLS_SERVICE_FROM_THIS(a)   \
@@ -87,6 +128,12 @@ struct _TLS_INSTANCE {
 #define TLS_INSTANCE_FROM_CONFIGURATION(a)  \
   CR (a, TLS_INSTANCE, TlsConfig, TLS_INSTANCE_SIGNATURE)
 
+#define TLS_INSTANCE_FROM_RECORD(a)  \
+  CR (a, TLS_INSTANCE, TlsRecord, TLS_INSTANCE_SIGNATURE)
+
+#define TLS_INSTANCE_FROM_SESSION_CACHE(a)  \
+  CR (a, TLS_INSTANCE, TlsSessionCache, TLS_INSTANCE_SIGNATURE)
+
 /**
   Release all the resources used by the TLS instance.
 
@@ -348,3 +348,192 @@ ERROR:
 
   return Status;
 }
+
+/**
+  Copy bytes out of a list of fragment as if the fragments were one buffer.
+
+  @param[in]  FragmentTable  Pointer to a list of fragment.
+  @param[in]  FragmentCount  Number of fragment.
+  @param[in]  Offset         The offset of the first byte to copy.
+  @param[in]  Length         The number of bytes to copy.
+  @param[out] Destination    The buffer to copy the bytes to.
+
+  @return The number of bytes copied, less than Length if the fragments end
+          before Offset + Length.
+**/
+STATIC
+UINT32
+TlsFragmentCopy (
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  IN     UINT32                 Offset,
+  IN     UINT32                 Length,
+  OUT    UINT8                  *Destination
+  )
+{
+  UINT32  Index;
+  UINT32  Copied;
+  UINT32  Count;
+
+  Copied = 0;
+
+  for (Index = 0; (Index < FragmentCount) && (Copied < Length); Index++) {
+    if (Offset >= FragmentTable[Index].FragmentLength) {
+      Offset -= FragmentTable[Index].FragmentLength;
+      continue;
+    }
+
+    Count = MIN (FragmentTable[Index].FragmentLength - Offset, Length - Copied);
+    CopyMem (Destination + Copied, (UINT8 *)FragmentTable[Index].FragmentBuffer + Offset, Count);
+    Copied += Count;
+    Offset  = 0;
+  }
+
+  return Copied;
+}
+
+/**
+  Decrypt the message listed in fragment into a caller supplied buffer.
+
+  Unlike TlsDecryptPacket(), the fragments are neither gathered into one
+  buffer nor replaced: they are fed to the TLS connection as they are, and
+  the plain text is read from the TLS connection straight into Buffer.
+
+  @param[in]       TlsInstance    The pointer to the TLS instance.
+  @param[in]       FragmentTable  Pointer to a list of fragment holding the TLS
+                                  header and cipher text TLS payload of one or more
+                                  records.
+  @param[in]       FragmentCount  Number of fragment.
+  @param[out]      Buffer         The buffer to receive the plain text TLS payload in.
+  @param[in, out]  BufferSize     On input, the size of Buffer. On output, the number
+                                  of bytes written to Buffer.
+  @param[out]      Remainder      The rest of the plain text TLS payload, in a buffer
+                                  to be freed by the caller. NULL if there is none.
+  @param[out]      RemainderSize  The size of Remainder.
+
+  @retval EFI_SUCCESS             The operation completed successfully.
+  @retval EFI_INVALID_PARAMETER   The fragments don't hold complete application data
+                                  records.
+  @retval EFI_OUT_OF_RESOURCES    Can't allocate memory resources.
+  @retval EFI_ABORTED             TLS session state is incorrect.
+**/
+EFI_STATUS
+TlsDecryptPacketToBuffer (
+  IN     TLS_INSTANCE           *TlsInstance,
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  OUT    UINT8                  *Buffer OPTIONAL,
+  IN OUT UINTN                  *BufferSize,
+  OUT    UINT8                  **Remainder,
+  OUT    UINTN                  *RemainderSize
+  )
+{
+  UINT32             Index;
+  UINT32             TotalSize;
+  UINT32             Offset;
+  UINT32             PayloadSize;
+  TLS_RECORD_HEADER  RecordHeader;
+  UINT8              *Extra;
+  UINTN              ExtraSize;
+  UINTN              Copied;
+  INTN               Ret;
+
+  *Remainder     = NULL;
+  *RemainderSize = 0;
+
+  //
+  // Check that the fragments hold complete application data records only,
+  // the record headers may straddle fragments.
+  //
+  TotalSize = 0;
+  for (Index = 0; Index < FragmentCount; Index++) {
+    TotalSize += FragmentTable[Index].FragmentLength;
+  }
+
+  Offset      = 0;
+  PayloadSize = 0;
+  while (Offset < TotalSize) {
+    if (TlsFragmentCopy (FragmentTable, FragmentCount, Offset, TLS_RECORD_HEADER_LENGTH, (UINT8 *)&RecordHeader) != TLS_RECORD_HEADER_LENGTH) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if ((RecordHeader.ContentType != TlsContentTypeApplicationData) || (NTOHS (RecordHeader.Length) > TLS_CIPHERTEXT_RECORD_MAX_PAYLOAD_LENGTH)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Offset      += TLS_RECORD_HEADER_LENGTH + NTOHS (RecordHeader.Length);
+    PayloadSize += NTOHS (RecordHeader.Length);
+  }
+
+  if (Offset != TotalSize) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Hand the cipher text to the TLS connection.
+  //
+  for (Index = 0; Index < FragmentCount; Index++) {
+    if (FragmentTable[Index].FragmentLength == 0) {
+      continue;
+    }
+
+    Ret = TlsCtrlTrafficIn (TlsInstance->TlsConn, FragmentTable[Index].FragmentBuffer, FragmentTable[Index].FragmentLength);
+    if (Ret != (INTN)FragmentTable[Index].FragmentLength) {
+      TlsInstance->TlsSessionState = EfiTlsSessionError;
+      return EFI_ABORTED;
+    }
+  }
+
+  //
+  // Decrypt into the caller's buffer first. A TLS read returns at most one
+  // record, so keep reading until the buffer is full or nothing is left.
+  //
+  Copied = 0;
+  while (Copied < *BufferSize) {
+    Ret = TlsRead (TlsInstance->TlsConn, Buffer + Copied, *BufferSize - Copied);
+    if (Ret <= 0) {
+      break;
+    }
+
+    Copied += (UINTN)Ret;
+  }
+
+  //
+  // The plain text is never longer than the cipher text, so what is left
+  // fits in PayloadSize - Copied bytes.
+  //
+  if ((Copied == *BufferSize) && (PayloadSize > Copied)) {
+    Extra = AllocatePool (PayloadSize - Copied);
+    if (Extra == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ExtraSize = 0;
+    while (ExtraSize < PayloadSize - Copied) {
+      Ret = TlsRead (TlsInstance->TlsConn, Extra + ExtraSize, PayloadSize - Copied - ExtraSize);
+      if (Ret <= 0) {
+        break;
+      }
+
+      ExtraSize += (UINTN)Ret;
+    }
+
+    if (ExtraSize == 0) {
+      FreePool (Extra);
+    } else {
+      *Remainder     = Extra;
+      *RemainderSize = ExtraSize;
+    }
+  }
+
+  if ((Copied == 0) && (*RemainderSize == 0)) {
+    //
+    // No data was successfully decrypted.
+    //
+    DEBUG ((DEBUG_WARN, "TlsDecryptPacketToBuffer: No data read from TLS object.\n"));
+  }
+
+  *BufferSize = Copied;
+
+  return EFI_SUCCESS;
+}
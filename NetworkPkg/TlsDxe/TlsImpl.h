@@ -28,6 +28,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
+#include <Protocol/TlsRecord.h>
+#include <Protocol/TlsSessionCache.h>
 
 #include <IndustryStandard/Tls1.h>
 
@@ -36,9 +38,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Protocol instances
 //
-extern EFI_SERVICE_BINDING_PROTOCOL    mTlsServiceBinding;
-extern EFI_TLS_PROTOCOL                mTlsProtocol;
-extern EFI_TLS_CONFIGURATION_PROTOCOL  mTlsConfigurationProtocol;
+extern EFI_SERVICE_BINDING_PROTOCOL      mTlsServiceBinding;
+extern EFI_TLS_PROTOCOL                  mTlsProtocol;
+extern EFI_TLS_CONFIGURATION_PROTOCOL    mTlsConfigurationProtocol;
+extern EDKII_TLS_RECORD_PROTOCOL         mTlsRecordProtocol;
+extern EDKII_TLS_SESSION_CACHE_PROTOCOL  mTlsSessionCacheProtocol;
+
+#define TLS12_PROTOCOL_VERSION  ((TLS12_PROTOCOL_VERSION_MAJOR << 8) | TLS12_PROTOCOL_VERSION_MINOR)
+
+//
+// Sessions kept for resumption, one per host and port, the most recently used
+// first. All of them were verified with the same trust settings.
+//
+#define TLS_SESSION_CACHE_SIGNATURE  SIGNATURE_32 ('T', 'L', 'S', 'C')
+#define TLS_SESSION_CACHE_MAX        8
+
+typedef struct {
+  UINT32                     Signature;
+  LIST_ENTRY                 Link;
+  CHAR8                      *HostName;
+  UINT16                     Port;
+  TLS_SESSION_CACHE_TRUST    Trust;
+  UINT16                     Version;
+  VOID                       *Session;
+} TLS_SESSION_CACHE_ENTRY;
 
 /**
   Encrypt the message listed in fragment.
@@ -86,6 +109,121 @@ TlsDecryptPacket (
   IN     UINT32                 *FragmentCount
   );
 
+/**
+  Decrypt the message listed in fragment into a caller supplied buffer.
+
+  Unlike TlsDecryptPacket(), the fragments are neither gathered into one
+  buffer nor replaced: they are fed to the TLS connection as they are, and
+  the plain text is read from the TLS connection straight into Buffer.
+
+  @param[in]       TlsInstance    The pointer to the TLS instance.
+  @param[in]       FragmentTable  Pointer to a list of fragment holding the TLS
+                                  header and cipher text TLS payload of one or more
+                                  records.
+  @param[in]       FragmentCount  Number of fragment.
+  @param[out]      Buffer         The buffer to receive the plain text TLS payload in.
+  @param[in, out]  BufferSize     On input, the size of Buffer. On output, the number
+                                  of bytes written to Buffer.
+  @param[out]      Remainder      The rest of the plain text TLS payload, in a buffer
+                                  to be freed by the caller. NULL if there is none.
+  @param[out]      RemainderSize  The size of Remainder.
+
+  @retval EFI_SUCCESS             The operation completed successfully.
+  @retval EFI_INVALID_PARAMETER   The fragments don't hold complete application data
+                                  records.
+  @retval EFI_OUT_OF_RESOURCES    Can't allocate memory resources.
+  @retval EFI_ABORTED             TLS session state is incorrect.
+**/
+EFI_STATUS
+TlsDecryptPacketToBuffer (
+  IN     TLS_INSTANCE           *TlsInstance,
+  IN     EFI_TLS_FRAGMENT_DATA  *FragmentTable,
+  IN     UINT32                 FragmentCount,
+  OUT    UINT8                  *Buffer OPTIONAL,
+  IN OUT UINTN                  *BufferSize,
+  OUT    UINT8                  **Remainder,
+  OUT    UINTN                  *RemainderSize
+  );
+
+/**
+  Offer the cached session of the host to the server, before the ClientHello
+  of the TLS instance is built.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Save the session of the TLS instance in the cache, for the next connection
+  to the same host.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Count the handshake of the TLS instance as resumed or full, once it's done.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheCountHandshake (
+  IN TLS_INSTANCE  *Instance
+  );
+
+/**
+  Add a CA certificate set on the TLS instance to the digest of its trust
+  anchors, which keys the session cache.
+
+  @param[in]  Instance       The TLS instance.
+  @param[in]  Data           The CA certificate.
+  @param[in]  DataSize       The size of the CA certificate.
+
+**/
+VOID
+TlsSessionCacheAddCaCertificate (
+  IN TLS_INSTANCE  *Instance,
+  IN VOID          *Data,
+  IN UINTN         DataSize
+  );
+
+/**
+  Identify the server port of the TLS session, so that the session may be
+  cached and resumed.
+
+  @param[in]  This                Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  Port                The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL or Port is 0.
+**/
+EFI_STATUS
+EFIAPI
+TlsSessionCacheSetPeer (
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            Port
+  );
+
+/**
+  Free all the sessions in the cache of the TLS service.
+
+  @param[in]  Service        The TLS service.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  );
+
 /**
   Set TLS session data.
 
@@ -243,6 +381,41 @@ TlsProcessPacket (
   IN     EFI_TLS_CRYPT_MODE     CryptMode
   );
 
+/**
+  Decrypt TLS application data records into a caller supplied buffer.
+
+  @param[in]       This           Pointer to the EDKII_TLS_RECORD_PROTOCOL instance.
+  @param[in]       FragmentTable  Pointer to a list of fragment holding the records.
+  @param[in]       FragmentCount  Number of fragment.
+  @param[out]      Buffer         The buffer to receive the plain text in. May be NULL
+                                  if *BufferSize is zero.
+  @param[in, out]  BufferSize     On input, the size of Buffer in bytes. On output, the
+                                  number of bytes written to Buffer.
+  @param[out]      Remainder      The rest of the plain text, in a buffer to be freed by
+                                  the caller with FreePool(). NULL if there is none.
+  @param[out]      RemainderSize  The size of Remainder in bytes.
+
+  @retval EFI_SUCCESS             The records are decrypted successfully.
+  @retval EFI_INVALID_PARAMETER   One or more parameters are invalid, or the fragments
+                                  don't hold complete application_data records.
+  @retval EFI_NOT_READY           Current TLS session state is NOT
+                                  EfiTlsSessionDataTransferring.
+  @retval EFI_ABORTED             Something wrong decryption the message. TLS session
+                                  status will become EfiTlsSessionError.
+  @retval EFI_OUT_OF_RESOURCES    No enough resource to finish the operation.
+**/
+EFI_STATUS
+EFIAPI
+TlsRecordDecryptToBuffer (
+  IN     EDKII_TLS_RECORD_PROTOCOL  *This,
+  IN     EFI_TLS_FRAGMENT_DATA      *FragmentTable,
+  IN     UINT32                     FragmentCount,
+  OUT    UINT8                      *Buffer OPTIONAL,
+  IN OUT UINTN                      *BufferSize,
+  OUT    UINT8                      **Remainder,
+  OUT    UINTN                      *RemainderSize
+  );
+
 /**
   Set TLS configuration data.
 
@@ -16,6 +16,11 @@ EFI_TLS_PROTOCOL  mTlsProtocol = {
   TlsProcessPacket
 };
 
+EDKII_TLS_RECORD_PROTOCOL  mTlsRecordProtocol = {
+  EDKII_TLS_RECORD_PROTOCOL_REVISION,
+  TlsRecordDecryptToBuffer
+};
+
 /**
   Set TLS session data.
 
@@ -187,7 +192,19 @@ TlsSetSessionData (
       }
 
       Status = TlsSetVerifyHost (Instance->TlsConn, TlsVerifyHost->Flags, TlsVerifyHost->HostName);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
 
+      //
+      // The verified host name keys the session cache.
+      //
+      if (Instance->HostName != NULL) {
+        FreePool (Instance->HostName);
+      }
+
+      Instance->HostName        = AllocateCopyPool (AsciiStrSize (TlsVerifyHost->HostName), TlsVerifyHost->HostName);
+      Instance->VerifyHostFlags = TlsVerifyHost->Flags;
       break;
     case EfiTlsSessionID:
       if (DataSize != sizeof (EFI_TLS_SESSION_ID)) {
@@ -208,6 +225,16 @@ TlsSetSessionData (
       }
 
       Instance->TlsSessionState = *(EFI_TLS_SESSION_STATE *)Data;
+      if (Instance->TlsSessionState == EfiTlsSessionNotStarted) {
+        //
+        // A new connection, the CA certificates it trusts are set next.
+        //
+        Instance->SessionOffered = FALSE;
+        Instance->CaCount        = 0;
+        Instance->CaDigestError  = FALSE;
+        ZeroMem (Instance->CaDigest, sizeof (Instance->CaDigest));
+      }
+
       break;
     //
     // Session information
@@ -484,6 +511,15 @@ TlsBuildResponsePacket (
   if ((RequestBuffer == NULL) && (RequestSize == 0)) {
     switch (Instance->TlsSessionState) {
       case EfiTlsSessionNotStarted:
+        //
+        // Offer the cached session of the host once, this may be called again
+        // with a larger buffer.
+        //
+        if (!Instance->SessionOffered) {
+          TlsSessionCacheResume (Instance);
+          Instance->SessionOffered = TRUE;
+        }
+
         //
         // ClientHello.
         //
@@ -512,7 +548,10 @@ TlsBuildResponsePacket (
       case EfiTlsSessionClosing:
         //
         // TLS session will be closed and response packet needs to be CloseNotify.
+        // Keep the session first, the TLS child may be reused for a new connection.
         //
+        TlsSessionCacheSave (Instance);
+
         Status = TlsCloseNotify (
                    Instance->TlsConn,
                    Buffer,
@@ -575,6 +614,7 @@ TlsBuildResponsePacket (
 
       if (!TlsInHandshake (Instance->TlsConn)) {
         Instance->TlsSessionState = EfiTlsSessionDataTransferring;
+        TlsSessionCacheCountHandshake (Instance);
       }
     } else {
       //
@@ -687,3 +727,76 @@ ON_EXIT:
   gBS->RestoreTPL (OldTpl);
   return Status;
 }
+
+/**
+  Decrypt TLS application data records into a caller supplied buffer.
+
+  The DecryptToBuffer() function is the counterpart of ProcessPacket() with
+  EfiTlsDecrypt for a caller that knows where the plain text is to go. The
+  TLS APP payload of the records is written to Buffer, and the part that
+  doesn't fit is returned in Remainder.
+
+  @param[in]       This           Pointer to the EDKII_TLS_RECORD_PROTOCOL instance.
+  @param[in]       FragmentTable  Pointer to a list of fragment holding the records.
+  @param[in]       FragmentCount  Number of fragment.
+  @param[out]      Buffer         The buffer to receive the plain text in. May be NULL
+                                  if *BufferSize is zero.
+  @param[in, out]  BufferSize     On input, the size of Buffer in bytes. On output, the
+                                  number of bytes written to Buffer.
+  @param[out]      Remainder      The rest of the plain text, in a buffer to be freed by
+                                  the caller with FreePool(). NULL if there is none.
+  @param[out]      RemainderSize  The size of Remainder in bytes.
+
+  @retval EFI_SUCCESS             The records are decrypted successfully.
+  @retval EFI_INVALID_PARAMETER   One or more parameters are invalid, or the fragments
+                                  don't hold complete application_data records.
+  @retval EFI_NOT_READY           Current TLS session state is NOT
+                                  EfiTlsSessionDataTransferring.
+  @retval EFI_ABORTED             Something wrong decryption the message. TLS session
+                                  status will become EfiTlsSessionError.
+  @retval EFI_OUT_OF_RESOURCES    No enough resource to finish the operation.
+**/
+EFI_STATUS
+EFIAPI
+TlsRecordDecryptToBuffer (
+  IN     EDKII_TLS_RECORD_PROTOCOL  *This,
+  IN     EFI_TLS_FRAGMENT_DATA      *FragmentTable,
+  IN     UINT32                     FragmentCount,
+  OUT    UINT8                      *Buffer OPTIONAL,
+  IN OUT UINTN                      *BufferSize,
+  OUT    UINT8                      **Remainder,
+  OUT    UINTN                      *RemainderSize
+  )
+{
+  EFI_STATUS    Status;
+  TLS_INSTANCE  *Instance;
+  EFI_TPL       OldTpl;
+
+  if ((This == NULL) || (FragmentTable == NULL) || (FragmentCount == 0) ||
+      (BufferSize == NULL) || ((Buffer == NULL) && (*BufferSize != 0)) ||
+      (Remainder == NULL) || (RemainderSize == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Instance = TLS_INSTANCE_FROM_RECORD (This);
+
+  if (Instance->TlsSessionState != EfiTlsSessionDataTransferring) {
+    Status = EFI_NOT_READY;
+  } else {
+    Status = TlsDecryptPacketToBuffer (
+               Instance,
+               FragmentTable,
+               FragmentCount,
+               Buffer,
+               BufferSize,
+               Remainder,
+               RemainderSize
+               );
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
@@ -0,0 +1,384 @@
+/** @file
+  TLS session cache of the TlsDxe driver.
+
+  The sessions of the finished TLS connections are kept per server, the host
+  name given with EfiTlsVerifyHost and the port given with the EDKII TLS
+  Session Cache Protocol, and offered to the server on the next connection to
+  it. A TLS 1.2 session is resumed by its session ID and may be offered
+  several times. A TLS 1.3 session is resumed by its PSK ticket, which should
+  only be used once, so it is dropped from the cache when it's offered; the
+  resumed connection leaves a fresh ticket behind.
+
+  A resumed handshake doesn't verify the peer certificate again, so only the
+  sessions whose handshake verified the peer are cached, and they are only
+  resumed by a connection with the same verification settings and CA
+  certificates. The cache is flushed when a connection uses other ones.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TlsImpl.h"
+
+EDKII_TLS_SESSION_CACHE_PROTOCOL  mTlsSessionCacheProtocol = {
+  EDKII_TLS_SESSION_CACHE_PROTOCOL_REVISION,
+  TlsSessionCacheSetPeer
+};
+
+/**
+  Free a session cache entry.
+
+  @param[in]  Entry          The session cache entry, removed from the cache.
+
+**/
+STATIC
+VOID
+TlsSessionCacheFreeEntry (
+  IN TLS_SESSION_CACHE_ENTRY  *Entry
+  )
+{
+  TlsFreeSession (Entry->Session);
+  FreePool (Entry->HostName);
+  FreePool (Entry);
+}
+
+/**
+  Get the trust settings of the TLS instance, if its sessions may be cached.
+
+  The peer certificate must be verified, against a host name and the CA
+  certificates set, and the server port must be known.
+
+  @param[in]   Instance      The TLS instance.
+  @param[out]  Trust         The trust settings of the instance.
+
+  @retval TRUE   The sessions of the instance may be cached and resumed.
+  @retval FALSE  They may not.
+
+**/
+STATIC
+BOOLEAN
+TlsSessionCacheGetTrust (
+  IN  TLS_INSTANCE             *Instance,
+  OUT TLS_SESSION_CACHE_TRUST  *Trust
+  )
+{
+  if ((Instance->HostName == NULL) || (Instance->Port == 0) ||
+      (Instance->CaCount == 0) || Instance->CaDigestError)
+  {
+    return FALSE;
+  }
+
+  ZeroMem (Trust, sizeof (*Trust));
+  Trust->VerifyMethod    = TlsGetVerify (Instance->TlsConn);
+  Trust->VerifyHostFlags = Instance->VerifyHostFlags;
+  CopyMem (Trust->CaDigest, Instance->CaDigest, sizeof (Trust->CaDigest));
+
+  return (BOOLEAN)((Trust->VerifyMethod & EFI_TLS_VERIFY_PEER) != 0);
+}
+
+/**
+  Flush the session cache if it holds sessions verified with other trust
+  settings than the given ones.
+
+  @param[in]  Service        The TLS service.
+  @param[in]  Trust          The trust settings of the current connection.
+
+**/
+STATIC
+VOID
+TlsSessionCacheCheckTrust (
+  IN TLS_SERVICE              *Service,
+  IN TLS_SESSION_CACHE_TRUST  *Trust
+  )
+{
+  if (CompareMem (&Service->SessionCacheTrust, Trust, sizeof (*Trust)) == 0) {
+    return;
+  }
+
+  if (Service->SessionCacheCount != 0) {
+    DEBUG ((DEBUG_INFO, "TlsDxe: TLS trust settings changed, flush %Lu cached sessions\n", (UINT64)Service->SessionCacheCount));
+    TlsSessionCacheFlush (Service);
+  }
+
+  CopyMem (&Service->SessionCacheTrust, Trust, sizeof (*Trust));
+}
+
+/**
+  Find the session cache entry of a server.
+
+  @param[in]  Service        The TLS service.
+  @param[in]  HostName       The host name.
+  @param[in]  Port           The port.
+  @param[in]  Trust          The trust settings of the connection.
+
+  @return The session cache entry, or NULL if the server has none.
+
+**/
+STATIC
+TLS_SESSION_CACHE_ENTRY *
+TlsSessionCacheFind (
+  IN TLS_SERVICE              *Service,
+  IN CHAR8                    *HostName,
+  IN UINT16                   Port,
+  IN TLS_SESSION_CACHE_TRUST  *Trust
+  )
+{
+  LIST_ENTRY               *Link;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Link, &Service->SessionCache) {
+    Entry = NET_LIST_USER_STRUCT_S (Link, TLS_SESSION_CACHE_ENTRY, Link, TLS_SESSION_CACHE_SIGNATURE);
+    if ((Entry->Port == Port) &&
+        (AsciiStrCmp (Entry->HostName, HostName) == 0) &&
+        (CompareMem (&Entry->Trust, Trust, sizeof (*Trust)) == 0))
+    {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Offer the cached session of the server to it, before the ClientHello of the
+  TLS instance is built.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheResume (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  TLS_SESSION_CACHE_TRUST  Trust;
+  EFI_STATUS               Status;
+
+  if (!TlsSessionCacheGetTrust (Instance, &Trust)) {
+    return;
+  }
+
+  Service = Instance->Service;
+  TlsSessionCacheCheckTrust (Service, &Trust);
+
+  Entry = TlsSessionCacheFind (Service, Instance->HostName, Instance->Port, &Trust);
+  if (Entry == NULL) {
+    return;
+  }
+
+  Status = TlsSetSession (Instance->TlsConn, Entry->Session);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "TlsSessionCacheResume: Can't offer the session of %a:%d - %r\n", Entry->HostName, Entry->Port, Status));
+  }
+
+  RemoveEntryList (&Entry->Link);
+  if (EFI_ERROR (Status) || (Entry->Version > TLS12_PROTOCOL_VERSION)) {
+    Service->SessionCacheCount--;
+    TlsSessionCacheFreeEntry (Entry);
+  } else {
+    //
+    // Keep the most recently used entries at the head.
+    //
+    InsertHeadList (&Service->SessionCache, &Entry->Link);
+  }
+}
+
+/**
+  Save the session of the TLS instance in the cache, for the next connection
+  to the same server.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheSave (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE              *Service;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+  TLS_SESSION_CACHE_TRUST  Trust;
+  VOID                     *Session;
+
+  //
+  // Only a session whose handshake completed, and so verified the peer, is
+  // kept.
+  //
+  if (((Instance->TlsSessionState != EfiTlsSessionDataTransferring) &&
+       (Instance->TlsSessionState != EfiTlsSessionClosing)) ||
+      !TlsSessionCacheGetTrust (Instance, &Trust))
+  {
+    return;
+  }
+
+  Session = TlsGetSession (Instance->TlsConn);
+  if (Session == NULL) {
+    return;
+  }
+
+  Service = Instance->Service;
+  TlsSessionCacheCheckTrust (Service, &Trust);
+
+  Entry = TlsSessionCacheFind (Service, Instance->HostName, Instance->Port, &Trust);
+  if (Entry != NULL) {
+    RemoveEntryList (&Entry->Link);
+    Service->SessionCacheCount--;
+    TlsSessionCacheFreeEntry (Entry);
+  }
+
+  Entry = AllocateZeroPool (sizeof (TLS_SESSION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    TlsFreeSession (Session);
+    return;
+  }
+
+  Entry->HostName = AllocateCopyPool (AsciiStrSize (Instance->HostName), Instance->HostName);
+  if (Entry->HostName == NULL) {
+    FreePool (Entry);
+    TlsFreeSession (Session);
+    return;
+  }
+
+  Entry->Signature = TLS_SESSION_CACHE_SIGNATURE;
+  Entry->Port      = Instance->Port;
+  Entry->Version   = TlsGetVersion (Instance->TlsConn);
+  Entry->Session   = Session;
+  CopyMem (&Entry->Trust, &Trust, sizeof (Entry->Trust));
+  InsertHeadList (&Service->SessionCache, &Entry->Link);
+  Service->SessionCacheCount++;
+
+  //
+  // Evict the least recently used entries.
+  //
+  while (Service->SessionCacheCount > TLS_SESSION_CACHE_MAX) {
+    Entry = NET_LIST_TAIL (&Service->SessionCache, TLS_SESSION_CACHE_ENTRY, Link);
+    RemoveEntryList (&Entry->Link);
+    Service->SessionCacheCount--;
+    TlsSessionCacheFreeEntry (Entry);
+  }
+}
+
+/**
+  Count the handshake of the TLS instance as resumed or full, once it's done.
+
+  @param[in]  Instance       The TLS instance.
+
+**/
+VOID
+TlsSessionCacheCountHandshake (
+  IN TLS_INSTANCE  *Instance
+  )
+{
+  TLS_SERVICE  *Service;
+  BOOLEAN      Resumed;
+
+  Service = Instance->Service;
+  Resumed = TlsGetSessionReused (Instance->TlsConn);
+
+  if (Resumed) {
+    Service->ResumedHandshakes++;
+  } else {
+    Service->FullHandshakes++;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "TlsDxe: %a handshake with %a (full %d, resumed %d)\n",
+    Resumed ? "Resumed" : "Full",
+    (Instance->HostName != NULL) ? Instance->HostName : "<unnamed>",
+    Service->FullHandshakes,
+    Service->ResumedHandshakes
+    ));
+}
+
+/**
+  Add a CA certificate set on the TLS instance to the digest of its trust
+  anchors, which keys the session cache.
+
+  @param[in]  Instance       The TLS instance.
+  @param[in]  Data           The CA certificate.
+  @param[in]  DataSize       The size of the CA certificate.
+
+**/
+VOID
+TlsSessionCacheAddCaCertificate (
+  IN TLS_INSTANCE  *Instance,
+  IN VOID          *Data,
+  IN UINTN         DataSize
+  )
+{
+  UINT8  Chain[2 * SHA256_DIGEST_SIZE];
+
+  //
+  // Chain the digest of the certificate to the digest of the ones set before.
+  //
+  CopyMem (Chain, Instance->CaDigest, SHA256_DIGEST_SIZE);
+  if (!Sha256HashAll (Data, DataSize, Chain + SHA256_DIGEST_SIZE) ||
+      !Sha256HashAll (Chain, sizeof (Chain), Instance->CaDigest))
+  {
+    Instance->CaDigestError = TRUE;
+  }
+
+  Instance->CaCount++;
+}
+
+/**
+  Identify the server port of the TLS session, so that the session may be
+  cached and resumed.
+
+  @param[in]  This                Pointer to the EDKII_TLS_SESSION_CACHE_PROTOCOL instance.
+  @param[in]  Port                The TCP port of the server.
+
+  @retval EFI_SUCCESS             The port is set.
+  @retval EFI_INVALID_PARAMETER   This is NULL or Port is 0.
+**/
+EFI_STATUS
+EFIAPI
+TlsSessionCacheSetPeer (
+  IN EDKII_TLS_SESSION_CACHE_PROTOCOL  *This,
+  IN UINT16                            Port
+  )
+{
+  TLS_INSTANCE  *Instance;
+  EFI_TPL       OldTpl;
+
+  if ((This == NULL) || (Port == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Instance       = TLS_INSTANCE_FROM_SESSION_CACHE (This);
+  Instance->Port = Port;
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Free all the sessions in the cache of the TLS service.
+
+  @param[in]  Service        The TLS service.
+
+**/
+VOID
+TlsSessionCacheFlush (
+  IN TLS_SERVICE  *Service
+  )
+{
+  LIST_ENTRY               *Link;
+  LIST_ENTRY               *Next;
+  TLS_SESSION_CACHE_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH_SAFE (Link, Next, &Service->SessionCache) {
+    Entry = NET_LIST_USER_STRUCT_S (Link, TLS_SESSION_CACHE_ENTRY, Link, TLS_SESSION_CACHE_SIGNATURE);
+    RemoveEntryList (&Entry->Link);
+    TlsSessionCacheFreeEntry (Entry);
+  }
+
+  Service->SessionCacheCount = 0;
+}
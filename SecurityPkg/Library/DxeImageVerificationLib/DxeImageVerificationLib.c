@@ -31,10 +31,16 @@ EFI_GUID                             mCertType;
 //
 // Information on current PE/COFF image
 //
-UINTN  mImageSize;
-UINT8  *mImageBase = NULL;
-UINT8  mImageDigest[MAX_DIGEST_SIZE];
-UINTN  mImageDigestSize;
+UINTN                           mImageSize;
+UINT8                           *mImageBase = NULL;
+CONST EFI_DEVICE_PATH_PROTOCOL  *mImageFile = NULL;
+UINT8                           mImageDigest[MAX_DIGEST_SIZE];
+UINTN                           mImageDigestSize;
+
+//
+// Digests of the image shared with the TCG measurement.
+//
+EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *mPeImageDigestCache = NULL;
 
 //
 // Notify string for authorization UI.
@@ -271,6 +277,72 @@ GetImageType (
   return IMAGE_UNKNOWN;
 }
 
+/**
+  Get the digest of the current image from the digests already computed by
+  the other Security2 handlers, into mImageDigest.
+
+  @param[in]  AlgorithmId   The hash algorithm, a TPM_ALG_ID value.
+
+  @retval TRUE            The digest is found.
+  @retval FALSE           The digest must be computed.
+
+**/
+STATIC
+BOOLEAN
+GetCachedImageDigest (
+  IN TPM_ALG_ID  AlgorithmId
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       DigestSize;
+
+  if (mPeImageDigestCache == NULL) {
+    Status = gBS->LocateProtocol (&gEdkiiPeImageDigestCacheProtocolGuid, NULL, (VOID **)&mPeImageDigestCache);
+    if (EFI_ERROR (Status)) {
+      mPeImageDigestCache = NULL;
+      return FALSE;
+    }
+  }
+
+  DigestSize = mImageDigestSize;
+  Status     = mPeImageDigestCache->GetDigest (
+                                      mPeImageDigestCache,
+                                      mImageBase,
+                                      mImageSize,
+                                      mImageFile,
+                                      AlgorithmId,
+                                      mImageDigest,
+                                      &DigestSize
+                                      );
+  return (BOOLEAN)(!EFI_ERROR (Status) && (DigestSize == mImageDigestSize));
+}
+
+/**
+  Share the digest of the current image in mImageDigest with the other
+  Security2 handlers.
+
+  @param[in]  AlgorithmId   The hash algorithm, a TPM_ALG_ID value.
+
+**/
+STATIC
+VOID
+SetCachedImageDigest (
+  IN TPM_ALG_ID  AlgorithmId
+  )
+{
+  if (mPeImageDigestCache != NULL) {
+    mPeImageDigestCache->SetDigest (
+                           mPeImageDigestCache,
+                           mImageBase,
+                           mImageSize,
+                           mImageFile,
+                           AlgorithmId,
+                           mImageDigest,
+                           mImageDigestSize
+                           );
+  }
+}
+
 /**
   Calculate hash of Pe/Coff image based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A
@@ -305,6 +377,7 @@ HashPeImage (
   UINTN                     Pos;
   UINT32                    CertSize;
   UINT32                    NumberOfRvaAndSizes;
+  TPM_ALG_ID                AlgorithmId;
 
   HashCtx       = NULL;
   SectionHeader = NULL;
@@ -324,22 +397,26 @@ HashPeImage (
     case HASHALG_SHA1:
       mImageDigestSize = SHA1_DIGEST_SIZE;
       mCertType        = gEfiCertSha1Guid;
+      AlgorithmId      = TPM_ALG_SHA1;
       break;
  #endif
 
     case HASHALG_SHA256:
       mImageDigestSize = SHA256_DIGEST_SIZE;
       mCertType        = gEfiCertSha256Guid;
+      AlgorithmId      = TPM_ALG_SHA256;
       break;
 
     case HASHALG_SHA384:
       mImageDigestSize = SHA384_DIGEST_SIZE;
       mCertType        = gEfiCertSha384Guid;
+      AlgorithmId      = TPM_ALG_SHA384;
       break;
 
     case HASHALG_SHA512:
       mImageDigestSize = SHA512_DIGEST_SIZE;
       mCertType        = gEfiCertSha512Guid;
+      AlgorithmId      = TPM_ALG_SHA512;
       break;
 
     default:
@@ -393,6 +470,14 @@ HashPeImage (
     goto Done;
   }
 
+  //
+  // The image may have been hashed already for the TCG measurement.
+  //
+  if (GetCachedImageDigest (AlgorithmId)) {
+    Status = TRUE;
+    goto Done;
+  }
+
   Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
   if (!Status) {
     goto Done;
@@ -592,6 +677,9 @@ HashPeImage (
   }
 
   Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
+  if (Status) {
+    SetCachedImageDigest (AlgorithmId);
+  }
 
 Done:
   if (HashCtx != NULL) {
@@ -831,8 +919,6 @@ AddImageExeInfo (
 
   @param[in]  Certificate       Pointer to X.509 Certificate that is searched for.
   @param[in]  CertSize          Size of X.509 Certificate.
-  @param[in]  SignatureList     Pointer to the Signature List in forbidden database.
-  @param[in]  SignatureListSize Size of Signature List.
   @param[out] RevocationTime    Return the time that the certificate was revoked.
   @param[out] IsFound           Search result. Only valid if EFI_SUCCESS returned.
 
@@ -842,36 +928,38 @@ AddImageExeInfo (
 **/
 EFI_STATUS
 IsCertHashFoundInDbx (
-  IN  UINT8               *Certificate,
-  IN  UINTN               CertSize,
-  IN  EFI_SIGNATURE_LIST  *SignatureList,
-  IN  UINTN               SignatureListSize,
-  OUT EFI_TIME            *RevocationTime,
-  OUT BOOLEAN             *IsFound
+  IN  UINT8     *Certificate,
+  IN  UINTN     CertSize,
+  OUT EFI_TIME  *RevocationTime,
+  OUT BOOLEAN   *IsFound
   )
 {
   EFI_STATUS          Status;
   EFI_SIGNATURE_LIST  *DbxList;
-  UINTN               DbxSize;
   EFI_SIGNATURE_DATA  *CertHash;
-  UINTN               CertHashCount;
+  EFI_SIGNATURE_DATA  *FoundHash;
   UINTN               Index;
   UINT32              HashAlg;
   VOID                *HashCtx;
   UINT8               CertDigest[MAX_DIGEST_SIZE];
-  UINT8               *DbxCertHash;
-  UINTN               SiglistHeaderSize;
   UINT8               *TBSCert;
   UINTN               TBSCertSize;
 
-  Status   = EFI_ABORTED;
-  *IsFound = FALSE;
-  DbxList  = SignatureList;
-  DbxSize  = SignatureListSize;
-  HashCtx  = NULL;
-  HashAlg  = HASHALG_MAX;
-
-  if ((RevocationTime == NULL) || (DbxList == NULL)) {
+  STATIC CONST struct {
+    EFI_GUID    *SignatureType;
+    UINT32      HashAlg;
+  } DbxCertHashTypes[] = {
+    { &gEfiCertX509Sha256Guid, HASHALG_SHA256 },
+    { &gEfiCertX509Sha384Guid, HASHALG_SHA384 },
+    { &gEfiCertX509Sha512Guid, HASHALG_SHA512 }
+  };
+
+  Status    = EFI_ABORTED;
+  *IsFound  = FALSE;
+  HashCtx   = NULL;
+  FoundHash = NULL;
+
+  if (RevocationTime == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -882,22 +970,17 @@ IsCertHashFoundInDbx (
     return Status;
   }
 
-  while ((DbxSize > 0) && (SignatureListSize >= DbxList->SignatureListSize)) {
-    //
-    // Determine Hash Algorithm of Certificate in the forbidden database.
-    //
-    if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha256Guid)) {
-      HashAlg = HASHALG_SHA256;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha384Guid)) {
-      HashAlg = HASHALG_SHA384;
-    } else if (CompareGuid (&DbxList->SignatureType, &gEfiCertX509Sha512Guid)) {
-      HashAlg = HASHALG_SHA512;
-    } else {
-      DbxSize -= DbxList->SignatureListSize;
-      DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+  //
+  // Hash the TBSCertificate once per hash algorithm used in the forbidden
+  // database, and look the digest up in the dbx index.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (DbxCertHashTypes); Index++) {
+    if (SignatureDbCountHashes (EFI_IMAGE_SECURITY_DATABASE1, DbxCertHashTypes[Index].SignatureType) == 0) {
       continue;
     }
 
+    HashAlg = DbxCertHashTypes[Index].HashAlg;
+
     //
     // Calculate the hash value of current TBSCertificate for comparision.
     //
@@ -926,36 +1009,36 @@ IsCertHashFoundInDbx (
     FreePool (HashCtx);
     HashCtx = NULL;
 
-    SiglistHeaderSize = sizeof (EFI_SIGNATURE_LIST) + DbxList->SignatureHeaderSize;
-    CertHash          = (EFI_SIGNATURE_DATA *)((UINT8 *)DbxList + SiglistHeaderSize);
-    CertHashCount     = (DbxList->SignatureListSize - SiglistHeaderSize) / DbxList->SignatureSize;
-    for (Index = 0; Index < CertHashCount; Index++) {
-      //
-      // Iterate each Signature Data Node within this CertList for verify.
-      //
-      DbxCertHash = CertHash->SignatureData;
-      if (CompareMem (DbxCertHash, CertDigest, mHash[HashAlg].DigestLength) == 0) {
-        //
-        // Hash of Certificate is found in forbidden database.
-        //
-        Status   = EFI_SUCCESS;
-        *IsFound = TRUE;
-
-        //
-        // Return the revocation time.
-        //
-        CopyMem (RevocationTime, (EFI_TIME *)(DbxCertHash + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
-        goto Done;
-      }
+    Status = SignatureDbFindHash (
+               EFI_IMAGE_SECURITY_DATABASE1,
+               DbxCertHashTypes[Index].SignatureType,
+               CertDigest,
+               mHash[HashAlg].DigestLength,
+               &DbxList,
+               &CertHash
+               );
+    if (Status == EFI_NOT_FOUND) {
+      continue;
+    }
 
-      CertHash = (EFI_SIGNATURE_DATA *)((UINT8 *)CertHash + DbxList->SignatureSize);
+    if (EFI_ERROR (Status)) {
+      goto Done;
     }
 
-    DbxSize -= DbxList->SignatureListSize;
-    DbxList  = (EFI_SIGNATURE_LIST *)((UINT8 *)DbxList + DbxList->SignatureListSize);
+    //
+    // Report the first hash of the database, whatever its algorithm.
+    //
+    if ((FoundHash == NULL) || ((UINT8 *)CertHash < (UINT8 *)FoundHash)) {
+      FoundHash = CertHash;
+      //
+      // Return the revocation time.
+      //
+      CopyMem (RevocationTime, (EFI_TIME *)(CertHash->SignatureData + mHash[HashAlg].DigestLength), sizeof (EFI_TIME));
+    }
   }
 
-  Status = EFI_SUCCESS;
+  *IsFound = (BOOLEAN)(FoundHash != NULL);
+  Status   = EFI_SUCCESS;
 
 Done:
   if (HashCtx != NULL) {
@@ -990,81 +1073,35 @@ IsSignatureFoundInDatabase (
   EFI_STATUS          Status;
   EFI_SIGNATURE_LIST  *CertList;
   EFI_SIGNATURE_DATA  *Cert;
-  UINTN               DataSize;
-  UINT8               *Data;
-  UINTN               Index;
-  UINTN               CertCount;
 
   //
-  // Read signature database variable.
+  // Look the signature up in the index of the signature database.
   //
   *IsFound = FALSE;
-  Data     = NULL;
-  DataSize = 0;
-  Status   = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status == EFI_NOT_FOUND) {
-      //
-      // No database, no need to search.
-      //
-      Status = EFI_SUCCESS;
-    }
-
-    return Status;
-  }
-
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  Status   = SignatureDbFindHash (VariableName, CertType, Signature, SignatureSize, &CertList, &Cert);
+  if (Status == EFI_NOT_FOUND) {
+    //
+    // No database or not in the database.
+    //
+    return EFI_SUCCESS;
   }
 
-  Status = gRT->GetVariable (VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Data);
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return Status;
   }
 
   //
-  // Enumerate all signature data in SigDB to check if signature exists for executable.
+  // Find the signature in database.
   //
-  CertList = (EFI_SIGNATURE_LIST *)Data;
-  while ((DataSize > 0) && (DataSize >= CertList->SignatureListSize)) {
-    CertCount = (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
-    Cert      = (EFI_SIGNATURE_DATA *)((UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize);
-    if ((CertList->SignatureSize == sizeof (EFI_SIGNATURE_DATA) - 1 + SignatureSize) && (CompareGuid (&CertList->SignatureType, CertType))) {
-      for (Index = 0; Index < CertCount; Index++) {
-        if (CompareMem (Cert->SignatureData, Signature, SignatureSize) == 0) {
-          //
-          // Find the signature in database.
-          //
-          *IsFound = TRUE;
-          //
-          // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
-          //
-          if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
-            SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
-          }
-
-          break;
-        }
-
-        Cert = (EFI_SIGNATURE_DATA *)((UINT8 *)Cert + CertList->SignatureSize);
-      }
-
-      if (*IsFound) {
-        break;
-      }
-    }
-
-    DataSize -= CertList->SignatureListSize;
-    CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
-  }
-
-Done:
-  if (Data != NULL) {
-    FreePool (Data);
+  *IsFound = TRUE;
+  //
+  // Entries in UEFI_IMAGE_SECURITY_DATABASE that are used to validate image should be measured
+  //
+  if (StrCmp (VariableName, EFI_IMAGE_SECURITY_DATABASE) == 0) {
+    SecureBootHook (VariableName, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, Cert);
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1288,10 +1325,8 @@ IsForbiddenByDbx (
   //
   // The image will not be forbidden if dbx can't be got.
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
+  Status = SignatureDbGetData (EFI_IMAGE_SECURITY_DATABASE1, &Data, &DataSize);
+  if (EFI_ERROR (Status)) {
     if (Status == EFI_NOT_FOUND) {
       //
       // Evidently not in dbx if the database doesn't exist.
@@ -1302,16 +1337,6 @@ IsForbiddenByDbx (
     return IsForbidden;
   }
 
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return IsForbidden;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
-
   //
   // Verify image signature with RAW X509 certificates in DBX database.
   // If passed, the image will be forbidden.
@@ -1389,7 +1414,7 @@ IsForbiddenByDbx (
     //
     CertPtr = CertPtr + sizeof (UINT32) + CertSize;
 
-    Status = IsCertHashFoundInDbx (Cert, CertSize, (EFI_SIGNATURE_LIST *)Data, DataSize, &RevocationTime, &IsFound);
+    Status = IsCertHashFoundInDbx (Cert, CertSize, &RevocationTime, &IsFound);
     if (EFI_ERROR (Status)) {
       //
       // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1418,10 +1443,6 @@ IsForbiddenByDbx (
   IsForbidden = FALSE;
 
 Done:
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
   Pkcs7FreeSigners (CertBuffer);
   Pkcs7FreeSigners (TrustedCert);
 
@@ -1471,21 +1492,9 @@ IsAllowedByDb (
   // Fetch 'db' content. If 'db' doesn't exist or encounters problem to get the
   // data, return not-allowed-by-db (FALSE).
   //
-  DataSize = 0;
-  Status   = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    return VerifyStatus;
-  }
-
-  Data = (UINT8 *)AllocateZeroPool (DataSize);
-  if (Data == NULL) {
-    return VerifyStatus;
-  }
-
-  Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, (VOID *)Data);
+  Status = SignatureDbGetData (EFI_IMAGE_SECURITY_DATABASE, &Data, &DataSize);
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return VerifyStatus;
   }
 
   //
@@ -1493,30 +1502,9 @@ IsAllowedByDb (
   // If any other errors occurred, no need to check 'db' but just return
   // not-allowed-by-db (FALSE) to avoid bypass.
   //
-  DbxDataSize = 0;
-  Status      = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, NULL);
-  ASSERT (EFI_ERROR (Status));
-  if (Status != EFI_BUFFER_TOO_SMALL) {
-    if (Status != EFI_NOT_FOUND) {
-      goto Done;
-    }
-
-    //
-    // 'dbx' does not exist. Continue to check 'db'.
-    //
-  } else {
-    //
-    // 'dbx' exists. Get its content.
-    //
-    DbxData = (UINT8 *)AllocateZeroPool (DbxDataSize);
-    if (DbxData == NULL) {
-      goto Done;
-    }
-
-    Status = gRT->GetVariable (EFI_IMAGE_SECURITY_DATABASE1, &gEfiImageSecurityDatabaseGuid, NULL, &DbxDataSize, (VOID *)DbxData);
-    if (EFI_ERROR (Status)) {
-      goto Done;
-    }
+  Status = SignatureDbGetData (EFI_IMAGE_SECURITY_DATABASE1, &DbxData, &DbxDataSize);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    return VerifyStatus;
   }
 
   //
@@ -1554,7 +1542,7 @@ IsAllowedByDb (
             //
             // Here We still need to check if this RootCert's Hash is revoked
             //
-            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, (EFI_SIGNATURE_LIST *)DbxData, DbxDataSize, &RevocationTime, &IsFound);
+            Status = IsCertHashFoundInDbx (RootCert, RootCertSize, &RevocationTime, &IsFound);
             if (EFI_ERROR (Status)) {
               //
               // Error in searching dbx. Consider it as 'found'. RevocationTime might
@@ -1595,14 +1583,6 @@ Done:
     SecureBootHook (EFI_IMAGE_SECURITY_DATABASE, &gEfiImageSecurityDatabaseGuid, CertList->SignatureSize, CertData);
   }
 
-  if (Data != NULL) {
-    FreePool (Data);
-  }
-
-  if (DbxData != NULL) {
-    FreePool (DbxData);
-  }
-
   return VerifyStatus;
 }
 
@@ -1760,6 +1740,11 @@ DxeImageVerificationHandler (
 
   FreePool (SecureBoot);
 
+  //
+  // db and dbx may have been updated since the last image was verified.
+  //
+  SignatureDbStartVerification ();
+
   //
   // Read the Dos header.
   //
@@ -1769,6 +1754,7 @@ DxeImageVerificationHandler (
 
   mImageBase = (UINT8 *)FileBuffer;
   mImageSize = FileSize;
+  mImageFile = File;
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
@@ -2065,6 +2051,8 @@ OnReadyToBoot (
   EFI_IMAGE_EXECUTION_INFO_TABLE  *ImageExeInfoTable;
   UINTN                           ImageExeInfoTableSize;
 
+  SignatureDbReportStatistics ();
+
   EfiGetSystemConfigurationTable (&gEfiImageSecurityDatabaseGuid, (VOID **)&ImageExeInfoTable);
   if (ImageExeInfoTable != NULL) {
     return;
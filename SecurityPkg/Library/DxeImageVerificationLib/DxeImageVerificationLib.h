@@ -28,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/BlockIo.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/VariableWrite.h>
+#include <Protocol/PeImageDigestCache.h>
 #include <Guid/ImageAuthentication.h>
 #include <Guid/AuthenticatedVariableFormat.h>
 #include <IndustryStandard/PeImage.h>
@@ -195,4 +196,88 @@ typedef struct {
   HASH_FINAL               HashFinal;
 } HASH_TABLE;
 
+/**
+  Start the verification of an image. The cached signature databases are
+  checked against their variables the next time they are used.
+
+**/
+VOID
+SignatureDbStartVerification (
+  VOID
+  );
+
+/**
+  Get the signature lists of a signature database.
+
+  The content returned remains valid until the verification of the next image.
+
+  @param[in]   VariableName   EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[out]  Data           The signature lists of the database.
+  @param[out]  DataSize       The size of the signature lists.
+
+  @retval EFI_SUCCESS           The database content is returned.
+  @retval EFI_NOT_FOUND         The database variable doesn't exist.
+  @retval Others                The database variable could not be read.
+
+**/
+EFI_STATUS
+SignatureDbGetData (
+  IN  CHAR16  *VariableName,
+  OUT UINT8   **Data,
+  OUT UINTN   *DataSize
+  );
+
+/**
+  Get the number of hash signatures of a type in a signature database.
+
+  @param[in]  VariableName    EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[in]  SignatureType   The hash signature type.
+
+  @return The number of signatures, zero if the database can't be read.
+
+**/
+UINTN
+SignatureDbCountHashes (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *SignatureType
+  );
+
+/**
+  Find a hash in a signature database.
+
+  If several signatures match, the first one in the database is returned.
+
+  @param[in]   VariableName    EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[in]   SignatureType   The hash signature type, gEfiCertSha*Guid for the image
+                               hashes or gEfiCertX509Sha*Guid for the certificate hashes.
+  @param[in]   Digest          The digest searched for.
+  @param[in]   DigestSize      The size of Digest.
+  @param[out]  SignatureList   The signature list holding the signature found.
+  @param[out]  Signature       The signature found.
+
+  @retval EFI_SUCCESS           The hash is found.
+  @retval EFI_NOT_FOUND         The hash is not in the database, or the database
+                                variable doesn't exist.
+  @retval Others                The database variable could not be read.
+
+**/
+EFI_STATUS
+SignatureDbFindHash (
+  IN  CHAR16              *VariableName,
+  IN  EFI_GUID            *SignatureType,
+  IN  UINT8               *Digest,
+  IN  UINTN               DigestSize,
+  OUT EFI_SIGNATURE_LIST  **SignatureList,
+  OUT EFI_SIGNATURE_DATA  **Signature
+  );
+
+/**
+  Report the use of the signature database caches.
+
+**/
+VOID
+SignatureDbReportStatistics (
+  VOID
+  );
+
 #endif
@@ -0,0 +1,590 @@
+/** @file
+  Cache of the signature databases used by the image verification.
+
+  The content of db and dbx is kept for the whole boot, along with an index
+  of their hash signatures sorted by signature type and digest. The cache is
+  checked against the variables once for every image verified, so a write to
+  db or dbx is taken into account by the next verification.
+
+  Caution: This file requires additional review when modified.
+  The signature databases are authenticated variables, but their signature
+  lists are validated before the signatures are indexed.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeImageVerificationLib.h"
+
+//
+// Hash signature types indexed.
+//
+typedef struct {
+  EFI_GUID    *SignatureType;
+  UINT32      DigestSize;
+  //
+  // Size of the signature data following the digest: the revocation time
+  // of the certificate hashes.
+  //
+  UINT32      ExtraSize;
+} SIGNATURE_DB_HASH_TYPE;
+
+//
+// A hash signature of a database.
+//
+typedef struct {
+  UINT8                 *Digest;
+  EFI_SIGNATURE_LIST    *SignatureList;
+  UINTN                 Type;
+} SIGNATURE_DB_HASH;
+
+//
+// Cached signature database.
+//
+typedef struct {
+  CHAR16               *VariableName;
+  //
+  // EFI_SUCCESS or EFI_NOT_FOUND once the variable has been read.
+  //
+  EFI_STATUS           Status;
+  //
+  // TRUE if the cache has been checked against the variable for the image
+  // being verified.
+  //
+  BOOLEAN              Checked;
+  UINT8                *Data;
+  UINTN                DataSize;
+  UINTN                DataBufferSize;
+  //
+  // Buffer the variable is read into, to be compared with the cached content.
+  //
+  UINT8                *ReadBuffer;
+  UINTN                ReadBufferSize;
+  SIGNATURE_DB_HASH    *Hashes;
+  UINTN                HashCount;
+  //
+  // Counters reported at ReadyToBoot.
+  //
+  UINTN                Checks;
+  UINTN                Rebuilds;
+  UINTN                Lookups;
+  UINTN                Hits;
+} SIGNATURE_DB_CACHE;
+
+GLOBAL_REMOVE_IF_UNREFERENCED SIGNATURE_DB_HASH_TYPE  mSignatureDbHashTypes[] = {
+  { &gEfiCertSha1Guid,       SHA1_DIGEST_SIZE,   0                  },
+  { &gEfiCertSha256Guid,     SHA256_DIGEST_SIZE, 0                  },
+  { &gEfiCertSha384Guid,     SHA384_DIGEST_SIZE, 0                  },
+  { &gEfiCertSha512Guid,     SHA512_DIGEST_SIZE, 0                  },
+  { &gEfiCertX509Sha256Guid, SHA256_DIGEST_SIZE, sizeof (EFI_TIME)  },
+  { &gEfiCertX509Sha384Guid, SHA384_DIGEST_SIZE, sizeof (EFI_TIME)  },
+  { &gEfiCertX509Sha512Guid, SHA512_DIGEST_SIZE, sizeof (EFI_TIME)  }
+};
+
+SIGNATURE_DB_CACHE  mSignatureDbCache[] = {
+  { EFI_IMAGE_SECURITY_DATABASE,  EFI_NOT_FOUND },
+  { EFI_IMAGE_SECURITY_DATABASE1, EFI_NOT_FOUND }
+};
+
+/**
+  Compare two hash signatures by type, digest and place in the database.
+
+  @param[in]  Buffer1   The first SIGNATURE_DB_HASH.
+  @param[in]  Buffer2   The second SIGNATURE_DB_HASH.
+
+  @retval  <0  Buffer1 is sorted before Buffer2.
+  @retval  0   Buffer1 and Buffer2 are the same signature.
+  @retval  >0  Buffer1 is sorted after Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+SignatureDbCompareHash (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST SIGNATURE_DB_HASH  *Hash1;
+  CONST SIGNATURE_DB_HASH  *Hash2;
+  INTN                     Result;
+
+  Hash1 = (CONST SIGNATURE_DB_HASH *)Buffer1;
+  Hash2 = (CONST SIGNATURE_DB_HASH *)Buffer2;
+
+  if (Hash1->Type != Hash2->Type) {
+    return (Hash1->Type < Hash2->Type) ? -1 : 1;
+  }
+
+  Result = CompareMem (Hash1->Digest, Hash2->Digest, mSignatureDbHashTypes[Hash1->Type].DigestSize);
+  if (Result != 0) {
+    return Result;
+  }
+
+  //
+  // Keep the order of the database among identical hashes, the first one is
+  // the one reported.
+  //
+  if (Hash1->Digest == Hash2->Digest) {
+    return 0;
+  }
+
+  return (Hash1->Digest < Hash2->Digest) ? -1 : 1;
+}
+
+/**
+  Get the hash type of a signature list.
+
+  @param[in]  SignatureList   The signature list.
+
+  @return The index of the type in mSignatureDbHashTypes, or
+          ARRAY_SIZE (mSignatureDbHashTypes) if the list isn't indexed.
+
+**/
+STATIC
+UINTN
+SignatureDbGetHashType (
+  IN EFI_SIGNATURE_LIST  *SignatureList
+  )
+{
+  UINTN   Type;
+  UINT32  MinSize;
+
+  for (Type = 0; Type < ARRAY_SIZE (mSignatureDbHashTypes); Type++) {
+    if (CompareGuid (&SignatureList->SignatureType, mSignatureDbHashTypes[Type].SignatureType)) {
+      break;
+    }
+  }
+
+  if (Type == ARRAY_SIZE (mSignatureDbHashTypes)) {
+    return Type;
+  }
+
+  //
+  // The image hashes have an exact size, the certificate hashes are
+  // followed by the revocation time.
+  //
+  MinSize = sizeof (EFI_GUID) + mSignatureDbHashTypes[Type].DigestSize + mSignatureDbHashTypes[Type].ExtraSize;
+  if ((SignatureList->SignatureSize < MinSize) ||
+      ((mSignatureDbHashTypes[Type].ExtraSize == 0) && (SignatureList->SignatureSize != MinSize)))
+  {
+    return ARRAY_SIZE (mSignatureDbHashTypes);
+  }
+
+  return Type;
+}
+
+/**
+  Build the hash index of a signature database from its content.
+
+  @param[in, out]  Cache   The signature database.
+
+  @retval EFI_SUCCESS           The index is built.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the index.
+
+**/
+STATIC
+EFI_STATUS
+SignatureDbBuildIndex (
+  IN OUT SIGNATURE_DB_CACHE  *Cache
+  )
+{
+  EFI_SIGNATURE_LIST  *CertList;
+  UINTN               DataSize;
+  UINTN               Pass;
+  UINTN               Type;
+  UINTN               Count;
+  UINTN               Index;
+  UINT8               *Cert;
+  SIGNATURE_DB_HASH   Swap;
+
+  if (Cache->Hashes != NULL) {
+    FreePool (Cache->Hashes);
+    Cache->Hashes = NULL;
+  }
+
+  Cache->HashCount = 0;
+
+  //
+  // Count the hash signatures, then fill the index.
+  //
+  for (Pass = 0; Pass < 2; Pass++) {
+    Count    = 0;
+    CertList = (EFI_SIGNATURE_LIST *)Cache->Data;
+    DataSize = Cache->DataSize;
+    while ((DataSize >= sizeof (EFI_SIGNATURE_LIST)) && (DataSize >= CertList->SignatureListSize)) {
+      if ((CertList->SignatureListSize < sizeof (EFI_SIGNATURE_LIST) + (UINTN)CertList->SignatureHeaderSize) ||
+          (CertList->SignatureSize == 0))
+      {
+        break;
+      }
+
+      Type = SignatureDbGetHashType (CertList);
+      if (Type < ARRAY_SIZE (mSignatureDbHashTypes)) {
+        Cert = (UINT8 *)CertList + sizeof (EFI_SIGNATURE_LIST) + CertList->SignatureHeaderSize;
+        for (Index = 0;
+             Index < (CertList->SignatureListSize - sizeof (EFI_SIGNATURE_LIST) - CertList->SignatureHeaderSize) / CertList->SignatureSize;
+             Index++)
+        {
+          if (Cache->Hashes != NULL) {
+            Cache->Hashes[Count].Digest        = ((EFI_SIGNATURE_DATA *)Cert)->SignatureData;
+            Cache->Hashes[Count].SignatureList = CertList;
+            Cache->Hashes[Count].Type          = Type;
+          }
+
+          Count++;
+          Cert += CertList->SignatureSize;
+        }
+      }
+
+      DataSize -= CertList->SignatureListSize;
+      CertList  = (EFI_SIGNATURE_LIST *)((UINT8 *)CertList + CertList->SignatureListSize);
+    }
+
+    if ((Pass != 0) || (Count == 0)) {
+      break;
+    }
+
+    Cache->Hashes = AllocatePool (Count * sizeof (SIGNATURE_DB_HASH));
+    if (Cache->Hashes == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  if (Cache->Hashes != NULL) {
+    QuickSort (Cache->Hashes, Count, sizeof (SIGNATURE_DB_HASH), SignatureDbCompareHash, &Swap);
+    Cache->HashCount = Count;
+  }
+
+  Cache->Rebuilds++;
+  DEBUG ((DEBUG_INFO, "DxeImageVerificationLib: %s indexed, %d hash signatures.\n", Cache->VariableName, Cache->HashCount));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check a cached signature database against its variable, and refresh it if
+  the variable changed.
+
+  @param[in, out]  Cache   The signature database.
+
+  @retval EFI_SUCCESS           The database is cached.
+  @retval EFI_NOT_FOUND         The database variable doesn't exist.
+  @retval Others                The database variable could not be read.
+
+**/
+STATIC
+EFI_STATUS
+SignatureDbCheck (
+  IN OUT SIGNATURE_DB_CACHE  *Cache
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       DataSize;
+  UINT8       *Buffer;
+  UINTN       BufferSize;
+
+  if (Cache->Checked) {
+    return Cache->Status;
+  }
+
+  Cache->Checks++;
+
+  DataSize = Cache->ReadBufferSize;
+  Status   = gRT->GetVariable (Cache->VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Cache->ReadBuffer);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    if (Cache->ReadBuffer != NULL) {
+      FreePool (Cache->ReadBuffer);
+    }
+
+    Cache->ReadBufferSize = 0;
+    Cache->ReadBuffer     = AllocatePool (DataSize);
+    if (Cache->ReadBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Cache->ReadBufferSize = DataSize;
+    Status                = gRT->GetVariable (Cache->VariableName, &gEfiImageSecurityDatabaseGuid, NULL, &DataSize, Cache->ReadBuffer);
+  }
+
+  if (Status == EFI_NOT_FOUND) {
+    Cache->Status    = EFI_NOT_FOUND;
+    Cache->DataSize  = 0;
+    Cache->HashCount = 0;
+    Cache->Checked   = TRUE;
+    return EFI_NOT_FOUND;
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Cache->Status == EFI_SUCCESS) &&
+      (DataSize == Cache->DataSize) &&
+      (CompareMem (Cache->ReadBuffer, Cache->Data, DataSize) == 0))
+  {
+    Cache->Checked = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The variable changed. Keep what was read and index it, the former
+  // content buffer is reused for the next read.
+  //
+  Buffer                = Cache->Data;
+  BufferSize            = Cache->DataBufferSize;
+  Cache->Data           = Cache->ReadBuffer;
+  Cache->DataBufferSize = Cache->ReadBufferSize;
+  Cache->DataSize       = DataSize;
+  Cache->ReadBuffer     = Buffer;
+  Cache->ReadBufferSize = BufferSize;
+
+  //
+  // Don't use the former content if the new one can't be indexed.
+  //
+  Cache->Status = EFI_NOT_READY;
+  Status        = SignatureDbBuildIndex (Cache);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Cache->Status  = EFI_SUCCESS;
+  Cache->Checked = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the cache of a signature database, checked against its variable.
+
+  @param[in]   VariableName   EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[out]  Cache          The signature database.
+
+  @retval EFI_SUCCESS           The database is cached.
+  @retval EFI_NOT_FOUND         The database variable doesn't exist.
+  @retval EFI_INVALID_PARAMETER The database isn't cached.
+  @retval Others                The database variable could not be read.
+
+**/
+STATIC
+EFI_STATUS
+SignatureDbGetCache (
+  IN  CHAR16              *VariableName,
+  OUT SIGNATURE_DB_CACHE  **Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDbCache); Index++) {
+    if (StrCmp (VariableName, mSignatureDbCache[Index].VariableName) == 0) {
+      *Cache = &mSignatureDbCache[Index];
+      return SignatureDbCheck (*Cache);
+    }
+  }
+
+  ASSERT (FALSE);
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  Start the verification of an image. The cached signature databases are
+  checked against their variables the next time they are used.
+
+**/
+VOID
+SignatureDbStartVerification (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDbCache); Index++) {
+    mSignatureDbCache[Index].Checked = FALSE;
+  }
+}
+
+/**
+  Get the signature lists of a signature database.
+
+  The content returned remains valid until the verification of the next image.
+
+  @param[in]   VariableName   EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[out]  Data           The signature lists of the database.
+  @param[out]  DataSize       The size of the signature lists.
+
+  @retval EFI_SUCCESS           The database content is returned.
+  @retval EFI_NOT_FOUND         The database variable doesn't exist.
+  @retval Others                The database variable could not be read.
+
+**/
+EFI_STATUS
+SignatureDbGetData (
+  IN  CHAR16  *VariableName,
+  OUT UINT8   **Data,
+  OUT UINTN   *DataSize
+  )
+{
+  EFI_STATUS          Status;
+  SIGNATURE_DB_CACHE  *Cache;
+
+  *Data     = NULL;
+  *DataSize = 0;
+
+  Status = SignatureDbGetCache (VariableName, &Cache);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *Data     = Cache->Data;
+  *DataSize = Cache->DataSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the number of hash signatures of a type in a signature database.
+
+  @param[in]  VariableName    EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[in]  SignatureType   The hash signature type.
+
+  @return The number of signatures, zero if the database can't be read.
+
+**/
+UINTN
+SignatureDbCountHashes (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *SignatureType
+  )
+{
+  SIGNATURE_DB_CACHE  *Cache;
+  UINTN               Index;
+  UINTN               Count;
+
+  if (EFI_ERROR (SignatureDbGetCache (VariableName, &Cache))) {
+    return 0;
+  }
+
+  Count = 0;
+  for (Index = 0; Index < Cache->HashCount; Index++) {
+    if (CompareGuid (mSignatureDbHashTypes[Cache->Hashes[Index].Type].SignatureType, SignatureType)) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Find a hash in a signature database.
+
+  If several signatures match, the first one in the database is returned.
+
+  @param[in]   VariableName    EFI_IMAGE_SECURITY_DATABASE or EFI_IMAGE_SECURITY_DATABASE1.
+  @param[in]   SignatureType   The hash signature type, gEfiCertSha*Guid for the image
+                               hashes or gEfiCertX509Sha*Guid for the certificate hashes.
+  @param[in]   Digest          The digest searched for.
+  @param[in]   DigestSize      The size of Digest.
+  @param[out]  SignatureList   The signature list holding the signature found.
+  @param[out]  Signature       The signature found.
+
+  @retval EFI_SUCCESS           The hash is found.
+  @retval EFI_NOT_FOUND         The hash is not in the database, or the database
+                                variable doesn't exist.
+  @retval Others                The database variable could not be read.
+
+**/
+EFI_STATUS
+SignatureDbFindHash (
+  IN  CHAR16              *VariableName,
+  IN  EFI_GUID            *SignatureType,
+  IN  UINT8               *Digest,
+  IN  UINTN               DigestSize,
+  OUT EFI_SIGNATURE_LIST  **SignatureList,
+  OUT EFI_SIGNATURE_DATA  **Signature
+  )
+{
+  EFI_STATUS          Status;
+  SIGNATURE_DB_CACHE  *Cache;
+  UINTN               Type;
+  UINTN               Low;
+  UINTN               High;
+  UINTN               Middle;
+  INTN                Result;
+
+  Status = SignatureDbGetCache (VariableName, &Cache);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Cache->Lookups++;
+
+  for (Type = 0; Type < ARRAY_SIZE (mSignatureDbHashTypes); Type++) {
+    if (CompareGuid (SignatureType, mSignatureDbHashTypes[Type].SignatureType)) {
+      break;
+    }
+  }
+
+  if ((Type == ARRAY_SIZE (mSignatureDbHashTypes)) || (DigestSize != mSignatureDbHashTypes[Type].DigestSize)) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Find the first signature not sorted before the digest. Equal hashes are
+  // sorted by position, so it is the first one of the database.
+  //
+  Low  = 0;
+  High = Cache->HashCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (Cache->Hashes[Middle].Type != Type) {
+      Result = (Cache->Hashes[Middle].Type < Type) ? -1 : 1;
+    } else {
+      Result = CompareMem (Cache->Hashes[Middle].Digest, Digest, DigestSize);
+    }
+
+    if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low == Cache->HashCount) ||
+      (Cache->Hashes[Low].Type != Type) ||
+      (CompareMem (Cache->Hashes[Low].Digest, Digest, DigestSize) != 0))
+  {
+    return EFI_NOT_FOUND;
+  }
+
+  Cache->Hits++;
+  *SignatureList = Cache->Hashes[Low].SignatureList;
+  *Signature     = (EFI_SIGNATURE_DATA *)(Cache->Hashes[Low].Digest - OFFSET_OF (EFI_SIGNATURE_DATA, SignatureData));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the use of the signature database caches.
+
+**/
+VOID
+SignatureDbReportStatistics (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSignatureDbCache); Index++) {
+    DEBUG ((
+      DEBUG_INFO,
+      "DxeImageVerificationLib: %s cache: %d hashes, %d checks, %d rebuilds, %d lookups, %d found\n",
+      mSignatureDbCache[Index].VariableName,
+      mSignatureDbCache[Index].HashCount,
+      mSignatureDbCache[Index].Checks,
+      mSignatureDbCache[Index].Rebuilds,
+      mSignatureDbCache[Index].Lookups,
+      mSignatureDbCache[Index].Hits
+      ));
+  }
+}
@@ -15,6 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/HashLib.h>
 #include <Protocol/Tcg2Protocol.h>
 
+#include "HashLibBaseCryptoRouterCommon.h"
+
 typedef struct {
   EFI_GUID    Guid;
   UINT32      Mask;
@@ -72,3 +74,50 @@ Tpm2SetHashToDigestList (
     );
   DigestList->count++;
 }
+
+/**
+  Run data through the active hash interfaces, block by block.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param HashMask           Mask of the active hash algorithms.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  )
+{
+  UINTN  Index;
+  UINTN  ActiveCount;
+  UINTN  Active[HASH_COUNT];
+  UINT8  *Block;
+  UINTN  BlockLen;
+
+  ActiveCount = 0;
+  for (Index = 0; Index < HashInterfaceCount; Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&HashInterface[Index].HashGuid) & HashMask) != 0) {
+      Active[ActiveCount++] = Index;
+    }
+  }
+
+  if (ActiveCount == 1) {
+    HashInterface[Active[0]].HashUpdate (HashCtx[Active[0]], DataToHash, DataToHashLen);
+    return;
+  }
+
+  for (Block = DataToHash; DataToHashLen > 0; Block += BlockLen, DataToHashLen -= BlockLen) {
+    BlockLen = MIN (DataToHashLen, HASH_LIB_ROUTER_BLOCK_SIZE);
+    for (Index = 0; Index < ActiveCount; Index++) {
+      HashInterface[Active[Index]].HashUpdate (HashCtx[Active[Index]], Block, BlockLen);
+    }
+  }
+}
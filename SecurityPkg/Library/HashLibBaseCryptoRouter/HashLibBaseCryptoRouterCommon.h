@@ -9,6 +9,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 #define _HASH_LIB_BASE_CRYPTO_ROUTER_COMMON_H_
 
+//
+// The data is hashed in blocks of this size. Every block is run through all
+// the active hash algorithms while it is still in the data cache, so a large
+// buffer such as a PE image is read from memory once whatever the number of
+// PCR banks.
+//
+#define HASH_LIB_ROUTER_BLOCK_SIZE  SIZE_16KB
+
 /**
   The function get hash mask info from algorithm.
 
@@ -35,4 +43,25 @@ Tpm2SetHashToDigestList (
   IN TPML_DIGEST_VALUES      *Digest
   );
 
+/**
+  Run data through the active hash interfaces, block by block.
+
+  @param HashInterface      Registered hash interfaces.
+  @param HashInterfaceCount Number of registered hash interfaces.
+  @param HashCtx            Hash contexts, one per registered hash interface.
+  @param HashMask           Mask of the active hash algorithms.
+  @param DataToHash         Data to be hashed.
+  @param DataToHashLen      Data size.
+**/
+VOID
+EFIAPI
+HashUpdateInterfaces (
+  IN HASH_INTERFACE  *HashInterface,
+  IN UINTN           HashInterfaceCount,
+  IN HASH_HANDLE     *HashCtx,
+  IN UINT32          HashMask,
+  IN VOID            *DataToHash,
+  IN UINTN           DataToHashLen
+  );
+
 #endif
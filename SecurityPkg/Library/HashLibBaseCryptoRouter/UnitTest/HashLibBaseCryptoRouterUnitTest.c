@@ -0,0 +1,400 @@
+/** @file
+  Unit tests and measured boot benchmark for the multi-bank hashing of
+  HashLibBaseCryptoRouter.
+
+  The hash instances linked to the test register themselves through
+  RegisterHashInterfaceLib(), which is provided here.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/HashLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+#include "../HashLibBaseCryptoRouterCommon.h"
+
+#define UNIT_TEST_APP_NAME     "HashLibBaseCryptoRouter Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define TEST_DATA_SIZE       (SIZE_1MB + 13)
+#define BENCHMARK_MEGABYTES  2
+
+#define HASH_ALG_ALL  (HASH_ALG_SHA1 | HASH_ALG_SHA256 | HASH_ALG_SHA384 | HASH_ALG_SHA512 | HASH_ALG_SM3_256)
+
+///
+/// Chunk sizes the data is passed to the hash update with, as the image
+/// sections are by Tcg2Dxe.
+///
+STATIC CONST UINTN  mTestChunkSizes[] = { 1, 63, 4097, HASH_LIB_ROUTER_BLOCK_SIZE + 1, TEST_DATA_SIZE };
+
+///
+/// PCR bank configurations the benchmark is run with.
+///
+STATIC CONST UINT32  mBenchmarkMasks[] = {
+  HASH_ALG_SHA256,
+  HASH_ALG_SHA256 | HASH_ALG_SHA384,
+  HASH_ALG_SHA1 | HASH_ALG_SHA256 | HASH_ALG_SHA384,
+  HASH_ALG_ALL
+};
+
+STATIC HASH_INTERFACE  mHashInterface[HASH_COUNT];
+STATIC UINTN           mHashInterfaceCount;
+STATIC UINT8           *mTestData;
+STATIC UINTN           mBenchmarkDataSize;
+
+/**
+  This service register Hash.
+
+  @param HashInterface  Hash interface
+
+  @retval EFI_SUCCESS          This hash interface is registered successfully.
+  @retval EFI_OUT_OF_RESOURCES Too many hash interfaces are registered.
+**/
+EFI_STATUS
+EFIAPI
+RegisterHashInterfaceLib (
+  IN HASH_INTERFACE  *HashInterface
+  )
+{
+  if (mHashInterfaceCount >= ARRAY_SIZE (mHashInterface)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (&mHashInterface[mHashInterfaceCount], HashInterface, sizeof (*HashInterface));
+  mHashInterfaceCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Hash data with the active hash interfaces.
+
+  @param[in]   HashMask   Mask of the active hash algorithms.
+  @param[in]   Data       Data to be hashed.
+  @param[in]   DataLen    Data size.
+  @param[in]   ChunkSize  Size of the chunks the data is passed in.
+  @param[in]   Fused      TRUE to hash with HashUpdateInterfaces(), FALSE to
+                          hash the whole chunk with each interface in turn.
+  @param[out]  DigestList The digests of the active hash algorithms.
+
+**/
+STATIC
+VOID
+TestHashData (
+  IN  UINT32              HashMask,
+  IN  UINT8               *Data,
+  IN  UINTN               DataLen,
+  IN  UINTN               ChunkSize,
+  IN  BOOLEAN             Fused,
+  OUT TPML_DIGEST_VALUES  *DigestList
+  )
+{
+  HASH_HANDLE         HashCtx[HASH_COUNT];
+  TPML_DIGEST_VALUES  Digest;
+  UINTN               Index;
+  UINTN               Offset;
+  UINTN               Len;
+
+  ZeroMem (HashCtx, sizeof (HashCtx));
+  ZeroMem (DigestList, sizeof (*DigestList));
+
+  for (Index = 0; Index < mHashInterfaceCount; Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid) & HashMask) != 0) {
+      mHashInterface[Index].HashInit (&HashCtx[Index]);
+    }
+  }
+
+  for (Offset = 0; Offset < DataLen; Offset += Len) {
+    Len = MIN (ChunkSize, DataLen - Offset);
+    if (Fused) {
+      HashUpdateInterfaces (mHashInterface, mHashInterfaceCount, HashCtx, HashMask, Data + Offset, Len);
+      continue;
+    }
+
+    for (Index = 0; Index < mHashInterfaceCount; Index++) {
+      if ((Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid) & HashMask) != 0) {
+        mHashInterface[Index].HashUpdate (HashCtx[Index], Data + Offset, Len);
+      }
+    }
+  }
+
+  for (Index = 0; Index < mHashInterfaceCount; Index++) {
+    if ((Tpm2GetHashMaskFromAlgo (&mHashInterface[Index].HashGuid) & HashMask) != 0) {
+      //
+      // Only the digest is set, clear the rest of the union to compare lists.
+      //
+      ZeroMem (&Digest, sizeof (Digest));
+      mHashInterface[Index].HashFinal (HashCtx[Index], &Digest);
+      Tpm2SetHashToDigestList (DigestList, &Digest);
+    }
+  }
+}
+
+/**
+  Make sure all the hash instances are registered and fill the test data.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The environment is ready.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  A hash instance is missing.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CheckHashInstances (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Size;
+
+  if (mHashInterfaceCount != HASH_COUNT) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  if (mTestData == NULL) {
+    mBenchmarkDataSize = UnitTestBenchmarkIterations (BENCHMARK_MEGABYTES) * SIZE_1MB;
+    Size               = MAX (mBenchmarkDataSize, TEST_DATA_SIZE);
+    mTestData          = AllocatePool (Size);
+    if (mTestData == NULL) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    for (Index = 0; Index < Size; Index++) {
+      mTestData[Index] = (UINT8)((Index * 167) ^ (Index >> 11));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The digests of all the banks match the ones computed bank by bank,
+  whatever the size of the chunks the data is passed in.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FusedDigestsShouldMatchPerBankDigests (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TPML_DIGEST_VALUES  Expected;
+  TPML_DIGEST_VALUES  Actual;
+  UINTN               Index;
+
+  TestHashData (HASH_ALG_ALL, mTestData, TEST_DATA_SIZE, TEST_DATA_SIZE, FALSE, &Expected);
+  UT_ASSERT_EQUAL (Expected.count, HASH_COUNT);
+
+  for (Index = 0; Index < ARRAY_SIZE (mTestChunkSizes); Index++) {
+    TestHashData (HASH_ALG_ALL, mTestData, TEST_DATA_SIZE, mTestChunkSizes[Index], TRUE, &Actual);
+    UT_ASSERT_EQUAL (Actual.count, Expected.count);
+    UT_ASSERT_MEM_EQUAL (&Actual, &Expected, sizeof (Expected));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Only the banks in the hash mask are hashed, and a single bank gives the
+  digest of BaseCryptLib.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OnlyMaskedBanksShouldBeHashed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TPML_DIGEST_VALUES  Actual;
+  UINT8               Sha256[SHA256_DIGEST_SIZE];
+  UINT8               Sha384[SHA384_DIGEST_SIZE];
+
+  UT_ASSERT_TRUE (Sha256HashAll (mTestData, TEST_DATA_SIZE, Sha256));
+  UT_ASSERT_TRUE (Sha384HashAll (mTestData, TEST_DATA_SIZE, Sha384));
+
+  TestHashData (HASH_ALG_SHA256, mTestData, TEST_DATA_SIZE, 4097, TRUE, &Actual);
+  UT_ASSERT_EQUAL (Actual.count, 1);
+  UT_ASSERT_EQUAL (Actual.digests[0].hashAlg, TPM_ALG_SHA256);
+  UT_ASSERT_MEM_EQUAL (Actual.digests[0].digest.sha256, Sha256, sizeof (Sha256));
+
+  TestHashData (HASH_ALG_SHA256 | HASH_ALG_SHA384, mTestData, TEST_DATA_SIZE, 4097, TRUE, &Actual);
+  UT_ASSERT_EQUAL (Actual.count, 2);
+  UT_ASSERT_MEM_EQUAL (Actual.digests[0].digest.sha256, Sha256, sizeof (Sha256));
+  UT_ASSERT_MEM_EQUAL (Actual.digests[1].digest.sha384, Sha384, sizeof (Sha384));
+
+  TestHashData (0, mTestData, TEST_DATA_SIZE, 4097, TRUE, &Actual);
+  UT_ASSERT_EQUAL (Actual.count, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measure the time taken to hash one MB of an image for the usual PCR bank
+  configurations, bank by bank and with all the banks fused.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The test passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  The test failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BenchmarkMeasuredBoot (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TPML_DIGEST_VALUES  PerBankDigests;
+  TPML_DIGEST_VALUES  FusedDigests;
+  UINTN               Index;
+  UINT64              Start;
+  UINT64              PerBank;
+  UINT64              Fused;
+  UINTN               MegaBytes;
+
+  MegaBytes = mBenchmarkDataSize / SIZE_1MB;
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkMasks); Index++) {
+    Start = UnitTestBenchmarkStart ();
+    TestHashData (mBenchmarkMasks[Index], mTestData, mBenchmarkDataSize, mBenchmarkDataSize, FALSE, &PerBankDigests);
+    PerBank = UnitTestBenchmarkElapsed (Start);
+
+    Start = UnitTestBenchmarkStart ();
+    TestHashData (mBenchmarkMasks[Index], mTestData, mBenchmarkDataSize, mBenchmarkDataSize, TRUE, &FusedDigests);
+    Fused = UnitTestBenchmarkElapsed (Start);
+
+    UT_ASSERT_MEM_EQUAL (&FusedDigests, &PerBankDigests, sizeof (PerBankDigests));
+
+    UT_LOG_INFO (
+      "Hash mask 0x%02x, %d banks: per bank %Lu us/MB, fused %Lu us/MB\n",
+      mBenchmarkMasks[Index],
+      FusedDigests.count,
+      DivU64x64Remainder (PerBank, MegaBytes, NULL),
+      DivU64x64Remainder (Fused, MegaBytes, NULL)
+      );
+    DEBUG ((
+      DEBUG_INFO,
+      "HashLib benchmark: hash mask 0x%02x, %d banks, per bank %Lu us/MB, fused %Lu us/MB\n",
+      mBenchmarkMasks[Index],
+      FusedDigests.count,
+      DivU64x64Remainder (PerBank, MegaBytes, NULL),
+      DivU64x64Remainder (Fused, MegaBytes, NULL)
+      ));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  multi-bank hashing and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      HashTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&HashTests, Framework, "Multi-bank Hash Tests", "HashLibBaseCryptoRouter.Update", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Multi-bank Hash Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------Description-------------------------------------Name--------Function-------------------------------Pre-----------------Post--Context
+  //
+  AddTestCase (HashTests, "Fused digests match the per bank digests", "Fused", FusedDigestsShouldMatchPerBankDigests, CheckHashInstances, NULL, NULL);
+  AddTestCase (HashTests, "Only the masked banks are hashed", "Mask", OnlyMaskedBanksShouldBeHashed, CheckHashInstances, NULL, NULL);
+  AddTestCase (HashTests, "Measured boot hashing benchmark", "Benchmark", BenchmarkMeasuredBoot, CheckHashInstances, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mTestData != NULL) {
+    FreePool (mTestData);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define HashLibBaseCryptoRouterUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+HashLibBaseCryptoRouterUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  UnitTestingEntry ();
+  return 0;
+}
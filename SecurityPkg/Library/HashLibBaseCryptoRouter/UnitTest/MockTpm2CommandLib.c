@@ -0,0 +1,32 @@
+/** @file
+  Mock of Tpm2CommandLib for the host-based tests of the hash libraries.
+  No TPM is present, the PCR extensions are accepted and dropped.
+
+Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <IndustryStandard/Tpm20.h>
+#include <Library/Tpm2CommandLib.h>
+
+/**
+  This command is used to cause an update to the indicated PCR.
+  The digests parameter contains one or more tagged digest value identified by an algorithm ID.
+  For each digest, the PCR associated with pcrHandle is Extended into the bank identified by the tag (hashAlg).
+
+  @param[in] PcrHandle   Handle of the PCR
+  @param[in] Digests     List of tagged digest values to be extended
+
+  @retval EFI_SUCCESS      Operation completed successfully.
+**/
+EFI_STATUS
+EFIAPI
+Tpm2PcrExtend (
+  IN      TPMI_DH_PCR         PcrHandle,
+  IN      TPML_DIGEST_VALUES  *Digests
+  )
+{
+  return EFI_SUCCESS;
+}
@@ -13,6 +13,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <PiDxe.h>
 
+#include <Protocol/PeImageDigestCache.h>
+
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -25,6 +27,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 UINTN  mTcg2DxeImageSize = 0;
 
+//
+// Digests of the image shared with the Secure Boot verification.
+//
+EDKII_PE_IMAGE_DIGEST_CACHE_PROTOCOL  *mTcg2DxePeImageDigestCache = NULL;
+
+//
+// Hash algorithms of the PCR banks.
+//
+TPM_ALG_ID  mTcg2DxePcrBankAlgorithms[] = {
+  TPM_ALG_SHA1,
+  TPM_ALG_SHA256,
+  TPM_ALG_SHA384,
+  TPM_ALG_SHA512,
+  TPM_ALG_SM3_256
+};
+
 /**
   Reads contents of a PE/COFF image in memory buffer.
 
@@ -73,6 +91,106 @@ Tcg2DxeImageRead (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the digests of the image for all the active PCR banks from the digests
+  already computed by the other Security2 handlers.
+
+  @param[in]  ImageAddress        Start address of image buffer.
+  @param[in]  ImageSize           Image size.
+  @param[in]  FilePath            Device path of the image.
+  @param[in]  HashAlgorithmMask   Bitmap of the active PCR banks.
+  @param[out] DigestList          Digest list of this image.
+
+  @retval TRUE            The digests of all the active PCR banks are found.
+  @retval FALSE           The image must be hashed.
+
+**/
+STATIC
+BOOLEAN
+GetCachedPeImageDigests (
+  IN  EFI_PHYSICAL_ADDRESS            ImageAddress,
+  IN  UINTN                           ImageSize,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN  UINT32                          HashAlgorithmMask,
+  OUT TPML_DIGEST_VALUES              *DigestList
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       DigestSize;
+
+  if (mTcg2DxePeImageDigestCache == NULL) {
+    Status = gBS->LocateProtocol (&gEdkiiPeImageDigestCacheProtocolGuid, NULL, (VOID **)&mTcg2DxePeImageDigestCache);
+    if (EFI_ERROR (Status)) {
+      mTcg2DxePeImageDigestCache = NULL;
+      return FALSE;
+    }
+  }
+
+  ZeroMem (DigestList, sizeof (*DigestList));
+  for (Index = 0; Index < ARRAY_SIZE (mTcg2DxePcrBankAlgorithms); Index++) {
+    if ((HashAlgorithmMask & GetHashMaskFromAlgo (mTcg2DxePcrBankAlgorithms[Index])) == 0) {
+      continue;
+    }
+
+    DigestSize = sizeof (DigestList->digests[DigestList->count].digest);
+    Status     = mTcg2DxePeImageDigestCache->GetDigest (
+                                               mTcg2DxePeImageDigestCache,
+                                               (VOID *)(UINTN)ImageAddress,
+                                               ImageSize,
+                                               FilePath,
+                                               mTcg2DxePcrBankAlgorithms[Index],
+                                               (UINT8 *)&DigestList->digests[DigestList->count].digest,
+                                               &DigestSize
+                                               );
+    if (EFI_ERROR (Status) || (DigestSize != GetHashSizeFromAlgo (mTcg2DxePcrBankAlgorithms[Index]))) {
+      return FALSE;
+    }
+
+    DigestList->digests[DigestList->count].hashAlg = mTcg2DxePcrBankAlgorithms[Index];
+    DigestList->count++;
+  }
+
+  return (BOOLEAN)(DigestList->count != 0);
+}
+
+/**
+  Share the digests of the image with the other Security2 handlers.
+
+  @param[in]  ImageAddress        Start address of image buffer.
+  @param[in]  ImageSize           Image size.
+  @param[in]  FilePath            Device path of the image.
+  @param[in]  DigestList          Digest list of this image.
+
+**/
+STATIC
+VOID
+SetCachedPeImageDigests (
+  IN EFI_PHYSICAL_ADDRESS            ImageAddress,
+  IN UINTN                           ImageSize,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN TPML_DIGEST_VALUES              *DigestList
+  )
+{
+  UINTN  Index;
+
+  if (mTcg2DxePeImageDigestCache == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < DigestList->count; Index++) {
+    mTcg2DxePeImageDigestCache->SetDigest (
+                                  mTcg2DxePeImageDigestCache,
+                                  (VOID *)(UINTN)ImageAddress,
+                                  ImageSize,
+                                  FilePath,
+                                  DigestList->digests[Index].hashAlg,
+                                  (UINT8 *)&DigestList->digests[Index].digest,
+                                  GetHashSizeFromAlgo (DigestList->digests[Index].hashAlg)
+                                  );
+  }
+}
+
 /**
   Measure PE image into TPM log based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A.
@@ -83,10 +201,15 @@ Tcg2DxeImageRead (
 
   Notes: PE/COFF image is checked by BasePeCoffLib PeCoffLoaderGetImageInfo().
 
-  @param[in]  PCRIndex       TPM PCR index
-  @param[in]  ImageAddress   Start address of image buffer.
-  @param[in]  ImageSize      Image size
-  @param[out] DigestList     Digest list of this image.
+  The image is only hashed if the digests of all the active PCR banks haven't
+  been computed yet by the other Security2 handlers.
+
+  @param[in]  PCRIndex           TPM PCR index
+  @param[in]  ImageAddress       Start address of image buffer.
+  @param[in]  ImageSize          Image size
+  @param[in]  FilePath           Device path of the image.
+  @param[in]  HashAlgorithmMask  Bitmap of the active PCR banks.
+  @param[out] DigestList         Digest list of this image.
 
   @retval EFI_SUCCESS            Successfully measure image.
   @retval EFI_OUT_OF_RESOURCES   No enough resource to measure image.
@@ -94,10 +217,12 @@ Tcg2DxeImageRead (
 **/
 EFI_STATUS
 MeasurePeImageAndExtend (
-  IN  UINT32                PCRIndex,
-  IN  EFI_PHYSICAL_ADDRESS  ImageAddress,
-  IN  UINTN                 ImageSize,
-  OUT TPML_DIGEST_VALUES    *DigestList
+  IN  UINT32                          PCRIndex,
+  IN  EFI_PHYSICAL_ADDRESS            ImageAddress,
+  IN  UINTN                           ImageSize,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN  UINT32                          HashAlgorithmMask,
+  OUT TPML_DIGEST_VALUES              *DigestList
   )
 {
   EFI_STATUS                           Status;
@@ -153,6 +278,14 @@ MeasurePeImageAndExtend (
     goto Finish;
   }
 
+  //
+  // The image may have been hashed already for the Secure Boot verification.
+  //
+  if (GetCachedPeImageDigests (ImageAddress, ImageSize, FilePath, HashAlgorithmMask, DigestList)) {
+    Status = Tpm2PcrExtend (PCRIndex, DigestList);
+    goto Finish;
+  }
+
   //
   // PE/COFF Image Measurement
   //
@@ -399,6 +532,8 @@ MeasurePeImageAndExtend (
     goto Finish;
   }
 
+  SetCachedPeImageDigests (ImageAddress, ImageSize, FilePath, DigestList);
+
 Finish:
   if (SectionHeader != NULL) {
     FreePool (SectionHeader);
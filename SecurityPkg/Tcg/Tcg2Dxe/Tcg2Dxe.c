@@ -44,6 +44,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PerformanceLib.h>
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/Tcg2PhysicalPresenceLib.h>
+#include <Library/DevicePathLib.h>
 
 #define PERF_ID_TCG2_DXE  0x3120
 
@@ -125,10 +126,12 @@ EFI_HANDLE  mImageHandle;
 
   Notes: PE/COFF image is checked by BasePeCoffLib PeCoffLoaderGetImageInfo().
 
-  @param[in]  PCRIndex       TPM PCR index
-  @param[in]  ImageAddress   Start address of image buffer.
-  @param[in]  ImageSize      Image size
-  @param[out] DigestList     Digest list of this image.
+  @param[in]  PCRIndex           TPM PCR index
+  @param[in]  ImageAddress       Start address of image buffer.
+  @param[in]  ImageSize          Image size
+  @param[in]  FilePath           Device path of the image.
+  @param[in]  HashAlgorithmMask  Bitmap of the active PCR banks.
+  @param[out] DigestList         Digest list of this image.
 
   @retval EFI_SUCCESS            Successfully measure image.
   @retval EFI_OUT_OF_RESOURCES   No enough resource to measure image.
@@ -136,10 +139,12 @@ EFI_HANDLE  mImageHandle;
 **/
 EFI_STATUS
 MeasurePeImageAndExtend (
-  IN  UINT32                PCRIndex,
-  IN  EFI_PHYSICAL_ADDRESS  ImageAddress,
-  IN  UINTN                 ImageSize,
-  OUT TPML_DIGEST_VALUES    *DigestList
+  IN  UINT32                          PCRIndex,
+  IN  EFI_PHYSICAL_ADDRESS            ImageAddress,
+  IN  UINTN                           ImageSize,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath OPTIONAL,
+  IN  UINT32                          HashAlgorithmMask,
+  OUT TPML_DIGEST_VALUES              *DigestList
   );
 
 /**
@@ -1292,9 +1297,11 @@ Tcg2HashLogExtendEvent (
   IN EFI_TCG2_EVENT        *Event
   )
 {
-  EFI_STATUS          Status;
-  TCG_PCR_EVENT_HDR   NewEventHdr;
-  TPML_DIGEST_VALUES  DigestList;
+  EFI_STATUS                Status;
+  TCG_PCR_EVENT_HDR         NewEventHdr;
+  TPML_DIGEST_VALUES        DigestList;
+  EFI_IMAGE_LOAD_EVENT      *ImageLoad;
+  EFI_DEVICE_PATH_PROTOCOL  *FilePath;
 
   DEBUG ((DEBUG_VERBOSE, "Tcg2HashLogExtendEvent ...\n"));
 
@@ -1325,10 +1332,26 @@ Tcg2HashLogExtendEvent (
   NewEventHdr.EventType = Event->Header.EventType;
   NewEventHdr.EventSize = Event->Size - sizeof (UINT32) - Event->Header.HeaderSize;
   if ((Flags & PE_COFF_IMAGE) != 0) {
+    //
+    // Get the device path of the image from the image load event, to look
+    // the image up in the digests computed by the Secure Boot verification.
+    //
+    FilePath  = NULL;
+    ImageLoad = (EFI_IMAGE_LOAD_EVENT *)Event->Event;
+    if ((NewEventHdr.EventSize > OFFSET_OF (EFI_IMAGE_LOAD_EVENT, DevicePath)) &&
+        (ImageLoad->LengthOfDevicePath != 0) &&
+        (ImageLoad->LengthOfDevicePath <= NewEventHdr.EventSize - OFFSET_OF (EFI_IMAGE_LOAD_EVENT, DevicePath)) &&
+        IsDevicePathValid (ImageLoad->DevicePath, ImageLoad->LengthOfDevicePath))
+    {
+      FilePath = ImageLoad->DevicePath;
+    }
+
     Status = MeasurePeImageAndExtend (
                NewEventHdr.PCRIndex,
                DataToHash,
                (UINTN)DataToHashLen,
+               FilePath,
+               mTcgDxeData.BsCap.ActivePcrBanks,
                &DigestList
                );
     if (!EFI_ERROR (Status)) {
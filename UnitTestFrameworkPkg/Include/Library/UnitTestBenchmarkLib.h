@@ -0,0 +1,62 @@
+/** @file
+  Timing and iteration counts for the benchmarks of host based unit tests.
+
+  A benchmark is added as a test case next to the test cases that check the
+  results of the code it measures. It runs a CI-sized number of iterations by
+  default, so it only costs a few milliseconds in a CI run, and logs the times
+  it measured. The number of iterations can be scaled up for a real
+  measurement without rebuilding the test.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef UNIT_TEST_BENCHMARK_LIB_H_
+#define UNIT_TEST_BENCHMARK_LIB_H_
+
+/**
+  Return the number of iterations a benchmark runs.
+
+  The default number of iterations is multiplied by the value of the
+  UNIT_TEST_BENCHMARK_SCALE environment variable if it is set to a positive
+  number.
+
+  @param[in]  DefaultIterations  The number of iterations of a CI run.
+
+  @return The number of iterations to run, at least one.
+
+**/
+UINTN
+EFIAPI
+UnitTestBenchmarkIterations (
+  IN UINTN  DefaultIterations
+  );
+
+/**
+  Return a time stamp to measure the time elapsed from.
+
+  @return The time stamp, for UnitTestBenchmarkElapsed().
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStart (
+  VOID
+  );
+
+/**
+  Return the processor time used since a time stamp.
+
+  @param[in]  Start  The time stamp returned by UnitTestBenchmarkStart().
+
+  @return The processor time elapsed since Start, in microseconds.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkElapsed (
+  IN UINT64  Start
+  );
+
+#endif
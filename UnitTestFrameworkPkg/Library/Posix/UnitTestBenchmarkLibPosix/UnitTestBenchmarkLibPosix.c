@@ -0,0 +1,85 @@
+/** @file
+  Instance of Unit Test Benchmark Library based on POSIX APIs
+
+  Uses the C library clock() to time the benchmarks and getenv() to read the
+  UNIT_TEST_BENCHMARK_SCALE environment variable.
+
+  Copyright (c) 2026, agent <agent@local>. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <Base.h>
+#include <Library/UnitTestBenchmarkLib.h>
+
+/**
+  Return the number of iterations a benchmark runs.
+
+  The default number of iterations is multiplied by the value of the
+  UNIT_TEST_BENCHMARK_SCALE environment variable if it is set to a positive
+  number.
+
+  @param[in]  DefaultIterations  The number of iterations of a CI run.
+
+  @return The number of iterations to run, at least one.
+
+**/
+UINTN
+EFIAPI
+UnitTestBenchmarkIterations (
+  IN UINTN  DefaultIterations
+  )
+{
+  CONST CHAR8  *Scale;
+  long         Value;
+
+  if (DefaultIterations == 0) {
+    DefaultIterations = 1;
+  }
+
+  Scale = getenv ("UNIT_TEST_BENCHMARK_SCALE");
+  if (Scale == NULL) {
+    return DefaultIterations;
+  }
+
+  Value = strtol (Scale, NULL, 10);
+  if ((Value <= 0) || ((UINTN)Value > MAX_UINTN / DefaultIterations)) {
+    return DefaultIterations;
+  }
+
+  return DefaultIterations * (UINTN)Value;
+}
+
+/**
+  Return a time stamp to measure the time elapsed from.
+
+  @return The time stamp, for UnitTestBenchmarkElapsed().
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkStart (
+  VOID
+  )
+{
+  return (UINT64)clock ();
+}
+
+/**
+  Return the processor time used since a time stamp.
+
+  @param[in]  Start  The time stamp returned by UnitTestBenchmarkStart().
+
+  @return The processor time elapsed since Start, in microseconds.
+
+**/
+UINT64
+EFIAPI
+UnitTestBenchmarkElapsed (
+  IN UINT64  Start
+  )
+{
+  return ((UINT64)clock () - Start) * 1000000 / CLOCKS_PER_SEC;
+}